@@ -0,0 +1,128 @@
+from __future__ import annotations
+
+import json
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Dict, Optional
+
+
+class StateStreamError(RuntimeError):
+    pass
+
+
+@dataclass
+class StateStreamReader:
+    """bot 状态增量流读端（写端见 src/monitor/state_delta_stream.cpp）。
+
+    流是 JSONL 追加文件：`type=snapshot` 行携带全量状态，`type=delta`
+    行只携带相对上一版本变化的字段（持仓按 symbol 对齐，qty=0 表示
+    平仓）。版本号单调递增；读端发现版本跳号或文件被截断重写时丢弃
+    缓存，等待下一条快照重新锚定。
+
+    用法：后端按请求或定时调用 ``poll()`` 吸收新行，再读 ``state``；
+    不重读历史内容，单次 poll 的成本只与新增行数成正比。
+    """
+
+    path: Path
+    _offset: int = 0
+    _version: int = 0
+    _anchored: bool = False
+    _state: Dict[str, Any] = field(default_factory=dict)
+
+    @property
+    def version(self) -> int:
+        return self._version
+
+    @property
+    def state(self) -> Optional[Dict[str, Any]]:
+        """当前快照视图（尚未锚定到任何 snapshot 行时为 None）。"""
+        return dict(self._state) if self._anchored else None
+
+    def poll(self) -> int:
+        """吸收自上次调用以来的新记录，返回应用的记录数。"""
+        path = Path(self.path)
+        if not path.exists():
+            return 0
+        size = path.stat().st_size
+        if size < self._offset:
+            # 写端截断重写（轮转）：丢弃缓存，从头重新锚定。
+            self._reset()
+        if size == self._offset:
+            return 0
+
+        applied = 0
+        with path.open("r", encoding="utf-8") as fp:
+            fp.seek(self._offset)
+            while True:
+                line_start = fp.tell()
+                line = fp.readline()
+                if not line:
+                    break
+                if not line.endswith("\n"):
+                    # 写端尚未写完本行：停在行首，下次 poll 重读。
+                    self._offset = line_start
+                    return applied
+                stripped = line.strip()
+                if stripped:
+                    self._apply_record(stripped)
+                    applied += 1
+                self._offset = fp.tell()
+        return applied
+
+    def _reset(self) -> None:
+        self._offset = 0
+        self._version = 0
+        self._anchored = False
+        self._state = {}
+
+    def _apply_record(self, line: str) -> None:
+        try:
+            record = json.loads(line)
+        except json.JSONDecodeError as exc:
+            raise StateStreamError(f"invalid state stream line: {exc}") from exc
+        version = int(record.get("v", 0))
+        record_type = record.get("type")
+
+        if record_type == "snapshot":
+            state = dict(record.get("state", {}))
+            state["_ts"] = record.get("ts")
+            self._state = state
+            self._version = version
+            self._anchored = True
+            return
+
+        if record_type != "delta":
+            raise StateStreamError(f"unknown state stream record: {record_type}")
+        if not self._anchored:
+            # 从流中段接入：delta 无锚点不可应用，等待下一条快照。
+            return
+        if version != self._version + 1:
+            # 丢行（被外部截断/并发写坏）：丢弃缓存等待重新锚定。
+            self._anchored = False
+            self._state = {}
+            return
+
+        changes = record.get("changes", {})
+        for key, value in changes.items():
+            if key == "positions":
+                self._apply_position_changes(value)
+            elif key == "funnel":
+                self._state.setdefault("funnel", {}).update(value)
+            else:
+                self._state[key] = value
+        self._state["_ts"] = record.get("ts")
+        self._version = version
+
+    def _apply_position_changes(self, entries: Any) -> None:
+        positions = {p["symbol"]: p for p in self._state.get("positions", [])}
+        for entry in entries:
+            symbol = entry.get("symbol")
+            if not symbol:
+                continue
+            if abs(float(entry.get("qty", 0.0))) <= 1e-12:
+                positions.pop(symbol, None)
+            else:
+                positions[symbol] = entry
+        self._state["positions"] = sorted(
+            positions.values(), key=lambda p: p["symbol"]
+        )
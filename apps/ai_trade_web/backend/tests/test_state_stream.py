@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+
+import json
+import pathlib
+import tempfile
+import unittest
+
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+APP_ROOT = ROOT / "app"
+import sys
+
+if str(APP_ROOT.parent) not in sys.path:
+    sys.path.insert(0, str(APP_ROOT.parent))
+
+from app.services.state_stream import StateStreamReader, StateStreamError  # noqa: E402
+
+
+def _snapshot_line(version: int, ts: int, **overrides) -> str:
+    state = {
+        "risk_mode": "NORMAL",
+        "trading_halted": False,
+        "equity_usd": 10000.0,
+        "drawdown_pct": 0.0,
+        "positions": [{"symbol": "BTCUSDT", "qty": 0.01, "mark": 64000.0}],
+        "funnel": {"raw_signals": 10, "intents_generated": 2},
+    }
+    state.update(overrides)
+    return json.dumps({"v": version, "ts": ts, "type": "snapshot", "state": state})
+
+
+def _delta_line(version: int, ts: int, changes: dict) -> str:
+    return json.dumps({"v": version, "ts": ts, "type": "delta", "changes": changes})
+
+
+class StateStreamReaderTest(unittest.TestCase):
+    def test_snapshot_then_deltas(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(
+                _snapshot_line(1, 1000) + "\n"
+                + _delta_line(2, 2000, {"equity_usd": 10100.0}) + "\n"
+                + _delta_line(
+                    3,
+                    3000,
+                    {
+                        "risk_mode": "DEGRADED",
+                        "positions": [
+                            {"symbol": "ETHUSDT", "qty": 1.5, "mark": 3200.0}
+                        ],
+                        "funnel": {"intents_generated": 3},
+                    },
+                )
+                + "\n",
+                encoding="utf-8",
+            )
+            reader = StateStreamReader(path=path)
+            self.assertEqual(reader.poll(), 3)
+            state = reader.state
+            self.assertIsNotNone(state)
+            self.assertEqual(reader.version, 3)
+            self.assertEqual(state["risk_mode"], "DEGRADED")
+            self.assertEqual(state["equity_usd"], 10100.0)
+            self.assertEqual(state["_ts"], 3000)
+            symbols = [p["symbol"] for p in state["positions"]]
+            self.assertEqual(symbols, ["BTCUSDT", "ETHUSDT"])
+            self.assertEqual(state["funnel"]["raw_signals"], 10)
+            self.assertEqual(state["funnel"]["intents_generated"], 3)
+
+    def test_incremental_poll_and_position_close(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(_snapshot_line(1, 1000) + "\n", encoding="utf-8")
+            reader = StateStreamReader(path=path)
+            self.assertEqual(reader.poll(), 1)
+            self.assertEqual(reader.poll(), 0)
+
+            with path.open("a", encoding="utf-8") as fp:
+                fp.write(
+                    _delta_line(
+                        2,
+                        2000,
+                        {
+                            "positions": [
+                                {"symbol": "BTCUSDT", "qty": 0.0, "mark": 64100.0}
+                            ]
+                        },
+                    )
+                    + "\n"
+                )
+            self.assertEqual(reader.poll(), 1)
+            self.assertEqual(reader.state["positions"], [])
+
+    def test_partial_line_is_deferred(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(_snapshot_line(1, 1000) + "\n", encoding="utf-8")
+            reader = StateStreamReader(path=path)
+            self.assertEqual(reader.poll(), 1)
+
+            # 写端未写完的半行不应被应用，补齐后下一次 poll 再吸收。
+            partial = _delta_line(2, 2000, {"equity_usd": 10050.0})
+            with path.open("a", encoding="utf-8") as fp:
+                fp.write(partial[: len(partial) // 2])
+            self.assertEqual(reader.poll(), 0)
+            self.assertEqual(reader.version, 1)
+            with path.open("a", encoding="utf-8") as fp:
+                fp.write(partial[len(partial) // 2 :] + "\n")
+            self.assertEqual(reader.poll(), 1)
+            self.assertEqual(reader.state["equity_usd"], 10050.0)
+
+    def test_rotation_resets_and_reanchors(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(
+                _snapshot_line(1, 1000) + "\n"
+                + _delta_line(2, 2000, {"equity_usd": 10100.0}) + "\n",
+                encoding="utf-8",
+            )
+            reader = StateStreamReader(path=path)
+            self.assertEqual(reader.poll(), 2)
+
+            # 写端轮转：截断重写一条新快照（版本继续递增）。
+            path.write_text(
+                _snapshot_line(3, 3000, equity_usd=10200.0) + "\n",
+                encoding="utf-8",
+            )
+            self.assertEqual(reader.poll(), 1)
+            self.assertEqual(reader.version, 3)
+            self.assertEqual(reader.state["equity_usd"], 10200.0)
+
+    def test_version_gap_waits_for_next_snapshot(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(
+                _snapshot_line(1, 1000) + "\n"
+                + _delta_line(5, 2000, {"equity_usd": 1.0}) + "\n",
+                encoding="utf-8",
+            )
+            reader = StateStreamReader(path=path)
+            reader.poll()
+            self.assertIsNone(reader.state)
+
+            with path.open("a", encoding="utf-8") as fp:
+                fp.write(_snapshot_line(6, 3000, equity_usd=10300.0) + "\n")
+            reader.poll()
+            self.assertEqual(reader.version, 6)
+            self.assertEqual(reader.state["equity_usd"], 10300.0)
+
+    def test_mid_stream_join_waits_for_snapshot(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text(
+                _delta_line(7, 1000, {"equity_usd": 1.0}) + "\n",
+                encoding="utf-8",
+            )
+            reader = StateStreamReader(path=path)
+            reader.poll()
+            self.assertIsNone(reader.state)
+
+    def test_invalid_line_raises(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = pathlib.Path(tmp) / "state_stream.jsonl"
+            path.write_text("not json\n", encoding="utf-8")
+            reader = StateStreamReader(path=path)
+            with self.assertRaises(StateStreamError):
+                reader.poll()
+
+
+if __name__ == "__main__":
+    unittest.main()
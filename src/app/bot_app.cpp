@@ -1,9 +1,15 @@
 #include "app/bot_app.h"
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <ctime>
+#include <filesystem>
 #include <iomanip>
 #include <limits>
 #include <sstream>
@@ -11,17 +17,27 @@
 #include <unordered_set>
 #include <utility>
 
+#include "core/clock.h"
+#include "core/line_writer.h"
 #include "core/log.h"
+#include "core/thread_topology.h"
+#include "core/reason_codes.h"
+#include "core/symbol_table.h"
 #include "app/intent_policy.h"
 #include "exchange/binance_exchange_adapter.h"
 #include "exchange/bybit_exchange_adapter.h"
 #include "exchange/mock_exchange_adapter.h"
+#include "exchange/mux_exchange_adapter.h"
+#include "research/bar_store.h"
+#include "storage/state_snapshot.h"
 
 namespace ai_trade {
 
 namespace {
 
 constexpr double kNotionalEpsilon = 1e-9;
+// 状态快照写出间隔（墙钟 ms）：重启恢复只回放该窗口内的 WAL 尾部。
+constexpr std::int64_t kStateSnapshotIntervalMs = 60'000;
 // 成交落地后，给远端持仓快照一个极短收敛窗口，避免瞬时对账误判。
 constexpr int kReconcileRecentFillGraceTicks = 2;
 // 若 symbol 级 delta 能被最近成交精确解释，则再给一段短暂宽限，避免刚撤出 pending 状态就被误重对齐。
@@ -45,10 +61,9 @@ double EffectiveQualityGuardMaxFeeBps(const AppConfig& config) {
 }
 
 // 统一毫秒时间戳，供节流、日志和心跳逻辑复用。
+// 读取主循环每轮刷新一次的缓存时钟，避免每个事件各打一次系统调用。
 std::int64_t CurrentTimestampMs() {
-  const auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(
-      std::chrono::system_clock::now());
-  return now.time_since_epoch().count();
+  return NowMsCached();
 }
 
 std::string CurrentUtcIsoTimestamp() {
@@ -116,39 +131,22 @@ double SafeRatio(double numerator, double denominator) {
   return numerator / denominator;
 }
 
-double StepAwareExecutableNotionalFloor(const ExchangeAdapter* adapter,
+double StepAwareExecutableNotionalFloor(QuantizationTable* quant_table,
+                                        const ExchangeAdapter* adapter,
                                         const std::string& symbol,
                                         double price,
                                         double min_notional_usd) {
   const double base_floor = std::max(0.0, min_notional_usd);
-  if (base_floor <= kNotionalEpsilon || adapter == nullptr || symbol.empty() ||
-      !std::isfinite(price) || price <= kNotionalEpsilon) {
-    return base_floor;
-  }
-
-  SymbolInfo info;
-  if (!adapter->GetSymbolInfo(symbol, &info) || !info.tradable ||
-      info.qty_step <= kNotionalEpsilon) {
+  if (base_floor <= kNotionalEpsilon || quant_table == nullptr ||
+      symbol.empty() || !std::isfinite(price) || price <= kNotionalEpsilon) {
     return base_floor;
   }
 
-  const double min_qty =
-      std::max(base_floor / price, std::max(0.0, info.min_order_qty));
-  const double steps =
-      std::ceil(std::max(0.0, min_qty - 1e-12) / info.qty_step);
-  if (!std::isfinite(steps) || steps <= 0.0) {
+  const SymbolQuantization* quant = quant_table->FindOrLoad(symbol, adapter);
+  if (quant == nullptr) {
     return base_floor;
   }
-  return std::max(base_floor, steps * info.qty_step * price);
-}
-
-bool HasReasonCode(const Signal& signal, const char* code) {
-  if (code == nullptr || *code == '\0') {
-    return false;
-  }
-  return std::find(signal.reason_codes.begin(),
-                   signal.reason_codes.end(),
-                   std::string(code)) != signal.reason_codes.end();
+  return quant->StepNotionalFloor(price, base_floor);
 }
 
 bool IsPolicySuppressedFlatSignal(const Signal& signal) {
@@ -157,13 +155,13 @@ bool IsPolicySuppressedFlatSignal(const Signal& signal) {
       HasExposure(signal.defensive_notional_usd)) {
     return false;
   }
-  if (HasReasonCode(signal, "STR_RANGE_CONFIDENCE_BLOCK") ||
-      HasReasonCode(signal, "STR_EXTREME_BLOCK")) {
+  if (HasReason(signal.reason_mask, ReasonCode::kStrRangeConfidenceBlock) ||
+      HasReason(signal.reason_mask, ReasonCode::kStrExtremeBlock)) {
     return true;
   }
-  return HasReasonCode(signal, "STR_FLAT_SIGNAL") &&
-         (HasReasonCode(signal, "REG_RANGE") ||
-          HasReasonCode(signal, "REG_EXTREME"));
+  return HasReason(signal.reason_mask, ReasonCode::kStrFlatSignal) &&
+         (HasReason(signal.reason_mask, ReasonCode::kRegRange) ||
+          HasReason(signal.reason_mask, ReasonCode::kRegExtreme));
 }
 
 int TrendCandidateProbeDirection(const RegimeState& regime) {
@@ -335,12 +333,24 @@ bool AccountAlreadyReflectsFill(const FillEvent& fill,
 }
 
 std::string FormatFillSummary(const FillEvent& fill) {
-  std::ostringstream oss;
-  oss << "fill_id=" << fill.fill_id << ", client_order_id=" << fill.client_order_id
-      << ", symbol=" << fill.symbol << ", direction=" << fill.direction
-      << ", qty=" << fill.qty << ", price=" << fill.price << ", fee=" << fill.fee
-      << ", liquidity=" << ToString(fill.liquidity);
-  return oss.str();
+  LineWriter writer(160);
+  writer.Append("fill_id=")
+      .Append(fill.fill_id)
+      .Append(", client_order_id=")
+      .Append(fill.client_order_id)
+      .Append(", symbol=")
+      .Append(fill.symbol)
+      .Append(", direction=")
+      .AppendInt(fill.direction)
+      .Append(", qty=")
+      .AppendDouble(fill.qty)
+      .Append(", price=")
+      .AppendDouble(fill.price)
+      .Append(", fee=")
+      .AppendDouble(fill.fee)
+      .Append(", liquidity=")
+      .Append(ToString(fill.liquidity));
+  return writer.TakeString();
 }
 
 std::string FormatAccountPositions(const AccountState& account) {
@@ -348,7 +358,7 @@ std::string FormatAccountPositions(const AccountState& account) {
   if (symbols.empty()) {
     return "flat";
   }
-  std::ostringstream oss;
+  LineWriter writer(160);
   bool first = true;
   for (const auto& symbol : symbols) {
     const double qty = account.position_qty(symbol);
@@ -356,54 +366,65 @@ std::string FormatAccountPositions(const AccountState& account) {
       continue;
     }
     if (!first) {
-      oss << ";";
+      writer.Append(';');
     }
     first = false;
-    const double mark = account.mark_price(symbol);
-    const double notional = account.current_notional_usd(symbol);
-    oss << symbol << ":qty=" << qty << ",mark=" << mark
-        << ",notional=" << notional;
+    writer.Append(symbol)
+        .Append(":qty=")
+        .AppendDouble(qty)
+        .Append(",mark=")
+        .AppendDouble(account.mark_price(symbol))
+        .Append(",notional=")
+        .AppendDouble(account.current_notional_usd(symbol));
   }
   if (first) {
     return "flat";
   }
-  return oss.str();
+  return writer.TakeString();
 }
 
 std::string FormatRemoteBalanceSummary(const RemoteAccountBalanceSnapshot& balance) {
-  std::ostringstream oss;
-  oss << "remote={equity=";
+  LineWriter writer(128);
+  writer.Append("remote={equity=");
   if (balance.has_equity) {
-    oss << balance.equity_usd;
+    writer.AppendDouble(balance.equity_usd);
   } else {
-    oss << "n/a";
+    writer.Append("n/a");
   }
-  oss << ", wallet=";
+  writer.Append(", wallet=");
   if (balance.has_wallet_balance) {
-    oss << balance.wallet_balance_usd;
+    writer.AppendDouble(balance.wallet_balance_usd);
   } else {
-    oss << "n/a";
+    writer.Append("n/a");
   }
-  oss << ", unrealized=";
+  writer.Append(", unrealized=");
   if (balance.has_unrealized_pnl) {
-    oss << balance.unrealized_pnl_usd;
+    writer.AppendDouble(balance.unrealized_pnl_usd);
   } else {
-    oss << "n/a";
+    writer.Append("n/a");
   }
-  oss << "}";
-  return oss.str();
+  writer.Append('}');
+  return writer.TakeString();
 }
 
 std::string FormatLocalAccountLedgerSummary(const AccountState& account) {
-  std::ostringstream oss;
-  oss << "local={cash=" << account.cash_usd()
-      << ", equity=" << account.equity_usd()
-      << ", unrealized=" << account.unrealized_pnl_usd()
-      << ", realized_pnl=" << account.cumulative_realized_pnl_usd()
-      << ", fees=" << account.cumulative_fee_usd()
-      << ", realized_net=" << account.cumulative_realized_net_pnl_usd()
-      << ", positions=" << FormatAccountPositions(account) << "}";
-  return oss.str();
+  LineWriter writer(192);
+  writer.Append("local={cash=")
+      .AppendDouble(account.cash_usd())
+      .Append(", equity=")
+      .AppendDouble(account.equity_usd())
+      .Append(", unrealized=")
+      .AppendDouble(account.unrealized_pnl_usd())
+      .Append(", realized_pnl=")
+      .AppendDouble(account.cumulative_realized_pnl_usd())
+      .Append(", fees=")
+      .AppendDouble(account.cumulative_fee_usd())
+      .Append(", realized_net=")
+      .AppendDouble(account.cumulative_realized_net_pnl_usd())
+      .Append(", positions=")
+      .Append(FormatAccountPositions(account))
+      .Append('}');
+  return writer.TakeString();
 }
 
 void LogAccountSyncSnapshot(const std::string& stage,
@@ -495,14 +516,14 @@ std::string FormatSymbolList(const std::vector<std::string>& symbols) {
   if (symbols.empty()) {
     return "n/a";
   }
-  std::ostringstream oss;
+  LineWriter writer(96);
   for (std::size_t i = 0; i < symbols.size(); ++i) {
     if (i > 0) {
-      oss << ",";
+      writer.Append(',');
     }
-    oss << symbols[i];
+    writer.Append(symbols[i]);
   }
-  return oss.str();
+  return writer.TakeString();
 }
 
 std::string FormatSymbolScores(const std::vector<SymbolScore>& scores,
@@ -510,19 +531,19 @@ std::string FormatSymbolScores(const std::vector<SymbolScore>& scores,
   if (scores.empty()) {
     return "n/a";
   }
-  std::ostringstream oss;
-  oss << std::fixed << std::setprecision(4);
+  LineWriter writer(128);
   const std::size_t limit = std::min(max_items, scores.size());
   for (std::size_t i = 0; i < limit; ++i) {
     if (i > 0) {
-      oss << ",";
+      writer.Append(',');
     }
-    oss << scores[i].symbol << ":" << scores[i].score;
+    writer.Append(scores[i].symbol).Append(':').AppendDoubleFixed(
+        scores[i].score, 4);
   }
   if (limit < scores.size()) {
-    oss << ",...";
+    writer.Append(",...");
   }
-  return oss.str();
+  return writer.TakeString();
 }
 
 struct ConcentrationSnapshot {
@@ -590,12 +611,13 @@ ConcentrationSnapshot BuildConcentrationSnapshot(
  * 副作用：
  * - 若量化后数量有效，会将 intent->qty 下修为量化后的可提交数量。
  */
-bool ViolatesExchangePretradeGuard(const ExchangeAdapter* adapter,
+bool ViolatesExchangePretradeGuard(QuantizationTable* quant_table,
+                                   const ExchangeAdapter* adapter,
                                    OrderIntent* intent,
                                    const MarketEvent& event,
                                    std::string* out_reason) {
   constexpr double kQtyEpsilon = 1e-12;
-  if (adapter == nullptr || intent == nullptr) {
+  if (quant_table == nullptr || intent == nullptr) {
     return false;
   }
   if (!std::isfinite(intent->qty) || intent->qty <= 0.0) {
@@ -605,50 +627,48 @@ bool ViolatesExchangePretradeGuard(const ExchangeAdapter* adapter,
     return true;
   }
 
-  SymbolInfo info;
-  if (!adapter->GetSymbolInfo(intent->symbol, &info)) {
-    return false;
-  }
-  if (!info.tradable) {
+  const SymbolQuantization* quant =
+      quant_table->FindOrLoad(intent->symbol, adapter);
+  if (quant == nullptr || !quant->tradable) {
     return false;
   }
 
-  double submit_qty = intent->qty;
-  if (info.qty_step > 0.0) {
-    const double steps = std::floor((submit_qty + kQtyEpsilon) / info.qty_step);
-    submit_qty = steps > 0.0 ? steps * info.qty_step : 0.0;
-  }
+  // 预计算倒数乘子做步长对齐：无除法、无规则表查询拷贝。
+  const double submit_qty = quant->QuantizeQtyFloor(intent->qty);
   if (!std::isfinite(submit_qty) || submit_qty <= kQtyEpsilon) {
     if (out_reason != nullptr) {
-      *out_reason = "qty_guard_quantized_zero(raw_qty=" +
-                    std::to_string(intent->qty) + ", qty_step=" +
-                    std::to_string(info.qty_step) + ")";
+      *out_reason = "qty_guard_quantized_zero(raw_qty=";
+      quant->AppendFormattedQty(intent->qty, out_reason);
+      *out_reason += ", qty_step=" + std::to_string(quant->qty_step) + ")";
     }
     return true;
   }
 
-  if (!intent->reduce_only && info.min_order_qty > 0.0 &&
-      submit_qty + kQtyEpsilon < info.min_order_qty) {
+  if (!intent->reduce_only && quant->min_order_qty > 0.0 &&
+      submit_qty + kQtyEpsilon < quant->min_order_qty) {
     if (out_reason != nullptr) {
-      *out_reason = "min_qty_guard(order_qty=" + std::to_string(submit_qty) +
-                    ", min_order_qty=" + std::to_string(info.min_order_qty) + ")";
+      *out_reason = "min_qty_guard(order_qty=";
+      quant->AppendFormattedQty(submit_qty, out_reason);
+      *out_reason += ", min_order_qty=";
+      quant->AppendFormattedQty(quant->min_order_qty, out_reason);
+      *out_reason += ")";
     }
     return true;
   }
 
-  if (!intent->reduce_only && info.min_notional_usd > 0.0) {
+  if (!intent->reduce_only && quant->min_notional_usd > 0.0) {
     const double ref_price =
         intent->price > 0.0
             ? intent->price
             : (event.mark_price > 0.0 ? event.mark_price : event.price);
     if (ref_price > 0.0) {
       const double order_notional = submit_qty * ref_price;
-      if (order_notional + 1e-9 < info.min_notional_usd) {
+      if (order_notional + 1e-9 < quant->min_notional_usd) {
         if (out_reason != nullptr) {
           *out_reason = "min_notional_guard(order_notional=" +
                         std::to_string(order_notional) +
-                        ", min_notional=" + std::to_string(info.min_notional_usd) +
-                        ")";
+                        ", min_notional=" +
+                        std::to_string(quant->min_notional_usd) + ")";
         }
         return true;
       }
@@ -690,6 +710,8 @@ std::unique_ptr<ExchangeAdapter> CreateAdapter(const AppConfig& config) {
     options.primary_symbol = config.primary_symbol;
     options.public_ws_enabled = config.bybit.public_ws_enabled;
     options.public_ws_rest_fallback = config.bybit.public_ws_rest_fallback;
+    options.orderbook_enabled = config.bybit.orderbook_enabled;
+    options.orderbook_depth = config.bybit.orderbook_depth;
     options.private_ws_enabled = config.bybit.private_ws_enabled;
     options.private_ws_rest_fallback = config.bybit.private_ws_rest_fallback;
     options.ws_reconnect_interval_ms = config.bybit.ws_reconnect_interval_ms;
@@ -720,6 +742,22 @@ std::unique_ptr<ExchangeAdapter> CreateAdapter(const AppConfig& config) {
     return std::make_unique<BinanceExchangeAdapter>();
   }
 
+  if (config.exchange == "mux") {
+    // 各 venue 复用单所的创建路径（含各自的 WS/回放选项），
+    // 行情归并与执行路由由 mux 层负责。
+    std::vector<MuxExchangeAdapter::Venue> venues;
+    for (const std::string& venue_name : config.mux.market_venues) {
+      if (venue_name == "mux") {
+        continue;  // 禁止自嵌套
+      }
+      AppConfig venue_config = config;
+      venue_config.exchange = venue_name;
+      venues.push_back(
+          MuxExchangeAdapter::Venue{venue_name, CreateAdapter(venue_config)});
+    }
+    return std::make_unique<MuxExchangeAdapter>(std::move(venues), config.mux);
+  }
+
   // Mock Adapter 默认行为
   std::vector<double> prices = {100.0, 100.5, 100.7, 100.2, 99.8, 100.1};
   return std::make_unique<MockExchangeAdapter>(prices, collect_symbols());
@@ -763,12 +801,62 @@ BotApplication::BotApplication(const AppConfig& config)
           .min_order_interval_ms = config.execution_min_order_interval_ms,
           .reverse_signal_cooldown_ticks =
               config.execution_reverse_signal_cooldown_ticks,
+          .api_budget_per_window = config.execution_api_budget_per_window,
+          .api_budget_window_ms = config.execution_api_budget_window_ms,
+          .api_order_budget_per_window =
+              config.execution_api_order_budget_per_window,
       }),
       self_evolution_(config.self_evolution),
       reconciler_(config.reconcile.tolerance_notional_usd),
       gate_monitor_(config.gate),
       universe_selector_(config.universe, config.primary_symbol),
-      wal_(config.data_path + "/trade.wal") {}
+      wal_(config.data_path + "/trade.wal"),
+      state_snapshot_path_(config.data_path + "/state.snapshot") {}
+
+bool BotApplication::EnableConfigHotReload(const std::string& config_path,
+                                           std::string* out_error) {
+  return config_watcher_.Start(config_path, out_error);
+}
+
+void BotApplication::ApplyHotConfigUpdate(const AppConfig& updated) {
+  AppConfig merged = updated;
+  // 拓扑与启动期消费的字段保持启动快照：交易所连接、symbol 池、
+  // 以及 Gate/对账/自进化等在构造时各自拷贝配置的子系统，热更新
+  // 这里的副本只会造成口径错位，统一要求重启生效。
+  merged.system_id = config_.system_id;
+  merged.mode = config_.mode;
+  merged.exchange = config_.exchange;
+  merged.primary_symbol = config_.primary_symbol;
+  merged.data_path = config_.data_path;
+  merged.regime_preload_dir = config_.regime_preload_dir;
+  merged.decision_journal_dir = config_.decision_journal_dir;
+  merged.decision_journal_rotate_mb = config_.decision_journal_rotate_mb;
+  merged.metrics_port = config_.metrics_port;
+  merged.executor_lanes = config_.executor_lanes;
+  merged.risk_max_abs_notional_usd = config_.risk_max_abs_notional_usd;
+  merged.risk_thresholds = config_.risk_thresholds;
+  merged.bybit = config_.bybit;
+  merged.universe = config_.universe;
+  merged.gate = config_.gate;
+  merged.reconcile = config_.reconcile;
+  merged.self_evolution = config_.self_evolution;
+  merged.integrator = config_.integrator;
+  config_ = merged;
+
+  system_.ApplyHotConfig(config_);
+  execution_.SetConfig(config_.GetExecutionEngineConfig());
+  order_throttle_.SetConfig({
+      .min_order_interval_ms = config_.execution_min_order_interval_ms,
+      .reverse_signal_cooldown_ticks =
+          config_.execution_reverse_signal_cooldown_ticks,
+      .api_budget_per_window = config_.execution_api_budget_per_window,
+      .api_budget_window_ms = config_.execution_api_budget_window_ms,
+      .api_order_budget_per_window =
+          config_.execution_api_order_budget_per_window,
+  });
+  LogInfo("CONFIG_HOT_RELOAD_APPLIED: 策略/Regime/保护/执行节流参数已在线更新"
+          "（拓扑字段保持启动快照）");
+}
 
 double BotApplication::RoundTripCostBps() const {
   const double entry_fee_bps = std::max(0.0, config_.execution_entry_fee_bps);
@@ -1537,7 +1625,7 @@ bool BotApplication::TryApplyTrendCandidateProbe(
   const double configured_min_executable_notional =
       std::max(0.0, config_.execution_min_rebalance_notional_usd);
   const double min_executable_notional =
-      StepAwareExecutableNotionalFloor(adapter_.get(),
+      StepAwareExecutableNotionalFloor(&quant_table_, adapter_.get(),
                                        event.symbol,
                                        price,
                                        configured_min_executable_notional);
@@ -1619,13 +1707,11 @@ bool BotApplication::TryApplyTrendCandidateProbe(
   probe_signal.valid_until_ms =
       event.ts_ms +
       std::max<std::int64_t>(decision->regime.decision_interval_ms, 0);
-  probe_signal.reason_codes = {
-      "STR_TREND_CANDIDATE_PROBE",
-      "REG_TREND_CANDIDATE",
-      "EXEC_MAKER_PROBE",
-  };
+  probe_signal.reason_mask = ReasonBit(ReasonCode::kStrTrendCandidateProbe) |
+                             ReasonBit(ReasonCode::kRegTrendCandidate) |
+                             ReasonBit(ReasonCode::kExecMakerProbe);
   if (strong_min_trend_ratio > 0.0) {
-    probe_signal.reason_codes.push_back("EXEC_STRONG_TREND_PROBE");
+    SetReason(&probe_signal.reason_mask, ReasonCode::kExecStrongTrendProbe);
   }
 
   decision->base_signal = probe_signal;
@@ -1842,7 +1928,7 @@ void BotApplication::ManageCandidateProbeLifecycle(const MarketEvent& event) {
     const double configured_min_executable_notional =
         std::max(0.0, config_.execution_min_rebalance_notional_usd);
     const double replacement_min_executable_notional =
-        StepAwareExecutableNotionalFloor(adapter_.get(),
+        StepAwareExecutableNotionalFloor(&quant_table_, adapter_.get(),
                                          event.symbol,
                                          reference_price,
                                          configured_min_executable_notional);
@@ -1886,8 +1972,8 @@ void BotApplication::ManageCandidateProbeLifecycle(const MarketEvent& event) {
         state.replacement_taker ? LiquidityPreference::kTaker
                                 : LiquidityPreference::kMaker;
     std::string guard_reason;
-    if (ViolatesExchangePretradeGuard(adapter_.get(), &*replacement, event,
-                                      &guard_reason)) {
+    if (ViolatesExchangePretradeGuard(&quant_table_, adapter_.get(),
+                                      &*replacement, event, &guard_reason)) {
       ++funnel_window_.candidate_probe_expired_without_fill;
       LogInfo("TREND_CANDIDATE_PROBE_EXPIRED_WITHOUT_FILL: symbol=" +
               event.symbol +
@@ -3030,6 +3116,27 @@ void BotApplication::AccumulateStats(DecisionFunnelStats* total,
       delta.entry_fills_taker_notional_abs_usd_sum;
 }
 
+void BotApplication::DrainFunnelSymbolShards() {
+  std::vector<ShardedSymbolStats::SymbolTotals> drained;
+  symbol_fill_quality_shards_.Drain(&drained);
+  for (const auto& totals : drained) {
+    auto& quality = funnel_window_.symbol_fill_quality_by_symbol[totals.symbol];
+    quality.fills += totals.fills;
+    quality.net_quality_fills += totals.net_quality_fills;
+    quality.realized_net_sum_usd += totals.realized_net_sum_usd;
+    quality.fee_usd_sum += totals.fee_usd_sum;
+    quality.notional_abs_usd_sum += totals.notional_abs_usd_sum;
+  }
+  entry_fill_quality_shards_.Drain(&drained);
+  for (const auto& totals : drained) {
+    auto& quality = funnel_window_.entry_fill_quality_by_symbol[totals.symbol];
+    quality.fills += totals.fills;
+    quality.realized_net_sum_usd += totals.realized_net_sum_usd;
+    quality.fee_usd_sum += totals.fee_usd_sum;
+    quality.notional_abs_usd_sum += totals.notional_abs_usd_sum;
+  }
+}
+
 bool BotApplication::IsForceReduceOnlyActive() const {
   return protection_forced_reduce_only_ || gate_forced_reduce_only_ ||
          reconcile_forced_reduce_only_;
@@ -3085,6 +3192,9 @@ void BotApplication::TickGateRuntimeCooldown() {
 int BotApplication::Run() {
   LogInfo("PROCESS_START: boot_id=" + boot_id_ + ", startup_utc=" +
           startup_utc_ + ", primary_symbol=" + config_.primary_symbol);
+  // 拓扑先于一切线程创建安装：Initialize 期间派生的后台/执行线程
+  // 在各自入口领取角色绑核。
+  ConfigureThreadTopology(config_.threads);
   if (!Initialize()) {
     return 1;
   }
@@ -3115,6 +3225,9 @@ int BotApplication::CheckStartup() {
  * 4. 初始化 Universe 并同步远端持仓。
  */
 bool BotApplication::Initialize() {
+  // 定时轮以启动时刻为锚点，后续随主循环缓存时钟推进。
+  timer_wheel_ = TimerWheel(CurrentTimestampMs());
+
   std::string wal_error;
   if (!wal_.Initialize(&wal_error)) {
     LogError("WAL 初始化失败: " + wal_error);
@@ -3124,18 +3237,118 @@ bool BotApplication::Initialize() {
   if (config_.mode == "replay") {
     LogInfo("replay 模式：跳过历史 WAL 恢复");
   } else {
+    // 先恢复最近一次状态快照，再只回放快照之后的 WAL 尾部；
+    // 快照缺失/损坏时退回完整 WAL 回放的冷启动路径。
+    std::unordered_set<std::string> snapshot_fill_ids;
+    bool snapshot_restored = false;
+    std::string snapshot_error;
+    if (LoadStateSnapshot(state_snapshot_path_, &system_, &snapshot_fill_ids,
+                          &snapshot_error)) {
+      snapshot_restored = true;
+      LogInfo("STATE_SNAPSHOT_RESTORED: fills=" +
+              std::to_string(snapshot_fill_ids.size()));
+    } else {
+      LogInfo("STATE_SNAPSHOT_MISS: " + snapshot_error);
+    }
+
     std::vector<FillEvent> historical_fills;
     if (!wal_.LoadState(&intent_ids_, &fill_ids_, &historical_fills, &wal_error)) {
       LogError("WAL 加载失败: " + wal_error);
       return false;
     }
-    // 仅回放成交恢复仓位和权益，Intent 去重由 intent_ids_ 负责。
+    // 仅回放成交恢复仓位和权益，Intent 去重由 intent_ids_ 负责；
+    // 已计入快照的成交只喂 OMS（其状态不在快照内），不再重复记账。
+    std::size_t tail_fills = 0;
     for (const auto& fill : historical_fills) {
       oms_.OnFill(fill);
+      if (snapshot_restored && snapshot_fill_ids.count(fill.fill_id) > 0) {
+        continue;
+      }
       system_.OnFill(fill);
+      ++tail_fills;
     }
     LogInfo("WAL 恢复完成: intents=" + std::to_string(intent_ids_.size()) +
-            ", fills=" + std::to_string(fill_ids_.size()));
+            ", fills=" + std::to_string(fill_ids_.size()) +
+            ", tail_fills=" + std::to_string(tail_fills));
+  }
+
+  // 可选二进制决策日志：初始化失败只降级为关闭，不阻塞启动。
+  if (!config_.decision_journal_dir.empty()) {
+    auto journal = std::make_unique<DecisionJournal>(
+        config_.decision_journal_dir,
+        static_cast<std::int64_t>(config_.decision_journal_rotate_mb) * 1024 *
+            1024);
+    std::string journal_error;
+    if (journal->Initialize(&journal_error)) {
+      decision_journal_ = std::move(journal);
+      LogInfo("DECISION_JOURNAL_ENABLED: file=" +
+              decision_journal_->current_file() + ", rotate_mb=" +
+              std::to_string(config_.decision_journal_rotate_mb));
+    } else {
+      LogError("决策日志初始化失败，已禁用: " + journal_error);
+    }
+  }
+
+  // 指标槽位注册（幂等）；scrape 端点按配置端口可选启动，失败只降级。
+  auto& metrics = MetricsRegistry::Instance();
+  metric_ticks_ =
+      metrics.RegisterCounter("ai_trade_ticks_total", "已处理行情 tick 总数");
+  metric_intents_enqueued_ = metrics.RegisterCounter(
+      "ai_trade_intents_enqueued_total", "已进入执行队列的订单意图总数");
+  metric_fills_ =
+      metrics.RegisterCounter("ai_trade_fills_total", "已应用成交总数");
+  metric_async_submit_ok_ = metrics.RegisterCounter(
+      "ai_trade_async_submit_ok_total", "异步发单成功总数");
+  metric_async_submit_failed_ = metrics.RegisterCounter(
+      "ai_trade_async_submit_failed_total", "异步发单失败总数");
+  metric_equity_usd_ =
+      metrics.RegisterGauge("ai_trade_equity_usd", "账户权益（USD）");
+  metric_gross_notional_usd_ = metrics.RegisterGauge(
+      "ai_trade_gross_notional_usd", "账户总名义敞口（USD）");
+  metric_throttle_checks_ = metrics.RegisterGauge(
+      "ai_trade_throttle_checks", "下单节流累计检查数");
+  metric_throttle_rejected_ = metrics.RegisterGauge(
+      "ai_trade_throttle_rejected", "下单节流累计拒绝数");
+  metric_evaluate_latency_ = metrics.RegisterHistogram(
+      "ai_trade_evaluate_latency_seconds", "tick->intent 决策耗时");
+  metric_tick_conflated_ = metrics.RegisterCounter(
+      "ai_trade_tick_conflated_total", "决策侧按 symbol 折叠掉的超时 tick 数");
+  metric_tick_backlog_ = metrics.RegisterGauge(
+      "ai_trade_tick_backlog", "决策侧最新值暂存表当前 symbol 数");
+  if (config_.metrics_port > 0) {
+    std::string metrics_error;
+    if (metrics_server_.Start(config_.metrics_port, &metrics_error)) {
+      LogInfo("METRICS_ENDPOINT_ENABLED: port=" +
+              std::to_string(metrics_server_.bound_port()));
+    } else {
+      LogError("metrics 端点启动失败，已禁用: " + metrics_error);
+    }
+  }
+
+  if (!config_.shm_event_bus_path.empty()) {
+    std::string shm_error;
+    constexpr std::size_t kShmEventBusCapacity = 1 << 14;
+    if (shm_bus_.Create(config_.shm_event_bus_path, kShmEventBusCapacity,
+                        &shm_error)) {
+      LogInfo("SHM_EVENT_BUS_ENABLED: path=" + config_.shm_event_bus_path);
+    } else {
+      LogError("共享内存事件总线创建失败，已禁用: " + shm_error);
+    }
+  }
+
+  if (!config_.state_delta_stream_path.empty()) {
+    std::string stream_error;
+    if (state_delta_stream_.Open(
+            config_.state_delta_stream_path,
+            config_.state_delta_snapshot_interval,
+            static_cast<std::int64_t>(config_.state_delta_rotate_mb) * 1024 *
+                1024,
+            &stream_error)) {
+      LogInfo("STATE_DELTA_STREAM_ENABLED: path=" +
+              config_.state_delta_stream_path);
+    } else {
+      LogError("状态增量流创建失败，已禁用: " + stream_error);
+    }
   }
 
   adapter_ = CreateAdapter(config_);
@@ -3151,11 +3364,13 @@ bool BotApplication::Initialize() {
   }
 
   // 执行通道单线程串行化，避免并发提交导致状态竞态。
-  executor_ = std::make_unique<AsyncExecutor>(adapter_.get());
+  executor_ =
+      std::make_unique<AsyncExecutor>(adapter_.get(), config_.executor_lanes);
   executor_->Start();
 
   InitializeUniverse();
   SyncRemotePositions();
+  WarmStartRegimeFromPreload();
 
   if (config_.integrator.enabled &&
       system_.integrator_mode() != IntegratorMode::kOff &&
@@ -3187,7 +3402,24 @@ bool BotApplication::Initialize() {
       LogError("自进化初始权重设置失败: " + error);
       return false;
     }
-    if (!self_evolution_.Initialize(
+    // 回放模式强制同步路径：异步落地会破坏逐 tick 可复现性。
+    const bool async_evolution =
+        config_.self_evolution.async_pipeline_enabled &&
+        config_.mode != "replay";
+    if (async_evolution) {
+      evolution_pipeline_ =
+          std::make_unique<EvolutionPipeline>(config_.self_evolution);
+      if (!evolution_pipeline_->Initialize(
+              /*current_tick=*/0,
+              system_.account().equity_usd(),
+              {config_.self_evolution.initial_trend_weight,
+               config_.self_evolution.initial_defensive_weight},
+              &error,
+              system_.account().cumulative_realized_net_pnl_usd())) {
+        LogError("自进化流水线初始化失败: " + error);
+        return false;
+      }
+    } else if (!self_evolution_.Initialize(
             /*current_tick=*/0,
             system_.account().equity_usd(),
             {config_.self_evolution.initial_trend_weight,
@@ -3197,7 +3429,9 @@ bool BotApplication::Initialize() {
       LogError("自进化控制器初始化失败: " + error);
       return false;
     }
-    LogInfo("SELF_EVOLUTION_INIT: trend_weight=" +
+    LogInfo("SELF_EVOLUTION_INIT: async_pipeline=" +
+            std::string(async_evolution ? "true" : "false") +
+            ", trend_weight=" +
             std::to_string(config_.self_evolution.initial_trend_weight) +
             ", defensive_weight=" +
             std::to_string(config_.self_evolution.initial_defensive_weight) +
@@ -3237,6 +3471,8 @@ void BotApplication::InitializeUniverse() {
     // 过滤掉不可交易或规则异常的币对
     if (!adapter_->GetSymbolInfo(symbol, &info)) continue;
     if (!info.tradable || info.qty_step <= 0.0) continue;
+    // 顺路构建预计算量化表，运行期守卫不再逐单查询交易规则。
+    quant_table_.Load(info);
     allowed.push_back(info.symbol);
   }
 
@@ -3297,13 +3533,21 @@ void BotApplication::SyncRemotePositions() {
  * 4. 周期任务（远端风险刷新、对账、Gate、状态日志）。
  */
 void BotApplication::RunLoop() {
+  ApplyThreadRole(ThreadRole::kDecision);
+  StartFeedReader();
+  // 读取线程启用后，决策线程只从环里取已解码事件；否则保持原地轮询。
+  const bool feed_reader_active = feed_reader_thread_.joinable();
   MarketEvent event;
   while (true) {
-    const bool has_market = adapter_->PollMarket(&event);
+    // 每轮只读一次系统时钟，本轮内所有时间戳复用缓存值。
+    RefreshCachedClock();
+    const bool has_market = FetchConflatedMarket(&event, feed_reader_active);
     bool advanced_tick = false;
     bool has_fill = false;
 
     if (has_market) {
+      // 适配器边界 intern 一次，热路径引擎全程按 id 做稠密索引。
+      event.symbol_id = InternSymbol(event.symbol);
       advanced_tick = true;
       has_tick_strategy_signal_ = false;
       tick_cost_filtered_signal_ = false;
@@ -3320,7 +3564,9 @@ void BotApplication::RunLoop() {
       has_fill = true;
       ProcessFillEvent(fill);
     }
-    CheckPendingRequiredSlTimeouts();
+    // 统一定时服务：到期回调（required SL 确认截止等）按时间序触发，
+    // 成本只与到期数量相关，替代各模块每轮全量扫描。
+    timer_wheel_.Advance(CurrentTimestampMs());
 
     if (advanced_tick) {
       ++market_tick_count_;
@@ -3329,6 +3575,16 @@ void BotApplication::RunLoop() {
       RunGateMonitor();
       RunSelfEvolution();
       LogStatus();
+      // tick 边界认领热加载快照：解析/校验已在监视线程完成，
+      // 这里只剩无锁 exchange + 参数覆盖。
+      if (const auto updated = config_watcher_.PollUpdated()) {
+        ApplyHotConfigUpdate(*updated);
+      }
+      MaybeWriteStateSnapshot();
+    }
+
+    if (advanced_tick || has_fill) {
+      PublishStateDelta();
     }
 
     if (ShouldExit(has_market, has_fill)) {
@@ -3336,8 +3592,192 @@ void BotApplication::RunLoop() {
     }
 
     if (!has_market && !has_fill) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      WaitForWork();
+    }
+  }
+  StopFeedReader();
+}
+
+bool BotApplication::FetchConflatedMarket(MarketEvent* out_event,
+                                          bool from_ring) {
+  if (!config_.tick_conflation_enabled || config_.mode == "replay") {
+    // 未开启或回放模式：按原始事件序逐条透传（回放要求历史节拍不变）。
+    return from_ring ? feed_ring_->TryPop(out_event)
+                     : adapter_->PollMarket(out_event);
+  }
+
+  // 单轮收数上限：决策落后时来源可能持续有新事件，设界保证成交
+  // 回报与周期任务不会被收数阶段饿死。
+  constexpr int kMaxDrainPerCycle = 1024;
+  MarketEvent incoming;
+  for (int drained = 0; drained < kMaxDrainPerCycle; ++drained) {
+    const bool has_market = from_ring ? feed_ring_->TryPop(&incoming)
+                                      : adapter_->PollMarket(&incoming);
+    if (!has_market) {
+      break;
+    }
+    const auto it = pending_ticks_.find(incoming.symbol);
+    if (it == pending_ticks_.end()) {
+      pending_tick_order_.push_back(incoming.symbol);
+      pending_ticks_.emplace(incoming.symbol, std::move(incoming));
+    } else {
+      // 被覆盖的中间 tick 折叠进幸存事件：价格取最新，增量字段累加。
+      ConflateMarketEvent(&it->second, incoming);
+      if (metric_tick_conflated_ != nullptr) {
+        metric_tick_conflated_->Inc();
+      }
+    }
+  }
+  if (metric_tick_backlog_ != nullptr) {
+    metric_tick_backlog_->Set(static_cast<double>(pending_ticks_.size()));
+  }
+
+  while (!pending_tick_order_.empty()) {
+    const auto it = pending_ticks_.find(pending_tick_order_.front());
+    pending_tick_order_.pop_front();
+    if (it == pending_ticks_.end()) {
+      continue;
+    }
+    *out_event = std::move(it->second);
+    pending_ticks_.erase(it);
+    return true;
+  }
+  return false;
+}
+
+void BotApplication::WaitForWork() {
+  if (main_wake_fd_ < 0) {
+    // 无事件 fd（读取线程未启用）：PollMarket 自身就是轮询点，
+    // 保留原定长退避即可。
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return;
+  }
+  // 行情入环 / 执行结果就绪都会写 eventfd；10ms 上限保证周期任务
+  // （对账、闸门窗口、状态快照）的节拍不被长时间静默拖后。
+  struct pollfd pfd{};
+  pfd.fd = main_wake_fd_;
+  pfd.events = POLLIN;
+  const int ready = ::poll(&pfd, 1, 10);
+  if (ready > 0 && (pfd.revents & POLLIN) != 0) {
+    std::uint64_t pending = 0;
+    (void)!::read(main_wake_fd_, &pending, sizeof(pending));
+  }
+}
+
+void BotApplication::StartFeedReader() {
+  if (!config_.feed_reader_enabled || config_.mode == "replay" ||
+      adapter_ == nullptr || feed_reader_thread_.joinable()) {
+    return;
+  }
+  auto& metrics = MetricsRegistry::Instance();
+  metric_feed_ring_depth_ = metrics.RegisterGauge(
+      "ai_trade_feed_ring_depth", "行情事件环当前深度");
+  metric_feed_conflated_ = metrics.RegisterCounter(
+      "ai_trade_feed_conflated_total", "环满按 symbol 合并的行情事件数");
+  const std::size_t capacity = config_.feed_ring_capacity > 0
+                                   ? static_cast<std::size_t>(
+                                         config_.feed_ring_capacity)
+                                   : 4096;
+  feed_ring_ = std::make_unique<SpscRing<MarketEvent>>(capacity);
+  // 主循环唤醒 fd：行情入环与执行结果都写这里，空闲等待即时醒来。
+  main_wake_fd_ = ::eventfd(0, EFD_NONBLOCK);
+  if (executor_ != nullptr) {
+    executor_->SetResultWakeFd(main_wake_fd_);
+  }
+  feed_reader_stop_.store(false, std::memory_order_release);
+  feed_reader_thread_ = std::thread([this] { RunFeedReader(); });
+  LogInfo("FEED_READER_ENABLED: ring_capacity=" +
+          std::to_string(feed_ring_->capacity()));
+}
+
+void BotApplication::StopFeedReader() {
+  if (!feed_reader_thread_.joinable()) {
+    return;
+  }
+  feed_reader_stop_.store(true, std::memory_order_release);
+  feed_reader_thread_.join();
+  if (executor_ != nullptr) {
+    executor_->SetResultWakeFd(-1);
+  }
+  if (main_wake_fd_ >= 0) {
+    ::close(main_wake_fd_);
+    main_wake_fd_ = -1;
+  }
+}
+
+/**
+ * @brief 行情读取线程主体
+ *
+ * 独占 PollMarket：WS 读取+解析的耗时全部发生在本线程，决策线程
+ * 只付一次环出队的成本。环满（决策侧落后）时不丢最新行情，而是
+ * 按 symbol 合并到积压表，环腾出空间后优先回灌。
+ */
+void BotApplication::RunFeedReader() {
+  ApplyThreadRole(ThreadRole::kFeed);
+  MarketEvent event;
+  // 环满时的按 symbol 合并积压（ticker 语义下安全：价格最新值有效，
+  // 增量 volume/interval 可加和）。
+  std::unordered_map<std::string, MarketEvent> conflated;
+  // 入环后写主循环 eventfd：先入队再写 fd，主循环读到计数后出队必然可见。
+  const auto wake_main = [this] {
+    if (main_wake_fd_ >= 0) {
+      const std::uint64_t one = 1;
+      (void)!::write(main_wake_fd_, &one, sizeof(one));
+    }
+  };
+  while (!feed_reader_stop_.load(std::memory_order_acquire)) {
+    // 先回灌合并积压，保证事件尽量新鲜且不乱序放大。
+    for (auto it = conflated.begin(); it != conflated.end();) {
+      if (feed_ring_->TryPush(std::move(it->second))) {
+        wake_main();
+        it = conflated.erase(it);
+      } else {
+        break;  // 环仍满；TryPush 失败不消耗元素。
+      }
     }
+
+    const bool has_market = adapter_->PollMarket(&event);
+    if (!has_market) {
+      // WS 路径在 PollMarket 内部已有就绪等待；空转时小步退避。
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    if (!feed_ring_->TryPush(std::move(event))) {
+      ConflateMarketEvent(&conflated[event.symbol], event);
+      if (metric_feed_conflated_ != nullptr) {
+        metric_feed_conflated_->Inc();
+      }
+    } else {
+      wake_main();
+    }
+    if (metric_feed_ring_depth_ != nullptr) {
+      metric_feed_ring_depth_->Set(static_cast<double>(feed_ring_->Size()));
+    }
+  }
+}
+
+void BotApplication::ConflateMarketEvent(MarketEvent* into,
+                                         const MarketEvent& latest) {
+  if (into->symbol.empty() || into->symbol != latest.symbol) {
+    *into = latest;
+    return;
+  }
+  into->ts_ms = latest.ts_ms;
+  into->price = latest.price;
+  into->mark_price = latest.mark_price;
+  // 订单簿顶档是状态量而非增量：合并取最新值即可。
+  into->best_bid = latest.best_bid;
+  into->best_ask = latest.best_ask;
+  into->book_imbalance = latest.book_imbalance;
+  into->volume += latest.volume;
+  into->interval_ms += latest.interval_ms;
+  if (std::isfinite(latest.funding_rate_per_interval)) {
+    // funding 为按 interval 已折算的增量口径，可与 volume 同样加和。
+    into->funding_rate_per_interval =
+        std::isfinite(into->funding_rate_per_interval)
+            ? into->funding_rate_per_interval +
+                  latest.funding_rate_per_interval
+            : latest.funding_rate_per_interval;
   }
 }
 
@@ -3361,14 +3801,20 @@ void BotApplication::RunRemoteRiskRefresh() {
     return;
   }
 
-  system_.RefreshAccountRiskFromRemotePositions(remote_positions);
+  const bool risk_changed =
+      system_.RefreshAccountRiskFromRemotePositions(remote_positions);
   RemoteAccountBalanceSnapshot balance;
   if (adapter_->GetRemoteAccountBalance(&balance)) {
     // 运行中只上调峰值，不重置峰值，避免人为清零回撤统计。
     system_.SyncAccountFromRemoteBalance(balance, /*reset_peak_to_equity=*/false);
     LogAccountSyncSnapshot("runtime_refresh", balance, system_.account());
   }
-  LogInfo("REMOTE_RISK_REFRESH: count=" + std::to_string(remote_positions.size()));
+  if (risk_changed) {
+    LogInfo("REMOTE_RISK_REFRESH: count=" +
+            std::to_string(remote_positions.size()));
+  } else {
+    LogInfo("REMOTE_RISK_REFRESH_UNCHANGED: 快照纪元一致，跳过风险字段应用");
+  }
 }
 
 /**
@@ -3382,6 +3828,9 @@ void BotApplication::RunRemoteRiskRefresh() {
  * 5. 满足条件则入队异步执行。
  */
 void BotApplication::ProcessMarketEvent(const MarketEvent& event) {
+  if (shm_bus_.ok()) {
+    shm_bus_.Publish(event);
+  }
   if (const auto update = universe_selector_.OnMarket(event); update.has_value()) {
     std::string message =
         "Universe Updated: active_count=" +
@@ -3454,8 +3903,29 @@ void BotApplication::ProcessMarketEvent(const MarketEvent& event) {
       symbol_inflight_notional_usd = inflight_qty * effective_price;
     }
   }
-  auto decision =
-      system_.Evaluate(event, trade_ok, symbol_inflight_notional_usd);
+  const auto evaluate_start = std::chrono::steady_clock::now();
+  system_.Evaluate(event, trade_ok, symbol_inflight_notional_usd,
+                   &decision_scratch_);
+  const std::int64_t evaluate_nanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - evaluate_start)
+          .count();
+  gate_monitor_.RecordDecisionLatency(evaluate_nanos);
+  if (metric_ticks_ != nullptr) {
+    metric_ticks_->Inc();
+    metric_evaluate_latency_->Record(evaluate_nanos);
+  }
+  MarketDecision& decision = decision_scratch_;
+  if (shm_bus_.ok()) {
+    shm_bus_.Publish(event, decision);
+  }
+  if (decision_journal_ != nullptr) {
+    std::string journal_error;
+    if (!decision_journal_->Append(event, decision, &journal_error)) {
+      LogError("决策日志写入失败，已禁用: " + journal_error);
+      decision_journal_.reset();
+    }
+  }
   constexpr double kRebalanceGapEpsilon = 1e-6;
   if (!decision.risk_adjusted.symbol.empty()) {
     const double settled_symbol_notional =
@@ -3693,7 +4163,8 @@ void BotApplication::ProcessMarketEvent(const MarketEvent& event) {
   // 交易所规则前置保护：避免 qty=0/min_qty/min_notional 拒单循环。
   if (decision.intent.has_value()) {
     std::string guard_reason;
-    if (ViolatesExchangePretradeGuard(adapter_.get(), &*decision.intent, event,
+    if (ViolatesExchangePretradeGuard(&quant_table_, adapter_.get(),
+                                      &*decision.intent, event,
                                       &guard_reason)) {
       LogInfo("EXEC_FILTER_IGNORE: symbol=" + decision.intent->symbol +
               ", client_order_id=" + decision.intent->client_order_id +
@@ -4126,10 +4597,19 @@ bool BotApplication::EnqueueIntent(const OrderIntent& intent) {
   }
   intent_ids_.insert(intent.client_order_id);
   if (IsNetPositionOrderPurpose(intent.purpose)) {
-    pending_net_order_enqueued_ms_[intent.client_order_id] = CurrentTimestampMs();
+    const std::int64_t enqueued_ms = CurrentTimestampMs();
+    pending_net_order_enqueued_ms_[intent.client_order_id] = enqueued_ms;
+    // 同步登记超时截止时间：对账收敛按堆弹出，避免逐单比对入队时间。
+    oms_.SchedulePendingDeadline(
+        intent.client_order_id,
+        enqueued_ms +
+            static_cast<std::int64_t>(config_.reconcile.pending_order_stale_ms));
   }
   executor_->Submit(intent);
   ++funnel_window_.intents_enqueued;
+  if (metric_intents_enqueued_ != nullptr) {
+    metric_intents_enqueued_->Inc();
+  }
   if (IsTrendCandidateProbeIntent(intent.client_order_id)) {
     const auto attempt_it =
         candidate_probe_attempt_by_intent_id_.find(intent.client_order_id);
@@ -4213,6 +4693,9 @@ void BotApplication::ProcessAsyncResults() {
         ClearPendingRequiredSl(res.client_order_id);
       }
       ++funnel_window_.async_submit_ok;
+      if (metric_async_submit_ok_ != nullptr) {
+        metric_async_submit_ok_->Inc();
+      }
     } else {
       oms_.MarkRejected(res.client_order_id);
       pending_net_order_enqueued_ms_.erase(res.client_order_id);
@@ -4226,6 +4709,9 @@ void BotApplication::ProcessAsyncResults() {
         }
       }
       ++funnel_window_.async_submit_failed;
+      if (metric_async_submit_failed_ != nullptr) {
+        metric_async_submit_failed_->Inc();
+      }
       LogError("Async Submit Failed: " + res.error);
 
       const auto* record = oms_.Find(res.client_order_id);
@@ -4375,6 +4861,12 @@ void BotApplication::ProcessFillEvent(const FillEvent& fill) {
   last_fill_tick_ = market_tick_count_;
   RememberRecentFillForReconcile(fill);
   ++funnel_window_.fills_applied;
+  if (metric_fills_ != nullptr) {
+    metric_fills_->Inc();
+  }
+  if (shm_bus_.ok()) {
+    shm_bus_.Publish(fill);
+  }
   ++pending_fills_for_evolution_;
   if (std::isfinite(fill.price) && fill.price > 0.0 && std::isfinite(fill.qty)) {
     const double fill_notional_abs_usd = std::fabs(fill.price * std::fabs(fill.qty));
@@ -4432,16 +4924,14 @@ void BotApplication::ProcessFillEvent(const FillEvent& fill) {
       ++funnel_window_.fills_unknown_liquidity_count;
     }
     if (symbol_quality_fill) {
-      auto& symbol_quality =
-          funnel_window_.symbol_fill_quality_by_symbol[fill.symbol];
-      ++symbol_quality.fills;
-      if (fill_order_record->intent.purpose != OrderPurpose::kEntry ||
-          std::fabs(realized_pnl_usd) > kFillQtyAuditEpsilon) {
-        ++symbol_quality.net_quality_fills;
-      }
-      symbol_quality.fee_usd_sum += fill.fee;
-      symbol_quality.realized_net_sum_usd += realized_pnl_usd - fill.fee;
-      symbol_quality.notional_abs_usd_sum += fill_notional_abs_usd;
+      const bool net_quality =
+          fill_order_record->intent.purpose != OrderPurpose::kEntry ||
+          std::fabs(realized_pnl_usd) > kFillQtyAuditEpsilon;
+      symbol_fill_quality_shards_.Record(fill.symbol,
+                                         net_quality,
+                                         realized_pnl_usd - fill.fee,
+                                         fill.fee,
+                                         fill_notional_abs_usd);
     }
     if (!account_already_reflects_fill && fill_order_record != nullptr) {
       LogExitCaptureSample(fill,
@@ -4457,12 +4947,11 @@ void BotApplication::ProcessFillEvent(const FillEvent& fill) {
       }
       ++funnel_window_.entry_fills_applied;
       funnel_window_.entry_fills_notional_abs_usd_sum += fill_notional_abs_usd;
-      auto& symbol_quality =
-          funnel_window_.entry_fill_quality_by_symbol[fill.symbol];
-      ++symbol_quality.fills;
-      symbol_quality.fee_usd_sum += fill.fee;
-      symbol_quality.realized_net_sum_usd -= fill.fee;
-      symbol_quality.notional_abs_usd_sum += fill_notional_abs_usd;
+      entry_fill_quality_shards_.Record(fill.symbol,
+                                        /*net_quality=*/false,
+                                        -fill.fee,
+                                        fill.fee,
+                                        fill_notional_abs_usd);
       if (explicit_liquidity) {
         ++funnel_window_.entry_fills_explicit_liquidity_count;
       } else if (fallback_by_fee) {
@@ -4523,7 +5012,7 @@ bool BotApplication::RecentFillsExplainReconcileMismatch(
     return false;
   }
 
-  std::ostringstream explanation;
+  LineWriter explanation(160);
   bool first = true;
   for (const auto& delta : deltas) {
     if (std::fabs(delta.delta_qty) <= kNotionalEpsilon) {
@@ -4565,19 +5054,24 @@ bool BotApplication::RecentFillsExplainReconcileMismatch(
     }
 
     if (!first) {
-      explanation << ";";
+      explanation.Append(';');
     }
     first = false;
-    explanation << delta.symbol << "{delta_qty=" << delta.delta_qty
-                << ", matched_recent_fill_qty=" << matched_qty
-                << ", matched_recent_fill_count=" << matched_count << "}";
+    explanation.Append(delta.symbol)
+        .Append("{delta_qty=")
+        .AppendDouble(delta.delta_qty)
+        .Append(", matched_recent_fill_qty=")
+        .AppendDouble(matched_qty)
+        .Append(", matched_recent_fill_count=")
+        .AppendInt(matched_count)
+        .Append('}');
   }
 
   if (first) {
     return false;
   }
   if (out_explanation != nullptr) {
-    *out_explanation = explanation.str();
+    *out_explanation = explanation.TakeString();
   }
   return true;
 }
@@ -5035,8 +5529,8 @@ bool BotApplication::TryEnqueueProfitProtectionImmediateReduce(
   reduce->liquidity_preference = LiquidityPreference::kTaker;
   reduce->price = current_price;
   std::string guard_reason;
-  if (ViolatesExchangePretradeGuard(adapter_.get(), &*reduce, event,
-                                    &guard_reason)) {
+  if (ViolatesExchangePretradeGuard(&quant_table_, adapter_.get(), &*reduce,
+                                    event, &guard_reason)) {
     LogInfo("PROFIT_PROTECTION_IMMEDIATE_REDUCE_SKIPPED: symbol=" +
             state.symbol +
             ", reason=" + guard_reason +
@@ -5207,15 +5701,21 @@ void BotApplication::UpdateProfitProtection(const MarketEvent& event) {
 void BotApplication::TrackPendingRequiredSl(
     const std::string& sl_client_order_id,
     const std::string& parent_order_id) {
-  if (sl_client_order_id.empty() || !config_.protection.require_sl) {
+  if (sl_client_order_id.empty() || !config_.protection.require_sl ||
+      config_.protection.attach_timeout_ms <= 0) {
     return;
   }
-  const std::int64_t timeout_ms =
-      static_cast<std::int64_t>(config_.protection.attach_timeout_ms);
-  pending_required_sl_attach_[sl_client_order_id] = PendingRequiredSlAttach{
-      .parent_order_id = parent_order_id,
-      .deadline_ms = CurrentTimestampMs() + timeout_ms,
-  };
+  // 截止检查交给定时轮：只在到期那一刻触碰该等待项，主循环不再全量扫描。
+  auto& pending = pending_required_sl_attach_[sl_client_order_id];
+  if (pending.timer_id != 0) {
+    timer_wheel_.Cancel(pending.timer_id);
+  }
+  pending.parent_order_id = parent_order_id;
+  pending.timer_id = timer_wheel_.ScheduleAfter(
+      static_cast<std::int64_t>(config_.protection.attach_timeout_ms),
+      [this, sl_client_order_id](std::int64_t /*now_ms*/) {
+        HandleRequiredSlAttachDeadline(sl_client_order_id);
+      });
 }
 
 void BotApplication::ClearPendingRequiredSl(
@@ -5223,53 +5723,48 @@ void BotApplication::ClearPendingRequiredSl(
   if (sl_client_order_id.empty()) {
     return;
   }
-  pending_required_sl_attach_.erase(sl_client_order_id);
+  const auto it = pending_required_sl_attach_.find(sl_client_order_id);
+  if (it != pending_required_sl_attach_.end()) {
+    timer_wheel_.Cancel(it->second.timer_id);
+    pending_required_sl_attach_.erase(it);
+  }
   RefreshProtectionReduceOnlyRelease("required_sl_cleared");
 }
 
-void BotApplication::CheckPendingRequiredSlTimeouts() {
-  if (!config_.protection.enabled || !config_.protection.require_sl ||
-      config_.protection.attach_timeout_ms <= 0 ||
-      pending_required_sl_attach_.empty()) {
+void BotApplication::HandleRequiredSlAttachDeadline(
+    const std::string& sl_client_order_id) {
+  const auto it = pending_required_sl_attach_.find(sl_client_order_id);
+  if (it == pending_required_sl_attach_.end()) {
     return;
   }
-
-  const std::int64_t now_ms = CurrentTimestampMs();
-  std::vector<std::string> to_remove;
-  to_remove.reserve(pending_required_sl_attach_.size());
-  for (const auto& [sl_client_order_id, pending] : pending_required_sl_attach_) {
-    if (now_ms < pending.deadline_ms) {
-      continue;
-    }
-
-    const auto* sl_record = oms_.Find(sl_client_order_id);
-    const bool confirmed =
-        sl_record != nullptr &&
-        (sl_record->state == OrderState::kSent ||
-         sl_record->state == OrderState::kPartial ||
-         sl_record->state == OrderState::kFilled);
-    if (confirmed) {
-      to_remove.push_back(sl_client_order_id);
-      continue;
-    }
-
-    protection_forced_reduce_only_ = true;
-    RefreshReduceOnlyMode();
-    LogError("EXEC_PROTECTIVE_ORDER_MISSING: reason=sl_attach_timeout"
-             ", parent_order_id=" + pending.parent_order_id +
-             ", sl_client_order_id=" + sl_client_order_id +
-             ", sl_state=" +
-             (sl_record != nullptr ? OrderStateToString(sl_record->state)
-                                   : "missing") +
-             ", timeout_ms=" +
-             std::to_string(config_.protection.attach_timeout_ms) +
-             ", forcing=reduce_only");
-    to_remove.push_back(sl_client_order_id);
+  const std::string parent_order_id = it->second.parent_order_id;
+  pending_required_sl_attach_.erase(it);
+  // 热更新可能在等待期间关闭保护：此时只清理等待项，不再升级。
+  if (!config_.protection.enabled || !config_.protection.require_sl) {
+    return;
   }
 
-  for (const auto& id : to_remove) {
-    pending_required_sl_attach_.erase(id);
+  const auto* sl_record = oms_.Find(sl_client_order_id);
+  const bool confirmed =
+      sl_record != nullptr &&
+      (sl_record->state == OrderState::kSent ||
+       sl_record->state == OrderState::kPartial ||
+       sl_record->state == OrderState::kFilled);
+  if (confirmed) {
+    return;
   }
+
+  protection_forced_reduce_only_ = true;
+  RefreshReduceOnlyMode();
+  LogError("EXEC_PROTECTIVE_ORDER_MISSING: reason=sl_attach_timeout"
+           ", parent_order_id=" + parent_order_id +
+           ", sl_client_order_id=" + sl_client_order_id +
+           ", sl_state=" +
+           (sl_record != nullptr ? OrderStateToString(sl_record->state)
+                                 : "missing") +
+           ", timeout_ms=" +
+           std::to_string(config_.protection.attach_timeout_ms) +
+           ", forcing=reduce_only");
 }
 
 /**
@@ -5308,22 +5803,36 @@ void BotApplication::RunReconcile() {
   const bool remote_open_orders_ok =
       adapter_ != nullptr &&
       adapter_->GetRemoteOpenOrderClientIds(&remote_open_order_ids);
+  if (remote_open_orders_ok) {
+    // 吸收进对账器的排序哈希纪元：后续按二分查找判定成员资格，
+    // 差分只在集合真实变化时产生日志。
+    const auto open_order_diff =
+        reconciler_.UpdateRemoteOpenOrders(remote_open_order_ids);
+    if (open_order_diff.changed()) {
+      LogInfo("OMS_REMOTE_OPEN_SET_DIFF: appeared=" +
+              std::to_string(open_order_diff.appeared) + ", disappeared=" +
+              std::to_string(open_order_diff.disappeared));
+    }
+  }
+  // 时间维度的到期订单由 OMS 截止时间堆直接弹出（只触达到期条目）；
+  // 下方遍历经二级索引支撑，规模为“在途净仓位订单数”而非全订单表。
+  std::unordered_set<std::string> deadline_expired_ids;
+  for (auto& expired_id : oms_.TakeExpiredPendingNetPositionOrders(now_ms)) {
+    deadline_expired_ids.insert(std::move(expired_id));
+  }
   for (const auto& client_order_id : oms_.PendingNetPositionOrderIds()) {
-    const auto it = pending_net_order_enqueued_ms_.find(client_order_id);
-    bool is_stale = false;
+    bool is_stale = deadline_expired_ids.count(client_order_id) > 0;
     bool missing_on_remote = false;
     if (remote_open_orders_ok &&
-        remote_open_order_ids.find(client_order_id) ==
-            remote_open_order_ids.end()) {
+        !reconciler_.RemoteOpenOrderEpochContains(client_order_id)) {
       // 远端活动订单列表中已不存在该订单，优先按陈旧单收敛。
       is_stale = true;
       missing_on_remote = true;
     }
-    if (it == pending_net_order_enqueued_ms_.end()) {
+    if (pending_net_order_enqueued_ms_.find(client_order_id) ==
+        pending_net_order_enqueued_ms_.end()) {
       // WAL恢复或历史遗留订单：缺少本次进程入队时间，按陈旧单处理。
       is_stale = true;
-    } else if (now_ms - it->second > stale_ms) {
-      is_stale = true;
     }
     if (!is_stale) {
       ++fresh_net_orders;
@@ -5517,12 +6026,12 @@ void BotApplication::RunGateMonitor() {
 
   if (auto res = gate_monitor_.OnTick(); res.has_value()) {
     if (!res->pass) {
-      std::ostringstream reasons;
+      LineWriter reasons(96);
       for (std::size_t i = 0; i < res->fail_reasons.size(); ++i) {
         if (i > 0) {
-          reasons << ",";
+          reasons.Append(',');
         }
-        reasons << res->fail_reasons[i];
+        reasons.Append(res->fail_reasons[i]);
       }
       LogInfo("GATE_CHECK_FAILED: raw_signals=" + std::to_string(res->raw_signals) +
               ", order_intents=" + std::to_string(res->order_intents) +
@@ -5533,6 +6042,9 @@ void BotApplication::RunGateMonitor() {
               std::to_string(res->policy_flat_signals) +
               ", runtime_action_exempt=" +
               std::string(res->policy_flat_runtime_exempt ? "true" : "false") +
+              ", latency_samples=" + std::to_string(res->latency_samples) +
+              ", latency_p50_us=" + std::to_string(res->latency_p50_us) +
+              ", latency_p99_us=" + std::to_string(res->latency_p99_us) +
               ", fail_reasons=[" + reasons.str() + "]");
     } else {
       LogInfo("GATE_CHECK_PASSED: raw_signals=" +
@@ -5544,7 +6056,10 @@ void BotApplication::RunGateMonitor() {
               ", policy_flat_signals=" +
               std::to_string(res->policy_flat_signals) +
               ", policy_flat=" +
-              std::string(res->policy_flat_pass ? "true" : "false"));
+              std::string(res->policy_flat_pass ? "true" : "false") +
+              ", latency_samples=" + std::to_string(res->latency_samples) +
+              ", latency_p50_us=" + std::to_string(res->latency_p50_us) +
+              ", latency_p99_us=" + std::to_string(res->latency_p99_us));
     }
 
     const bool runtime_action_pass =
@@ -5619,13 +6134,29 @@ void BotApplication::RunGateMonitor() {
   }
 }
 
+std::int64_t BotApplication::EvolutionNextEvalTick() const {
+  return evolution_pipeline_ != nullptr ? evolution_pipeline_->next_eval_tick()
+                                        : self_evolution_.next_eval_tick();
+}
+
+std::int64_t BotApplication::EvolutionCooldownUntilTick() const {
+  return evolution_pipeline_ != nullptr
+             ? evolution_pipeline_->cooldown_until_tick()
+             : self_evolution_.cooldown_until_tick();
+}
+
+bool BotApplication::EvolutionInitialized() const {
+  return evolution_pipeline_ != nullptr ? evolution_pipeline_->initialized()
+                                        : self_evolution_.initialized();
+}
+
 void BotApplication::RunSelfEvolution() {
   if (!config_.self_evolution.enabled) {
     return;
   }
   if (system_.integrator_mode() == IntegratorMode::kCanary ||
       system_.integrator_mode() == IntegratorMode::kActive) {
-    if (market_tick_count_ == self_evolution_.next_eval_tick()) {
+    if (market_tick_count_ == EvolutionNextEvalTick()) {
       ++funnel_window_.self_evolution_skipped;
       LogInfo("SELF_EVOLUTION_ACTION: type=skipped, reason=EVOLUTION_INTEGRATOR_ACTIVE_MODE, integrator_mode=" +
               std::string(ToString(system_.integrator_mode())));
@@ -5647,6 +6178,38 @@ void BotApplication::RunSelfEvolution() {
   const std::string signal_symbol =
       has_tick_strategy_signal_ ? tick_strategy_signal_symbol_ : std::string();
   const double observed_turnover_cost_bps = std::max(0.0, 0.5 * RoundTripCostBps());
+  const int fill_count = std::max(0, pending_fills_for_evolution_);
+  pending_fills_for_evolution_ = 0;
+
+  if (evolution_pipeline_ != nullptr) {
+    // 异步流水线：观测入环即返回；累计器维护与评估在后台线程完成，
+    // 本轮只应用其已产出的动作（权重切换仍在交易线程 tick 边界落地）。
+    EvolutionObservation observation;
+    observation.tick = market_tick_count_;
+    observation.realized_net_pnl_usd =
+        system_.account().cumulative_realized_net_pnl_usd();
+    observation.regime_bucket = active_bucket;
+    observation.drawdown_pct = system_.account().drawdown_pct();
+    observation.account_notional_usd = system_.account().current_notional_usd();
+    observation.trend_signal_notional_usd = trend_signal_notional_usd;
+    observation.defensive_signal_notional_usd = defensive_signal_notional_usd;
+    observation.mark_price_usd = mark_price_usd;
+    observation.signal_symbol = signal_symbol;
+    observation.entry_filtered_by_cost = tick_cost_filtered_signal_;
+    observation.fill_count = fill_count;
+    observation.account_equity_usd = system_.account().equity_usd();
+    observation.observed_turnover_cost_bps = observed_turnover_cost_bps;
+    observation.observed_funding_rate_per_tick = observed_funding_rate_per_tick;
+    if (!evolution_pipeline_->SubmitObservation(std::move(observation))) {
+      LogError("EVOLUTION_OBS_DROPPED: ring_full, dropped_total=" +
+               std::to_string(evolution_pipeline_->dropped_observations()));
+    }
+    while (const auto pending = evolution_pipeline_->PollAction()) {
+      ApplySelfEvolutionAction(*pending);
+    }
+    return;
+  }
+
   const auto action =
       self_evolution_.OnTick(market_tick_count_,
                              system_.account().cumulative_realized_net_pnl_usd(),
@@ -5658,15 +6221,19 @@ void BotApplication::RunSelfEvolution() {
                              mark_price_usd,
                              signal_symbol,
                              tick_cost_filtered_signal_,
-                             std::max(0, pending_fills_for_evolution_),
+                             fill_count,
                              system_.account().equity_usd(),
                              observed_turnover_cost_bps,
                              observed_funding_rate_per_tick);
-  pending_fills_for_evolution_ = 0;
   if (!action.has_value()) {
     return;
   }
+  ApplySelfEvolutionAction(*action);
+}
 
+void BotApplication::ApplySelfEvolutionAction(
+    const SelfEvolutionAction& applied_action) {
+  const SelfEvolutionAction* action = &applied_action;
   if (action->type == SelfEvolutionActionType::kUpdated ||
       action->type == SelfEvolutionActionType::kRolledBack) {
     std::string set_error;
@@ -5811,6 +6378,17 @@ void BotApplication::LogStatus() {
                 static_cast<double>(throttle_total.checks)
           : 0.0;
 
+  // 状态日志节奏同时刷新慢变化指标（gauge 写入为 relaxed store，成本可忽略）。
+  if (metric_equity_usd_ != nullptr) {
+    metric_equity_usd_->Set(system_.account().equity_usd());
+    metric_gross_notional_usd_->Set(system_.account().gross_notional_usd());
+    metric_throttle_checks_->Set(static_cast<double>(throttle_total.checks));
+    metric_throttle_rejected_->Set(
+        static_cast<double>(throttle_total.rejected));
+  }
+
+  // 分片累计只在此处（摘要结算）聚合回按品种映射，热路径不碰哈希表。
+  DrainFunnelSymbolShards();
   const DecisionFunnelStats funnel_window = funnel_window_;
   AccumulateStats(&funnel_total_, funnel_window_);
   funnel_window_ = DecisionFunnelStats{};
@@ -5950,12 +6528,12 @@ void BotApplication::LogStatus() {
   const auto active_evolution_weights = system_.evolution_weights(active_bucket);
   const auto evolution_weights = system_.evolution_weights_all();
   const bool evolution_enabled =
-      config_.self_evolution.enabled && self_evolution_.initialized();
+      config_.self_evolution.enabled && EvolutionInitialized();
   const bool evolution_cooldown =
-      evolution_enabled && market_tick_count_ < self_evolution_.cooldown_until_tick();
+      evolution_enabled && market_tick_count_ < EvolutionCooldownUntilTick();
   const int evolution_cooldown_remaining =
       evolution_cooldown
-          ? static_cast<int>(self_evolution_.cooldown_until_tick() -
+          ? static_cast<int>(EvolutionCooldownUntilTick() -
                              market_tick_count_)
           : 0;
   const double window_realized_net_delta_usd =
@@ -6589,10 +7167,16 @@ void BotApplication::LogStatus() {
           ", extreme=(" + std::to_string(evolution_weights[2].trend_weight) +
           "," + std::to_string(evolution_weights[2].defensive_weight) + ")}" +
           ", next_eval_tick=" +
-          std::to_string(self_evolution_.next_eval_tick()) +
+          std::to_string(EvolutionNextEvalTick()) +
           ", cooldown=" + std::string(evolution_cooldown ? "true" : "false") +
           ", cooldown_remaining_ticks=" +
           std::to_string(evolution_cooldown_remaining) + "}");
+  // Evaluate 流水线分阶段延迟摘要（画像编译关闭或尚无样本时为空）。
+  const std::string latency_summary = system_.EvaluateLatencySummary();
+  if (!latency_summary.empty()) {
+    LogInfo(latency_summary);
+  }
+
   last_status_realized_net_pnl_usd_ =
       system_.account().cumulative_realized_net_pnl_usd();
   last_status_fee_usd_ = system_.account().cumulative_fee_usd();
@@ -6605,6 +7189,134 @@ void BotApplication::LogStatus() {
  * - live/paper: 受 system_max_ticks 控制；
  * - replay: 数据耗尽后自动退出。
  */
+void BotApplication::WarmStartRegimeFromPreload() {
+  if (config_.regime_preload_dir.empty()) {
+    return;
+  }
+  std::error_code dir_error;
+  std::filesystem::directory_iterator it(config_.regime_preload_dir, dir_error);
+  if (dir_error) {
+    LogInfo("REGIME_WARM_START_SKIPPED: 预热目录不可用: " +
+            config_.regime_preload_dir);
+    return;
+  }
+
+  const auto preload_start = std::chrono::steady_clock::now();
+  std::vector<MarketEvent> events;
+  std::size_t file_count = 0;
+  for (const auto& entry : it) {
+    if (!entry.is_regular_file() || entry.path().extension() != ".bin") {
+      continue;
+    }
+    const std::string symbol = entry.path().stem().string();
+    research::ColumnarBarStore store;
+    std::string open_error;
+    if (!store.Open(entry.path().string(), &open_error)) {
+      LogInfo("REGIME_WARM_START_FILE_SKIPPED: " + open_error);
+      continue;
+    }
+    ++file_count;
+    const auto timestamps = store.Timestamps();
+    const auto closes = store.Closes();
+    const auto volumes = store.Volumes();
+    const SymbolId symbol_id = InternSymbol(symbol);
+    events.reserve(events.size() + store.Count());
+    for (std::size_t i = 0; i < store.Count(); ++i) {
+      MarketEvent event;
+      event.ts_ms = timestamps[i];
+      event.symbol = symbol;
+      event.price = closes[i];
+      event.mark_price = closes[i];
+      event.volume = volumes[i];
+      event.interval_ms = i > 0 ? timestamps[i] - timestamps[i - 1] : 60000;
+      event.symbol_id = symbol_id;
+      events.push_back(std::move(event));
+    }
+  }
+  if (events.empty()) {
+    LogInfo("REGIME_WARM_START_SKIPPED: 预热目录无可用 K 线: " +
+            config_.regime_preload_dir);
+    return;
+  }
+
+  const std::size_t warm_cleared = system_.WarmStartRegime(events);
+  const auto preload_end = std::chrono::steady_clock::now();
+  const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              preload_end - preload_start)
+                              .count();
+  LogInfo("REGIME_WARM_START: files=" + std::to_string(file_count) +
+          ", events=" + std::to_string(events.size()) +
+          ", warm_cleared=" + std::to_string(warm_cleared) +
+          ", elapsed_ms=" + std::to_string(elapsed_ms));
+}
+
+void BotApplication::MaybeWriteStateSnapshot() {
+  // replay 模式状态即用即弃；实盘/paper 按固定间隔摊薄落盘成本。
+  if (config_.mode == "replay") {
+    return;
+  }
+  const std::int64_t now_ms = NowMsCached();
+  if (last_state_snapshot_ms_ != 0 &&
+      now_ms - last_state_snapshot_ms_ < kStateSnapshotIntervalMs) {
+    return;
+  }
+  last_state_snapshot_ms_ = now_ms;
+  std::string snapshot_error;
+  if (!SaveStateSnapshot(state_snapshot_path_, system_, fill_ids_,
+                         &snapshot_error)) {
+    LogError("STATE_SNAPSHOT_WRITE_FAILED: " + snapshot_error);
+  }
+  // WAL 压实随快照节拍：无已封存段时为空操作，失败只降级不阻断。
+  std::string compact_error;
+  if (!wal_.Compact(&compact_error)) {
+    LogError("WAL_COMPACT_FAILED: " + compact_error);
+  }
+  // 决策日志随快照节拍刷盘：每条记录仅入 stdio 缓冲，不逐条 fflush。
+  if (decision_journal_ != nullptr) {
+    std::string journal_error;
+    if (!decision_journal_->Flush(&journal_error)) {
+      LogError("决策日志刷盘失败，已禁用: " + journal_error);
+      decision_journal_.reset();
+    }
+  }
+}
+
+void BotApplication::PublishStateDelta() {
+  if (!state_delta_stream_.ok()) {
+    return;
+  }
+  RuntimeStateSample sample;
+  sample.ts_ms = NowMsCached();
+  sample.risk_mode = RiskModeToString(system_.risk_mode());
+  sample.trading_halted = trading_halted_;
+  const AccountState& account = system_.account();
+  sample.equity_usd = account.equity_usd();
+  sample.drawdown_pct = account.drawdown_pct();
+  for (const auto& symbol : account.GetActiveSymbols()) {
+    const double qty = account.position_qty(symbol);
+    if (std::fabs(qty) <= kNotionalEpsilon) {
+      continue;
+    }
+    sample.positions.push_back({symbol, qty, account.mark_price(symbol)});
+  }
+  // 漏斗计数按进程累计口径导出（窗口部分尚未结算进 total，补上）。
+  sample.funnel = {
+      {"raw_signals",
+       funnel_total_.raw_signals + funnel_window_.raw_signals},
+      {"risk_adjusted_signals", funnel_total_.risk_adjusted_signals +
+                                    funnel_window_.risk_adjusted_signals},
+      {"intents_generated",
+       funnel_total_.intents_generated + funnel_window_.intents_generated},
+      {"intents_filtered_min_notional",
+       funnel_total_.intents_filtered_min_notional +
+           funnel_window_.intents_filtered_min_notional},
+      {"intents_filtered_fee_aware",
+       funnel_total_.intents_filtered_fee_aware +
+           funnel_window_.intents_filtered_fee_aware},
+  };
+  state_delta_stream_.Publish(sample);
+}
+
 bool BotApplication::ShouldExit(bool has_market, bool has_fill) {
   if (config_.system_max_ticks > 0 &&
       market_tick_count_ >= config_.system_max_ticks) {
@@ -6616,9 +7328,18 @@ bool BotApplication::ShouldExit(bool has_market, bool has_fill) {
   return false;
 }
 
-// 停机顺序：先停执行线程，再输出结束日志。
+// 停机顺序：先停行情读取线程，再停执行线程，落盘决策日志，输出结束日志。
 void BotApplication::Shutdown() {
+  StopFeedReader();
+  if (evolution_pipeline_ != nullptr) {
+    evolution_pipeline_->Stop();
+  }
   if (executor_) executor_->Stop();
+  metrics_server_.Stop();
+  shm_bus_.Close();
+  if (decision_journal_ != nullptr) {
+    decision_journal_->Close();
+  }
   LogInfo("Bot Shutdown.");
 }
 
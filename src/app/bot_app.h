@@ -1,23 +1,36 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "core/config.h"
+#include "core/config_watcher.h"
+#include "core/spsc_ring.h"
+#include "core/timer_wheel.h"
 #include "core/types.h"
+#include "evolution/evolution_pipeline.h"
 #include "evolution/self_evolution_controller.h"
 #include "exchange/exchange_adapter.h"
 #include "execution/async_executor.h"
 #include "execution/execution_engine.h"
 #include "execution/order_throttle.h"
+#include "execution/quantization.h"
 #include "monitor/gate_monitor.h"
+#include "monitor/metrics_http_server.h"
+#include "monitor/metrics_registry.h"
+#include "monitor/sharded_symbol_stats.h"
+#include "monitor/shm_event_bus.h"
+#include "monitor/state_delta_stream.h"
 #include "oms/order_manager.h"
 #include "oms/reconciler.h"
+#include "storage/decision_journal.h"
 #include "storage/wal_store.h"
 #include "system/trade_system.h"
 #include "universe/universe_selector.h"
@@ -57,6 +70,20 @@ class BotApplication {
    */
   int CheckStartup();
 
+  /**
+   * @brief 启用配置热加载
+   *
+   * 启动后台监视线程：源文件变化时在热路径之外解析 + 校验，
+   * 主循环在 tick 边界无锁认领新快照并应用可在线调整的参数
+   * （策略/Regime/保护/执行节流）；交易所、symbol、模式等拓扑
+   * 字段忽略，仍需重启生效。
+   *
+   * @param config_path 配置源文件路径
+   * @param out_error   启动失败原因
+   */
+  bool EnableConfigHotReload(const std::string& config_path,
+                             std::string* out_error);
+
  private:
   // --- 初始化阶段 ---
 
@@ -79,6 +106,15 @@ class BotApplication {
    */
   void SyncRemotePositions();
 
+  /**
+   * @brief 用本地历史 K 线预热 Regime 状态机
+   *
+   * 扫描 `regime_preload_dir` 下的 ATCBAR1 列式文件（文件名主干为
+   * symbol），按内存速度并行回放进 RegimeEngine，使 warmup 在首个
+   * 实时 tick 之前清除；目录未配置或文件缺失时静默走原 warmup 流程。
+   */
+  void WarmStartRegimeFromPreload();
+
   // --- 运行阶段 ---
 
   /**
@@ -87,6 +123,33 @@ class BotApplication {
    */
   void RunLoop();
 
+  /**
+   * @brief 启动专职行情读取线程
+   *
+   * feed_reader_enabled 且非 replay 模式时生效：WS 读取+解析移出
+   * 决策线程，经有界 SPSC 环送入；行情活性不再受决策路径延迟影响。
+   */
+  void StartFeedReader();
+  /// 停止并回收行情读取线程（幂等）。
+  void StopFeedReader();
+  /// 读取线程主体：PollMarket -> 入环；环满按 symbol 合并并计数。
+  void RunFeedReader();
+  /// 主循环空闲时的事件等待：行情入环/执行结果写 eventfd 立即唤醒，
+  /// 周期任务节拍由等待上限（10ms）兜底；无 wake fd 时退化为定长睡眠。
+  void WaitForWork();
+  /// 环满合并语义：价格/时间取最新，增量 volume/interval/funding 累加。
+  static void ConflateMarketEvent(MarketEvent* into, const MarketEvent& latest);
+  /**
+   * @brief 决策侧行情取数（含按 symbol 最新值折叠）
+   *
+   * 决策落后于行情时（停顿恢复、波动爆发），同 symbol 的积压事件只有
+   * 最新一条对下一轮决策有意义：这里把来源当前可得的事件一次性收进
+   * 暂存表，被覆盖的中间 tick 折叠进幸存事件（volume/interval 累加）
+   * 并计数，再按 symbol 首现顺序逐轮吐出。需 tick_conflation_enabled
+   * 开启；replay 模式按原始事件序演进，折叠恒为关闭。
+   */
+  bool FetchConflatedMarket(MarketEvent* out_event, bool from_ring);
+
   /**
    * @brief 处理行情事件
    * 包含：Universe 更新、策略计算、风控检查、生成订单意图。
@@ -241,8 +304,8 @@ class BotApplication {
                             double position_qty_before,
                             double avg_entry_price_before,
                             double realized_pnl_usd);
-  /// 检查“required SL 挂单确认”是否超时，超时则触发强制只减仓并审计。
-  void CheckPendingRequiredSlTimeouts();
+  /// required SL 确认截止到期（定时轮回调）：未确认则强制只减仓并审计。
+  void HandleRequiredSlAttachDeadline(const std::string& sl_client_order_id);
   /// 注册 required SL 的确认等待项（key=SL client_order_id）。
   void TrackPendingRequiredSl(const std::string& sl_client_order_id,
                               const std::string& parent_order_id);
@@ -278,13 +341,30 @@ class BotApplication {
    */
   void LogStatus();
 
+  /**
+   * @brief 周期写出 TradeSystem 状态快照
+   *
+   * 序列化在内存完成（微秒级），落盘为临时文件 + rename 原子替换，
+   * 按固定时间间隔摊薄；重启时恢复快照后只需回放 WAL 尾部。
+   */
+  void MaybeWriteStateSnapshot();
+
   /**
    * @brief 周期执行自进化权重更新/回滚
    *
-   * 仅触发组合层权重变化，不触碰风控不可动层参数。
+   * 仅触发组合层权重变化，不触碰风控不可动层参数。同步路径在当前
+   * tick 内完成评估与应用；异步流水线启用时本函数只提交观测并应用
+   * 后台线程已产出的动作。
    */
   void RunSelfEvolution();
 
+  /// 应用一条自进化动作：权重切换 + 漏斗计数 + 审计日志（同步/异步共用）。
+  void ApplySelfEvolutionAction(const SelfEvolutionAction& action);
+  /// 自进化评估节奏读数（异步流水线启用时读其原子镜像）。
+  std::int64_t EvolutionNextEvalTick() const;
+  std::int64_t EvolutionCooldownUntilTick() const;
+  bool EvolutionInitialized() const;
+
   /**
    * @brief 判断主循环是否应退出
    * @param has_market 当前轮是否消费到行情
@@ -436,6 +516,13 @@ class BotApplication {
   static void AccumulateStats(DecisionFunnelStats* total,
                               const DecisionFunnelStats& delta);
 
+  /// 把分片成交质量累计惰性聚合进 funnel_window_ 的按品种映射
+  /// （仅摘要结算调用，同时完成分片窗口清零）。
+  void DrainFunnelSymbolShards();
+
+  /// 采样当前运行态并发布到状态增量流（流未启用时为空操作）。
+  void PublishStateDelta();
+
   /// 当前是否存在任一“强制只减仓”来源（保护单失败、Gate 或对账异常保护）。
   bool IsForceReduceOnlyActive() const;
   /// 将强制只减仓合并态同步到风控引擎。
@@ -446,23 +533,69 @@ class BotApplication {
   void RefreshTradingHaltState();
   /// 每个行情 tick 驱动 Gate 运行时动作冷却计时。
   void TickGateRuntimeCooldown();
+  /// 应用热加载配置快照（仅运行期可调参数，拓扑字段保持启动快照）。
+  void ApplyHotConfigUpdate(const AppConfig& updated);
 
   // --- 成员变量 ---
   AppConfig config_;  ///< 应用级配置快照。
   std::string startup_utc_;  ///< 进程启动 UTC 时间（用于部署新鲜度与日志对齐）。
   std::string boot_id_;  ///< 进程启动唯一标识（同一进程内稳定，便于识别日志是否跨重启）。
   TradeSystem system_;  ///< 策略->风控->执行决策流水线。
+  /// 跨 tick 复用的决策对象：容量保留，使稳态评估路径零堆分配。
+  MarketDecision decision_scratch_;
   ExecutionEngine execution_;  ///< 保护单意图生成等执行辅助逻辑。
   OrderThrottle order_throttle_;  ///< 下单节流器（最小间隔/反向冷却）。
+  QuantizationTable quant_table_;  ///< 预计算 symbol 量化表（步长/精度）。
+  ConfigWatcher config_watcher_;  ///< 配置热加载监视器（可选启用）。
   SelfEvolutionController self_evolution_;  ///< 阶段2自进化控制器（权重更新/回滚）。
+  /// 自进化异步评估流水线（async_pipeline_enabled 且非回放时启用）。
+  std::unique_ptr<EvolutionPipeline> evolution_pipeline_;
   OrderManager oms_;  ///< 订单状态机与成交累计。
   Reconciler reconciler_;  ///< 本地/远端对账器。
   GateMonitor gate_monitor_;  ///< 活跃度门禁统计器。
   UniverseSelector universe_selector_;  ///< 多币种筛选器。
   WalStore wal_;  ///< WAL 持久化组件。
+  std::string state_snapshot_path_;  ///< 状态快照文件路径。
+  std::int64_t last_state_snapshot_ms_{0};  ///< 上次快照写出时间（墙钟 ms）。
+  /// 二进制决策日志（配置目录为空或写入失败时为 nullptr）。
+  std::unique_ptr<DecisionJournal> decision_journal_;
+
+  // --- 指标注册表槽位（进程单例注册，热路径单次 relaxed 原子操作） ---
+  MetricsHttpServer metrics_server_;  ///< Prometheus scrape 端点（metrics_port>0 时启用）。
+  ShmEventBusWriter shm_bus_;  ///< 共享内存事件总线（配置路径为空时不启用）。
+  /// 状态增量流写端（web 后端消费；配置路径为空时不启用）。
+  StateDeltaStreamWriter state_delta_stream_;
+  MetricCounter* metric_ticks_{nullptr};  ///< 已处理行情 tick 总数。
+  MetricCounter* metric_intents_enqueued_{nullptr};  ///< 已入执行队列的意图总数。
+  MetricCounter* metric_fills_{nullptr};  ///< 已应用成交总数。
+  MetricCounter* metric_async_submit_ok_{nullptr};  ///< 异步发单成功总数。
+  MetricCounter* metric_async_submit_failed_{nullptr};  ///< 异步发单失败总数。
+  MetricGauge* metric_equity_usd_{nullptr};  ///< 账户权益（状态窗口刷新）。
+  MetricGauge* metric_gross_notional_usd_{nullptr};  ///< 总名义敞口。
+  MetricGauge* metric_throttle_checks_{nullptr};  ///< 节流累计检查数。
+  MetricGauge* metric_throttle_rejected_{nullptr};  ///< 节流累计拒绝数。
+  MetricHistogram* metric_evaluate_latency_{nullptr};  ///< tick->intent 延迟直方图。
+  MetricGauge* metric_feed_ring_depth_{nullptr};  ///< 行情事件环当前深度。
+  MetricCounter* metric_feed_conflated_{nullptr};  ///< 环满按 symbol 合并的事件数。
+  MetricCounter* metric_tick_conflated_{nullptr};  ///< 决策侧折叠掉的超时 tick 数。
+  MetricGauge* metric_tick_backlog_{nullptr};  ///< 决策侧暂存表当前 symbol 数。
 
   std::unique_ptr<ExchangeAdapter> adapter_;  ///< 交易所适配器实例。
   std::unique_ptr<AsyncExecutor> executor_;  ///< 异步执行器（单线程串行发单）。
+  /// 行情事件环（读取线程启用时有效；读取线程写、决策线程读）。
+  std::unique_ptr<SpscRing<MarketEvent>> feed_ring_;
+  std::thread feed_reader_thread_;  ///< 专职 WS 读取+解析线程。
+  std::atomic<bool> feed_reader_stop_{false};  ///< 读取线程停止标志。
+  /// 主循环唤醒 eventfd：行情读取线程与执行通道线程写，主循环等待。
+  int main_wake_fd_{-1};
+  /// 决策侧按 symbol 的最新值暂存表（仅决策线程触达，无锁）。
+  std::unordered_map<std::string, MarketEvent> pending_ticks_;
+  /// 暂存表消费顺序（symbol 首现顺序），避免饥饿。
+  std::deque<std::string> pending_tick_order_;
+
+  /// 决策线程统一定时服务：主循环每轮 Advance 一次，组件按需注册
+  /// 到期回调（当前接入 required SL 确认截止），替代各自的全量扫描。
+  TimerWheel timer_wheel_;
 
   // 状态追踪
   std::unordered_set<std::string> intent_ids_; ///< 已处理的订单 ID (去重)
@@ -472,7 +605,7 @@ class BotApplication {
   std::unordered_map<std::string, std::int64_t> pending_net_order_enqueued_ms_;
   struct PendingRequiredSlAttach {
     std::string parent_order_id;
-    std::int64_t deadline_ms{0};
+    TimerWheel::TimerId timer_id{0};  ///< 定时轮里的截止回调句柄。
   };
   std::unordered_map<std::string, PendingRequiredSlAttach>
       pending_required_sl_attach_;
@@ -604,6 +737,9 @@ class BotApplication {
   int reconcile_streak_{0};        ///< 连续对账失败次数
   DecisionFunnelStats funnel_total_;  ///< 进程累计漏斗统计。
   DecisionFunnelStats funnel_window_;  ///< 日志窗口漏斗统计（周期清零）。
+  /// 按品种分片的成交质量累计（热路径 relaxed 原子，摘要时惰性聚合）。
+  ShardedSymbolStats entry_fill_quality_shards_;
+  ShardedSymbolStats symbol_fill_quality_shards_;
   RegimeState last_regime_state_;  ///< 最近一笔行情对应的 Regime 状态。
   bool has_last_regime_state_{false};  ///< 是否已有 Regime 状态可展示。
   Signal last_strategy_signal_;  ///< 最近一次“策略+自进化混合后”的基础信号。
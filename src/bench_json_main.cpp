@@ -0,0 +1,287 @@
+/**
+ * @brief bench_json：feed 路径 JSON 解析微基准
+ *
+ * 语料是 data/bench/bybit/ 下入库的 Bybit v5 WS 帧录制样本
+ * （ticker/kline/order/execution/wallet 五种形态），对每种消息分别
+ * 测 DOM 解析（ParseJson）与零拷贝视图解析（ParseJsonView + 典型
+ * 字段提取）的吞吐与每消息分配数。视图路径按 feed 的真实用法取
+ * topic 与 data 字段，而非只做结构校验。
+ *
+ * 输出默认人读表格；--json 产出逐项 JSON，供发布门禁做
+ * run-over-run 对比。tick-to-trade 的最前端靠它守住基线。
+ *
+ * 用法：
+ *   bench_json [--corpus-dir data/bench/bybit] [--min-time-ms 200]
+ *              [--filter 子串] [--json [路径]]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/json_utils.h"
+
+namespace {
+
+// 进程级分配计数（与 trade_bench 同口径）：DOM 解析的主要成本就是
+// 节点分配，allocs/msg 是比 ns/msg 更稳定的回归信号。
+std::atomic<std::uint64_t> g_alloc_count{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+struct BenchResult {
+  std::string message_type;
+  std::string parser;  // dom / view
+  std::size_t message_bytes{0};
+  std::uint64_t iterations{0};
+  double ns_per_msg{0.0};
+  double mb_per_s{0.0};
+  double allocs_per_msg{0.0};
+};
+
+struct BenchOptions {
+  std::string corpus_dir{"data/bench/bybit"};
+  int min_time_ms{200};
+  std::string filter;
+  bool json{false};
+  std::string json_path;
+};
+
+BenchResult RunBench(const std::string& message_type,
+                     const std::string& parser,
+                     std::size_t message_bytes,
+                     const BenchOptions& options,
+                     const std::function<void()>& body) {
+  constexpr std::uint64_t kWarmupIterations = 1000;
+  constexpr std::uint64_t kBatchIterations = 1000;
+  for (std::uint64_t i = 0; i < kWarmupIterations; ++i) {
+    body();
+  }
+
+  const auto min_duration = std::chrono::milliseconds(options.min_time_ms);
+  const std::uint64_t allocs_before =
+      g_alloc_count.load(std::memory_order_relaxed);
+  const auto start = std::chrono::steady_clock::now();
+  std::uint64_t iterations = 0;
+  auto elapsed = start - start;
+  do {
+    for (std::uint64_t i = 0; i < kBatchIterations; ++i) {
+      body();
+    }
+    iterations += kBatchIterations;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < min_duration);
+  const std::uint64_t allocs =
+      g_alloc_count.load(std::memory_order_relaxed) - allocs_before;
+  const double elapsed_ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+  BenchResult result;
+  result.message_type = message_type;
+  result.parser = parser;
+  result.message_bytes = message_bytes;
+  result.iterations = iterations;
+  result.ns_per_msg = elapsed_ns / static_cast<double>(iterations);
+  result.mb_per_s = static_cast<double>(message_bytes * iterations) * 1000.0 /
+                    elapsed_ns;  // bytes/ns -> MB/s（1e9/1e6）
+  result.allocs_per_msg =
+      static_cast<double>(allocs) / static_cast<double>(iterations);
+  return result;
+}
+
+bool LoadCorpusFile(const std::filesystem::path& path, std::string* out_text) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::ostringstream oss;
+  oss << in.rdbuf();
+  *out_text = oss.str();
+  // 去掉尾部换行，保持字节数与线上帧一致。
+  while (!out_text->empty() &&
+         (out_text->back() == '\n' || out_text->back() == '\r')) {
+    out_text->pop_back();
+  }
+  return !out_text->empty();
+}
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+void WriteResults(const std::vector<BenchResult>& results,
+                  const BenchOptions& options) {
+  if (options.json) {
+    std::ostringstream oss;
+    oss << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const BenchResult& r = results[i];
+      oss << "  {\"message_type\": \"" << JsonEscape(r.message_type) << "\""
+          << ", \"parser\": \"" << r.parser << "\""
+          << ", \"message_bytes\": " << r.message_bytes
+          << ", \"iterations\": " << r.iterations
+          << ", \"ns_per_msg\": " << r.ns_per_msg
+          << ", \"mb_per_s\": " << r.mb_per_s
+          << ", \"allocs_per_msg\": " << r.allocs_per_msg << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    oss << "]\n";
+    if (options.json_path.empty()) {
+      std::cout << oss.str();
+    } else {
+      std::ofstream out(options.json_path, std::ios::trunc);
+      out << oss.str();
+      if (!out.good()) {
+        std::cerr << "无法写入基准结果: " << options.json_path << "\n";
+      }
+    }
+    return;
+  }
+  std::cout << "message_type  parser  bytes    ns/msg      MB/s  allocs/msg\n";
+  for (const BenchResult& r : results) {
+    std::printf("%-13s %-7s %5zu %9.1f %9.1f %11.3f\n",
+                r.message_type.c_str(), r.parser.c_str(), r.message_bytes,
+                r.ns_per_msg, r.mb_per_s, r.allocs_per_msg);
+  }
+}
+
+void PrintUsage() {
+  std::cout
+      << "用法: bench_json [选项]\n"
+      << "  --corpus-dir 目录  帧语料目录（默认 data/bench/bybit）\n"
+      << "  --min-time-ms N    每项最短计时时长（默认 200）\n"
+      << "  --filter 子串      只运行消息类型含子串的项\n"
+      << "  --json [路径]      输出 JSON（省略路径时写 stdout）\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto next_value = [&](const char* flag) -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "缺少参数值: " << flag << "\n";
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      return 0;
+    } else if (arg == "--corpus-dir") {
+      options.corpus_dir = next_value(arg.c_str());
+    } else if (arg == "--min-time-ms") {
+      options.min_time_ms =
+          std::max(1, std::atoi(next_value(arg.c_str()).c_str()));
+    } else if (arg == "--filter") {
+      options.filter = next_value(arg.c_str());
+    } else if (arg == "--json") {
+      options.json = true;
+      if (i + 1 < argc && argv[i + 1][0] != '-') {
+        options.json_path = argv[++i];
+      }
+    } else {
+      std::cerr << "未知参数: " << arg << "\n";
+      PrintUsage();
+      return 2;
+    }
+  }
+
+  // 语料固定五种形态，覆盖 public（ticker/kline）与 private
+  // （order/execution/wallet）两条 WS 流的代表帧。
+  const char* kMessageTypes[] = {"ticker", "kline", "order", "execution",
+                                 "wallet"};
+  std::vector<BenchResult> results;
+  for (const char* message_type : kMessageTypes) {
+    if (!options.filter.empty() &&
+        std::string(message_type).find(options.filter) == std::string::npos) {
+      continue;
+    }
+    const std::filesystem::path path =
+        std::filesystem::path(options.corpus_dir) /
+        (std::string(message_type) + ".json");
+    std::string frame;
+    if (!LoadCorpusFile(path, &frame)) {
+      std::cerr << "无法读取语料帧: " << path.string() << "\n";
+      return 2;
+    }
+
+    // DOM 路径：与 feed 相同的完整树构建 + topic 提取。
+    results.push_back(RunBench(message_type, "dom", frame.size(), options, [&] {
+      ai_trade::JsonValue root;
+      std::string error;
+      if (!ai_trade::ParseJson(frame, &root, &error)) {
+        std::cerr << "DOM 解析失败: " << error << "\n";
+        std::exit(2);
+      }
+      const ai_trade::JsonValue* topic =
+          ai_trade::JsonObjectField(&root, "topic");
+      if (topic == nullptr) {
+        std::cerr << "语料帧缺少 topic 字段\n";
+        std::exit(2);
+      }
+    }));
+
+    // 视图路径：零拷贝解析 + 按 feed 用法提取 topic/ts 与 data 切片。
+    results.push_back(
+        RunBench(message_type, "view", frame.size(), options, [&] {
+          ai_trade::JsonView root;
+          std::string error;
+          if (!ai_trade::ParseJsonView(frame, &root, &error)) {
+            std::cerr << "视图解析失败: " << error << "\n";
+            std::exit(2);
+          }
+          ai_trade::JsonView topic;
+          ai_trade::JsonView data;
+          if (!ai_trade::JsonViewObjectField(root, "topic", &topic) ||
+              !ai_trade::JsonViewObjectField(root, "data", &data)) {
+            std::cerr << "语料帧缺少 topic/data 字段\n";
+            std::exit(2);
+          }
+        }));
+  }
+  if (results.empty()) {
+    std::cerr << "没有匹配 --filter 的消息类型: " << options.filter << "\n";
+    return 2;
+  }
+  WriteResults(results, options);
+  return 0;
+}
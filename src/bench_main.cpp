@@ -0,0 +1,368 @@
+/**
+ * @brief trade_bench：决策流水线热路径微基准
+ *
+ * 覆盖 TradeSystem::Evaluate（单/多 symbol）、OnFill、RegimeEngine
+ * 行情更新、RiskEngine::Apply 与 OrderThrottle::Allow。每个基准用
+ * MarketData::Next 预生成固定行情序列（同种子同序列，跑间可比），
+ * 计时循环按批推进直到达到最短采样时长，报告 ns/op 与 allocs/op
+ * （进程内 operator new 计数，含所有线程）。
+ *
+ * 输出默认是人读表格；--json 产出逐基准 JSON 行数组，供发布门禁
+ * 按 run-over-run 对比拦截性能回退。
+ *
+ * 用法：
+ *   trade_bench [--min-time-ms 200] [--filter 子串] [--json [路径]]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/types.h"
+#include "execution/order_throttle.h"
+#include "market/market_data.h"
+#include "regime/regime_engine.h"
+#include "risk/risk_engine.h"
+#include "system/trade_system.h"
+
+namespace {
+
+// 进程级分配计数：基准回归最常见的形态是热路径悄悄引入每 tick
+// 分配，ns/op 抖动可能淹没它，allocs/op 是硬指标（必须恰好为 0 或
+// 恰好为既有值）。计数覆盖所有线程，基准循环本身不得分配。
+std::atomic<std::uint64_t> g_alloc_count{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+struct BenchResult {
+  std::string name;
+  std::uint64_t iterations{0};
+  double ns_per_op{0.0};
+  double allocs_per_op{0.0};
+};
+
+struct BenchOptions {
+  int min_time_ms{200};
+  std::string filter;
+  bool json{false};
+  std::string json_path;  // 空表示写 stdout
+};
+
+/// 单个基准：setup 已在闭包内完成，body 每次调用执行一个操作。
+/// 先跑不计时的预热批（让缓冲区容量、regime 预热等进入稳态），
+/// 再按批计时推进到 min_time_ms，避免单次 clock 读数的量化误差。
+BenchResult RunBench(const std::string& name,
+                     const BenchOptions& options,
+                     const std::function<void()>& body) {
+  constexpr std::uint64_t kWarmupIterations = 2000;
+  constexpr std::uint64_t kBatchIterations = 1000;
+  for (std::uint64_t i = 0; i < kWarmupIterations; ++i) {
+    body();
+  }
+
+  const auto min_duration = std::chrono::milliseconds(options.min_time_ms);
+  const std::uint64_t allocs_before =
+      g_alloc_count.load(std::memory_order_relaxed);
+  const auto start = std::chrono::steady_clock::now();
+  std::uint64_t iterations = 0;
+  auto elapsed = start - start;
+  do {
+    for (std::uint64_t i = 0; i < kBatchIterations; ++i) {
+      body();
+    }
+    iterations += kBatchIterations;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < min_duration);
+  const std::uint64_t allocs =
+      g_alloc_count.load(std::memory_order_relaxed) - allocs_before;
+
+  BenchResult result;
+  result.name = name;
+  result.iterations = iterations;
+  result.ns_per_op =
+      static_cast<double>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count()) /
+      static_cast<double>(iterations);
+  result.allocs_per_op =
+      static_cast<double>(allocs) / static_cast<double>(iterations);
+  return result;
+}
+
+/// 固定行情序列：正弦走价叠加慢漂移，既覆盖趋势也覆盖震荡分支。
+std::vector<ai_trade::MarketEvent> MakeMarketEvents(
+    const std::vector<std::string>& symbols, std::size_t count) {
+  ai_trade::MarketData market;
+  std::vector<ai_trade::MarketEvent> events;
+  events.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const double step = static_cast<double>(i);
+    const double price =
+        100.0 + 5.0 * std::sin(step * 0.05) + 0.01 * step;
+    events.push_back(market.Next(price, symbols[i % symbols.size()]));
+  }
+  return events;
+}
+
+BenchResult BenchEvaluateSingleSymbol(const BenchOptions& options) {
+  auto system = std::make_unique<ai_trade::TradeSystem>(
+      /*risk_cap_usd=*/3000.0,
+      /*max_order_notional_usd=*/1000.0);
+  const auto events = MakeMarketEvents({"BTCUSDT"}, 4096);
+  auto decision = std::make_unique<ai_trade::MarketDecision>();
+  std::size_t cursor = 0;
+  return RunBench("evaluate_single_symbol", options, [&] {
+    system->Evaluate(events[cursor], /*trade_ok=*/true,
+                     /*symbol_inflight_notional_usd=*/0.0, decision.get());
+    cursor = (cursor + 1) % events.size();
+  });
+}
+
+BenchResult BenchEvaluateMultiSymbol(const BenchOptions& options) {
+  auto system = std::make_unique<ai_trade::TradeSystem>(
+      /*risk_cap_usd=*/3000.0,
+      /*max_order_notional_usd=*/1000.0);
+  const std::vector<std::string> symbols = {
+      "BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT",
+      "XRPUSDT", "ADAUSDT", "DOGEUSDT", "LTCUSDT"};
+  const auto events = MakeMarketEvents(symbols, 4096);
+  auto decision = std::make_unique<ai_trade::MarketDecision>();
+  std::size_t cursor = 0;
+  return RunBench("evaluate_multi_symbol_8", options, [&] {
+    system->Evaluate(events[cursor], /*trade_ok=*/true,
+                     /*symbol_inflight_notional_usd=*/0.0, decision.get());
+    cursor = (cursor + 1) % events.size();
+  });
+}
+
+BenchResult BenchOnFill(const BenchOptions& options) {
+  auto system = std::make_unique<ai_trade::TradeSystem>(
+      /*risk_cap_usd=*/3000.0,
+      /*max_order_notional_usd=*/1000.0);
+  // 买卖交替：持仓在 ±qty 间往返，长跑不发散。
+  ai_trade::FillEvent buy;
+  buy.fill_id = "bench-fill-buy";
+  buy.client_order_id = "bench-order-buy";
+  buy.direction = 1;
+  buy.qty = 0.01;
+  buy.price = 100.0;
+  ai_trade::FillEvent sell = buy;
+  sell.fill_id = "bench-fill-sell";
+  sell.client_order_id = "bench-order-sell";
+  sell.direction = -1;
+  bool flip = false;
+  return RunBench("on_fill", options, [&] {
+    system->OnFill(flip ? sell : buy);
+    flip = !flip;
+  });
+}
+
+BenchResult BenchRegimeOnMarket(const BenchOptions& options) {
+  auto engine = std::make_unique<ai_trade::RegimeEngine>();
+  const auto events = MakeMarketEvents({"BTCUSDT"}, 4096);
+  std::size_t cursor = 0;
+  return RunBench("regime_on_market", options, [&] {
+    (void)engine->OnMarket(events[cursor]);
+    cursor = (cursor + 1) % events.size();
+  });
+}
+
+BenchResult BenchRiskApply(const BenchOptions& options) {
+  auto engine = std::make_unique<ai_trade::RiskEngine>(
+      /*max_abs_notional_usd=*/3000.0);
+  ai_trade::TargetPosition target;
+  target.target_notional_usd = 500.0;
+  // 回撤序列横跨正常/降级/熔断阈值，覆盖状态机全部分支。
+  const double drawdowns[] = {0.00, 0.02, 0.06, 0.12, 0.20, 0.06, 0.02};
+  std::size_t cursor = 0;
+  return RunBench("risk_apply", options, [&] {
+    (void)engine->Apply(target, /*trade_ok=*/true, drawdowns[cursor],
+                        /*liq_distance_pct=*/1.0);
+    cursor = (cursor + 1) % (sizeof(drawdowns) / sizeof(drawdowns[0]));
+  });
+}
+
+BenchResult BenchOrderThrottleAllow(const BenchOptions& options) {
+  ai_trade::OrderThrottleConfig config;
+  config.min_order_interval_ms = 1000;
+  config.reverse_signal_cooldown_ticks = 3;
+  config.api_budget_per_window = 50;
+  config.api_order_budget_per_window = 20;
+  auto throttle = std::make_unique<ai_trade::OrderThrottle>(config);
+  ai_trade::OrderIntent intent;
+  intent.client_order_id = "bench-intent";
+  intent.direction = 1;
+  intent.qty = 0.01;
+  intent.price = 100.0;
+  std::string reason;
+  std::int64_t now_ms = 0;
+  std::int64_t tick_index = 0;
+  return RunBench("order_throttle_allow", options, [&] {
+    // 时间步长让放行与各拒绝分支都周期性命中。
+    now_ms += 137;
+    ++tick_index;
+    if (throttle->Allow(intent, now_ms, tick_index, &reason)) {
+      throttle->OnAccepted(intent, now_ms, tick_index);
+    }
+  });
+}
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+void WriteResults(const std::vector<BenchResult>& results,
+                  const BenchOptions& options) {
+  if (options.json) {
+    std::ostringstream oss;
+    oss << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const BenchResult& r = results[i];
+      oss << "  {\"name\": \"" << JsonEscape(r.name) << "\""
+          << ", \"iterations\": " << r.iterations
+          << ", \"ns_per_op\": " << r.ns_per_op
+          << ", \"allocs_per_op\": " << r.allocs_per_op << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    oss << "]\n";
+    if (options.json_path.empty()) {
+      std::cout << oss.str();
+    } else {
+      std::ofstream out(options.json_path, std::ios::trunc);
+      out << oss.str();
+      if (!out.good()) {
+        std::cerr << "无法写入基准结果: " << options.json_path << "\n";
+      }
+    }
+    return;
+  }
+  std::cout << "benchmark                      iterations     ns/op  allocs/op\n";
+  for (const BenchResult& r : results) {
+    std::ostringstream line;
+    line << r.name;
+    while (line.str().size() < 30) {
+      line << ' ';
+    }
+    std::cout << line.str();
+    std::printf("%11llu %9.1f %10.3f\n",
+                static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                r.allocs_per_op);
+  }
+}
+
+void PrintUsage() {
+  std::cout
+      << "用法: trade_bench [选项]\n"
+      << "  --min-time-ms N   每个基准最短计时时长（默认 200）\n"
+      << "  --filter 子串     只运行名称含子串的基准\n"
+      << "  --json [路径]     输出 JSON（省略路径时写 stdout）\n"
+      << "  --list            列出全部基准名后退出\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  bool list_only = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto next_value = [&](const char* flag) -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "缺少参数值: " << flag << "\n";
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      return 0;
+    } else if (arg == "--min-time-ms") {
+      options.min_time_ms = std::max(1, std::atoi(next_value(arg.c_str()).c_str()));
+    } else if (arg == "--filter") {
+      options.filter = next_value(arg.c_str());
+    } else if (arg == "--json") {
+      options.json = true;
+      if (i + 1 < argc && argv[i + 1][0] != '-') {
+        options.json_path = argv[++i];
+      }
+    } else if (arg == "--list") {
+      list_only = true;
+    } else {
+      std::cerr << "未知参数: " << arg << "\n";
+      PrintUsage();
+      return 2;
+    }
+  }
+
+  struct BenchEntry {
+    const char* name;
+    BenchResult (*run)(const BenchOptions&);
+  };
+  const BenchEntry benches[] = {
+      {"evaluate_single_symbol", BenchEvaluateSingleSymbol},
+      {"evaluate_multi_symbol_8", BenchEvaluateMultiSymbol},
+      {"on_fill", BenchOnFill},
+      {"regime_on_market", BenchRegimeOnMarket},
+      {"risk_apply", BenchRiskApply},
+      {"order_throttle_allow", BenchOrderThrottleAllow},
+  };
+
+  if (list_only) {
+    for (const BenchEntry& entry : benches) {
+      std::cout << entry.name << "\n";
+    }
+    return 0;
+  }
+
+  std::vector<BenchResult> results;
+  for (const BenchEntry& entry : benches) {
+    if (!options.filter.empty() &&
+        std::string(entry.name).find(options.filter) == std::string::npos) {
+      continue;
+    }
+    results.push_back(entry.run(options));
+  }
+  if (results.empty()) {
+    std::cerr << "没有匹配 --filter 的基准: " << options.filter << "\n";
+    return 2;
+  }
+  WriteResults(results, options);
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include "core/arena.h"
+
+#include <algorithm>
+
+namespace ai_trade {
+
+Arena::Arena(std::size_t block_bytes)
+    : block_bytes_(std::max<std::size_t>(block_bytes, 256)) {}
+
+void* Arena::Allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes == 0) {
+    bytes = 1;
+  }
+  for (;;) {
+    if (block_index_ < blocks_.size()) {
+      Block& block = blocks_[block_index_];
+      const std::size_t aligned_offset =
+          (offset_ + alignment - 1) & ~(alignment - 1);
+      if (aligned_offset + bytes <= block.capacity) {
+        void* out = block.data.get() + aligned_offset;
+        allocated_ += (aligned_offset - offset_) + bytes;
+        offset_ = aligned_offset + bytes;
+        return out;
+      }
+      // 当前块放不下：推进到下一块（保留块按申请顺序复用）。
+      ++block_index_;
+      offset_ = 0;
+      continue;
+    }
+    // 无可复用块：按需新建，超大请求独占一块，避免撑大常规块水位。
+    Block block;
+    block.capacity = std::max(block_bytes_, bytes + alignment);
+    block.data = std::make_unique<std::byte[]>(block.capacity);
+    blocks_.push_back(std::move(block));
+  }
+}
+
+void Arena::Reset() {
+  block_index_ = 0;
+  offset_ = 0;
+  allocated_ = 0;
+}
+
+std::size_t Arena::reserved_bytes() const {
+  std::size_t total = 0;
+  for (const Block& block : blocks_) {
+    total += block.capacity;
+  }
+  return total;
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief Bump 分配器（每 tick 作用域的竞技场分配器）
+ *
+ * 面向决策/格式化热路径上的临时对象：分配只推进当前块内指针，
+ * 不支持单独释放；`Reset()` 一次指针归位回收全部分配，已申请的
+ * 内存块保留复用，稳态下不再触碰系统分配器。
+ *
+ * 注意：从 Arena 分配的对象生命周期严格不得超过下一次 `Reset()`；
+ * 需要跨 tick 存活的数据（如进入执行队列的订单意图）必须拷贝到
+ * 常规容器。非线程安全，每个使用线程各持一个实例。
+ */
+class Arena {
+ public:
+  static constexpr std::size_t kDefaultBlockBytes = 64 * 1024;
+
+  explicit Arena(std::size_t block_bytes = kDefaultBlockBytes);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief 分配 bytes 字节（按 alignment 对齐）
+   *
+   * 当前块放不下时串接新块；超过块大小的请求分配独立大块。
+   */
+  void* Allocate(std::size_t bytes,
+                 std::size_t alignment = alignof(std::max_align_t));
+
+  /// 指针归位：回收全部已分配对象，内存块保留待复用。
+  void Reset();
+
+  /// 自上次 Reset 起累计分配字节数（含对齐填充）。
+  std::size_t allocated_bytes() const { return allocated_; }
+
+  /// 已向系统申请的总容量（跨 Reset 保留）。
+  std::size_t reserved_bytes() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    std::size_t capacity{0};
+  };
+
+  std::vector<Block> blocks_;
+  std::size_t block_index_{0};  ///< 当前分配块下标。
+  std::size_t offset_{0};       ///< 当前块内偏移。
+  std::size_t block_bytes_;
+  std::size_t allocated_{0};
+};
+
+/**
+ * @brief Arena 的 STL 分配器适配，供标准容器在竞技场上分配
+ *
+ * `deallocate` 为空操作：内存随 `Arena::Reset()` 整体回收。
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* /*ptr*/, std::size_t /*count*/) {}
+
+  Arena* arena() const { return arena_; }
+
+ private:
+  Arena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+using ArenaString =
+    std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+}  // namespace ai_trade
@@ -0,0 +1,35 @@
+#include "core/clock.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace ai_trade {
+
+namespace {
+
+std::int64_t ReadWallClockMs() {
+  const auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now());
+  return now.time_since_epoch().count();
+}
+
+// 0 表示从未刷新；墙钟毫秒恒为正，可安全复用作哨兵值。
+std::atomic<std::int64_t> g_cached_wall_ms{0};
+
+}  // namespace
+
+std::int64_t RefreshCachedClock() {
+  const std::int64_t now_ms = ReadWallClockMs();
+  g_cached_wall_ms.store(now_ms, std::memory_order_relaxed);
+  return now_ms;
+}
+
+std::int64_t NowMsCached() {
+  const std::int64_t cached = g_cached_wall_ms.load(std::memory_order_relaxed);
+  if (cached > 0) {
+    return cached;
+  }
+  return ReadWallClockMs();
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ai_trade {
+
+/**
+ * @brief 刷新进程级缓存时钟
+ *
+ * 主循环每轮迭代调用一次，实际读取一次系统时钟并写入进程级原子缓存，
+ * 供同一轮内的节流、日志、心跳等逻辑复用，避免每个事件都触发
+ * `clock_gettime` 系统调用。
+ *
+ * @return 刷新后的墙钟毫秒时间戳
+ */
+std::int64_t RefreshCachedClock();
+
+/**
+ * @brief 读取缓存的墙钟毫秒时间戳
+ *
+ * 精度由刷新频率决定（主循环每轮刷新一次，空转轮次约 10ms）。
+ * 若本进程尚未调用过 `RefreshCachedClock()`（如单测或启动早期），
+ * 退化为实时读取系统时钟，保证任何阶段都返回有效时间。
+ */
+std::int64_t NowMsCached();
+
+}  // namespace ai_trade
@@ -1,11 +1,15 @@
 #include "core/config.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <cctype>
 #include <cmath>
 #include <fstream>
 #include <sstream>
 
+#include "core/config_cache.h"
+
 namespace ai_trade {
 
 namespace {
@@ -239,14 +243,26 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
     return false;
   }
 
-  std::ifstream input(file_path);
-  if (!input.is_open()) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
     if (out_error != nullptr) {
       *out_error = "无法打开配置文件: " + file_path;
     }
     return false;
   }
+  std::string contents((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+  file.close();
 
+  // 二进制快照命中（源文件未变且格式版本一致）时跳过完整解析与校验，
+  // 把故障恢复场景的配置加载压缩到毫秒级。
+  const std::uint64_t source_hash = HashConfigSource(contents);
+  const std::string cache_path = file_path + ".cache";
+  if (TryLoadAppConfigCache(cache_path, source_hash, out_config)) {
+    return true;
+  }
+
+  std::istringstream input(contents);
   AppConfig config = *out_config;
   std::string current_section;
   std::string current_subsection;
@@ -537,6 +553,49 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "execution" && key == "api_budget_per_window") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error =
+              "execution.api_budget_per_window 解析失败，行号: " +
+              std::to_string(line_no);
+        }
+        return false;
+      }
+      config.execution_api_budget_per_window = parsed;
+      continue;
+    }
+
+    if (current_section == "execution" && key == "api_budget_window_ms") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error =
+              "execution.api_budget_window_ms 解析失败，行号: " +
+              std::to_string(line_no);
+        }
+        return false;
+      }
+      config.execution_api_budget_window_ms = parsed;
+      continue;
+    }
+
+    if (current_section == "execution" &&
+        key == "api_order_budget_per_window") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error =
+              "execution.api_order_budget_per_window 解析失败，行号: " +
+              std::to_string(line_no);
+        }
+        return false;
+      }
+      config.execution_api_order_budget_per_window = parsed;
+      continue;
+    }
+
     if (current_section == "execution" &&
         (key == "enable_fee_aware_entry_gate" ||
          key == "fee_aware_entry_gate")) {
@@ -2115,6 +2174,36 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "exchange" &&
+        current_subsection == "bybit" &&
+        key == "orderbook_enabled") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.bybit.orderbook_enabled 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.bybit.orderbook_enabled = parsed;
+      continue;
+    }
+
+    if (current_section == "exchange" &&
+        current_subsection == "bybit" &&
+        key == "orderbook_depth") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.bybit.orderbook_depth 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.bybit.orderbook_depth = parsed;
+      continue;
+    }
+
     if (current_section == "exchange" &&
         current_subsection == "bybit" &&
         key == "private_ws_enabled") {
@@ -2242,6 +2331,73 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "exchange" &&
+        current_subsection == "mux" &&
+        key == "market_venues") {
+      std::vector<std::string> parsed;
+      if (!ParseStringList(raw_value, &parsed) || parsed.empty()) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.mux.market_venues 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.mux.market_venues = std::move(parsed);
+      continue;
+    }
+
+    if (current_section == "exchange" &&
+        current_subsection == "mux" &&
+        key == "execution_venue") {
+      config.mux.execution_venue = NormalizeExchange(value);
+      continue;
+    }
+
+    if (current_section == "exchange" &&
+        current_subsection == "mux" &&
+        key == "symbol_routes") {
+      std::vector<std::string> parsed;
+      if (!ParseStringList(raw_value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.mux.symbol_routes 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.mux.symbol_routes = std::move(parsed);
+      continue;
+    }
+
+    if (current_section == "exchange" &&
+        current_subsection == "mux" &&
+        key == "ring_capacity") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.mux.ring_capacity 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.mux.ring_capacity = parsed;
+      continue;
+    }
+
+    if (current_section == "exchange" &&
+        current_subsection == "mux" &&
+        key == "poll_idle_sleep_us") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "exchange.mux.poll_idle_sleep_us 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.mux.poll_idle_sleep_us = parsed;
+      continue;
+    }
+
     if (current_section == "universe" && key == "enabled") {
       bool parsed = false;
       if (!ParseBool(value, &parsed)) {
@@ -2417,6 +2573,194 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "system" && key == "regime_preload_dir") {
+      config.regime_preload_dir = value;
+      continue;
+    }
+
+    if (current_section == "system" && key == "decision_journal_dir") {
+      config.decision_journal_dir = value;
+      continue;
+    }
+
+    if (current_section == "system" && key == "decision_journal_rotate_mb") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.decision_journal_rotate_mb 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.decision_journal_rotate_mb = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "metrics_port") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.metrics_port 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.metrics_port = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "shm_event_bus_path") {
+      config.shm_event_bus_path = value;
+      continue;
+    }
+
+    if (current_section == "system" && key == "state_delta_stream_path") {
+      config.state_delta_stream_path = value;
+      continue;
+    }
+
+    if (current_section == "system" && key == "state_delta_snapshot_interval") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.state_delta_snapshot_interval 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.state_delta_snapshot_interval = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "state_delta_rotate_mb") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.state_delta_rotate_mb 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.state_delta_rotate_mb = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "feed_reader_enabled") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.feed_reader_enabled 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.feed_reader_enabled = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "feed_ring_capacity") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.feed_ring_capacity 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.feed_ring_capacity = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "tick_conflation_enabled") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.tick_conflation_enabled 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.tick_conflation_enabled = parsed;
+      continue;
+    }
+
+    if (current_section == "system" && key == "executor_lanes") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "system.executor_lanes 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.executor_lanes = parsed;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "enabled") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "threads.enabled 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.threads.enabled = parsed;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "feed_cpus") {
+      config.threads.feed_cpus = value;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "decision_cpus") {
+      config.threads.decision_cpus = value;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "executor_cpus") {
+      config.threads.executor_cpus = value;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "logger_cpus") {
+      config.threads.logger_cpus = value;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "background_cpus") {
+      config.threads.background_cpus = value;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "decision_sched_fifo") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "threads.decision_sched_fifo 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.threads.decision_sched_fifo = parsed;
+      continue;
+    }
+
+    if (current_section == "threads" && key == "decision_fifo_priority") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "threads.decision_fifo_priority 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.threads.decision_fifo_priority = parsed;
+      continue;
+    }
+
     if (current_section == "system" && key == "id") {
       config.system_id = value;
       continue;
@@ -2658,6 +3002,32 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "gate" && key == "history_windows") {
+      int parsed = 0;
+      if (!ParseInt(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "gate.history_windows 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.gate.history_windows = parsed;
+      continue;
+    }
+
+    if (current_section == "gate" && key == "latency_p99_budget_us") {
+      double parsed = 0.0;
+      if (!ParseDouble(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "gate.latency_p99_budget_us 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.gate.latency_p99_budget_us = parsed;
+      continue;
+    }
+
     if (current_section == "gate" && key == "allow_policy_flat_windows") {
       bool parsed = false;
       if (!ParseBool(value, &parsed)) {
@@ -2974,6 +3344,12 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "integrator" && current_subsection == "shadow" &&
+        key == "native_model_path") {
+      config.integrator.shadow.native_model_path = value;
+      continue;
+    }
+
     if (current_section == "integrator" && current_subsection == "shadow" &&
         key == "active_meta_path") {
       config.integrator.shadow.active_meta_path = value;
@@ -3126,6 +3502,20 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
       continue;
     }
 
+    if (current_section == "self_evolution" &&
+        key == "async_pipeline_enabled") {
+      bool parsed = false;
+      if (!ParseBool(value, &parsed)) {
+        if (out_error != nullptr) {
+          *out_error = "self_evolution.async_pipeline_enabled 解析失败，行号: " +
+                       std::to_string(line_no);
+        }
+        return false;
+      }
+      config.self_evolution.async_pipeline_enabled = parsed;
+      continue;
+    }
+
     if (current_section == "self_evolution" &&
         key == "update_interval_ticks") {
       int parsed = 0;
@@ -4324,6 +4714,13 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
     }
     return false;
   }
+  // 本地定长簿最多保留 50 档，更深的订阅档位只是白付带宽。
+  if (config.bybit.orderbook_depth != 1 && config.bybit.orderbook_depth != 50) {
+    if (out_error != nullptr) {
+      *out_error = "exchange.bybit.orderbook_depth 仅支持 1 或 50";
+    }
+    return false;
+  }
   if (config.bybit.testnet && config.bybit.demo_trading) {
     if (out_error != nullptr) {
       *out_error =
@@ -4663,6 +5060,24 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
     }
     return false;
   }
+  if (config.execution_api_budget_per_window < 0) {
+    if (out_error != nullptr) {
+      *out_error = "execution.api_budget_per_window 不能为负数";
+    }
+    return false;
+  }
+  if (config.execution_api_budget_window_ms <= 0) {
+    if (out_error != nullptr) {
+      *out_error = "execution.api_budget_window_ms 必须为正数";
+    }
+    return false;
+  }
+  if (config.execution_api_order_budget_per_window < 0) {
+    if (out_error != nullptr) {
+      *out_error = "execution.api_order_budget_per_window 不能为负数";
+    }
+    return false;
+  }
   if (config.execution_entry_fee_bps < 0.0) {
     if (out_error != nullptr) {
       *out_error = "execution.entry_fee_bps 不能为负数";
@@ -5377,6 +5792,8 @@ bool LoadAppConfigFromYaml(const std::string& file_path,
     }
     return false;
   }
+  // 解析 + 校验全部通过后才落快照；写失败不致命，下次照常完整解析。
+  WriteAppConfigCache(cache_path, source_hash, config);
   *out_config = config;
   return true;
 }
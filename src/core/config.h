@@ -61,6 +61,10 @@ struct GateConfig {
   int pass_to_resume_windows{1};
   bool auto_resume_when_flat{true};
   int auto_resume_flat_ticks{120};
+  // 窗口计数环形历史深度（滚动统计 O(1) 推进，<=0 取默认 16）。
+  int history_windows{16};
+  // tick->intent 决策延迟 p99 预算（微秒）；<=0 关闭延迟门。
+  double latency_p99_budget_us{0.0};
 };
 
 struct BybitConfig {
@@ -73,6 +77,10 @@ struct BybitConfig {
   PositionMode expected_position_mode{PositionMode::kOneWay};
   bool public_ws_enabled{true};
   bool public_ws_rest_fallback{true};
+  // 公共 WS 是否加订 orderbook 深度通道（行情事件带顶档与不平衡，
+  // maker 被动单改按 best bid/ask 定价）。
+  bool orderbook_enabled{false};
+  int orderbook_depth{50};
   bool private_ws_enabled{true};
   bool private_ws_rest_fallback{true};
   int ws_reconnect_interval_ms{15000};
@@ -87,6 +95,20 @@ struct BybitConfig {
   int replay_default_interval_ms{5000};
 };
 
+/// exchange=mux 时的多所并发配置：行情多路时间序归并，执行按 symbol 路由。
+struct ExchangeMuxConfig {
+  // 行情来源 venue 列表（取值同 exchange 字段：bybit/binance/mock）。
+  std::vector<std::string> market_venues{"bybit", "binance"};
+  // 默认执行 venue；必须出现在 market_venues 中。
+  std::string execution_venue{"bybit"};
+  // "SYMBOL=venue" 覆盖项；未命中的 symbol 走 execution_venue。
+  std::vector<std::string> symbol_routes{};
+  // 每个 venue 的行情环容量（向上取整到 2 的幂）。
+  int ring_capacity{8192};
+  // venue 拉取线程无行情时的空转睡眠（微秒）。
+  int poll_idle_sleep_us{200};
+};
+
 struct UniverseConfig {
   bool enabled{true};
   int update_interval_ticks{20};
@@ -104,6 +126,10 @@ struct UniverseConfig {
 
 struct SelfEvolutionConfig {
   bool enabled{false};
+  // 异步评估流水线：热路径只把紧凑观测入环，统计累计与权重评估移交
+  // 后台线程，交易线程在 tick 边界原子应用已批准的权重切换。
+  // 回放模式强制同步路径以保证可复现。
+  bool async_pipeline_enabled{false};
   int update_interval_ticks{60};
   int min_update_interval_ticks{60};
   double min_abs_window_pnl_usd{0.0};
@@ -151,6 +177,9 @@ struct IntegratorShadowConfig {
   bool log_model_score{true};
   std::string model_report_path{"./data/research/integrator_report.json"};
   std::string model_path{"./data/models/integrator_latest.cbm"};
+  /// 原生对称树模型 blob 路径（tools/convert_catboost_model.py 产出）。
+  /// 非空时用进程内原生评估器打分，镜像无需 CatBoost 运行库。
+  std::string native_model_path{};
   std::string active_meta_path{"./data/models/integrator_active.json"};
   bool require_model_file{false};
   bool require_active_meta{false};
@@ -242,6 +271,20 @@ struct StrategyConfig {
   bool extreme_block_signals{false};
 };
 
+// 线程拓扑：BotApplication 各角色线程的绑核与调度策略。
+// 核号列表为 "0,2,4-7" 形态；空表示该角色不绑核（内核自由迁移）。
+struct ThreadTopologyConfig {
+  bool enabled{false};
+  std::string feed_cpus{};        // 行情读取线程
+  std::string decision_cpus{};    // 决策主循环线程
+  std::string executor_cpus{};    // 异步执行器工作线程
+  std::string logger_cpus{};      // 异步日志线程
+  std::string background_cpus{};  // 配置热加载/合约刷新/metrics 等后台线程
+  // 决策线程 SCHED_FIFO 提升（需 CAP_SYS_NICE；失败时降级为普通调度）。
+  bool decision_sched_fifo{false};
+  int decision_fifo_priority{10};
+};
+
 // ============================================================================
 // Main Application Config
 // ============================================================================
@@ -302,6 +345,12 @@ struct AppConfig {
   int execution_max_inflight_orders_per_symbol_direction{2};
   int execution_min_order_interval_ms{0};
   int execution_reverse_signal_cooldown_ticks{0};
+  // 交易所 API 预算：账户级每窗口请求数上限，0 表示不启用。
+  int execution_api_budget_per_window{0};
+  // API 预算窗口长度（毫秒），与交易所限频窗口对齐。
+  int execution_api_budget_window_ms{5000};
+  // 下单/撤单 endpoint 类的每窗口预算（账户级预算的子桶），0 表示不启用。
+  int execution_api_order_budget_per_window{0};
   bool execution_enable_fee_aware_entry_gate{true};
   double execution_entry_fee_bps{5.5};
   double execution_exit_fee_bps{5.5};
@@ -370,11 +419,56 @@ struct AppConfig {
 
   std::string exchange{"mock"};
   std::string data_path{"data"};
-  
+  // Regime 预热 K 线目录（ATCBAR1 列式文件，文件名主干为 symbol）；
+  // 为空时跳过预热，按实时 tick 走原 warmup 流程。
+  std::string regime_preload_dir{};
+
+  // 二进制决策日志目录（定长记录追加 + 按大小滚动，trade_journal_dump
+  // 离线解码为 JSONL）；为空时关闭决策日志。
+  std::string decision_journal_dir{};
+  // 决策日志单文件滚动阈值（MiB）。
+  int decision_journal_rotate_mb{64};
+
+  // Prometheus scrape 端点监听端口；<=0 关闭内嵌 metrics 服务。
+  int metrics_port{0};
+
+  // 共享内存事件总线文件路径（建议放 /dev/shm 下）；为空时关闭总线。
+  // sidecar（web 后端/审计工具）只读映射该文件消费行情/决策/成交。
+  std::string shm_event_bus_path{};
+
+  // 状态增量流文件路径（web 后端秒级消费）；为空时关闭。
+  // bot 把运行态（持仓/风险模式/漏斗计数）的字段级变化按版本号
+  // 追加为 JSONL，读端见 backend/app/services/state_stream.py。
+  std::string state_delta_stream_path{};
+  // 每多少条记录重发一次全量快照（读端冷启动/丢行恢复锚点）。
+  int state_delta_snapshot_interval{50};
+  // 流文件超过该大小（MB）时截断重写快照。
+  int state_delta_rotate_mb{16};
+
+  // 专职行情读取线程：true 时 WS 读取+解析在独立线程进行，经有界
+  // SPSC 环送入决策线程，行情活性不再受决策路径延迟影响；环满时
+  // 按 symbol 合并（价格取最新、增量 volume/interval 累加）。
+  // replay 模式忽略该开关（回放要求单线程确定性）。
+  bool feed_reader_enabled{false};
+  // 行情事件环容量（向上取整到 2 的幂）。
+  int feed_ring_capacity{4096};
+  // 决策侧最新值折叠：true 时决策落后期间同 symbol 的积压行情按
+  // 最新值折叠（价格取最新、增量 volume/interval 累加）后再进入
+  // Evaluate，被折叠的 tick 计入 ai_trade_tick_conflated_total。
+  // replay 模式忽略该开关（回放按原始事件序演进）。
+  bool tick_conflation_enabled{false};
+
+  // 异步执行器工作通道数：同一 symbol 的任务按哈希固定通道串行执行，
+  // 不同 symbol 并发提交；1 = 原单线程串行行为。
+  int executor_lanes{1};
+
+  ThreadTopologyConfig threads{};
+
   ProtectionConfig protection{};
   ReconcileConfig reconcile{};
   GateConfig gate{};
   BybitConfig bybit{};
+  ExchangeMuxConfig mux{};
   UniverseConfig universe{};
   IntegratorConfig integrator{};
   SelfEvolutionConfig self_evolution{};
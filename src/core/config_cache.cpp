@@ -0,0 +1,471 @@
+#include "core/config_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "core/snapshot_io.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 快照文件头：magic + 格式版本 + 源文件哈希 + sizeof(AppConfig)。
+// 格式版本在序列化布局变更时递增；sizeof 作为兜底防线，捕获
+// “新增 AppConfig 字段但忘记同步 ArchiveFields/版本号”的大多数情况。
+// 快照只在本机生成本机消费，数值按宿主字节序原样存取。
+constexpr std::uint32_t kConfigCacheMagic = 0x43435441;  // "ATCC"
+constexpr std::uint32_t kConfigCacheVersion = 16;
+
+struct CacheHeader {
+  std::uint32_t magic{0};
+  std::uint32_t version{0};
+  std::uint64_t source_hash{0};
+  std::uint64_t config_struct_size{0};
+};
+
+// 字段清单与结构体声明顺序一一对应；增删字段时同步更新并递增
+// kConfigCacheVersion。读写共用同一份清单，杜绝两端不一致。
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, RiskThresholds& c) {
+  ar.Field(c.degraded_drawdown);
+  ar.Field(c.degraded_recover_drawdown);
+  ar.Field(c.cooldown_drawdown);
+  ar.Field(c.cooldown_recover_drawdown);
+  ar.Field(c.fuse_drawdown);
+  ar.Field(c.fuse_recover_drawdown);
+  ar.Field(c.min_liquidation_distance);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, ProtectionConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.require_sl);
+  ar.Field(c.enable_tp);
+  ar.Field(c.attach_timeout_ms);
+  ar.Field(c.stop_loss_ratio);
+  ar.Field(c.take_profit_ratio);
+  ar.Field(c.dynamic_distance_enabled);
+  ar.Field(c.dynamic_distance_volatility_multiplier);
+  ar.Field(c.dynamic_stop_loss_min_ratio);
+  ar.Field(c.dynamic_stop_loss_max_ratio);
+  ar.Field(c.dynamic_take_profit_min_ratio);
+  ar.Field(c.dynamic_take_profit_max_ratio);
+  ar.Field(c.dynamic_take_profit_rr_multiplier);
+  ar.Field(c.break_even_enabled);
+  ar.Field(c.break_even_trigger_ratio);
+  ar.Field(c.break_even_offset_ratio);
+  ar.Field(c.trailing_enabled);
+  ar.Field(c.trailing_trigger_ratio);
+  ar.Field(c.trailing_distance_ratio);
+  ar.Field(c.profit_protection_min_update_ratio);
+  ar.Field(c.profit_protection_immediate_reduce_enabled);
+  ar.Field(c.profit_protection_immediate_min_net_bps);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, ReconcileConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.interval_ticks);
+  ar.Field(c.tolerance_notional_usd);
+  ar.Field(c.mismatch_confirmations);
+  ar.Field(c.pending_order_stale_ms);
+  ar.Field(c.anomaly_reduce_only_streak);
+  ar.Field(c.anomaly_halt_streak);
+  ar.Field(c.anomaly_resume_streak);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, GateConfig& c) {
+  ar.Field(c.min_effective_signals_per_window);
+  ar.Field(c.min_fills_per_window);
+  ar.Field(c.heartbeat_empty_signal_ticks);
+  ar.Field(c.window_ticks);
+  ar.Field(c.allow_policy_flat_windows);
+  ar.Field(c.enforce_runtime_actions);
+  ar.Field(c.fail_to_reduce_only_windows);
+  ar.Field(c.fail_to_halt_windows);
+  ar.Field(c.reduce_only_cooldown_ticks);
+  ar.Field(c.halt_cooldown_ticks);
+  ar.Field(c.pass_to_resume_windows);
+  ar.Field(c.auto_resume_when_flat);
+  ar.Field(c.auto_resume_flat_ticks);
+  ar.Field(c.history_windows);
+  ar.Field(c.latency_p99_budget_us);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, BybitConfig& c) {
+  ar.Field(c.testnet);
+  ar.Field(c.demo_trading);
+  ar.Field(c.category);
+  ar.Field(c.account_type);
+  ar.Field(c.expected_account_mode);
+  ar.Field(c.expected_margin_mode);
+  ar.Field(c.expected_position_mode);
+  ar.Field(c.public_ws_enabled);
+  ar.Field(c.public_ws_rest_fallback);
+  ar.Field(c.orderbook_enabled);
+  ar.Field(c.orderbook_depth);
+  ar.Field(c.private_ws_enabled);
+  ar.Field(c.private_ws_rest_fallback);
+  ar.Field(c.ws_reconnect_interval_ms);
+  ar.Field(c.execution_poll_limit);
+  ar.Field(c.replay_market_data_path);
+  ar.Field(c.replay_timestamp_column);
+  ar.Field(c.replay_symbol_column);
+  ar.Field(c.replay_price_column);
+  ar.Field(c.replay_volume_column);
+  ar.Field(c.replay_interval_column);
+  ar.Field(c.replay_funding_rate_column);
+  ar.Field(c.replay_default_interval_ms);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, ExchangeMuxConfig& c) {
+  ar.Field(c.market_venues);
+  ar.Field(c.execution_venue);
+  ar.Field(c.symbol_routes);
+  ar.Field(c.ring_capacity);
+  ar.Field(c.poll_idle_sleep_us);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, UniverseConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.update_interval_ticks);
+  ar.Field(c.max_active_symbols);
+  ar.Field(c.min_active_symbols);
+  ar.Field(c.min_turnover_usd);
+  ar.Field(c.trend_reserve_enabled);
+  ar.Field(c.trend_reserve_slots);
+  ar.Field(c.trend_reserve_min_residency_refreshes);
+  ar.Field(c.warmup_trend_reserve_min_ratio);
+  ar.Field(c.reset_stats_on_refresh);
+  ar.Field(c.fallback_symbols);
+  ar.Field(c.candidate_symbols);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, IntegratorShadowConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.log_model_score);
+  ar.Field(c.model_report_path);
+  ar.Field(c.model_path);
+  ar.Field(c.native_model_path);
+  ar.Field(c.active_meta_path);
+  ar.Field(c.require_model_file);
+  ar.Field(c.require_active_meta);
+  ar.Field(c.require_gate_pass);
+  ar.Field(c.min_auc_mean);
+  ar.Field(c.min_delta_auc_vs_baseline);
+  ar.Field(c.min_split_trained_count);
+  ar.Field(c.min_split_trained_ratio);
+  ar.Field(c.score_gain);
+  ar.Field(c.feature_window_ticks);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, IntegratorConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.model_type);
+  ar.Field(c.mode);
+  ar.Field(c.canary_notional_ratio);
+  ar.Field(c.canary_min_notional_usd);
+  ar.Field(c.canary_confidence_threshold);
+  ar.Field(c.canary_allow_countertrend);
+  ar.Field(c.active_confidence_threshold);
+  ar.Field(c.active_min_notional_usd);
+  ar.Field(c.active_partial_notional_ratio);
+  ar.Field(c.active_full_notional_confidence_threshold);
+  ArchiveFields(ar, c.shadow);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, SelfEvolutionConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.async_pipeline_enabled);
+  ar.Field(c.update_interval_ticks);
+  ar.Field(c.min_update_interval_ticks);
+  ar.Field(c.min_abs_window_pnl_usd);
+  ar.Field(c.min_bucket_ticks_for_update);
+  ar.Field(c.min_consecutive_direction_windows);
+  ar.Field(c.use_virtual_pnl);
+  ar.Field(c.use_counterfactual_search);
+  ar.Field(c.counterfactual_fallback_to_factor_ic);
+  ar.Field(c.counterfactual_min_improvement_usd);
+  ar.Field(c.counterfactual_min_improvement_ratio_of_equity);
+  ar.Field(c.counterfactual_improvement_decay_per_filtered_signal_usd);
+  ar.Field(c.counterfactual_min_fill_count_for_update);
+  ar.Field(c.counterfactual_min_t_stat_samples_for_update);
+  ar.Field(c.counterfactual_min_t_stat_abs_for_update);
+  ar.Field(c.counterfactual_superiority_min_samples_for_update);
+  ar.Field(c.counterfactual_superiority_min_t_stat_for_update);
+  ar.Field(c.virtual_cost_bps);
+  ar.Field(c.virtual_cost_dynamic_enabled);
+  ar.Field(c.virtual_cost_dynamic_max_multiplier);
+  ar.Field(c.virtual_funding_rate_per_tick);
+  ar.Field(c.enable_factor_ic_adaptive_weights);
+  ar.Field(c.factor_ic_min_samples);
+  ar.Field(c.factor_ic_min_abs);
+  ar.Field(c.factor_ic_deadzone_abs);
+  ar.Field(c.enable_learnability_gate);
+  ar.Field(c.learnability_min_samples);
+  ar.Field(c.learnability_min_t_stat_abs);
+  ar.Field(c.min_effective_weight_delta);
+  ar.Field(c.objective_alpha_pnl);
+  ar.Field(c.objective_beta_drawdown);
+  ar.Field(c.objective_gamma_notional_churn);
+  ar.Field(c.objective_use_sharpe_like);
+  ar.Field(c.max_single_strategy_weight);
+  ar.Field(c.max_weight_step);
+  ar.Field(c.rollback_degrade_windows);
+  ar.Field(c.rollback_degrade_threshold_score);
+  ar.Field(c.rollback_to_baseline_on_trigger);
+  ar.Field(c.rollback_cooldown_ticks);
+  ar.Field(c.initial_trend_weight);
+  ar.Field(c.initial_defensive_weight);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, RegimeConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.warmup_ticks);
+  ar.Field(c.ewma_alpha);
+  ar.Field(c.bar_interval_ms);
+  ar.Field(c.switch_confirm_ticks);
+  ar.Field(c.extreme_requires_both);
+  ar.Field(c.volume_extreme_multiplier);
+  ar.Field(c.trend_threshold);
+  ar.Field(c.extreme_threshold);
+  ar.Field(c.volatility_threshold);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, ThreadTopologyConfig& c) {
+  ar.Field(c.enabled);
+  ar.Field(c.feed_cpus);
+  ar.Field(c.decision_cpus);
+  ar.Field(c.executor_cpus);
+  ar.Field(c.logger_cpus);
+  ar.Field(c.background_cpus);
+  ar.Field(c.decision_sched_fifo);
+  ar.Field(c.decision_fifo_priority);
+}
+
+template <typename Archive>
+void ArchiveFields(Archive& ar, AppConfig& c) {
+  ar.Field(c.system_id);
+  ar.Field(c.mode);
+  ar.Field(c.primary_symbol);
+  ar.Field(c.system_max_ticks);
+  ar.Field(c.system_status_log_interval_ticks);
+  ar.Field(c.system_remote_risk_refresh_interval_ticks);
+  ar.Field(c.strategy_signal_notional_usd);
+  ar.Field(c.strategy_signal_deadband_abs);
+  ar.Field(c.strategy_signal_deadband_bps);
+  ar.Field(c.strategy_signal_valid_for_ms);
+  ar.Field(c.strategy_default_tick_interval_ms);
+  ar.Field(c.strategy_min_hold_ticks);
+  ar.Field(c.trend_ema_fast);
+  ar.Field(c.trend_ema_slow);
+  ar.Field(c.strategy_trend_breakout_lookback_ticks);
+  ar.Field(c.strategy_trend_breakout_rank_threshold);
+  ar.Field(c.strategy_trend_slope_lookback_ticks);
+  ar.Field(c.strategy_trend_slope_min_abs);
+  ar.Field(c.strategy_trend_vol_cap_annual);
+  ar.Field(c.strategy_trend_strength_scale);
+  ar.Field(c.strategy_trend_trend_scale);
+  ar.Field(c.strategy_trend_range_scale);
+  ar.Field(c.strategy_trend_extreme_scale);
+  ar.Field(c.vol_target_pct);
+  ar.Field(c.strategy_vol_target_max_leverage);
+  ar.Field(c.strategy_vol_target_low_vol_leverage_cap_enabled);
+  ar.Field(c.strategy_vol_target_low_vol_annual_threshold);
+  ar.Field(c.strategy_vol_target_low_vol_max_leverage);
+  ar.Field(c.strategy_vol_target_rebalance_min_abs_usd);
+  ar.Field(c.strategy_vol_target_rebalance_min_ratio);
+  ar.Field(c.strategy_defensive_notional_ratio);
+  ar.Field(c.strategy_defensive_entry_score);
+  ar.Field(c.strategy_defensive_rank_lookback_ticks);
+  ar.Field(c.strategy_defensive_trend_scale);
+  ar.Field(c.strategy_defensive_range_scale);
+  ar.Field(c.strategy_defensive_extreme_scale);
+  ar.Field(c.strategy_range_min_confidence);
+  ar.Field(c.strategy_eth_range_defensive_scale_multiplier);
+  ar.Field(c.strategy_extreme_block_signals);
+  ar.Field(c.risk_max_abs_notional_usd);
+  ArchiveFields(ar, c.risk_thresholds);
+  ar.Field(c.execution_max_order_notional);
+  ar.Field(c.execution_min_rebalance_notional_usd);
+  ar.Field(c.execution_same_side_rebalance_multiplier);
+  ar.Field(c.execution_include_inflight_notional_in_position);
+  ar.Field(c.execution_direct_flip_entry_enabled);
+  ar.Field(c.execution_max_inflight_orders_per_symbol_direction);
+  ar.Field(c.execution_min_order_interval_ms);
+  ar.Field(c.execution_api_budget_per_window);
+  ar.Field(c.execution_api_budget_window_ms);
+  ar.Field(c.execution_api_order_budget_per_window);
+  ar.Field(c.execution_reverse_signal_cooldown_ticks);
+  ar.Field(c.execution_enable_fee_aware_entry_gate);
+  ar.Field(c.execution_entry_fee_bps);
+  ar.Field(c.execution_exit_fee_bps);
+  ar.Field(c.execution_expected_slippage_bps);
+  ar.Field(c.execution_min_expected_edge_bps);
+  ar.Field(c.execution_required_edge_cap_bps);
+  ar.Field(c.execution_entry_gate_near_miss_tolerance_bps);
+  ar.Field(c.execution_entry_gate_near_miss_maker_allow);
+  ar.Field(c.execution_entry_gate_near_miss_maker_max_gap_bps);
+  ar.Field(c.execution_adaptive_fee_gate_enabled);
+  ar.Field(c.execution_adaptive_fee_gate_min_samples);
+  ar.Field(c.execution_adaptive_fee_gate_trigger_ratio);
+  ar.Field(c.execution_adaptive_fee_gate_max_relax_bps);
+  ar.Field(c.execution_maker_entry_enabled);
+  ar.Field(c.execution_maker_fallback_to_market);
+  ar.Field(c.execution_maker_price_offset_bps);
+  ar.Field(c.execution_maker_post_only);
+  ar.Field(c.execution_maker_edge_relax_bps);
+  ar.Field(c.execution_cost_filter_cooldown_trigger_count);
+  ar.Field(c.execution_cost_filter_cooldown_ticks);
+  ar.Field(c.execution_strategy_reduce_cost_guard_enabled);
+  ar.Field(c.execution_strategy_reduce_min_net_bps);
+  ar.Field(c.execution_strategy_reduce_max_adverse_bps);
+  ar.Field(c.execution_strategy_reduce_guard_max_hold_ticks);
+  ar.Field(c.execution_quality_guard_enabled);
+  ar.Field(c.execution_quality_guard_min_fills);
+  ar.Field(c.execution_quality_guard_bad_streak_to_trigger);
+  ar.Field(c.execution_quality_guard_good_streak_to_release);
+  ar.Field(c.execution_quality_guard_min_realized_net_per_fill_usd);
+  ar.Field(c.execution_quality_guard_max_fee_bps_per_fill);
+  ar.Field(c.execution_quality_guard_required_edge_penalty_bps);
+  ar.Field(c.execution_quality_guard_required_edge_floor_bps);
+  ar.Field(c.execution_concentration_top1_share_threshold);
+  ar.Field(c.execution_concentration_penalty_bps);
+  ar.Field(c.execution_concentration_min_symbols);
+  ar.Field(c.execution_dynamic_edge_enabled);
+  ar.Field(c.execution_dynamic_edge_regime_trend_relax_bps);
+  ar.Field(c.execution_dynamic_edge_regime_range_penalty_bps);
+  ar.Field(c.execution_dynamic_edge_regime_extreme_penalty_bps);
+  ar.Field(c.execution_dynamic_edge_volatility_relax_bps);
+  ar.Field(c.execution_dynamic_edge_volatility_penalty_bps);
+  ar.Field(c.execution_dynamic_edge_liquidity_maker_ratio_threshold);
+  ar.Field(c.execution_dynamic_edge_liquidity_unknown_ratio_threshold);
+  ar.Field(c.execution_dynamic_edge_liquidity_relax_bps);
+  ar.Field(c.execution_dynamic_edge_liquidity_penalty_bps);
+  ar.Field(c.execution_candidate_probe_enabled);
+  ar.Field(c.execution_candidate_probe_min_trend_ratio);
+  ar.Field(c.execution_candidate_probe_strong_min_trend_ratio);
+  ar.Field(c.execution_candidate_probe_notional_usd);
+  ar.Field(c.execution_candidate_probe_max_edge_gap_bps);
+  ar.Field(c.execution_candidate_probe_memory_max_edge_gap_bps);
+  ar.Field(c.execution_candidate_probe_memory_min_trend_ratio);
+  ar.Field(c.execution_candidate_probe_diagnostic_canary_enabled);
+  ar.Field(c.execution_candidate_probe_diagnostic_min_trend_ratio);
+  ar.Field(c.execution_candidate_probe_diagnostic_max_edge_gap_bps);
+  ar.Field(c.execution_candidate_probe_diagnostic_min_expected_edge_bps);
+  ar.Field(c.execution_candidate_probe_reduce_min_net_bps);
+  ar.Field(c.execution_candidate_probe_reduce_max_adverse_bps);
+  ar.Field(c.execution_candidate_probe_cooldown_ticks);
+  ar.Field(c.execution_candidate_probe_max_per_window);
+  ar.Field(c.execution_candidate_probe_post_only_timeout_ticks);
+  ar.Field(c.execution_candidate_probe_reprice_max_attempts);
+  ar.Field(c.execution_candidate_probe_reprice_bps);
+  ar.Field(c.execution_candidate_probe_taker_fallback_enabled);
+  ar.Field(c.execution_candidate_probe_taker_fallback_min_trend_ratio);
+  ar.Field(c.exchange);
+  ar.Field(c.data_path);
+  ar.Field(c.regime_preload_dir);
+  ar.Field(c.decision_journal_dir);
+  ar.Field(c.decision_journal_rotate_mb);
+  ar.Field(c.metrics_port);
+  ar.Field(c.shm_event_bus_path);
+  ar.Field(c.state_delta_stream_path);
+  ar.Field(c.state_delta_snapshot_interval);
+  ar.Field(c.state_delta_rotate_mb);
+  ar.Field(c.feed_reader_enabled);
+  ar.Field(c.feed_ring_capacity);
+  ar.Field(c.tick_conflation_enabled);
+  ar.Field(c.executor_lanes);
+  ArchiveFields(ar, c.threads);
+  ArchiveFields(ar, c.protection);
+  ArchiveFields(ar, c.reconcile);
+  ArchiveFields(ar, c.gate);
+  ArchiveFields(ar, c.bybit);
+  ArchiveFields(ar, c.mux);
+  ArchiveFields(ar, c.universe);
+  ArchiveFields(ar, c.integrator);
+  ArchiveFields(ar, c.self_evolution);
+  ArchiveFields(ar, c.regime);
+}
+
+}  // namespace
+
+std::uint64_t HashConfigSource(std::string_view contents) {
+  // FNV-1a 64 位。
+  std::uint64_t hash = 1469598103934665603ULL;
+  for (const char ch : contents) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool TryLoadAppConfigCache(const std::string& cache_path,
+                           std::uint64_t source_hash,
+                           AppConfig* out_config) {
+  if (out_config == nullptr) {
+    return false;
+  }
+  std::ifstream input(cache_path, std::ios::binary);
+  if (!input.is_open()) {
+    return false;
+  }
+  std::string contents((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+  if (contents.size() < sizeof(CacheHeader)) {
+    return false;
+  }
+  CacheHeader header;
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kConfigCacheMagic ||
+      header.version != kConfigCacheVersion ||
+      header.source_hash != source_hash ||
+      header.config_struct_size != sizeof(AppConfig)) {
+    return false;
+  }
+  SnapshotReader reader(
+      std::string_view(contents).substr(sizeof(CacheHeader)));
+  AppConfig config;
+  ArchiveFields(reader, config);
+  if (!reader.fully_consumed()) {
+    return false;
+  }
+  *out_config = std::move(config);
+  return true;
+}
+
+bool WriteAppConfigCache(const std::string& cache_path,
+                         std::uint64_t source_hash,
+                         const AppConfig& config) {
+  SnapshotWriter writer;
+  AppConfig mutable_copy = config;
+  ArchiveFields(writer, mutable_copy);
+
+  CacheHeader header;
+  header.magic = kConfigCacheMagic;
+  header.version = kConfigCacheVersion;
+  header.source_hash = source_hash;
+  header.config_struct_size = sizeof(AppConfig);
+
+  std::ofstream output(cache_path, std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    return false;
+  }
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(writer.buffer().data(),
+               static_cast<std::streamsize>(writer.buffer().size()));
+  return output.good();
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "core/config.h"
+
+namespace ai_trade {
+
+/**
+ * @brief 计算配置源文件内容的 64 位哈希（FNV-1a）
+ *
+ * 作为二进制快照的键：源文件字节不变则哈希不变，快照可直接复用。
+ */
+std::uint64_t HashConfigSource(std::string_view contents);
+
+/**
+ * @brief 尝试从二进制快照加载已解析的 AppConfig
+ *
+ * 快照头部记录格式版本、源文件哈希与 `sizeof(AppConfig)`，任一不匹配
+ * （源文件已修改、代码升级、快照损坏）即返回 false，调用方回退到完整
+ * 解析路径。快照内容是完整解析 + 校验后的结果，命中时无需重新校验。
+ *
+ * @param cache_path  快照文件路径
+ * @param source_hash 当前配置源文件内容哈希
+ * @param out_config  输出配置（仅在返回 true 时写入）
+ */
+bool TryLoadAppConfigCache(const std::string& cache_path,
+                           std::uint64_t source_hash,
+                           AppConfig* out_config);
+
+/**
+ * @brief 将已解析校验的 AppConfig 写为二进制快照
+ *
+ * 写入失败（目录只读等）不视为致命错误，下次启动照常走完整解析。
+ *
+ * @return 是否写入成功
+ */
+bool WriteAppConfigCache(const std::string& cache_path,
+                         std::uint64_t source_hash,
+                         const AppConfig& config);
+
+}  // namespace ai_trade
@@ -0,0 +1,103 @@
+#include "core/config_watcher.h"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "core/config_cache.h"
+#include "core/log.h"
+#include "core/thread_topology.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 轮询间隔：热加载延迟上限，对调参场景足够即时，又不构成 IO 压力。
+constexpr auto kWatchPollInterval = std::chrono::milliseconds(500);
+
+bool ReadFileContents(const std::string& path, std::string* out_contents) {
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    return false;
+  }
+  out_contents->assign((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+  return true;
+}
+
+}  // namespace
+
+ConfigWatcher::~ConfigWatcher() {
+  Stop();
+}
+
+bool ConfigWatcher::Start(const std::string& config_path,
+                          std::string* out_error) {
+  if (worker_.joinable()) {
+    if (out_error != nullptr) {
+      *out_error = "ConfigWatcher 已启动";
+    }
+    return false;
+  }
+  std::string contents;
+  if (!ReadFileContents(config_path, &contents)) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开配置文件: " + config_path;
+    }
+    return false;
+  }
+  config_path_ = config_path;
+  last_seen_hash_ = HashConfigSource(contents);
+  stop_requested_.store(false, std::memory_order_release);
+  worker_ = std::thread([this]() { Run(); });
+  return true;
+}
+
+void ConfigWatcher::Stop() {
+  stop_requested_.store(true, std::memory_order_release);
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+std::unique_ptr<const AppConfig> ConfigWatcher::PollUpdated() {
+  return std::unique_ptr<const AppConfig>(
+      pending_.exchange(nullptr, std::memory_order_acquire));
+}
+
+void ConfigWatcher::Run() {
+  ApplyThreadRole(ThreadRole::kBackground);
+  while (!stop_requested_.load(std::memory_order_acquire)) {
+    std::this_thread::sleep_for(kWatchPollInterval);
+
+    std::string contents;
+    if (!ReadFileContents(config_path_, &contents)) {
+      // 文件暂不可读（编辑器原子替换的中间态等），下一轮重试。
+      continue;
+    }
+    const std::uint64_t hash = HashConfigSource(contents);
+    if (hash == last_seen_hash_) {
+      continue;
+    }
+
+    AppConfig parsed;
+    std::string error;
+    if (!LoadAppConfigFromYaml(config_path_, &parsed, &error)) {
+      if (hash != last_failed_hash_) {
+        LogError("CONFIG_HOT_RELOAD_REJECTED: " + error);
+        last_failed_hash_ = hash;
+      }
+      continue;
+    }
+    last_seen_hash_ = hash;
+    last_failed_hash_ = 0;
+
+    const AppConfig* fresh = new AppConfig(std::move(parsed));
+    // 覆盖尚未被消费的旧待发布快照：消费端总是拿到最新版本。
+    delete pending_.exchange(fresh, std::memory_order_acq_rel);
+  }
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/config.h"
+
+namespace ai_trade {
+
+/**
+ * @brief 配置热加载监视器（RCU 风格快照发布）
+ *
+ * 后台线程周期性读取配置源文件，内容变化时在热路径之外完成完整
+ * 解析 + 校验，成功后把新的不可变快照发布到单槽位原子指针；解析
+ * 失败只记错误日志，继续沿用当前配置。
+ *
+ * 消费端（主循环）在 tick 边界调用 `PollUpdated()` 以一次原子
+ * exchange 认领快照，读写双方都不加锁。单消费者模型：快照所有权
+ * 随 exchange 转移，被新版本替换的未消费快照由发布线程回收。
+ */
+class ConfigWatcher {
+ public:
+  ConfigWatcher() = default;
+  ~ConfigWatcher();
+
+  ConfigWatcher(const ConfigWatcher&) = delete;
+  ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+  /**
+   * @brief 启动监视线程
+   *
+   * 以当前文件内容为基线：只有之后发生的内容变化才会触发发布。
+   *
+   * @param config_path 配置源文件路径
+   * @param out_error   失败原因（文件不可读/重复启动）
+   */
+  bool Start(const std::string& config_path, std::string* out_error);
+
+  /// 停止监视线程（幂等；析构自动调用）。
+  void Stop();
+
+  /**
+   * @brief 认领自上次调用以来新发布的配置快照
+   *
+   * @return 新快照；无更新时返回 nullptr
+   */
+  std::unique_ptr<const AppConfig> PollUpdated();
+
+ private:
+  void Run();
+
+  std::string config_path_;
+  std::uint64_t last_seen_hash_{0};    ///< 仅监视线程访问。
+  std::uint64_t last_failed_hash_{0};  ///< 仅监视线程访问，避免重复报错。
+  std::atomic<const AppConfig*> pending_{nullptr};
+  std::atomic<bool> stop_requested_{false};
+  std::thread worker_;
+};
+
+}  // namespace ai_trade
@@ -1,6 +1,7 @@
 #include "core/json_utils.h"
 
 #include <cctype>
+#include <charconv>
 #include <exception>
 #include <sstream>
 
@@ -317,6 +318,180 @@ class JsonParser {
   std::size_t cursor_{0};
 };
 
+// ----------------------------------------------------------------------------
+// 零拷贝视图解析辅助：只做"跳过一个完整值"级别的结构扫描，不构建节点。
+// ----------------------------------------------------------------------------
+
+void SkipViewWhitespace(std::string_view text, std::size_t* pos) {
+  while (*pos < text.size() &&
+         std::isspace(static_cast<unsigned char>(text[*pos])) != 0) {
+    ++*pos;
+  }
+}
+
+// 跳过一个字符串（*pos 指向起始引号）；成功时 *pos 指向结束引号之后。
+bool SkipViewString(std::string_view text, std::size_t* pos) {
+  if (*pos >= text.size() || text[*pos] != '"') {
+    return false;
+  }
+  ++*pos;
+  while (*pos < text.size()) {
+    const char ch = text[(*pos)++];
+    if (ch == '"') {
+      return true;
+    }
+    if (ch == '\\') {
+      if (*pos >= text.size()) {
+        return false;
+      }
+      ++*pos;
+    }
+  }
+  return false;
+}
+
+// 跳过一个完整 JSON 值（对象/数组按深度配平，字符串按转义规则跳过）。
+bool SkipViewValue(std::string_view text, std::size_t* pos) {
+  if (*pos >= text.size()) {
+    return false;
+  }
+  const char ch = text[*pos];
+  if (ch == '"') {
+    return SkipViewString(text, pos);
+  }
+  if (ch == '{' || ch == '[') {
+    int depth = 0;
+    while (*pos < text.size()) {
+      const char current = text[*pos];
+      if (current == '"') {
+        if (!SkipViewString(text, pos)) {
+          return false;
+        }
+        continue;
+      }
+      if (current == '{' || current == '[') {
+        ++depth;
+      } else if (current == '}' || current == ']') {
+        --depth;
+        if (depth == 0) {
+          ++*pos;
+          return true;
+        }
+      }
+      ++*pos;
+    }
+    return false;
+  }
+  // 字面量 / 数字：扫描到分隔符为止，内容合法性推迟到取值时检查。
+  const std::size_t begin = *pos;
+  while (*pos < text.size()) {
+    const char current = text[*pos];
+    if (current == ',' || current == '}' || current == ']' ||
+        std::isspace(static_cast<unsigned char>(current)) != 0) {
+      break;
+    }
+    ++*pos;
+  }
+  return *pos > begin;
+}
+
+JsonType ViewTypeOf(char first_char) {
+  switch (first_char) {
+    case '{':
+      return JsonType::kObject;
+    case '[':
+      return JsonType::kArray;
+    case '"':
+      return JsonType::kString;
+    case 't':
+    case 'f':
+      return JsonType::kBool;
+    case 'n':
+      return JsonType::kNull;
+    default:
+      return JsonType::kNumber;
+  }
+}
+
+// 解码字符串视图正文（raw 含首尾引号）；转义规则与 DOM 解析器一致。
+bool DecodeViewString(std::string_view raw, std::string* out) {
+  if (out == nullptr || raw.size() < 2 || raw.front() != '"' ||
+      raw.back() != '"') {
+    return false;
+  }
+  const std::string_view body = raw.substr(1, raw.size() - 2);
+  out->clear();
+  out->reserve(body.size());
+  std::size_t pos = 0;
+  while (pos < body.size()) {
+    const char ch = body[pos++];
+    if (ch != '\\') {
+      out->push_back(ch);
+      continue;
+    }
+    if (pos >= body.size()) {
+      return false;
+    }
+    const char esc = body[pos++];
+    switch (esc) {
+      case '"':
+      case '\\':
+      case '/':
+        out->push_back(esc);
+        break;
+      case 'b':
+        out->push_back('\b');
+        break;
+      case 'f':
+        out->push_back('\f');
+        break;
+      case 'n':
+        out->push_back('\n');
+        break;
+      case 'r':
+        out->push_back('\r');
+        break;
+      case 't':
+        out->push_back('\t');
+        break;
+      case 'u': {
+        if (pos + 4 > body.size()) {
+          return false;
+        }
+        unsigned int codepoint = 0;
+        for (int i = 0; i < 4; ++i) {
+          const char hex = body[pos++];
+          codepoint <<= 4U;
+          if (hex >= '0' && hex <= '9') {
+            codepoint += static_cast<unsigned int>(hex - '0');
+          } else if (hex >= 'a' && hex <= 'f') {
+            codepoint += static_cast<unsigned int>(hex - 'a' + 10);
+          } else if (hex >= 'A' && hex <= 'F') {
+            codepoint += static_cast<unsigned int>(hex - 'A' + 10);
+          } else {
+            return false;
+          }
+        }
+        out->push_back(codepoint <= 0x7F ? static_cast<char>(codepoint) : '?');
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+std::optional<double> ViewNumberFromChars(std::string_view body) {
+  double value = 0.0;
+  const auto result =
+      std::from_chars(body.data(), body.data() + body.size(), value);
+  if (result.ec != std::errc{} || result.ptr != body.data() + body.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
 }  // namespace
 
 bool ParseJson(const std::string& text,
@@ -410,4 +585,197 @@ std::optional<bool> JsonAsBool(const JsonValue* value) {
   return std::nullopt;
 }
 
+bool ParseJsonView(std::string_view text,
+                   JsonView* out_view,
+                   std::string* out_error) {
+  if (out_view == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "out_view 为空";
+    }
+    return false;
+  }
+  std::size_t pos = 0;
+  SkipViewWhitespace(text, &pos);
+  const std::size_t begin = pos;
+  if (!SkipViewValue(text, &pos)) {
+    if (out_error != nullptr) {
+      *out_error = "JSON 视图解析失败，offset=" + std::to_string(pos);
+    }
+    return false;
+  }
+  out_view->type = ViewTypeOf(text[begin]);
+  out_view->raw = text.substr(begin, pos - begin);
+  SkipViewWhitespace(text, &pos);
+  if (pos != text.size()) {
+    if (out_error != nullptr) {
+      *out_error = "JSON 尾部存在多余字符，offset=" + std::to_string(pos);
+    }
+    return false;
+  }
+  return true;
+}
+
+bool JsonViewObjectField(const JsonView& object,
+                         std::string_view key,
+                         JsonView* out_field) {
+  if (out_field == nullptr || object.type != JsonType::kObject ||
+      object.raw.empty() || object.raw.front() != '{') {
+    return false;
+  }
+  const std::string_view raw = object.raw;
+  std::size_t pos = 1;
+  while (pos < raw.size()) {
+    SkipViewWhitespace(raw, &pos);
+    if (pos < raw.size() && raw[pos] == '}') {
+      return false;
+    }
+    const std::size_t key_begin = pos;
+    if (!SkipViewString(raw, &pos)) {
+      return false;
+    }
+    const std::string_view key_raw = raw.substr(key_begin, pos - key_begin);
+    SkipViewWhitespace(raw, &pos);
+    if (pos >= raw.size() || raw[pos] != ':') {
+      return false;
+    }
+    ++pos;
+    SkipViewWhitespace(raw, &pos);
+    const std::size_t value_begin = pos;
+    if (!SkipViewValue(raw, &pos)) {
+      return false;
+    }
+    if (JsonViewStringEquals(JsonView{JsonType::kString, key_raw}, key)) {
+      out_field->type = ViewTypeOf(raw[value_begin]);
+      out_field->raw = raw.substr(value_begin, pos - value_begin);
+      return true;
+    }
+    SkipViewWhitespace(raw, &pos);
+    if (pos >= raw.size() || raw[pos] == '}') {
+      return false;
+    }
+    if (raw[pos] != ',') {
+      return false;
+    }
+    ++pos;
+  }
+  return false;
+}
+
+bool JsonViewArrayNext(const JsonView& array,
+                       std::size_t* cursor,
+                       JsonView* out_item) {
+  if (cursor == nullptr || out_item == nullptr ||
+      array.type != JsonType::kArray || array.raw.empty() ||
+      array.raw.front() != '[') {
+    return false;
+  }
+  const std::string_view raw = array.raw;
+  std::size_t pos = *cursor;
+  if (pos == 0) {
+    pos = 1;
+  }
+  SkipViewWhitespace(raw, &pos);
+  if (pos >= raw.size() || raw[pos] == ']') {
+    return false;
+  }
+  if (raw[pos] == ',') {
+    ++pos;
+    SkipViewWhitespace(raw, &pos);
+  }
+  if (pos >= raw.size() || raw[pos] == ']') {
+    return false;
+  }
+  const std::size_t item_begin = pos;
+  if (!SkipViewValue(raw, &pos)) {
+    return false;
+  }
+  out_item->type = ViewTypeOf(raw[item_begin]);
+  out_item->raw = raw.substr(item_begin, pos - item_begin);
+  *cursor = pos;
+  return true;
+}
+
+std::optional<double> JsonViewAsNumber(const JsonView& view) {
+  if (view.type == JsonType::kNumber) {
+    return ViewNumberFromChars(view.raw);
+  }
+  if (view.type == JsonType::kString && view.raw.size() >= 2) {
+    // 交易所数值字段常以字符串下发；无转义快路径直接原地转换。
+    const std::string_view body = view.raw.substr(1, view.raw.size() - 2);
+    if (body.find('\\') == std::string_view::npos) {
+      return ViewNumberFromChars(body);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::int64_t> JsonViewAsInt64(const JsonView& view) {
+  std::string_view body;
+  if (view.type == JsonType::kNumber) {
+    body = view.raw;
+  } else if (view.type == JsonType::kString && view.raw.size() >= 2) {
+    body = view.raw.substr(1, view.raw.size() - 2);
+  } else {
+    return std::nullopt;
+  }
+  std::int64_t value = 0;
+  const auto result =
+      std::from_chars(body.data(), body.data() + body.size(), value);
+  if (result.ec == std::errc{} && result.ptr == body.data() + body.size()) {
+    return value;
+  }
+  // 带小数/指数的数值退化为 double 再截断，与 DOM 路径口径一致。
+  if (const auto number = JsonViewAsNumber(view); number.has_value()) {
+    return static_cast<std::int64_t>(*number);
+  }
+  return std::nullopt;
+}
+
+std::optional<bool> JsonViewAsBool(const JsonView& view) {
+  if (view.type == JsonType::kBool) {
+    return view.raw == "true";
+  }
+  if (view.type == JsonType::kString) {
+    if (view.raw == "\"true\"") {
+      return true;
+    }
+    if (view.raw == "\"false\"") {
+      return false;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> JsonViewAsString(const JsonView& view) {
+  if (view.type == JsonType::kString) {
+    std::string decoded;
+    if (DecodeViewString(view.raw, &decoded)) {
+      return decoded;
+    }
+    return std::nullopt;
+  }
+  if (view.type == JsonType::kNumber) {
+    if (const auto number = JsonViewAsNumber(view); number.has_value()) {
+      return std::to_string(*number);
+    }
+    return std::nullopt;
+  }
+  if (view.type == JsonType::kBool) {
+    return std::string(view.raw == "true" ? "true" : "false");
+  }
+  return std::nullopt;
+}
+
+bool JsonViewStringEquals(const JsonView& view, std::string_view expected) {
+  if (view.type != JsonType::kString || view.raw.size() < 2) {
+    return false;
+  }
+  const std::string_view body = view.raw.substr(1, view.raw.size() - 2);
+  if (body.find('\\') == std::string_view::npos) {
+    return body == expected;
+  }
+  std::string decoded;
+  return DecodeViewString(view.raw, &decoded) && decoded == expected;
+}
+
 }  // namespace ai_trade
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -69,4 +71,55 @@ std::optional<double> JsonAsNumber(const JsonValue* value);
 /// 尝试将节点解释为布尔值；失败返回 `std::nullopt`。
 std::optional<bool> JsonAsBool(const JsonValue* value);
 
+// ============================================================================
+// 零拷贝视图解析（热路径）
+// ============================================================================
+//
+// DOM 版 `ParseJson` 为每个对象节点分配 unordered_map，在行情/成交 WS
+// 消息速率下是 feed 路径最大的分配来源。以下视图 API 不构建任何节点：
+// `JsonView::raw` 只是原文的一个切片，字段查找按需线性扫描对象原文并跳过
+// 嵌套值，字符串仅在真正需要解码时才分配。适用于"大消息取少数字段"的
+// 流式解析场景；需要完整遍历结构时仍应使用 DOM 版。
+
+/// JSON 值的零拷贝视图；`raw` 为该值在原文中的完整切片（含引号/括号）。
+struct JsonView {
+  JsonType type{JsonType::kNull};
+  std::string_view raw;
+};
+
+/**
+ * @brief 解析顶层 JSON 值为视图（不构建 DOM）
+ *
+ * 仅做轻量结构校验（括号/引号配平与尾部多余字符）；字段内容的合法性
+ * 推迟到按需取值时检查。`text` 的生命周期必须覆盖视图的使用期。
+ */
+bool ParseJsonView(std::string_view text,
+                   JsonView* out_view,
+                   std::string* out_error);
+
+/// 在对象视图中查找字段；不存在或类型不符返回 false。
+bool JsonViewObjectField(const JsonView& object,
+                         std::string_view key,
+                         JsonView* out_field);
+
+/**
+ * @brief 数组遍历游标
+ *
+ * `*cursor` 初始化为 0，每次调用产出下一个元素；遍历结束返回 false。
+ */
+bool JsonViewArrayNext(const JsonView& array,
+                       std::size_t* cursor,
+                       JsonView* out_item);
+
+/// 尝试将视图解释为数值（数字或数字字符串）；失败返回 `std::nullopt`。
+std::optional<double> JsonViewAsNumber(const JsonView& view);
+/// 尝试将视图解释为 64 位整数；失败返回 `std::nullopt`。
+std::optional<std::int64_t> JsonViewAsInt64(const JsonView& view);
+/// 尝试将视图解释为布尔值（布尔/数字/"true"/"false"）；失败返回 `std::nullopt`。
+std::optional<bool> JsonViewAsBool(const JsonView& view);
+/// 字符串视图解码（仅在包含转义时分配）；非字符串返回 `std::nullopt`。
+std::optional<std::string> JsonViewAsString(const JsonView& view);
+/// 字符串视图与字面量比较；无转义时零拷贝逐字节比较。
+bool JsonViewStringEquals(const JsonView& view, std::string_view expected);
+
 }  // namespace ai_trade
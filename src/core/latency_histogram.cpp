@@ -0,0 +1,91 @@
+#include "core/latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "core/line_writer.h"
+
+namespace ai_trade {
+
+std::size_t LatencyHistogram::BucketIndex(std::int64_t nanos) {
+  if (nanos < 512) {
+    return 0;
+  }
+  const auto width =
+      static_cast<std::size_t>(std::bit_width(
+          static_cast<std::uint64_t>(nanos) >> 9));
+  return std::min(width, kBucketCount - 1);
+}
+
+std::int64_t LatencyHistogram::BucketUpperBoundNanos(std::size_t index) {
+  return static_cast<std::int64_t>(512) << index;
+}
+
+void LatencyHistogram::Record(std::int64_t nanos) {
+  if (nanos < 0) {
+    nanos = 0;
+  }
+  ++buckets_[BucketIndex(nanos)];
+  ++count_;
+  total_nanos_ += nanos;
+  max_nanos_ = std::max(max_nanos_, nanos);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_nanos_ += other.total_nanos_;
+  max_nanos_ = std::max(max_nanos_, other.max_nanos_);
+}
+
+void LatencyHistogram::Reset() {
+  buckets_.fill(0);
+  count_ = 0;
+  total_nanos_ = 0;
+  max_nanos_ = 0;
+}
+
+std::int64_t LatencyHistogram::ApproxPercentileNanos(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percentile = std::clamp(percentile, 0.0, 1.0);
+  const auto target = static_cast<std::uint64_t>(
+      percentile * static_cast<double>(count_) + 0.5);
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    cumulative += buckets_[i];
+    if (cumulative >= target) {
+      // 末桶无上界，回退到实测最大值。
+      if (i == kBucketCount - 1) {
+        return max_nanos_;
+      }
+      return std::min(BucketUpperBoundNanos(i), max_nanos_);
+    }
+  }
+  return max_nanos_;
+}
+
+void LatencyHistogram::AppendSummary(LineWriter* out) const {
+  const double avg_us =
+      count_ > 0
+          ? static_cast<double>(total_nanos_) /
+                (1000.0 * static_cast<double>(count_))
+          : 0.0;
+  out->Append("n=")
+      .AppendInt(static_cast<std::int64_t>(count_))
+      .Append(", avg_us=")
+      .AppendDoubleFixed(avg_us, 1)
+      .Append(", p50_us=")
+      .AppendDoubleFixed(
+          static_cast<double>(ApproxPercentileNanos(0.50)) / 1000.0, 1)
+      .Append(", p99_us=")
+      .AppendDoubleFixed(
+          static_cast<double>(ApproxPercentileNanos(0.99)) / 1000.0, 1)
+      .Append(", max_us=")
+      .AppendDoubleFixed(static_cast<double>(max_nanos_) / 1000.0, 1);
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_trade {
+
+class LineWriter;
+
+/**
+ * @brief 固定桶位的对数延迟直方图
+ *
+ * 桶宽按 2 的幂递增：桶 0 覆盖 < 512ns，桶 i 覆盖
+ * [512ns << (i-1), 512ns << i)，末桶收纳更大的离群值（约 >134ms）。
+ * `Record` 只做一次位运算定桶加若干计数累加，适合放在逐 tick 热路径；
+ * 无锁、非线程安全，按使用线程各持实例或仅在单线程流水线内使用。
+ */
+class LatencyHistogram {
+ public:
+  static constexpr std::size_t kBucketCount = 20;
+
+  /// 记录一个耗时样本（纳秒，负值按 0 处理）。
+  void Record(std::int64_t nanos);
+
+  /// 合并另一直方图（用于跨 symbol 聚合汇总）。
+  void Merge(const LatencyHistogram& other);
+
+  void Reset();
+
+  std::uint64_t count() const { return count_; }
+  std::int64_t total_nanos() const { return total_nanos_; }
+  std::int64_t max_nanos() const { return max_nanos_; }
+
+  /**
+   * @brief 近似分位数（返回所在桶的上界纳秒值）
+   *
+   * @param percentile (0, 1] 区间，如 0.5 / 0.99
+   * @return 近似分位纳秒；无样本返回 0；落在末桶返回实测最大值
+   */
+  std::int64_t ApproxPercentileNanos(double percentile) const;
+
+  /// 以 `n=..., avg_us=..., p50_us=..., p99_us=..., max_us=...` 追加摘要。
+  void AppendSummary(LineWriter* out) const;
+
+  const std::array<std::uint64_t, kBucketCount>& buckets() const {
+    return buckets_;
+  }
+
+ private:
+  static std::size_t BucketIndex(std::int64_t nanos);
+  static std::int64_t BucketUpperBoundNanos(std::size_t index);
+
+  std::array<std::uint64_t, kBucketCount> buckets_{};
+  std::uint64_t count_{0};
+  std::int64_t total_nanos_{0};
+  std::int64_t max_nanos_{0};
+};
+
+}  // namespace ai_trade
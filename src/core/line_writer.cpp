@@ -0,0 +1,87 @@
+#include "core/line_writer.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace ai_trade {
+
+LineWriter& LineWriter::AppendInt(std::int64_t value) {
+  char scratch[24];
+  const auto result = std::to_chars(scratch, scratch + sizeof(scratch), value);
+  buffer_.append(scratch, result.ptr);
+  return *this;
+}
+
+LineWriter& LineWriter::AppendDouble(double value) {
+  if (!std::isfinite(value)) {
+    if (std::isnan(value)) {
+      buffer_.append("nan");
+    } else {
+      buffer_.append(value > 0.0 ? "inf" : "-inf");
+    }
+    return *this;
+  }
+  char scratch[32];
+  const auto result = std::to_chars(scratch, scratch + sizeof(scratch), value);
+  buffer_.append(scratch, result.ptr);
+  return *this;
+}
+
+LineWriter& LineWriter::AppendDoubleFixed(double value, int precision) {
+  if (!std::isfinite(value)) {
+    return AppendDouble(value);
+  }
+  char scratch[64];
+  const auto result = std::to_chars(scratch,
+                                    scratch + sizeof(scratch),
+                                    value,
+                                    std::chars_format::fixed,
+                                    precision);
+  if (result.ec != std::errc{}) {
+    // 数值过大导致定点表示超出 scratch 时回退最短表示。
+    return AppendDouble(value);
+  }
+  buffer_.append(scratch, result.ptr);
+  return *this;
+}
+
+LineWriter& LineWriter::AppendJsonEscaped(std::string_view text) {
+  for (const char ch : text) {
+    switch (ch) {
+      case '"':
+        buffer_.append("\\\"");
+        break;
+      case '\\':
+        buffer_.append("\\\\");
+        break;
+      case '\b':
+        buffer_.append("\\b");
+        break;
+      case '\f':
+        buffer_.append("\\f");
+        break;
+      case '\n':
+        buffer_.append("\\n");
+        break;
+      case '\r':
+        buffer_.append("\\r");
+        break;
+      case '\t':
+        buffer_.append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          constexpr char kHex[] = "0123456789abcdef";
+          buffer_.append("\\u00");
+          buffer_.push_back(kHex[(static_cast<unsigned char>(ch) >> 4U) & 0xF]);
+          buffer_.push_back(kHex[static_cast<unsigned char>(ch) & 0xF]);
+        } else {
+          buffer_.push_back(ch);
+        }
+        break;
+    }
+  }
+  return *this;
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ai_trade {
+
+/**
+ * @brief 追加式文本/JSON 行构造器（热路径序列化）
+ *
+ * `std::ostringstream` 的 double 格式化慢且受 locale 影响，主循环里
+ * 决策/漏斗/摘要日志与 WAL 行的拼接曾与交易逻辑抢占时间。本类在预分配
+ * 的连续缓冲上追加，数值统一走 `std::to_chars`：
+ * - 浮点默认输出最短可往返表示（WAL 回放不丢精度）；
+ * - 亦支持定点位数输出，用于展示型摘要；
+ * - 提供 JSON 字符串转义，供结构化日志字段使用。
+ */
+class LineWriter {
+ public:
+  explicit LineWriter(std::size_t reserve_bytes = 256) {
+    buffer_.reserve(reserve_bytes);
+  }
+
+  /// 追加原始文本（不做任何转义）。
+  LineWriter& Append(std::string_view text) {
+    buffer_.append(text);
+    return *this;
+  }
+
+  LineWriter& Append(char ch) {
+    buffer_.push_back(ch);
+    return *this;
+  }
+
+  /// 追加十进制整数（to_chars，无 locale）。
+  LineWriter& AppendInt(std::int64_t value);
+
+  /// 追加浮点数，最短可往返表示；非有限值输出 "nan"/"inf"/"-inf"。
+  LineWriter& AppendDouble(double value);
+
+  /// 追加定点小数（固定 `precision` 位），用于展示型摘要。
+  LineWriter& AppendDoubleFixed(double value, int precision);
+
+  /// 追加 "true"/"false"。
+  LineWriter& AppendBool(bool value) {
+    buffer_.append(value ? "true" : "false");
+    return *this;
+  }
+
+  /// 追加 JSON 字符串转义后的文本（不含首尾引号）。
+  LineWriter& AppendJsonEscaped(std::string_view text);
+
+  std::string_view view() const { return buffer_; }
+  const std::string& str() const { return buffer_; }
+  /// 移出内部缓冲（调用后 writer 复位为空）。
+  std::string TakeString() { return std::move(buffer_); }
+
+  void Clear() { buffer_.clear(); }
+  bool empty() const { return buffer_.empty(); }
+
+ private:
+  std::string buffer_;
+};
+
+}  // namespace ai_trade
@@ -1,41 +1,215 @@
 #include "core/log.h"
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
-#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "core/clock.h"
+#include "core/thread_topology.h"
 
 namespace ai_trade {
 
-static std::mutex g_log_mutex;
+namespace {
 
-void LogInfo(std::string_view message) {
-  // 用全局互斥保证多线程日志不会交叉写入。
-  std::lock_guard<std::mutex> lock(g_log_mutex);
-  const auto now = std::chrono::system_clock::now();
-  const std::time_t t = std::chrono::system_clock::to_time_t(now);
+// 环形队列容量（2 的幂）。满时丢行计数，绝不阻塞主循环：
+// 成交爆发期终端/管道背压曾导致同步日志在锁上卡住整个 tick。
+constexpr std::size_t kLogRingCapacity = 8192;
+constexpr std::size_t kLogRingMask = kLogRingCapacity - 1;
+static_assert((kLogRingCapacity & kLogRingMask) == 0,
+              "kLogRingCapacity 必须是 2 的幂");
+
+struct LogRecord {
+  std::chrono::system_clock::time_point ts;
+  std::string message;
+  bool is_error{false};
+};
+
+// Vyukov 风格有界队列槽位：sequence 标记槽位归属轮次。
+struct LogCell {
+  std::atomic<std::size_t> sequence{0};
+  LogRecord record;
+};
+
+// 日志前缀精确到秒，缓存时钟的毫秒粒度绰绰有余，省去每行一次系统调用。
+std::chrono::system_clock::time_point CachedWallClockTime() {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::milliseconds(NowMsCached())));
+}
+
+void WriteRecordToSink(const LogRecord& record) {
+  const std::time_t t = std::chrono::system_clock::to_time_t(record.ts);
   std::tm tm{};
 #if defined(_WIN32)
   localtime_s(&tm, &t);
 #else
   localtime_r(&t, &tm);
 #endif
-  std::cout << std::put_time(&tm, "%F %T") << " [INFO] " << message << '\n';
+  std::ostream& sink = record.is_error ? std::cerr : std::cout;
+  sink << std::put_time(&tm, "%F %T")
+       << (record.is_error ? " [ERROR] " : " [INFO] ") << record.message
+       << '\n';
+}
+
+class AsyncLogger {
+ public:
+  AsyncLogger() {
+    for (std::size_t i = 0; i < kLogRingCapacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker_ = std::thread([this]() { Run(); });
+  }
+
+  ~AsyncLogger() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+    stopped_.store(true, std::memory_order_release);
+    std::cout.flush();
+    std::cerr.flush();
+  }
+
+  void Log(bool is_error, std::string_view message) {
+    if (stopped_.load(std::memory_order_acquire)) {
+      // 退出阶段后台线程已收尾，退化为同步直写，避免丢失关键尾部日志。
+      LogRecord record;
+      record.ts = CachedWallClockTime();
+      record.message.assign(message);
+      record.is_error = is_error;
+      WriteRecordToSink(record);
+      return;
+    }
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      LogCell& cell = cells_[pos & kLogRingMask];
+      const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) -
+                        static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos,
+                                               pos + 1,
+                                               std::memory_order_relaxed)) {
+          cell.record.ts = CachedWallClockTime();
+          cell.record.message.assign(message);
+          cell.record.is_error = is_error;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return;
+        }
+      } else if (diff < 0) {
+        // 队列已满：按有界丢弃策略丢弃本行，只累加计数。
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Flush() {
+    const std::size_t target = enqueue_pos_.load(std::memory_order_acquire);
+    while (!stopped_.load(std::memory_order_acquire) &&
+           consumed_pos_.load(std::memory_order_acquire) < target) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::cout.flush();
+    std::cerr.flush();
+  }
+
+  std::uint64_t dropped_lines() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Run() {
+    ApplyThreadRole(ThreadRole::kLogger);
+    LogRecord record;
+    for (;;) {
+      if (Dequeue(&record)) {
+        WriteRecordToSink(record);
+        continue;
+      }
+      ReportDropsIfAny();
+      if (stop_requested_.load(std::memory_order_acquire)) {
+        // 收到停止请求后再确认一次队列已空，避免丢尾部。
+        if (!Dequeue(&record)) {
+          return;
+        }
+        WriteRecordToSink(record);
+        continue;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  bool Dequeue(LogRecord* out_record) {
+    LogCell& cell = cells_[dequeue_pos_ & kLogRingMask];
+    const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::intptr_t>(seq) -
+                      static_cast<std::intptr_t>(dequeue_pos_ + 1);
+    if (diff != 0) {
+      return false;
+    }
+    *out_record = std::move(cell.record);
+    cell.record.message.clear();
+    cell.sequence.store(dequeue_pos_ + kLogRingCapacity,
+                        std::memory_order_release);
+    ++dequeue_pos_;
+    consumed_pos_.store(dequeue_pos_, std::memory_order_release);
+    return true;
+  }
+
+  // 空闲时把新增的丢行数作为一条 ERROR 汇报，便于运维感知损失规模。
+  void ReportDropsIfAny() {
+    const std::uint64_t total = dropped_.load(std::memory_order_relaxed);
+    if (total > reported_dropped_) {
+      LogRecord record;
+      record.ts = CachedWallClockTime();
+      record.message = "LOG_RING_DROPPED: lines=" +
+                       std::to_string(total - reported_dropped_) +
+                       ", total=" + std::to_string(total);
+      record.is_error = true;
+      WriteRecordToSink(record);
+      reported_dropped_ = total;
+    }
+  }
+
+  LogCell cells_[kLogRingCapacity];
+  std::atomic<std::size_t> enqueue_pos_{0};
+  std::atomic<std::size_t> consumed_pos_{0};
+  std::size_t dequeue_pos_{0};  ///< 仅消费线程访问。
+  std::atomic<std::uint64_t> dropped_{0};
+  std::uint64_t reported_dropped_{0};  ///< 仅消费线程访问。
+  std::atomic<bool> stop_requested_{false};
+  std::atomic<bool> stopped_{false};
+  std::thread worker_;
+};
+
+AsyncLogger& Logger() {
+  static AsyncLogger logger;
+  return logger;
+}
+
+}  // namespace
+
+void LogInfo(std::string_view message) {
+  Logger().Log(false, message);
 }
 
 void LogError(std::string_view message) {
-  // 错误日志和信息日志共享同一把锁，保证时序可读。
-  std::lock_guard<std::mutex> lock(g_log_mutex);
-  const auto now = std::chrono::system_clock::now();
-  const std::time_t t = std::chrono::system_clock::to_time_t(now);
-  std::tm tm{};
-#if defined(_WIN32)
-  localtime_s(&tm, &t);
-#else
-  localtime_r(&t, &tm);
-#endif
-  std::cerr << std::put_time(&tm, "%F %T") << " [ERROR] " << message << '\n';
+  Logger().Log(true, message);
+}
+
+void LogFlush() {
+  Logger().Flush();
+}
+
+std::uint64_t LogDroppedLines() {
+  return Logger().dropped_lines();
 }
 
 }  // namespace ai_trade
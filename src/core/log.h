@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -9,20 +10,28 @@ namespace ai_trade {
  * @brief 输出 INFO 级日志
  *
  * 行为：
- * 1. 线程安全串行写入；
+ * 1. 异步写入：调用方仅把消息投入无锁环形队列，由后台线程统一落盘；
  * 2. 输出到 `stdout`；
- * 3. 自动附加本地时间戳和 `[INFO]` 前缀。
+ * 3. 自动附加本地时间戳和 `[INFO]` 前缀（时间取入队时刻，格式化在后台线程完成）；
+ * 4. 队列满时按有界丢弃策略丢行并计数，绝不阻塞调用方。
  */
 void LogInfo(std::string_view message);
 
 /**
  * @brief 输出 ERROR 级日志
  *
- * 行为：
- * 1. 线程安全串行写入；
- * 2. 输出到 `stderr`；
- * 3. 自动附加本地时间戳和 `[ERROR]` 前缀。
+ * 行为与 `LogInfo` 相同，但输出到 `stderr` 并使用 `[ERROR]` 前缀。
  */
 void LogError(std::string_view message);
 
+/**
+ * @brief 等待已入队日志全部落盘并刷新底层流
+ *
+ * 进程退出前调用，避免后台线程尚未消费的尾部日志丢失。
+ */
+void LogFlush();
+
+/// 因环形队列满而被丢弃的日志行累计数（进程生命周期内单调递增）。
+std::uint64_t LogDroppedLines();
+
 }  // namespace ai_trade
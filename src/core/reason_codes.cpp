@@ -0,0 +1,77 @@
+#include "core/reason_codes.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 与 ReasonCode 枚举逐项同序；新增 code 时两处同步修改。
+constexpr const char* kReasonNames[] = {
+    "STR_WARMUP",
+    "STR_FEATURE_NOT_READY",
+    "STR_TREND_EVAL",
+    "STR_TREND_EMA_UP",
+    "STR_TREND_EMA_DOWN",
+    "STR_TREND_EMA_FLAT",
+    "STR_TREND_EMA_INVALID",
+    "STR_BREAKOUT_NOT_READY",
+    "STR_BREAKOUT_BLOCK",
+    "STR_BREAKOUT_PASS",
+    "STR_SLOPE_NOT_READY",
+    "STR_SLOPE_BLOCK",
+    "STR_SLOPE_PASS",
+    "STR_VOL_CAP_BLOCK",
+    "STR_DEADBAND_HOLD",
+    "STR_MIN_HOLD_HOLD",
+    "STR_DEFENSIVE_RANK_TRIGGER",
+    "STR_DEFENSIVE_RANK_WEAK",
+    "STR_DEFENSIVE_RANK_NOT_READY",
+    "STR_DEFENSIVE_LEGACY_TRIGGER",
+    "STR_DEFENSIVE_LEGACY_WEAK",
+    "STR_DEFENSIVE_DEADBAND_HOLD",
+    "STR_DEFENSIVE_MIN_HOLD_HOLD",
+    "STR_DEFENSIVE_ETH_RANGE_SCALED",
+    "STR_TREND_BUCKET_SCALED",
+    "STR_TREND_CANDIDATE_PROBE",
+    "STR_RANGE_CONFIDENCE_BLOCK",
+    "STR_EXTREME_BLOCK",
+    "STR_ACTIVE_SIGNAL",
+    "STR_FLAT_SIGNAL",
+    "STR_SIGNAL_EXPIRED",
+    "STR_NO_REASON",
+    "REG_WARMUP",
+    "REG_UPTREND",
+    "REG_DOWNTREND",
+    "REG_RANGE",
+    "REG_EXTREME",
+    "REG_TREND_CANDIDATE",
+    "PORT_EVOLUTION_BLEND",
+    "EXEC_MAKER_PROBE",
+    "EXEC_STRONG_TREND_PROBE",
+};
+
+static_assert(sizeof(kReasonNames) / sizeof(kReasonNames[0]) ==
+                  static_cast<std::size_t>(ReasonCode::kCount),
+              "kReasonNames 与 ReasonCode 枚举不同步");
+
+}  // namespace
+
+const char* ReasonCodeName(ReasonCode code) {
+  const auto index = static_cast<std::size_t>(code);
+  if (index >= static_cast<std::size_t>(ReasonCode::kCount)) {
+    return "";
+  }
+  return kReasonNames[index];
+}
+
+std::vector<std::string> ExpandReasonMask(ReasonMask mask) {
+  std::vector<std::string> out;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(ReasonCode::kCount);
+       ++i) {
+    if ((mask & (1ULL << i)) != 0ULL) {
+      out.emplace_back(kReasonNames[i]);
+    }
+  }
+  return out;
+}
+
+}  // namespace ai_trade
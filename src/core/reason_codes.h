@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ai_trade {
+
+// 信号 reason code 位掩码
+// 策略链路每次评估都会附带多条 reason 供审计；旧实现是
+// vector<string>，每 tick 每 symbol 数次堆分配，而绝大多数决策根本
+// 不会被落盘。现改为枚举位号 + uint64 掩码：热路径置位是一次或运算，
+// 字符串仅在决策真正进日志时经 ExpandReasonMask 懒展开，
+// 展开结果与旧 JSON 字段逐字一致。
+enum class ReasonCode : std::uint8_t {
+  // 策略主链
+  kStrWarmup = 0,
+  kStrFeatureNotReady,
+  kStrTrendEval,
+  kStrTrendEmaUp,
+  kStrTrendEmaDown,
+  kStrTrendEmaFlat,
+  kStrTrendEmaInvalid,
+  kStrBreakoutNotReady,
+  kStrBreakoutBlock,
+  kStrBreakoutPass,
+  kStrSlopeNotReady,
+  kStrSlopeBlock,
+  kStrSlopePass,
+  kStrVolCapBlock,
+  kStrDeadbandHold,
+  kStrMinHoldHold,
+  kStrDefensiveRankTrigger,
+  kStrDefensiveRankWeak,
+  kStrDefensiveRankNotReady,
+  kStrDefensiveLegacyTrigger,
+  kStrDefensiveLegacyWeak,
+  kStrDefensiveDeadbandHold,
+  kStrDefensiveMinHoldHold,
+  kStrDefensiveEthRangeScaled,
+  kStrTrendBucketScaled,
+  kStrTrendCandidateProbe,
+  kStrRangeConfidenceBlock,
+  kStrExtremeBlock,
+  kStrActiveSignal,
+  kStrFlatSignal,
+  kStrSignalExpired,
+  kStrNoReason,
+  // Regime 标注
+  kRegWarmup,
+  kRegUptrend,
+  kRegDowntrend,
+  kRegRange,
+  kRegExtreme,
+  kRegTrendCandidate,
+  // 组合/执行
+  kPortEvolutionBlend,
+  kExecMakerProbe,
+  kExecStrongTrendProbe,
+  kCount,
+};
+
+/// 位掩码容器：一个 uint64 足以覆盖全部固定 reason code。
+using ReasonMask = std::uint64_t;
+
+constexpr ReasonMask ReasonBit(ReasonCode code) {
+  return 1ULL << static_cast<unsigned>(code);
+}
+
+inline void SetReason(ReasonMask* mask, ReasonCode code) {
+  *mask |= ReasonBit(code);
+}
+
+inline bool HasReason(ReasonMask mask, ReasonCode code) {
+  return (mask & ReasonBit(code)) != 0ULL;
+}
+
+/// code → 审计字符串（与旧 reason_codes JSON 取值逐字一致）。
+const char* ReasonCodeName(ReasonCode code);
+
+/// 掩码 → 字符串数组（按位号升序）。仅在日志/审计落盘路径调用，
+/// 热路径不应触达。
+std::vector<std::string> ExpandReasonMask(ReasonMask mask);
+
+}  // namespace ai_trade
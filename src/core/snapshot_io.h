@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief 二进制快照字段读写器
+ *
+ * 配置缓存与 TradeSystem 状态快照共用的序列化原语：字段按声明顺序
+ * 写入/消费，读写两端共用同一份 `ArchiveFields` 清单杜绝不一致。
+ * 快照只在本机生成本机消费，数值按宿主字节序原样存取。
+ */
+
+/// 写端：把字段按声明顺序追加到内存缓冲，一次性落盘。
+class SnapshotWriter {
+ public:
+  void Field(bool value) {
+    const std::uint8_t byte = value ? 1 : 0;
+    AppendRaw(&byte, sizeof(byte));
+  }
+
+  void Field(int value) {
+    const std::int32_t v = value;
+    AppendRaw(&v, sizeof(v));
+  }
+
+  void Field(std::int64_t value) { AppendRaw(&value, sizeof(value)); }
+
+  void Field(std::uint64_t value) { AppendRaw(&value, sizeof(value)); }
+
+  void Field(double value) { AppendRaw(&value, sizeof(value)); }
+
+  void Field(const std::string& value) {
+    const std::uint32_t size = static_cast<std::uint32_t>(value.size());
+    AppendRaw(&size, sizeof(size));
+    buffer_.append(value);
+  }
+
+  void Field(const std::vector<std::string>& values) {
+    const std::uint32_t count = static_cast<std::uint32_t>(values.size());
+    AppendRaw(&count, sizeof(count));
+    for (const auto& value : values) {
+      Field(value);
+    }
+  }
+
+  void Field(const std::vector<double>& values) {
+    const std::uint32_t count = static_cast<std::uint32_t>(values.size());
+    AppendRaw(&count, sizeof(count));
+    if (count > 0) {
+      AppendRaw(values.data(), count * sizeof(double));
+    }
+  }
+
+  void Field(const std::deque<double>& values) {
+    const std::uint32_t count = static_cast<std::uint32_t>(values.size());
+    AppendRaw(&count, sizeof(count));
+    for (const double value : values) {
+      Field(value);
+    }
+  }
+
+  void Field(const std::unordered_set<std::string>& values) {
+    const std::uint32_t count = static_cast<std::uint32_t>(values.size());
+    AppendRaw(&count, sizeof(count));
+    for (const auto& value : values) {
+      Field(value);
+    }
+  }
+
+  template <typename E,
+            typename std::enable_if_t<std::is_enum_v<E>, int> = 0>
+  void Field(E value) {
+    Field(static_cast<int>(value));
+  }
+
+  const std::string& buffer() const { return buffer_; }
+
+ private:
+  void AppendRaw(const void* data, std::size_t size) {
+    buffer_.append(static_cast<const char*>(data), size);
+  }
+
+  std::string buffer_;
+};
+
+/// 读端：按相同顺序消费缓冲，任何越界立即置失败，之后所有读取短路。
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::string_view payload) : payload_(payload) {}
+
+  void Field(bool& value) {
+    std::uint8_t byte = 0;
+    if (ReadRaw(&byte, sizeof(byte))) {
+      value = byte != 0;
+    }
+  }
+
+  void Field(int& value) {
+    std::int32_t v = 0;
+    if (ReadRaw(&v, sizeof(v))) {
+      value = v;
+    }
+  }
+
+  void Field(std::int64_t& value) { ReadRaw(&value, sizeof(value)); }
+
+  void Field(std::uint64_t& value) { ReadRaw(&value, sizeof(value)); }
+
+  void Field(double& value) { ReadRaw(&value, sizeof(value)); }
+
+  void Field(std::string& value) {
+    std::uint32_t size = 0;
+    if (!ReadRaw(&size, sizeof(size))) {
+      return;
+    }
+    if (payload_.size() - cursor_ < size) {
+      ok_ = false;
+      return;
+    }
+    value.assign(payload_.data() + cursor_, size);
+    cursor_ += size;
+  }
+
+  void Field(std::vector<std::string>& values) {
+    std::uint32_t count = 0;
+    if (!ReadRaw(&count, sizeof(count))) {
+      return;
+    }
+    values.clear();
+    for (std::uint32_t i = 0; ok_ && i < count; ++i) {
+      std::string value;
+      Field(value);
+      values.push_back(std::move(value));
+    }
+  }
+
+  void Field(std::vector<double>& values) {
+    std::uint32_t count = 0;
+    if (!ReadRaw(&count, sizeof(count))) {
+      return;
+    }
+    if (payload_.size() - cursor_ < count * sizeof(double)) {
+      ok_ = false;
+      return;
+    }
+    values.resize(count);
+    if (count > 0) {
+      std::memcpy(values.data(), payload_.data() + cursor_,
+                  count * sizeof(double));
+      cursor_ += count * sizeof(double);
+    }
+  }
+
+  void Field(std::deque<double>& values) {
+    std::uint32_t count = 0;
+    if (!ReadRaw(&count, sizeof(count))) {
+      return;
+    }
+    values.clear();
+    for (std::uint32_t i = 0; ok_ && i < count; ++i) {
+      double value = 0.0;
+      Field(value);
+      values.push_back(value);
+    }
+  }
+
+  void Field(std::unordered_set<std::string>& values) {
+    std::uint32_t count = 0;
+    if (!ReadRaw(&count, sizeof(count))) {
+      return;
+    }
+    values.clear();
+    for (std::uint32_t i = 0; ok_ && i < count; ++i) {
+      std::string value;
+      Field(value);
+      values.insert(std::move(value));
+    }
+  }
+
+  template <typename E,
+            typename std::enable_if_t<std::is_enum_v<E>, int> = 0>
+  void Field(E& value) {
+    int raw = 0;
+    Field(raw);
+    value = static_cast<E>(raw);
+  }
+
+  bool ok() const { return ok_; }
+  bool fully_consumed() const { return ok_ && cursor_ == payload_.size(); }
+
+ private:
+  bool ReadRaw(void* out, std::size_t size) {
+    if (!ok_ || payload_.size() - cursor_ < size) {
+      ok_ = false;
+      return false;
+    }
+    std::memcpy(out, payload_.data() + cursor_, size);
+    cursor_ += size;
+    return true;
+  }
+
+  std::string_view payload_;
+  std::size_t cursor_{0};
+  bool ok_{true};
+};
+
+}  // namespace ai_trade
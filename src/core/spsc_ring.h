@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief 有界无锁 SPSC 环形队列
+ *
+ * 单生产者 + 单消费者专用：生产者只写 head_，消费者只写 tail_，
+ * 双方通过 acquire/release 读对端游标同步，不存在 CAS 重试或锁。
+ * head_/tail_ 各自独占缓存行，避免两个线程互相打扰（false sharing）。
+ *
+ * 容量向上取整到 2 的幂，游标按自然溢出回绕、用掩码取槽位。
+ * 队满时 `TryPush` 返回 false，由调用方决定退避策略——环不会
+ * 覆盖未消费的元素。
+ */
+template <typename T>
+class SpscRing {
+ public:
+  /// @param capacity 期望容量（向上取整到 2 的幂，最小为 2）。
+  explicit SpscRing(std::size_t capacity)
+      : buffer_(RoundUpPow2(capacity)), mask_(buffer_.size() - 1) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  /// 生产者调用：移动入队；队满返回 false（元素保持有效）。
+  bool TryPush(T&& item) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail > mask_) {
+      return false;
+    }
+    buffer_[head & mask_] = std::move(item);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// 消费者调用：移动出队；队空返回 false（`*out` 不被修改）。
+  bool TryPop(T* out) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+      return false;
+    }
+    *out = std::move(buffer_[tail & mask_]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// 近似深度（跨线程观察值，仅作监控提示用途）。
+  std::size_t Size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  /// 近似判空（跨线程观察值，仅作提示用途）。
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  std::size_t capacity() const { return buffer_.size(); }
+
+ private:
+  static std::size_t RoundUpPow2(std::size_t value) {
+    std::size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  std::vector<T> buffer_;
+  std::size_t mask_{0};
+  alignas(64) std::atomic<std::size_t> head_{0};  ///< 生产者游标。
+  alignas(64) std::atomic<std::size_t> tail_{0};  ///< 消费者游标。
+};
+
+}  // namespace ai_trade
@@ -0,0 +1,66 @@
+#include "core/symbol_table.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace ai_trade {
+
+namespace {
+
+// 读多写少：已知 symbol 走共享锁；只有首次出现的 symbol 走独占锁。
+// universe 规模为几十个，插入在启动阶段即收敛。
+// names 用 deque：追加不搬移既有元素，SymbolNameOf 返回的引用
+// 在进程生命周期内始终有效。
+struct SymbolTable {
+  std::shared_mutex mutex;
+  std::unordered_map<std::string, SymbolId> ids;
+  std::deque<std::string> names;
+};
+
+SymbolTable& GlobalTable() {
+  static SymbolTable table;
+  return table;
+}
+
+}  // namespace
+
+SymbolId InternSymbol(const std::string& name) {
+  SymbolTable& table = GlobalTable();
+  {
+    std::shared_lock lock(table.mutex);
+    const auto it = table.ids.find(name);
+    if (it != table.ids.end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock lock(table.mutex);
+  // 升级锁期间可能已被其它线程插入，重查一次。
+  const auto it = table.ids.find(name);
+  if (it != table.ids.end()) {
+    return it->second;
+  }
+  const SymbolId id = static_cast<SymbolId>(table.names.size());
+  table.names.push_back(name);
+  table.ids.emplace(name, id);
+  return id;
+}
+
+const std::string& SymbolNameOf(SymbolId id) {
+  static const std::string kEmpty;
+  SymbolTable& table = GlobalTable();
+  std::shared_lock lock(table.mutex);
+  if (id >= table.names.size()) {
+    return kEmpty;
+  }
+  return table.names[id];
+}
+
+std::size_t InternedSymbolCount() {
+  SymbolTable& table = GlobalTable();
+  std::shared_lock lock(table.mutex);
+  return table.names.size();
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "core/types.h"
+
+namespace ai_trade {
+
+// 进程级 symbol intern 表
+// 把 symbol 名称映射为从 0 起的稠密 SymbolId：行情/回报入口 intern
+// 一次，热路径结构体与各引擎的 per-symbol 状态改用 id 做数组索引，
+// 字符串只在 I/O 边界（日志、REST/WS 报文）出现。线程安全，id 一经
+// 分配在进程生命周期内不变。
+
+/// 返回 name 的稠密 id；首次出现时分配新 id。
+SymbolId InternSymbol(const std::string& name);
+
+/// 反查 id 对应的名称；未知 id 返回空串引用。
+const std::string& SymbolNameOf(SymbolId id);
+
+/// 当前已 intern 的 symbol 数量（稠密 id 的上界）。
+std::size_t InternedSymbolCount();
+
+}  // namespace ai_trade
@@ -0,0 +1,190 @@
+#include "core/thread_topology.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "core/log.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 进程级拓扑配置：启动期写一次，之后各线程入口只读。
+ThreadTopologyConfig g_topology_config;
+bool g_topology_configured = false;
+
+const std::string& RoleCpuList(const ThreadTopologyConfig& config,
+                               ThreadRole role) {
+  switch (role) {
+    case ThreadRole::kFeed:
+      return config.feed_cpus;
+    case ThreadRole::kDecision:
+      return config.decision_cpus;
+    case ThreadRole::kExecutor:
+      return config.executor_cpus;
+    case ThreadRole::kLogger:
+      return config.logger_cpus;
+    case ThreadRole::kBackground:
+      return config.background_cpus;
+  }
+  static const std::string kEmpty;
+  return kEmpty;
+}
+
+}  // namespace
+
+const char* ToString(ThreadRole role) {
+  switch (role) {
+    case ThreadRole::kFeed:
+      return "feed";
+    case ThreadRole::kDecision:
+      return "decision";
+    case ThreadRole::kExecutor:
+      return "executor";
+    case ThreadRole::kLogger:
+      return "logger";
+    case ThreadRole::kBackground:
+      return "background";
+  }
+  return "unknown";
+}
+
+bool ParseCpuList(const std::string& text, std::vector<int>* out_cpus) {
+  out_cpus->clear();
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    // 跳过空白与分隔符
+    while (pos < text.size() &&
+           (text[pos] == ',' || std::isspace(static_cast<unsigned char>(text[pos])))) {
+      ++pos;
+    }
+    if (pos >= text.size()) {
+      break;
+    }
+    char* end = nullptr;
+    const long first = std::strtol(text.c_str() + pos, &end, 10);
+    if (end == text.c_str() + pos || first < 0) {
+      return false;
+    }
+    pos = static_cast<std::size_t>(end - text.c_str());
+    long last = first;
+    if (pos < text.size() && text[pos] == '-') {
+      ++pos;
+      last = std::strtol(text.c_str() + pos, &end, 10);
+      if (end == text.c_str() + pos || last < first) {
+        return false;
+      }
+      pos = static_cast<std::size_t>(end - text.c_str());
+    }
+    for (long cpu = first; cpu <= last; ++cpu) {
+      out_cpus->push_back(static_cast<int>(cpu));
+    }
+  }
+  return !out_cpus->empty();
+}
+
+void ConfigureThreadTopology(const ThreadTopologyConfig& config) {
+  g_topology_config = config;
+  g_topology_configured = true;
+  if (config.enabled) {
+    LogInfo("THREAD_TOPOLOGY_CONFIGURED: " + ThreadTopologyStartupReport());
+  }
+}
+
+bool ApplyThreadRole(ThreadRole role, std::string* out_realized) {
+  if (!g_topology_configured || !g_topology_config.enabled) {
+    if (out_realized != nullptr) {
+      *out_realized = "topology_disabled";
+    }
+    return true;
+  }
+  const std::string& cpu_list = RoleCpuList(g_topology_config, role);
+  const bool want_fifo =
+      role == ThreadRole::kDecision && g_topology_config.decision_sched_fifo;
+  if (cpu_list.empty() && !want_fifo) {
+    if (out_realized != nullptr) {
+      *out_realized = "unpinned";
+    }
+    return true;
+  }
+
+  bool ok = true;
+  std::ostringstream realized;
+#if defined(__linux__)
+  if (!cpu_list.empty()) {
+    std::vector<int> cpus;
+    if (!ParseCpuList(cpu_list, &cpus)) {
+      LogInfo("THREAD_TOPOLOGY_WARN: role=" + std::string(ToString(role)) +
+              ", 核号列表非法: " + cpu_list);
+      ok = false;
+    } else {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      for (const int cpu : cpus) {
+        CPU_SET(cpu, &cpu_set);
+      }
+      if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+          0) {
+        LogInfo("THREAD_TOPOLOGY_WARN: role=" + std::string(ToString(role)) +
+                ", 绑核失败（内核拒绝），线程保持自由迁移: cpus=" + cpu_list);
+        ok = false;
+      } else {
+        realized << "cpus=" << cpu_list;
+      }
+    }
+  }
+  if (want_fifo) {
+    sched_param param{};
+    param.sched_priority = g_topology_config.decision_fifo_priority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+      // 容器/无 CAP_SYS_NICE 环境的常态，降级为普通调度继续跑。
+      LogInfo("THREAD_TOPOLOGY_WARN: role=decision, SCHED_FIFO 提升失败"
+              "（缺少权限？），保持默认调度策略");
+      ok = false;
+    } else {
+      realized << (realized.str().empty() ? "" : " ")
+               << "policy=fifo:" << g_topology_config.decision_fifo_priority;
+    }
+  }
+#else
+  LogInfo("THREAD_TOPOLOGY_WARN: 非 Linux 平台不支持绑核，拓扑配置被忽略");
+  ok = false;
+#endif
+
+  std::string realized_text = realized.str();
+  if (realized_text.empty()) {
+    realized_text = "unpinned";
+  }
+  LogInfo("THREAD_TOPOLOGY_APPLIED: role=" + std::string(ToString(role)) +
+          ", " + realized_text);
+  if (out_realized != nullptr) {
+    *out_realized = realized_text;
+  }
+  return ok;
+}
+
+std::string ThreadTopologyStartupReport() {
+  const ThreadTopologyConfig& c = g_topology_config;
+  std::ostringstream oss;
+  oss << "enabled=" << (c.enabled ? "true" : "false");
+  const ThreadRole roles[] = {ThreadRole::kFeed, ThreadRole::kDecision,
+                              ThreadRole::kExecutor, ThreadRole::kLogger,
+                              ThreadRole::kBackground};
+  for (const ThreadRole role : roles) {
+    const std::string& cpus = RoleCpuList(c, role);
+    oss << ", " << ToString(role) << "=" << (cpus.empty() ? "any" : cpus);
+  }
+  if (c.decision_sched_fifo) {
+    oss << ", decision_policy=fifo:" << c.decision_fifo_priority;
+  }
+  return oss.str();
+}
+
+}  // namespace ai_trade
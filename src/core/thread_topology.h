@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/config.h"
+
+namespace ai_trade {
+
+/**
+ * @brief 线程拓扑角色
+ *
+ * BotApplication 的线程按职责分五类：行情读取（feed）、决策主循环
+ * （decision）、异步执行器（executor）、异步日志（logger）与其余
+ * 后台维护线程（background：配置热加载、合约规则刷新、metrics 服务）。
+ */
+enum class ThreadRole {
+  kFeed,
+  kDecision,
+  kExecutor,
+  kLogger,
+  kBackground,
+};
+
+/// 角色名（日志/报告用）。
+const char* ToString(ThreadRole role);
+
+/**
+ * @brief 安装进程级线程拓扑配置（启动期调用一次）
+ *
+ * 之后各线程在自己的入口调用 `ApplyThreadRole` 领取绑核与调度策略。
+ * 未调用或 `enabled=false` 时 `ApplyThreadRole` 是空操作——内核自由
+ * 迁移，与历史行为一致。
+ */
+void ConfigureThreadTopology(const ThreadTopologyConfig& config);
+
+/**
+ * @brief 把当前线程按角色绑核并（仅决策线程可选）提升为 SCHED_FIFO
+ *
+ * 绑核失败不致命：记录 THREAD_TOPOLOGY_WARN 日志后按原样继续运行。
+ * SCHED_FIFO 需要 CAP_SYS_NICE，无权限时同样降级为普通调度。
+ * 成功与否都会把实际生效的布局写入 INFO 日志（启动报告的逐线程部分）。
+ *
+ * @param role 线程角色
+ * @param out_realized 实际生效布局描述（可选输出，如 "cpus=2 policy=fifo:10"）
+ * @return true 配置的绑核/调度全部生效（拓扑未启用或该角色未配置也算 true）
+ */
+bool ApplyThreadRole(ThreadRole role, std::string* out_realized = nullptr);
+
+/**
+ * @brief 配置布局一览（启动日志用）
+ *
+ * 仅反映配置期望；逐线程的实际生效布局由 `ApplyThreadRole` 各自上报。
+ */
+std::string ThreadTopologyStartupReport();
+
+/**
+ * @brief 解析核号列表（"0,2,4-7" 形态）
+ *
+ * 供拓扑内部与配置校验使用；非法片段返回 false 并保持 out 未定义。
+ */
+bool ParseCpuList(const std::string& text, std::vector<int>* out_cpus);
+
+}  // namespace ai_trade
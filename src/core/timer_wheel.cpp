@@ -0,0 +1,150 @@
+#include "core/timer_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace ai_trade {
+
+TimerWheel::TimerWheel(std::int64_t now_ms) : current_ms_(now_ms) {}
+
+TimerWheel::TimerId TimerWheel::ScheduleAt(std::int64_t fire_at_ms,
+                                           Callback callback) {
+  const TimerId id = next_id_++;
+  // 过去时刻统一推到下一毫秒：保证条目总在轮面前方、下次 Advance 必触发。
+  const std::int64_t fire_at = std::max(fire_at_ms, current_ms_ + 1);
+  live_.insert(id);
+  deadline_hints_.push_back(fire_at);
+  std::push_heap(deadline_hints_.begin(), deadline_hints_.end(),
+                 std::greater<std::int64_t>{});
+  Place(Entry{id, fire_at, std::move(callback)});
+  return id;
+}
+
+TimerWheel::TimerId TimerWheel::ScheduleAfter(std::int64_t delay_ms,
+                                              Callback callback) {
+  return ScheduleAt(current_ms_ + delay_ms, std::move(callback));
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+  // 惰性删除：槽里的条目等轮转触碰到时再丢弃，这里只摘句柄。
+  return live_.erase(id) > 0;
+}
+
+void TimerWheel::Place(Entry&& entry) {
+  const std::int64_t delta = entry.fire_at_ms - current_ms_;
+  for (int level = 0; level < kLevels; ++level) {
+    if (delta < (1LL << (kSlotBits * (level + 1)))) {
+      const int slot = static_cast<int>(
+          (entry.fire_at_ms >> (kSlotBits * level)) & kSlotMask);
+      slots_[level][slot].push_back(std::move(entry));
+      ++level_count_[level];
+      return;
+    }
+  }
+  overflow_.push_back(std::move(entry));
+}
+
+void TimerWheel::Drain(std::vector<Entry>* entries, int* fired) {
+  for (Entry& entry : *entries) {
+    const auto it = live_.find(entry.id);
+    if (it == live_.end()) {
+      continue;  // 已取消：随轮转释放
+    }
+    if (entry.fire_at_ms <= current_ms_) {
+      live_.erase(it);
+      Callback callback = std::move(entry.callback);
+      callback(current_ms_);
+      ++*fired;
+    } else {
+      // 级联回填：高层槽释放的条目落到更低层，等各自的到期时刻。
+      Place(std::move(entry));
+    }
+  }
+}
+
+void TimerWheel::StepOneMs(int* fired) {
+  ++current_ms_;
+  // 级联：轮面跨过高层槽边界时把该槽整体释放到低层。
+  for (int level = 1; level <= kLevels; ++level) {
+    if ((current_ms_ & ((1LL << (kSlotBits * level)) - 1)) != 0) {
+      break;
+    }
+    std::vector<Entry> batch;
+    if (level == kLevels) {
+      // 顶层换轮：把进入覆盖范围的溢出条目回填进轮。
+      for (auto it = overflow_.begin(); it != overflow_.end();) {
+        if (it->fire_at_ms < current_ms_ + kHorizonMs) {
+          batch.push_back(std::move(*it));
+          it = overflow_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    } else {
+      const int slot = static_cast<int>(
+          (current_ms_ >> (kSlotBits * level)) & kSlotMask);
+      batch = std::move(slots_[level][slot]);
+      slots_[level][slot].clear();
+      level_count_[level] -= static_cast<int>(batch.size());
+    }
+    Drain(&batch, fired);
+  }
+
+  const int slot0 = static_cast<int>(current_ms_ & kSlotMask);
+  std::vector<Entry> due = std::move(slots_[0][slot0]);
+  slots_[0][slot0].clear();
+  level_count_[0] -= static_cast<int>(due.size());
+  Drain(&due, fired);
+}
+
+int TimerWheel::Advance(std::int64_t now_ms) {
+  int fired = 0;
+  while (current_ms_ < now_ms) {
+    if (live_.empty()) {
+      // 只剩已取消的残留条目：整体清空并直接对齐轮面。
+      for (auto& level : slots_) {
+        for (auto& slot : level) {
+          slot.clear();
+        }
+      }
+      for (int& count : level_count_) {
+        count = 0;
+      }
+      overflow_.clear();
+      deadline_hints_.clear();
+      current_ms_ = now_ms;
+      break;
+    }
+    // 快进：低层全空时，下一个可能的到期/级联点只会在更高层的槽边界。
+    int empty_levels = 0;
+    while (empty_levels < kLevels && level_count_[empty_levels] == 0) {
+      ++empty_levels;
+    }
+    if (empty_levels > 0) {
+      const std::int64_t boundary =
+          ((current_ms_ >> (kSlotBits * empty_levels)) + 1)
+          << (kSlotBits * empty_levels);
+      const std::int64_t target = std::min(now_ms, boundary);
+      if (target - 1 > current_ms_) {
+        current_ms_ = target - 1;
+      }
+    }
+    StepOneMs(&fired);
+  }
+  // 清理已过期的到期提示（对应条目要么已触发、要么已取消）。
+  while (!deadline_hints_.empty() && deadline_hints_.front() <= current_ms_) {
+    std::pop_heap(deadline_hints_.begin(), deadline_hints_.end(),
+                  std::greater<std::int64_t>{});
+    deadline_hints_.pop_back();
+  }
+  return fired;
+}
+
+std::int64_t TimerWheel::NextDeadlineHintMs() const {
+  if (live_.empty() || deadline_hints_.empty()) {
+    return -1;
+  }
+  return deadline_hints_.front();
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_set>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief 分层时间轮 (Hierarchical Timer Wheel)
+ *
+ * 为重试退避、订单超时升级、保护单确认截止等分散的时间逻辑提供统一的
+ * 毫秒级定时服务：组件注册回调，主循环每轮调用一次 `Advance()`，到期
+ * 回调按时间序触发，成本与**到期数量**成正比，而不是与在途定时器总数
+ * 成正比——取代各模块每轮全量扫描自身状态表的做法。
+ *
+ * 结构：4 层、每层 64 槽，槽宽依次为 1ms / 64ms / 4096ms / 262144ms，
+ * 覆盖约 4.6 小时；更远的定时器进溢出链，在顶层换轮时批量回填。
+ * 高层槽在其时间边界整点把条目级联到低层，定时器只在到期那一刻被触碰。
+ *
+ * 约定：
+ * - 单线程使用（决策线程），与主循环共享 `NowMsCached()` 时间源；
+ * - 过去时刻的定时器在下一次 `Advance()` 触发，不会丢失；
+ * - `Cancel()` 为惰性删除：条目在被轮转触碰时才真正释放；
+ * - 回调内允许再注册/取消定时器（含注册到当前时刻）。
+ */
+class TimerWheel {
+ public:
+  using TimerId = std::uint64_t;
+  using Callback = std::function<void(std::int64_t now_ms)>;
+
+  /// @param now_ms 时间轮锚点；后续 Advance/Schedule 的时间都相对它推进。
+  explicit TimerWheel(std::int64_t now_ms = 0);
+
+  /// 注册在绝对时刻 `fire_at_ms` 触发的回调，返回可用于取消的句柄。
+  TimerId ScheduleAt(std::int64_t fire_at_ms, Callback callback);
+
+  /// 注册在 `delay_ms` 毫秒后触发的回调（相对当前轮面时间）。
+  TimerId ScheduleAfter(std::int64_t delay_ms, Callback callback);
+
+  /// 取消定时器；已触发或未知的句柄返回 false。
+  bool Cancel(TimerId id);
+
+  /**
+   * @brief 把轮面推进到 `now_ms` 并触发期间到期的回调
+   *
+   * 低层无定时器时直接跳到下一个级联边界，空闲推进几乎零成本。
+   * @return 本次触发的回调数量
+   */
+  int Advance(std::int64_t now_ms);
+
+  /// 在途（未触发且未取消）的定时器数量。
+  std::size_t pending() const { return live_.size(); }
+
+  /// 当前轮面时间（最近一次 Advance 推进到的毫秒时刻）。
+  std::int64_t now_ms() const { return current_ms_; }
+
+  /**
+   * @brief 下一个可能到期时刻的下界（无在途定时器时返回 -1）
+   *
+   * 供事件驱动主循环做等待超时：保证不晚于真实的最早到期时刻；
+   * 因取消是惰性的，可能偏早（提前醒来一轮空转，无副作用）。
+   */
+  std::int64_t NextDeadlineHintMs() const;
+
+ private:
+  struct Entry {
+    TimerId id{0};
+    std::int64_t fire_at_ms{0};
+    Callback callback;
+  };
+
+  static constexpr int kLevels = 4;      ///< 轮的层数。
+  static constexpr int kSlotBits = 6;    ///< 每层槽位数的位宽（64 槽）。
+  static constexpr int kSlotsPerLevel = 1 << kSlotBits;
+  static constexpr int kSlotMask = kSlotsPerLevel - 1;
+  /// 四层合计可表达的最大相对时距（约 4.6 小时），超出进溢出链。
+  static constexpr std::int64_t kHorizonMs = 1LL
+                                             << (kSlotBits * kLevels);
+
+  /// 把条目放入对应层的槽（或溢出链）；fire_at 必须晚于当前轮面时间。
+  void Place(Entry&& entry);
+  /// 推进轮面 1ms：先级联到点的高层槽，再触发当前槽。
+  void StepOneMs(int* fired);
+  /// 触发或回填一批条目（级联与到期共用）。
+  void Drain(std::vector<Entry>* entries, int* fired);
+
+  std::int64_t current_ms_{0};  ///< 轮面时间。
+  TimerId next_id_{1};          ///< 句柄分配器（0 保留为非法值）。
+  std::vector<Entry> slots_[kLevels][kSlotsPerLevel];
+  std::list<Entry> overflow_;           ///< 超出四层覆盖范围的远期定时器。
+  int level_count_[kLevels] = {};       ///< 各层在槽条目数（含已取消）。
+  std::unordered_set<TimerId> live_;    ///< 未触发且未取消的句柄集合。
+  /// 到期时刻下界提示（小顶堆语义，用有序多重集合实现，惰性清理）。
+  std::vector<std::int64_t> deadline_hints_;
+};
+
+}  // namespace ai_trade
@@ -18,6 +18,11 @@ using Price = double;
 using Quantity = double;
 using Money = double;
 
+/// 进程内 intern 的 symbol 稠密 id（见 core/symbol_table.h）。
+using SymbolId = std::uint32_t;
+/// 哨兵值：事件尚未经过 intern，下游按字符串回退解析。
+inline constexpr SymbolId kInvalidSymbolId = 0xFFFFFFFFU;
+
 /// Trading Side (Type-safe wrapper around direction)
 enum class Side {
   kBuy = 1,
@@ -58,6 +63,14 @@ struct MarketEvent {
   std::int64_t interval_ms{0};  // 与上一条同 symbol 行情的时间间隔
   // 当前行情间隔对应的资金费率（按 interval 已折算）；缺失时为 NaN。
   double funding_rate_per_interval{std::numeric_limits<double>::quiet_NaN()};
+  // 行情入口 intern 一次后填充（新字段置尾，保持聚合初始化兼容）；
+  // 热路径引擎凭 id 做稠密数组索引，避免逐引擎的字符串哈希。
+  SymbolId symbol_id{kInvalidSymbolId};
+  // 订单簿顶档（公共流 orderbook 通道启用后填充；0 表示簿不可用）。
+  Price best_bid{0.0};
+  Price best_ask{0.0};
+  // 前几档买卖量不平衡 (Σbid-Σask)/(Σbid+Σask)；无簿时为 NaN。
+  double book_imbalance{std::numeric_limits<double>::quiet_NaN()};
 };
 
 /// Regime Analysis Snapshot
@@ -95,7 +108,12 @@ struct Signal {
   int direction{0}; // Kept as int for JSON compatibility (-1, 0, 1)
   double confidence{0.0}; // 0.0 to 1.0
   Timestamp valid_until_ms{0};
-  std::vector<std::string> reason_codes{};
+  // 固定 reason code 的位掩码（见 core/reason_codes.h）：热路径只置位，
+  // 落日志时经 ExpandReasonMask 懒展开为旧 JSON 字段的字符串数组。
+  std::uint64_t reason_mask{0};
+  // 动态 reason（如 MODEL_<policy>）：无法进位掩码的少数例外，
+  // 仅 Integrator 策略介入时填充。
+  std::vector<std::string> extra_reason_codes{};
 };
 
 /// Integrator / ML Model Inference
@@ -121,6 +139,15 @@ struct RiskAdjustedPosition {
   RiskMode risk_mode{RiskMode::kNormal};
 };
 
+/// 账户级风险聚合快照：每个决策轮对持仓表做一次遍历得出，
+/// 供风控在同一轮内对全部 symbol 复用，避免逐 symbol 重复聚合。
+struct AccountRiskSnapshot {
+  double equity_usd{0.0};               ///< 现金 + 未实现盈亏。
+  double drawdown_pct{0.0};             ///< 相对权益峰值的回撤 (0.0 ~ 1.0)。
+  double liquidation_distance_pct{1.0}; ///< P95 强平距离（无持仓时为 1.0）。
+  double gross_notional_usd{0.0};       ///< 全部持仓名义敞口绝对值之和。
+};
+
 /// Execution Intent
 struct OrderIntent {
   std::string client_order_id;
@@ -0,0 +1,119 @@
+#include "evolution/evolution_pipeline.h"
+
+#include <chrono>
+
+namespace ai_trade {
+
+namespace {
+
+/// 后台线程空转超时：即使错过唤醒也按该周期兜底排空。
+constexpr int kWorkerIdleTimeoutMs = 10;
+
+}  // namespace
+
+EvolutionPipeline::EvolutionPipeline(SelfEvolutionConfig config)
+    : controller_(std::move(config)),
+      observation_ring_(kObservationRingCapacity) {}
+
+EvolutionPipeline::~EvolutionPipeline() { Stop(); }
+
+bool EvolutionPipeline::Initialize(std::int64_t current_tick,
+                                   double initial_equity_usd,
+                                   const std::pair<double, double>& initial_weights,
+                                   std::string* out_error,
+                                   double initial_realized_net_pnl_usd) {
+  if (!controller_.Initialize(current_tick,
+                              initial_equity_usd,
+                              initial_weights,
+                              out_error,
+                              initial_realized_net_pnl_usd)) {
+    return false;
+  }
+  next_eval_tick_.store(controller_.next_eval_tick(),
+                        std::memory_order_relaxed);
+  cooldown_until_tick_.store(controller_.cooldown_until_tick(),
+                             std::memory_order_relaxed);
+  initialized_.store(true, std::memory_order_relaxed);
+  worker_thread_ = std::thread(&EvolutionPipeline::RunWorker, this);
+  return true;
+}
+
+bool EvolutionPipeline::SubmitObservation(EvolutionObservation observation) {
+  if (!observation_ring_.TryPush(std::move(observation))) {
+    dropped_observations_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  work_cv_.notify_one();
+  return true;
+}
+
+std::optional<SelfEvolutionAction> EvolutionPipeline::PollAction() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_actions_.empty()) {
+    return std::nullopt;
+  }
+  SelfEvolutionAction action = std::move(pending_actions_.front());
+  pending_actions_.pop_front();
+  return action;
+}
+
+void EvolutionPipeline::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      return;
+    }
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  if (worker_thread_.joinable()) {
+    worker_thread_.join();
+  }
+}
+
+void EvolutionPipeline::RunWorker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait_for(lock,
+                      std::chrono::milliseconds(kWorkerIdleTimeoutMs),
+                      [this] { return stop_ || !observation_ring_.Empty(); });
+    const bool stopping = stop_;
+    lock.unlock();
+    DrainObservations();
+    lock.lock();
+    if (stopping) {
+      return;  // 停止前已排空剩余观测。
+    }
+  }
+}
+
+void EvolutionPipeline::DrainObservations() {
+  EvolutionObservation observation;
+  while (observation_ring_.TryPop(&observation)) {
+    auto action =
+        controller_.OnTick(observation.tick,
+                           observation.realized_net_pnl_usd,
+                           observation.regime_bucket,
+                           observation.drawdown_pct,
+                           observation.account_notional_usd,
+                           observation.trend_signal_notional_usd,
+                           observation.defensive_signal_notional_usd,
+                           observation.mark_price_usd,
+                           observation.signal_symbol,
+                           observation.entry_filtered_by_cost,
+                           observation.fill_count,
+                           observation.account_equity_usd,
+                           observation.observed_turnover_cost_bps,
+                           observation.observed_funding_rate_per_tick);
+    next_eval_tick_.store(controller_.next_eval_tick(),
+                          std::memory_order_relaxed);
+    cooldown_until_tick_.store(controller_.cooldown_until_tick(),
+                               std::memory_order_relaxed);
+    if (action.has_value()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_actions_.push_back(std::move(*action));
+    }
+  }
+}
+
+}  // namespace ai_trade
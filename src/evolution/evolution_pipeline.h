@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "core/config.h"
+#include "core/spsc_ring.h"
+#include "evolution/self_evolution_controller.h"
+
+namespace ai_trade {
+
+/// 自进化的单 tick 紧凑观测（与 SelfEvolutionController::OnTick 参数一致）。
+struct EvolutionObservation {
+  std::int64_t tick{0};
+  double realized_net_pnl_usd{0.0};
+  RegimeBucket regime_bucket{RegimeBucket::kRange};
+  double drawdown_pct{0.0};
+  double account_notional_usd{0.0};
+  double trend_signal_notional_usd{0.0};
+  double defensive_signal_notional_usd{0.0};
+  double mark_price_usd{0.0};
+  std::string signal_symbol;
+  bool entry_filtered_by_cost{false};
+  int fill_count{0};
+  double account_equity_usd{0.0};
+  double observed_turnover_cost_bps{0.0};
+  double observed_funding_rate_per_tick{0.0};
+};
+
+/**
+ * @brief 自进化异步评估流水线
+ *
+ * `SelfEvolutionController` 的统计累计与反事实评估都是批处理友好的
+ * 工作，不需要 tick 截止期延迟，此前却同步跑在交易主循环里。本类把
+ * 它搬到后台线程：交易线程每 tick 只把紧凑观测压进 SPSC 环（无锁，
+ * 环满丢弃并由调用方计数），后台线程按序排空环、驱动控制器维护
+ * 累计器并产出 `SelfEvolutionAction`；交易线程在 tick 边界通过
+ * `PollAction` 取回已批准的动作，再经 `SetEvolutionWeightsForBucket`
+ * 原子应用权重切换。
+ *
+ * 观测严格按 tick 顺序消费，控制器语义与同步路径一致，只是动作
+ * 落地晚至多一个轮询周期。`next_eval_tick`/`cooldown_until_tick`
+ * 以 relaxed 原子镜像供主循环状态行无锁读取。回放模式不应使用本类
+ * （异步落地破坏可复现性），由调用方保持同步路径。
+ */
+class EvolutionPipeline {
+ public:
+  /// 观测环容量（远大于评估周期，环满意味着后台线程长期饥饿）。
+  static constexpr std::size_t kObservationRingCapacity = 4096;
+
+  explicit EvolutionPipeline(SelfEvolutionConfig config);
+  ~EvolutionPipeline();
+
+  EvolutionPipeline(const EvolutionPipeline&) = delete;
+  EvolutionPipeline& operator=(const EvolutionPipeline&) = delete;
+
+  /// 初始化内部控制器并启动后台评估线程。
+  bool Initialize(std::int64_t current_tick,
+                  double initial_equity_usd,
+                  const std::pair<double, double>& initial_weights,
+                  std::string* out_error,
+                  double initial_realized_net_pnl_usd = 0.0);
+
+  /// 热路径：观测入环（无锁）；环满返回 false（观测被丢弃）。
+  bool SubmitObservation(EvolutionObservation observation);
+
+  /// 交易线程在 tick 边界取回后台产出的动作；无动作返回 nullopt。
+  std::optional<SelfEvolutionAction> PollAction();
+
+  /// 停止后台线程并排空剩余观测（幂等，析构自动调用）。
+  void Stop();
+
+  bool initialized() const { return initialized_.load(std::memory_order_relaxed); }
+  /// 控制器评估节奏的原子镜像（后台线程每次 OnTick 后刷新）。
+  std::int64_t next_eval_tick() const {
+    return next_eval_tick_.load(std::memory_order_relaxed);
+  }
+  std::int64_t cooldown_until_tick() const {
+    return cooldown_until_tick_.load(std::memory_order_relaxed);
+  }
+  /// 环满丢弃的观测数（监控用途）。
+  std::uint64_t dropped_observations() const {
+    return dropped_observations_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// 后台线程主体：cv 唤醒或超时后按序排空观测环。
+  void RunWorker();
+  /// 排空当前环内全部观测并产出动作（后台线程调用）。
+  void DrainObservations();
+
+  SelfEvolutionController controller_;  ///< 仅后台线程触达（启动后）。
+  SpscRing<EvolutionObservation> observation_ring_;
+  std::thread worker_thread_;
+  std::mutex mutex_;  ///< 保护动作队列与停止标志。
+  std::condition_variable work_cv_;  ///< 生产者唤醒后台线程。
+  std::deque<SelfEvolutionAction> pending_actions_;
+  bool stop_{false};
+  std::atomic<bool> initialized_{false};
+  std::atomic<std::int64_t> next_eval_tick_{0};
+  std::atomic<std::int64_t> cooldown_until_tick_{0};
+  std::atomic<std::uint64_t> dropped_observations_{0};
+};
+
+}  // namespace ai_trade
@@ -10,6 +10,11 @@ namespace {
 constexpr double kWeightEpsilon = 1e-9;
 constexpr double kStatsEpsilon = 1e-12;
 
+// 因子 IC 共矩的指数衰减系数：1.0 表示窗口内等权（窗口由
+// ResetWindowAttribution 周期清零界定）；调小即可让 IC 偏向近期
+// 样本，无需改动累计器布局。
+constexpr double kFactorIcDecay = 1.0;
+
 double BlendNotional(double trend_notional_usd,
                      double defensive_notional_usd,
                      double trend_weight) {
@@ -24,6 +29,32 @@ SelfEvolutionController::SelfEvolutionController(SelfEvolutionConfig config)
   InitializeCounterfactualGrid();
 }
 
+void SelfEvolutionController::CorrelationAccumulator::Add(double x,
+                                                          double y,
+                                                          double decay) {
+  // 加权 Welford 更新（West, 1979）：先衰减旧共矩再并入新样本，
+  // 共矩始终围绕当前均值中心化。
+  m2_x *= decay;
+  m2_y *= decay;
+  co_xy *= decay;
+  weight = weight * decay + 1.0;
+  const double dx = x - mean_x;
+  mean_x += dx / weight;
+  const double dy = y - mean_y;
+  mean_y += dy / weight;
+  m2_x += dx * (x - mean_x);
+  m2_y += dy * (y - mean_y);
+  co_xy += dx * (y - mean_y);
+  ++samples;
+}
+
+void SelfEvolutionController::SampleAccumulator::Add(double value) {
+  ++samples;
+  const double delta = value - mean;
+  mean += delta / static_cast<double>(samples);
+  m2 += delta * (value - mean);
+}
+
 std::size_t SelfEvolutionController::BucketIndex(RegimeBucket bucket) {
   switch (bucket) {
     case RegimeBucket::kTrend:
@@ -157,11 +188,8 @@ std::optional<SelfEvolutionAction> SelfEvolutionController::OnTick(
   }
   bucket_window_realized_pnl_usd_[active_index] += delta_realized_net_pnl_usd;
   if (!config_.use_virtual_pnl) {
-    auto& learnability_stats = bucket_window_learnability_stats_[active_index];
-    learnability_stats.sum += delta_realized_net_pnl_usd;
-    learnability_stats.sum_sq +=
-        delta_realized_net_pnl_usd * delta_realized_net_pnl_usd;
-    ++learnability_stats.samples;
+    bucket_window_learnability_stats_[active_index].Add(
+        delta_realized_net_pnl_usd);
   }
   bucket_window_ticks_[active_index] += 1;
   if (std::fabs(trend_signal_notional_usd) > kWeightEpsilon ||
@@ -240,31 +268,16 @@ std::optional<SelfEvolutionAction> SelfEvolutionController::OnTick(
         ++bucket_window_virtual_pnl_train_samples_[active_index];
       }
       if (config_.use_virtual_pnl) {
-        auto& learnability_stats = bucket_window_learnability_stats_[active_index];
-        learnability_stats.sum += tick_virtual_pnl;
-        learnability_stats.sum_sq += tick_virtual_pnl * tick_virtual_pnl;
-        ++learnability_stats.samples;
+        bucket_window_learnability_stats_[active_index].Add(tick_virtual_pnl);
       }
 
       const double trend_component = signal_state.trend_notional_usd;
       const double defensive_component = signal_state.defensive_notional_usd;
 
-      auto& trend_factor_ic = bucket_window_trend_factor_ic_[active_index];
-      trend_factor_ic.sum_x += trend_component;
-      trend_factor_ic.sum_y += forward_return;
-      trend_factor_ic.sum_x2 += trend_component * trend_component;
-      trend_factor_ic.sum_y2 += forward_return * forward_return;
-      trend_factor_ic.sum_xy += trend_component * forward_return;
-      ++trend_factor_ic.samples;
-
-      auto& defensive_factor_ic =
-          bucket_window_defensive_factor_ic_[active_index];
-      defensive_factor_ic.sum_x += defensive_component;
-      defensive_factor_ic.sum_y += forward_return;
-      defensive_factor_ic.sum_x2 += defensive_component * defensive_component;
-      defensive_factor_ic.sum_y2 += forward_return * forward_return;
-      defensive_factor_ic.sum_xy += defensive_component * forward_return;
-      ++defensive_factor_ic.samples;
+      bucket_window_trend_factor_ic_[active_index].Add(
+          trend_component, forward_return, kFactorIcDecay);
+      bucket_window_defensive_factor_ic_[active_index].Add(
+          defensive_component, forward_return, kFactorIcDecay);
 
       if (config_.use_counterfactual_search &&
           !counterfactual_trend_weight_grid_.empty()) {
@@ -328,17 +341,11 @@ std::optional<SelfEvolutionAction> SelfEvolutionController::OnTick(
           } else {
             bucket_counterfactual_train[i] += counterfactual_tick_virtual_pnl;
           }
-          auto& diff_stats = bucket_counterfactual_diff_stats[i];
           const double diff_vs_current =
               counterfactual_tick_virtual_pnl - tick_virtual_pnl;
-          diff_stats.sum += diff_vs_current;
-          diff_stats.sum_sq += diff_vs_current * diff_vs_current;
-          ++diff_stats.samples;
+          bucket_counterfactual_diff_stats[i].Add(diff_vs_current);
           if (holdout_sample) {
-            auto& holdout_diff_stats = bucket_counterfactual_holdout_diff_stats[i];
-            holdout_diff_stats.sum += diff_vs_current;
-            holdout_diff_stats.sum_sq += diff_vs_current * diff_vs_current;
-            ++holdout_diff_stats.samples;
+            bucket_counterfactual_holdout_diff_stats[i].Add(diff_vs_current);
           }
         }
       }
@@ -348,6 +355,7 @@ std::optional<SelfEvolutionAction> SelfEvolutionController::OnTick(
     signal_state.defensive_notional_usd = defensive_signal_notional_usd;
     signal_state.mark_price_usd = mark_price_usd;
     signal_state.has_state = true;
+    signal_state.last_update_tick = current_tick;
   }
 
   last_observed_realized_net_pnl_usd_ = realized_net_pnl_usd;
@@ -359,6 +367,9 @@ std::optional<SelfEvolutionAction> SelfEvolutionController::OnTick(
     return std::nullopt;
   }
 
+  // 评估边界顺带回收陈旧信号状态，热路径不付遍历成本。
+  EvictStaleSignalStates(current_tick);
+
   const std::size_t eval_index = SelectEvalBucket(active_index);
   const RegimeBucket eval_bucket = BucketFromIndex(eval_index);
   const double window_realized_pnl_usd = bucket_window_realized_pnl_usd_[eval_index];
@@ -1037,17 +1048,12 @@ double SelfEvolutionController::CorrelationFromAccumulator(
   if (accumulator.samples < 2) {
     return 0.0;
   }
-  const double n = static_cast<double>(accumulator.samples);
-  const double cov_num =
-      n * accumulator.sum_xy - accumulator.sum_x * accumulator.sum_y;
-  const double var_x_num =
-      n * accumulator.sum_x2 - accumulator.sum_x * accumulator.sum_x;
-  const double var_y_num =
-      n * accumulator.sum_y2 - accumulator.sum_y * accumulator.sum_y;
-  if (var_x_num <= kStatsEpsilon || var_y_num <= kStatsEpsilon) {
+  if (accumulator.m2_x <= kStatsEpsilon ||
+      accumulator.m2_y <= kStatsEpsilon) {
     return 0.0;
   }
-  const double corr = cov_num / std::sqrt(var_x_num * var_y_num);
+  const double corr =
+      accumulator.co_xy / std::sqrt(accumulator.m2_x * accumulator.m2_y);
   if (!std::isfinite(corr)) {
     return 0.0;
   }
@@ -1060,9 +1066,7 @@ double SelfEvolutionController::TStatFromAccumulator(
     return 0.0;
   }
   const double n = static_cast<double>(accumulator.samples);
-  const double mean = accumulator.sum / n;
-  const double variance =
-      std::max(0.0, accumulator.sum_sq / n - mean * mean);
+  const double variance = std::max(0.0, accumulator.m2 / n);
   if (variance <= kStatsEpsilon) {
     return 0.0;
   }
@@ -1070,7 +1074,23 @@ double SelfEvolutionController::TStatFromAccumulator(
   if (std_error <= kStatsEpsilon) {
     return 0.0;
   }
-  return mean / std_error;
+  return accumulator.mean / std_error;
+}
+
+void SelfEvolutionController::EvictStaleSignalStates(
+    std::int64_t current_tick) {
+  // 宇宙轮换会不断引入新 symbol；超过数个评估窗口未再观测的条目
+  // 直接回收，状态表内存随活跃信号数而非历史 symbol 总数增长。
+  const std::int64_t stale_horizon =
+      static_cast<std::int64_t>(8) * EffectiveUpdateIntervalTicks();
+  for (auto it = signal_states_by_symbol_.begin();
+       it != signal_states_by_symbol_.end();) {
+    if (current_tick - it->second.last_update_tick > stale_horizon) {
+      it = signal_states_by_symbol_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 std::optional<EvolutionWeights> SelfEvolutionController::ProposeFactorIcWeights(
@@ -148,24 +148,35 @@ class SelfEvolutionController {
     int pending_direction{0};  // +1=trend up, -1=trend down, 0=none
     int pending_direction_streak{0};
   };
+  /// 流式相关性累计器：中心化共矩（Welford 形式）。相比原始
+  /// sum_x/sum_xy 原始矩，长窗口下不产生大数相消误差；内存恒定，
+  /// 单次更新若干次浮点运算。decay < 1 时按指数衰减加权共矩，
+  /// 近期样本权重更高。
   struct CorrelationAccumulator {
-    double sum_x{0.0};
-    double sum_y{0.0};
-    double sum_x2{0.0};
-    double sum_y2{0.0};
-    double sum_xy{0.0};
+    double mean_x{0.0};
+    double mean_y{0.0};
+    double m2_x{0.0};
+    double m2_y{0.0};
+    double co_xy{0.0};
+    double weight{0.0};  ///< 衰减后的有效样本权重（decay=1 时等于 samples）。
     int samples{0};
+
+    void Add(double x, double y, double decay = 1.0);
   };
+  /// 流式样本累计器：Welford 均值/二阶中心矩，替代 sum/sum_sq。
   struct SampleAccumulator {
-    double sum{0.0};
-    double sum_sq{0.0};
+    double mean{0.0};
+    double m2{0.0};
     int samples{0};
+
+    void Add(double value);
   };
   struct SignalState {
     double trend_notional_usd{0.0};
     double defensive_notional_usd{0.0};
     double mark_price_usd{0.0};
     bool has_state{false};
+    std::int64_t last_update_tick{0};  ///< 最近观测 tick（用于陈旧回收）。
   };
 
   static std::size_t BucketIndex(RegimeBucket bucket);
@@ -196,6 +207,9 @@ class SelfEvolutionController {
   }
   void ResetWindowAttribution(std::optional<std::size_t> bucket_index =
                                   std::nullopt);
+  /// 回收长期未再观测到的 symbol 信号状态（评估边界调用，保持
+  /// 状态表随“活跃信号数”而非历史 symbol 总数增长）。
+  void EvictStaleSignalStates(std::int64_t current_tick);
   bool ValidateWeights(double trend_weight,
                        double defensive_weight,
                        std::string* out_error) const;
@@ -16,11 +16,20 @@
 
 #include "core/json_utils.h"
 #include "core/log.h"
+#include "core/thread_topology.h"
+#include "monitor/metrics_registry.h"
 
 namespace ai_trade {
 
 namespace {
 
+/// 公共 WS 行情断档时长直方图（降级到重连恢复的墙钟间隔）。
+void RecordPublicWsGapMs(std::int64_t gap_ms) {
+  static MetricHistogram* hist = MetricsRegistry::Instance().RegisterHistogram(
+      "ai_trade_public_ws_gap", "公共 WS 行情断档时长（降级到恢复）");
+  hist->Record(gap_ms * 1'000'000);
+}
+
 // 说明：
 // 该文件承担 Bybit 适配器的核心编排逻辑，覆盖
 // 1) 认证与通道初始化（REST/WS）；
@@ -1010,65 +1019,68 @@ bool ParseBybitSymbolTradeRule(const JsonValue* instrument,
   return true;
 }
 
-bool LoadTradeRuleForSymbol(BybitRestClient* rest_client,
-                            const std::string& category,
-                            const std::string& symbol,
-                            BybitSymbolTradeRule* out_rule,
-                            std::string* out_error) {
-  if (rest_client == nullptr || out_rule == nullptr) {
-    if (out_error != nullptr) {
-      *out_error = "LoadTradeRuleForSymbol 参数为空";
-    }
-    return false;
-  }
-
-  const std::string query = "category=" + category + "&symbol=" + symbol;
-  std::string body;
-  std::string error;
-  if (!rest_client->GetPublic("/v5/market/instruments-info", query,
-                              &body, &error)) {
+/// 全量拉取交易规则（cursor 分页）；任一页失败整体失败，保留旧快照。
+bool LoadAllTradeRules(BybitRestClient* rest_client,
+                       const std::string& category,
+                       BybitExchangeAdapter::TradeRuleMap* out_rules,
+                       std::string* out_error) {
+  if (rest_client == nullptr || out_rules == nullptr) {
     if (out_error != nullptr) {
-      *out_error = error;
+      *out_error = "LoadAllTradeRules 参数为空";
     }
     return false;
   }
 
-  const std::optional<JsonValue> root = ParseJsonBody(body);
-  if (!root.has_value()) {
-    if (out_error != nullptr) {
-      *out_error = "instruments-info JSON解析失败";
+  out_rules->clear();
+  std::string cursor;
+  // 分页上限兜底：避免异常 cursor 造成死循环。
+  for (int page = 0; page < 32; ++page) {
+    std::string query = "category=" + category + "&limit=1000";
+    if (!cursor.empty()) {
+      query += "&cursor=" + cursor;
     }
-    return false;
-  }
-  const JsonValue* list = JsonResultList(&(*root));
-  if (list == nullptr || list->type != JsonType::kArray ||
-      list->array_value.empty()) {
-    if (out_error != nullptr) {
-      *out_error = "instruments-info 返回空列表";
+    std::string body;
+    if (!rest_client->GetPublic("/v5/market/instruments-info", query, &body,
+                                out_error)) {
+      return false;
     }
-    return false;
-  }
 
-  for (const auto& row : list->array_value) {
-    if (row.type != JsonType::kObject) {
-      continue;
+    const std::optional<JsonValue> root = ParseJsonBody(body);
+    if (!root.has_value()) {
+      if (out_error != nullptr) {
+        *out_error = "instruments-info JSON解析失败";
+      }
+      return false;
     }
-    const std::string row_symbol =
-        JsonStringField(&row, "symbol").value_or(std::string());
-    if (!row_symbol.empty() && row_symbol != symbol) {
-      continue;
+    const JsonValue* list = JsonResultList(&(*root));
+    if (list == nullptr || list->type != JsonType::kArray) {
+      if (out_error != nullptr) {
+        *out_error = "instruments-info 返回缺少 result.list";
+      }
+      return false;
     }
-    BybitSymbolTradeRule rule;
-    if (ParseBybitSymbolTradeRule(&row, &rule)) {
-      *out_rule = rule;
-      return true;
+    for (const auto& row : list->array_value) {
+      if (row.type != JsonType::kObject) {
+        continue;
+      }
+      const std::string row_symbol =
+          JsonStringField(&row, "symbol").value_or(std::string());
+      if (row_symbol.empty()) {
+        continue;
+      }
+      BybitSymbolTradeRule rule;
+      if (ParseBybitSymbolTradeRule(&row, &rule)) {
+        (*out_rules)[row_symbol] = rule;
+      }
     }
-  }
 
-  if (out_error != nullptr) {
-    *out_error = "instruments-info 未找到可用 lotSizeFilter";
+    const JsonValue* result = JsonObjectField(&(*root), "result");
+    cursor = JsonStringField(result, "nextPageCursor").value_or(std::string());
+    if (cursor.empty()) {
+      break;
+    }
   }
-  return false;
+  return true;
 }
 
 }  // namespace
@@ -1084,6 +1096,7 @@ bool LoadTradeRuleForSymbol(BybitRestClient* rest_client,
  * 5. 预热 execution 游标，避免重启后误消费历史成交。
  */
 bool BybitExchangeAdapter::Connect() {
+  StopInstrumentRefresh();  // 重连时先停旧刷新线程，避免双线程换代。
   options_.symbols = NormalizeSymbols(options_.symbols, options_.primary_symbol);
   observed_exec_ids_.clear();
   pending_fills_.clear();
@@ -1093,6 +1106,7 @@ bool BybitExchangeAdapter::Connect() {
   last_volume_24h_by_symbol_.clear();
   last_public_ws_reconnect_attempt_ms_ = 0;
   last_private_ws_reconnect_attempt_ms_ = 0;
+  public_ws_down_since_ms_ = 0;
   execution_watermark_ms_ = 0;
   execution_cursor_primed_ = false;
   if (!options_.replay_market_data_path.empty()) {
@@ -1168,27 +1182,32 @@ bool BybitExchangeAdapter::Connect() {
       options_.demo_trading,
       std::move(transport));
 
-  // 1. 加载交易规则 (Instrument Info)
-  symbol_trade_rules_.clear();
-  for (const auto& symbol : options_.symbols) {
-    BybitSymbolTradeRule rule;
-    std::string rule_error;
-    if (!LoadTradeRuleForSymbol(rest_client_.get(),
-                                options_.category,
-                                symbol,
-                                &rule,
-                                &rule_error)) {
-      LogInfo("Bybit 交易规则读取失败(" + symbol + "): " + rule_error +
+  // 1. 加载交易规则 (Instrument Info)：全量拉取后原子换代快照
+  {
+    auto rules = std::make_shared<TradeRuleMap>();
+    std::string rules_error;
+    if (!LoadAllTradeRules(rest_client_.get(), options_.category, rules.get(),
+                           &rules_error)) {
+      LogInfo("Bybit 交易规则全量读取失败: " + rules_error +
               "，将使用原始下单数量");
-      continue;
     }
-    symbol_trade_rules_[symbol] = rule;
-    LogInfo("Bybit 交易规则加载成功(" + symbol + "): qty_step=" +
-            ToDecimalString(rule.qty_step) +
-            ", min_order_qty=" + ToDecimalString(rule.min_order_qty) +
-            ", price_tick=" + ToDecimalString(rule.price_tick) +
-            ", min_notional=" + ToDecimalString(rule.min_notional_value) +
-            ", tradable=" + std::string(rule.tradable ? "true" : "false"));
+    for (const auto& symbol : options_.symbols) {
+      const auto it = rules->find(symbol);
+      if (it == rules->end()) {
+        LogInfo("Bybit 交易规则缺失(" + symbol + ")，将使用原始下单数量");
+        continue;
+      }
+      const BybitSymbolTradeRule& rule = it->second;
+      LogInfo("Bybit 交易规则加载成功(" + symbol + "): qty_step=" +
+              ToDecimalString(rule.qty_step) +
+              ", min_order_qty=" + ToDecimalString(rule.min_order_qty) +
+              ", price_tick=" + ToDecimalString(rule.price_tick) +
+              ", min_notional=" + ToDecimalString(rule.min_notional_value) +
+              ", tradable=" + std::string(rule.tradable ? "true" : "false"));
+    }
+    trade_rules_snapshot_.store(
+        std::shared_ptr<const TradeRuleMap>(std::move(rules)),
+        std::memory_order_release);
   }
 
   // 2. 加载账户与持仓模式 (Account Info)
@@ -1226,6 +1245,8 @@ bool BybitExchangeAdapter::Connect() {
     ws_options.enabled = true;
     ws_options.category = options_.category;
     ws_options.symbols = options_.symbols;
+    ws_options.orderbook_enabled = options_.orderbook_enabled;
+    ws_options.orderbook_depth = options_.orderbook_depth;
 
     if (options_.public_stream_factory) {
       public_stream_ = options_.public_stream_factory(ws_options);
@@ -1309,9 +1330,68 @@ bool BybitExchangeAdapter::Connect() {
           ", symbols=" + std::to_string(options_.symbols.size()) +
           ", market_channel=" + market_channel_name +
           ", fill_channel=" + fill_channel_name);
+  StartInstrumentRefresh();
   return true;
 }
 
+BybitExchangeAdapter::~BybitExchangeAdapter() {
+  StopInstrumentRefresh();
+}
+
+void BybitExchangeAdapter::StartInstrumentRefresh() {
+  if (options_.instrument_refresh_interval_s <= 0 ||
+      rest_client_ == nullptr || instrument_refresh_thread_.joinable()) {
+    return;
+  }
+  instrument_refresh_stop_.store(false, std::memory_order_release);
+  instrument_refresh_thread_ =
+      std::thread([this] { RunInstrumentRefresh(); });
+  LogInfo("BYBIT_INSTRUMENT_REFRESH_ENABLED: interval_s=" +
+          std::to_string(options_.instrument_refresh_interval_s));
+}
+
+void BybitExchangeAdapter::StopInstrumentRefresh() {
+  if (!instrument_refresh_thread_.joinable()) {
+    return;
+  }
+  instrument_refresh_stop_.store(true, std::memory_order_release);
+  instrument_refresh_thread_.join();
+}
+
+/**
+ * @brief 交易规则后台刷新线程主体
+ *
+ * TTL 到期后全量重拉 instruments-info 并原子换代快照：下单路径与
+ * GetSymbolInfo 始终读到完整一致的规则表，规则变陈旧也只是多等一个
+ * TTL 周期，永远不会在订单路径上触发阻塞的 REST 调用。拉取失败时
+ * 保留旧快照（陈旧规则优于空规则），下个周期重试。
+ */
+void BybitExchangeAdapter::RunInstrumentRefresh() {
+  ApplyThreadRole(ThreadRole::kBackground);
+  const auto interval =
+      std::chrono::seconds(options_.instrument_refresh_interval_s);
+  auto next_refresh = std::chrono::steady_clock::now() + interval;
+  while (!instrument_refresh_stop_.load(std::memory_order_acquire)) {
+    if (std::chrono::steady_clock::now() < next_refresh) {
+      // 小步睡眠以便停止标志及时生效。
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      continue;
+    }
+    auto rules = std::make_shared<TradeRuleMap>();
+    std::string refresh_error;
+    if (LoadAllTradeRules(rest_client_.get(), options_.category, rules.get(),
+                          &refresh_error)) {
+      trade_rules_snapshot_.store(
+          std::shared_ptr<const TradeRuleMap>(std::move(rules)),
+          std::memory_order_release);
+    } else {
+      LogInfo("BYBIT_INSTRUMENT_REFRESH_DEGRADED: " + refresh_error +
+              "，保留旧交易规则快照");
+    }
+    next_refresh = std::chrono::steady_clock::now() + interval;
+  }
+}
+
 std::string BybitExchangeAdapter::Name() const {
   if (IsReplayMode(options_)) {
     return "bybit_stub";
@@ -1374,7 +1454,15 @@ void BybitExchangeAdapter::MaybeReconnectPublicWs() {
   std::string reconnect_error;
   if (public_stream_->Connect(&reconnect_error)) {
     market_channel_ = MarketChannel::kPublicWs;
-    LogInfo("BYBIT_PUBLIC_WS_RECOVERED: 重连成功，切回 public_ws 行情通道");
+    std::int64_t gap_ms = 0;
+    if (public_ws_down_since_ms_ > 0) {
+      gap_ms = std::max<std::int64_t>(
+          CurrentTimestampMs() - public_ws_down_since_ms_, 0);
+      RecordPublicWsGapMs(gap_ms);
+      public_ws_down_since_ms_ = 0;
+    }
+    LogInfo("BYBIT_PUBLIC_WS_RECOVERED: 重连成功，切回 public_ws 行情通道"
+            ", gap_ms=" + std::to_string(gap_ms));
     return;
   }
 
@@ -1638,6 +1726,7 @@ bool BybitExchangeAdapter::PollMarket(MarketEvent* out_event) {
         return false;
       }
       market_channel_ = MarketChannel::kRestPolling;
+      public_ws_down_since_ms_ = CurrentTimestampMs();
       LogInfo("BYBIT_PUBLIC_WS_DEGRADED: 运行时WS不可用，切换到 REST market/tickers 轮询");
     } else {
       return false;
@@ -2000,15 +2089,88 @@ bool BybitExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
   if (rest_client_ == nullptr) {
     return false;
   }
+
+  PreparedSubmit prepared;
+  if (!PrepareSubmit(intent, &prepared)) {
+    return false;
+  }
+
+  const std::string body = "{\"category\":\"" + EscapeJson(options_.category) +
+                           "\"," + prepared.order_fields + "}";
+  std::string response;
+  std::string error;
+  if (!rest_client_->PostPrivate("/v5/order/create", body, &response, &error)) {
+    const bool post_only_rejected =
+        (error.find("PostOnly") != std::string::npos) ||
+        (error.find("post only") != std::string::npos) ||
+        (error.find("post-only") != std::string::npos) ||
+        (error.find("post_only") != std::string::npos) ||
+        (error.find("would be filled immediately") != std::string::npos);
+    if (!prepared.market_fallback_fields.empty() && post_only_rejected) {
+      std::string fallback_response;
+      std::string fallback_error;
+      LogInfo("Bybit maker-first 回退市价: symbol=" + prepared.symbol +
+              ", client_order_id=" + intent.client_order_id +
+              ", reason=post_only_rejected");
+      LogInfo("BYBIT_SUBMIT: symbol=" + prepared.symbol +
+              ", client_order_id=" + intent.client_order_id +
+              ", order_type=Market, reduce_only=" +
+              (intent.reduce_only ? std::string("true")
+                                  : std::string("false")) +
+              ", qty=" + prepared.submit_qty_str +
+              ", reason=maker_fallback_post_only");
+      const std::string market_body =
+          "{\"category\":\"" + EscapeJson(options_.category) + "\"," +
+          prepared.market_fallback_fields + "}";
+      if (!rest_client_->PostPrivate("/v5/order/create", market_body,
+                                     &fallback_response, &fallback_error)) {
+        LogInfo("Bybit 下单失败: client_order_id=" + intent.client_order_id +
+                ", error=" + fallback_error);
+        return false;
+      }
+      response = fallback_response;
+    } else {
+      LogInfo("Bybit 下单失败: client_order_id=" + intent.client_order_id +
+              ", error=" + error);
+      return false;
+    }
+  }
+  // 记录 orderId->clientOrderId 映射，解决私有回报仅携带 orderId 时的本地归一化问题。
+  if (const std::optional<JsonValue> root = ParseJsonBody(response);
+      root.has_value()) {
+    const JsonValue* result = JsonObjectField(&(*root), "result");
+    if (result != nullptr && result->type == JsonType::kObject) {
+      const std::string order_id =
+          JsonStringField(result, "orderId").value_or(std::string());
+      const std::string order_link_id =
+          JsonStringField(result, "orderLinkId")
+              .value_or(intent.client_order_id);
+      RememberOrderIdMapping(order_id, order_link_id);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 构造单笔订单的提交载荷
+ *
+ * 把交易规则应用（截断/量化/最小量/最小名义）、保护单触发参数与
+ * maker-first 定价收敛到一处，单笔与批量提交共用同一份字段构造，
+ * 保证两条路径的下单口径完全一致。
+ */
+bool BybitExchangeAdapter::PrepareSubmit(const OrderIntent& intent,
+                                         PreparedSubmit* out) {
   double submit_qty = intent.qty;
   int qty_precision = 8;
   int price_precision = 8;
   const std::string normalized_symbol = ToUpperCopy(intent.symbol);
   const BybitSymbolTradeRule* submit_rule = nullptr;
-  
+
   // 应用交易规则：先截断，再量化，再做最小名义与最小数量校验。
-  const auto rule_it = symbol_trade_rules_.find(normalized_symbol);
-  if (rule_it != symbol_trade_rules_.end()) {
+  // 快照持有到函数结束，后台换代不影响本次下单读到的规则。
+  const std::shared_ptr<const TradeRuleMap> trade_rules = TradeRules();
+  const auto rule_it = trade_rules->find(normalized_symbol);
+  if (rule_it != trade_rules->end()) {
     const BybitSymbolTradeRule& rule = rule_it->second;
     submit_rule = &rule;
     if (!rule.tradable) {
@@ -2106,19 +2268,36 @@ bool BybitExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
       options_.maker_entry_enabled &&
       (maker_entry_order || maker_reduce_order);
   if (maker_passive_order) {
-    double reference_price = intent.price;
-    if (reference_price <= 0.0) {
-      const auto it = last_price_by_symbol_.find(normalized_symbol);
-      if (it != last_price_by_symbol_.end()) {
-        reference_price = it->second;
-      }
-    }
-    if (reference_price > 0.0) {
-      const double offset_ratio =
-          std::max(0.0, options_.maker_price_offset_bps) / 10000.0;
-      const double target_price =
-          intent.direction > 0 ? reference_price * (1.0 - offset_ratio)
-                               : reference_price * (1.0 + offset_ratio);
+    // 定价优先级：订单簿顶档 > last price 偏移。簿可用时直接贴 touch
+    // （买挂 best bid、卖挂 best ask），拿到最优被动排队位置，且天然
+    // 不穿越对手价，PostOnly 不会因行情偏离参考价被拒。
+    double target_price = 0.0;
+    if (public_stream_ != nullptr) {
+      double best_bid = 0.0;
+      double best_ask = 0.0;
+      if (public_stream_->ReadTopOfBook(normalized_symbol, &best_bid,
+                                        &best_ask) &&
+          best_bid > 0.0 && best_ask > best_bid) {
+        target_price = intent.direction > 0 ? best_bid : best_ask;
+      }
+    }
+    if (target_price <= 0.0) {
+      double reference_price = intent.price;
+      if (reference_price <= 0.0) {
+        const auto it = last_price_by_symbol_.find(normalized_symbol);
+        if (it != last_price_by_symbol_.end()) {
+          reference_price = it->second;
+        }
+      }
+      if (reference_price > 0.0) {
+        const double offset_ratio =
+            std::max(0.0, options_.maker_price_offset_bps) / 10000.0;
+        target_price =
+            intent.direction > 0 ? reference_price * (1.0 - offset_ratio)
+                                 : reference_price * (1.0 + offset_ratio);
+      }
+    }
+    if (target_price > 0.0) {
       submit_price = submit_rule != nullptr
                          ? QuantizePassivePrice(target_price,
                                                 intent.direction,
@@ -2136,38 +2315,36 @@ bool BybitExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
 
   order_symbol_by_client_id_[intent.client_order_id] = normalized_symbol;
   const std::string side = intent.direction > 0 ? "Buy" : "Sell";
-  auto build_order_body = [&](const std::string& submit_order_type,
-                              double limit_price,
-                              const std::string& submit_time_in_force,
-                              double submit_trigger_price,
-                              int submit_trigger_direction,
-                              bool close_on_trigger) {
-    std::string body =
-        "{\"category\":\"" + EscapeJson(options_.category) +
-        "\",\"symbol\":\"" + EscapeJson(normalized_symbol) +
+  auto build_order_fields = [&](const std::string& submit_order_type,
+                                double limit_price,
+                                const std::string& submit_time_in_force,
+                                double submit_trigger_price,
+                                int submit_trigger_direction,
+                                bool close_on_trigger) {
+    std::string fields =
+        "\"symbol\":\"" + EscapeJson(normalized_symbol) +
         "\",\"side\":\"" + side +
         "\",\"orderType\":\"" + submit_order_type + "\"" +
         ",\"qty\":\"" + ToDecimalString(submit_qty, qty_precision) + "\"" +
         ",\"reduceOnly\":" + std::string(intent.reduce_only ? "true" : "false") +
         ",\"orderLinkId\":\"" + EscapeJson(intent.client_order_id) + "\"";
     if (submit_order_type == "Limit" && limit_price > 0.0) {
-      body +=
+      fields +=
           ",\"price\":\"" + ToDecimalString(limit_price, price_precision) + "\"";
       if (!submit_time_in_force.empty()) {
-        body += ",\"timeInForce\":\"" + submit_time_in_force + "\"";
+        fields += ",\"timeInForce\":\"" + submit_time_in_force + "\"";
       }
     }
     if (submit_trigger_price > 0.0 && submit_trigger_direction > 0) {
-      body += ",\"triggerPrice\":\"" +
-              ToDecimalString(submit_trigger_price, price_precision) + "\"";
-      body += ",\"triggerDirection\":" + std::to_string(submit_trigger_direction);
-      body += ",\"triggerBy\":\"MarkPrice\"";
+      fields += ",\"triggerPrice\":\"" +
+                ToDecimalString(submit_trigger_price, price_precision) + "\"";
+      fields += ",\"triggerDirection\":" + std::to_string(submit_trigger_direction);
+      fields += ",\"triggerBy\":\"MarkPrice\"";
       if (close_on_trigger) {
-        body += ",\"closeOnTrigger\":true";
+        fields += ",\"closeOnTrigger\":true";
       }
     }
-    body += "}";
-    return body;
+    return fields;
   };
 
   LogInfo("BYBIT_SUBMIT: symbol=" + normalized_symbol +
@@ -2188,64 +2365,136 @@ bool BybitExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
                      ", trigger_direction=" + std::to_string(trigger_direction)
                : std::string()));
 
-  std::string body = build_order_body(order_type,
-                                      submit_price,
-                                      time_in_force,
-                                      trigger_price,
-                                      trigger_direction,
-                                      conditional_protection_order);
-  std::string response;
-  std::string error;
-  if (!rest_client_->PostPrivate("/v5/order/create", body, &response, &error)) {
-    const bool post_only_rejected =
-        (error.find("PostOnly") != std::string::npos) ||
-        (error.find("post only") != std::string::npos) ||
-        (error.find("post-only") != std::string::npos) ||
-        (error.find("post_only") != std::string::npos) ||
-        (error.find("would be filled immediately") != std::string::npos);
-    if (options_.maker_fallback_to_market && maker_passive_order &&
-        order_type == "Limit" && options_.maker_post_only && post_only_rejected) {
-      std::string fallback_response;
-      std::string fallback_error;
-      LogInfo("Bybit maker-first 回退市价: symbol=" + normalized_symbol +
-              ", client_order_id=" + intent.client_order_id +
-              ", reason=post_only_rejected");
-      LogInfo("BYBIT_SUBMIT: symbol=" + normalized_symbol +
-              ", client_order_id=" + intent.client_order_id +
-              ", order_type=Market, reduce_only=" +
-              (intent.reduce_only ? std::string("true")
-                                  : std::string("false")) +
-              ", qty=" + ToDecimalString(submit_qty, qty_precision) +
-              ", reason=maker_fallback_post_only");
-      const std::string market_body =
-          build_order_body("Market", 0.0, "", 0.0, 0, false);
-      if (!rest_client_->PostPrivate("/v5/order/create", market_body,
-                                     &fallback_response, &fallback_error)) {
-        LogInfo("Bybit 下单失败: client_order_id=" + intent.client_order_id +
-                ", error=" + fallback_error);
-        return false;
+  out->symbol = normalized_symbol;
+  out->submit_qty_str = ToDecimalString(submit_qty, qty_precision);
+  out->order_fields = build_order_fields(order_type,
+                                         submit_price,
+                                         time_in_force,
+                                         trigger_price,
+                                         trigger_direction,
+                                         conditional_protection_order);
+  const bool fallback_eligible =
+      options_.maker_fallback_to_market && maker_passive_order &&
+      order_type == "Limit" && options_.maker_post_only;
+  out->market_fallback_fields =
+      fallback_eligible ? build_order_fields("Market", 0.0, "", 0.0, 0, false)
+                        : std::string();
+  return true;
+}
+
+/**
+ * @brief 批量提交订单（`/v5/order/create-batch`）
+ *
+ * 同一批订单一次 wire 调用下发（每批最多 10 笔，超出自动分片），
+ * entry + TP/SL 保护单族的提交延迟由三次 HTTP 往返降为一次。
+ * Replay 与单笔场景退回逐单路径，保留 maker PostOnly 回退等完整
+ * 语义；批量路径按响应 retExtInfo.list 的逐单 retCode 回填结果。
+ */
+bool BybitExchangeAdapter::SubmitOrders(std::span<const OrderIntent> intents,
+                                        std::vector<bool>* out_ok) {
+  if (out_ok != nullptr) {
+    out_ok->assign(intents.size(), false);
+  }
+  if (intents.empty()) {
+    return true;
+  }
+  if (!connected_) {
+    return false;
+  }
+  if (IsReplayMode(options_) || rest_client_ == nullptr ||
+      intents.size() == 1) {
+    return ExchangeAdapter::SubmitOrders(intents, out_ok);
+  }
+
+  constexpr std::size_t kBatchMaxOrders = 10;
+  bool all_ok = true;
+  std::size_t index = 0;
+  while (index < intents.size()) {
+    const std::size_t chunk =
+        std::min<std::size_t>(intents.size() - index, kBatchMaxOrders);
+    std::vector<std::size_t> batch_slots;
+    batch_slots.reserve(chunk);
+    std::string request_items;
+    for (std::size_t i = 0; i < chunk; ++i) {
+      const OrderIntent& intent = intents[index + i];
+      if (intent.client_order_id.empty() || intent.symbol.empty() ||
+          intent.direction == 0 || intent.qty <= 0.0) {
+        all_ok = false;
+        continue;
       }
-      response = fallback_response;
-    } else {
-      LogInfo("Bybit 下单失败: client_order_id=" + intent.client_order_id +
-              ", error=" + error);
-      return false;
+      PreparedSubmit prepared;
+      if (!PrepareSubmit(intent, &prepared)) {
+        all_ok = false;
+        continue;
+      }
+      if (!request_items.empty()) {
+        request_items += ",";
+      }
+      request_items += "{" + prepared.order_fields + "}";
+      batch_slots.push_back(index + i);
     }
-  }
-  // 记录 orderId->clientOrderId 映射，解决私有回报仅携带 orderId 时的本地归一化问题。
-  if (const std::optional<JsonValue> root = ParseJsonBody(response);
-      root.has_value()) {
-    const JsonValue* result = JsonObjectField(&(*root), "result");
-    if (result != nullptr && result->type == JsonType::kObject) {
-      const std::string order_id =
-          JsonStringField(result, "orderId").value_or(std::string());
-      const std::string order_link_id =
-          JsonStringField(result, "orderLinkId")
-              .value_or(intent.client_order_id);
-      RememberOrderIdMapping(order_id, order_link_id);
+    index += chunk;
+    if (batch_slots.empty()) {
+      continue;
+    }
+
+    const std::string body = "{\"category\":\"" +
+                             EscapeJson(options_.category) +
+                             "\",\"request\":[" + request_items + "]}";
+    std::string response;
+    std::string error;
+    if (!rest_client_->PostPrivate("/v5/order/create-batch", body, &response,
+                                   &error)) {
+      LogInfo("Bybit 批量下单失败: count=" +
+              std::to_string(batch_slots.size()) + ", error=" + error);
+      all_ok = false;
+      continue;
+    }
+
+    // result.list 与 retExtInfo.list 按请求顺序对齐：逐单回填结果。
+    const std::optional<JsonValue> root = ParseJsonBody(response);
+    const JsonValue* result_list = nullptr;
+    const JsonValue* code_list = nullptr;
+    if (root.has_value()) {
+      if (const JsonValue* result = JsonObjectField(&(*root), "result");
+          result != nullptr && result->type == JsonType::kObject) {
+        result_list = JsonObjectField(result, "list");
+      }
+      if (const JsonValue* ext = JsonObjectField(&(*root), "retExtInfo");
+          ext != nullptr && ext->type == JsonType::kObject) {
+        code_list = JsonObjectField(ext, "list");
+      }
+    }
+    for (std::size_t k = 0; k < batch_slots.size(); ++k) {
+      bool order_ok = true;
+      if (code_list != nullptr && code_list->type == JsonType::kArray &&
+          k < code_list->array_value.size()) {
+        order_ok =
+            JsonIntField(&code_list->array_value[k], "code").value_or(0) == 0;
+      }
+      if (!order_ok) {
+        const std::string msg =
+            JsonStringField(&code_list->array_value[k], "msg")
+                .value_or(std::string());
+        LogInfo("Bybit 批量下单逐单失败: client_order_id=" +
+                intents[batch_slots[k]].client_order_id + ", msg=" + msg);
+        all_ok = false;
+        continue;
+      }
+      if (out_ok != nullptr) {
+        (*out_ok)[batch_slots[k]] = true;
+      }
+      if (result_list != nullptr && result_list->type == JsonType::kArray &&
+          k < result_list->array_value.size()) {
+        const JsonValue& entry = result_list->array_value[k];
+        RememberOrderIdMapping(
+            JsonStringField(&entry, "orderId").value_or(std::string()),
+            JsonStringField(&entry, "orderLinkId")
+                .value_or(intents[batch_slots[k]].client_order_id));
+      }
     }
   }
-  return true;
+  return all_ok;
 }
 
 /**
@@ -2380,6 +2629,21 @@ bool BybitExchangeAdapter::PollFill(FillEvent* out_fill) {
   return true;
 }
 
+/**
+ * @brief 拉取一条折叠后的订单状态更新
+ *
+ * 仅当成交通道为 Private WS 且链路健康时有数据；REST/Replay 通道
+ * 没有 order 主题推送，直接返回 false。
+ */
+bool BybitExchangeAdapter::PollOrderUpdate(BybitOrderUpdate* out_update) {
+  if (!connected_ || out_update == nullptr ||
+      fill_channel_ != FillChannel::kPrivateWs || private_stream_ == nullptr ||
+      !private_stream_->Healthy()) {
+    return false;
+  }
+  return private_stream_->PollOrderUpdate(out_update);
+}
+
 // 获取交易所侧净名义敞口（USD, signed），供对账快速检查使用。
 bool BybitExchangeAdapter::GetRemoteNotionalUsd(double* out_notional_usd) const {
   if (!connected_ || out_notional_usd == nullptr) {
@@ -2764,8 +3028,9 @@ bool BybitExchangeAdapter::GetSymbolInfo(const std::string& symbol,
     return false;
   }
   const std::string normalized = ToUpperCopy(symbol);
-  const auto it = symbol_trade_rules_.find(normalized);
-  if (it == symbol_trade_rules_.end()) {
+  const std::shared_ptr<const TradeRuleMap> trade_rules = TradeRules();
+  const auto it = trade_rules->find(normalized);
+  if (it == trade_rules->end()) {
     return false;
   }
 
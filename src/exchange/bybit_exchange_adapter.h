@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -49,6 +52,8 @@ struct BybitAdapterOptions {
   std::string primary_symbol{"BTCUSDT"};  ///< 主交易标的（兜底 symbol）。
   bool public_ws_enabled{true};  ///< 是否启用公共 WS 行情。
   bool public_ws_rest_fallback{true};  ///< 公共 WS 异常时是否降级 REST。
+  bool orderbook_enabled{false};  ///< 公共 WS 是否加订 orderbook 深度通道。
+  int orderbook_depth{50};  ///< orderbook 订阅档位（Bybit linear 支持 1/50）。
   bool private_ws_enabled{true};  ///< 是否启用私有 WS 成交通道。
   bool private_ws_rest_fallback{true};  ///< 私有 WS 异常时是否降级 REST。
   int ws_reconnect_interval_ms{
@@ -73,6 +78,8 @@ struct BybitAdapterOptions {
       "funding_rate_per_interval"};  ///< replay CSV 资金费列名（可缺省）。
   int replay_default_interval_ms{
       5000};  ///< replay CSV 缺失 interval 时的默认 bar 间隔。
+  int instrument_refresh_interval_s{
+      300};  ///< 交易规则后台刷新 TTL（秒，<=0 关闭后台刷新）。
   double replay_entry_fee_bps{0.0};  ///< replay Entry 成交手续费估计（bps）。
   double replay_exit_fee_bps{0.0};  ///< replay Reduce/TP/SL 成交手续费估计（bps）。
   double replay_expected_slippage_bps{0.0};  ///< replay taker 成交单侧滑点估计（bps）。
@@ -96,8 +103,12 @@ struct BybitAdapterOptions {
  */
 class BybitExchangeAdapter : public ExchangeAdapter {
  public:
+  /// symbol -> 交易规则的不可变快照（原子换代，读端无锁）。
+  using TradeRuleMap = std::unordered_map<std::string, BybitSymbolTradeRule>;
+
   explicit BybitExchangeAdapter(BybitAdapterOptions options)
       : options_(std::move(options)) {}
+  ~BybitExchangeAdapter() override;
 
   /// 返回当前通道组合名称（`bybit_ws/bybit_mixed/bybit_rest/bybit_stub`）。
   std::string Name() const override;
@@ -107,10 +118,15 @@ class BybitExchangeAdapter : public ExchangeAdapter {
   bool PollMarket(MarketEvent* out_event) override;
   /// 提交一笔订单（内部应用 symbol 规则与数量校验）。
   bool SubmitOrder(const OrderIntent& intent) override;
+  /// 批量提交订单：Live/Paper 走 `/v5/order/create-batch` 单次 wire 调用。
+  bool SubmitOrders(std::span<const OrderIntent> intents,
+                    std::vector<bool>* out_ok) override;
   /// 按 client_order_id 撤单。
   bool CancelOrder(const std::string& client_order_id) override;
   /// 拉取一条成交回报（Replay/WS/REST 统一入口）。
   bool PollFill(FillEvent* out_fill) override;
+  /// 拉取一条折叠后的订单状态更新（仅私有 WS 通道有数据）。
+  bool PollOrderUpdate(BybitOrderUpdate* out_update);
   /// 获取远端净名义敞口（USD, signed），用于快速对账。
   bool GetRemoteNotionalUsd(double* out_notional_usd) const override;
   /// 获取远端账户模式快照。
@@ -146,6 +162,16 @@ class BybitExchangeAdapter : public ExchangeAdapter {
   struct ReplayConditionalOrder {
     OrderIntent intent;
   };
+  /// 单笔订单的预构造提交载荷（字段串不含花括号与 category）。
+  struct PreparedSubmit {
+    std::string symbol;  ///< 规范化 symbol。
+    std::string order_fields;  ///< 订单 JSON 字段。
+    std::string market_fallback_fields;  ///< PostOnly 回退市价字段（可为空）。
+    std::string submit_qty_str;  ///< 量化后数量（日志用）。
+  };
+
+  /// 应用交易规则/maker 策略并构造订单 JSON 字段；拒单返回 false。
+  bool PrepareSubmit(const OrderIntent& intent, PreparedSubmit* out);
 
   /// 回放模式成交读取。
   bool PollFillFromReplay(FillEvent* out_fill);
@@ -176,6 +202,17 @@ class BybitExchangeAdapter : public ExchangeAdapter {
   /// 当前毫秒时间戳（用于重连节流）。
   static std::int64_t CurrentTimestampMs();
 
+  /// 取当前交易规则快照（下单路径与规则查询共用，读端无锁不阻塞）。
+  std::shared_ptr<const TradeRuleMap> TradeRules() const {
+    return trade_rules_snapshot_.load(std::memory_order_acquire);
+  }
+  /// 启动交易规则 TTL 后台刷新线程（replay/关闭 TTL 时不启动）。
+  void StartInstrumentRefresh();
+  /// 停止后台刷新线程（幂等，析构与重连前调用）。
+  void StopInstrumentRefresh();
+  /// 后台刷新线程主体：TTL 到期全量重拉，成功则原子换代快照。
+  void RunInstrumentRefresh();
+
   BybitAdapterOptions options_;  ///< 适配器配置快照。
   bool connected_{false};  ///< 建连状态。
   MarketChannel market_channel_{MarketChannel::kReplay};  ///< 当前行情通道。
@@ -200,13 +237,20 @@ class BybitExchangeAdapter : public ExchangeAdapter {
       last_volume_24h_by_symbol_;  ///< 每个 symbol 最近 volume24h（用于增量 volume）。
   std::vector<MarketEvent> replay_market_events_;  ///< 来自 CSV 的 replay 行情。
   std::unordered_map<std::string, double> remote_position_qty_by_symbol_;  ///< 远端仓位数量（signed）。
-  std::unordered_map<std::string, BybitSymbolTradeRule> symbol_trade_rules_;  ///< symbol 交易规则缓存。
+  /// 交易规则缓存：connect 全量加载 + 后台 TTL 刷新，原子快照换代，
+  /// 下单路径读最新快照即可，永不因规则陈旧阻塞在 REST 上。
+  std::atomic<std::shared_ptr<const TradeRuleMap>> trade_rules_snapshot_{
+      std::make_shared<const TradeRuleMap>()};
+  std::thread instrument_refresh_thread_;  ///< 规则后台刷新线程。
+  std::atomic<bool> instrument_refresh_stop_{false};  ///< 刷新线程停止标志。
   std::deque<ReplayConditionalOrder> replay_conditional_orders_;  ///< replay 条件保护单。
   std::deque<FillEvent> pending_fills_;  ///< 待消费成交队列。
   std::int64_t execution_watermark_ms_{0};  ///< execution 时间水位（去历史用）。
   bool execution_cursor_primed_{false};  ///< execution 游标是否已完成预热。
   std::int64_t last_public_ws_reconnect_attempt_ms_{
       0};  ///< 最近一次公共 WS 重连尝试时间。
+  std::int64_t public_ws_down_since_ms_{
+      0};  ///< 公共 WS 降级起点（断档时长指标用，0=未降级）。
   std::int64_t last_private_ws_reconnect_attempt_ms_{
       0};  ///< 最近一次私有 WS 重连尝试时间。
   mutable std::uint64_t open_order_diag_counter_{
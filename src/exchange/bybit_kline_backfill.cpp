@@ -0,0 +1,334 @@
+#include "exchange/bybit_kline_backfill.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <thread>
+#include <utility>
+
+#include "core/json_utils.h"
+#include "exchange/bybit_rest_client.h"
+#include "research/bar_store.h"
+
+namespace ai_trade {
+
+namespace {
+
+/// 单调毫秒时钟（预算滑窗用，墙钟回拨不影响限速）。
+std::int64_t SteadyNowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Bybit kline 列表元素全部为字符串，解析失败返回 false。
+bool ParseListNumber(const JsonValue* value, double* out) {
+  if (const auto number = JsonAsNumber(value); number.has_value()) {
+    *out = *number;
+    return true;
+  }
+  if (const auto text = JsonAsString(value); text.has_value()) {
+    try {
+      *out = std::stod(*text);
+      return true;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+BybitKlineBackfill::BybitKlineBackfill(const BybitRestClient* rest_client,
+                                       BybitKlineBackfillOptions options)
+    : rest_client_(rest_client), options_(std::move(options)) {
+  options_.page_limit = std::clamp(options_.page_limit, 1, 1000);
+  options_.concurrency = std::clamp(options_.concurrency, 1, 16);
+  options_.max_requests_per_second =
+      std::clamp(options_.max_requests_per_second, 1, 100);
+}
+
+bool BybitKlineBackfill::BackfillRange(
+    const std::string& symbol,
+    int interval_minutes,
+    std::int64_t start_ms,
+    std::int64_t end_ms,
+    std::vector<research::ResearchBar>* out_bars,
+    std::string* out_error) const {
+  if (out_bars == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "out_bars 为空";
+    }
+    return false;
+  }
+  out_bars->clear();
+  if (rest_client_ == nullptr || interval_minutes <= 0 ||
+      end_ms <= start_ms) {
+    if (out_error != nullptr) {
+      *out_error = "回补参数非法（rest_client/interval/时间段）";
+    }
+    return false;
+  }
+
+  const std::vector<std::string> symbols = {symbol};
+  const std::vector<ChunkJob> jobs =
+      BuildChunks(0, interval_minutes, start_ms, end_ms);
+  std::vector<std::vector<research::ResearchBar>> pages;
+  if (!FetchChunks(symbols, interval_minutes, jobs, &pages, out_error)) {
+    return false;
+  }
+
+  for (auto& page : pages) {
+    for (auto& bar : page) {
+      if (bar.ts_ms >= start_ms && bar.ts_ms < end_ms) {
+        out_bars->push_back(bar);
+      }
+    }
+  }
+  std::sort(out_bars->begin(), out_bars->end(),
+            [](const research::ResearchBar& lhs,
+               const research::ResearchBar& rhs) {
+              return lhs.ts_ms < rhs.ts_ms;
+            });
+  out_bars->erase(
+      std::unique(out_bars->begin(), out_bars->end(),
+                  [](const research::ResearchBar& lhs,
+                     const research::ResearchBar& rhs) {
+                    return lhs.ts_ms == rhs.ts_ms;
+                  }),
+      out_bars->end());
+  return true;
+}
+
+bool BybitKlineBackfill::BackfillSymbolsToColumnar(
+    const std::vector<std::string>& symbols,
+    int interval_minutes,
+    std::int64_t start_ms,
+    std::int64_t end_ms,
+    const std::string& out_dir,
+    std::string* out_error) const {
+  if (rest_client_ == nullptr || symbols.empty() || interval_minutes <= 0 ||
+      end_ms <= start_ms) {
+    if (out_error != nullptr) {
+      *out_error = "回补参数非法（rest_client/symbols/interval/时间段）";
+    }
+    return false;
+  }
+
+  // 全部 symbol 的块进同一个任务列表：并发度由线程池统一调度，
+  // 二十个 symbol 一天的回补与单 symbol 二十天一样整体推进。
+  std::vector<ChunkJob> jobs;
+  for (std::size_t s = 0; s < symbols.size(); ++s) {
+    const std::vector<ChunkJob> symbol_jobs =
+        BuildChunks(s, interval_minutes, start_ms, end_ms);
+    jobs.insert(jobs.end(), symbol_jobs.begin(), symbol_jobs.end());
+  }
+  std::vector<std::vector<research::ResearchBar>> pages;
+  if (!FetchChunks(symbols, interval_minutes, jobs, &pages, out_error)) {
+    return false;
+  }
+
+  std::vector<std::vector<research::ResearchBar>> by_symbol(symbols.size());
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    auto& dest = by_symbol[jobs[i].symbol_index];
+    for (auto& bar : pages[i]) {
+      if (bar.ts_ms >= start_ms && bar.ts_ms < end_ms) {
+        dest.push_back(bar);
+      }
+    }
+  }
+
+  std::error_code dir_error;
+  std::filesystem::create_directories(out_dir, dir_error);
+  for (std::size_t s = 0; s < symbols.size(); ++s) {
+    auto& bars = by_symbol[s];
+    std::sort(bars.begin(), bars.end(),
+              [](const research::ResearchBar& lhs,
+                 const research::ResearchBar& rhs) {
+                return lhs.ts_ms < rhs.ts_ms;
+              });
+    bars.erase(std::unique(bars.begin(), bars.end(),
+                           [](const research::ResearchBar& lhs,
+                              const research::ResearchBar& rhs) {
+                             return lhs.ts_ms == rhs.ts_ms;
+                           }),
+               bars.end());
+    const std::string path =
+        (std::filesystem::path(out_dir) /
+         (symbols[s] + "_" + std::to_string(interval_minutes) + "m.bin"))
+            .string();
+    if (!research::SaveResearchBarsColumnar(bars, path, out_error)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<BybitKlineBackfill::ChunkJob> BybitKlineBackfill::BuildChunks(
+    std::size_t symbol_index,
+    int interval_minutes,
+    std::int64_t start_ms,
+    std::int64_t end_ms) const {
+  // 块跨度 = interval * page_limit：单块恰好一页，一次请求拉满。
+  const std::int64_t interval_ms =
+      static_cast<std::int64_t>(interval_minutes) * 60'000;
+  const std::int64_t chunk_span =
+      interval_ms * static_cast<std::int64_t>(options_.page_limit);
+  std::vector<ChunkJob> jobs;
+  for (std::int64_t cursor = start_ms; cursor < end_ms; cursor += chunk_span) {
+    jobs.push_back(ChunkJob{
+        .symbol_index = symbol_index,
+        .start_ms = cursor,
+        .end_ms = std::min(cursor + chunk_span, end_ms),
+    });
+  }
+  return jobs;
+}
+
+bool BybitKlineBackfill::FetchChunks(
+    const std::vector<std::string>& symbols,
+    int interval_minutes,
+    const std::vector<ChunkJob>& jobs,
+    std::vector<std::vector<research::ResearchBar>>* out_pages,
+    std::string* out_error) const {
+  out_pages->assign(jobs.size(), {});
+  if (jobs.empty()) {
+    return true;
+  }
+
+  // 每个块有独立结果槽位，工作线程只写自己认领的槽，无需结果锁。
+  std::atomic<std::size_t> next_job{0};
+  std::atomic<bool> failed{false};
+  std::mutex error_mutex;
+  std::string first_error;
+
+  const std::size_t worker_count = std::min(
+      static_cast<std::size_t>(options_.concurrency), jobs.size());
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (std::size_t w = 0; w < worker_count; ++w) {
+    workers.emplace_back([&] {
+      while (!failed.load(std::memory_order_acquire)) {
+        const std::size_t index =
+            next_job.fetch_add(1, std::memory_order_relaxed);
+        if (index >= jobs.size()) {
+          return;
+        }
+        const ChunkJob& job = jobs[index];
+        std::string fetch_error;
+        if (!FetchPage(symbols[job.symbol_index], interval_minutes,
+                       job.start_ms, job.end_ms, &(*out_pages)[index],
+                       &fetch_error)) {
+          // 首个错误生效：部分回补会留下隐性断档，整体报错重来。
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!failed.exchange(true, std::memory_order_acq_rel)) {
+            first_error = symbols[job.symbol_index] + " [" +
+                          std::to_string(job.start_ms) + ", " +
+                          std::to_string(job.end_ms) + "): " + fetch_error;
+          }
+          return;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  if (failed.load(std::memory_order_acquire)) {
+    if (out_error != nullptr) {
+      *out_error = "K 线回补失败: " + first_error;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool BybitKlineBackfill::FetchPage(
+    const std::string& symbol,
+    int interval_minutes,
+    std::int64_t start_ms,
+    std::int64_t end_ms,
+    std::vector<research::ResearchBar>* out_bars,
+    std::string* out_error) const {
+  AcquireBudgetSlot();
+
+  // end 参数为闭区间：减 1ms 保持块间半开不重叠。
+  const std::string query =
+      "category=" + options_.category + "&symbol=" + symbol +
+      "&interval=" + std::to_string(interval_minutes) +
+      "&start=" + std::to_string(start_ms) +
+      "&end=" + std::to_string(end_ms - 1) +
+      "&limit=" + std::to_string(options_.page_limit);
+  std::string body;
+  if (!rest_client_->GetPublic("/v5/market/kline", query, &body, out_error)) {
+    return false;
+  }
+
+  JsonValue root;
+  std::string parse_error;
+  if (!ParseJson(body, &root, &parse_error)) {
+    if (out_error != nullptr) {
+      *out_error = "kline 响应解析失败: " + parse_error;
+    }
+    return false;
+  }
+  const JsonValue* list = JsonFindPath(&root, {"result", "list"});
+  if (list == nullptr || list->type != JsonType::kArray) {
+    if (out_error != nullptr) {
+      *out_error = "kline 响应缺少 result.list";
+    }
+    return false;
+  }
+
+  out_bars->clear();
+  out_bars->reserve(list->array_value.size());
+  for (const JsonValue& row : list->array_value) {
+    double ts = 0.0;
+    research::ResearchBar bar;
+    if (!ParseListNumber(JsonArrayAt(&row, 0), &ts) ||
+        !ParseListNumber(JsonArrayAt(&row, 1), &bar.open) ||
+        !ParseListNumber(JsonArrayAt(&row, 2), &bar.high) ||
+        !ParseListNumber(JsonArrayAt(&row, 3), &bar.low) ||
+        !ParseListNumber(JsonArrayAt(&row, 4), &bar.close) ||
+        !ParseListNumber(JsonArrayAt(&row, 5), &bar.volume)) {
+      if (out_error != nullptr) {
+        *out_error = "kline 行字段解析失败";
+      }
+      return false;
+    }
+    bar.ts_ms = static_cast<std::int64_t>(ts);
+    out_bars->push_back(bar);
+  }
+  // Bybit 返回按时间倒序；统一为升序方便调用方合并。
+  std::reverse(out_bars->begin(), out_bars->end());
+  return true;
+}
+
+void BybitKlineBackfill::AcquireBudgetSlot() const {
+  // 按秒滑窗限速：窗口内请求数达到预算时等到最老一笔滑出再发。
+  while (true) {
+    std::int64_t wait_ms = 0;
+    {
+      std::lock_guard<std::mutex> lock(budget_mutex_);
+      const std::int64_t now_ms = SteadyNowMs();
+      while (!budget_window_ms_.empty() &&
+             now_ms - budget_window_ms_.front() >= 1000) {
+        budget_window_ms_.pop_front();
+      }
+      if (budget_window_ms_.size() <
+          static_cast<std::size_t>(options_.max_requests_per_second)) {
+        budget_window_ms_.push_back(now_ms);
+        return;
+      }
+      wait_ms = 1000 - (now_ms - budget_window_ms_.front());
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(std::max<std::int64_t>(wait_ms, 1)));
+  }
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "research/miner.h"
+
+namespace ai_trade {
+
+class BybitRestClient;
+
+/// 回补任务参数（页对齐分块 + 并发抓取 + API 预算限速）。
+struct BybitKlineBackfillOptions {
+  std::string category{"linear"};  ///< Bybit V5 产品类别。
+  int page_limit{1000};  ///< 单页 K 线根数（V5 kline 接口上限）。
+  int concurrency{4};  ///< 并发抓取线程数（复用传输层暖连接池）。
+  int max_requests_per_second{8};  ///< 全局 API 预算（按秒滑窗计数）。
+};
+
+/**
+ * @brief Bybit K 线并发回补引擎
+ *
+ * 断档回补此前走 tools/gap_fill_klines.py：单线程顺序翻页，补一天
+ * 二十个 symbol 要二十分钟量级。本引擎把 (symbol, interval, 时间段)
+ * 切成页对齐的块（块跨度 = interval * page_limit，单块一次请求拉满
+ * 一页），由固定线程池并发抓取：连接复用交给传输层暖连接池，请求
+ * 速率由按秒滑窗的 API 预算限速器兜底，避免并发把公共接口配额打穿。
+ * 结果直接落成研究栈消费的 ATCBAR1 列式文件，不再经 CSV 中转。
+ *
+ * 任一块失败即整体失败（部分回补会留下隐性断档，比失败更危险）；
+ * 结果按 ts 排序并去重，块边界重叠或交易所返回冗余页都不会产生
+ * 重复样本。
+ */
+class BybitKlineBackfill {
+ public:
+  /// @param rest_client REST 客户端，生命周期由外部管理（不持有所有权）。
+  explicit BybitKlineBackfill(const BybitRestClient* rest_client,
+                              BybitKlineBackfillOptions options = {});
+
+  /// 回补单 symbol 时间段 [start_ms, end_ms)，结果按 ts 升序去重。
+  bool BackfillRange(const std::string& symbol,
+                     int interval_minutes,
+                     std::int64_t start_ms,
+                     std::int64_t end_ms,
+                     std::vector<research::ResearchBar>* out_bars,
+                     std::string* out_error) const;
+
+  /// 回补多 symbol 同一时间段并落盘列式文件：
+  /// `<out_dir>/<symbol>_<interval>m.bin`（全部 symbol 的块共享
+  /// 同一线程池与 API 预算，整体并发推进）。
+  bool BackfillSymbolsToColumnar(const std::vector<std::string>& symbols,
+                                 int interval_minutes,
+                                 std::int64_t start_ms,
+                                 std::int64_t end_ms,
+                                 const std::string& out_dir,
+                                 std::string* out_error) const;
+
+ private:
+  /// 单块抓取任务：symbol 下标 + 半开时间段。
+  struct ChunkJob {
+    std::size_t symbol_index{0};
+    std::int64_t start_ms{0};
+    std::int64_t end_ms{0};
+  };
+
+  /// 并发执行全部块任务；`out_pages` 与 `jobs` 一一对应（块内升序）。
+  bool FetchChunks(const std::vector<std::string>& symbols,
+                   int interval_minutes,
+                   const std::vector<ChunkJob>& jobs,
+                   std::vector<std::vector<research::ResearchBar>>* out_pages,
+                   std::string* out_error) const;
+
+  /// 拉取并解析单页 K 线（返回的 bars 已按 ts 升序）。
+  bool FetchPage(const std::string& symbol,
+                 int interval_minutes,
+                 std::int64_t start_ms,
+                 std::int64_t end_ms,
+                 std::vector<research::ResearchBar>* out_bars,
+                 std::string* out_error) const;
+
+  /// 阻塞直到 API 预算滑窗内有空位（全部工作线程共享）。
+  void AcquireBudgetSlot() const;
+
+  /// 按 [start_ms, end_ms) 切页对齐块。
+  std::vector<ChunkJob> BuildChunks(std::size_t symbol_index,
+                                    int interval_minutes,
+                                    std::int64_t start_ms,
+                                    std::int64_t end_ms) const;
+
+  const BybitRestClient* rest_client_{nullptr};  ///< 外部注入（不拥有）。
+  BybitKlineBackfillOptions options_;
+
+  mutable std::mutex budget_mutex_;  ///< 保护预算滑窗。
+  mutable std::deque<std::int64_t> budget_window_ms_;  ///< 最近请求时刻。
+};
+
+}  // namespace ai_trade
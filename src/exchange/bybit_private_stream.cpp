@@ -4,11 +4,13 @@
 #include <chrono>
 #include <cctype>
 #include <optional>
+#include <string_view>
 #include <thread>
 #include <utility>
 
 #include "core/json_utils.h"
 #include "exchange/bybit_rest_client.h"
+#include "monitor/metrics_registry.h"
 
 namespace ai_trade {
 
@@ -25,50 +27,50 @@ std::string ToUpperCopy(const std::string& text) {
   return out;
 }
 
-std::optional<double> JsonNumberField(const JsonValue* object,
-                                      const std::string& key) {
-  const JsonValue* field = JsonObjectField(object, key);
-  if (field == nullptr) {
+std::optional<double> ViewNumberField(const JsonView& object,
+                                      std::string_view key) {
+  JsonView field;
+  if (!JsonViewObjectField(object, key, &field)) {
     return std::nullopt;
   }
-  return JsonAsNumber(field);
+  return JsonViewAsNumber(field);
 }
 
-std::optional<std::string> JsonStringField(const JsonValue* object,
-                                           const std::string& key) {
-  const JsonValue* field = JsonObjectField(object, key);
-  if (field == nullptr) {
+std::optional<std::string> ViewStringField(const JsonView& object,
+                                           std::string_view key) {
+  JsonView field;
+  if (!JsonViewObjectField(object, key, &field)) {
     return std::nullopt;
   }
-  return JsonAsString(field);
+  return JsonViewAsString(field);
 }
 
-std::optional<std::string> JsonNonEmptyStringField(const JsonValue* object,
-                                                   const std::string& key) {
-  auto value = JsonStringField(object, key);
+std::optional<std::string> ViewNonEmptyStringField(const JsonView& object,
+                                                   std::string_view key) {
+  auto value = ViewStringField(object, key);
   if (!value.has_value() || value->empty()) {
     return std::nullopt;
   }
   return value;
 }
 
-FillLiquidity ParseFillLiquidity(const JsonValue* object) {
-  if (object == nullptr || object->type != JsonType::kObject) {
+FillLiquidity ParseFillLiquidity(const JsonView& object) {
+  JsonView maker_field;
+  if (object.type != JsonType::kObject ||
+      !JsonViewObjectField(object, "isMaker", &maker_field)) {
     return FillLiquidity::kUnknown;
   }
-  const JsonValue* maker_field = JsonObjectField(object, "isMaker");
-  if (maker_field == nullptr) {
-    return FillLiquidity::kUnknown;
-  }
-  if (const auto maker = JsonAsBool(maker_field); maker.has_value()) {
+  if (const auto maker = JsonViewAsBool(maker_field); maker.has_value()) {
     return *maker ? FillLiquidity::kMaker : FillLiquidity::kTaker;
   }
-  if (const auto maker_number = JsonAsNumber(maker_field);
-      maker_number.has_value()) {
-    return *maker_number != 0.0 ? FillLiquidity::kMaker
-                                : FillLiquidity::kTaker;
+  if (maker_field.type == JsonType::kNumber) {
+    if (const auto maker_number = JsonViewAsNumber(maker_field);
+        maker_number.has_value()) {
+      return *maker_number != 0.0 ? FillLiquidity::kMaker
+                                  : FillLiquidity::kTaker;
+    }
   }
-  if (const auto maker_text = JsonAsString(maker_field);
+  if (const auto maker_text = JsonViewAsString(maker_field);
       maker_text.has_value()) {
     const std::string normalized = ToUpperCopy(*maker_text);
     if (normalized == "TRUE" || normalized == "1") {
@@ -93,6 +95,14 @@ std::string EscapeJson(const std::string& raw) {
   return out;
 }
 
+/// 撤改单风暴观测口径：每覆盖一条未消费的订单中间态计数一次。
+void RecordOrderUpdateConflated() {
+  static MetricCounter* counter = MetricsRegistry::Instance().RegisterCounter(
+      "ai_trade_order_update_conflated_total",
+      "私有流按订单折叠掉的 order 中间态帧数");
+  counter->Inc();
+}
+
 bool IsAckSuccess(const JsonValue& root) {
   const auto success = JsonAsBool(JsonObjectField(&root, "success"));
   if (success.has_value()) {
@@ -128,6 +138,8 @@ bool BybitPrivateStream::Connect(std::string* out_error) {
   last_error_.clear();
   pending_fills_.clear();
   seen_exec_ids_.clear();
+  order_update_slots_.clear();
+  dirty_order_ids_.clear();
 
   if (!options_.enabled) {
     last_error_ = "private ws disabled by config";
@@ -243,7 +255,32 @@ bool BybitPrivateStream::PollExecution(FillEvent* out_fill) {
   if (DrainPending(out_fill)) {
     return true;
   }
+  if (!PumpSocketOnce()) {
+    return false;
+  }
+  return DrainPending(out_fill);
+}
+
+/**
+ * @brief 拉取一条折叠后的订单更新
+ *
+ * 撤改单风暴期间同一订单的中间态在槽位里互相覆盖，这里按脏单入队
+ * 顺序每个订单只吐出最新一帧；脏单队列为空时拉取一条 WS 消息再重试。
+ */
+bool BybitPrivateStream::PollOrderUpdate(BybitOrderUpdate* out_update) {
+  if (out_update == nullptr) {
+    return false;
+  }
+  if (DrainOrderUpdate(out_update)) {
+    return true;
+  }
+  if (!Healthy() || !PumpSocketOnce()) {
+    return false;
+  }
+  return DrainOrderUpdate(out_update);
+}
 
+bool BybitPrivateStream::PumpSocketOnce() {
   const std::int64_t now_ms = CurrentTimestampMs();
   // 定时 ping，维持链路活性并尽快感知断链。
   if (options_.heartbeat_interval_ms > 0 &&
@@ -268,7 +305,7 @@ bool BybitPrivateStream::PollExecution(FillEvent* out_fill) {
   }
 
   ParseMessage(message);
-  return DrainPending(out_fill);
+  return true;
 }
 
 bool BybitPrivateStream::DrainPending(FillEvent* out_fill) {
@@ -280,6 +317,22 @@ bool BybitPrivateStream::DrainPending(FillEvent* out_fill) {
   return true;
 }
 
+bool BybitPrivateStream::DrainOrderUpdate(BybitOrderUpdate* out_update) {
+  while (!dirty_order_ids_.empty()) {
+    const std::string order_id = std::move(dirty_order_ids_.front());
+    dirty_order_ids_.pop_front();
+    const auto it = order_update_slots_.find(order_id);
+    if (it == order_update_slots_.end() || !it->second.dirty) {
+      continue;
+    }
+    *out_update = it->second.update;
+    it->second.dirty = false;
+    it->second.update.conflated_count = 0;
+    return true;
+  }
+  return false;
+}
+
 bool BybitPrivateStream::WaitForAck(const std::string& expected_op,
                                     int timeout_ms,
                                     std::string* out_error) {
@@ -336,49 +389,57 @@ bool BybitPrivateStream::WaitForAck(const std::string& expected_op,
 }
 
 bool BybitPrivateStream::ParseMessage(const std::string& message) {
-  // 解析策略：先处理控制帧（ping/pong/auth/subscribe），再处理 execution 业务消息。
-  JsonValue root;
+  // 热路径零拷贝解析：不构建 DOM 节点，按需从原文切片抽取少数字段。
+  // 先处理控制帧（ping/pong/auth/subscribe），再处理 execution 业务消息。
+  JsonView root;
   std::string parse_error;
-  if (!ParseJson(message, &root, &parse_error)) {
+  if (!ParseJsonView(message, &root, &parse_error)) {
     return false;
   }
 
-  const auto op = JsonAsString(JsonObjectField(&root, "op"));
-  if (op.has_value()) {
-    if (*op == "ping") {
+  JsonView op_view;
+  if (JsonViewObjectField(root, "op", &op_view)) {
+    if (JsonViewStringEquals(op_view, "ping")) {
       std::string pong_error;
       ws_client_->SendText("{\"op\":\"pong\"}", &pong_error);
       return true;
     }
-    if (*op == "pong" || *op == "auth" || *op == "subscribe") {
+    if (JsonViewStringEquals(op_view, "pong") ||
+        JsonViewStringEquals(op_view, "auth") ||
+        JsonViewStringEquals(op_view, "subscribe")) {
       return true;
     }
   }
 
-  const auto topic = JsonAsString(JsonObjectField(&root, "topic"));
+  const auto topic = ViewStringField(root, "topic");
   if (!topic.has_value()) {
     return false;
   }
-  if (topic->rfind("execution", 0) != 0) {
-    return true;
+  if (topic->rfind("execution", 0) == 0) {
+    JsonView data;
+    if (!JsonViewObjectField(root, "data", &data)) {
+      return false;
+    }
+    return ParseExecutionPayload(data);
   }
-
-  const JsonValue* data = JsonObjectField(&root, "data");
-  return ParseExecutionPayload(data);
-}
-
-bool BybitPrivateStream::ParseExecutionPayload(const JsonValue* data) {
-  if (data == nullptr) {
-    return false;
+  if (topic->rfind("order", 0) == 0) {
+    JsonView data;
+    if (!JsonViewObjectField(root, "data", &data)) {
+      return false;
+    }
+    return ParseOrderPayload(data);
   }
+  return true;
+}
 
-  auto consume = [&](const JsonValue* item) {
-    if (item == nullptr || item->type != JsonType::kObject) {
+bool BybitPrivateStream::ParseExecutionPayload(const JsonView& data) {
+  auto consume = [&](const JsonView& item) {
+    if (item.type != JsonType::kObject) {
       return;
     }
 
     const std::string exec_id =
-        JsonStringField(item, "execId").value_or(std::string());
+        ViewStringField(item, "execId").value_or(std::string());
     if (exec_id.empty()) {
       return;
     }
@@ -387,10 +448,10 @@ bool BybitPrivateStream::ParseExecutionPayload(const JsonValue* data) {
       return;
     }
 
-    const std::string side = JsonStringField(item, "side").value_or(std::string());
+    const std::string side = ViewStringField(item, "side").value_or(std::string());
     const int direction = SideToDirection(side);
-    const double qty = JsonNumberField(item, "execQty").value_or(0.0);
-    const double price = JsonNumberField(item, "execPrice").value_or(0.0);
+    const double qty = ViewNumberField(item, "execQty").value_or(0.0);
+    const double price = ViewNumberField(item, "execPrice").value_or(0.0);
     if (direction == 0 || qty <= 0.0 || price <= 0.0) {
       return;
     }
@@ -398,25 +459,84 @@ bool BybitPrivateStream::ParseExecutionPayload(const JsonValue* data) {
     FillEvent fill;
     fill.fill_id = exec_id;
     fill.client_order_id =
-        JsonNonEmptyStringField(item, "orderLinkId")
-            .value_or(JsonNonEmptyStringField(item, "orderId")
+        ViewNonEmptyStringField(item, "orderLinkId")
+            .value_or(ViewNonEmptyStringField(item, "orderId")
                           .value_or(std::string()));
-    fill.symbol = JsonStringField(item, "symbol").value_or("BTCUSDT");
+    fill.symbol = ViewStringField(item, "symbol").value_or("BTCUSDT");
     fill.direction = direction;
     fill.qty = qty;
     fill.price = price;
-    fill.fee = JsonNumberField(item, "execFee").value_or(0.0);
+    fill.fee = ViewNumberField(item, "execFee").value_or(0.0);
     fill.liquidity = ParseFillLiquidity(item);
     pending_fills_.push_back(std::move(fill));
   };
 
-  if (data->type == JsonType::kObject) {
+  if (data.type == JsonType::kObject) {
+    consume(data);
+    return true;
+  }
+  if (data.type == JsonType::kArray) {
+    std::size_t cursor = 0;
+    JsonView item;
+    while (JsonViewArrayNext(data, &cursor, &item)) {
+      consume(item);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool BybitPrivateStream::ParseOrderPayload(const JsonView& data) {
+  auto consume = [&](const JsonView& item) {
+    if (item.type != JsonType::kObject) {
+      return;
+    }
+
+    const std::string order_id =
+        ViewNonEmptyStringField(item, "orderLinkId")
+            .value_or(ViewNonEmptyStringField(item, "orderId")
+                          .value_or(std::string()));
+    if (order_id.empty()) {
+      return;
+    }
+
+    // 最新态覆盖写入槽位：同一订单被撤改单风暴重推时，未消费的
+    // 中间态直接丢弃，只累计折叠帧数供观测。
+    OrderUpdateSlot& slot = order_update_slots_[order_id];
+    const std::int64_t folded =
+        slot.dirty ? slot.update.conflated_count : 0;
+    BybitOrderUpdate& update = slot.update;
+    update.client_order_id = order_id;
+    if (const auto symbol = ViewNonEmptyStringField(item, "symbol");
+        symbol.has_value()) {
+      update.symbol = *symbol;
+    }
+    update.order_status =
+        ViewStringField(item, "orderStatus").value_or(std::string());
+    update.cum_exec_qty = ViewNumberField(item, "cumExecQty").value_or(0.0);
+    update.leaves_qty = ViewNumberField(item, "leavesQty").value_or(0.0);
+    update.avg_price = ViewNumberField(item, "avgPrice").value_or(0.0);
+    update.updated_ts_ms = static_cast<std::int64_t>(
+        ViewNumberField(item, "updatedTime").value_or(0.0));
+    update.conflated_count = folded + 1;
+
+    if (!slot.dirty) {
+      slot.dirty = true;
+      dirty_order_ids_.push_back(order_id);
+    } else {
+      RecordOrderUpdateConflated();
+    }
+  };
+
+  if (data.type == JsonType::kObject) {
     consume(data);
     return true;
   }
-  if (data->type == JsonType::kArray) {
-    for (const auto& item : data->array_value) {
-      consume(&item);
+  if (data.type == JsonType::kArray) {
+    std::size_t cursor = 0;
+    JsonView item;
+    while (JsonViewArrayNext(data, &cursor, &item)) {
+      consume(item);
     }
     return true;
   }
@@ -4,6 +4,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "core/types.h"
@@ -11,7 +12,7 @@
 
 namespace ai_trade {
 
-struct JsonValue;
+struct JsonView;
 
 /// Bybit 私有 WS 配置（成交/订单/仓位/钱包通道）。
 struct BybitPrivateStreamOptions {
@@ -25,13 +26,27 @@ struct BybitPrivateStreamOptions {
   int heartbeat_interval_ms{20000};
 };
 
+/// 私有流 `order` 主题的折叠后订单状态（每个订单只保留最新一帧）。
+struct BybitOrderUpdate {
+  std::string client_order_id;     ///< orderLinkId，缺失时回退 orderId。
+  std::string symbol{"BTCUSDT"};   ///< 订单标的。
+  std::string order_status;        ///< Bybit 原文状态（New/Filled/Cancelled...）。
+  double cum_exec_qty{0.0};        ///< 累计成交数量。
+  double leaves_qty{0.0};          ///< 剩余挂单数量。
+  double avg_price{0.0};           ///< 累计成交均价。
+  std::int64_t updated_ts_ms{0};   ///< 交易所 updatedTime（毫秒）。
+  std::int64_t conflated_count{0}; ///< 自上次消费以来折叠进本槽位的原始帧数。
+};
+
 /**
  * @brief Bybit 私有成交流
  *
  * 负责：
  * 1. 私有 WS 鉴权与主题订阅；
  * 2. 解析 execution 并映射为标准 `FillEvent`；
- * 3. 执行去重、心跳和健康状态维护。
+ * 3. 将 `order` 主题按订单折叠为最新状态槽位（撤改单风暴下中间态
+ *    直接覆盖，消费侧只看到每个订单的终态，收敛成本与订单数成正比）；
+ * 4. 执行去重、心跳和健康状态维护。
  */
 class BybitPrivateStream {
  public:
@@ -52,22 +67,42 @@ class BybitPrivateStream {
    */
   bool PollExecution(FillEvent* out_fill);
 
+  /**
+   * @brief 轮询一条折叠后的订单更新
+   *
+   * 行为：先按脏单队列顺序吐出各订单的最新状态；脏单队列为空时
+   * 拉取一条 WS 消息再重试。同一订单的多条中间态只会产出最后一帧。
+   */
+  bool PollOrderUpdate(BybitOrderUpdate* out_update);
+
   /// 返回当前私有链路健康状态（连接已建立且底层 WS 仍在线）。
   bool Healthy() const;
 
   const std::string& last_error() const { return last_error_; }
 
  private:
+  /// 单个订单的最新状态槽位：dirty 表示自上次消费后有新帧落入。
+  struct OrderUpdateSlot {
+    BybitOrderUpdate update;
+    bool dirty{false};
+  };
+
   /// 先消费内部 pending 队列，再返回单条成交。
   bool DrainPending(FillEvent* out_fill);
+  /// 按脏单队列顺序吐出一条折叠后的订单状态。
+  bool DrainOrderUpdate(BybitOrderUpdate* out_update);
+  /// 心跳 + 拉取并解析一条 WS 消息；返回是否消费到消息。
+  bool PumpSocketOnce();
   /// 等待指定 `op` 的 ACK（auth/subscribe）。
   bool WaitForAck(const std::string& expected_op,
                   int timeout_ms,
                   std::string* out_error);
   /// 解析单条 WS 消息（控制帧 + 业务帧）。
   bool ParseMessage(const std::string& message);
-  /// 解析 execution payload 并写入 pending 队列。
-  bool ParseExecutionPayload(const JsonValue* data);
+  /// 解析 execution payload（零拷贝视图）并写入 pending 队列。
+  bool ParseExecutionPayload(const JsonView& data);
+  /// 解析 order payload（零拷贝视图）并折叠进槽位表。
+  bool ParseOrderPayload(const JsonView& data);
 
   /// 根据环境组合生成私有 WS URL。
   static std::string BuildPrivateUrl(bool testnet, bool demo_trading);
@@ -85,6 +120,9 @@ class BybitPrivateStream {
   std::string last_error_;  ///< 最近一次错误描述。
   std::deque<FillEvent> pending_fills_;  ///< 已解析待消费的成交队列。
   std::unordered_set<std::string> seen_exec_ids_;  ///< 成交去重集合（execId）。
+  std::unordered_map<std::string, OrderUpdateSlot>
+      order_update_slots_;  ///< 按订单折叠的最新状态表。
+  std::deque<std::string> dirty_order_ids_;  ///< 待消费脏单队列（入队顺序）。
   std::int64_t last_ping_ts_ms_{0};  ///< 最近一次发送 ping 的时间戳。
 };
 
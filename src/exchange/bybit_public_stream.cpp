@@ -1,14 +1,15 @@
 #include "exchange/bybit_public_stream.h"
 
 #include <algorithm>
+#include <charconv>
 #include <chrono>
 #include <cctype>
 #include <cmath>
 #include <deque>
-#include <exception>
 #include <limits>
 #include <optional>
 #include <sstream>
+#include <string_view>
 #include <thread>
 #include <unordered_set>
 #include <utility>
@@ -20,6 +21,10 @@ namespace ai_trade {
 
 namespace {
 
+/// MarketEvent.book_imbalance 的统计档数：顶部几档足以刻画短期压力，
+/// 又不被深处的挂撤噪声稀释。
+constexpr int kImbalanceLevels = 5;
+
 std::string Trim(const std::string& text) {
   std::size_t begin = 0;
   while (begin < text.size() &&
@@ -45,41 +50,31 @@ std::string ToUpperCopy(const std::string& text) {
   return out;
 }
 
-std::optional<double> JsonNumberField(const JsonValue* object,
-                                      const std::string& key) {
-  const JsonValue* field = JsonObjectField(object, key);
-  if (field == nullptr) {
+std::optional<double> ViewNumberField(const JsonView& object,
+                                      std::string_view key) {
+  JsonView field;
+  if (!JsonViewObjectField(object, key, &field)) {
     return std::nullopt;
   }
-  return JsonAsNumber(field);
+  return JsonViewAsNumber(field);
 }
 
-std::optional<std::string> JsonStringField(const JsonValue* object,
-                                           const std::string& key) {
-  const JsonValue* field = JsonObjectField(object, key);
-  if (field == nullptr) {
+std::optional<std::string> ViewStringField(const JsonView& object,
+                                           std::string_view key) {
+  JsonView field;
+  if (!JsonViewObjectField(object, key, &field)) {
     return std::nullopt;
   }
-  return JsonAsString(field);
+  return JsonViewAsString(field);
 }
 
-std::optional<std::int64_t> JsonInt64Field(const JsonValue* object,
-                                           const std::string& key) {
-  const JsonValue* field = JsonObjectField(object, key);
-  if (field == nullptr) {
+std::optional<std::int64_t> ViewInt64Field(const JsonView& object,
+                                           std::string_view key) {
+  JsonView field;
+  if (!JsonViewObjectField(object, key, &field)) {
     return std::nullopt;
   }
-  if (const auto number = JsonAsNumber(field); number.has_value()) {
-    return static_cast<std::int64_t>(*number);
-  }
-  if (const auto text = JsonAsString(field); text.has_value()) {
-    try {
-      return std::stoll(*text);
-    } catch (const std::exception&) {
-      return std::nullopt;
-    }
-  }
-  return std::nullopt;
+  return JsonViewAsInt64(field);
 }
 
 std::string EscapeJson(const std::string& raw) {
@@ -121,12 +116,77 @@ std::string TopicToSymbol(const std::string& topic) {
   return topic.substr(kPrefix.size());
 }
 
+// ---- 首字节扫描读取器（专用于 Bybit 实发的紧凑 JSON 形状） ----
+// 约定：键以 "key":" / "key": 的紧凑写法出现；带空白或转义的载荷
+// 由调用方回退通用解析，这里只需返回"未命中"。
+
+/// 定位 "key":"value" 的值切片；缺失、空值或含转义时返回空视图。
+std::string_view ScanQuotedField(std::string_view payload,
+                                 std::string_view quoted_key) {
+  const std::size_t pos = payload.find(quoted_key);
+  if (pos == std::string_view::npos) {
+    return {};
+  }
+  const std::size_t begin = pos + quoted_key.size();
+  const std::size_t end = payload.find('"', begin);
+  if (end == std::string_view::npos) {
+    return {};
+  }
+  const std::string_view value = payload.substr(begin, end - begin);
+  if (value.find('\\') != std::string_view::npos) {
+    return {};
+  }
+  return value;
+}
+
+/// 解析 "key":"123.4" 形式的字符串编码数值。
+std::optional<double> ScanQuotedNumber(std::string_view payload,
+                                       std::string_view quoted_key) {
+  const std::string_view value = ScanQuotedField(payload, quoted_key);
+  if (value.empty()) {
+    return std::nullopt;
+  }
+  double out = 0.0;
+  const auto result =
+      std::from_chars(value.data(), value.data() + value.size(), out);
+  if (result.ec != std::errc{} || result.ptr != value.data() + value.size()) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+/// 解析 "key":123 形式的裸整数（key_colon 形如 "\"ts\":"）。
+std::optional<std::int64_t> ScanInt64Field(std::string_view payload,
+                                           std::string_view key_colon) {
+  const std::size_t pos = payload.find(key_colon);
+  if (pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+  const char* begin = payload.data() + pos + key_colon.size();
+  const char* end = payload.data() + payload.size();
+  std::int64_t out = 0;
+  const auto result = std::from_chars(begin, end, out);
+  if (result.ec != std::errc{} || result.ptr == begin) {
+    return std::nullopt;
+  }
+  return out;
+}
+
 }  // namespace
 
 BybitPublicStream::BybitPublicStream(BybitPublicStreamOptions options,
                                      std::unique_ptr<WebsocketClient> ws_client)
     : options_(std::move(options)),
-      ws_client_(std::move(ws_client)) {}
+      ws_client_(std::move(ws_client)) {
+  options_.symbols = NormalizeSymbols(options_.symbols);
+  // 订单簿在构造期一次建齐：此后 map 结构只读，ReadTopOfBook 可在
+  // 任意线程查表而无需与重连路径互斥。
+  if (options_.orderbook_enabled) {
+    for (const auto& symbol : options_.symbols) {
+      order_books_.emplace(symbol, std::make_unique<FixedDepthOrderBook>());
+    }
+  }
+}
 
 /**
  * @brief 建立公共 WS 连接并完成订阅握手
@@ -142,10 +202,14 @@ bool BybitPublicStream::Connect(std::string* out_error) {
   last_error_.clear();
   pending_events_.clear();
   seq_ = 0;
+  subscribe_ack_deadline_ms_ = 0;
   last_event_ts_ms_by_symbol_.clear();
   last_volume_24h_by_symbol_.clear();
-
-  options_.symbols = NormalizeSymbols(options_.symbols);
+  // 重连只清簿内容不动 map：断链期间的增量缺口由新 snapshot 重新锚定。
+  for (auto& [symbol, book] : order_books_) {
+    (void)symbol;
+    book->Reset();
+  }
 
   if (!options_.enabled) {
     last_error_ = "public ws disabled by config";
@@ -173,19 +237,27 @@ bool BybitPublicStream::Connect(std::string* out_error) {
     return false;
   }
 
-  std::string args;
-  for (std::size_t i = 0; i < options_.symbols.size(); ++i) {
-    if (i > 0U) {
-      args += ",";
+  // 订阅帧只序列化一次：symbol 集合连接期不变，重连直接复用缓存。
+  if (subscribe_payload_.empty()) {
+    std::string args;
+    for (std::size_t i = 0; i < options_.symbols.size(); ++i) {
+      if (i > 0U) {
+        args += ",";
+      }
+      args += "\"tickers." + EscapeJson(options_.symbols[i]) + "\"";
     }
-    args += "\"tickers." + EscapeJson(options_.symbols[i]) + "\"";
+    if (options_.orderbook_enabled) {
+      const std::string depth = std::to_string(options_.orderbook_depth);
+      for (const auto& symbol : options_.symbols) {
+        args += ",\"orderbook." + depth + "." + EscapeJson(symbol) + "\"";
+      }
+    }
+    // 单连接可批量订阅多个 symbol 的 ticker/orderbook 主题（单帧订阅）。
+    subscribe_payload_ = "{\"op\":\"subscribe\",\"args\":[" + args + "]}";
   }
-  // 单连接可订阅多个 symbol 的 ticker 主题。
-  const std::string subscribe_payload =
-      "{\"op\":\"subscribe\",\"args\":[" + args + "]}";
 
   std::string send_error;
-  if (!ws_client_->SendText(subscribe_payload, &send_error)) {
+  if (!ws_client_->SendText(subscribe_payload_, &send_error)) {
     MarkBroken(send_error.empty() ? "public ws subscribe send failed" : send_error);
     if (out_error != nullptr) {
       *out_error = last_error_;
@@ -193,11 +265,24 @@ bool BybitPublicStream::Connect(std::string* out_error) {
     return false;
   }
 
+  if (subscribed_once_) {
+    // 重连快路径：订阅参数已被首连验证过，ACK 改为异步收集
+    // （ParseMessage 顺带消化），行情处理立即恢复，不再阻塞等待。
+    // 截止时间内未确认或被拒由 PollTicker 按断链处理，重走降级。
+    subscribe_ack_deadline_ms_ =
+        CurrentTimestampMs() +
+        static_cast<std::int64_t>(std::max(500, options_.ack_timeout_ms));
+    connected_ = true;
+    last_ping_ts_ms_ = CurrentTimestampMs();
+    return true;
+  }
+
   if (!WaitForSubscribeAck(out_error)) {
     MarkBroken(last_error_);
     return false;
   }
 
+  subscribed_once_ = true;
   connected_ = true;
   last_ping_ts_ms_ = CurrentTimestampMs();
   return true;
@@ -216,6 +301,12 @@ bool BybitPublicStream::PollTicker(MarketEvent* out_event) {
   if (out_event == nullptr || !Healthy()) {
     return false;
   }
+  // 异步 ACK 超时视为订阅失败：断链让适配器重走降级/重连。
+  if (subscribe_ack_deadline_ms_ > 0 &&
+      CurrentTimestampMs() > subscribe_ack_deadline_ms_) {
+    MarkBroken("public ws subscribe ack timeout");
+    return false;
+  }
   if (DrainPending(out_event)) {
     return true;
   }
@@ -232,9 +323,10 @@ bool BybitPublicStream::PollTicker(MarketEvent* out_event) {
     last_ping_ts_ms_ = now_ms;
   }
 
-  std::string message;
+  // 批量排空：波动期 Bybit 会突发推送多条 ticker，一次取完避免
+  // 每条消息一次轮询往返；切片直接借用复用缓冲，无逐帧分配。
   std::string poll_error;
-  const WsPollStatus status = ws_client_->PollText(&message, &poll_error);
+  const WsPollStatus status = ws_client_->PollBatch(&ws_batch_, &poll_error);
   if (status == WsPollStatus::kNoMessage) {
     return false;
   }
@@ -243,7 +335,9 @@ bool BybitPublicStream::PollTicker(MarketEvent* out_event) {
     return false;
   }
 
-  ParseMessage(message);
+  for (const std::string_view frame : ws_batch_.frames) {
+    ParseMessage(frame);
+  }
   return DrainPending(out_event);
 }
 
@@ -313,27 +407,120 @@ bool BybitPublicStream::WaitForSubscribeAck(std::string* out_error) {
   return false;
 }
 
-bool BybitPublicStream::ParseMessage(const std::string& message) {
-  // 解析策略：先处理控制帧（ping/pong/subscribe），再处理业务 topic。
-  JsonValue root;
+bool BybitPublicStream::ParseMessage(std::string_view message) {
+  // 路由顺序：控制帧首字节扫描 -> ticker 专用读取器 -> 通用解析。
+  // 前两级不建 DOM、不产生临时字符串，是 tick-to-trade 路径的固定成本。
+  if (message.find("\"op\":") != std::string_view::npos) {
+    if (message.find("\"op\":\"ping\"") != std::string_view::npos) {
+      std::string pong_error;
+      ws_client_->SendText("{\"op\":\"pong\"}", &pong_error);
+      return true;
+    }
+    if (message.find("\"op\":\"subscribe\"") != std::string_view::npos) {
+      // 异步 ACK 收集：被拒按断链处理，成功清掉待确认截止时间。
+      if (message.find("\"success\":false") != std::string_view::npos) {
+        MarkBroken("public ws subscribe rejected");
+      } else {
+        subscribe_ack_deadline_ms_ = 0;
+      }
+      return true;
+    }
+    if (message.find("\"op\":\"pong\"") != std::string_view::npos) {
+      return true;
+    }
+  }
+  if (!order_books_.empty() &&
+      message.find("\"topic\":\"orderbook.") != std::string_view::npos) {
+    return ParseOrderBookMessage(message);
+  }
+  if (ParseTickerFast(message)) {
+    return true;
+  }
+  return ParseMessageGeneral(message);
+}
+
+bool BybitPublicStream::ParseTickerFast(std::string_view message) {
+  // topic 前缀路由：未命中 tickers. 主题即交给通用解析。
+  static constexpr std::string_view kTopicKey = "\"topic\":\"tickers.";
+  const std::size_t topic_pos = message.find(kTopicKey);
+  if (topic_pos == std::string_view::npos) {
+    return false;
+  }
+  const std::size_t symbol_begin = topic_pos + kTopicKey.size();
+  const std::size_t symbol_end = message.find('"', symbol_begin);
+  if (symbol_end == std::string_view::npos || symbol_end == symbol_begin) {
+    return false;
+  }
+  const std::string_view topic_symbol =
+      message.substr(symbol_begin, symbol_end - symbol_begin);
+
+  const std::size_t data_pos = message.find("\"data\":", symbol_end);
+  if (data_pos == std::string_view::npos) {
+    return false;
+  }
+  const std::size_t body_begin = data_pos + 7;
+  if (body_begin >= message.size() || message[body_begin] != '{') {
+    return false;  // data 为数组等少见形状交给通用解析。
+  }
+  // data 终点无需精确闭合：专用键不会出现在后续兄弟字段里。
+  const std::string_view data = message.substr(body_begin);
+
+  const std::optional<double> last_price =
+      ScanQuotedNumber(data, "\"lastPrice\":\"");
+  if (!last_price.has_value()) {
+    return false;  // 缺价格视为未识别形状，由通用解析兜底判定。
+  }
+  if (*last_price <= 0.0) {
+    return true;  // 与通用路径一致：无有效价格不产出事件。
+  }
+  const double mark_price =
+      ScanQuotedNumber(data, "\"markPrice\":\"").value_or(*last_price);
+  const double volume_24h =
+      ScanQuotedNumber(data, "\"volume24h\":\"").value_or(0.0);
+  const double funding_rate_8h =
+      ScanQuotedNumber(data, "\"fundingRate\":\"")
+          .value_or(std::numeric_limits<double>::quiet_NaN());
+  const std::string_view symbol_field = ScanQuotedField(data, "\"symbol\":\"");
+  const std::string_view symbol =
+      symbol_field.empty() ? topic_symbol : symbol_field;
+
+  // ts 优先取 data 内字段；Bybit 根级 ts 位置不定，miss 时全文补扫。
+  std::int64_t event_ts_ms = ScanInt64Field(data, "\"ts\":").value_or(0);
+  if (event_ts_ms <= 0) {
+    event_ts_ms = ScanInt64Field(message, "\"ts\":").value_or(0);
+  }
+  if (event_ts_ms <= 0) {
+    event_ts_ms = CurrentTimestampMs();
+  }
+
+  AppendTickerEvent(symbol, *last_price, mark_price, volume_24h,
+                    funding_rate_8h, event_ts_ms);
+  return true;
+}
+
+bool BybitPublicStream::ParseMessageGeneral(std::string_view message) {
+  // 通用零拷贝解析：不构建 DOM 节点，按需从原文切片抽取少数字段。
+  // 先处理控制帧（ping/pong/subscribe），再处理业务 topic。
+  JsonView root;
   std::string parse_error;
-  if (!ParseJson(message, &root, &parse_error)) {
+  if (!ParseJsonView(message, &root, &parse_error)) {
     return false;
   }
 
-  const auto op = JsonAsString(JsonObjectField(&root, "op"));
-  if (op.has_value()) {
-    if (*op == "ping") {
+  JsonView op_view;
+  if (JsonViewObjectField(root, "op", &op_view)) {
+    if (JsonViewStringEquals(op_view, "ping")) {
       std::string pong_error;
       ws_client_->SendText("{\"op\":\"pong\"}", &pong_error);
       return true;
     }
-    if (*op == "pong" || *op == "subscribe") {
+    if (JsonViewStringEquals(op_view, "pong") ||
+        JsonViewStringEquals(op_view, "subscribe")) {
       return true;
     }
   }
 
-  const auto topic = JsonAsString(JsonObjectField(&root, "topic"));
+  const auto topic = ViewStringField(root, "topic");
   if (!topic.has_value()) {
     return false;
   }
@@ -342,102 +529,220 @@ bool BybitPublicStream::ParseMessage(const std::string& message) {
     return false;
   }
 
-  const JsonValue* data = JsonObjectField(&root, "data");
-  if (data == nullptr) {
+  JsonView data;
+  if (!JsonViewObjectField(root, "data", &data)) {
     return false;
   }
 
-  auto append_event = [&](const JsonValue* item) {
-    if (item == nullptr || item->type != JsonType::kObject) {
+  auto append_event = [&](const JsonView& item) {
+    if (item.type != JsonType::kObject) {
       return;
     }
     const std::string symbol =
-        JsonStringField(item, "symbol").value_or(topic_symbol);
-    const double last_price = JsonNumberField(item, "lastPrice").value_or(0.0);
+        ViewStringField(item, "symbol").value_or(topic_symbol);
+    const double last_price = ViewNumberField(item, "lastPrice").value_or(0.0);
     if (last_price <= 0.0) {
       return;
     }
     const double mark_price =
-        JsonNumberField(item, "markPrice").value_or(last_price);
-    const double volume_24h = JsonNumberField(item, "volume24h").value_or(0.0);
+        ViewNumberField(item, "markPrice").value_or(last_price);
+    const double volume_24h = ViewNumberField(item, "volume24h").value_or(0.0);
     const double funding_rate_8h =
-        JsonNumberField(item, "fundingRate")
+        ViewNumberField(item, "fundingRate")
             .value_or(std::numeric_limits<double>::quiet_NaN());
 
     std::int64_t event_ts_ms = 0;
-    if (const auto row_ts = JsonInt64Field(item, "ts"); row_ts.has_value()) {
+    if (const auto row_ts = ViewInt64Field(item, "ts"); row_ts.has_value()) {
       event_ts_ms = *row_ts;
-    } else if (const auto root_ts = JsonInt64Field(&root, "ts");
+    } else if (const auto root_ts = ViewInt64Field(root, "ts");
                root_ts.has_value()) {
       event_ts_ms = *root_ts;
     }
     if (event_ts_ms <= 0) {
       event_ts_ms = CurrentTimestampMs();
     }
-    std::int64_t interval_ms = 0;
-    const auto ts_it = last_event_ts_ms_by_symbol_.find(symbol);
-    if (ts_it != last_event_ts_ms_by_symbol_.end() &&
-        event_ts_ms > ts_it->second) {
-      interval_ms = event_ts_ms - ts_it->second;
+    AppendTickerEvent(symbol, last_price, mark_price, volume_24h,
+                      funding_rate_8h, event_ts_ms);
+  };
+
+  if (data.type == JsonType::kObject) {
+    append_event(data);
+    return true;
+  }
+  if (data.type == JsonType::kArray) {
+    std::size_t cursor = 0;
+    JsonView item;
+    while (JsonViewArrayNext(data, &cursor, &item)) {
+      append_event(item);
     }
-    last_event_ts_ms_by_symbol_[symbol] = event_ts_ms;
-
-    double interval_volume = 0.0;
-    const auto volume_it = last_volume_24h_by_symbol_.find(symbol);
-    if (std::isfinite(volume_24h) && volume_24h >= 0.0) {
-      // volume24h 为滚动 24h 指标，不保证单调递增：
-      // 1) 若单调上升，优先使用差分估算区间成交量；
-      // 2) 若回落或跳变，回退到按 24h 均速折算，避免长时间被错误压成 0。
-      constexpr double kOneDayMs = 24.0 * 60.0 * 60.0 * 1000.0;
-      if (volume_it != last_volume_24h_by_symbol_.end() &&
-          std::isfinite(volume_it->second)) {
-        if (volume_24h >= volume_it->second) {
-          interval_volume = volume_24h - volume_it->second;
-        } else if (interval_ms > 0) {
-          interval_volume =
-              std::max(0.0, volume_24h) *
-              (static_cast<double>(interval_ms) / kOneDayMs);
-        }
+    return true;
+  }
+  return false;
+}
+
+bool BybitPublicStream::ParseOrderBookMessage(std::string_view message) {
+  // orderbook 频率远低于 ticker 的毫秒级突发且形状更复杂，
+  // 直接走 JsonView 零拷贝路径，不做专用字节扫描。
+  JsonView root;
+  std::string parse_error;
+  if (!ParseJsonView(message, &root, &parse_error)) {
+    return false;
+  }
+  const auto type = ViewStringField(root, "type");
+  if (!type.has_value() || (*type != "snapshot" && *type != "delta")) {
+    return false;
+  }
+  JsonView data;
+  if (!JsonViewObjectField(root, "data", &data) ||
+      data.type != JsonType::kObject) {
+    return false;
+  }
+  const auto symbol = ViewStringField(data, "s");
+  if (!symbol.has_value()) {
+    return false;
+  }
+  const auto book_it = order_books_.find(*symbol);
+  if (book_it == order_books_.end()) {
+    return true;  // 非关注 symbol 的簿消息：确认消化，不再回退通用解析。
+  }
+  FixedDepthOrderBook& book = *book_it->second;
+
+  const std::int64_t update_id = ViewInt64Field(data, "u").value_or(0);
+  std::int64_t event_ts_ms = ViewInt64Field(root, "ts").value_or(0);
+  if (event_ts_ms <= 0) {
+    event_ts_ms = CurrentTimestampMs();
+  }
+  if (!book.Begin(event_ts_ms, update_id, *type == "snapshot")) {
+    return true;  // 乱序/未锚定 delta：按协议丢弃，等 snapshot 重建。
+  }
+  // Begin 成功后必须走到 Commit：档位解析失败只跳过该档，不提前返回。
+  const auto apply_side = [&data, &book](std::string_view key, bool is_bid) {
+    JsonView levels;
+    if (!JsonViewObjectField(data, key, &levels) ||
+        levels.type != JsonType::kArray) {
+      return;
+    }
+    std::size_t cursor = 0;
+    JsonView level;
+    while (JsonViewArrayNext(levels, &cursor, &level)) {
+      if (level.type != JsonType::kArray) {
+        continue;
+      }
+      std::size_t field_cursor = 0;
+      JsonView price_view;
+      JsonView qty_view;
+      if (!JsonViewArrayNext(level, &field_cursor, &price_view) ||
+          !JsonViewArrayNext(level, &field_cursor, &qty_view)) {
+        continue;
+      }
+      const auto price = JsonViewAsNumber(price_view);
+      const auto qty = JsonViewAsNumber(qty_view);
+      if (!price.has_value() || !qty.has_value()) {
+        continue;
+      }
+      if (is_bid) {
+        book.SetBid(*price, *qty);
+      } else {
+        book.SetAsk(*price, *qty);
+      }
+    }
+  };
+  apply_side("b", /*is_bid=*/true);
+  apply_side("a", /*is_bid=*/false);
+  book.Commit();
+  return true;
+}
+
+bool BybitPublicStream::ReadTopOfBook(const std::string& symbol,
+                                      double* out_best_bid,
+                                      double* out_best_ask) const {
+  const auto book_it = order_books_.find(symbol);
+  if (book_it == order_books_.end()) {
+    return false;
+  }
+  OrderBookSnapshot snapshot;
+  if (!book_it->second->ReadSnapshot(&snapshot) || !snapshot.valid()) {
+    return false;
+  }
+  if (out_best_bid != nullptr) {
+    *out_best_bid = snapshot.best_bid();
+  }
+  if (out_best_ask != nullptr) {
+    *out_best_ask = snapshot.best_ask();
+  }
+  return true;
+}
+
+void BybitPublicStream::AppendTickerEvent(std::string_view symbol_view,
+                                          double last_price,
+                                          double mark_price,
+                                          double volume_24h,
+                                          double funding_rate_8h,
+                                          std::int64_t event_ts_ms) {
+  // 常见合约符号命中 SSO，此处的 string 构造不触发堆分配。
+  const std::string symbol(symbol_view);
+  std::int64_t interval_ms = 0;
+  const auto ts_it = last_event_ts_ms_by_symbol_.find(symbol);
+  if (ts_it != last_event_ts_ms_by_symbol_.end() &&
+      event_ts_ms > ts_it->second) {
+    interval_ms = event_ts_ms - ts_it->second;
+  }
+  last_event_ts_ms_by_symbol_[symbol] = event_ts_ms;
+
+  double interval_volume = 0.0;
+  const auto volume_it = last_volume_24h_by_symbol_.find(symbol);
+  if (std::isfinite(volume_24h) && volume_24h >= 0.0) {
+    // volume24h 为滚动 24h 指标，不保证单调递增：
+    // 1) 若单调上升，优先使用差分估算区间成交量；
+    // 2) 若回落或跳变，回退到按 24h 均速折算，避免长时间被错误压成 0。
+    constexpr double kOneDayMs = 24.0 * 60.0 * 60.0 * 1000.0;
+    if (volume_it != last_volume_24h_by_symbol_.end() &&
+        std::isfinite(volume_it->second)) {
+      if (volume_24h >= volume_it->second) {
+        interval_volume = volume_24h - volume_it->second;
       } else if (interval_ms > 0) {
         interval_volume =
             std::max(0.0, volume_24h) *
             (static_cast<double>(interval_ms) / kOneDayMs);
       }
-      last_volume_24h_by_symbol_[symbol] = volume_24h;
+    } else if (interval_ms > 0) {
+      interval_volume =
+          std::max(0.0, volume_24h) *
+          (static_cast<double>(interval_ms) / kOneDayMs);
     }
-
-    ++seq_;
-    double funding_rate_per_interval =
-        std::numeric_limits<double>::quiet_NaN();
-    if (std::isfinite(funding_rate_8h) && interval_ms > 0) {
-      constexpr double kEightHoursMs = 8.0 * 60.0 * 60.0 * 1000.0;
-      funding_rate_per_interval =
-          funding_rate_8h *
-          (static_cast<double>(interval_ms) / kEightHoursMs);
-    }
-    // volume 统一口径为“该事件间隔内的增量成交量”，避免把 24h 累计值喂给在线特征。
-    pending_events_.push_back(MarketEvent{
-        event_ts_ms,
-        symbol,
-        last_price,
-        mark_price,
-        std::max(0.0, interval_volume),
-        interval_ms,
-        funding_rate_per_interval,
-    });
+    last_volume_24h_by_symbol_[symbol] = volume_24h;
+  }
+
+  ++seq_;
+  double funding_rate_per_interval =
+      std::numeric_limits<double>::quiet_NaN();
+  if (std::isfinite(funding_rate_8h) && interval_ms > 0) {
+    constexpr double kEightHoursMs = 8.0 * 60.0 * 60.0 * 1000.0;
+    funding_rate_per_interval =
+        funding_rate_8h *
+        (static_cast<double>(interval_ms) / kEightHoursMs);
+  }
+  // volume 统一口径为“该事件间隔内的增量成交量”，避免把 24h 累计值喂给在线特征。
+  MarketEvent event{
+      event_ts_ms,
+      symbol,
+      last_price,
+      mark_price,
+      std::max(0.0, interval_volume),
+      interval_ms,
+      funding_rate_per_interval,
   };
-
-  if (data->type == JsonType::kObject) {
-    append_event(data);
-    return true;
-  }
-  if (data->type == JsonType::kArray) {
-    for (const auto& item : data->array_value) {
-      append_event(&item);
+  // 订单簿顶档随 ticker 事件带出：簿维护与本函数同在解析线程，
+  // 直读即可，无需 seqlock 拷贝。
+  if (!order_books_.empty()) {
+    const auto book_it = order_books_.find(symbol);
+    if (book_it != order_books_.end() && book_it->second->anchored()) {
+      event.best_bid = book_it->second->best_bid();
+      event.best_ask = book_it->second->best_ask();
+      event.book_imbalance = book_it->second->ImbalanceTop(kImbalanceLevels);
     }
-    return true;
   }
-  return false;
+  pending_events_.push_back(std::move(event));
 }
 
 void BybitPublicStream::MarkBroken(const std::string& error_message) {
@@ -4,11 +4,13 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "core/types.h"
 #include "exchange/websocket_client.h"
+#include "market/order_book.h"
 
 namespace ai_trade {
 
@@ -20,14 +22,16 @@ struct BybitPublicStreamOptions {
   std::vector<std::string> symbols{"BTCUSDT"};
   int ack_timeout_ms{2500};
   int heartbeat_interval_ms{20000};
+  bool orderbook_enabled{false};  ///< 是否加订 orderbook 深度通道。
+  int orderbook_depth{50};  ///< orderbook 档位（Bybit linear 支持 1/50）。
 };
 
 /**
  * @brief Bybit 公共行情流
  *
  * 负责：
- * 1. 建立公共 WS 并订阅 `tickers`；
- * 2. 将原始消息解析为统一 `MarketEvent`；
+ * 1. 建立公共 WS 并订阅 `tickers`（可选加订 `orderbook`）；
+ * 2. 将原始消息解析为统一 `MarketEvent`，订单簿增量维护进定长簿；
  * 3. 维护心跳与连接健康状态。
  */
 class BybitPublicStream {
@@ -52,6 +56,16 @@ class BybitPublicStream {
   /// 返回当前链路健康状态（连接已建立且底层 WS 仍在线）。
   bool Healthy() const;
 
+  /**
+   * @brief 读取 symbol 订单簿顶档（任意线程，seqlock 一致性读）
+   *
+   * orderbook 通道未启用或簿未锚定时返回 false；执行侧用它给
+   * maker 被动单定价（贴 best bid/ask 排队且不穿越对手价）。
+   */
+  bool ReadTopOfBook(const std::string& symbol,
+                     double* out_best_bid,
+                     double* out_best_ask) const;
+
   const std::string& last_error() const { return last_error_; }
 
  private:
@@ -59,8 +73,22 @@ class BybitPublicStream {
   bool DrainPending(MarketEvent* out_event);
   /// 等待 subscribe ACK。
   bool WaitForSubscribeAck(std::string* out_error);
-  /// 解析单条 WS 消息（控制帧 + ticker 业务帧）。
-  bool ParseMessage(const std::string& message);
+  /// 解析单条 WS 消息：首字节扫描路由，失配时回退通用解析。
+  bool ParseMessage(std::string_view message);
+  /// Bybit 实发 ticker 形状的专用读取器（无 DOM、无临时字符串）。
+  /// 返回 false 表示形状不匹配，调用方回退通用解析。
+  bool ParseTickerFast(std::string_view message);
+  /// 通用解析路径（JsonView 按需切片），处理未识别形状的载荷。
+  bool ParseMessageGeneral(std::string_view message);
+  /// 解析 orderbook 主题消息并增量应用到对应 symbol 的定长簿。
+  bool ParseOrderBookMessage(std::string_view message);
+  /// 按统一口径（interval/增量 volume/折算 funding）构造并入队行情事件。
+  void AppendTickerEvent(std::string_view symbol,
+                         double last_price,
+                         double mark_price,
+                         double volume_24h,
+                         double funding_rate_8h,
+                         std::int64_t event_ts_ms);
 
   /// 标记链路损坏并主动关闭底层连接。
   void MarkBroken(const std::string& error_message);
@@ -73,14 +101,24 @@ class BybitPublicStream {
   BybitPublicStreamOptions options_;  ///< 公共流配置快照。
   std::unique_ptr<WebsocketClient> ws_client_;  ///< 底层 WS 客户端。
   bool connected_{false};  ///< 当前连接状态。
+  std::string subscribe_payload_;  ///< 预序列化订阅帧（重连快路径复用）。
+  bool subscribed_once_{false};  ///< 首次订阅是否已完成同步 ACK 校验。
+  /// 异步 ACK 截止时间（0 = 无待确认订阅）：重连快路径立即恢复行情
+  /// 处理，ACK 在 ParseMessage 里顺带收集；超时或被拒按断链处理。
+  std::int64_t subscribe_ack_deadline_ms_{0};
   std::string last_error_;  ///< 最近一次错误描述。
   std::deque<MarketEvent> pending_events_;  ///< 已解析待消费行情队列。
+  WsFrameBatch ws_batch_;  ///< PollBatch 复用帧缓冲（避免逐帧分配）。
   std::int64_t seq_{0};  ///< 本地生成的行情序号。
   std::int64_t last_ping_ts_ms_{0};  ///< 最近一次发送 ping 的时间戳。
   std::unordered_map<std::string, std::int64_t>
       last_event_ts_ms_by_symbol_;  ///< 每个 symbol 最近事件时间（用于 interval）。
   std::unordered_map<std::string, double>
       last_volume_24h_by_symbol_;  ///< 每个 symbol 最近 volume24h（用于增量 volume）。
+  /// symbol -> 定长订单簿。构造期一次建齐后只读结构（重连仅 Reset 内容），
+  /// 读端跨线程持有的簿指针始终有效，查表无需加锁。
+  std::unordered_map<std::string, std::unique_ptr<FixedDepthOrderBook>>
+      order_books_;
 };
 
 }  // namespace ai_trade
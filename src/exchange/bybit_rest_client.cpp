@@ -14,12 +14,64 @@
 
 #include <curl/curl.h>
 
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+
 #include "core/json_utils.h"
+#include "monitor/metrics_registry.h"
 
 namespace ai_trade {
 
 namespace {
 
+/// 空闲句柄池容量上限：对齐执行通道并发量级，超出的句柄直接销毁。
+constexpr std::size_t kMaxPooledHandles = 8;
+
+/// DNS 解析缓存时长（秒）：句柄内复用，避免每请求一次解析。
+constexpr long kDnsCacheSeconds = 300;
+
+/// 从完整 URL 提取 path（去 scheme/host/query），供 endpoint 级指标命名。
+std::string ExtractUrlPath(const std::string& url) {
+  std::size_t host_begin = url.find("://");
+  host_begin = (host_begin == std::string::npos) ? 0 : host_begin + 3;
+  const std::size_t path_begin = url.find('/', host_begin);
+  if (path_begin == std::string::npos) {
+    return "/";
+  }
+  const std::size_t query_begin = url.find('?', path_begin);
+  return url.substr(path_begin, query_begin == std::string::npos
+                                    ? std::string::npos
+                                    : query_begin - path_begin);
+}
+
+/// 按 endpoint 记录 REST 往返延迟（首个请求注册，之后查缓存直达）。
+void RecordEndpointLatency(const std::string& path, std::int64_t nanos) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, MetricHistogram*> by_path;
+  MetricHistogram* hist = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = by_path.find(path);
+    if (it == by_path.end()) {
+      std::string name = "ai_trade_rest_latency" + path;
+      for (char& c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c)) == 0) {
+          c = '_';
+        }
+      }
+      hist = MetricsRegistry::Instance().RegisterHistogram(
+          name, "Bybit REST 往返延迟（endpoint: " + path + "）");
+      by_path.emplace(path, hist);
+    } else {
+      hist = it->second;
+    }
+  }
+  if (hist != nullptr) {
+    hist->Record(nanos);
+  }
+}
+
 std::string BytesToHex(const unsigned char* bytes, std::size_t size) {
   static constexpr char kHex[] = "0123456789abcdef";
   std::string out;
@@ -49,6 +101,58 @@ std::size_t WriteToString(char* ptr, std::size_t size, std::size_t nmemb,
 
 }  // namespace
 
+CurlBybitHttpTransport::~CurlBybitHttpTransport() {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  for (void* handle : pool_) {
+    curl_easy_cleanup(static_cast<CURL*>(handle));
+  }
+  pool_.clear();
+}
+
+void* CurlBybitHttpTransport::AcquireHandle() const {
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!pool_.empty()) {
+      void* handle = pool_.back();
+      pool_.pop_back();
+      return handle;
+    }
+  }
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    return nullptr;
+  }
+  // 连接生命周期配置只在新建时设置一次，随句柄跨请求生效：
+  // keep-alive 保持 TCP 连接驻留，HTTP/2（TLS 协商到则用）允许同
+  // 连接多路复用，DNS 缓存免去逐请求解析。
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 30L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 15L);
+  curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, kDnsCacheSeconds);
+  curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, 5000L);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 10000L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "ai-trade/0.1");
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+  return curl;
+}
+
+void CurlBybitHttpTransport::ReleaseHandle(void* handle, bool healthy) const {
+  if (handle == nullptr) {
+    return;
+  }
+  if (healthy) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (pool_.size() < kMaxPooledHandles) {
+      pool_.push_back(handle);
+      return;
+    }
+  }
+  curl_easy_cleanup(static_cast<CURL*>(handle));
+}
+
 BybitHttpResponse CurlBybitHttpTransport::Send(
     const std::string& method,
     const std::string& url,
@@ -65,7 +169,7 @@ BybitHttpResponse CurlBybitHttpTransport::Send(
     return out;
   }
 
-  CURL* curl = curl_easy_init();
+  CURL* curl = static_cast<CURL*>(AcquireHandle());
   if (curl == nullptr) {
     out.error = "curl_easy_init 失败";
     return out;
@@ -79,16 +183,10 @@ BybitHttpResponse CurlBybitHttpTransport::Send(
   std::string response_body;
   char curl_error[CURL_ERROR_SIZE] = {0};
   curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
-  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, 5000L);
-  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 10000L);
   curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
   curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteToString);
   curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
   curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curl_error);
-  curl_easy_setopt(curl, CURLOPT_USERAGENT, "ai-trade/0.1");
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
 
   const bool is_post = method == "POST";
   if (is_post) {
@@ -97,10 +195,14 @@ BybitHttpResponse CurlBybitHttpTransport::Send(
     curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
                      static_cast<long>(body.size()));
   } else {
+    // 复用句柄可能上一轮是 POST：清掉 CUSTOMREQUEST 再切回 GET。
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, nullptr);
     curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
   }
 
+  const auto started = std::chrono::steady_clock::now();
   const CURLcode code = curl_easy_perform(curl);
+  const auto elapsed = std::chrono::steady_clock::now() - started;
   long status_code = 0;
   curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
 
@@ -111,9 +213,13 @@ BybitHttpResponse CurlBybitHttpTransport::Send(
         (curl_error[0] != '\0') ? std::string(curl_error) : CurlCodeToString(code);
     out.error = "curl_easy_perform 失败: " + detailed;
   }
+  RecordEndpointLatency(
+      ExtractUrlPath(url),
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
 
   curl_slist_free_all(header_list);
-  curl_easy_cleanup(curl);
+  // 传输层报错说明连接已不可信（超时/断链/握手失败），销毁重建。
+  ReleaseHandle(curl, code == CURLE_OK);
   return out;
 }
 
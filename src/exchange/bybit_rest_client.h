@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,14 +32,36 @@ class BybitHttpTransport {
       const std::string& body) const = 0;
 };
 
+/**
+ * @brief libcurl 传输实现（带暖连接池）
+ *
+ * 每次请求新建句柄意味着每单都付一次 TLS+TCP 握手（数十毫秒），
+ * 恰好落在下单/撤单最敏感的路径上。本实现维护一个空闲句柄池：
+ * 句柄内的 keep-alive 连接与 DNS 缓存跨请求复用，首次之后的请求
+ * 直接在暖连接上收发；传输层报错的句柄视为连接不可信，直接销毁
+ * 不回池（健康检查式复用）。池有锁但只护住取还两步，多执行通道
+ * 并发请求时各自持有独立句柄收发。
+ */
 class CurlBybitHttpTransport final : public BybitHttpTransport {
  public:
-  /// 使用 libcurl 发送 HTTP 请求。
+  CurlBybitHttpTransport() = default;
+  ~CurlBybitHttpTransport() override;
+
+  /// 使用 libcurl 发送 HTTP 请求（句柄取自暖连接池）。
   BybitHttpResponse Send(
       const std::string& method,
       const std::string& url,
       const std::vector<std::pair<std::string, std::string>>& headers,
       const std::string& body) const override;
+
+ private:
+  /// 取出空闲暖句柄，池空时新建并配置 keep-alive/HTTP2/DNS 缓存。
+  void* AcquireHandle() const;
+  /// 归还句柄：健康的回池（容量封顶），不健康的销毁让下次重建连接。
+  void ReleaseHandle(void* handle, bool healthy) const;
+
+  mutable std::mutex pool_mutex_;  ///< 仅保护句柄池取还。
+  mutable std::vector<void*> pool_;  ///< 空闲句柄（void* 以隔离 curl 头依赖）。
 };
 
 /**
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -32,6 +33,30 @@ class ExchangeAdapter {
   /// @brief 提交订单意图到交易所。
   virtual bool SubmitOrder(const OrderIntent& intent) = 0;
 
+  /**
+   * @brief 批量提交订单意图
+   *
+   * `out_ok` 与 `intents` 按下标一一对应，记录每笔是否提交成功；
+   * 返回值为“是否全部成功”。默认实现逐单回退到 `SubmitOrder`，
+   * 支持批量端点的适配器（如 Bybit create-batch）应覆写为单次
+   * wire 调用。
+   */
+  virtual bool SubmitOrders(std::span<const OrderIntent> intents,
+                            std::vector<bool>* out_ok) {
+    bool all_ok = true;
+    if (out_ok != nullptr) {
+      out_ok->assign(intents.size(), false);
+    }
+    for (std::size_t i = 0; i < intents.size(); ++i) {
+      const bool ok = SubmitOrder(intents[i]);
+      if (out_ok != nullptr) {
+        (*out_ok)[i] = ok;
+      }
+      all_ok = all_ok && ok;
+    }
+    return all_ok;
+  }
+
   /// @brief 按 client_order_id 撤单。
   virtual bool CancelOrder(const std::string& client_order_id) = 0;
 
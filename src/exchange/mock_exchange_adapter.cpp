@@ -1,9 +1,24 @@
 #include "exchange/mock_exchange_adapter.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <random>
+
+#include "monitor/metrics_registry.h"
 
 namespace ai_trade {
 
+namespace {
+
+std::int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
 bool MockExchangeAdapter::Connect() {
   if (symbols_.empty()) {
     symbols_.push_back("BTCUSDT");
@@ -14,7 +29,38 @@ bool MockExchangeAdapter::Connect() {
 }
 
 bool MockExchangeAdapter::PollMarket(MarketEvent* out_event) {
-  if (!connected_ || out_event == nullptr || cursor_ >= prices_.size()) {
+  if (!connected_ || out_event == nullptr) {
+    return false;
+  }
+
+  if (stress_mode_) {
+    if (stress_cursor_ >= stress_events_.size()) {
+      return false;
+    }
+    // 相邻 poll 间隔直方图：量化消费侧的真实服务节奏。
+    const std::int64_t now_ns = SteadyNowNs();
+    if (stress_poll_gap_hist_ != nullptr && last_stress_poll_ns_ > 0) {
+      stress_poll_gap_hist_->Record(now_ns - last_stress_poll_ns_);
+    }
+    last_stress_poll_ns_ = now_ns;
+
+    // 预生成数组按游标取用：每事件只付一次拷贝，无生成开销。
+    *out_event = stress_events_[stress_cursor_++];
+    last_price_by_symbol_[out_event->symbol] = out_event->price;
+    ++stress_stats_.market_events_served;
+
+    // 按场景节奏把预生成成交注入 pending 队列（模拟异步回报）。
+    if (stress_scenario_.fill_every > 0 &&
+        stress_cursor_ % stress_scenario_.fill_every == 0 &&
+        stress_fill_cursor_ < stress_fills_.size()) {
+      pending_fills_.push_back(stress_fills_[stress_fill_cursor_++]);
+      ++stress_stats_.fills_injected;
+      NotePendingFillDepth();
+    }
+    return true;
+  }
+
+  if (cursor_ >= prices_.size()) {
     return false;
   }
 
@@ -70,6 +116,7 @@ bool MockExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
   second.price = intent.price;
   pending_fills_.push_back(second);
 
+  NotePendingFillDepth();
   return true;
 }
 
@@ -205,4 +252,88 @@ bool MockExchangeAdapter::GetSymbolInfo(const std::string& symbol,
   return true;
 }
 
+void MockExchangeAdapter::NotePendingFillDepth() {
+  stress_stats_.max_pending_fill_depth =
+      std::max(stress_stats_.max_pending_fill_depth, pending_fills_.size());
+}
+
+/**
+ * @brief 预生成压测事件流
+ *
+ * 生成规则：
+ * - 时间轴：突发内相邻事件间隔 1ms，突发之间插入 `gap_ms` 空洞；
+ * - symbol：按构造时的 symbol 列表轮转交织；
+ * - 价格：每 symbol 独立随机游走（`price_jitter_pct` 抖动上限）；
+ * - 成交：每 `fill_every` 条行情预生成一笔小额成交（方向交替），
+ *   运行期按同样节奏注入 pending 队列，模拟异步回报压力。
+ */
+void MockExchangeAdapter::PreloadStressScenario(
+    const MockStressScenario& scenario) {
+  if (symbols_.empty()) {
+    symbols_.push_back("BTCUSDT");
+  }
+  stress_scenario_ = scenario;
+  stress_events_.clear();
+  stress_fills_.clear();
+  stress_cursor_ = 0;
+  stress_fill_cursor_ = 0;
+  last_stress_poll_ns_ = 0;
+  stress_stats_ = MockStressStats{};
+
+  std::mt19937_64 rng(scenario.seed);
+  std::uniform_real_distribution<double> jitter(-scenario.price_jitter_pct,
+                                                scenario.price_jitter_pct);
+  std::vector<double> price_by_symbol(symbols_.size(), scenario.base_price);
+  std::vector<std::int64_t> last_ts_by_symbol(symbols_.size(), 0);
+  const std::size_t burst_size = std::max<std::size_t>(1, scenario.burst_size);
+  const std::int64_t gap_ms = std::max<std::int64_t>(1, scenario.gap_ms);
+
+  stress_events_.reserve(scenario.total_events);
+  if (scenario.fill_every > 0) {
+    stress_fills_.reserve(scenario.total_events / scenario.fill_every + 1);
+  }
+
+  std::int64_t ts_ms = 0;
+  for (std::size_t i = 0; i < scenario.total_events; ++i) {
+    ts_ms += (i > 0 && i % burst_size == 0) ? gap_ms : 1;
+    const std::size_t symbol_index = i % symbols_.size();
+    const std::string& symbol = symbols_[symbol_index];
+
+    double& price = price_by_symbol[symbol_index];
+    price = std::max(1e-9, price * (1.0 + jitter(rng)));
+
+    const std::int64_t last_ts = last_ts_by_symbol[symbol_index];
+    const std::int64_t interval_ms = (last_ts > 0) ? (ts_ms - last_ts) : 1;
+    last_ts_by_symbol[symbol_index] = ts_ms;
+
+    MarketEvent event;
+    event.ts_ms = ts_ms;
+    event.symbol = symbol;
+    event.price = price;
+    event.mark_price = price;
+    event.volume = 1000.0;
+    event.interval_ms = interval_ms;
+    stress_events_.push_back(std::move(event));
+
+    if (scenario.fill_every > 0 && (i + 1) % scenario.fill_every == 0) {
+      FillEvent fill;
+      // 短 id（SSO 范围内）：注入时的拷贝不触发堆分配。
+      fill.fill_id = "sf-" + std::to_string(stress_fills_.size());
+      fill.client_order_id = "so-" + std::to_string(stress_fills_.size());
+      fill.symbol = symbol;
+      fill.direction = (stress_fills_.size() % 2 == 0) ? 1 : -1;
+      fill.qty = 0.001;
+      fill.price = price;
+      stress_fills_.push_back(std::move(fill));
+    }
+  }
+
+  stress_mode_ = !stress_events_.empty();
+  if (stress_mode_ && stress_poll_gap_hist_ == nullptr) {
+    stress_poll_gap_hist_ = MetricsRegistry::Instance().RegisterHistogram(
+        "ai_trade_mock_stress_poll_gap_ns",
+        "压测模式相邻 PollMarket 调用间隔（纳秒）");
+  }
+}
+
 }  // namespace ai_trade
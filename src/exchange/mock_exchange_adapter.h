@@ -13,16 +13,43 @@
 
 namespace ai_trade {
 
+class MetricHistogram;
+
+/**
+ * @brief mock 压测场景描述
+ *
+ * 按种子确定性预生成事件流：同一场景在任意机器上产出完全一致的
+ * 行情序列，压测结果可跨版本比对。
+ */
+struct MockStressScenario {
+  std::uint64_t seed{42};            ///< 随机游走种子。
+  std::size_t total_events{0};       ///< 预生成行情事件总数。
+  std::size_t burst_size{32};        ///< 突发内连续事件数（事件间隔 1ms）。
+  std::int64_t gap_ms{1000};         ///< 突发之间的时间空洞（毫秒）。
+  double base_price{100.0};          ///< 随机游走起始价。
+  double price_jitter_pct{0.001};    ///< 单事件相对价格抖动上限。
+  std::size_t fill_every{0};         ///< 每 N 条行情注入一笔预生成成交（0=关闭）。
+};
+
+/// 压测运行统计：服务计数与 pending 成交队列深度水位。
+struct MockStressStats {
+  std::size_t market_events_served{0};
+  std::size_t fills_injected{0};
+  std::size_t max_pending_fill_depth{0};
+};
+
 /**
  * @brief 本地模拟交易所适配器
  *
  * 特性：
  * 1. 使用预置价格序列生成行情；
  * 2. 下单后本地生成成交回报（含部分成交）；
- * 3. 维护“远端仓位视图”以支持对账流程测试。
+ * 3. 维护“远端仓位视图”以支持对账流程测试；
+ * 4. 压测模式：从连续数组按游标服务预生成事件（零逐事件分配），
+ *    相邻 PollMarket 间隔以直方图导出，pending 队列深度记录水位。
  *
  * 场景：
- * - 单元测试、回放验证、无外网开发环境。
+ * - 单元测试、回放验证、无外网开发环境、发布前端到端负载测试。
  */
 class MockExchangeAdapter : public ExchangeAdapter {
  public:
@@ -63,7 +90,20 @@ class MockExchangeAdapter : public ExchangeAdapter {
                      SymbolInfo* out_info) const override;
   bool TradeOk() const override { return connected_; }
 
+  /**
+   * @brief 预生成压测事件流并切换到压测模式
+   *
+   * 突发/空洞节奏、多 symbol 轮转与价格游走全部在本次调用内完成，
+   * 之后 PollMarket 只做一次数组拷贝；场景可重复（同种子同序列）。
+   */
+  void PreloadStressScenario(const MockStressScenario& scenario);
+  bool stress_mode() const { return stress_mode_; }
+  const MockStressStats& stress_stats() const { return stress_stats_; }
+
  private:
+  /// 记录 pending 成交队列深度水位（压测诊断用）。
+  void NotePendingFillDepth();
+
   std::vector<double> prices_;
   std::vector<std::string> symbols_;
   std::size_t cursor_{0};
@@ -75,6 +115,17 @@ class MockExchangeAdapter : public ExchangeAdapter {
   std::unordered_map<std::string, std::int64_t> last_market_ts_ms_by_symbol_;
   std::unordered_map<std::string, double> remote_position_qty_by_symbol_;
   std::deque<FillEvent> pending_fills_;
+
+  // --- 压测模式状态 ---
+  bool stress_mode_{false};
+  MockStressScenario stress_scenario_;
+  std::vector<MarketEvent> stress_events_;  ///< 预生成行情（连续数组）。
+  std::vector<FillEvent> stress_fills_;     ///< 预生成注入成交。
+  std::size_t stress_cursor_{0};
+  std::size_t stress_fill_cursor_{0};
+  std::int64_t last_stress_poll_ns_{0};
+  MetricHistogram* stress_poll_gap_hist_{nullptr};
+  MockStressStats stress_stats_;
 };
 
 }  // namespace ai_trade
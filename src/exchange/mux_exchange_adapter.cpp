@@ -0,0 +1,316 @@
+#include "exchange/mux_exchange_adapter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "core/log.h"
+#include "core/thread_topology.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 订单归属表上限：超过后整体清空重建。表只服务撤单回路由，
+// 丢失旧条目时撤单退回默认执行 venue，属于可接受的降级。
+constexpr std::size_t kMaxTrackedOrderRoutes = 65536;
+
+}  // namespace
+
+MuxExchangeAdapter::MuxExchangeAdapter(std::vector<Venue> venues,
+                                       const ExchangeMuxConfig& config)
+    : poll_idle_sleep_us_(std::max(config.poll_idle_sleep_us, 1)) {
+  venues_.reserve(venues.size());
+  for (Venue& venue : venues) {
+    auto state = std::make_unique<VenueState>();
+    state->name = venue.name;
+    state->adapter = std::move(venue.adapter);
+    state->ring = std::make_unique<SpscRing<MarketEvent>>(
+        static_cast<std::size_t>(std::max(config.ring_capacity, 64)));
+    venues_.push_back(std::move(state));
+  }
+
+  auto find_adapter = [this](const std::string& name) -> ExchangeAdapter* {
+    for (const auto& venue : venues_) {
+      if (venue->name == name) {
+        return venue->adapter.get();
+      }
+    }
+    return nullptr;
+  };
+
+  execution_adapter_ = find_adapter(config.execution_venue);
+  if (execution_adapter_ == nullptr && !venues_.empty()) {
+    LogError("MUX_EXECUTION_VENUE_MISSING: venue=" + config.execution_venue +
+             ", fallback=" + venues_.front()->name);
+    execution_adapter_ = venues_.front()->adapter.get();
+  }
+  execution_targets_.push_back(execution_adapter_);
+
+  for (const std::string& route : config.symbol_routes) {
+    const auto eq = route.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 >= route.size()) {
+      LogError("MUX_SYMBOL_ROUTE_INVALID: route=" + route +
+               ", expected=SYMBOL=venue");
+      continue;
+    }
+    const std::string symbol = route.substr(0, eq);
+    const std::string venue_name = route.substr(eq + 1);
+    ExchangeAdapter* adapter = find_adapter(venue_name);
+    if (adapter == nullptr) {
+      LogError("MUX_SYMBOL_ROUTE_UNKNOWN_VENUE: symbol=" + symbol +
+               ", venue=" + venue_name);
+      continue;
+    }
+    route_by_symbol_[symbol] = adapter;
+    if (std::find(execution_targets_.begin(), execution_targets_.end(),
+                  adapter) == execution_targets_.end()) {
+      execution_targets_.push_back(adapter);
+    }
+  }
+}
+
+MuxExchangeAdapter::~MuxExchangeAdapter() {
+  stop_.store(true, std::memory_order_release);
+  for (const auto& venue : venues_) {
+    if (venue->poll_thread.joinable()) {
+      venue->poll_thread.join();
+    }
+  }
+}
+
+std::string MuxExchangeAdapter::Name() const {
+  std::string name = "mux(";
+  for (std::size_t i = 0; i < venues_.size(); ++i) {
+    if (i > 0) {
+      name += "+";
+    }
+    name += venues_[i]->name;
+  }
+  name += ")";
+  return name;
+}
+
+bool MuxExchangeAdapter::Connect() {
+  for (const auto& venue : venues_) {
+    const bool connected = venue->adapter->Connect();
+    const bool is_execution_target =
+        std::find(execution_targets_.begin(), execution_targets_.end(),
+                  venue->adapter.get()) != execution_targets_.end();
+    if (!connected) {
+      if (is_execution_target) {
+        LogError("MUX_EXECUTION_VENUE_CONNECT_FAILED: venue=" + venue->name);
+        return false;
+      }
+      // 行情专用 venue 失败只降级：少一路行情，交易链路不受影响。
+      LogError("MUX_MARKET_VENUE_DEGRADED: venue=" + venue->name +
+               ", reason=connect_failed");
+      continue;
+    }
+    venue->market_active = true;
+  }
+
+  for (const auto& venue : venues_) {
+    if (!venue->market_active) {
+      continue;
+    }
+    venue->poll_thread =
+        std::thread([this, state = venue.get()] { RunMarketPump(state); });
+  }
+  LogInfo("MUX_ADAPTER_READY: name=" + Name() +
+          ", execution_venue=" +
+          (execution_adapter_ != nullptr ? execution_adapter_->Name() : "none") +
+          ", symbol_routes=" + std::to_string(route_by_symbol_.size()));
+  return execution_adapter_ != nullptr;
+}
+
+void MuxExchangeAdapter::RunMarketPump(VenueState* venue) {
+  ApplyThreadRole(ThreadRole::kFeed);
+  MarketEvent event;
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (!venue->adapter->PollMarket(&event)) {
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(poll_idle_sleep_us_));
+      continue;
+    }
+    if (!venue->ring->TryPush(std::move(event))) {
+      // 环满说明消费侧长期落后：丢最新一条并计数，保持旧序完整。
+      dropped_market_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool MuxExchangeAdapter::PollMarket(MarketEvent* out_event) {
+  // k 路归并：每路在消费侧暂存一条头部事件，输出时间戳最小的那条。
+  // 某一路暂时无事件时不等待（有界乱序换取零阻塞），该路下一条到达
+  // 后重新参与比较。
+  VenueState* best = nullptr;
+  for (const auto& venue : venues_) {
+    if (!venue->market_active) {
+      continue;
+    }
+    if (!venue->has_staged) {
+      venue->has_staged = venue->ring->TryPop(&venue->staged);
+    }
+    if (venue->has_staged &&
+        (best == nullptr || venue->staged.ts_ms < best->staged.ts_ms)) {
+      best = venue.get();
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+  *out_event = std::move(best->staged);
+  best->has_staged = false;
+  return true;
+}
+
+ExchangeAdapter* MuxExchangeAdapter::RouteExecution(
+    const std::string& symbol) const {
+  const auto it = route_by_symbol_.find(symbol);
+  return it != route_by_symbol_.end() ? it->second : execution_adapter_;
+}
+
+bool MuxExchangeAdapter::SubmitOrder(const OrderIntent& intent) {
+  ExchangeAdapter* adapter = RouteExecution(intent.symbol);
+  if (adapter == nullptr) {
+    return false;
+  }
+  const bool ok = adapter->SubmitOrder(intent);
+  if (ok) {
+    std::lock_guard<std::mutex> lock(order_route_mutex_);
+    if (order_route_.size() >= kMaxTrackedOrderRoutes) {
+      order_route_.clear();
+    }
+    order_route_[intent.client_order_id] = adapter;
+  }
+  return ok;
+}
+
+bool MuxExchangeAdapter::SubmitOrders(std::span<const OrderIntent> intents,
+                                      std::vector<bool>* out_ok) {
+  // 按目标 venue 分组后各自走一次批量端点，保持单所的批量优化。
+  if (out_ok != nullptr) {
+    out_ok->assign(intents.size(), false);
+  }
+  std::unordered_map<ExchangeAdapter*, std::vector<std::size_t>> by_venue;
+  std::size_t routed = 0;
+  for (std::size_t i = 0; i < intents.size(); ++i) {
+    ExchangeAdapter* adapter = RouteExecution(intents[i].symbol);
+    if (adapter != nullptr) {
+      by_venue[adapter].push_back(i);
+      ++routed;
+    }
+  }
+  bool all_ok = routed == intents.size();
+  std::vector<OrderIntent> batch;
+  std::vector<bool> batch_ok;
+  for (auto& [adapter, indices] : by_venue) {
+    batch.clear();
+    batch.reserve(indices.size());
+    for (const std::size_t index : indices) {
+      batch.push_back(intents[index]);
+    }
+    const bool venue_ok = adapter->SubmitOrders(batch, &batch_ok);
+    all_ok = all_ok && venue_ok;
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+      const bool ok = k < batch_ok.size() && batch_ok[k];
+      if (out_ok != nullptr) {
+        (*out_ok)[indices[k]] = ok;
+      }
+      if (ok) {
+        std::lock_guard<std::mutex> lock(order_route_mutex_);
+        if (order_route_.size() >= kMaxTrackedOrderRoutes) {
+          order_route_.clear();
+        }
+        order_route_[intents[indices[k]].client_order_id] = adapter;
+      }
+    }
+  }
+  return all_ok;
+}
+
+bool MuxExchangeAdapter::CancelOrder(const std::string& client_order_id) {
+  ExchangeAdapter* adapter = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(order_route_mutex_);
+    const auto it = order_route_.find(client_order_id);
+    if (it != order_route_.end()) {
+      adapter = it->second;
+      order_route_.erase(it);
+    }
+  }
+  if (adapter == nullptr) {
+    adapter = execution_adapter_;  // 归属未知（表重建后）退回默认执行所
+  }
+  return adapter != nullptr && adapter->CancelOrder(client_order_id);
+}
+
+bool MuxExchangeAdapter::PollFill(FillEvent* out_fill) {
+  if (venues_.empty()) {
+    return false;
+  }
+  // 轮转起点：避免固定顺序下前面的 venue 持续抢占消费带宽。
+  const std::size_t count = venues_.size();
+  for (std::size_t offset = 0; offset < count; ++offset) {
+    VenueState* venue = venues_[(fill_poll_cursor_ + offset) % count].get();
+    if (!venue->market_active) {
+      continue;
+    }
+    if (venue->adapter->PollFill(out_fill)) {
+      fill_poll_cursor_ = (fill_poll_cursor_ + offset + 1) % count;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MuxExchangeAdapter::GetRemoteNotionalUsd(
+    double* out_notional_usd) const {
+  return execution_adapter_ != nullptr &&
+         execution_adapter_->GetRemoteNotionalUsd(out_notional_usd);
+}
+
+bool MuxExchangeAdapter::GetAccountSnapshot(
+    ExchangeAccountSnapshot* out_snapshot) const {
+  return execution_adapter_ != nullptr &&
+         execution_adapter_->GetAccountSnapshot(out_snapshot);
+}
+
+bool MuxExchangeAdapter::GetRemotePositions(
+    std::vector<RemotePositionSnapshot>* out_positions) const {
+  return execution_adapter_ != nullptr &&
+         execution_adapter_->GetRemotePositions(out_positions);
+}
+
+bool MuxExchangeAdapter::GetRemoteAccountBalance(
+    RemoteAccountBalanceSnapshot* out_balance) const {
+  return execution_adapter_ != nullptr &&
+         execution_adapter_->GetRemoteAccountBalance(out_balance);
+}
+
+bool MuxExchangeAdapter::GetRemoteOpenOrderClientIds(
+    std::unordered_set<std::string>* out_client_order_ids) const {
+  return execution_adapter_ != nullptr &&
+         execution_adapter_->GetRemoteOpenOrderClientIds(out_client_order_ids);
+}
+
+bool MuxExchangeAdapter::GetSymbolInfo(const std::string& symbol,
+                                       SymbolInfo* out_info) const {
+  ExchangeAdapter* adapter = RouteExecution(symbol);
+  return adapter != nullptr && adapter->GetSymbolInfo(symbol, out_info);
+}
+
+bool MuxExchangeAdapter::TradeOk() const {
+  if (execution_targets_.empty()) {
+    return false;
+  }
+  for (ExchangeAdapter* adapter : execution_targets_) {
+    if (adapter == nullptr || !adapter->TradeOk()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace ai_trade
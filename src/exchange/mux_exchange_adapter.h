@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/config.h"
+#include "core/spsc_ring.h"
+#include "exchange/exchange_adapter.h"
+
+namespace ai_trade {
+
+/**
+ * @brief 多交易所并发复用适配器 (Mux)
+ *
+ * 同时驱动多个 venue 适配器，对上层仍表现为单一 `ExchangeAdapter`：
+ * - 行情：每个 venue 一条拉取线程把 `MarketEvent` 推入各自的 SPSC 环，
+ *   `PollMarket` 在消费侧做 k 路时间序归并。跨所共列的 symbol 两路
+ *   行情都会流出，策略侧的 tick 合流天然保留最快到达的最新价——
+ *   领先所（通常 Binance ticker 领先 Bybit 数十毫秒）的打印先驱动决策；
+ * - 执行：订单按 symbol 路由到配置的执行 venue（`symbol_routes` 覆盖，
+ *   未命中走 `execution_venue`），撤单按下单时记录的归属路由回原所；
+ * - 账户口径（余额/持仓/对账）全部取自默认执行 venue，行情专用
+ *   venue 连接失败只降级丢一路行情，不影响交易可用性。
+ *
+ * 线程约定：`PollMarket`/`PollFill` 单消费者（feed 读取线程/决策线程），
+ * `SubmitOrder`/`CancelOrder` 来自执行线程；订单归属表内部加锁。
+ */
+class MuxExchangeAdapter : public ExchangeAdapter {
+ public:
+  /// 一个受管 venue：名字用于路由配置匹配与日志。
+  struct Venue {
+    std::string name;
+    std::unique_ptr<ExchangeAdapter> adapter;
+  };
+
+  MuxExchangeAdapter(std::vector<Venue> venues,
+                     const ExchangeMuxConfig& config);
+  ~MuxExchangeAdapter() override;
+
+  std::string Name() const override;
+  /// 连接所有 venue 并启动行情拉取线程；执行 venue 连接失败即失败，
+  /// 仅做行情的 venue 失败只降级（少一路行情）。
+  bool Connect() override;
+  /// 多路行情时间序归并：输出各 venue 暂存头部中时间戳最小的一条。
+  bool PollMarket(MarketEvent* out_event) override;
+  bool SubmitOrder(const OrderIntent& intent) override;
+  bool SubmitOrders(std::span<const OrderIntent> intents,
+                    std::vector<bool>* out_ok) override;
+  bool CancelOrder(const std::string& client_order_id) override;
+  /// 轮询各 venue 的成交回报（轮转起点避免固定偏向某一所）。
+  bool PollFill(FillEvent* out_fill) override;
+  bool GetRemoteNotionalUsd(double* out_notional_usd) const override;
+  bool GetAccountSnapshot(ExchangeAccountSnapshot* out_snapshot) const override;
+  bool GetRemotePositions(
+      std::vector<RemotePositionSnapshot>* out_positions) const override;
+  bool GetRemoteAccountBalance(
+      RemoteAccountBalanceSnapshot* out_balance) const override;
+  bool GetRemoteOpenOrderClientIds(
+      std::unordered_set<std::string>* out_client_order_ids) const override;
+  /// symbol 规则按执行路由取自将实际下单的 venue。
+  bool GetSymbolInfo(const std::string& symbol,
+                     SymbolInfo* out_info) const override;
+  /// 交易健康 = 默认执行 venue 与所有被路由覆盖的 venue 均健康。
+  bool TradeOk() const override;
+
+  /// 行情环满被丢弃的事件数（监控口径，近似值）。
+  std::uint64_t dropped_market_events() const {
+    return dropped_market_events_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct VenueState {
+    std::string name;
+    std::unique_ptr<ExchangeAdapter> adapter;
+    std::unique_ptr<SpscRing<MarketEvent>> ring;  ///< 行情环（venue 线程写）。
+    std::thread poll_thread;
+    bool market_active{false};  ///< 连接成功且行情线程在跑。
+    // 消费侧归并暂存：环里弹出的头部事件在此等待与其他路比较。
+    MarketEvent staged{};
+    bool has_staged{false};
+  };
+
+  /// 解析 intent.symbol 的执行 venue；未配置覆盖时返回默认执行 venue。
+  ExchangeAdapter* RouteExecution(const std::string& symbol) const;
+  /// venue 行情拉取线程：PollMarket 推环，环满丢弃并计数。
+  void RunMarketPump(VenueState* venue);
+
+  std::vector<std::unique_ptr<VenueState>> venues_;
+  ExchangeAdapter* execution_adapter_{nullptr};  ///< 默认执行 venue。
+  /// symbol → 执行 venue 适配器（来自 symbol_routes 覆盖项）。
+  std::unordered_map<std::string, ExchangeAdapter*> route_by_symbol_;
+  /// 被任意路由引用的执行 venue 集合（TradeOk 的健康口径）。
+  std::vector<ExchangeAdapter*> execution_targets_;
+  int poll_idle_sleep_us_{200};
+  std::atomic<bool> stop_{false};
+  std::atomic<std::uint64_t> dropped_market_events_{0};
+  std::size_t fill_poll_cursor_{0};  ///< PollFill 轮转起点。
+
+  /// client_order_id → 下单 venue（撤单回原所）；有界，满后整体重建。
+  mutable std::mutex order_route_mutex_;
+  std::unordered_map<std::string, ExchangeAdapter*> order_route_;
+};
+
+}  // namespace ai_trade
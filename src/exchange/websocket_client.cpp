@@ -2,12 +2,15 @@
 
 #include <array>
 #include <chrono>
+#include <cstddef>
 #include <string>
 #include <thread>
 #include <utility>
 
 #include <curl/curl.h>
 
+#include "monitor/metrics_registry.h"
+
 #if defined(AI_TRADE_ENABLE_BEAST_WS)
 #include <boost/asio/connect.hpp>
 #include <boost/asio/error.hpp>
@@ -36,6 +39,19 @@ std::string CurlCodeToString(CURLcode code) {
   return std::string(curl_easy_strerror(code));
 }
 
+/// 单次排空的帧数上限：限制一次 PollBatch 的最坏停留时间。
+constexpr int kMaxFramesPerDrain = 256;
+
+/// 记录一次批量排空取到的帧数（仅统计非空排空，观测积压形成）。
+void RecordFramesPerDrain(std::size_t frames) {
+  static MetricHistogram* hist = MetricsRegistry::Instance().RegisterHistogram(
+      "ai_trade_ws_frames_per_drain",
+      "单次 PollBatch 排空的完整帧数");
+  if (hist != nullptr) {
+    hist->Record(static_cast<std::int64_t>(frames));
+  }
+}
+
 bool WaitSocketReadable(CURL* curl,
                         long timeout_ms,
                         bool* out_readable,
@@ -472,6 +488,46 @@ class BeastWebsocketClient final : public WebsocketClient {
 
 }  // namespace
 
+void WsFrameBatch::Seal() {
+  frames.clear();
+  std::size_t begin = 0;
+  for (const std::size_t end : frame_ends_) {
+    frames.emplace_back(data.data() + begin, end - begin);
+    begin = end;
+  }
+}
+
+WsPollStatus WebsocketClient::PollBatch(WsFrameBatch* out_batch,
+                                        std::string* out_error) {
+  if (out_batch == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "out_batch 为空";
+    }
+    return WsPollStatus::kError;
+  }
+
+  out_batch->Clear();
+  std::string frame;
+  WsPollStatus status = WsPollStatus::kNoMessage;
+  for (int guard = 0; guard < kMaxFramesPerDrain; ++guard) {
+    frame.clear();
+    status = PollText(&frame, out_error);
+    if (status != WsPollStatus::kMessage) {
+      break;
+    }
+    out_batch->data.append(frame);
+    out_batch->MarkFrameEnd();
+  }
+
+  if (out_batch->FrameBytes() == 0U) {
+    return status == WsPollStatus::kMessage ? WsPollStatus::kNoMessage : status;
+  }
+  // 已取到完整帧则正常返回；排空尾部遇到的关闭/错误会在下一次调用复现。
+  out_batch->Seal();
+  RecordFramesPerDrain(out_batch->frames.size());
+  return WsPollStatus::kMessage;
+}
+
 CurlWebsocketClient::CurlWebsocketClient() = default;
 
 CurlWebsocketClient::~CurlWebsocketClient() {
@@ -613,7 +669,12 @@ WsPollStatus CurlWebsocketClient::PollText(std::string* out_payload,
   for (int guard = 0; guard < 32; ++guard) {
     std::array<char, 4096> buffer{};
     std::size_t received = 0;
+#if LIBCURL_VERSION_NUM >= 0x080900
+    // curl >= 8.9 将 meta 指针改为 const
     const struct curl_ws_frame* meta = nullptr;
+#else
+    struct curl_ws_frame* meta = nullptr;
+#endif
 
     const CURLcode code =
         curl_ws_recv(curl, buffer.data(), buffer.size(), &received, &meta);
@@ -654,6 +715,101 @@ WsPollStatus CurlWebsocketClient::PollText(std::string* out_payload,
   return WsPollStatus::kMessage;
 }
 
+WsPollStatus CurlWebsocketClient::PollBatch(WsFrameBatch* out_batch,
+                                            std::string* out_error) {
+  if (!connected_ || curl_handle_ == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "WebSocket 未连接";
+    }
+    return WsPollStatus::kClosed;
+  }
+  if (out_batch == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "out_batch 为空";
+    }
+    return WsPollStatus::kError;
+  }
+
+  out_batch->Clear();
+  // 上次排空遗留的半帧作为本次首帧前缀续接。
+  if (!partial_frame_.empty()) {
+    out_batch->data.append(partial_frame_);
+    partial_frame_.clear();
+  }
+
+  CURL* curl = static_cast<CURL*>(curl_handle_);
+  bool readable = false;
+  std::string wait_error;
+  if (!WaitSocketReadable(curl, /*timeout_ms=*/5, &readable, &wait_error)) {
+    MarkClosed(wait_error);
+    if (out_error != nullptr) {
+      *out_error = wait_error;
+    }
+    return WsPollStatus::kError;
+  }
+
+  if (readable) {
+    for (int guard = 0; guard < kMaxFramesPerDrain; ++guard) {
+      std::array<char, 4096> buffer{};
+      std::size_t received = 0;
+#if LIBCURL_VERSION_NUM >= 0x080900
+      // curl >= 8.9 将 meta 指针改为 const
+      const struct curl_ws_frame* meta = nullptr;
+#else
+      struct curl_ws_frame* meta = nullptr;
+#endif
+
+      const CURLcode code =
+          curl_ws_recv(curl, buffer.data(), buffer.size(), &received, &meta);
+      if (code == CURLE_AGAIN) {
+        break;
+      }
+      if (code != CURLE_OK) {
+        const std::string message =
+            "WebSocket 接收失败: " + CurlCodeToString(code);
+        MarkClosed(message);
+        if (out_error != nullptr) {
+          *out_error = message;
+        }
+        return WsPollStatus::kError;
+      }
+
+      if (meta != nullptr && (meta->flags & CURLWS_CLOSE) != 0U) {
+        const std::string message = "WebSocket 对端关闭连接";
+        MarkClosed(message);
+        if (out_error != nullptr) {
+          *out_error = message;
+        }
+        return WsPollStatus::kClosed;
+      }
+
+      if (received > 0U) {
+        out_batch->data.append(buffer.data(), received);
+      }
+      // 空帧（纯控制帧）不产生切片，对齐 PollText 的空载荷语义。
+      if ((meta == nullptr || meta->bytesleft == 0U) &&
+          out_batch->data.size() > out_batch->FrameBytes()) {
+        out_batch->MarkFrameEnd();
+      }
+    }
+  }
+
+  // 尾部未闭合的字节留到下一次排空续接。
+  const std::size_t frame_bytes = out_batch->FrameBytes();
+  if (out_batch->data.size() > frame_bytes) {
+    partial_frame_.assign(out_batch->data, frame_bytes,
+                          out_batch->data.size() - frame_bytes);
+    out_batch->data.resize(frame_bytes);
+  }
+
+  if (frame_bytes == 0U) {
+    return WsPollStatus::kNoMessage;
+  }
+  out_batch->Seal();
+  RecordFramesPerDrain(out_batch->frames.size());
+  return WsPollStatus::kMessage;
+}
+
 void CurlWebsocketClient::Close() {
   if (curl_handle_ != nullptr) {
     curl_easy_cleanup(static_cast<CURL*>(curl_handle_));
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -14,6 +16,36 @@ enum class WsPollStatus {
   kError,
 };
 
+/**
+ * @brief PollBatch 的复用帧缓冲
+ *
+ * data 为持久接收缓冲（跨调用保留容量，稳态零分配），frames 为指向 data
+ * 内部的完整帧切片，仅在下一次 PollBatch 调用前有效。实现方通过
+ * MarkFrameEnd/Seal 记录帧边界：追加字节可能触发 data 扩容，
+ * 因此切片统一在排空结束后构建。
+ */
+struct WsFrameBatch {
+  std::string data;                      ///< 持久接收缓冲。
+  std::vector<std::string_view> frames;  ///< 完整帧切片（borrow 自 data）。
+
+  void Clear() {
+    data.clear();
+    frames.clear();
+    frame_ends_.clear();
+  }
+  /// 标记 data 当前末尾为一帧边界（实现方在帧完整时调用）。
+  void MarkFrameEnd() { frame_ends_.push_back(data.size()); }
+  /// 已闭合帧覆盖的字节数（其后的尾部字节属于未完成帧）。
+  std::size_t FrameBytes() const {
+    return frame_ends_.empty() ? 0 : frame_ends_.back();
+  }
+  /// 按帧边界把 frames 重建为 data 的切片。
+  void Seal();
+
+ private:
+  std::vector<std::size_t> frame_ends_;  ///< 各帧在 data 中的结束偏移。
+};
+
 /**
  * @brief WebSocket 客户端抽象接口
  *
@@ -36,6 +68,16 @@ class WebsocketClient {
   virtual WsPollStatus PollText(std::string* out_payload,
                                 std::string* out_error) = 0;
 
+  /**
+   * @brief 一次排空 socket 上所有完整帧
+   *
+   * 默认实现循环 PollText 直到无消息，适配 mock/Beast 等实现；
+   * 具体实现可覆写为单次 syscall 级排空。至少取到一帧返回 kMessage，
+   * 已收集帧数记入直方图 ai_trade_ws_frames_per_drain。
+   */
+  virtual WsPollStatus PollBatch(WsFrameBatch* out_batch,
+                                 std::string* out_error);
+
   virtual bool IsConnected() const = 0;
   virtual void Close() = 0;
 };
@@ -56,6 +98,10 @@ class CurlWebsocketClient final : public WebsocketClient {
   WsPollStatus PollText(std::string* out_payload,
                         std::string* out_error) override;
 
+  /// 原生批量排空：单次就绪检测后连续 curl_ws_recv 直到 CURLE_AGAIN。
+  WsPollStatus PollBatch(WsFrameBatch* out_batch,
+                         std::string* out_error) override;
+
   bool IsConnected() const override { return connected_; }
   void Close() override;
 
@@ -66,6 +112,7 @@ class CurlWebsocketClient final : public WebsocketClient {
   void* curl_handle_{nullptr};  ///< libcurl 句柄（void* 以隔离头文件依赖）。
   bool connected_{false};  ///< 当前连接状态。
   std::string last_error_;  ///< 最近一次关闭原因，供上层降级日志使用。
+  std::string partial_frame_;  ///< 批量排空后遗留的未完成帧前缀。
 };
 
 /// 工厂函数：按编译开关返回可用的 WebSocket 实现。
@@ -1,70 +1,175 @@
 #include "execution/async_executor.h"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <utility>
 
+#include "core/thread_topology.h"
+#include "monitor/metrics_registry.h"
+
 namespace ai_trade {
 
-AsyncExecutor::AsyncExecutor(ExchangeAdapter* adapter) : adapter_(adapter) {}
+namespace {
+
+/// 单通道任务/结果环容量：覆盖最坏成交风暴下单轮可能积压的任务数。
+constexpr std::size_t kRingCapacity = 1024;
+
+/// 通道数上限：超过交易所连接配额的并发没有收益。
+constexpr int kMaxLanes = 16;
+
+/// 撤单路由映射容量上限；超出后按插入顺序剪掉最旧条目
+/// （只会影响早已终态的订单，兜底哈希路由仍然可用）。
+constexpr std::size_t kMaxTrackedOrders = 1 << 16;
+
+/// 同批合并提交的订单数上限（对齐交易所批量端点单批限制）。
+constexpr std::size_t kCoalesceMaxOrders = 10;
+
+}  // namespace
+
+AsyncExecutor::AsyncExecutor(ExchangeAdapter* adapter, int lanes)
+    : adapter_(adapter) {
+  const int lane_count = std::clamp(lanes, 1, kMaxLanes);
+  lanes_.reserve(static_cast<std::size_t>(lane_count));
+  for (int i = 0; i < lane_count; ++i) {
+    lanes_.push_back(std::make_unique<Lane>(kRingCapacity));
+  }
+}
 
 AsyncExecutor::~AsyncExecutor() {
   Stop();
 }
 
 void AsyncExecutor::Start() {
-  if (worker_.joinable()) {
+  if (lanes_.front()->worker.joinable()) {
     return;
   }
-  worker_ = std::thread(&AsyncExecutor::WorkerLoop, this);
+  for (std::size_t i = 0; i < lanes_.size(); ++i) {
+    Lane* lane = lanes_[i].get();
+    lane->wake_fd = ::eventfd(0, 0);
+    lane->depth_gauge = MetricsRegistry::Instance().RegisterGauge(
+        "ai_trade_executor_lane_depth_" + std::to_string(i),
+        "异步执行器通道 " + std::to_string(i) + " 任务环近似深度");
+    lane->worker = std::thread(&AsyncExecutor::WorkerLoop, this, lane);
+  }
 }
 
 void AsyncExecutor::Stop() {
   // 通过投递 stop 任务优雅退出，避免直接中断工作线程。
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    task_queue_.push(Task{.type = Task::kStop, .intent = {}, .cancel_id = ""});
+  if (!lanes_.front()->worker.joinable()) {
+    return;
   }
-  queue_cv_.notify_one();
-  if (worker_.joinable()) {
-    worker_.join();
+  for (auto& lane : lanes_) {
+    EnqueueTask(lane.get(),
+                Task{.type = Task::kStop, .intent = {}, .cancel_id = ""});
+  }
+  for (auto& lane : lanes_) {
+    lane->worker.join();
+    if (lane->wake_fd >= 0) {
+      ::close(lane->wake_fd);
+      lane->wake_fd = -1;
+    }
   }
 }
 
 void AsyncExecutor::Submit(const OrderIntent& intent) {
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    task_queue_.push(Task{.type = Task::kSubmit, .intent = intent, .cancel_id = ""});
-  }
-  queue_cv_.notify_one();
+  const std::size_t lane =
+      std::hash<std::string>{}(intent.symbol) % lanes_.size();
+  RememberLane(intent.client_order_id, lane);
+  EnqueueTask(lanes_[lane].get(),
+              Task{.type = Task::kSubmit, .intent = intent, .cancel_id = ""});
 }
 
 void AsyncExecutor::Cancel(const std::string& client_order_id) {
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    task_queue_.push(Task{.type = Task::kCancel, .intent = {}, .cancel_id = client_order_id});
+  const std::size_t lane = ResolveCancelLane(client_order_id);
+  EnqueueTask(
+      lanes_[lane].get(),
+      Task{.type = Task::kCancel, .intent = {}, .cancel_id = client_order_id});
+}
+
+void AsyncExecutor::RememberLane(const std::string& client_order_id,
+                                 std::size_t lane) {
+  lane_by_order_id_[client_order_id] = lane;
+  lane_map_fifo_.push_back(client_order_id);
+  while (lane_map_fifo_.size() > kMaxTrackedOrders) {
+    lane_by_order_id_.erase(lane_map_fifo_.front());
+    lane_map_fifo_.pop_front();
+  }
+}
+
+std::size_t AsyncExecutor::ResolveCancelLane(
+    const std::string& client_order_id) {
+  const auto it = lane_by_order_id_.find(client_order_id);
+  if (it != lane_by_order_id_.end()) {
+    return it->second;
+  }
+  // 未命中（映射已剪枝/恢复路径注入的订单）：按 id 哈希兜底。
+  return std::hash<std::string>{}(client_order_id) % lanes_.size();
+}
+
+void AsyncExecutor::EnqueueTask(Lane* lane, Task&& task) {
+  // 队满说明通道线程严重滞后：让出 CPU 等待空位，背压而非丢单。
+  while (!lane->tasks.TryPush(std::move(task))) {
+    std::this_thread::yield();
+  }
+  if (lane->depth_gauge != nullptr) {
+    lane->depth_gauge->Set(static_cast<double>(lane->tasks.Size()));
+  }
+  if (lane->wake_fd >= 0) {
+    const std::uint64_t one = 1;
+    (void)!::write(lane->wake_fd, &one, sizeof(one));
   }
-  queue_cv_.notify_one();
 }
 
 void AsyncExecutor::PollResults(std::vector<AsyncResult>* out_results) {
   if (out_results == nullptr) return;
   out_results->clear();
-  std::lock_guard<std::mutex> lock(result_mutex_);
-  if (results_.empty()) {
-    return;
+  AsyncResult result;
+  for (auto& lane : lanes_) {
+    while (lane->results.TryPop(&result)) {
+      out_results->push_back(std::move(result));
+    }
   }
-  // swap 方式把锁持有时间降到最短。
-  out_results->swap(results_);
 }
 
-void AsyncExecutor::WorkerLoop() {
+void AsyncExecutor::WorkerLoop(Lane* lane) {
+  ApplyThreadRole(ThreadRole::kExecutor);
+  std::vector<OrderIntent> batch;
+  std::vector<bool> batch_ok;
+  Task carried;  ///< 合并提交时预读到的非 submit 任务，下轮优先处理。
+  bool has_carried = false;
+
+  auto push_result = [this, lane](AsyncResult&& result) {
+    // 结果环满时同样退避：主线程每个 tick 都会排空结果环。
+    while (!lane->results.TryPush(std::move(result))) {
+      std::this_thread::yield();
+    }
+    // 结果就绪后通知消费方（eventfd 写计数，多通道并发写安全）。
+    const int wake_fd = result_wake_fd_.load(std::memory_order_acquire);
+    if (wake_fd >= 0) {
+      const std::uint64_t one = 1;
+      (void)!::write(wake_fd, &one, sizeof(one));
+    }
+  };
+
   while (true) {
     Task task;
-    {
-      std::unique_lock<std::mutex> lock(queue_mutex_);
-      // 条件变量阻塞等待，避免空转占用 CPU。
-      queue_cv_.wait(lock, [this] { return !task_queue_.empty(); });
-      task = task_queue_.front();
-      task_queue_.pop();
+    if (has_carried) {
+      task = std::move(carried);
+      has_carried = false;
+    } else if (!lane->tasks.TryPop(&task)) {
+      // 空闲时阻塞在 eventfd 上；生产者入队后写 fd 唤醒。
+      // 入队先于写 fd，读到计数后重试出队必然可见新任务。
+      std::uint64_t pending = 0;
+      (void)!::read(lane->wake_fd, &pending, sizeof(pending));
+      continue;
+    }
+    if (lane->depth_gauge != nullptr) {
+      lane->depth_gauge->Set(static_cast<double>(lane->tasks.Size()));
     }
 
     // 统一由 stop 任务驱动退出，保证线程收敛路径可控。
@@ -72,32 +177,64 @@ void AsyncExecutor::WorkerLoop() {
       break;
     }
 
-    AsyncResult result;
     if (task.type == Task::kSubmit) {
-      result.client_order_id = task.intent.client_order_id;
-      result.is_cancel = false;
-      if (adapter_) {
-        result.success = adapter_->SubmitOrder(task.intent);
-        if (!result.success) {
-          result.error = "SubmitOrder returned false";
+      // 把同批已排队的连续提交合并为一次批量 wire 调用
+      // （entry + TP/SL 保护单族典型场景：三次往返降为一次）。
+      batch.clear();
+      batch.push_back(std::move(task.intent));
+      Task next;
+      while (batch.size() < kCoalesceMaxOrders && lane->tasks.TryPop(&next)) {
+        if (next.type == Task::kSubmit) {
+          batch.push_back(std::move(next.intent));
+          continue;
         }
+        carried = std::move(next);
+        has_carried = true;
+        break;
       }
-    } else if (task.type == Task::kCancel) {
-      result.client_order_id = task.cancel_id;
-      result.is_cancel = true;
-      if (adapter_) {
-        result.success = adapter_->CancelOrder(task.cancel_id);
-        if (!result.success) {
-          result.error = "CancelOrder returned false";
+
+      if (batch.size() == 1) {
+        AsyncResult result;
+        result.client_order_id = batch.front().client_order_id;
+        result.is_cancel = false;
+        if (adapter_) {
+          result.success = adapter_->SubmitOrder(batch.front());
+          if (!result.success) {
+            result.error = "SubmitOrder returned false";
+          }
+        }
+        push_result(std::move(result));
+      } else {
+        batch_ok.assign(batch.size(), false);
+        if (adapter_) {
+          adapter_->SubmitOrders(
+              std::span<const OrderIntent>(batch.data(), batch.size()),
+              &batch_ok);
+        }
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+          AsyncResult result;
+          result.client_order_id = batch[i].client_order_id;
+          result.is_cancel = false;
+          result.success = batch_ok[i];
+          if (!result.success && adapter_ != nullptr) {
+            result.error = "SubmitOrders returned false";
+          }
+          push_result(std::move(result));
         }
       }
+      continue;
     }
 
-    {
-      std::lock_guard<std::mutex> lock(result_mutex_);
-      // 结果先落地到线程安全缓冲区，再由主线程批量消费。
-      results_.push_back(std::move(result));
+    AsyncResult result;
+    result.client_order_id = task.cancel_id;
+    result.is_cancel = true;
+    if (adapter_) {
+      result.success = adapter_->CancelOrder(task.cancel_id);
+      if (!result.success) {
+        result.error = "CancelOrder returned false";
+      }
     }
+    push_result(std::move(result));
   }
 }
 
@@ -1,17 +1,22 @@
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
-#include <queue>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "core/spsc_ring.h"
 #include "core/types.h"
 #include "exchange/exchange_adapter.h"
 
 namespace ai_trade {
 
+class MetricGauge;
+
 // 异步执行结果：由工作线程写入，主线程轮询消费。
 struct AsyncResult {
   std::string client_order_id;
@@ -21,51 +26,89 @@ struct AsyncResult {
 };
 
 /**
- * @brief 异步执行器（单工作线程串行执行）
+ * @brief 异步执行器（按 symbol 亲和的多通道串行执行）
  *
  * 设计目的：
  * 1. 主线程只负责“投递任务”，不阻塞在网络调用；
- * 2. 交易所接口统一在单线程串行执行，避免并发下单竞态；
- * 3. 执行结果由主线程轮询消费，简化状态机一致性。
+ * 2. 同一 symbol 的任务按哈希固定到同一通道串行执行，避免同单竞态；
+ * 3. 不同 symbol 走不同通道并发提交，单个慢 REST 往返不再队头阻塞
+ *    其他 symbol 的订单；
+ * 4. 执行结果由主线程轮询消费，简化状态机一致性。
+ *
+ * 每条通道拥有独立的任务/结果 SPSC 环与 eventfd：主线程是唯一生产者、
+ * 通道线程是唯一消费者，投递与轮询均无锁。撤单按原提交记录路由到
+ * 同一通道，保证与对应下单的先后顺序。通道深度经 MetricsRegistry
+ * 以 gauge 形式导出（`ai_trade_executor_lane_depth_<i>`）。
+ *
+ * 通道线程出队时把已排队的连续提交合并为一次 `SubmitOrders` 批量
+ * wire 调用（entry + TP/SL 同 tick 下发的典型场景），支持批量端点
+ * 的适配器只付一次往返。
  */
 class AsyncExecutor {
  public:
   /**
    * @param adapter 交易所适配器，生命周期由外部管理（不持有所有权）
+   * @param lanes 工作通道数（夹取到 [1, 16]；1 = 原单线程串行行为）
    */
-  explicit AsyncExecutor(ExchangeAdapter* adapter);
+  explicit AsyncExecutor(ExchangeAdapter* adapter, int lanes = 1);
   ~AsyncExecutor();
 
   /// 启动后台工作线程；重复调用无副作用。
   void Start();
-  /// 投递 stop 任务并等待线程退出（幂等）。
+  /// 投递 stop 任务并等待全部通道退出（幂等）。
   void Stop();
 
-  /// 异步提交下单任务。
+  /// 异步提交下单任务（按 intent.symbol 哈希选通道）。
   void Submit(const OrderIntent& intent);
-  /// 异步提交撤单任务。
+  /// 异步提交撤单任务（路由到原下单通道，保持先后顺序）。
   void Cancel(const std::string& client_order_id);
 
   /// 非阻塞轮询执行结果；返回后 `out_results` 持有本轮所有结果。
   void PollResults(std::vector<AsyncResult>* out_results);
 
- private:
-  void WorkerLoop();
+  /// 设置结果唤醒 fd（eventfd）：工作线程写入结果后写 1 通知消费方，
+  /// 使主循环能在事件等待中立即醒来。fd 生命周期由调用方管理；
+  /// 传 -1 关闭通知。可在 Start 之后调用。
+  void SetResultWakeFd(int fd) {
+    result_wake_fd_.store(fd, std::memory_order_release);
+  }
+
+  int lane_count() const { return static_cast<int>(lanes_.size()); }
 
+ private:
   struct Task {
-    enum Type { kSubmit, kCancel, kStop } type;
+    enum Type { kSubmit, kCancel, kStop } type{kSubmit};
     OrderIntent intent;  ///< submit 任务有效载荷。
     std::string cancel_id;  ///< cancel 任务目标 client_order_id。
   };
 
+  /// 单条执行通道：任务环 + 结果环 + 唤醒 fd + 工作线程。
+  struct Lane {
+    explicit Lane(std::size_t ring_capacity)
+        : tasks(ring_capacity), results(ring_capacity) {}
+
+    SpscRing<Task> tasks;
+    SpscRing<AsyncResult> results;
+    std::thread worker;
+    int wake_fd{-1};
+    MetricGauge* depth_gauge{nullptr};  ///< 任务环近似深度。
+  };
+
+  void WorkerLoop(Lane* lane);
+  /// 入队并唤醒通道线程；队满时让出 CPU 重试（背压而非丢弃）。
+  void EnqueueTask(Lane* lane, Task&& task);
+  /// 提交时记录 client_order_id → 通道映射（容量封顶，FIFO 剪枝）。
+  void RememberLane(const std::string& client_order_id, std::size_t lane);
+  /// 撤单路由：优先查提交记录，未命中时按 id 哈希兜底。
+  std::size_t ResolveCancelLane(const std::string& client_order_id);
+
   ExchangeAdapter* adapter_{nullptr};  ///< 外部注入适配器（不拥有所有权）。
-  std::thread worker_;  ///< 后台执行线程。
-  std::mutex queue_mutex_;  ///< 任务队列互斥锁。
-  std::condition_variable queue_cv_;  ///< 任务到达通知。
-  std::queue<Task> task_queue_;  ///< 待执行任务队列。
+  std::vector<std::unique_ptr<Lane>> lanes_;  ///< 执行通道（数量固定）。
+  std::atomic<int> result_wake_fd_{-1};  ///< 结果唤醒 fd（-1 = 不通知）。
 
-  std::mutex result_mutex_;  ///< 结果缓冲区互斥锁。
-  std::vector<AsyncResult> results_;  ///< 待主线程消费的执行结果。
+  // 以下映射仅由主线程（唯一生产者）读写，无需加锁。
+  std::unordered_map<std::string, std::size_t> lane_by_order_id_;
+  std::deque<std::string> lane_map_fifo_;  ///< 映射剪枝用的插入顺序。
 };
 
 }  // namespace ai_trade
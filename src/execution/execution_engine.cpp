@@ -2,11 +2,12 @@
 
 #include <algorithm>
 #include <atomic>
-#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <random>
 
+#include "core/clock.h"
+
 namespace ai_trade {
 
 namespace {
@@ -14,7 +15,10 @@ namespace {
 // client_order_id 规则：
 // symbol + 毫秒时间 + 进程实例随机串 + 单调序号。
 // 目标是“单进程唯一 + 可排障可追溯”。
-std::string BuildClientOrderId(const std::string& symbol) {
+// 原位拼装 "<symbol>-<ts_ms>-<instance>-<seq>"，复用 out 的既有容量；
+// 各数字段经 std::to_string 都在 SSO 内，稳态无堆分配
+// （ostringstream 版本每次调用都要构造 512B 的内部缓冲）。
+void BuildClientOrderId(const std::string& symbol, std::string* out) {
   static std::atomic<std::uint64_t> seq{0};
   // 生成一个进程生命周期内唯一的随机标识 (Instance ID)
   static const std::string instance_id = []() {
@@ -24,13 +28,20 @@ std::string BuildClientOrderId(const std::string& symbol) {
     return std::to_string(dist(gen));
   }();
 
-  const auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(
-      std::chrono::system_clock::now());
-  const auto ts_ms = now.time_since_epoch().count();
+  out->clear();
+  out->append(symbol);
+  out->push_back('-');
+  out->append(std::to_string(NowMsCached()));
+  out->push_back('-');
+  out->append(instance_id);
+  out->push_back('-');
+  out->append(std::to_string(seq.fetch_add(1, std::memory_order_relaxed)));
+}
 
-  std::ostringstream oss;
-  oss << symbol << "-" << ts_ms << "-" << instance_id << "-" << seq.fetch_add(1, std::memory_order_relaxed);
-  return oss.str();
+std::string BuildClientOrderId(const std::string& symbol) {
+  std::string out;
+  BuildClientOrderId(symbol, &out);
+  return out;
 }
 
 }  // namespace
@@ -129,10 +140,21 @@ std::optional<OrderIntent> ExecutionEngine::BuildIntent(
     const RiskAdjustedPosition& target,
     double current_notional_usd,
     double price) const {
-  constexpr double kEpsilon = 1e-4;
-  if (price <= 0.0) {
+  OrderIntent intent;
+  if (!BuildIntentInto(target, current_notional_usd, price, &intent)) {
     return std::nullopt;
   }
+  return intent;
+}
+
+bool ExecutionEngine::BuildIntentInto(const RiskAdjustedPosition& target,
+                                      double current_notional_usd,
+                                      double price,
+                                      OrderIntent* out) const {
+  constexpr double kEpsilon = 1e-4;
+  if (out == nullptr || price <= 0.0) {
+    return false;
+  }
 
   double effective_target = target.adjusted_notional_usd;
   // 任何“目标归零”的现有仓位收敛都应按 reduce-only 表达；否则 inactive
@@ -145,7 +167,7 @@ std::optional<OrderIntent> ExecutionEngine::BuildIntent(
   // ReduceOnly/归零收敛语义：只能向 0 方向减仓，禁止加仓和反手开仓。
   if (risk_converging_only) {
     if (std::fabs(current_notional_usd) < kEpsilon) {
-      return std::nullopt;
+      return false;
     }
     if (current_notional_usd > 0.0) {
       effective_target = std::clamp(effective_target, 0.0, current_notional_usd);
@@ -169,7 +191,7 @@ std::optional<OrderIntent> ExecutionEngine::BuildIntent(
   // 防抖：净名义敞口总变动过小则不下单，减少无效交易和手续费磨损。
   if (!risk_converging_only &&
       std::fabs(total_delta) < min_rebalance_notional_usd) {
-    return std::nullopt;
+    return false;
   }
 
   // 反向切仓：
@@ -180,57 +202,57 @@ std::optional<OrderIntent> ExecutionEngine::BuildIntent(
       std::fabs(effective_target) >= kEpsilon &&
       (current_notional_usd * effective_target < -kEpsilon)) {
     if (config_.direct_flip_entry_enabled) {
-      OrderIntent flip_intent;
-      flip_intent.client_order_id = BuildClientOrderId(target.symbol);
-      flip_intent.symbol = target.symbol;
-      flip_intent.reduce_only = false;
-      flip_intent.purpose = OrderPurpose::kEntry;
+      BuildClientOrderId(target.symbol, &out->client_order_id);
+      out->parent_order_id.clear();
+      out->symbol = target.symbol;
+      out->reduce_only = false;
+      out->purpose = OrderPurpose::kEntry;
       // direct flip 属于策略性切仓，不是风控强制减仓；默认仍走 maker-first。
-      flip_intent.liquidity_preference = LiquidityPreference::kMaker;
-      flip_intent.direction = (total_delta > 0.0) ? 1 : -1;
+      out->liquidity_preference = LiquidityPreference::kMaker;
+      out->direction = (total_delta > 0.0) ? 1 : -1;
       const double flip_notional =
           std::min(std::fabs(total_delta), config_.max_order_notional_usd);
-      flip_intent.qty = flip_notional / price;
-      flip_intent.price = price;
-      return flip_intent;
+      out->qty = flip_notional / price;
+      out->price = price;
+      return true;
     }
 
     // 默认模式：第一步只平旧仓，不在同一笔意图中携带新方向开仓。
     const double close_notional =
         std::min(std::fabs(current_notional_usd), config_.max_order_notional_usd);
 
-    OrderIntent close_intent;
-    close_intent.client_order_id = BuildClientOrderId(target.symbol);
-    close_intent.symbol = target.symbol;
-    close_intent.reduce_only = true;
-    close_intent.purpose = OrderPurpose::kReduce;
+    BuildClientOrderId(target.symbol, &out->client_order_id);
+    out->parent_order_id.clear();
+    out->symbol = target.symbol;
+    out->reduce_only = true;
+    out->purpose = OrderPurpose::kReduce;
     // 反手第一步是策略性平旧仓，优先 maker；风控 forced reduce-only
     // 会走上方 risk_converging_only 分支并保留 taker。
-    close_intent.liquidity_preference = LiquidityPreference::kMaker;
-    close_intent.direction = (current_notional_usd > 0.0) ? -1 : 1;
-    close_intent.qty = close_notional / price;
-    close_intent.price = price;
-    return close_intent;
+    out->liquidity_preference = LiquidityPreference::kMaker;
+    out->direction = (current_notional_usd > 0.0) ? -1 : 1;
+    out->qty = close_notional / price;
+    out->price = price;
+    return true;
   }
 
   if (std::fabs(total_delta) < kEpsilon) {
-    return std::nullopt;
+    return false;
   }
 
-  OrderIntent intent;
-  intent.client_order_id = BuildClientOrderId(target.symbol);
-  intent.symbol = target.symbol;
-  intent.reduce_only = risk_converging_only;
-  intent.purpose = risk_converging_only ? OrderPurpose::kReduce : OrderPurpose::kEntry;
-  intent.liquidity_preference =
+  BuildClientOrderId(target.symbol, &out->client_order_id);
+  out->parent_order_id.clear();
+  out->symbol = target.symbol;
+  out->reduce_only = risk_converging_only;
+  out->purpose = risk_converging_only ? OrderPurpose::kReduce : OrderPurpose::kEntry;
+  out->liquidity_preference =
       forced_reduce_only ? LiquidityPreference::kTaker
                          : LiquidityPreference::kMaker;
-  intent.direction = (total_delta > 0.0) ? 1 : -1;
+  out->direction = (total_delta > 0.0) ? 1 : -1;
   const double order_notional =
       std::min(std::fabs(total_delta), config_.max_order_notional_usd);
-  intent.qty = order_notional / price;
-  intent.price = price;
-  return intent;
+  out->qty = order_notional / price;
+  out->price = price;
+  return true;
 }
 
 std::optional<OrderIntent> ExecutionEngine::BuildProtectionIntent(
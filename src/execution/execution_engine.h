@@ -81,6 +81,9 @@ class ExecutionEngine {
   explicit ExecutionEngine(ExecutionEngineConfig config)
       : config_(config) {}
 
+  /// 热更新执行层参数（含保护参数），不影响在途订单状态。
+  void SetConfig(const ExecutionEngineConfig& config) { config_ = config; }
+
   /**
    * @brief 构建交易意图
    *
@@ -93,6 +96,13 @@ class ExecutionEngine {
                                          double current_notional_usd,
                                          double price) const;
 
+  /// BuildIntent 的原位版本：复用 out 的字符串容量，热路径稳态零分配。
+  /// 返回 false 表示本 tick 无需下单（此时 out 内容未定义）。
+  bool BuildIntentInto(const RiskAdjustedPosition& target,
+                       double current_notional_usd,
+                       double price,
+                       OrderIntent* out) const;
+
   /**
    * @brief 构建保护性订单意图（止盈/止损）
    *
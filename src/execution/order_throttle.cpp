@@ -41,6 +41,30 @@ bool OrderThrottle::Allow(const OrderIntent& intent,
     return false;
   }
 
+  // 规则 0: 账户级 API 预算 (Token Bucket)
+  // 对齐交易所限频窗口，在本地挡住会触发 429 的突发；reduce-only
+  // 订单（平仓/保护）永不因预算被拒，改为在 OnAccepted 透支记账。
+  if (config_.api_budget_per_window > 0 && now_ms > 0 &&
+      !intent.reduce_only) {
+    RefillBuckets(now_ms);
+    const bool account_exhausted = account_bucket_.tokens < 1;
+    const bool order_exhausted =
+        config_.api_order_budget_per_window > 0 && order_bucket_.tokens < 1;
+    if (account_exhausted || order_exhausted) {
+      if (out_reason != nullptr) {
+        const std::int64_t window_ms =
+            static_cast<std::int64_t>(config_.api_budget_window_ms);
+        const std::int64_t remaining =
+            account_bucket_.window_start_ms + window_ms - now_ms;
+        *out_reason = "api_budget_exhausted_ms_remaining=" +
+                      std::to_string(std::max<std::int64_t>(remaining, 0));
+      }
+      on_rejected(&OrderThrottleStats::budget_rejects,
+                  &OrderThrottleStats::budget_rejects);
+      return false;
+    }
+  }
+
   const auto it = state_by_symbol_.find(intent.symbol);
   if (it == state_by_symbol_.end()) {
     on_allowed();
@@ -108,6 +132,43 @@ void OrderThrottle::OnAccepted(const OrderIntent& intent,
   if (!intent.reduce_only && intent.direction != 0) {
     state.last_entry_direction = intent.direction;
   }
+
+  // 消费 API 预算令牌；reduce-only 可把桶打到负值（透支），由下个
+  // 窗口边界的整窗补满偿还——保护单排队而非被丢弃。
+  if (config_.api_budget_per_window > 0 && now_ms > 0) {
+    RefillBuckets(now_ms);
+    --account_bucket_.tokens;
+    if (config_.api_order_budget_per_window > 0) {
+      --order_bucket_.tokens;
+    }
+    total_stats_.account_budget_tokens = account_bucket_.tokens;
+    total_stats_.order_budget_tokens = order_bucket_.tokens;
+    window_stats_.account_budget_tokens = account_bucket_.tokens;
+    window_stats_.order_budget_tokens = order_bucket_.tokens;
+  }
+}
+
+void OrderThrottle::RefillBuckets(std::int64_t now_ms) {
+  const std::int64_t window_ms =
+      static_cast<std::int64_t>(config_.api_budget_window_ms);
+  if (account_bucket_.window_start_ms <= 0) {
+    account_bucket_.window_start_ms = now_ms;
+    account_bucket_.tokens = config_.api_budget_per_window;
+    order_bucket_.window_start_ms = now_ms;
+    order_bucket_.tokens = config_.api_order_budget_per_window;
+  } else if (window_ms > 0 &&
+             now_ms - account_bucket_.window_start_ms >= window_ms) {
+    // 对齐窗口边界整窗补满（不跨窗累积），透支余额一并清偿。
+    account_bucket_.window_start_ms =
+        now_ms - (now_ms - account_bucket_.window_start_ms) % window_ms;
+    account_bucket_.tokens = config_.api_budget_per_window;
+    order_bucket_.window_start_ms = account_bucket_.window_start_ms;
+    order_bucket_.tokens = config_.api_order_budget_per_window;
+  }
+  total_stats_.account_budget_tokens = account_bucket_.tokens;
+  total_stats_.order_budget_tokens = order_bucket_.tokens;
+  window_stats_.account_budget_tokens = account_bucket_.tokens;
+  window_stats_.order_budget_tokens = order_bucket_.tokens;
 }
 
 OrderThrottleStats OrderThrottle::ConsumeWindowStats() {
@@ -13,6 +13,12 @@ struct OrderThrottleConfig {
   int min_order_interval_ms{0};
   // 开仓方向反转后的冷静期（按行情 tick 计数），0 表示不启用。
   int reverse_signal_cooldown_ticks{0};
+  // 账户级 API 预算：每窗口允许的请求数，0 表示不启用限频。
+  int api_budget_per_window{0};
+  // API 预算窗口长度（毫秒），按交易所限频窗口边界整窗补满令牌。
+  int api_budget_window_ms{5000};
+  // 下单/撤单 endpoint 类子桶的每窗口预算，0 表示不启用该层。
+  int api_order_budget_per_window{0};
 };
 
 /// 节流统计快照：用于运行态命中率观测。
@@ -23,6 +29,10 @@ struct OrderThrottleStats {
   std::uint64_t interval_rejects{0};  // 最小间隔命中次数。
   std::uint64_t reverse_rejects{0};  // 反向冷却命中次数。
   std::uint64_t invalid_rejects{0};  // 非法意图命中次数。
+  std::uint64_t budget_rejects{0};  // API 预算耗尽命中次数。
+  // 桶内剩余令牌快照（reduce-only 透支时可为负）；随每次检查刷新。
+  std::int64_t account_budget_tokens{0};
+  std::int64_t order_budget_tokens{0};
 };
 
 /**
@@ -31,13 +41,20 @@ struct OrderThrottleStats {
  * 目标：
  * 1. 限制同一 symbol 的最小下单间隔，避免高频重复下单；
  * 2. 限制开仓方向快速反转，降低来回打脸（whipsaw）风险；
- * 3. 仅做“准入判断”，不改变订单内容。
+ * 3. 按层级令牌桶对齐交易所账户级限频窗口，在本地挡住会触发
+ *    HTTP 429 的突发（账户桶 + 下单 endpoint 类子桶，窗口边界整窗
+ *    补满）；reduce-only 订单永不因预算被拒，改为透支令牌记账，
+ *    由后续窗口的补满偿还；
+ * 4. 仅做“准入判断”，不改变订单内容。
  */
 class OrderThrottle {
  public:
   explicit OrderThrottle(OrderThrottleConfig config)
       : config_(config) {}
 
+  /// 热更新节流参数（各 symbol 冷却状态保持不变）。
+  void SetConfig(const OrderThrottleConfig& config) { config_ = config; }
+
   /**
    * @brief 判断订单是否可放行
    *
@@ -68,6 +85,15 @@ class OrderThrottle {
   OrderThrottleStats ConsumeWindowStats();
 
  private:
+  /// 单个令牌桶：窗口边界整窗补满，消费可透支（reduce-only）。
+  struct TokenBucket {
+    std::int64_t tokens{0};
+    std::int64_t window_start_ms{0};
+  };
+
+  /// 按窗口边界补满两级令牌桶并刷新统计快照。
+  void RefillBuckets(std::int64_t now_ms);
+
   struct SymbolState {
     // 最近一次成功排队下单的时间戳（毫秒）。
     std::int64_t last_submit_ms{0};
@@ -79,6 +105,8 @@ class OrderThrottle {
 
   OrderThrottleConfig config_;
   std::unordered_map<std::string, SymbolState> state_by_symbol_;
+  TokenBucket account_bucket_;  ///< 账户级 API 预算桶。
+  TokenBucket order_bucket_;  ///< 下单 endpoint 类子桶。
   OrderThrottleStats total_stats_;  ///< 全量累计节流统计。
   OrderThrottleStats window_stats_;  ///< 自上次消费以来的窗口统计。
 };
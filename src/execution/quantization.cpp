@@ -0,0 +1,107 @@
+#include "execution/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "exchange/exchange_adapter.h"
+
+namespace ai_trade {
+
+namespace {
+
+constexpr double kQtyEpsilon = 1e-12;
+constexpr double kNotionalEpsilon = 1e-9;
+
+/// 构造 "%.Nf" 形式的精度模板；精度夹取到 [0, 12]。
+void BuildFormat(int precision, char* out, std::size_t out_size) {
+  const int clamped = std::clamp(precision, 0, 12);
+  std::snprintf(out, out_size, "%%.%df", clamped);
+}
+
+}  // namespace
+
+double SymbolQuantization::QuantizeQtyFloor(double qty) const {
+  if (inv_qty_step <= 0.0) {
+    return qty;
+  }
+  const double steps = std::floor((qty + kQtyEpsilon) * inv_qty_step);
+  return steps > 0.0 ? steps * qty_step : 0.0;
+}
+
+double SymbolQuantization::StepNotionalFloor(double price,
+                                             double base_floor_usd) const {
+  const double base_floor = std::max(0.0, base_floor_usd);
+  if (base_floor <= kNotionalEpsilon || !tradable ||
+      inv_qty_step <= 0.0 || !std::isfinite(price) ||
+      price <= kNotionalEpsilon) {
+    return base_floor;
+  }
+  const double min_qty =
+      std::max(base_floor / price, std::max(0.0, min_order_qty));
+  const double steps =
+      std::ceil(std::max(0.0, min_qty - kQtyEpsilon) * inv_qty_step);
+  if (!std::isfinite(steps) || steps <= 0.0) {
+    return base_floor;
+  }
+  return std::max(base_floor, steps * qty_step * price);
+}
+
+void SymbolQuantization::AppendFormattedQty(double qty,
+                                            std::string* out) const {
+  if (out == nullptr) {
+    return;
+  }
+  char buffer[32];
+  const int written = std::snprintf(buffer, sizeof(buffer), qty_format, qty);
+  if (written > 0) {
+    out->append(buffer, static_cast<std::size_t>(
+                            std::min<int>(written, sizeof(buffer) - 1)));
+  }
+}
+
+void QuantizationTable::Load(const SymbolInfo& info) {
+  SymbolQuantization quant;
+  quant.tradable = info.tradable;
+  quant.qty_step = info.qty_step;
+  quant.inv_qty_step =
+      info.qty_step > kQtyEpsilon ? 1.0 / info.qty_step : 0.0;
+  quant.min_order_qty = info.min_order_qty;
+  quant.min_notional_usd = info.min_notional_usd;
+  quant.price_tick = info.price_tick;
+  quant.inv_price_tick =
+      info.price_tick > kQtyEpsilon ? 1.0 / info.price_tick : 0.0;
+  BuildFormat(info.qty_precision, quant.qty_format, sizeof(quant.qty_format));
+  BuildFormat(info.price_precision, quant.price_format,
+              sizeof(quant.price_format));
+  by_symbol_[info.symbol] = quant;
+}
+
+const SymbolQuantization* QuantizationTable::Find(
+    const std::string& symbol) const {
+  const auto it = by_symbol_.find(symbol);
+  return it != by_symbol_.end() ? &it->second : nullptr;
+}
+
+const SymbolQuantization* QuantizationTable::FindOrLoad(
+    const std::string& symbol, const ExchangeAdapter* adapter) {
+  if (const SymbolQuantization* found = Find(symbol); found != nullptr) {
+    return found;
+  }
+  if (adapter == nullptr || symbol.empty()) {
+    return nullptr;
+  }
+  SymbolInfo info;
+  if (!adapter->GetSymbolInfo(symbol, &info)) {
+    // 查询失败不缓存负结果：适配器恢复后下次即可补载。
+    return nullptr;
+  }
+  Load(info);
+  if (info.symbol != symbol) {
+    // 适配器可能返回规范化 symbol：同时按查询键建立别名，避免反复补载。
+    by_symbol_[symbol] = by_symbol_[info.symbol];
+  }
+  return Find(symbol);
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "core/types.h"
+
+namespace ai_trade {
+
+class ExchangeAdapter;
+
+/**
+ * @brief 单 symbol 预计算量化表
+ *
+ * 在 `SymbolInfo` 加载时一次性算好倒数乘子与格式化模板，之后构造
+ * 订单的数量步长对齐、最小名义金额地板与精度格式化都不再做除法、
+ * 不再按单拼 snprintf 模板——热路径只剩乘法与查表。
+ */
+struct SymbolQuantization {
+  bool tradable{false};
+  double qty_step{0.0};
+  double inv_qty_step{0.0};  ///< 1 / qty_step 倒数乘子；步长无效时为 0。
+  double min_order_qty{0.0};
+  double min_notional_usd{0.0};
+  double price_tick{0.0};
+  double inv_price_tick{0.0};  ///< 1 / price_tick 倒数乘子。
+  char qty_format[8]{"%.8f"};  ///< 预构造的数量精度模板。
+  char price_format[8]{"%.8f"};  ///< 预构造的价格精度模板。
+
+  /// 数量向下对齐到步长（乘法 + floor，无除法）；步长无效时原样返回。
+  double QuantizeQtyFloor(double qty) const;
+
+  /// 步长感知的最小可执行名义金额地板（与 min-notional 预检共用）。
+  double StepNotionalFloor(double price, double base_floor_usd) const;
+
+  /// 按预构造精度模板格式化数量（追加到 `out`）。
+  void AppendFormattedQty(double qty, std::string* out) const;
+};
+
+/**
+ * @brief symbol → 量化表缓存
+ *
+ * 启动期由 Universe 初始化批量加载；运行中遇到未加载 symbol
+ * （如恢复路径注入的遗留持仓）时按需从适配器补载。
+ */
+class QuantizationTable {
+ public:
+  /// 从交易所 symbol 规则构建并缓存量化表（重复加载覆盖旧表）。
+  void Load(const SymbolInfo& info);
+
+  /// 查缓存；未命中返回 nullptr。
+  const SymbolQuantization* Find(const std::string& symbol) const;
+
+  /// 查缓存，未命中时从适配器按需补载；适配器无规则时返回 nullptr。
+  const SymbolQuantization* FindOrLoad(const std::string& symbol,
+                                       const ExchangeAdapter* adapter);
+
+  std::size_t size() const { return by_symbol_.size(); }
+
+ private:
+  std::unordered_map<std::string, SymbolQuantization> by_symbol_;
+};
+
+}  // namespace ai_trade
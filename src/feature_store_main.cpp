@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "core/log.h"
+#include "research/bar_store.h"
+#include "research/feature_store_builder.h"
+#include "research/miner.h"
+
+namespace {
+
+struct FeatureStoreOptions {
+  std::string input_path;
+  std::string output_path;
+  std::string binary_output_path;
+  std::string report_path;
+  int forward_bars{12};
+  int threads{0};
+  bool keep_na{false};
+  bool show_help{false};
+};
+
+void PrintUsage() {
+  ai_trade::LogInfo(
+      "用法: trade_feature_store --input <ohlcv.csv|columnar.bin> "
+      "--output <feature.csv> [--binary-output <feature.bin>] "
+      "[--forward-bars N] [--threads N] [--keep-na] [--report <report.json>]");
+  ai_trade::LogInfo(
+      "以 time_series_operators 为唯一实现构建特征矩阵，列集合与 "
+      "tools/build_feature_store.py 一致；输入为列式文件时 mmap 零拷贝扫描");
+}
+
+// 解析 `--key value` 与 `--key=value` 两种形式（与 Python 工具的
+// 命令行兼容，便于 run_data_pipeline 原样替换命令头）。
+bool ParseOptions(int argc, char** argv, FeatureStoreOptions* options) {
+  const auto take_value = [&](int* index, const std::string& arg,
+                              std::string* out_value) {
+    const std::size_t eq = arg.find('=');
+    if (eq != std::string::npos) {
+      *out_value = arg.substr(eq + 1);
+      return true;
+    }
+    if (*index + 1 >= argc) {
+      return false;
+    }
+    *index += 1;
+    *out_value = argv[*index];
+    return true;
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const std::string key = arg.substr(0, arg.find('='));
+    std::string value;
+    if (key == "--help" || key == "-h") {
+      options->show_help = true;
+      return true;
+    }
+    if (key == "--keep-na") {
+      options->keep_na = true;
+      continue;
+    }
+    if (key == "--input") {
+      if (!take_value(&i, arg, &options->input_path)) {
+        return false;
+      }
+      continue;
+    }
+    if (key == "--output") {
+      if (!take_value(&i, arg, &options->output_path)) {
+        return false;
+      }
+      continue;
+    }
+    if (key == "--binary-output") {
+      if (!take_value(&i, arg, &options->binary_output_path)) {
+        return false;
+      }
+      continue;
+    }
+    if (key == "--report") {
+      if (!take_value(&i, arg, &options->report_path)) {
+        return false;
+      }
+      continue;
+    }
+    if (key == "--forward-bars") {
+      if (!take_value(&i, arg, &value)) {
+        return false;
+      }
+      options->forward_bars = std::atoi(value.c_str());
+      continue;
+    }
+    if (key == "--threads") {
+      if (!take_value(&i, arg, &value)) {
+        return false;
+      }
+      options->threads = std::atoi(value.c_str());
+      continue;
+    }
+    ai_trade::LogError("未知参数: " + arg);
+    return false;
+  }
+  return !options->input_path.empty() && !options->output_path.empty();
+}
+
+std::string BuildSummaryJson(const FeatureStoreOptions& options,
+                             std::size_t rows_input,
+                             std::size_t rows_output) {
+  std::string json = "{";
+  json += "\"input\": \"" + options.input_path + "\", ";
+  json += "\"output\": \"" + options.output_path + "\", ";
+  json += "\"rows_input\": " + std::to_string(rows_input) + ", ";
+  json += "\"rows_output\": " + std::to_string(rows_output) + ", ";
+  json += "\"forward_bars\": " +
+          std::to_string(std::max(1, options.forward_bars)) + ", ";
+  json += std::string("\"drop_na\": ") + (options.keep_na ? "false" : "true");
+  json += "}";
+  return json;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FeatureStoreOptions options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 1;
+  }
+  if (options.show_help) {
+    PrintUsage();
+    return 0;
+  }
+
+  ai_trade::research::FeatureBuildOptions build_options;
+  build_options.forward_bars = options.forward_bars;
+  build_options.threads = options.threads;
+
+  // 优先按列式文件打开（mmap 零解析）；magic 不匹配时回退 CSV 解析。
+  std::string error;
+  ai_trade::research::FeatureMatrix matrix;
+  std::size_t rows_input = 0;
+  ai_trade::research::ColumnarBarStore store;
+  if (store.Open(options.input_path, &error)) {
+    rows_input = store.Count();
+    if (!ai_trade::research::BuildFeatureMatrix(store, build_options, &matrix,
+                                                &error)) {
+      ai_trade::LogError("特征构建失败: " + error);
+      return 2;
+    }
+  } else {
+    std::vector<ai_trade::research::ResearchBar> bars;
+    if (!ai_trade::research::LoadResearchBarsFromCsv(options.input_path, &bars,
+                                                     &error)) {
+      ai_trade::LogError("输入数据加载失败: " + error);
+      return 2;
+    }
+    rows_input = bars.size();
+    if (!ai_trade::research::BuildFeatureMatrix(bars, build_options, &matrix,
+                                                &error)) {
+      ai_trade::LogError("特征构建失败: " + error);
+      return 2;
+    }
+  }
+
+  std::size_t rows_output = 0;
+  if (!ai_trade::research::WriteFeatureMatrixCsv(
+          matrix, options.output_path, /*drop_na=*/!options.keep_na,
+          &rows_output, &error)) {
+    ai_trade::LogError("特征 CSV 写出失败: " + error);
+    return 2;
+  }
+  if (!options.binary_output_path.empty() &&
+      !ai_trade::research::WriteFeatureMatrixBinary(
+          matrix, options.binary_output_path, &error)) {
+    ai_trade::LogError("特征二进制写出失败: " + error);
+    return 2;
+  }
+
+  const std::string summary =
+      BuildSummaryJson(options, rows_input, rows_output);
+  if (!options.report_path.empty()) {
+    std::FILE* report = std::fopen(options.report_path.c_str(), "w");
+    if (report == nullptr) {
+      ai_trade::LogError("特征报告写出失败: " + options.report_path);
+      return 2;
+    }
+    std::fwrite(summary.data(), 1, summary.size(), report);
+    std::fputc('\n', report);
+    std::fclose(report);
+  }
+  // 摘要 JSON 走 stdout，与 Python 版工具一致，便于管道消费。
+  std::fwrite(summary.data(), 1, summary.size(), stdout);
+  std::fputc('\n', stdout);
+  std::fflush(stdout);
+  ai_trade::LogFlush();
+  return rows_output > 0 ? 0 : 2;
+}
@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "core/log.h"
+#include "storage/decision_journal.h"
+
+namespace {
+
+void PrintUsage() {
+  ai_trade::LogInfo(
+      "用法: trade_journal_dump <decisions-*.dj> [more files...]");
+  ai_trade::LogInfo(
+      "按参数顺序解码二进制决策日志，向 stdout 输出 JSONL（每条决策一行）");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      return 0;
+    }
+    files.push_back(arg);
+  }
+  if (files.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::uint64_t total_records = 0;
+  for (const auto& file : files) {
+    std::vector<ai_trade::DecisionJournalRecord> records;
+    std::string error;
+    if (!ai_trade::DecisionJournal::ReadFile(file, &records, &error)) {
+      ai_trade::LogError("决策日志解码失败: " + error);
+      return 1;
+    }
+    // JSONL 走 stdout，诊断信息走日志通道，方便下游直接管道消费。
+    for (const auto& record : records) {
+      const std::string line = ai_trade::DecisionJournal::ToJsonLine(record);
+      std::fwrite(line.data(), 1, line.size(), stdout);
+      std::fputc('\n', stdout);
+    }
+    total_records += records.size();
+  }
+  std::fflush(stdout);
+  ai_trade::LogInfo("决策日志解码完成: files=" + std::to_string(files.size()) +
+                    ", records=" + std::to_string(total_records));
+  ai_trade::LogFlush();
+  return 0;
+}
@@ -413,7 +413,9 @@ int main(int argc, char** argv) {
   // 1) 解析 CLI 覆盖参数。
   const RuntimeOptions options = ParseOptions(argc, argv);
   if (options.run_miner) {
-    return RunOfflineMiner(options);
+    const int exit_code = RunOfflineMiner(options);
+    ai_trade::LogFlush();
+    return exit_code;
   }
   // 2) 加载 YAML 基础配置。
   ai_trade::AppConfig config;
@@ -421,6 +423,7 @@ int main(int argc, char** argv) {
   if (!ai_trade::LoadAppConfigFromYaml(options.config_path, &config,
                                        &config_error)) {
     ai_trade::LogError("配置加载失败: " + config_error);
+    ai_trade::LogFlush();
     return 1;
   }
   // 3) 应用 CLI 覆盖参数并启动应用。
@@ -446,8 +449,18 @@ int main(int argc, char** argv) {
       FormatSymbolList(config.universe.candidate_symbols) + "]}");
 
   ai_trade::BotApplication app(config);
-  if (options.check_startup) {
-    return app.CheckStartup();
-  }
-  return app.Run();
+  if (!options.check_startup) {
+    std::string watch_error;
+    if (app.EnableConfigHotReload(options.config_path, &watch_error)) {
+      ai_trade::LogInfo("CONFIG_HOT_RELOAD_ENABLED: path=" +
+                        options.config_path);
+    } else {
+      ai_trade::LogError("配置热加载启动失败（继续以静态配置运行）: " +
+                         watch_error);
+    }
+  }
+  const int exit_code = options.check_startup ? app.CheckStartup() : app.Run();
+  // 退出前等待异步日志线程清空队列，避免尾部日志丢失。
+  ai_trade::LogFlush();
+  return exit_code;
 }
@@ -1,17 +1,22 @@
 #include "market/market_data.h"
 
+#include "core/symbol_table.h"
+
 namespace ai_trade {
 
 MarketEvent MarketData::Next(double price, const std::string& symbol) {
   ++seq_;
   // 当前骨架将成交价与标记价保持一致，方便回放和测试。
   constexpr std::int64_t kDefaultIntervalMs = 5000;
-  return MarketEvent{seq_ * kDefaultIntervalMs,
-                     symbol,
-                     price,
-                     price,
-                     1000.0,
-                     kDefaultIntervalMs};
+  MarketEvent event{seq_ * kDefaultIntervalMs,
+                    symbol,
+                    price,
+                    price,
+                    1000.0,
+                    kDefaultIntervalMs};
+  // 行情入口统一 intern，下游引擎按 id 做稠密索引。
+  event.symbol_id = InternSymbol(symbol);
+  return event;
 }
 
 }  // namespace ai_trade
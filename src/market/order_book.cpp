@@ -0,0 +1,141 @@
+#include "market/order_book.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ai_trade {
+
+double OrderBookSnapshot::ImbalanceTop(int levels) const {
+  if (!valid() || levels <= 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  double bid_qty = 0.0;
+  double ask_qty = 0.0;
+  const int bid_levels = std::min(levels, bid_count);
+  for (int i = 0; i < bid_levels; ++i) {
+    bid_qty += bids[i].qty;
+  }
+  const int ask_levels = std::min(levels, ask_count);
+  for (int i = 0; i < ask_levels; ++i) {
+    ask_qty += asks[i].qty;
+  }
+  const double total = bid_qty + ask_qty;
+  if (total <= 0.0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return (bid_qty - ask_qty) / total;
+}
+
+void FixedDepthOrderBook::Reset() {
+  seq_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  book_ = OrderBookSnapshot{};
+  anchored_ = false;
+  std::atomic_thread_fence(std::memory_order_release);
+  seq_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool FixedDepthOrderBook::Begin(std::int64_t ts_ms,
+                                std::int64_t update_id,
+                                bool is_snapshot) {
+  if (!is_snapshot) {
+    // delta 只在已锚定且序号前进时接受；乱序/重复帧直接丢弃，
+    // 交易所会在序号断裂时重发 snapshot 重建。
+    if (!anchored_ || update_id <= book_.update_id) {
+      return false;
+    }
+  }
+  seq_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  if (is_snapshot) {
+    book_.bid_count = 0;
+    book_.ask_count = 0;
+  }
+  book_.ts_ms = ts_ms;
+  book_.update_id = update_id;
+  anchored_ = true;
+  return true;
+}
+
+void FixedDepthOrderBook::Commit() {
+  std::atomic_thread_fence(std::memory_order_release);
+  seq_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FixedDepthOrderBook::SetBid(double price, double qty) {
+  UpsertLevel(book_.bids, &book_.bid_count, price, qty, /*descending=*/true);
+}
+
+void FixedDepthOrderBook::SetAsk(double price, double qty) {
+  UpsertLevel(book_.asks, &book_.ask_count, price, qty, /*descending=*/false);
+}
+
+void FixedDepthOrderBook::UpsertLevel(OrderBookLevel* levels,
+                                      int* count,
+                                      double price,
+                                      double qty,
+                                      bool descending) {
+  if (!(price > 0.0)) {
+    return;
+  }
+  // 价格来自同一交易所的同一字符串解析路径，double 相等比较可判同档。
+  int pos = 0;
+  while (pos < *count) {
+    if (levels[pos].price == price) {
+      if (qty <= 0.0) {
+        // 删除：后续档位前移补位。
+        std::memmove(&levels[pos], &levels[pos + 1],
+                     static_cast<std::size_t>(*count - pos - 1) *
+                         sizeof(OrderBookLevel));
+        --*count;
+      } else {
+        levels[pos].qty = qty;
+      }
+      return;
+    }
+    const bool better = descending ? price > levels[pos].price
+                                   : price < levels[pos].price;
+    if (better) {
+      break;
+    }
+    ++pos;
+  }
+  if (qty <= 0.0) {
+    return;  // 删除不存在的价位：簿深超出本地截断时的正常情况。
+  }
+  if (pos >= kOrderBookMaxDepth) {
+    return;  // 劣于末档且簿已满：超出关注深度，丢弃。
+  }
+  const int move_count = std::min(*count, kOrderBookMaxDepth - 1) - pos;
+  if (move_count > 0) {
+    std::memmove(&levels[pos + 1], &levels[pos],
+                 static_cast<std::size_t>(move_count) * sizeof(OrderBookLevel));
+  }
+  levels[pos].price = price;
+  levels[pos].qty = qty;
+  *count = std::min(*count + 1, kOrderBookMaxDepth);
+}
+
+bool FixedDepthOrderBook::ReadSnapshot(OrderBookSnapshot* out_snapshot) const {
+  if (out_snapshot == nullptr) {
+    return false;
+  }
+  // 经典 seqlock 读端：序号为偶且拷贝前后一致即成功；写端一条消息的
+  // 临界区极短，重试上限仅为防御写端异常中止。
+  for (int attempt = 0; attempt < 1024; ++attempt) {
+    const std::uint32_t before = seq_.load(std::memory_order_acquire);
+    if ((before & 1U) != 0U) {
+      continue;
+    }
+    *out_snapshot = book_;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint32_t after = seq_.load(std::memory_order_relaxed);
+    if (before == after) {
+      return out_snapshot->update_id > 0;
+    }
+  }
+  return false;
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace ai_trade {
+
+/// 订单簿定长档位上限：数组内联在结构体里，整本簿零节点分配。
+inline constexpr int kOrderBookMaxDepth = 50;
+
+/// 单个价格档位（price, qty 均为交易所原始口径）。
+struct OrderBookLevel {
+  double price{0.0};
+  double qty{0.0};
+};
+
+/**
+ * @brief 订单簿一致性快照（seqlock 读端的拷贝目标）
+ *
+ * bids 按价格降序、asks 按价格升序紧凑排列，[0] 即最优档。
+ * 定长数组 + 计数的布局使整个快照可以按位拷贝，读端无需追指针。
+ */
+struct OrderBookSnapshot {
+  std::int64_t ts_ms{0};  ///< 最近一次应用的行情时间戳。
+  std::int64_t update_id{0};  ///< 交易所更新序号（去重/乱序判定用）。
+  int bid_count{0};
+  int ask_count{0};
+  OrderBookLevel bids[kOrderBookMaxDepth];
+  OrderBookLevel asks[kOrderBookMaxDepth];
+
+  /// 买卖双边均有档位才视为可用。
+  bool valid() const { return bid_count > 0 && ask_count > 0; }
+  double best_bid() const { return bid_count > 0 ? bids[0].price : 0.0; }
+  double best_ask() const { return ask_count > 0 ? asks[0].price : 0.0; }
+  double spread() const {
+    return valid() ? asks[0].price - bids[0].price : 0.0;
+  }
+  double mid() const {
+    return valid() ? (bids[0].price + asks[0].price) * 0.5 : 0.0;
+  }
+  /// 前 levels 档买卖量不平衡 (Σbid-Σask)/(Σbid+Σask)；不可用返回 NaN。
+  double ImbalanceTop(int levels) const;
+};
+
+/**
+ * @brief 定长数组订单簿（单写多读，seqlock 发布）
+ *
+ * 设计取舍：
+ * 1. 档位内联定长数组，插入/删除用小段 move——深度 ≤ 50 时线性扫描
+ *    对分支预测友好，实测快于任何基于节点的有序容器，且零堆分配；
+ * 2. 写端单线程（行情解析线程）按 Begin/SetBid/SetAsk/Commit 应用一条
+ *    消息，seqlock 序号在 Begin/Commit 间保持奇数；
+ * 3. 读端任意线程经 ReadSnapshot 重试拷贝，无锁且永不阻塞写端。
+ *
+ * 注意：Begin 返回 true 后必须调用 Commit，否则读端会一直重试。
+ */
+class FixedDepthOrderBook {
+ public:
+  FixedDepthOrderBook() = default;
+
+  /// 清空簿并解除锚定（重连后等待新 snapshot）。
+  void Reset();
+
+  /**
+   * @brief 开始应用一条 orderbook 消息（写端线程专用）
+   *
+   * snapshot 总是接受并清空现有档位；delta 在未锚定（尚无 snapshot）
+   * 或 update_id 不前进时拒绝，返回 false 且不进入写临界区。
+   */
+  bool Begin(std::int64_t ts_ms, std::int64_t update_id, bool is_snapshot);
+
+  /// 应用单个买档：qty==0 删除该价位，已存在则替换，否则插入。
+  void SetBid(double price, double qty);
+  /// 应用单个卖档，语义同 SetBid。
+  void SetAsk(double price, double qty);
+
+  /// 结束本条消息的应用并发布（与 Begin 配对）。
+  void Commit();
+
+  /// 读取一致性快照（任意线程）；未锚定或重试耗尽返回 false。
+  bool ReadSnapshot(OrderBookSnapshot* out_snapshot) const;
+
+  // ---- 写端线程直读（与 Begin/Commit 同线程时免 seqlock 拷贝） ----
+  bool anchored() const { return anchored_; }
+  double best_bid() const { return book_.best_bid(); }
+  double best_ask() const { return book_.best_ask(); }
+  double ImbalanceTop(int levels) const { return book_.ImbalanceTop(levels); }
+
+ private:
+  /// 在有序档位数组上定位并更新/插入/删除（descending 区分买卖方向）。
+  static void UpsertLevel(OrderBookLevel* levels,
+                          int* count,
+                          double price,
+                          double qty,
+                          bool descending);
+
+  /// seqlock 序号：奇数 = 写入中；读端拷贝前后比对判定一致性。
+  std::atomic<std::uint32_t> seq_{0};
+  OrderBookSnapshot book_{};
+  bool anchored_{false};  ///< 是否已收到首个 snapshot（写端线程专用）。
+};
+
+}  // namespace ai_trade
@@ -1,16 +1,24 @@
 #include "monitor/gate_monitor.h"
 
-#include <algorithm>
 #include <cmath>
 
+#include "core/reason_codes.h"
+
 namespace ai_trade {
 
 namespace {
 
 constexpr double kNotionalEpsilon = 1e-6;
+constexpr int kDefaultHistoryWindows = 16;
 
 }  // namespace
 
+GateMonitor::GateMonitor(GateConfig config) : config_(config) {
+  const int depth = config_.history_windows > 0 ? config_.history_windows
+                                                : kDefaultHistoryWindows;
+  history_.resize(static_cast<std::size_t>(depth));
+}
+
 bool GateMonitor::HasExposure(double notional_usd) {
   return std::fabs(notional_usd) > kNotionalEpsilon;
 }
@@ -25,17 +33,16 @@ bool GateMonitor::IsPolicyFlatSignal(
       HasExposure(adjusted.adjusted_notional_usd) || intent.has_value()) {
     return false;
   }
-  const auto has_reason = [&signal](const char* code) {
-    return std::find(signal.reason_codes.begin(),
-                     signal.reason_codes.end(),
-                     std::string(code)) != signal.reason_codes.end();
+  const auto has_reason = [&signal](ReasonCode code) {
+    return HasReason(signal.reason_mask, code);
   };
-  if (has_reason("STR_RANGE_CONFIDENCE_BLOCK") ||
-      has_reason("STR_EXTREME_BLOCK")) {
+  if (has_reason(ReasonCode::kStrRangeConfidenceBlock) ||
+      has_reason(ReasonCode::kStrExtremeBlock)) {
     return true;
   }
-  return has_reason("STR_FLAT_SIGNAL") &&
-         (has_reason("REG_RANGE") || has_reason("REG_EXTREME"));
+  return has_reason(ReasonCode::kStrFlatSignal) &&
+         (has_reason(ReasonCode::kRegRange) ||
+          has_reason(ReasonCode::kRegExtreme));
 }
 
 /**
@@ -78,6 +85,10 @@ void GateMonitor::OnFill(const FillEvent& fill) {
   ++fills_;
 }
 
+void GateMonitor::RecordDecisionLatency(std::int64_t nanos) {
+  latency_.Record(nanos);
+}
+
 /**
  * @brief 周期性 Gate 检查 (Window Check)
  * 检查当前窗口内的活跃度是否满足最小要求 (Min Activity)。
@@ -94,6 +105,11 @@ std::optional<GateWindowResult> GateMonitor::OnTick() {
   result.effective_signals = effective_signals_;
   result.fills = fills_;
   result.policy_flat_signals = policy_flat_signals_;
+  result.latency_samples = latency_.count();
+  result.latency_p50_us =
+      static_cast<double>(latency_.ApproxPercentileNanos(0.50)) / 1000.0;
+  result.latency_p99_us =
+      static_cast<double>(latency_.ApproxPercentileNanos(0.99)) / 1000.0;
 
   const bool policy_flat_observed =
       config_.allow_policy_flat_windows && policy_flat_signals_ > 0 &&
@@ -115,11 +131,44 @@ std::optional<GateWindowResult> GateMonitor::OnTick() {
     result.pass = false;
     result.fail_reasons.push_back("FAIL_LOW_ACTIVITY_FILLS");
   }
+  // 检查 3: 决策延迟 p99 是否超出预算（与活跃度异常同级告警）
+  if (config_.latency_p99_budget_us > 0.0 && result.latency_samples > 0 &&
+      result.latency_p99_us > config_.latency_p99_budget_us) {
+    result.pass = false;
+    result.fail_reasons.push_back("FAIL_LATENCY_P99_BUDGET");
+  }
 
+  PushWindowToHistory();
   ResetWindow();
   return result;
 }
 
+void GateMonitor::PushWindowToHistory() {
+  // 覆盖最旧槽位并增量修正总和：推进为 O(1)，不随历史深度重扫。
+  WindowCounters& slot = history_[history_head_];
+  if (history_filled_ == static_cast<int>(history_.size())) {
+    rolling_.raw_signals -= slot.raw_signals;
+    rolling_.order_intents -= slot.order_intents;
+    rolling_.effective_signals -= slot.effective_signals;
+    rolling_.fills -= slot.fills;
+    rolling_.policy_flat_signals -= slot.policy_flat_signals;
+  } else {
+    ++history_filled_;
+  }
+  slot.raw_signals = raw_signals_;
+  slot.order_intents = order_intents_;
+  slot.effective_signals = effective_signals_;
+  slot.fills = fills_;
+  slot.policy_flat_signals = policy_flat_signals_;
+  rolling_.raw_signals += raw_signals_;
+  rolling_.order_intents += order_intents_;
+  rolling_.effective_signals += effective_signals_;
+  rolling_.fills += fills_;
+  rolling_.policy_flat_signals += policy_flat_signals_;
+  rolling_.windows = history_filled_;
+  history_head_ = (history_head_ + 1) % history_.size();
+}
+
 void GateMonitor::ResetWindow() {
   tick_in_window_ = 0;
   raw_signals_ = 0;
@@ -127,6 +176,7 @@ void GateMonitor::ResetWindow() {
   effective_signals_ = 0;
   fills_ = 0;
   policy_flat_signals_ = 0;
+  latency_.Reset();
 }
 
 }  // namespace ai_trade
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "core/config.h"
+#include "core/latency_histogram.h"
 #include "core/types.h"
 
 namespace ai_trade {
@@ -19,20 +21,35 @@ struct GateWindowResult {
   int policy_flat_signals{0};
   bool policy_flat_pass{false};
   bool policy_flat_runtime_exempt{false};
+  std::uint64_t latency_samples{0};  ///< 本窗口决策延迟样本数。
+  double latency_p50_us{0.0};        ///< 决策延迟 p50（微秒，近似分位）。
+  double latency_p99_us{0.0};        ///< 决策延迟 p99（微秒，近似分位）。
   std::vector<std::string> fail_reasons;
 };
 
+/// 最近 N 个已关闭窗口的滚动计数（环形维护，推进 O(1)）。
+struct GateRollingStats {
+  int windows{0};               ///< 当前参与滚动统计的窗口数。
+  std::int64_t raw_signals{0};
+  std::int64_t order_intents{0};
+  std::int64_t effective_signals{0};
+  std::int64_t fills{0};
+  std::int64_t policy_flat_signals{0};
+};
+
 /**
  * @brief Gate 活跃度监控器
  *
  * 作用：
  * 1. 在固定窗口内统计信号漏斗（raw/effective/fills）；
  * 2. 检测“策略装死”或“有信号无成交”等运行异常；
- * 3. 输出告警与窗口检查结果，供上层决策或审计使用。
+ * 3. 跟踪 tick->intent 决策延迟分位，p99 超预算与活跃度异常同级告警；
+ * 4. 维护最近 N 个窗口的环形计数历史，滚动口径推进为 O(1)
+ *    （覆盖被逐出槽位并增量修正总和，无按 tick 重扫）。
  */
 class GateMonitor {
  public:
-  explicit GateMonitor(GateConfig config) : config_(config) {}
+  explicit GateMonitor(GateConfig config);
 
   /**
    * @brief 输入一轮决策结果并更新统计
@@ -44,13 +61,28 @@ class GateMonitor {
   /// 记录成交事件计数。
   void OnFill(const FillEvent& fill);
 
+  /// 记录一次 tick->intent 决策耗时样本（纳秒）。
+  void RecordDecisionLatency(std::int64_t nanos);
+
   /**
    * @brief 行情 tick 驱动窗口推进
    * @return 窗口结束时返回 Gate 判定，否则 `std::nullopt`
    */
   std::optional<GateWindowResult> OnTick();
 
+  /// 最近 `history_windows` 个已关闭窗口的滚动计数。
+  const GateRollingStats& rolling() const { return rolling_; }
+
  private:
+  /// 单个已关闭窗口的计数槽位。
+  struct WindowCounters {
+    int raw_signals{0};
+    int order_intents{0};
+    int effective_signals{0};
+    int fills{0};
+    int policy_flat_signals{0};
+  };
+
   /// 判定是否存在非零净名义敞口。
   static bool HasExposure(double notional_usd);
   /// 判定本 tick 是否属于“策略主动 flat”的政策性空仓。
@@ -59,6 +91,8 @@ class GateMonitor {
                                  const std::optional<OrderIntent>& intent);
   /// 重置窗口计数器。
   void ResetWindow();
+  /// 把刚关闭窗口写入环形历史并增量更新滚动总和（O(1)）。
+  void PushWindowToHistory();
 
   GateConfig config_;  ///< Gate 配置快照。
   int tick_in_window_{0};  ///< 当前窗口已累计 tick 数。
@@ -68,6 +102,12 @@ class GateMonitor {
   int effective_signals_{0};  ///< 有效信号计数（风控后仍有敞口）。
   int fills_{0};  ///< 成交计数。
   int policy_flat_signals_{0};  ///< 策略主动空仓信号计数。
+  LatencyHistogram latency_;  ///< 本窗口 tick->intent 决策延迟直方图。
+
+  std::vector<WindowCounters> history_;  ///< 已关闭窗口环形缓冲（定长）。
+  std::size_t history_head_{0};  ///< 下一个写入槽位。
+  int history_filled_{0};        ///< 已填充槽位数（<= 容量后饱和）。
+  GateRollingStats rolling_;     ///< 环内窗口的增量滚动总和。
 };
 
 }  // namespace ai_trade
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace ai_trade {
+
+/**
+ * @brief 内嵌 Prometheus scrape 端点
+ *
+ * 极简单线程 HTTP 服务：poll + accept，任意 GET 请求都返回
+ * `MetricsRegistry::RenderPrometheus()` 的文本（Prometheus 不关心
+ * 路径匹配，按 job 配置抓取即可）。渲染在 scrape 线程完成，只读
+ * relaxed 原子，不触碰交易热路径。
+ *
+ * 仅用于内网 observability 栈抓取，不做 TLS/认证。
+ */
+class MetricsHttpServer {
+ public:
+  MetricsHttpServer() = default;
+  ~MetricsHttpServer() { Stop(); }
+
+  MetricsHttpServer(const MetricsHttpServer&) = delete;
+  MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+  /// 绑定并监听端口（port=0 由内核分配，实际端口见 `bound_port`）。
+  bool Start(int port, std::string* out_error);
+  /// 停止监听线程并关闭套接字（幂等）。
+  void Stop();
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+  int bound_port() const { return bound_port_; }
+
+ private:
+  void ServeLoop();
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_requested_{false};
+  int listen_fd_{-1};
+  int bound_port_{0};
+};
+
+}  // namespace ai_trade
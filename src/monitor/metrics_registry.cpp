@@ -0,0 +1,140 @@
+#include "monitor/metrics_registry.h"
+
+#include <bit>
+
+#include "core/line_writer.h"
+
+namespace ai_trade {
+
+namespace {
+
+constexpr std::int64_t kFirstBucketUpperNanos = 512;
+
+std::size_t HistogramBucketIndex(std::int64_t nanos) {
+  if (nanos < kFirstBucketUpperNanos) {
+    return 0;
+  }
+  const auto value = static_cast<std::uint64_t>(nanos / kFirstBucketUpperNanos);
+  const std::size_t index = std::bit_width(value);
+  return index < MetricHistogram::kBucketCount
+             ? index
+             : MetricHistogram::kBucketCount - 1;
+}
+
+}  // namespace
+
+void MetricHistogram::Record(std::int64_t nanos) {
+  if (nanos < 0) {
+    nanos = 0;
+  }
+  buckets_[HistogramBucketIndex(nanos)].fetch_add(1,
+                                                  std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+std::int64_t MetricHistogram::BucketUpperBoundNanos(std::size_t index) {
+  if (index + 1 >= kBucketCount) {
+    return -1;  // +Inf
+  }
+  return kFirstBucketUpperNanos << index;
+}
+
+MetricsRegistry& MetricsRegistry::Instance() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+MetricCounter* MetricsRegistry::RegisterCounter(const std::string& name,
+                                                const std::string& help) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : counter_entries_) {
+    if (entry.name == name) {
+      return entry.metric;  // 重复注册幂等：返回已有槽位。
+    }
+  }
+  MetricCounter* metric = &counters_.emplace_back();
+  counter_entries_.push_back({name, help, metric});
+  return metric;
+}
+
+MetricGauge* MetricsRegistry::RegisterGauge(const std::string& name,
+                                            const std::string& help) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : gauge_entries_) {
+    if (entry.name == name) {
+      return entry.metric;
+    }
+  }
+  MetricGauge* metric = &gauges_.emplace_back();
+  gauge_entries_.push_back({name, help, metric});
+  return metric;
+}
+
+MetricHistogram* MetricsRegistry::RegisterHistogram(const std::string& name,
+                                                    const std::string& help) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : histogram_entries_) {
+    if (entry.name == name) {
+      return entry.metric;
+    }
+  }
+  MetricHistogram* metric = &histograms_.emplace_back();
+  histogram_entries_.push_back({name, help, metric});
+  return metric;
+}
+
+std::string MetricsRegistry::RenderPrometheus() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LineWriter writer(2048);
+
+  for (const auto& entry : counter_entries_) {
+    writer.Append("# HELP ").Append(entry.name).Append(' ');
+    writer.Append(entry.help).Append('\n');
+    writer.Append("# TYPE ").Append(entry.name).Append(" counter\n");
+    writer.Append(entry.name).Append(' ');
+    writer.AppendInt(static_cast<std::int64_t>(entry.metric->value()));
+    writer.Append('\n');
+  }
+
+  for (const auto& entry : gauge_entries_) {
+    writer.Append("# HELP ").Append(entry.name).Append(' ');
+    writer.Append(entry.help).Append('\n');
+    writer.Append("# TYPE ").Append(entry.name).Append(" gauge\n");
+    writer.Append(entry.name).Append(' ');
+    writer.AppendDouble(entry.metric->value());
+    writer.Append('\n');
+  }
+
+  for (const auto& entry : histogram_entries_) {
+    writer.Append("# HELP ").Append(entry.name).Append(' ');
+    writer.Append(entry.help).Append('\n');
+    writer.Append("# TYPE ").Append(entry.name).Append(" histogram\n");
+    // 累积桶：le 上界按纳秒桶界换算为秒。
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < MetricHistogram::kBucketCount; ++i) {
+      cumulative += entry.metric->bucket(i);
+      writer.Append(entry.name).Append("_bucket{le=\"");
+      const std::int64_t upper_nanos =
+          MetricHistogram::BucketUpperBoundNanos(i);
+      if (upper_nanos < 0) {
+        writer.Append("+Inf");
+      } else {
+        writer.AppendDouble(static_cast<double>(upper_nanos) / 1e9);
+      }
+      writer.Append("\"} ");
+      writer.AppendInt(static_cast<std::int64_t>(cumulative));
+      writer.Append('\n');
+    }
+    writer.Append(entry.name).Append("_sum ");
+    writer.AppendDouble(static_cast<double>(entry.metric->total_nanos()) / 1e9);
+    writer.Append('\n');
+    writer.Append(entry.name).Append("_count ");
+    writer.AppendInt(static_cast<std::int64_t>(entry.metric->count()));
+    writer.Append('\n');
+  }
+
+  return writer.TakeString();
+}
+
+}  // namespace ai_trade
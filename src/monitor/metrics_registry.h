@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ai_trade {
+
+/// 缓存行对齐的单调计数器：热路径只做一次 relaxed fetch_add。
+class alignas(64) MetricCounter {
+ public:
+  void Inc(std::uint64_t delta = 1) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+  std::uint64_t value() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+/// 缓存行对齐的瞬时值：Set/value 均为 relaxed 原子读写。
+class alignas(64) MetricGauge {
+ public:
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0.0};
+};
+
+/**
+ * @brief 原子化对数直方图（Prometheus histogram 口径）
+ *
+ * 桶界与 `LatencyHistogram` 相同（桶 0 覆盖 < 512ns，之后按 2 的幂
+ * 翻倍），但计数为 relaxed 原子，允许采集线程在热路径并发写入、
+ * scrape 线程无锁读取。`Record` 为一次定桶位运算 + 三次 relaxed 累加。
+ */
+class alignas(64) MetricHistogram {
+ public:
+  static constexpr std::size_t kBucketCount = 20;
+
+  void Record(std::int64_t nanos);
+
+  std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  std::int64_t total_nanos() const {
+    return total_nanos_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t bucket(std::size_t index) const {
+    return buckets_[index].load(std::memory_order_relaxed);
+  }
+  /// 桶上界（纳秒）；末桶返回 -1 表示 +Inf。
+  static std::int64_t BucketUpperBoundNanos(std::size_t index);
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::int64_t> total_nanos_{0};
+};
+
+/**
+ * @brief 进程级指标注册表
+ *
+ * 运行健康此前靠 grep 文本日志推断；本注册表让各组件在启动期注册
+ * counter/gauge/histogram（返回稳定指针，deque 存储不搬移），热路径
+ * 只触达自己持有的原子槽位，不经过任何查找或锁。`RenderPrometheus`
+ * 由 scrape 线程调用，按 Prometheus 文本格式导出全部指标。
+ *
+ * 注册仅应发生在启动/初始化阶段（互斥量只保护注册与遍历，不在
+ * 数据路径上）。指标名需符合 Prometheus 规范（[a-zA-Z_][a-zA-Z0-9_]*）。
+ */
+class MetricsRegistry {
+ public:
+  /// 进程单例（各组件注册与 scrape 端点共享）。
+  static MetricsRegistry& Instance();
+
+  MetricCounter* RegisterCounter(const std::string& name,
+                                 const std::string& help);
+  MetricGauge* RegisterGauge(const std::string& name, const std::string& help);
+  /// 直方图以秒为导出单位（内部记录纳秒）。
+  MetricHistogram* RegisterHistogram(const std::string& name,
+                                     const std::string& help);
+
+  /// 按 Prometheus 文本 exposition 格式渲染全部指标。
+  std::string RenderPrometheus() const;
+
+ private:
+  template <typename Metric>
+  struct Entry {
+    std::string name;
+    std::string help;
+    Metric* metric{nullptr};
+  };
+
+  mutable std::mutex mutex_;  ///< 仅保护注册与渲染遍历。
+  std::deque<MetricCounter> counters_;      ///< deque：指针稳定。
+  std::deque<MetricGauge> gauges_;
+  std::deque<MetricHistogram> histograms_;
+  std::vector<Entry<MetricCounter>> counter_entries_;
+  std::vector<Entry<MetricGauge>> gauge_entries_;
+  std::vector<Entry<MetricHistogram>> histogram_entries_;
+};
+
+}  // namespace ai_trade
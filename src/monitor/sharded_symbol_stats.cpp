@@ -0,0 +1,116 @@
+#include "monitor/sharded_symbol_stats.h"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ai_trade {
+
+ShardedSymbolStats::ShardedSymbolStats()
+    : shards_(std::make_unique<std::array<Shard, kShardCount>>()) {}
+
+std::size_t ShardedSymbolStats::IdOf(const std::string& symbol) {
+  {
+    std::shared_lock<std::shared_mutex> read_lock(registry_mutex_);
+    const auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> write_lock(registry_mutex_);
+  const auto [it, inserted] =
+      symbol_ids_.emplace(symbol, symbol_names_.size());
+  if (inserted) {
+    symbol_names_.push_back(symbol);
+  }
+  return it->second;
+}
+
+std::size_t ShardedSymbolStats::ShardIndexForThread() {
+  thread_local const std::size_t shard_index =
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) % kShardCount;
+  return shard_index;
+}
+
+void ShardedSymbolStats::Record(const std::string& symbol,
+                                bool net_quality,
+                                double realized_net_usd,
+                                double fee_usd,
+                                double notional_abs_usd) {
+  const std::size_t id = IdOf(symbol);
+  if (id >= kMaxSymbols) {
+    // 兜底路径：稠密槽位耗尽后退回注册锁下累计（实盘不应触发）。
+    std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+    while (overflow_.size() <= id - kMaxSymbols) {
+      overflow_.emplace_back();
+      overflow_.back().symbol = symbol_names_[kMaxSymbols + overflow_.size() - 1];
+    }
+    SymbolTotals& totals = overflow_[id - kMaxSymbols];
+    ++totals.fills;
+    if (net_quality) {
+      ++totals.net_quality_fills;
+    }
+    totals.realized_net_sum_usd += realized_net_usd;
+    totals.fee_usd_sum += fee_usd;
+    totals.notional_abs_usd_sum += notional_abs_usd;
+    return;
+  }
+  Slot& slot = (*shards_)[ShardIndexForThread()][id];
+  slot.fills.fetch_add(1, std::memory_order_relaxed);
+  if (net_quality) {
+    slot.net_quality_fills.fetch_add(1, std::memory_order_relaxed);
+  }
+  slot.realized_net_sum_usd.fetch_add(realized_net_usd,
+                                      std::memory_order_relaxed);
+  slot.fee_usd_sum.fetch_add(fee_usd, std::memory_order_relaxed);
+  slot.notional_abs_usd_sum.fetch_add(notional_abs_usd,
+                                      std::memory_order_relaxed);
+}
+
+void ShardedSymbolStats::Drain(std::vector<SymbolTotals>* out_totals) {
+  if (out_totals == nullptr) {
+    return;
+  }
+  out_totals->clear();
+  std::shared_lock<std::shared_mutex> read_lock(registry_mutex_);
+  const std::size_t dense_count =
+      symbol_names_.size() < kMaxSymbols ? symbol_names_.size() : kMaxSymbols;
+  for (std::size_t id = 0; id < dense_count; ++id) {
+    SymbolTotals totals;
+    for (std::size_t shard = 0; shard < kShardCount; ++shard) {
+      Slot& slot = (*shards_)[shard][id];
+      totals.fills += slot.fills.exchange(0, std::memory_order_relaxed);
+      totals.net_quality_fills +=
+          slot.net_quality_fills.exchange(0, std::memory_order_relaxed);
+      totals.realized_net_sum_usd +=
+          slot.realized_net_sum_usd.exchange(0.0, std::memory_order_relaxed);
+      totals.fee_usd_sum +=
+          slot.fee_usd_sum.exchange(0.0, std::memory_order_relaxed);
+      totals.notional_abs_usd_sum +=
+          slot.notional_abs_usd_sum.exchange(0.0, std::memory_order_relaxed);
+    }
+    if (totals.fills == 0 && totals.net_quality_fills == 0 &&
+        totals.realized_net_sum_usd == 0.0 && totals.fee_usd_sum == 0.0 &&
+        totals.notional_abs_usd_sum == 0.0) {
+      continue;
+    }
+    totals.symbol = symbol_names_[id];
+    out_totals->push_back(std::move(totals));
+  }
+  if (!overflow_.empty()) {
+    // 溢出槽同为窗口语义：读出后清零（需要写锁，升级为独占访问）。
+    read_lock.unlock();
+    std::unique_lock<std::shared_mutex> write_lock(registry_mutex_);
+    for (SymbolTotals& totals : overflow_) {
+      if (totals.fills == 0) {
+        continue;
+      }
+      out_totals->push_back(totals);
+      const std::string symbol = totals.symbol;
+      totals = SymbolTotals{};
+      totals.symbol = symbol;
+    }
+  }
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief 按品种分片的成交质量累计器
+ *
+ * 决策路径此前直接在 string 键 unordered_map 上原地累加，单线程下
+ * 哈希查找已可测量，流水线分线程后更会成为争用点。本类把每个品种的
+ * 累计槽位按线程分片：品种首见时注册为稠密 SymbolId（读多写少，
+ * shared_mutex 保护），之后热路径按 (分片, SymbolId) 直达缓存行对齐
+ * 的原子槽位，只做 relaxed 累加，不同线程落在不同分片互不争用。
+ *
+ * 聚合是惰性的：只有摘要行/窗口结算调用 `Drain` 时才跨分片汇总，
+ * 并用 exchange(0) 同时完成窗口清零。超过 kMaxSymbols 的品种退回
+ * 注册锁下的溢出槽累计（实盘宇宙远小于该上限，仅作兜底）。
+ */
+class ShardedSymbolStats {
+ public:
+  /// 线程分片数（按线程 id 哈希选片）。
+  static constexpr std::size_t kShardCount = 8;
+  /// 稠密 SymbolId 上限；超出部分走锁保护的溢出槽。
+  static constexpr std::size_t kMaxSymbols = 512;
+
+  /// 单品种聚合结果（Drain 输出，也是溢出槽的累计形态）。
+  struct SymbolTotals {
+    std::string symbol;
+    std::uint64_t fills{0};
+    std::uint64_t net_quality_fills{0};
+    double realized_net_sum_usd{0.0};
+    double fee_usd_sum{0.0};
+    double notional_abs_usd_sum{0.0};
+  };
+
+  ShardedSymbolStats();
+
+  ShardedSymbolStats(const ShardedSymbolStats&) = delete;
+  ShardedSymbolStats& operator=(const ShardedSymbolStats&) = delete;
+
+  /**
+   * @brief 累加一笔成交样本（热路径，relaxed 原子）
+   * @param net_quality 是否计入净质量成交数
+   */
+  void Record(const std::string& symbol,
+              bool net_quality,
+              double realized_net_usd,
+              double fee_usd,
+              double notional_abs_usd);
+
+  /**
+   * @brief 汇总并清零全部分片（惰性聚合，仅摘要/窗口结算调用）
+   *
+   * 全零品种不输出；每个字段以 exchange(0) 读取，窗口语义与此前
+   * “拷贝后置空”一致。
+   */
+  void Drain(std::vector<SymbolTotals>* out_totals);
+
+ private:
+  /// 缓存行对齐的单品种单分片累计槽。
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> fills{0};
+    std::atomic<std::uint64_t> net_quality_fills{0};
+    std::atomic<double> realized_net_sum_usd{0.0};
+    std::atomic<double> fee_usd_sum{0.0};
+    std::atomic<double> notional_abs_usd_sum{0.0};
+  };
+  using Shard = std::array<Slot, kMaxSymbols>;
+
+  /// 查找或注册品种的稠密 id；返回值 >= kMaxSymbols 表示溢出。
+  std::size_t IdOf(const std::string& symbol);
+  /// 当前线程的分片下标（线程 id 哈希，线程内缓存）。
+  static std::size_t ShardIndexForThread();
+
+  mutable std::shared_mutex registry_mutex_;  ///< 保护 id 注册与溢出槽。
+  std::unordered_map<std::string, std::size_t> symbol_ids_;
+  std::vector<std::string> symbol_names_;  ///< 稠密 id -> 品种名。
+  std::vector<SymbolTotals> overflow_;  ///< 超上限品种的兜底累计。
+  std::unique_ptr<std::array<Shard, kShardCount>> shards_;  ///< 堆上分片块。
+};
+
+}  // namespace ai_trade
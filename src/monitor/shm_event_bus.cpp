@@ -0,0 +1,287 @@
+#include "monitor/shm_event_bus.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+namespace ai_trade {
+
+namespace {
+
+constexpr std::uint32_t kShmEventBusMagic = 0x42535441;  // "ATSB"
+constexpr std::uint32_t kShmEventBusVersion = 1;
+
+/// 上取整到 2 的幂（槽位定位用位与代替取模）。
+std::size_t RoundUpPowerOfTwo(std::size_t value) {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+void CopyTruncated(char* dst, std::size_t dst_size, const std::string& src) {
+  const std::size_t n = std::min(dst_size - 1, src.size());
+  std::memcpy(dst, src.data(), n);
+  dst[n] = '\0';
+}
+
+}  // namespace
+
+/// 总线文件头（cacheline 对齐，后随 capacity 个槽位）。
+struct ShmEventBusHeader {
+  std::uint32_t magic{0};
+  std::uint32_t version{0};
+  std::uint64_t capacity{0};
+  std::uint64_t record_size{0};
+  std::atomic<std::uint64_t> next_seq{0};  ///< 累计发布记录数。
+  char padding[32]{};
+};
+static_assert(sizeof(ShmEventBusHeader) == 64,
+              "总线头布局变化必须同步提升 kShmEventBusVersion");
+
+/// 单槽：seqlock 版本号 + 定长记录。
+struct ShmEventSlot {
+  std::atomic<std::uint64_t> version{0};  ///< 奇数=写入中；偶数=2*(seq+1)。
+  ShmEventRecord record{};
+};
+
+ShmEventBusWriter::~ShmEventBusWriter() {
+  Close();
+}
+
+bool ShmEventBusWriter::Create(const std::string& path, std::size_t capacity,
+                               std::string* out_error) {
+  Close();
+  if (path.empty() || capacity == 0) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线路径为空或容量为 0";
+    }
+    return false;
+  }
+  const std::size_t slot_count = RoundUpPowerOfTwo(capacity);
+  const std::size_t total_size =
+      sizeof(ShmEventBusHeader) + slot_count * sizeof(ShmEventSlot);
+
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线文件打开失败: " + std::string(std::strerror(errno));
+    }
+    return false;
+  }
+  if (::ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线文件扩容失败: " + std::string(std::strerror(errno));
+    }
+    ::close(fd);
+    return false;
+  }
+  void* base = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+  ::close(fd);  // 映射持有引用，fd 可立即关闭。
+  if (base == MAP_FAILED) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线映射失败: " + std::string(std::strerror(errno));
+    }
+    return false;
+  }
+
+  map_base_ = base;
+  map_size_ = total_size;
+  header_ = new (base) ShmEventBusHeader{};
+  slots_ = reinterpret_cast<ShmEventSlot*>(
+      static_cast<char*>(base) + sizeof(ShmEventBusHeader));
+  for (std::size_t i = 0; i < slot_count; ++i) {
+    new (&slots_[i]) ShmEventSlot{};
+  }
+  capacity_mask_ = slot_count - 1;
+  published_ = 0;
+
+  header_->capacity = slot_count;
+  header_->record_size = sizeof(ShmEventRecord);
+  header_->version = kShmEventBusVersion;
+  // 魔数最后写入：读者以魔数判定文件初始化完成。
+  header_->magic = kShmEventBusMagic;
+  return true;
+}
+
+void ShmEventBusWriter::PublishRecord(const ShmEventRecord& record) {
+  if (header_ == nullptr) {
+    return;
+  }
+  const std::uint64_t seq = published_;
+  ShmEventSlot& slot = slots_[seq & capacity_mask_];
+  // seqlock 写协议：奇数版本圈住拷贝，偶数版本携带全局序号。
+  slot.version.store(2 * seq + 1, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&slot.record, &record, sizeof(record));
+  slot.version.store(2 * (seq + 1), std::memory_order_release);
+  ++published_;
+  header_->next_seq.store(published_, std::memory_order_release);
+}
+
+void ShmEventBusWriter::Publish(const MarketEvent& event) {
+  ShmEventRecord record;
+  record.type = static_cast<std::uint8_t>(ShmEventType::kMarket);
+  auto& market = record.payload.market;
+  market.ts_ms = event.ts_ms;
+  CopyTruncated(market.symbol, sizeof(market.symbol), event.symbol);
+  market.price = event.price;
+  market.mark_price = event.mark_price;
+  market.volume = event.volume;
+  market.interval_ms = event.interval_ms;
+  PublishRecord(record);
+}
+
+void ShmEventBusWriter::Publish(const MarketEvent& event,
+                                const MarketDecision& decision) {
+  ShmEventRecord record;
+  record.type = static_cast<std::uint8_t>(ShmEventType::kDecision);
+  DecisionJournal::FillRecord(event, decision, &record.payload.decision);
+  PublishRecord(record);
+}
+
+void ShmEventBusWriter::Publish(const FillEvent& fill) {
+  ShmEventRecord record;
+  record.type = static_cast<std::uint8_t>(ShmEventType::kFill);
+  auto& payload = record.payload.fill;
+  CopyTruncated(payload.fill_id, sizeof(payload.fill_id), fill.fill_id);
+  CopyTruncated(payload.client_order_id, sizeof(payload.client_order_id),
+                fill.client_order_id);
+  CopyTruncated(payload.symbol, sizeof(payload.symbol), fill.symbol);
+  payload.direction = static_cast<std::int8_t>(fill.direction);
+  payload.liquidity = static_cast<std::uint8_t>(fill.liquidity);
+  payload.qty = fill.qty;
+  payload.price = fill.price;
+  payload.fee = fill.fee;
+  PublishRecord(record);
+}
+
+void ShmEventBusWriter::Close() {
+  if (map_base_ != nullptr) {
+    ::munmap(map_base_, map_size_);
+  }
+  map_base_ = nullptr;
+  map_size_ = 0;
+  header_ = nullptr;
+  slots_ = nullptr;
+  capacity_mask_ = 0;
+}
+
+ShmEventBusReader::~ShmEventBusReader() {
+  Close();
+}
+
+bool ShmEventBusReader::Open(const std::string& path, std::string* out_error) {
+  Close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线文件打开失败: " + std::string(std::strerror(errno));
+    }
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < sizeof(ShmEventBusHeader)) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线文件尺寸非法";
+    }
+    ::close(fd);
+    return false;
+  }
+  const std::size_t total_size = static_cast<std::size_t>(st.st_size);
+  const void* base = ::mmap(nullptr, total_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线映射失败: " + std::string(std::strerror(errno));
+    }
+    return false;
+  }
+
+  const auto* header = static_cast<const ShmEventBusHeader*>(base);
+  if (header->magic != kShmEventBusMagic ||
+      header->version != kShmEventBusVersion ||
+      header->record_size != sizeof(ShmEventRecord) ||
+      header->capacity == 0 ||
+      total_size < sizeof(ShmEventBusHeader) +
+                       header->capacity * sizeof(ShmEventSlot)) {
+    if (out_error != nullptr) {
+      *out_error = "shm 总线文件头校验失败（版本或布局不匹配）";
+    }
+    ::munmap(const_cast<void*>(base), total_size);
+    return false;
+  }
+
+  map_base_ = base;
+  map_size_ = total_size;
+  header_ = header;
+  slots_ = reinterpret_cast<const ShmEventSlot*>(
+      static_cast<const char*>(base) + sizeof(ShmEventBusHeader));
+  capacity_ = header->capacity;
+  cursor_ = 0;
+  dropped_ = 0;
+  return true;
+}
+
+bool ShmEventBusReader::Next(ShmEventRecord* out_record) {
+  if (header_ == nullptr || out_record == nullptr) {
+    return false;
+  }
+  const std::uint64_t next_seq =
+      header_->next_seq.load(std::memory_order_acquire);
+  if (cursor_ >= next_seq) {
+    return false;
+  }
+  // 被写者套圈：最旧可读记录是 next_seq - capacity，之前的已被覆盖。
+  if (next_seq - cursor_ > capacity_) {
+    const std::uint64_t oldest = next_seq - capacity_;
+    dropped_ += oldest - cursor_;
+    cursor_ = oldest;
+  }
+
+  const ShmEventSlot& slot = slots_[cursor_ & (capacity_ - 1)];
+  const std::uint64_t expected_version = 2 * (cursor_ + 1);
+  for (;;) {
+    const std::uint64_t v1 = slot.version.load(std::memory_order_acquire);
+    if (v1 < expected_version) {
+      return false;  // 尚未发布（理论上不会发生，防御尺寸回退）。
+    }
+    if (v1 != expected_version || (v1 & 1) != 0) {
+      // 读取期间被覆盖：按套圈处理，下一轮重新对齐游标。
+      ++dropped_;
+      ++cursor_;
+      return Next(out_record);
+    }
+    std::memcpy(out_record, &slot.record, sizeof(*out_record));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t v2 = slot.version.load(std::memory_order_relaxed);
+    if (v1 == v2) {
+      break;  // 拷贝期间未被改写。
+    }
+  }
+  ++cursor_;
+  return true;
+}
+
+void ShmEventBusReader::Close() {
+  if (map_base_ != nullptr) {
+    ::munmap(const_cast<void*>(map_base_), map_size_);
+  }
+  map_base_ = nullptr;
+  map_size_ = 0;
+  header_ = nullptr;
+  slots_ = nullptr;
+  capacity_ = 0;
+  cursor_ = 0;
+}
+
+}  // namespace ai_trade
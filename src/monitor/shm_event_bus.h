@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/types.h"
+#include "storage/decision_journal.h"
+
+namespace ai_trade {
+
+/// 共享内存事件类型（记录头 `type` 字段取值）。
+enum class ShmEventType : std::uint8_t {
+  kMarket = 1,
+  kDecision = 2,
+  kFill = 3,
+};
+
+#pragma pack(push, 1)
+
+/// 行情事件定长载荷（布局即共享内存格式，字段增删必须提版本）。
+struct ShmMarketRecord {
+  std::int64_t ts_ms{0};
+  char symbol[16]{};  ///< NUL 填充，超长截断。
+  double price{0.0};
+  double mark_price{0.0};
+  double volume{0.0};
+  std::int64_t interval_ms{0};
+};
+
+/// 成交事件定长载荷。
+struct ShmFillRecord {
+  char fill_id[24]{};
+  char client_order_id[24]{};
+  char symbol[16]{};
+  std::int8_t direction{0};
+  std::uint8_t liquidity{0};
+  std::uint8_t reserved[6]{};
+  double qty{0.0};
+  double price{0.0};
+  double fee{0.0};
+};
+
+/// 总线单条记录：类型头 + 三种定长载荷的联合。
+/// 决策载荷复用决策日志的定长记录，避免第二份布局定义漂移。
+struct ShmEventRecord {
+  std::uint8_t type{0};  ///< ShmEventType 底层值。
+  std::uint8_t reserved[7]{};
+  union {
+    ShmMarketRecord market;
+    DecisionJournalRecord decision;
+    ShmFillRecord fill;
+  } payload{};
+};
+
+#pragma pack(pop)
+
+/**
+ * @brief 共享内存事件总线（单写者环 + 每槽 seqlock）
+ *
+ * 动机：web 后端与审计工具此前靠 tail JSON 日志消费运行态，既占用
+ * 主循环的序列化开销，又有秒级滞后。总线把行情/决策/成交以定长记录
+ * 写入 mmap 文件环：热路径每条事件只付一次 memcpy；sidecar 进程以
+ * 只读方式映射同一文件，微秒级看到最新状态，完全不回压主进程。
+ *
+ * 并发协议（单写者、任意多只读者）：
+ * - 每槽带版本号 seqlock：写者先置奇数版本，拷贝记录后置
+ *   `2 * (全局序号 + 1)` 的偶数版本；读者两次读版本夹住一次拷贝，
+ *   版本为奇数或前后不一致则重试；
+ * - 头部 `next_seq` 记录累计发布数；读者据此检测被写者套圈
+ *   （lapped）并跳到最旧可读记录，丢弃计数由读者侧自行累计；
+ * - 写者永不等待读者：慢读者只会丢数据，不会拖慢主循环。
+ */
+class ShmEventBusWriter {
+ public:
+  ShmEventBusWriter() = default;
+  ~ShmEventBusWriter();
+
+  ShmEventBusWriter(const ShmEventBusWriter&) = delete;
+  ShmEventBusWriter& operator=(const ShmEventBusWriter&) = delete;
+
+  /**
+   * @brief 创建并映射总线文件（截断重建，容量上取整到 2 的幂）
+   *
+   * 路径放在 /dev/shm 下即为纯内存页；普通文件系统路径同样可用
+   * （页缓存承载，便于测试）。
+   */
+  bool Create(const std::string& path, std::size_t capacity,
+              std::string* out_error);
+
+  /// 发布一条行情事件（一次 memcpy）。
+  void Publish(const MarketEvent& event);
+  /// 发布一条决策记录（载荷编码与决策日志共用 FillRecord）。
+  void Publish(const MarketEvent& event, const MarketDecision& decision);
+  /// 发布一条成交回报。
+  void Publish(const FillEvent& fill);
+
+  /// 解除映射并关闭（析构亦会调用）。
+  void Close();
+
+  bool ok() const { return header_ != nullptr; }
+  std::uint64_t published() const { return published_; }
+
+ private:
+  void PublishRecord(const ShmEventRecord& record);
+
+  void* map_base_{nullptr};
+  std::size_t map_size_{0};
+  struct ShmEventBusHeader* header_{nullptr};
+  struct ShmEventSlot* slots_{nullptr};
+  std::uint64_t capacity_mask_{0};
+  std::uint64_t published_{0};
+};
+
+/**
+ * @brief 总线只读读者（sidecar 进程侧的小型消费库）
+ *
+ * 用法：Open 映射总线文件后循环调用 Next；返回 false 表示暂无新
+ * 记录。被写者套圈时自动跳到最旧可读记录并累计 `dropped()`。
+ */
+class ShmEventBusReader {
+ public:
+  ShmEventBusReader() = default;
+  ~ShmEventBusReader();
+
+  ShmEventBusReader(const ShmEventBusReader&) = delete;
+  ShmEventBusReader& operator=(const ShmEventBusReader&) = delete;
+
+  /// 只读映射总线文件并校验魔数/版本/记录布局。
+  bool Open(const std::string& path, std::string* out_error);
+
+  /// 读取下一条记录；无新记录返回 false（非阻塞）。
+  bool Next(ShmEventRecord* out_record);
+
+  void Close();
+
+  bool ok() const { return header_ != nullptr; }
+  /// 因写者套圈而跳过的记录数。
+  std::uint64_t dropped() const { return dropped_; }
+
+ private:
+  const void* map_base_{nullptr};
+  std::size_t map_size_{0};
+  const struct ShmEventBusHeader* header_{nullptr};
+  const struct ShmEventSlot* slots_{nullptr};
+  std::uint64_t capacity_{0};
+  std::uint64_t cursor_{0};   ///< 下一条期望的全局序号。
+  std::uint64_t dropped_{0};
+};
+
+}  // namespace ai_trade
@@ -0,0 +1,247 @@
+#include "monitor/state_delta_stream.h"
+
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+#include <unordered_map>
+
+namespace ai_trade {
+
+namespace {
+
+// 浮点字段的变更判定阈值：小于该幅度的抖动不值得占一条记录。
+constexpr double kChangeEpsilon = 1e-9;
+
+bool NumberChanged(double lhs, double rhs) {
+  return std::fabs(lhs - rhs) > kChangeEpsilon;
+}
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+void AppendPositionJson(std::ostringstream* oss,
+                        const StatePositionEntry& entry) {
+  *oss << "{\"symbol\":\"" << JsonEscape(entry.symbol)
+       << "\",\"qty\":" << entry.qty << ",\"mark\":" << entry.mark_price
+       << "}";
+}
+
+void AppendStateJson(std::ostringstream* oss,
+                     const RuntimeStateSample& sample) {
+  *oss << "{\"risk_mode\":\"" << JsonEscape(sample.risk_mode)
+       << "\",\"trading_halted\":"
+       << (sample.trading_halted ? "true" : "false")
+       << ",\"equity_usd\":" << sample.equity_usd
+       << ",\"drawdown_pct\":" << sample.drawdown_pct << ",\"positions\":[";
+  for (std::size_t i = 0; i < sample.positions.size(); ++i) {
+    if (i > 0) {
+      *oss << ",";
+    }
+    AppendPositionJson(oss, sample.positions[i]);
+  }
+  *oss << "],\"funnel\":{";
+  for (std::size_t i = 0; i < sample.funnel.size(); ++i) {
+    if (i > 0) {
+      *oss << ",";
+    }
+    *oss << "\"" << JsonEscape(sample.funnel[i].first)
+         << "\":" << sample.funnel[i].second;
+  }
+  *oss << "}}";
+}
+
+}  // namespace
+
+bool StateDeltaStreamWriter::Open(const std::string& path,
+                                  int snapshot_interval,
+                                  std::int64_t max_bytes,
+                                  std::string* out_error) {
+  Close();
+  const std::filesystem::path parent =
+      std::filesystem::path(path).parent_path();
+  if (!parent.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(parent, ec);
+  }
+  // 截断重建：流的快照锚点语义要求首行必然是快照，续写旧文件会让
+  // 读端把历史版本误当作当前状态。
+  out_.open(path, std::ios::trunc);
+  if (!out_.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开状态增量流文件: " + path;
+    }
+    return false;
+  }
+  path_ = path;
+  snapshot_interval_ = snapshot_interval > 0 ? snapshot_interval : 50;
+  max_bytes_ = max_bytes;
+  version_ = 0;
+  records_since_snapshot_ = 0;
+  bytes_written_ = 0;
+  has_last_ = false;
+  return true;
+}
+
+void StateDeltaStreamWriter::Close() {
+  if (out_.is_open()) {
+    out_.flush();
+    out_.close();
+  }
+}
+
+void StateDeltaStreamWriter::WriteSnapshot(const RuntimeStateSample& sample) {
+  ++version_;
+  std::ostringstream oss;
+  oss << "{\"v\":" << version_ << ",\"ts\":" << sample.ts_ms
+      << ",\"type\":\"snapshot\",\"state\":";
+  AppendStateJson(&oss, sample);
+  oss << "}\n";
+  const std::string line = oss.str();
+  out_ << line;
+  out_.flush();
+  bytes_written_ += static_cast<std::int64_t>(line.size());
+  records_since_snapshot_ = 0;
+  last_ = sample;
+  has_last_ = true;
+}
+
+void StateDeltaStreamWriter::RotateIfNeeded() {
+  if (max_bytes_ <= 0 || bytes_written_ < max_bytes_) {
+    return;
+  }
+  // 截断重写：读端看到文件变短即重置偏移，从新快照重新锚定。
+  out_.close();
+  out_.open(path_, std::ios::trunc);
+  bytes_written_ = 0;
+  records_since_snapshot_ = snapshot_interval_;  // 强制下一条写快照
+}
+
+bool StateDeltaStreamWriter::Publish(const RuntimeStateSample& sample) {
+  if (!out_.is_open()) {
+    return false;
+  }
+  RotateIfNeeded();
+  if (!has_last_ || records_since_snapshot_ >= snapshot_interval_) {
+    WriteSnapshot(sample);
+    return true;
+  }
+
+  // 字段级对比：只把发生变化的内容放进 changes。
+  std::ostringstream changes;
+  bool any = false;
+  auto append_sep = [&] {
+    if (any) {
+      changes << ",";
+    }
+    any = true;
+  };
+  if (sample.risk_mode != last_.risk_mode) {
+    append_sep();
+    changes << "\"risk_mode\":\"" << JsonEscape(sample.risk_mode) << "\"";
+  }
+  if (sample.trading_halted != last_.trading_halted) {
+    append_sep();
+    changes << "\"trading_halted\":"
+            << (sample.trading_halted ? "true" : "false");
+  }
+  if (NumberChanged(sample.equity_usd, last_.equity_usd)) {
+    append_sep();
+    changes << "\"equity_usd\":" << sample.equity_usd;
+  }
+  if (NumberChanged(sample.drawdown_pct, last_.drawdown_pct)) {
+    append_sep();
+    changes << "\"drawdown_pct\":" << sample.drawdown_pct;
+  }
+
+  // 持仓按 symbol 对齐：新增/变化的条目整条下发，消失的以 qty=0 下发。
+  std::unordered_map<std::string, const StatePositionEntry*> last_positions;
+  last_positions.reserve(last_.positions.size());
+  for (const StatePositionEntry& entry : last_.positions) {
+    last_positions[entry.symbol] = &entry;
+  }
+  std::ostringstream position_changes;
+  bool any_position = false;
+  for (const StatePositionEntry& entry : sample.positions) {
+    const auto it = last_positions.find(entry.symbol);
+    const bool changed = it == last_positions.end() ||
+                         NumberChanged(entry.qty, it->second->qty) ||
+                         NumberChanged(entry.mark_price,
+                                       it->second->mark_price);
+    if (it != last_positions.end()) {
+      last_positions.erase(it);
+    }
+    if (changed) {
+      if (any_position) {
+        position_changes << ",";
+      }
+      any_position = true;
+      AppendPositionJson(&position_changes, entry);
+    }
+  }
+  for (const auto& [symbol, entry] : last_positions) {
+    if (any_position) {
+      position_changes << ",";
+    }
+    any_position = true;
+    StatePositionEntry closed;
+    closed.symbol = symbol;
+    closed.mark_price = entry->mark_price;
+    AppendPositionJson(&position_changes, closed);
+  }
+  if (any_position) {
+    append_sep();
+    changes << "\"positions\":[" << position_changes.str() << "]";
+  }
+
+  // 漏斗计数器按名字对齐（两侧名单一致由写端调用方保证）。
+  std::ostringstream funnel_changes;
+  bool any_funnel = false;
+  std::unordered_map<std::string, std::uint64_t> last_funnel;
+  last_funnel.reserve(last_.funnel.size());
+  for (const auto& [name, count] : last_.funnel) {
+    last_funnel[name] = count;
+  }
+  for (const auto& [name, count] : sample.funnel) {
+    const auto it = last_funnel.find(name);
+    if (it != last_funnel.end() && it->second == count) {
+      continue;
+    }
+    if (any_funnel) {
+      funnel_changes << ",";
+    }
+    any_funnel = true;
+    funnel_changes << "\"" << JsonEscape(name) << "\":" << count;
+  }
+  if (any_funnel) {
+    append_sep();
+    changes << "\"funnel\":{" << funnel_changes.str() << "}";
+  }
+
+  if (!any) {
+    // 采样与上一版本完全一致：不写、不升版本。
+    return false;
+  }
+
+  ++version_;
+  std::ostringstream oss;
+  oss << "{\"v\":" << version_ << ",\"ts\":" << sample.ts_ms
+      << ",\"type\":\"delta\",\"changes\":{" << changes.str() << "}}\n";
+  const std::string line = oss.str();
+  out_ << line;
+  out_.flush();
+  bytes_written_ += static_cast<std::int64_t>(line.size());
+  ++records_since_snapshot_;
+  last_ = sample;
+  return true;
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ai_trade {
+
+/// 状态流的一条持仓条目（delta 对比按 symbol 对齐）。
+struct StatePositionEntry {
+  std::string symbol;
+  double qty{0.0};
+  double mark_price{0.0};
+};
+
+/// 一次运行态采样：写端每 tick 采一份，流里只落变化的字段。
+struct RuntimeStateSample {
+  std::int64_t ts_ms{0};
+  std::string risk_mode{"NORMAL"};
+  bool trading_halted{false};
+  double equity_usd{0.0};
+  double drawdown_pct{0.0};
+  std::vector<StatePositionEntry> positions;
+  // 漏斗计数器（进程累计口径）：name -> count。
+  std::vector<std::pair<std::string, std::uint64_t>> funnel;
+};
+
+/**
+ * @brief 版本化状态增量流写端（bot -> web 后端）
+ *
+ * 后端此前整文件重读报告/状态 JSON，仪表盘滞后数十秒且 bot 侧要
+ * 反复写全量快照。本流是一个紧凑 JSONL 追加文件：每行一条记录，
+ * `{"v":N,"ts":...,"type":"snapshot","state":{...}}` 为全量快照，
+ * `{"v":N,"ts":...,"type":"delta","changes":{...}}` 只携带相对上一
+ * 版本发生变化的字段（持仓按 symbol 对齐，消失的持仓以 qty=0 下发）。
+ * 版本号单调递增，读端据此检测丢行并回退到最近快照。
+ *
+ * 快照按固定条数间隔重发（读端冷启动锚点）；文件超限时原地截断
+ * 重写一条快照（流语义重置，版本继续递增）。无变化的采样不落盘，
+ * 稳态时 bot 侧导出成本接近于零。
+ *
+ * 读端实现见 apps/ai_trade_web/backend/app/services/state_stream.py。
+ */
+class StateDeltaStreamWriter {
+ public:
+  StateDeltaStreamWriter() = default;
+
+  /**
+   * @brief 打开（追加）流文件并立即写入一条全量快照锚点
+   *
+   * @param path 流文件路径
+   * @param snapshot_interval 每多少条记录重发一次全量快照（>=1）
+   * @param max_bytes 文件超过该字节数时截断重写（<=0 表示不限制）
+   */
+  bool Open(const std::string& path,
+            int snapshot_interval,
+            std::int64_t max_bytes,
+            std::string* out_error);
+
+  /**
+   * @brief 发布一次采样：与上一版本对比后按需落盘
+   *
+   * 无任何字段变化时直接返回（不写、不升版本）。
+   * @return true 表示本次采样产生了新记录
+   */
+  bool Publish(const RuntimeStateSample& sample);
+
+  void Close();
+
+  bool ok() const { return out_.is_open(); }
+  std::uint64_t version() const { return version_; }
+
+ private:
+  void WriteSnapshot(const RuntimeStateSample& sample);
+  void RotateIfNeeded();
+
+  std::ofstream out_;
+  std::string path_;
+  int snapshot_interval_{50};
+  std::int64_t max_bytes_{0};
+  std::uint64_t version_{0};
+  int records_since_snapshot_{0};
+  std::int64_t bytes_written_{0};
+  bool has_last_{false};
+  RuntimeStateSample last_;
+};
+
+}  // namespace ai_trade
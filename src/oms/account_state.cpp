@@ -4,6 +4,9 @@
 #include <cmath>
 #include <limits>
 
+#include "core/snapshot_io.h"
+#include "core/symbol_table.h"
+
 namespace ai_trade {
 
 namespace {
@@ -105,50 +108,84 @@ double AccountState::drawdown_pct() const {
   return std::max(0.0, dd);
 }
 
-double AccountState::liquidation_distance_p95() const {
-  struct Sample {
-    double distance;
-    double weight;
-  };
+void AccountState::CollectLiqDistanceSample(
+    const PositionState& position,
+    std::vector<LiqDistanceSample>* samples,
+    double* total_weight) {
+  if (std::fabs(position.qty) <= kEpsilon) return;
 
-  std::vector<Sample> samples;
-  samples.reserve(positions_.size());
-  double total_weight = 0.0;
+  const double mark = EffectiveMarkPrice(position);
+  const double liq = position.liquidation_price;
 
-  for (const auto& [_, position] : positions_) {
-    if (std::fabs(position.qty) <= kEpsilon) continue;
-
-    const double mark = EffectiveMarkPrice(position);
-    const double liq = position.liquidation_price;
-    
-    if (mark <= kEpsilon || liq <= kEpsilon) continue;
+  if (mark <= kEpsilon || liq <= kEpsilon) return;
 
-    double distance = (position.qty > 0.0) ? (mark - liq) : (liq - mark);
-    distance = std::max(0.0, distance / mark);
+  double distance = (position.qty > 0.0) ? (mark - liq) : (liq - mark);
+  distance = std::max(0.0, distance / mark);
 
-    const double notional_weight = std::fabs(position.qty * mark);
-    if (notional_weight <= kEpsilon) continue;
+  const double notional_weight = std::fabs(position.qty * mark);
+  if (notional_weight <= kEpsilon) return;
 
-    samples.push_back({distance, notional_weight});
-    total_weight += notional_weight;
-  }
+  samples->push_back({distance, notional_weight});
+  *total_weight += notional_weight;
+}
 
-  if (samples.empty() || total_weight <= kEpsilon) return 1.0;
+double AccountState::WeightedP95(std::vector<LiqDistanceSample>* samples,
+                                 double total_weight) {
+  if (samples->empty() || total_weight <= kEpsilon) return 1.0;
 
   // Sort by distance ascending
-  std::sort(samples.begin(), samples.end(),
-            [](const Sample& a, const Sample& b) { return a.distance < b.distance; });
+  std::sort(samples->begin(), samples->end(),
+            [](const LiqDistanceSample& a, const LiqDistanceSample& b) {
+              return a.distance < b.distance;
+            });
 
   const double target_weight = total_weight * 0.95;
   double cumulative_weight = 0.0;
-  
-  for (const auto& sample : samples) {
+
+  for (const auto& sample : *samples) {
     cumulative_weight += sample.weight;
     if (cumulative_weight >= target_weight - kEpsilon) {
       return sample.distance;
     }
   }
-  return samples.back().distance;
+  return samples->back().distance;
+}
+
+double AccountState::liquidation_distance_p95() const {
+  std::vector<LiqDistanceSample>& samples = liq_samples_scratch_;
+  samples.clear();
+  samples.reserve(positions_.size());
+  double total_weight = 0.0;
+
+  for (const auto& [_, position] : positions_) {
+    CollectLiqDistanceSample(position, &samples, &total_weight);
+  }
+  return WeightedP95(&samples, total_weight);
+}
+
+AccountRiskSnapshot AccountState::BuildRiskSnapshot() const {
+  AccountRiskSnapshot out;
+  std::vector<LiqDistanceSample>& samples = liq_samples_scratch_;
+  samples.clear();
+  samples.reserve(positions_.size());
+  double total_weight = 0.0;
+  double unrealized = 0.0;
+
+  // 一次遍历同时累计未实现盈亏、总名义敞口与强平距离样本。
+  for (const auto& [_, position] : positions_) {
+    const double mark = EffectiveMarkPrice(position);
+    unrealized += position.qty * (mark - position.avg_entry_price);
+    out.gross_notional_usd += std::fabs(position.qty * mark);
+    CollectLiqDistanceSample(position, &samples, &total_weight);
+  }
+
+  out.equity_usd = cash_usd_ + unrealized;
+  out.drawdown_pct =
+      (peak_equity_usd_ <= kEpsilon)
+          ? 0.0
+          : std::max(0.0, (peak_equity_usd_ - out.equity_usd) / peak_equity_usd_);
+  out.liquidation_distance_pct = WeightedP95(&samples, total_weight);
+  return out;
 }
 
 void AccountState::RefreshPeakEquity() {
@@ -246,43 +283,88 @@ void AccountState::SyncFromRemotePositions(
   peak_equity_usd_ = baseline_cash_usd;
   cumulative_realized_pnl_usd_ = 0.0;
   cumulative_fee_usd_ = 0.0;
+  // 全量同步即本轮纪元基线：后续增量刷新以此为比对起点。
+  last_remote_risk_epoch_ = BuildRemoteEpoch(positions);
   RefreshPeakEquity();
 }
 
-void AccountState::RefreshRiskFromRemotePositions(
+std::vector<AccountState::RemoteEpochEntry> AccountState::BuildRemoteEpoch(
     const std::vector<RemotePositionSnapshot>& positions) {
+  std::vector<RemoteEpochEntry> epoch;
+  epoch.reserve(positions.size());
   for (const auto& remote : positions) {
     if (remote.symbol.empty()) continue;
+    epoch.push_back(RemoteEpochEntry{
+        .symbol_id = InternSymbol(remote.symbol),
+        .qty = remote.qty,
+        .avg_entry_price = remote.avg_entry_price,
+        .mark_price = remote.mark_price,
+        .liquidation_price = remote.liquidation_price,
+    });
+  }
+  std::sort(epoch.begin(), epoch.end(),
+            [](const RemoteEpochEntry& lhs, const RemoteEpochEntry& rhs) {
+              return lhs.symbol_id < rhs.symbol_id;
+            });
+  return epoch;
+}
 
-    auto it = positions_.find(remote.symbol);
-    if (it == positions_.end()) {
-      // Add missing position for risk tracking
-      if (std::fabs(remote.qty) <= kEpsilon) continue;
-      PositionState state;
-      state.qty = remote.qty;
-      state.avg_entry_price = std::max(0.0, remote.avg_entry_price);
-      state.mark_price = (remote.mark_price > kEpsilon) ? remote.mark_price : state.avg_entry_price;
-      state.liquidation_price = std::max(0.0, remote.liquidation_price);
-      positions_[remote.symbol] = state;
-      continue;
+void AccountState::ApplyRemoteRiskEntry(const RemoteEpochEntry& entry) {
+  const std::string& symbol = SymbolNameOf(entry.symbol_id);
+  auto it = positions_.find(symbol);
+  if (it == positions_.end()) {
+    // Add missing position for risk tracking
+    if (std::fabs(entry.qty) <= kEpsilon) return;
+    PositionState state;
+    state.qty = entry.qty;
+    state.avg_entry_price = std::max(0.0, entry.avg_entry_price);
+    state.mark_price =
+        (entry.mark_price > kEpsilon) ? entry.mark_price : state.avg_entry_price;
+    state.liquidation_price = std::max(0.0, entry.liquidation_price);
+    positions_[symbol] = state;
+    return;
+  }
+
+  auto& local = it->second;
+  if (entry.mark_price > kEpsilon) {
+    local.mark_price = entry.mark_price;
+  }
+  local.liquidation_price = std::max(0.0, entry.liquidation_price);
+
+  // Sync quantity if local is zero but remote is not (safety net)
+  if (std::fabs(local.qty) <= kEpsilon && std::fabs(entry.qty) > kEpsilon) {
+    local.qty = entry.qty;
+    local.avg_entry_price = std::max(0.0, entry.avg_entry_price);
+    if (local.mark_price <= kEpsilon) {
+      local.mark_price = local.avg_entry_price;
     }
+  }
+}
 
-    auto& local = it->second;
-    if (remote.mark_price > kEpsilon) {
-      local.mark_price = remote.mark_price;
+bool AccountState::RefreshRiskFromRemotePositions(
+    const std::vector<RemotePositionSnapshot>& positions) {
+  std::vector<RemoteEpochEntry> epoch = BuildRemoteEpoch(positions);
+  if (epoch == last_remote_risk_epoch_) {
+    // 快照纪元一致：本轮刷新为空操作，跳过字段应用与峰值重算。
+    return false;
+  }
+
+  // 归并游走两个有序纪元，只应用“新增或字段有变化”的条目。
+  std::size_t prev_index = 0;
+  for (const auto& entry : epoch) {
+    while (prev_index < last_remote_risk_epoch_.size() &&
+           last_remote_risk_epoch_[prev_index].symbol_id < entry.symbol_id) {
+      ++prev_index;
     }
-    local.liquidation_price = std::max(0.0, remote.liquidation_price);
-
-    // Sync quantity if local is zero but remote is not (safety net)
-    if (std::fabs(local.qty) <= kEpsilon && std::fabs(remote.qty) > kEpsilon) {
-      local.qty = remote.qty;
-      local.avg_entry_price = std::max(0.0, remote.avg_entry_price);
-      if (local.mark_price <= kEpsilon) {
-        local.mark_price = local.avg_entry_price;
-      }
+    if (prev_index < last_remote_risk_epoch_.size() &&
+        last_remote_risk_epoch_[prev_index] == entry) {
+      continue;
     }
+    ApplyRemoteRiskEntry(entry);
   }
+  last_remote_risk_epoch_ = std::move(epoch);
   RefreshPeakEquity();
+  return true;
 }
 
 void AccountState::ForceSyncPositionsFromRemote(
@@ -299,6 +381,7 @@ void AccountState::ForceSyncPositionsFromRemote(
     synced[remote.symbol] = state;
   }
   positions_.swap(synced);
+  last_remote_risk_epoch_ = BuildRemoteEpoch(positions);
   RefreshPeakEquity();
 }
 
@@ -324,4 +407,41 @@ void AccountState::SyncFromRemoteAccountBalance(
   }
 }
 
+void AccountState::SaveState(SnapshotWriter* writer) const {
+  writer->Field(cash_usd_);
+  writer->Field(peak_equity_usd_);
+  writer->Field(cumulative_realized_pnl_usd_);
+  writer->Field(cumulative_fee_usd_);
+  writer->Field(static_cast<std::uint64_t>(positions_.size()));
+  for (const auto& [symbol, position] : positions_) {
+    writer->Field(symbol);
+    writer->Field(position.qty);
+    writer->Field(position.avg_entry_price);
+    writer->Field(position.mark_price);
+    writer->Field(position.liquidation_price);
+  }
+}
+
+void AccountState::LoadState(SnapshotReader* reader) {
+  reader->Field(cash_usd_);
+  reader->Field(peak_equity_usd_);
+  reader->Field(cumulative_realized_pnl_usd_);
+  reader->Field(cumulative_fee_usd_);
+  std::uint64_t count = 0;
+  reader->Field(count);
+  positions_.clear();
+  // 快照恢复后远端纪元未知：清空以强制下一轮全量应用。
+  last_remote_risk_epoch_.clear();
+  for (std::uint64_t i = 0; reader->ok() && i < count; ++i) {
+    std::string symbol;
+    PositionState position;
+    reader->Field(symbol);
+    reader->Field(position.qty);
+    reader->Field(position.avg_entry_price);
+    reader->Field(position.mark_price);
+    reader->Field(position.liquidation_price);
+    positions_.emplace(std::move(symbol), position);
+  }
+}
+
 }  // namespace ai_trade
@@ -9,6 +9,9 @@
 
 namespace ai_trade {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /// Single symbol position state.
 struct PositionState {
   Quantity qty{0.0};
@@ -41,8 +44,19 @@ class AccountState {
   void SyncFromRemotePositions(const std::vector<RemotePositionSnapshot>& positions,
                                double baseline_cash_usd = 10000.0);
 
-  /// Updates risk-related fields (mark/liq price) from remote without resetting cash.
-  void RefreshRiskFromRemotePositions(
+  /**
+   * @brief Updates risk-related fields (mark/liq price) from remote without resetting cash.
+   *
+   * 增量口径：
+   * - 对比上一轮保留的快照纪元（按 SymbolId 排序），只应用发生变化的条目；
+   * - 快照与上轮完全一致时直接返回 false（快路径），不触碰任何持仓字段，
+   *   调用方可据此跳过下游风险重算与日志；
+   * - 快路径同时跳过“本地 qty 漂移为零”的安全网回填，本地漂移依赖
+   *   对账路径收敛（远端快照一旦变化即恢复全量语义）。
+   *
+   * @return true 表示快照相对上轮发生变化并已应用。
+   */
+  bool RefreshRiskFromRemotePositions(
       const std::vector<RemotePositionSnapshot>& positions);
 
   /// Forces a hard overwrite of positions (for error recovery).
@@ -54,6 +68,13 @@ class AccountState {
       const RemoteAccountBalanceSnapshot& balance,
       bool reset_peak_to_equity);
 
+  // --- Snapshot ---
+
+  /// 把完整账户状态（现金/峰值权益/累计盈亏/持仓）写入二进制快照。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复账户状态；缓冲损坏时由调用方检查 reader->ok()。
+  void LoadState(SnapshotReader* reader);
+
   // --- Accessors ---
 
   double current_notional_usd() const;
@@ -68,10 +89,14 @@ class AccountState {
   double cumulative_realized_net_pnl_usd() const;
   
   double drawdown_pct() const;
-  
+
   /// Calculates the P95 liquidation distance (Risk Metric).
   double liquidation_distance_p95() const;
 
+  /// 单次遍历持仓表产出账户级风险聚合（权益/回撤/P95 强平距离/
+  /// 总名义敞口），供每个决策轮复用，替代多次独立聚合调用。
+  AccountRiskSnapshot BuildRiskSnapshot() const;
+
   double mark_price(const std::string& symbol) const;
   double position_qty(const std::string& symbol) const;
   double avg_entry_price(const std::string& symbol) const;
@@ -79,9 +104,42 @@ class AccountState {
   std::vector<std::string> GetActiveSymbols() const;
 
  private:
+  /// 强平距离样本（按名义敞口加权）。
+  struct LiqDistanceSample {
+    double distance{0.0};
+    double weight{0.0};
+  };
+
+  /// 远端快照纪元条目（按 SymbolId 排序，用于逐字段增量比对）。
+  struct RemoteEpochEntry {
+    SymbolId symbol_id{kInvalidSymbolId};
+    double qty{0.0};
+    double avg_entry_price{0.0};
+    double mark_price{0.0};
+    double liquidation_price{0.0};
+
+    friend bool operator==(const RemoteEpochEntry&,
+                           const RemoteEpochEntry&) = default;
+  };
+
+  /// 把远端快照规整为按 SymbolId 排序的纪元（忽略空 symbol 条目）。
+  static std::vector<RemoteEpochEntry> BuildRemoteEpoch(
+      const std::vector<RemotePositionSnapshot>& positions);
+  /// 把单条远端纪元条目的风险字段应用到本地持仓表。
+  void ApplyRemoteRiskEntry(const RemoteEpochEntry& entry);
+
   void RefreshPeakEquity();
   double UnrealizedPnlUsd() const;
   static double EffectiveMarkPrice(const PositionState& position);
+  static void CollectLiqDistanceSample(const PositionState& position,
+                                       std::vector<LiqDistanceSample>* samples,
+                                       double* total_weight);
+  static double WeightedP95(std::vector<LiqDistanceSample>* samples,
+                            double total_weight);
+
+  /// 强平距离样本的复用缓冲：BuildRiskSnapshot 在热路径每 tick 调用，
+  /// 临时 vector 会反复分配，这里跨调用保留容量。
+  mutable std::vector<LiqDistanceSample> liq_samples_scratch_;
 
   double cash_usd_{10000.0};
   double peak_equity_usd_{10000.0};
@@ -89,6 +147,8 @@ class AccountState {
   double cumulative_fee_usd_{0.0};
   
   std::unordered_map<std::string, PositionState> positions_;
+  /// 上一轮远端风险刷新的快照纪元（快路径比对基准）。
+  std::vector<RemoteEpochEntry> last_remote_risk_epoch_;
 };
 
 }  // namespace ai_trade
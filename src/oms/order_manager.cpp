@@ -33,7 +33,10 @@ bool OrderManager::RegisterIntent(const OrderIntent& intent) {
     return false;
   }
   // 订单生命周期入口：先注册再允许异步发送。
-  orders_.emplace(intent.client_order_id, OrderRecord{intent});
+  const auto [it, inserted] =
+      orders_.emplace(intent.client_order_id, OrderRecord{intent});
+  (void)inserted;
+  SyncIndexes(it->first, it->second);
   return true;
 }
 
@@ -56,6 +59,7 @@ void OrderManager::MarkRejected(const std::string& client_order_id) {
   }
   if (!IsTerminalState(record->state)) {
     record->state = OrderState::kRejected;
+    SyncIndexes(client_order_id, *record);
   }
 }
 
@@ -67,6 +71,7 @@ void OrderManager::MarkCancelled(const std::string& client_order_id) {
   }
   if (!IsTerminalState(record->state)) {
     record->state = OrderState::kCancelled;
+    SyncIndexes(client_order_id, *record);
   }
 }
 
@@ -94,9 +99,11 @@ void OrderManager::OnFill(const FillEvent& fill) {
   record->filled_qty += fill.qty;
   if (record->filled_qty + kEpsilon >= record->intent.qty) {
     record->state = OrderState::kFilled;
-    return;
+  } else {
+    // 注意：Cancelled 订单的 late fill 会回到 Partial（重新进入在途口径）。
+    record->state = OrderState::kPartial;
   }
-  record->state = OrderState::kPartial;
+  SyncIndexes(fill.client_order_id, *record);
 }
 
 void OrderManager::SeedNetPositionBaseline(
@@ -136,6 +143,50 @@ OrderRecord* OrderManager::FindMutable(const std::string& client_order_id) {
   return &it->second;
 }
 
+/**
+ * @brief 状态迁移后同步二级索引
+ *
+ * 索引不变量：
+ * - `pending_net_ids_by_symbol_` 只含“非终态 Entry/Reduce”订单；
+ * - `open_protection_ids_by_parent_` 只含“非终态 SL/TP 且有父单”订单；
+ * - 任意状态迁移（含 Cancelled 经 late fill 回到 Partial）后重新判定
+ *   成员资格，空集随即回收避免 key 堆积。
+ */
+void OrderManager::SyncIndexes(const std::string& client_order_id,
+                               const OrderRecord& record) {
+  const bool pending = !IsTerminalState(record.state);
+  if (IsNetPositionMutating(record.intent.purpose)) {
+    if (pending) {
+      pending_net_ids_by_symbol_[record.intent.symbol].insert(client_order_id);
+    } else {
+      auto it = pending_net_ids_by_symbol_.find(record.intent.symbol);
+      if (it != pending_net_ids_by_symbol_.end()) {
+        it->second.erase(client_order_id);
+        if (it->second.empty()) {
+          pending_net_ids_by_symbol_.erase(it);
+        }
+      }
+    }
+    return;
+  }
+  if (IsProtection(record.intent.purpose) &&
+      !record.intent.parent_order_id.empty()) {
+    if (pending) {
+      open_protection_ids_by_parent_[record.intent.parent_order_id].insert(
+          client_order_id);
+    } else {
+      auto it = open_protection_ids_by_parent_.find(
+          record.intent.parent_order_id);
+      if (it != open_protection_ids_by_parent_.end()) {
+        it->second.erase(client_order_id);
+        if (it->second.empty()) {
+          open_protection_ids_by_parent_.erase(it);
+        }
+      }
+    }
+  }
+}
+
 std::optional<std::string> OrderManager::FindOpenProtectiveSibling(
     const std::string& parent_order_id,
     OrderPurpose purpose) const {
@@ -146,38 +197,24 @@ std::optional<std::string> OrderManager::FindOpenProtectiveSibling(
   const OrderPurpose sibling_purpose =
       (purpose == OrderPurpose::kSl) ? OrderPurpose::kTp : OrderPurpose::kSl;
 
-  // 当前实现 O(n) 扫描；MVP 阶段规模可接受，后续可按 parent_id 建索引优化。
-  for (const auto& [order_id, record] : orders_) {
-    if (record.intent.parent_order_id != parent_order_id) {
-      continue;
-    }
-    if (record.intent.purpose != sibling_purpose) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
+  // parent_id 索引内只有未终态保护单，按另一侧用途过滤即可。
+  const auto it = open_protection_ids_by_parent_.find(parent_order_id);
+  if (it == open_protection_ids_by_parent_.end()) {
+    return std::nullopt;
+  }
+  for (const auto& order_id : it->second) {
+    const auto* record = Find(order_id);
+    if (record != nullptr && record->intent.purpose == sibling_purpose) {
+      return order_id;
     }
-    return order_id;
   }
   return std::nullopt;
 }
 
 bool OrderManager::HasOpenProtection(const std::string& parent_order_id) const {
   // 只要存在任一未终态保护单即可判定为“已有保护”。
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (record.intent.parent_order_id != parent_order_id) {
-      continue;
-    }
-    if (!IsProtection(record.intent.purpose)) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    return true;
-  }
-  return false;
+  const auto it = open_protection_ids_by_parent_.find(parent_order_id);
+  return it != open_protection_ids_by_parent_.end() && !it->second.empty();
 }
 
 bool OrderManager::HasPendingNetPositionOrders() const {
@@ -186,29 +223,18 @@ bool OrderManager::HasPendingNetPositionOrders() const {
 
 int OrderManager::PendingNetPositionOrderCount() const {
   int count = 0;
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (!IsNetPositionMutating(record.intent.purpose)) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    ++count;
+  for (const auto& [symbol, ids] : pending_net_ids_by_symbol_) {
+    (void)symbol;
+    count += static_cast<int>(ids.size());
   }
   return count;
 }
 
 std::vector<std::string> OrderManager::PendingNetPositionOrderIds() const {
   std::vector<std::string> ids;
-  for (const auto& [order_id, record] : orders_) {
-    if (!IsNetPositionMutating(record.intent.purpose)) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    ids.push_back(order_id);
+  for (const auto& [symbol, symbol_ids] : pending_net_ids_by_symbol_) {
+    (void)symbol;
+    ids.insert(ids.end(), symbol_ids.begin(), symbol_ids.end());
   }
   return ids;
 }
@@ -226,19 +252,17 @@ int OrderManager::PendingNetPositionOrderCountForSymbolDirection(
     return 0;
   }
   const int normalized_direction = direction > 0 ? 1 : -1;
+  const auto symbol_it = pending_net_ids_by_symbol_.find(symbol);
+  if (symbol_it == pending_net_ids_by_symbol_.end()) {
+    return 0;
+  }
   int count = 0;
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (!IsNetPositionMutating(record.intent.purpose)) {
+  for (const auto& order_id : symbol_it->second) {
+    const auto* record = Find(order_id);
+    if (record == nullptr || record->intent.direction == 0) {
       continue;
     }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    if (record.intent.symbol != symbol || record.intent.direction == 0) {
-      continue;
-    }
-    const int pending_direction = record.intent.direction > 0 ? 1 : -1;
+    const int pending_direction = record->intent.direction > 0 ? 1 : -1;
     if (pending_direction == normalized_direction) {
       ++count;
     }
@@ -253,19 +277,18 @@ int OrderManager::PendingEntryOrderCountForSymbolDirection(
     return 0;
   }
   const int normalized_direction = direction > 0 ? 1 : -1;
+  const auto symbol_it = pending_net_ids_by_symbol_.find(symbol);
+  if (symbol_it == pending_net_ids_by_symbol_.end()) {
+    return 0;
+  }
   int count = 0;
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (record.intent.purpose != OrderPurpose::kEntry) {
+  for (const auto& order_id : symbol_it->second) {
+    const auto* record = Find(order_id);
+    if (record == nullptr || record->intent.purpose != OrderPurpose::kEntry ||
+        record->intent.direction == 0) {
       continue;
     }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    if (record.intent.symbol != symbol || record.intent.direction == 0) {
-      continue;
-    }
-    const int pending_direction = record.intent.direction > 0 ? 1 : -1;
+    const int pending_direction = record->intent.direction > 0 ? 1 : -1;
     if (pending_direction == normalized_direction) {
       ++count;
     }
@@ -278,19 +301,8 @@ bool OrderManager::HasPendingNetPositionOrderForSymbol(
   if (symbol.empty()) {
     return false;
   }
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (!IsNetPositionMutating(record.intent.purpose)) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    if (record.intent.symbol == symbol) {
-      return true;
-    }
-  }
-  return false;
+  const auto it = pending_net_ids_by_symbol_.find(symbol);
+  return it != pending_net_ids_by_symbol_.end() && !it->second.empty();
 }
 
 double OrderManager::PendingNetPositionRemainingQtyForSymbol(
@@ -298,26 +310,51 @@ double OrderManager::PendingNetPositionRemainingQtyForSymbol(
   if (symbol.empty()) {
     return 0.0;
   }
+  const auto symbol_it = pending_net_ids_by_symbol_.find(symbol);
+  if (symbol_it == pending_net_ids_by_symbol_.end()) {
+    return 0.0;
+  }
   double remaining_signed_qty = 0.0;
-  for (const auto& [order_id, record] : orders_) {
-    (void)order_id;
-    if (!IsNetPositionMutating(record.intent.purpose)) {
-      continue;
-    }
-    if (IsTerminalState(record.state)) {
-      continue;
-    }
-    if (record.intent.symbol != symbol || record.intent.direction == 0) {
+  for (const auto& order_id : symbol_it->second) {
+    const auto* record = Find(order_id);
+    if (record == nullptr || record->intent.direction == 0) {
       continue;
     }
-    const double remaining_qty = std::max(0.0, record.intent.qty - record.filled_qty);
+    const double remaining_qty =
+        std::max(0.0, record->intent.qty - record->filled_qty);
     if (remaining_qty <= kEpsilon) {
       continue;
     }
-    const double direction = record.intent.direction > 0 ? 1.0 : -1.0;
+    const double direction = record->intent.direction > 0 ? 1.0 : -1.0;
     remaining_signed_qty += direction * remaining_qty;
   }
   return remaining_signed_qty;
 }
 
+void OrderManager::SchedulePendingDeadline(const std::string& client_order_id,
+                                           std::int64_t deadline_ms) {
+  if (client_order_id.empty()) {
+    return;
+  }
+  pending_deadlines_.emplace(deadline_ms, client_order_id);
+}
+
+std::vector<std::string> OrderManager::TakeExpiredPendingNetPositionOrders(
+    std::int64_t now_ms) {
+  std::vector<std::string> expired;
+  while (!pending_deadlines_.empty() &&
+         pending_deadlines_.top().first <= now_ms) {
+    std::string order_id = pending_deadlines_.top().second;
+    pending_deadlines_.pop();
+    // 惰性删除：订单已终态/非净仓位订单时条目直接丢弃。
+    const auto* record = Find(order_id);
+    if (record == nullptr || IsTerminalState(record->state) ||
+        !IsNetPositionMutating(record->intent.purpose)) {
+      continue;
+    }
+    expired.push_back(std::move(order_id));
+  }
+  return expired;
+}
+
 }  // namespace ai_trade
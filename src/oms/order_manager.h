@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "core/types.h"
@@ -35,6 +39,13 @@ struct OrderRecord {
  * 2. 追踪订单状态变化 (New -> Sent -> Filled/Cancelled)
  * 3. 维护净成交数量 (Net Filled Qty) 用于对账
  * 4. 管理保护单 (SL/TP) 的关联关系
+ *
+ * 性能口径：
+ * - 订单主表随运行累积（含大量终态历史与长挂保护单），
+ *   周期性查询不允许全表扫描；
+ * - 在途净仓位订单按 symbol、未终态保护单按 parent_id 维护二级索引，
+ *   索引只在状态迁移点增量更新，查询成本与“在途订单数”同阶；
+ * - 超时收敛使用截止时间小顶堆（惰性删除），每轮只弹出到期条目。
  */
 class OrderManager {
  public:
@@ -123,6 +134,23 @@ class OrderManager {
   double PendingNetPositionRemainingQtyForSymbol(
       const std::string& symbol) const;
 
+  /**
+   * @brief 登记在途订单的超时截止时间
+   *
+   * 截止条目进入小顶堆，由 `TakeExpiredPendingNetPositionOrders` 按到期
+   * 顺序弹出；订单先行终态时条目惰性失效，无需显式删除。
+   */
+  void SchedulePendingDeadline(const std::string& client_order_id,
+                               std::int64_t deadline_ms);
+  /**
+   * @brief 弹出所有“已到期且仍在途”的净仓位订单 id
+   *
+   * 只处理堆顶已到期的条目（O(到期数 · log 堆)），已终态或未知订单
+   * 的条目直接丢弃；未到期条目保留在堆中等待下轮。
+   */
+  std::vector<std::string> TakeExpiredPendingNetPositionOrders(
+      std::int64_t now_ms);
+
   /// 全局净成交数量（跨 symbol 聚合，signed qty）。
   double net_filled_qty() const { return net_filled_qty_; }
   /// 单 symbol 净成交数量（signed qty）。
@@ -136,9 +164,27 @@ class OrderManager {
   static bool IsTerminalState(OrderState state);
 
  private:
+  /// 截止时间堆条目：`(deadline_ms, client_order_id)`，按时间小顶排序。
+  using DeadlineEntry = std::pair<std::int64_t, std::string>;
+
+  /// 状态迁移后同步二级索引：在途则确保入索引，终态则移除。
+  void SyncIndexes(const std::string& client_order_id,
+                   const OrderRecord& record);
+
   std::unordered_map<std::string, OrderRecord> orders_;  ///< 订单主表（client_order_id 索引）。
   double net_filled_qty_{0.0};  ///< 全局净成交数量（signed qty）。
   std::unordered_map<std::string, double> net_filled_qty_by_symbol_;  ///< 单 symbol 净成交数量。
+
+  /// 二级索引：symbol -> 在途净仓位订单 id（Entry/Reduce 且非终态）。
+  std::unordered_map<std::string, std::unordered_set<std::string>>
+      pending_net_ids_by_symbol_;
+  /// 二级索引：parent_order_id -> 未终态保护单 id（SL/TP）。
+  std::unordered_map<std::string, std::unordered_set<std::string>>
+      open_protection_ids_by_parent_;
+  /// 超时截止时间小顶堆（惰性删除：弹出时校验订单仍在途）。
+  std::priority_queue<DeadlineEntry, std::vector<DeadlineEntry>,
+                      std::greater<DeadlineEntry>>
+      pending_deadlines_;
 };
 
 }  // namespace ai_trade
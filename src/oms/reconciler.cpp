@@ -140,4 +140,51 @@ std::string Reconciler::BuildSymbolDeltaReport(
   return oss.str();
 }
 
+RemoteOpenOrderDiff Reconciler::UpdateRemoteOpenOrders(
+    const std::unordered_set<std::string>& client_order_ids) {
+  remote_open_order_scratch_.clear();
+  remote_open_order_scratch_.reserve(client_order_ids.size());
+  for (const auto& client_order_id : client_order_ids) {
+    remote_open_order_scratch_.push_back(
+        std::hash<std::string>{}(client_order_id));
+  }
+  std::sort(remote_open_order_scratch_.begin(),
+            remote_open_order_scratch_.end());
+
+  // 归并差分两个升序纪元：只统计真正出现/消失的 id。
+  RemoteOpenOrderDiff diff;
+  std::size_t prev_index = 0;
+  std::size_t next_index = 0;
+  while (prev_index < remote_open_order_epoch_.size() &&
+         next_index < remote_open_order_scratch_.size()) {
+    const std::uint64_t prev_hash = remote_open_order_epoch_[prev_index];
+    const std::uint64_t next_hash = remote_open_order_scratch_[next_index];
+    if (prev_hash == next_hash) {
+      ++prev_index;
+      ++next_index;
+    } else if (prev_hash < next_hash) {
+      ++diff.disappeared;
+      ++prev_index;
+    } else {
+      ++diff.appeared;
+      ++next_index;
+    }
+  }
+  diff.disappeared +=
+      static_cast<int>(remote_open_order_epoch_.size() - prev_index);
+  diff.appeared +=
+      static_cast<int>(remote_open_order_scratch_.size() - next_index);
+
+  // 交换而非拷贝：两个缓冲轮换复用，稳态无分配。
+  remote_open_order_epoch_.swap(remote_open_order_scratch_);
+  return diff;
+}
+
+bool Reconciler::RemoteOpenOrderEpochContains(
+    const std::string& client_order_id) const {
+  return std::binary_search(remote_open_order_epoch_.begin(),
+                            remote_open_order_epoch_.end(),
+                            std::hash<std::string>{}(client_order_id));
+}
+
 }  // namespace ai_trade
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "core/types.h"
@@ -17,6 +19,14 @@ struct ReconcileResult {
   std::string reason_code;
 };
 
+/// 远端活动订单集合一轮吸收后的差分统计。
+struct RemoteOpenOrderDiff {
+  int appeared{0};     ///< 本轮新出现的 id 数。
+  int disappeared{0};  ///< 本轮消失的 id 数。
+
+  bool changed() const { return appeared > 0 || disappeared > 0; }
+};
+
 /**
  * @brief 本地对账器
  *
@@ -45,8 +55,30 @@ class Reconciler {
       const std::vector<std::string>& tracked_symbols,
       double min_abs_notional_delta_usd = 1.0) const;
 
+  /**
+   * @brief 吸收一轮远端活动订单 id 集合（保留排序哈希纪元）
+   *
+   * 每轮把 id 取 64 位哈希写入复用缓冲并排序，与上一轮保留纪元做
+   * 归并差分：稳态下不产生堆分配，差分结果只覆盖真正出现/消失的
+   * id，供调用方做无变化快路径与诊断日志。
+   */
+  RemoteOpenOrderDiff UpdateRemoteOpenOrders(
+      const std::unordered_set<std::string>& client_order_ids);
+  /**
+   * @brief 远端活动纪元中是否包含该 client_order_id（二分查找）
+   *
+   * 说明：按 64 位哈希判定，理论上存在碰撞把“远端已消失”误判为
+   * “仍在远端”的可能，该场景由在途订单的超时收敛路径兜底。
+   */
+  bool RemoteOpenOrderEpochContains(const std::string& client_order_id) const;
+
  private:
   double tolerance_notional_usd_{5.0};  ///< 允许的净名义敞口偏差容差（USD）。
+
+  /// 上一轮远端活动订单 id 的 64 位哈希（升序保留纪元）。
+  std::vector<std::uint64_t> remote_open_order_epoch_;
+  /// 每轮复用的哈希缓冲（避免稳态分配）。
+  std::vector<std::uint64_t> remote_open_order_scratch_;
 };
 
 }  // namespace ai_trade
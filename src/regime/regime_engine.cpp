@@ -1,7 +1,13 @@
 #include "regime/regime_engine.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <thread>
+#include <unordered_map>
+
+#include "core/snapshot_io.h"
+#include "core/symbol_table.h"
 
 namespace ai_trade {
 
@@ -186,6 +192,20 @@ RegimeState RegimeEngine::ProcessSample(SymbolState& symbol_state,
   return state;
 }
 
+RegimeEngine::SymbolState& RegimeEngine::StateFor(const MarketEvent& event) {
+  // 入口已 intern 的事件直接用 id；直接构造的事件（测试/回放）回退一次。
+  const SymbolId symbol_id = event.symbol_id != kInvalidSymbolId
+                                 ? event.symbol_id
+                                 : InternSymbol(event.symbol);
+  if (symbol_state_.size() <= symbol_id) {
+    symbol_state_.resize(symbol_id + 1);
+  }
+  if (!symbol_state_[symbol_id]) {
+    symbol_state_[symbol_id] = std::make_unique<SymbolState>();
+  }
+  return *symbol_state_[symbol_id];
+}
+
 RegimeState RegimeEngine::OnMarket(const MarketEvent& event) {
   RegimeState state;
   state.symbol = event.symbol;
@@ -195,7 +215,7 @@ RegimeState RegimeEngine::OnMarket(const MarketEvent& event) {
     return state;
   }
 
-  SymbolState& symbol_state = symbol_state_[event.symbol];
+  SymbolState& symbol_state = StateFor(event);
   if (config_.bar_interval_ms <= 0) {
     return ProcessSample(symbol_state,
                          event.symbol,
@@ -236,4 +256,160 @@ RegimeState RegimeEngine::OnMarket(const MarketEvent& event) {
                        aggregated_event_count);
 }
 
+std::size_t RegimeEngine::PreloadHistory(std::span<const MarketEvent> events) {
+  if (events.empty()) {
+    return 0;
+  }
+
+  // 先串行建好全部槽位并按 symbol 分组（保持各 symbol 内相对顺序），
+  // 预热线程随后只触碰自己 symbol 的状态，零跨线程共享可写数据。
+  std::vector<std::vector<const MarketEvent*>> groups;
+  std::unordered_map<SymbolId, std::size_t> group_index;
+  for (const MarketEvent& event : events) {
+    const SymbolId symbol_id = event.symbol_id != kInvalidSymbolId
+                                   ? event.symbol_id
+                                   : InternSymbol(event.symbol);
+    const auto [it, inserted] = group_index.emplace(symbol_id, groups.size());
+    if (inserted) {
+      groups.emplace_back();
+      StateFor(event);
+    }
+    groups[it->second].push_back(&event);
+  }
+
+  // 工作线程按原子游标领 symbol，单 symbol 的样本流串行推进。
+  std::atomic<std::size_t> next_group{0};
+  const auto worker = [&]() {
+    while (true) {
+      const std::size_t g = next_group.fetch_add(1, std::memory_order_relaxed);
+      if (g >= groups.size()) {
+        return;
+      }
+      for (const MarketEvent* event : groups[g]) {
+        OnMarket(*event);
+      }
+    }
+  };
+  const std::size_t worker_count = std::min(
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1),
+      groups.size());
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+
+  std::size_t warmup_cleared = 0;
+  for (const auto& entry : group_index) {
+    const auto& state = symbol_state_[entry.first];
+    if (state && state->has_last_emitted_state &&
+        !state->last_emitted_state.warmup) {
+      ++warmup_cleared;
+    }
+  }
+  return warmup_cleared;
+}
+
+namespace {
+
+// 快照字段清单与 RegimeState 声明顺序一一对应（读写共用）。
+template <typename Archive>
+void ArchiveRegimeState(Archive& ar, RegimeState& state) {
+  ar.Field(state.symbol);
+  ar.Field(state.regime);
+  ar.Field(state.bucket);
+  ar.Field(state.raw_regime);
+  ar.Field(state.raw_bucket);
+  ar.Field(state.pending_regime);
+  ar.Field(state.pending_bucket);
+  ar.Field(state.instant_return);
+  ar.Field(state.trend_strength);
+  ar.Field(state.volatility_level);
+  ar.Field(state.trend_threshold_ratio);
+  ar.Field(state.volatility_threshold_ratio);
+  ar.Field(state.decision_interval_ms);
+  ar.Field(state.aggregated_event_count);
+  ar.Field(state.pending_regime_ticks);
+  ar.Field(state.confirm_ticks_required);
+  ar.Field(state.pending_regime_elapsed_ms);
+  ar.Field(state.confirm_elapsed_ms_required);
+  ar.Field(state.pending_trend_confirmation);
+  ar.Field(state.trend_candidate);
+  ar.Field(state.warmup_trend_candidate);
+  ar.Field(state.warmup);
+}
+
+}  // namespace
+
+void RegimeEngine::SaveState(SnapshotWriter* writer) const {
+  std::uint64_t active = 0;
+  for (const auto& state : symbol_state_) {
+    if (state) {
+      ++active;
+    }
+  }
+  writer->Field(active);
+  for (SymbolId id = 0; id < symbol_state_.size(); ++id) {
+    const auto& state = symbol_state_[id];
+    if (!state) {
+      continue;
+    }
+    writer->Field(SymbolNameOf(id));
+    writer->Field(state->has_last_price);
+    writer->Field(state->last_price);
+    writer->Field(state->sample_ticks);
+    writer->Field(state->ewma_return);
+    writer->Field(state->ewma_abs_return);
+    writer->Field(state->ewma_volume);
+    writer->Field(state->pending_interval_ms);
+    writer->Field(state->pending_volume);
+    writer->Field(state->pending_price);
+    writer->Field(state->pending_event_count);
+    writer->Field(state->has_last_emitted_state);
+    RegimeState emitted_copy = state->last_emitted_state;
+    ArchiveRegimeState(*writer, emitted_copy);
+    writer->Field(state->has_confirmed_regime);
+    writer->Field(state->confirmed_regime);
+    writer->Field(state->pending_regime);
+    writer->Field(state->pending_regime_ticks);
+    writer->Field(state->pending_regime_elapsed_ms);
+  }
+}
+
+void RegimeEngine::LoadState(SnapshotReader* reader) {
+  symbol_state_.clear();
+  std::uint64_t count = 0;
+  reader->Field(count);
+  for (std::uint64_t i = 0; reader->ok() && i < count; ++i) {
+    std::string symbol;
+    reader->Field(symbol);
+    const SymbolId symbol_id = InternSymbol(symbol);
+    if (symbol_state_.size() <= symbol_id) {
+      symbol_state_.resize(symbol_id + 1);
+    }
+    auto state = std::make_unique<SymbolState>();
+    reader->Field(state->has_last_price);
+    reader->Field(state->last_price);
+    reader->Field(state->sample_ticks);
+    reader->Field(state->ewma_return);
+    reader->Field(state->ewma_abs_return);
+    reader->Field(state->ewma_volume);
+    reader->Field(state->pending_interval_ms);
+    reader->Field(state->pending_volume);
+    reader->Field(state->pending_price);
+    reader->Field(state->pending_event_count);
+    reader->Field(state->has_last_emitted_state);
+    ArchiveRegimeState(*reader, state->last_emitted_state);
+    reader->Field(state->has_confirmed_regime);
+    reader->Field(state->confirmed_regime);
+    reader->Field(state->pending_regime);
+    reader->Field(state->pending_regime_ticks);
+    reader->Field(state->pending_regime_elapsed_ms);
+    symbol_state_[symbol_id] = std::move(state);
+  }
+}
+
 }  // namespace ai_trade
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <memory>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "core/config.h"
 #include "core/types.h"
 
 namespace ai_trade {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /**
  * @brief Regime 轻量识别器
  *
@@ -20,9 +25,29 @@ class RegimeEngine {
  public:
   explicit RegimeEngine(RegimeConfig config = {}) : config_(config) {}
 
+  /// 热更新 Regime 参数（EWMA/warmup 等运行态保持不变）。
+  void SetConfig(const RegimeConfig& config) { config_ = config; }
+
   /// 输入一笔行情并返回最新 Regime 状态。
   RegimeState OnMarket(const MarketEvent& event);
 
+  /**
+   * @brief 用历史 K 线事件按内存速度预热状态机（仅启动期调用）
+   *
+   * 事件按 symbol 分组后并行推进：各 symbol 槽位先串行建好，预热
+   * 线程只触碰自己 symbol 的状态，互不共享可写数据。调用后已喂足
+   * 样本的 symbol 直接进入确认态，首个实时 tick 不再处于 warmup。
+   *
+   * @return warmup 已清除的 symbol 数
+   */
+  std::size_t PreloadHistory(std::span<const MarketEvent> events);
+
+  /// 把各 symbol 的 EWMA/warmup/确认态写入二进制快照。
+  /// 状态按 symbol 名落盘，跨进程重启不依赖 SymbolId 分配顺序。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复各 symbol 运行态；缓冲损坏时由调用方检查 reader->ok()。
+  void LoadState(SnapshotReader* reader);
+
  private:
   struct SymbolState {
     bool has_last_price{false};     ///< 是否已拿到上一笔价格。
@@ -51,9 +76,12 @@ class RegimeEngine {
                             double volume,
                             std::int64_t interval_ms,
                             int aggregated_event_count);
+  /// 取 event 对应 symbol 的运行态（按稠密 SymbolId 索引，按需创建）。
+  SymbolState& StateFor(const MarketEvent& event);
 
   RegimeConfig config_;  ///< Regime 识别配置快照。
-  std::unordered_map<std::string, SymbolState> symbol_state_;  ///< 多币对运行态。
+  // 多币对运行态：按 SymbolId 稠密索引（数组下标替代字符串哈希）。
+  std::vector<std::unique_ptr<SymbolState>> symbol_state_;
 };
 
 }  // namespace ai_trade
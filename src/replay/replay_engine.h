@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/config.h"
+#include "core/symbol_table.h"
+#include "core/types.h"
+#include "research/bar_store.h"
+#include "system/trade_system.h"
+
+namespace ai_trade {
+
+/// 回放汇总：与 bot_app RUNTIME_STATUS 漏斗同口径的核心计数。
+struct ReplayStats {
+  std::size_t events{0};          ///< 回放的行情事件数。
+  std::size_t active_signals{0};  ///< 最终信号方向非零的事件数。
+  std::size_t warmup_events{0};   ///< Regime 仍处 warmup 的事件数。
+  std::size_t intents{0};         ///< 产生订单意图的事件数。
+  std::size_t fills{0};           ///< 模拟成交数（意图即时成交语义）。
+  double final_equity_usd{0.0};
+  double realized_pnl_usd{0.0};
+  double gross_notional_usd{0.0};
+  double elapsed_seconds{0.0};
+  double events_per_second{0.0};
+};
+
+/// 单 symbol 的只读 K 线视图（mmap 列的切片）；跨线程零拷贝共享。
+struct BarSeriesView {
+  std::string symbol;
+  SymbolId symbol_id{kInvalidSymbolId};
+  std::span<const std::int64_t> ts_ms;
+  std::span<const double> closes;
+  std::span<const double> volumes;
+  std::int64_t default_interval_ms{60000};
+};
+
+/**
+ * @brief 已挂载的列式 K 线集合
+ *
+ * 每个文件只 mmap 打开一次；`Views()` 产出的切片可被任意多个并行
+ * 消费者（单次回放、walk-forward 各折）只读共享，零拷贝。
+ */
+class BarSeriesSet {
+ public:
+  /// 挂载一个 symbol 的列式 K 线文件（ATCBAR1 格式）；可多次调用。
+  /// `default_interval_ms` 用于首条样本（无前驱可求时间差）。
+  bool AddSymbolBars(const std::string& symbol, const std::string& bar_path,
+                     std::int64_t default_interval_ms, std::string* out_error);
+
+  std::vector<BarSeriesView> Views() const;
+  bool empty() const { return sources_.empty(); }
+
+  /// 全部 symbol 的最早/最晚时间戳（空集合时返回 0）。
+  std::int64_t MinTimestampMs() const;
+  std::int64_t MaxTimestampMs() const;
+
+ private:
+  struct Source {
+    std::string symbol;
+    SymbolId symbol_id{kInvalidSymbolId};
+    research::ColumnarBarStore store;
+    std::int64_t default_interval_ms{60000};
+  };
+
+  std::vector<Source> sources_;
+};
+
+/**
+ * @brief 将多 symbol K 线视图按 ts 归并回放进给定 TradeSystem
+ *
+ * 仅处理时间戳落在 `[ts_begin, ts_end)` 的样本；`stats_from_ts` 之前
+ * 的事件作状态预热（trade_ok=false，不计统计、不产生持仓），之后的
+ * 事件完整评估并按 OnPrice 的 Mock 即时成交语义回灌 `OnFill`。
+ * 返回的统计只覆盖计数字段；耗时与账户快照由调用方补齐。
+ */
+ReplayStats ReplaySeriesInto(TradeSystem* system,
+                             std::span<const BarSeriesView> series,
+                             std::int64_t ts_begin,
+                             std::int64_t ts_end,
+                             std::int64_t stats_from_ts);
+
+/**
+ * @brief 原生回放引擎：列式 K 线 → MarketEvent → TradeSystem
+ *
+ * 设计动机：tools/backtest_walkforward.py 与 run_replay_validation.py
+ * 用 Python 近似重写了决策流水线，既慢几个数量级、口径又会漂移。
+ * 本引擎直接 mmap 打开 `ColumnarBarStore`（ATCBAR1）历史 K 线，按
+ * 时间戳归并多 symbol 事件流，驱动与实盘完全同一份
+ * `TradeSystem::Evaluate` 代码，意图按 OnPrice 的 Mock 即时成交语义
+ * 回灌 `OnFill` —— 校验的就是实盘路径本身，而非它的 Python 影子。
+ */
+class ReplayEngine {
+ public:
+  explicit ReplayEngine(const AppConfig& config);
+
+  /// 挂载一个 symbol 的列式 K 线文件；参见 BarSeriesSet::AddSymbolBars。
+  bool AddSymbolBars(const std::string& symbol, const std::string& bar_path,
+                     std::int64_t default_interval_ms, std::string* out_error);
+
+  /// 运行回放：多 symbol 事件按 ts 归并后逐条评估，意图即时成交。
+  bool Run(ReplayStats* out_stats, std::string* out_error);
+
+  /// 与 RUNTIME_STATUS 同风格的汇总行（Run 之后有效）。
+  std::string SummaryLine() const;
+
+  const ReplayStats& stats() const { return stats_; }
+  const TradeSystem& system() const { return system_; }
+
+ private:
+  TradeSystem system_;
+  BarSeriesSet series_;
+  ReplayStats stats_;
+};
+
+}  // namespace ai_trade
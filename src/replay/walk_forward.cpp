@@ -0,0 +1,180 @@
+#include "replay/walk_forward.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include "core/line_writer.h"
+
+namespace ai_trade {
+
+WalkForwardRunner::WalkForwardRunner(const AppConfig& config)
+    : config_(config) {}
+
+bool WalkForwardRunner::AddSymbolBars(const std::string& symbol,
+                                      const std::string& bar_path,
+                                      std::int64_t default_interval_ms,
+                                      std::string* out_error) {
+  return series_.AddSymbolBars(symbol, bar_path, default_interval_ms,
+                               out_error);
+}
+
+bool WalkForwardRunner::Run(std::size_t fold_count, std::size_t max_parallel,
+                            WalkForwardReport* out_report,
+                            std::string* out_error) {
+  if (series_.empty()) {
+    if (out_error != nullptr) {
+      *out_error = "walk-forward 未挂载任何 K 线文件";
+    }
+    return false;
+  }
+  if (fold_count == 0) {
+    if (out_error != nullptr) {
+      *out_error = "walk-forward 折数必须大于 0";
+    }
+    return false;
+  }
+
+  const std::int64_t min_ts = series_.MinTimestampMs();
+  const std::int64_t max_ts = series_.MaxTimestampMs();
+  const std::int64_t span_ms = max_ts - min_ts + 1;
+  if (span_ms < static_cast<std::int64_t>(fold_count)) {
+    if (out_error != nullptr) {
+      *out_error = "walk-forward 样本时间跨度不足以切分 " +
+                   std::to_string(fold_count) + " 折";
+    }
+    return false;
+  }
+
+  WalkForwardReport report;
+  report.folds.resize(fold_count);
+  for (std::size_t k = 0; k < fold_count; ++k) {
+    auto& fold = report.folds[k];
+    fold.fold_index = k;
+    fold.test_begin_ts =
+        min_ts + static_cast<std::int64_t>(k) * span_ms /
+                     static_cast<std::int64_t>(fold_count);
+    fold.test_end_ts =
+        min_ts + static_cast<std::int64_t>(k + 1) * span_ms /
+                     static_cast<std::int64_t>(fold_count);
+  }
+
+  // 各折独立 TradeSystem，只读共享 mmap 列；工作线程按原子游标领折。
+  const std::vector<BarSeriesView> views = series_.Views();
+  if (max_parallel == 0) {
+    max_parallel = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  const std::size_t worker_count = std::min(max_parallel, fold_count);
+
+  const auto wall_start = std::chrono::steady_clock::now();
+  std::atomic<std::size_t> next_fold{0};
+  auto worker = [&]() {
+    while (true) {
+      const std::size_t k = next_fold.fetch_add(1, std::memory_order_relaxed);
+      if (k >= fold_count) {
+        return;
+      }
+      auto& fold = report.folds[k];
+      TradeSystem system(config_);
+      const auto fold_start = std::chrono::steady_clock::now();
+      fold.stats = ReplaySeriesInto(&system, views,
+                                    std::numeric_limits<std::int64_t>::min(),
+                                    fold.test_end_ts, fold.test_begin_ts);
+      const auto fold_end = std::chrono::steady_clock::now();
+      fold.stats.elapsed_seconds =
+          std::chrono::duration<double>(fold_end - fold_start).count();
+      fold.stats.events_per_second =
+          fold.stats.elapsed_seconds > 0.0
+              ? static_cast<double>(fold.stats.events) /
+                    fold.stats.elapsed_seconds
+              : 0.0;
+      fold.stats.final_equity_usd = system.account().equity_usd();
+      fold.stats.realized_pnl_usd =
+          system.account().cumulative_realized_pnl_usd();
+      fold.stats.gross_notional_usd = system.account().gross_notional_usd();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  const auto wall_end = std::chrono::steady_clock::now();
+  report.wall_seconds =
+      std::chrono::duration<double>(wall_end - wall_start).count();
+
+  for (const auto& fold : report.folds) {
+    report.total.events += fold.stats.events;
+    report.total.active_signals += fold.stats.active_signals;
+    report.total.warmup_events += fold.stats.warmup_events;
+    report.total.intents += fold.stats.intents;
+    report.total.fills += fold.stats.fills;
+    report.total.final_equity_usd += fold.stats.final_equity_usd;
+    report.total.realized_pnl_usd += fold.stats.realized_pnl_usd;
+    report.total.gross_notional_usd += fold.stats.gross_notional_usd;
+  }
+  report.total.elapsed_seconds = report.wall_seconds;
+  report.total.events_per_second =
+      report.wall_seconds > 0.0
+          ? static_cast<double>(report.total.events) / report.wall_seconds
+          : 0.0;
+
+  if (out_report != nullptr) {
+    *out_report = std::move(report);
+  }
+  return true;
+}
+
+std::string WalkForwardSummaryLine(const WalkForwardReport& report) {
+  LineWriter line;
+  line.Append("WALK_FORWARD_SUMMARY: folds=")
+      .AppendInt(static_cast<std::int64_t>(report.folds.size()))
+      .Append(", events=")
+      .AppendInt(static_cast<std::int64_t>(report.total.events))
+      .Append(", active_signals=")
+      .AppendInt(static_cast<std::int64_t>(report.total.active_signals))
+      .Append(", warmup=")
+      .AppendInt(static_cast<std::int64_t>(report.total.warmup_events))
+      .Append(", intents=")
+      .AppendInt(static_cast<std::int64_t>(report.total.intents))
+      .Append(", fills=")
+      .AppendInt(static_cast<std::int64_t>(report.total.fills))
+      .Append(", realized_pnl=")
+      .AppendDoubleFixed(report.total.realized_pnl_usd, 2)
+      .Append(", wall_s=")
+      .AppendDoubleFixed(report.wall_seconds, 3)
+      .Append(", events_per_s=")
+      .AppendDoubleFixed(report.total.events_per_second, 0);
+  return line.TakeString();
+}
+
+std::string WalkForwardFoldLine(const WalkForwardFoldResult& fold) {
+  LineWriter line;
+  line.Append("WALK_FORWARD_FOLD: index=")
+      .AppendInt(static_cast<std::int64_t>(fold.fold_index))
+      .Append(", test_ts=[")
+      .AppendInt(fold.test_begin_ts)
+      .Append(", ")
+      .AppendInt(fold.test_end_ts)
+      .Append("), events=")
+      .AppendInt(static_cast<std::int64_t>(fold.stats.events))
+      .Append(", intents=")
+      .AppendInt(static_cast<std::int64_t>(fold.stats.intents))
+      .Append(", fills=")
+      .AppendInt(static_cast<std::int64_t>(fold.stats.fills))
+      .Append(", realized_pnl=")
+      .AppendDoubleFixed(fold.stats.realized_pnl_usd, 2)
+      .Append(", equity=")
+      .AppendDoubleFixed(fold.stats.final_equity_usd, 2)
+      .Append(", elapsed_s=")
+      .AppendDoubleFixed(fold.stats.elapsed_seconds, 3);
+  return line.TakeString();
+}
+
+}  // namespace ai_trade
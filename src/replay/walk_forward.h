@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/config.h"
+#include "replay/replay_engine.h"
+
+namespace ai_trade {
+
+/// 单折结果：测试窗口内的漏斗计数 + 该折自身账户快照。
+struct WalkForwardFoldResult {
+  std::size_t fold_index{0};
+  std::int64_t test_begin_ts{0};
+  std::int64_t test_end_ts{0};  ///< 开区间右端点。
+  ReplayStats stats;
+};
+
+/// 全部折的汇总：计数字段为各折测试窗口求和（账户字段同为求和，
+/// 逐折口径见 `folds`）。
+struct WalkForwardReport {
+  std::vector<WalkForwardFoldResult> folds;
+  ReplayStats total;
+  double wall_seconds{0.0};
+};
+
+/**
+ * @brief Walk-forward 折级并行回放
+ *
+ * 时间轴均分为 N 个测试窗口；第 k 折用 `[min_ts, w_k)` 的全部历史做
+ * 状态预热（trade_ok=false，走出样本外语义），再在 `[w_k, w_{k+1})`
+ * 内完整评估 + 即时成交。各折持独立 `TradeSystem`（同一 AppConfig
+ * 构造）互不共享可写状态，只读共享同一份 mmap K 线列，因此可各占
+ * 一核并行执行；折结果在全部线程汇合后按折序合并。
+ */
+class WalkForwardRunner {
+ public:
+  explicit WalkForwardRunner(const AppConfig& config);
+
+  /// 挂载一个 symbol 的列式 K 线文件；参见 BarSeriesSet::AddSymbolBars。
+  bool AddSymbolBars(const std::string& symbol, const std::string& bar_path,
+                     std::int64_t default_interval_ms, std::string* out_error);
+
+  /// 运行全部折。`max_parallel` 为 0 时取硬件并发数。
+  bool Run(std::size_t fold_count, std::size_t max_parallel,
+           WalkForwardReport* out_report, std::string* out_error);
+
+ private:
+  AppConfig config_;
+  BarSeriesSet series_;
+};
+
+/// 与 RUNTIME_STATUS 同风格的单行汇总。
+std::string WalkForwardSummaryLine(const WalkForwardReport& report);
+
+/// 单折明细行（逐折打印用）。
+std::string WalkForwardFoldLine(const WalkForwardFoldResult& fold);
+
+}  // namespace ai_trade
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/config.h"
+#include "core/log.h"
+#include "replay/replay_engine.h"
+#include "replay/walk_forward.h"
+
+namespace {
+
+// 回放参数：K 线文件按 `--bars=SYMBOL=path` 逐个挂载，可重复。
+struct ReplayOptions {
+  std::string config_path{"config/default.yaml"};
+  bool config_path_explicit{false};
+  std::vector<std::pair<std::string, std::string>> symbol_bars;
+  std::int64_t default_interval_ms{60000};
+  std::size_t walk_forward_folds{0};  ///< >0 时走 walk-forward 折级并行。
+  std::size_t max_parallel{0};        ///< 0 取硬件并发数。
+  bool show_usage{false};
+};
+
+void PrintUsage() {
+  ai_trade::LogInfo(
+      "用法: trade_replay --bars=SYMBOL=path.bin [--bars=...] "
+      "[--config=config/default.yaml] [--default_interval_ms=60000] "
+      "[--walk_forward_folds=N] [--max_parallel=N]");
+  ai_trade::LogInfo(
+      "K 线文件为 ATCBAR1 列式格式，可用 ConvertResearchCsvToColumnar "
+      "从研究 CSV 一次性转换");
+}
+
+ReplayOptions ParseOptions(int argc, char** argv) {
+  ReplayOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.rfind("--config=", 0) == 0) {
+      options.config_path = arg.substr(std::string("--config=").size());
+      options.config_path_explicit = true;
+      continue;
+    }
+    if (arg.rfind("--bars=", 0) == 0) {
+      const std::string value = arg.substr(std::string("--bars=").size());
+      const std::size_t sep = value.find('=');
+      if (sep == std::string::npos || sep == 0 || sep + 1 >= value.size()) {
+        ai_trade::LogInfo("--bars 参数非法（应为 SYMBOL=path），已忽略: " +
+                          value);
+        continue;
+      }
+      options.symbol_bars.emplace_back(value.substr(0, sep),
+                                       value.substr(sep + 1));
+      continue;
+    }
+    if (arg.rfind("--default_interval_ms=", 0) == 0) {
+      const std::string value =
+          arg.substr(std::string("--default_interval_ms=").size());
+      try {
+        options.default_interval_ms = std::stoll(value);
+      } catch (...) {
+        ai_trade::LogInfo("--default_interval_ms 参数非法，已忽略: " + value);
+      }
+      continue;
+    }
+    if (arg.rfind("--walk_forward_folds=", 0) == 0) {
+      const std::string value =
+          arg.substr(std::string("--walk_forward_folds=").size());
+      try {
+        options.walk_forward_folds = static_cast<std::size_t>(
+            std::max<long long>(0, std::stoll(value)));
+      } catch (...) {
+        ai_trade::LogInfo("--walk_forward_folds 参数非法，已忽略: " + value);
+      }
+      continue;
+    }
+    if (arg.rfind("--max_parallel=", 0) == 0) {
+      const std::string value =
+          arg.substr(std::string("--max_parallel=").size());
+      try {
+        options.max_parallel = static_cast<std::size_t>(
+            std::max<long long>(0, std::stoll(value)));
+      } catch (...) {
+        ai_trade::LogInfo("--max_parallel 参数非法，已忽略: " + value);
+      }
+      continue;
+    }
+    if (arg == "--help" || arg == "-h") {
+      options.show_usage = true;
+      continue;
+    }
+    ai_trade::LogInfo("未识别的参数已忽略: " + arg);
+  }
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const ReplayOptions options = ParseOptions(argc, argv);
+  if (options.show_usage || options.symbol_bars.empty()) {
+    PrintUsage();
+    return options.show_usage ? 0 : 1;
+  }
+
+  // 回放与实盘共享同一份配置；未显式指定且默认文件缺失时退回编译默认值。
+  ai_trade::AppConfig config;
+  std::string error;
+  if (!ai_trade::LoadAppConfigFromYaml(options.config_path, &config, &error)) {
+    if (options.config_path_explicit) {
+      ai_trade::LogError("回放配置加载失败: " + error);
+      return 1;
+    }
+    ai_trade::LogInfo("默认配置不可用，使用编译默认值回放: " + error);
+    config = ai_trade::AppConfig{};
+  }
+
+  if (options.walk_forward_folds > 0) {
+    ai_trade::WalkForwardRunner runner(config);
+    for (const auto& [symbol, bar_path] : options.symbol_bars) {
+      if (!runner.AddSymbolBars(symbol, bar_path, options.default_interval_ms,
+                                &error)) {
+        ai_trade::LogError("回放 K 线挂载失败: " + error);
+        return 1;
+      }
+    }
+    ai_trade::WalkForwardReport report;
+    if (!runner.Run(options.walk_forward_folds, options.max_parallel, &report,
+                    &error)) {
+      ai_trade::LogError("walk-forward 执行失败: " + error);
+      return 1;
+    }
+    for (const auto& fold : report.folds) {
+      ai_trade::LogInfo(ai_trade::WalkForwardFoldLine(fold));
+    }
+    ai_trade::LogInfo(ai_trade::WalkForwardSummaryLine(report));
+    ai_trade::LogFlush();
+    return 0;
+  }
+
+  ai_trade::ReplayEngine engine(config);
+  for (const auto& [symbol, bar_path] : options.symbol_bars) {
+    if (!engine.AddSymbolBars(symbol, bar_path, options.default_interval_ms,
+                              &error)) {
+      ai_trade::LogError("回放 K 线挂载失败: " + error);
+      return 1;
+    }
+  }
+
+  ai_trade::ReplayStats stats;
+  if (!engine.Run(&stats, &error)) {
+    ai_trade::LogError("回放执行失败: " + error);
+    return 1;
+  }
+  ai_trade::LogInfo(engine.SummaryLine());
+  const std::string latency_summary = engine.system().EvaluateLatencySummary();
+  if (!latency_summary.empty()) {
+    ai_trade::LogInfo(latency_summary);
+  }
+  ai_trade::LogFlush();
+  return 0;
+}
@@ -0,0 +1,223 @@
+#include "research/bar_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace ai_trade::research {
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'T', 'C', 'B', 'A', 'R', '1', '\0'};
+constexpr std::size_t kHeaderBytes = 16;
+constexpr std::size_t kColumnCount = 6;  // ts + OHLCV
+
+std::size_t ExpectedFileBytes(std::size_t count) {
+  return kHeaderBytes + kColumnCount * count * sizeof(double);
+}
+
+}  // namespace
+
+ColumnarBarStore::~ColumnarBarStore() {
+  Close();
+}
+
+ColumnarBarStore::ColumnarBarStore(ColumnarBarStore&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      mapped_size_(std::exchange(other.mapped_size_, 0)),
+      count_(std::exchange(other.count_, 0)) {}
+
+ColumnarBarStore& ColumnarBarStore::operator=(
+    ColumnarBarStore&& other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    mapped_size_ = std::exchange(other.mapped_size_, 0);
+    count_ = std::exchange(other.count_, 0);
+  }
+  return *this;
+}
+
+bool ColumnarBarStore::Open(const std::string& file_path,
+                            std::string* out_error) {
+  Close();
+
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开列式数据文件: " + file_path;
+    }
+    return false;
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      st.st_size < static_cast<off_t>(kHeaderBytes)) {
+    ::close(fd);
+    if (out_error != nullptr) {
+      *out_error = "列式数据文件过小或不可读: " + file_path;
+    }
+    return false;
+  }
+  const std::size_t file_size = static_cast<std::size_t>(st.st_size);
+
+  void* mapped = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // 映射建立后文件描述符即可关闭，映射仍然有效。
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    if (out_error != nullptr) {
+      *out_error = "mmap 列式数据文件失败: " + file_path;
+    }
+    return false;
+  }
+
+  const unsigned char* bytes = static_cast<const unsigned char*>(mapped);
+  if (std::memcmp(bytes, kMagic, sizeof(kMagic)) != 0) {
+    ::munmap(mapped, file_size);
+    if (out_error != nullptr) {
+      *out_error = "列式数据文件魔数不匹配（非 ATCBAR1 格式）: " + file_path;
+    }
+    return false;
+  }
+  std::uint64_t count = 0;
+  std::memcpy(&count, bytes + sizeof(kMagic), sizeof(count));
+  if (file_size != ExpectedFileBytes(static_cast<std::size_t>(count))) {
+    ::munmap(mapped, file_size);
+    if (out_error != nullptr) {
+      *out_error = "列式数据文件长度与样本数不一致: " + file_path;
+    }
+    return false;
+  }
+
+  data_ = mapped;
+  mapped_size_ = file_size;
+  count_ = static_cast<std::size_t>(count);
+  return true;
+}
+
+void ColumnarBarStore::Close() {
+  if (data_ != nullptr) {
+    ::munmap(data_, mapped_size_);
+    data_ = nullptr;
+    mapped_size_ = 0;
+    count_ = 0;
+  }
+}
+
+const double* ColumnarBarStore::Column(std::size_t index) const {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data_);
+  return reinterpret_cast<const double*>(bytes + kHeaderBytes +
+                                         index * count_ * sizeof(double));
+}
+
+std::span<const std::int64_t> ColumnarBarStore::Timestamps() const {
+  if (!IsOpen()) {
+    return {};
+  }
+  return {reinterpret_cast<const std::int64_t*>(Column(0)), count_};
+}
+
+std::span<const double> ColumnarBarStore::Opens() const {
+  return IsOpen() ? std::span<const double>{Column(1), count_}
+                  : std::span<const double>{};
+}
+
+std::span<const double> ColumnarBarStore::Highs() const {
+  return IsOpen() ? std::span<const double>{Column(2), count_}
+                  : std::span<const double>{};
+}
+
+std::span<const double> ColumnarBarStore::Lows() const {
+  return IsOpen() ? std::span<const double>{Column(3), count_}
+                  : std::span<const double>{};
+}
+
+std::span<const double> ColumnarBarStore::Closes() const {
+  return IsOpen() ? std::span<const double>{Column(4), count_}
+                  : std::span<const double>{};
+}
+
+std::span<const double> ColumnarBarStore::Volumes() const {
+  return IsOpen() ? std::span<const double>{Column(5), count_}
+                  : std::span<const double>{};
+}
+
+bool SaveResearchBarsColumnar(const std::vector<ResearchBar>& bars,
+                              const std::string& file_path,
+                              std::string* out_error) {
+  std::error_code ec;
+  const std::filesystem::path path(file_path);
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) {
+      if (out_error != nullptr) {
+        *out_error = "创建目录失败: " + ec.message();
+      }
+      return false;
+    }
+  }
+
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法写入列式数据文件: " + file_path;
+    }
+    return false;
+  }
+
+  const std::uint64_t count = bars.size();
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  // 行式样本转置为列后整列写出，读端才能得到连续内存。
+  std::vector<std::int64_t> ts_column;
+  std::vector<double> column;
+  ts_column.reserve(bars.size());
+  column.reserve(bars.size());
+  for (const ResearchBar& bar : bars) {
+    ts_column.push_back(bar.ts_ms);
+  }
+  out.write(reinterpret_cast<const char*>(ts_column.data()),
+            static_cast<std::streamsize>(ts_column.size() * sizeof(std::int64_t)));
+
+  const auto write_column = [&](double ResearchBar::* field) {
+    column.clear();
+    for (const ResearchBar& bar : bars) {
+      column.push_back(bar.*field);
+    }
+    out.write(reinterpret_cast<const char*>(column.data()),
+              static_cast<std::streamsize>(column.size() * sizeof(double)));
+  };
+  write_column(&ResearchBar::open);
+  write_column(&ResearchBar::high);
+  write_column(&ResearchBar::low);
+  write_column(&ResearchBar::close);
+  write_column(&ResearchBar::volume);
+
+  out.flush();
+  if (!out.good()) {
+    if (out_error != nullptr) {
+      *out_error = "列式数据文件写入失败: " + file_path;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool ConvertResearchCsvToColumnar(const std::string& csv_path,
+                                  const std::string& out_path,
+                                  std::string* out_error) {
+  std::vector<ResearchBar> bars;
+  if (!LoadResearchBarsFromCsv(csv_path, &bars, out_error)) {
+    return false;
+  }
+  return SaveResearchBarsColumnar(bars, out_path, out_error);
+}
+
+}  // namespace ai_trade::research
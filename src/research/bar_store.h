@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "research/miner.h"
+
+namespace ai_trade::research {
+
+/**
+ * @brief 研究样本的二进制列式存储（内存映射只读）
+ *
+ * 设计动机：CSV 文本解析在多年数据集上比一次 Miner 代际还慢，且
+ * `std::vector<ResearchBar>`（行式）对按列扫描的时序算子不友好。
+ * 列式文件由转换器一次性产出，研究进程 mmap 只读打开即得到每个
+ * OHLCV 字段的连续 double 列，零解析、零拷贝、页按需换入。
+ *
+ * 文件格式 v1（小端，8 字节对齐）：
+ *   [0,8)   magic "ATCBAR1\0"
+ *   [8,16)  样本数 count（uint64）
+ *   之后依次为 ts_ms(int64)、open/high/low/close/volume(double) 六列，
+ *   每列 count 个元素连续存放。
+ */
+class ColumnarBarStore {
+ public:
+  ColumnarBarStore() = default;
+  ~ColumnarBarStore();
+
+  ColumnarBarStore(const ColumnarBarStore&) = delete;
+  ColumnarBarStore& operator=(const ColumnarBarStore&) = delete;
+  ColumnarBarStore(ColumnarBarStore&& other) noexcept;
+  ColumnarBarStore& operator=(ColumnarBarStore&& other) noexcept;
+
+  /// 只读映射列式文件；失败时返回 false 并写出中文错误信息。
+  bool Open(const std::string& file_path, std::string* out_error);
+  /// 解除映射；析构时自动调用，可安全重复调用。
+  void Close();
+
+  bool IsOpen() const { return data_ != nullptr; }
+  std::size_t Count() const { return count_; }
+
+  std::span<const std::int64_t> Timestamps() const;
+  std::span<const double> Opens() const;
+  std::span<const double> Highs() const;
+  std::span<const double> Lows() const;
+  std::span<const double> Closes() const;
+  std::span<const double> Volumes() const;
+
+ private:
+  const double* Column(std::size_t index) const;
+
+  void* data_{nullptr};
+  std::size_t mapped_size_{0};
+  std::size_t count_{0};
+};
+
+/// 将研究样本落盘为列式文件（转换器写端，覆盖已有文件）。
+bool SaveResearchBarsColumnar(const std::vector<ResearchBar>& bars,
+                              const std::string& file_path,
+                              std::string* out_error);
+
+/// 一次性转换：CSV（LoadResearchBarsFromCsv 同款格式）→ 列式文件。
+bool ConvertResearchCsvToColumnar(const std::string& csv_path,
+                                  const std::string& out_path,
+                                  std::string* out_error);
+
+}  // namespace ai_trade::research
@@ -0,0 +1,521 @@
+#include "research/feature_store_builder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include "research/time_series_operators.h"
+
+namespace ai_trade::research {
+
+namespace {
+
+constexpr char kFeatureMagic[8] = {'A', 'T', 'C', 'F', 'E', 'A', 'T', '1'};
+constexpr double kDivideEpsilon = 1e-12;
+
+double NaN() {
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+// 与 tools/build_feature_store.py 的 safe_divide 口径一致：任一输入
+// 非有限或分母接近 0 时输出 NaN。
+double SafeDivide(double numerator, double denominator) {
+  if (!IsFinite(numerator) || !IsFinite(denominator) ||
+      std::fabs(denominator) <= kDivideEpsilon) {
+    return NaN();
+  }
+  return numerator / denominator;
+}
+
+double Sign(double value) {
+  if (!IsFinite(value)) {
+    return NaN();
+  }
+  if (value > 0.0) {
+    return 1.0;
+  }
+  if (value < 0.0) {
+    return -1.0;
+  }
+  return 0.0;
+}
+
+/// d 步历史收益率：x[t]/x[t-d] - 1，前 d 个位置 NaN。
+std::vector<double> ShiftReturn(std::span<const double> series, int bars) {
+  std::vector<double> out(series.size(), NaN());
+  if (bars <= 0 || series.size() <= static_cast<std::size_t>(bars)) {
+    return out;
+  }
+  const std::size_t d = static_cast<std::size_t>(bars);
+  for (std::size_t i = d; i < series.size(); ++i) {
+    out[i] = SafeDivide(series[i], series[i - d]);
+    if (IsFinite(out[i])) {
+      out[i] -= 1.0;
+    }
+  }
+  return out;
+}
+
+/// d 步前向收益率标签：x[t+d]/x[t] - 1，尾部 d 个位置 NaN。
+std::vector<double> ForwardReturn(std::span<const double> series, int bars) {
+  std::vector<double> out(series.size(), NaN());
+  if (bars <= 0 || series.size() <= static_cast<std::size_t>(bars)) {
+    return out;
+  }
+  const std::size_t d = static_cast<std::size_t>(bars);
+  for (std::size_t i = 0; i + d < series.size(); ++i) {
+    out[i] = SafeDivide(series[i + d], series[i]);
+    if (IsFinite(out[i])) {
+      out[i] -= 1.0;
+    }
+  }
+  return out;
+}
+
+/// 滚动均值：TsSum / w（窗口含无效值时 TsSum 已输出 NaN）。
+std::vector<double> RollingMean(std::span<const double> series, int window) {
+  std::vector<double> out = TsSum(series, window);
+  const double w = static_cast<double>(window);
+  for (double& value : out) {
+    if (IsFinite(value)) {
+      value /= w;
+    }
+  }
+  return out;
+}
+
+/// 列任务并行执行：原子游标分发，与 Miner 的种群并行评估同一模式。
+/// 任务之间互不写同一列，无需同步。
+void RunColumnTasks(const std::vector<std::function<void()>>& tasks,
+                    int worker_count) {
+  const std::size_t count = tasks.size();
+  if (count == 0) {
+    return;
+  }
+  std::size_t workers =
+      worker_count > 0
+          ? static_cast<std::size_t>(worker_count)
+          : static_cast<std::size_t>(
+                std::max(1U, std::thread::hardware_concurrency()));
+  workers = std::min(workers, count);
+  if (workers <= 1) {
+    for (const auto& task : tasks) {
+      task();
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (std::size_t t = 0; t < workers; ++t) {
+    threads.emplace_back([&next, count, &tasks]() {
+      while (true) {
+        const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) {
+          break;
+        }
+        tasks[index]();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+bool BuildFromSpans(std::span<const std::int64_t> timestamps,
+                    std::span<const double> open,
+                    std::span<const double> high,
+                    std::span<const double> low,
+                    std::span<const double> close,
+                    std::span<const double> volume,
+                    const FeatureBuildOptions& options,
+                    FeatureMatrix* out_matrix,
+                    std::string* out_error) {
+  if (out_matrix == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "特征矩阵输出指针为空";
+    }
+    return false;
+  }
+  const std::size_t count = timestamps.size();
+  if (count == 0) {
+    if (out_error != nullptr) {
+      *out_error = "特征构建输入样本为空";
+    }
+    return false;
+  }
+  const int forward_bars = std::max(1, options.forward_bars);
+
+  // ret_1 是多数波动/量能列的共同输入，先串行算出（O(n) 一趟），
+  // 其余列按任务并行：每个任务只写自己的输出列。
+  const std::vector<double> ret_1 = ShiftReturn(close, 1);
+
+  std::vector<double> ret_3;
+  std::vector<double> ret_12;
+  std::vector<double> ret_24;
+  std::vector<double> ret_36;
+  std::vector<double> ret_72;
+  std::vector<double> mom_48;
+  std::vector<double> mom_96;
+  std::vector<double> ema_fast;
+  std::vector<double> ema_slow;
+  std::vector<double> ema_slow_96;
+  std::vector<double> vol_12;
+  std::vector<double> vol_48;
+  std::vector<double> vol_96;
+  std::vector<double> mean_48;
+  std::vector<double> std_48;
+  std::vector<double> mean_96;
+  std::vector<double> std_96;
+  std::vector<double> volume_mean_12;
+  std::vector<double> volume_mean_48;
+  std::vector<double> volume_std_48;
+  std::vector<double> vol_chg_12;
+  std::vector<double> forward_ret;
+  std::vector<double> range_pct(count, NaN());
+  std::vector<double> body_pct(count, NaN());
+  std::vector<double> upper_wick_pct(count, NaN());
+  std::vector<double> lower_wick_pct(count, NaN());
+  std::vector<double> close_pos_in_range(count, NaN());
+
+  std::vector<std::function<void()>> base_tasks;
+  base_tasks.emplace_back([&]() { ret_3 = ShiftReturn(close, 3); });
+  base_tasks.emplace_back([&]() { ret_12 = ShiftReturn(close, 12); });
+  base_tasks.emplace_back([&]() { ret_24 = ShiftReturn(close, 24); });
+  base_tasks.emplace_back([&]() { ret_36 = ShiftReturn(close, 36); });
+  base_tasks.emplace_back([&]() { ret_72 = ShiftReturn(close, 72); });
+  base_tasks.emplace_back([&]() { mom_48 = ShiftReturn(close, 48); });
+  base_tasks.emplace_back([&]() { mom_96 = ShiftReturn(close, 96); });
+  base_tasks.emplace_back([&]() { ema_fast = TsEma(close, 12); });
+  base_tasks.emplace_back([&]() { ema_slow = TsEma(close, 48); });
+  base_tasks.emplace_back([&]() { ema_slow_96 = TsEma(close, 96); });
+  base_tasks.emplace_back([&]() { vol_12 = TsStd(ret_1, 12); });
+  base_tasks.emplace_back([&]() { vol_48 = TsStd(ret_1, 48); });
+  base_tasks.emplace_back([&]() { vol_96 = TsStd(ret_1, 96); });
+  base_tasks.emplace_back([&]() { mean_48 = RollingMean(close, 48); });
+  base_tasks.emplace_back([&]() { std_48 = TsStd(close, 48); });
+  base_tasks.emplace_back([&]() { mean_96 = RollingMean(close, 96); });
+  base_tasks.emplace_back([&]() { std_96 = TsStd(close, 96); });
+  base_tasks.emplace_back([&]() { volume_mean_12 = RollingMean(volume, 12); });
+  base_tasks.emplace_back([&]() { volume_mean_48 = RollingMean(volume, 48); });
+  base_tasks.emplace_back([&]() { volume_std_48 = TsStd(volume, 48); });
+  base_tasks.emplace_back([&]() { vol_chg_12 = ShiftReturn(volume, 12); });
+  base_tasks.emplace_back(
+      [&]() { forward_ret = ForwardReturn(close, forward_bars); });
+  base_tasks.emplace_back([&]() {
+    for (std::size_t i = 0; i < count; ++i) {
+      const double range_raw = high[i] - low[i];
+      range_pct[i] = SafeDivide(range_raw, close[i]);
+      body_pct[i] = SafeDivide(close[i] - open[i], close[i]);
+      upper_wick_pct[i] =
+          SafeDivide(high[i] - std::max(open[i], close[i]), close[i]);
+      lower_wick_pct[i] =
+          SafeDivide(std::min(open[i], close[i]) - low[i], close[i]);
+      close_pos_in_range[i] = SafeDivide(close[i] - low[i], range_raw);
+    }
+  });
+  RunColumnTasks(base_tasks, options.threads);
+
+  // 组合列全部是逐元素 O(n) 运算，依赖上面的基础列，串行即可。
+  // NaN 经普通算术自然传播，与 numpy 版本口径一致。
+  std::vector<double> ema_diff(count, NaN());
+  std::vector<double> ema_diff_96(count, NaN());
+  std::vector<double> zscore_48(count, NaN());
+  std::vector<double> zscore_96(count, NaN());
+  std::vector<double> ret_3_minus_ret_12(count, NaN());
+  std::vector<double> ret_12_minus_ret_48(count, NaN());
+  std::vector<double> vol_ratio_12_48(count, NaN());
+  std::vector<double> vol_ratio_48_96(count, NaN());
+  std::vector<double> volume_zscore_48(count, NaN());
+  std::vector<double> volume_ratio_12_48(count, NaN());
+  std::vector<double> signed_volume_pressure(count, NaN());
+  for (std::size_t i = 0; i < count; ++i) {
+    ema_diff[i] = SafeDivide(ema_fast[i] - ema_slow[i], close[i]);
+    ema_diff_96[i] = SafeDivide(ema_slow[i] - ema_slow_96[i], close[i]);
+    zscore_48[i] = SafeDivide(close[i] - mean_48[i], std_48[i]);
+    zscore_96[i] = SafeDivide(close[i] - mean_96[i], std_96[i]);
+    ret_3_minus_ret_12[i] = ret_3[i] - ret_12[i];
+    ret_12_minus_ret_48[i] = ret_12[i] - mom_48[i];
+    const double ratio_12_48 = SafeDivide(vol_12[i], vol_48[i]);
+    vol_ratio_12_48[i] = IsFinite(ratio_12_48) ? ratio_12_48 - 1.0 : NaN();
+    const double ratio_48_96 = SafeDivide(vol_48[i], vol_96[i]);
+    vol_ratio_48_96[i] = IsFinite(ratio_48_96) ? ratio_48_96 - 1.0 : NaN();
+    volume_zscore_48[i] =
+        SafeDivide(volume[i] - volume_mean_48[i], volume_std_48[i]);
+    const double volume_ratio =
+        SafeDivide(volume_mean_12[i], volume_mean_48[i]);
+    volume_ratio_12_48[i] =
+        IsFinite(volume_ratio) ? volume_ratio - 1.0 : NaN();
+    signed_volume_pressure[i] = Sign(ret_1[i]) * volume_zscore_48[i];
+  }
+
+  FeatureMatrix matrix;
+  matrix.timestamps.assign(timestamps.begin(), timestamps.end());
+  const auto add_column = [&matrix](const char* name,
+                                    std::vector<double> values) {
+    matrix.column_names.emplace_back(name);
+    matrix.columns.push_back(std::move(values));
+  };
+  matrix.column_names.emplace_back("timestamp");
+  add_column("close", std::vector<double>(close.begin(), close.end()));
+  add_column("volume", std::vector<double>(volume.begin(), volume.end()));
+  add_column("ret_1", ret_1);
+  add_column("ret_3", std::move(ret_3));
+  add_column("ret_12", ret_12);
+  add_column("ret_24", std::move(ret_24));
+  add_column("ret_36", std::move(ret_36));
+  add_column("ret_72", std::move(ret_72));
+  add_column("ema_fast", std::move(ema_fast));
+  add_column("ema_slow", std::move(ema_slow));
+  add_column("ema_slow_96", std::move(ema_slow_96));
+  add_column("ema_diff", std::move(ema_diff));
+  add_column("ema_diff_96", std::move(ema_diff_96));
+  add_column("vol_12", std::move(vol_12));
+  add_column("vol_48", std::move(vol_48));
+  add_column("vol_96", std::move(vol_96));
+  add_column("zscore_48", std::move(zscore_48));
+  add_column("zscore_96", std::move(zscore_96));
+  // mom_12 与 ret_12 定义相同（与 Python 版列集合保持一致），复制一份。
+  add_column("mom_12", ret_12);
+  add_column("mom_48", std::move(mom_48));
+  add_column("mom_96", std::move(mom_96));
+  add_column("ret_3_minus_ret_12", std::move(ret_3_minus_ret_12));
+  add_column("ret_12_minus_ret_48", std::move(ret_12_minus_ret_48));
+  add_column("vol_ratio_12_48", std::move(vol_ratio_12_48));
+  add_column("vol_ratio_48_96", std::move(vol_ratio_48_96));
+  add_column("range_pct", std::move(range_pct));
+  add_column("body_pct", std::move(body_pct));
+  add_column("upper_wick_pct", std::move(upper_wick_pct));
+  add_column("lower_wick_pct", std::move(lower_wick_pct));
+  add_column("close_pos_in_range", std::move(close_pos_in_range));
+  add_column("vol_chg_12", std::move(vol_chg_12));
+  add_column("volume_zscore_48", std::move(volume_zscore_48));
+  add_column("volume_ratio_12_48", std::move(volume_ratio_12_48));
+  add_column("signed_volume_pressure", std::move(signed_volume_pressure));
+  add_column("forward_return", std::move(forward_ret));
+
+  *out_matrix = std::move(matrix);
+  return true;
+}
+
+}  // namespace
+
+bool BuildFeatureMatrix(const ColumnarBarStore& store,
+                        const FeatureBuildOptions& options,
+                        FeatureMatrix* out_matrix,
+                        std::string* out_error) {
+  if (!store.IsOpen()) {
+    if (out_error != nullptr) {
+      *out_error = "列式数据文件未打开";
+    }
+    return false;
+  }
+  return BuildFromSpans(store.Timestamps(), store.Opens(), store.Highs(),
+                        store.Lows(), store.Closes(), store.Volumes(), options,
+                        out_matrix, out_error);
+}
+
+bool BuildFeatureMatrix(const std::vector<ResearchBar>& bars,
+                        const FeatureBuildOptions& options,
+                        FeatureMatrix* out_matrix,
+                        std::string* out_error) {
+  std::vector<std::int64_t> timestamps;
+  std::vector<double> open;
+  std::vector<double> high;
+  std::vector<double> low;
+  std::vector<double> close;
+  std::vector<double> volume;
+  timestamps.reserve(bars.size());
+  open.reserve(bars.size());
+  high.reserve(bars.size());
+  low.reserve(bars.size());
+  close.reserve(bars.size());
+  volume.reserve(bars.size());
+  for (const ResearchBar& bar : bars) {
+    timestamps.push_back(bar.ts_ms);
+    open.push_back(bar.open);
+    high.push_back(bar.high);
+    low.push_back(bar.low);
+    close.push_back(bar.close);
+    volume.push_back(bar.volume);
+  }
+  return BuildFromSpans(timestamps, open, high, low, close, volume, options,
+                        out_matrix, out_error);
+}
+
+bool WriteFeatureMatrixCsv(const FeatureMatrix& matrix,
+                           const std::string& file_path,
+                           bool drop_na,
+                           std::size_t* out_rows_kept,
+                           std::string* out_error) {
+  std::ofstream out(file_path, std::ios::trunc);
+  if (!out.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法写入特征 CSV 文件: " + file_path;
+    }
+    return false;
+  }
+
+  for (std::size_t i = 0; i < matrix.column_names.size(); ++i) {
+    if (i > 0) {
+      out << ',';
+    }
+    out << matrix.column_names[i];
+  }
+  out << '\n';
+
+  char buffer[64];
+  std::size_t kept = 0;
+  for (std::size_t row = 0; row < matrix.RowCount(); ++row) {
+    bool valid = true;
+    for (const auto& column : matrix.columns) {
+      if (!IsFinite(column[row])) {
+        valid = false;
+        break;
+      }
+    }
+    if (drop_na && !valid) {
+      continue;
+    }
+    out << matrix.timestamps[row];
+    for (const auto& column : matrix.columns) {
+      std::snprintf(buffer, sizeof(buffer), ",%.10f", column[row]);
+      out << buffer;
+    }
+    out << '\n';
+    ++kept;
+  }
+  out.flush();
+  if (!out.good()) {
+    if (out_error != nullptr) {
+      *out_error = "写入特征 CSV 文件失败: " + file_path;
+    }
+    return false;
+  }
+  if (out_rows_kept != nullptr) {
+    *out_rows_kept = kept;
+  }
+  return true;
+}
+
+bool WriteFeatureMatrixBinary(const FeatureMatrix& matrix,
+                              const std::string& file_path,
+                              std::string* out_error) {
+  if (matrix.column_names.size() != matrix.columns.size() + 1) {
+    if (out_error != nullptr) {
+      *out_error = "特征矩阵列名与列数据不一致";
+    }
+    return false;
+  }
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法写入特征二进制文件: " + file_path;
+    }
+    return false;
+  }
+
+  const std::uint64_t count = matrix.RowCount();
+  const std::uint64_t column_count = matrix.column_names.size();
+  out.write(kFeatureMagic, sizeof(kFeatureMagic));
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char*>(&column_count),
+            sizeof(column_count));
+  for (const std::string& name : matrix.column_names) {
+    const std::uint32_t length = static_cast<std::uint32_t>(name.size());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  }
+  out.write(reinterpret_cast<const char*>(matrix.timestamps.data()),
+            static_cast<std::streamsize>(count * sizeof(std::int64_t)));
+  for (const auto& column : matrix.columns) {
+    out.write(reinterpret_cast<const char*>(column.data()),
+              static_cast<std::streamsize>(count * sizeof(double)));
+  }
+  out.flush();
+  if (!out.good()) {
+    if (out_error != nullptr) {
+      *out_error = "写入特征二进制文件失败: " + file_path;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool LoadFeatureMatrixBinary(const std::string& file_path,
+                             FeatureMatrix* out_matrix,
+                             std::string* out_error) {
+  if (out_matrix == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "特征矩阵输出指针为空";
+    }
+    return false;
+  }
+  std::ifstream in(file_path, std::ios::binary);
+  if (!in.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开特征二进制文件: " + file_path;
+    }
+    return false;
+  }
+
+  char magic[sizeof(kFeatureMagic)] = {};
+  std::uint64_t count = 0;
+  std::uint64_t column_count = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(&count), sizeof(count));
+  in.read(reinterpret_cast<char*>(&column_count), sizeof(column_count));
+  if (!in.good() ||
+      std::memcmp(magic, kFeatureMagic, sizeof(kFeatureMagic)) != 0 ||
+      column_count < 1) {
+    if (out_error != nullptr) {
+      *out_error = "特征二进制文件头部非法: " + file_path;
+    }
+    return false;
+  }
+
+  FeatureMatrix matrix;
+  matrix.column_names.reserve(column_count);
+  for (std::uint64_t i = 0; i < column_count; ++i) {
+    std::uint32_t length = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    std::string name(length, '\0');
+    in.read(name.data(), static_cast<std::streamsize>(length));
+    if (!in.good()) {
+      if (out_error != nullptr) {
+        *out_error = "特征二进制文件列名损坏: " + file_path;
+      }
+      return false;
+    }
+    matrix.column_names.push_back(std::move(name));
+  }
+  matrix.timestamps.resize(count);
+  in.read(reinterpret_cast<char*>(matrix.timestamps.data()),
+          static_cast<std::streamsize>(count * sizeof(std::int64_t)));
+  matrix.columns.resize(column_count - 1);
+  for (auto& column : matrix.columns) {
+    column.resize(count);
+    in.read(reinterpret_cast<char*>(column.data()),
+            static_cast<std::streamsize>(count * sizeof(double)));
+  }
+  if (!in.good()) {
+    if (out_error != nullptr) {
+      *out_error = "特征二进制文件数据不完整: " + file_path;
+    }
+    return false;
+  }
+  *out_matrix = std::move(matrix);
+  return true;
+}
+
+}  // namespace ai_trade::research
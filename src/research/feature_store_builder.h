@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "research/bar_store.h"
+
+namespace ai_trade::research {
+
+/**
+ * @brief 单 symbol 特征矩阵（列式存放）
+ *
+ * 列名与 tools/build_feature_store.py 产出的 CSV 列一一对应：
+ * 首列 timestamp 单独存放，其余列按 column_names 顺序对齐到
+ * columns（columns[i] 对应 column_names[i + 1]）。
+ */
+struct FeatureMatrix {
+  std::vector<std::string> column_names;  ///< 全部列名（含 timestamp）。
+  std::vector<std::int64_t> timestamps;   ///< timestamp 列（毫秒）。
+  std::vector<std::vector<double>> columns;  ///< 其余特征列。
+
+  std::size_t RowCount() const { return timestamps.size(); }
+};
+
+/// 特征构建参数。
+struct FeatureBuildOptions {
+  int forward_bars{12};  ///< 前向收益标签步长（<1 时按 1 处理）。
+  /// 列任务并行线程数；<=0 取硬件并发数。列之间互相独立，
+  /// 并行不改变任何列的数值。
+  int threads{0};
+};
+
+/**
+ * @brief 从列式 K 线存储构建特征矩阵
+ *
+ * 特征表达式以 time_series_operators 为唯一实现（与在线/Miner 同源），
+ * 列集合与 tools/build_feature_store.py 保持一致；mmap 列直接作为
+ * span 输入，零拷贝扫描。样本为空时返回 false。
+ */
+bool BuildFeatureMatrix(const ColumnarBarStore& store,
+                        const FeatureBuildOptions& options,
+                        FeatureMatrix* out_matrix,
+                        std::string* out_error);
+
+/// 行式样本重载：内部转列后走同一条构建路径。
+bool BuildFeatureMatrix(const std::vector<ResearchBar>& bars,
+                        const FeatureBuildOptions& options,
+                        FeatureMatrix* out_matrix,
+                        std::string* out_error);
+
+/**
+ * @brief 落盘为 CSV（与 tools/build_feature_store.py 输出同格式）
+ *
+ * 数值格式 %.10f；drop_na 为 true 时剔除含非有限值的行（即默认的
+ * drop-na 行为）。out_rows_kept 返回实际写出的行数（可为 nullptr）。
+ */
+bool WriteFeatureMatrixCsv(const FeatureMatrix& matrix,
+                           const std::string& file_path,
+                           bool drop_na,
+                           std::size_t* out_rows_kept,
+                           std::string* out_error);
+
+/**
+ * @brief 落盘为二进制列式特征文件（覆盖已有文件）
+ *
+ * 文件格式 v1（小端，与 ColumnarBarStore 同风格）：
+ *   [0,8)   magic "ATCFEAT1"
+ *   [8,16)  行数 count（uint64）
+ *   [16,24) 列数 column_count（uint64，含 timestamp）
+ *   之后为 column_count 个列名：uint32 长度 + UTF-8 字节；
+ *   再之后按列名顺序存放列数据：timestamp 列为 int64，
+ *   其余列为 double，每列 count 个元素连续存放。
+ *   下游（tools/integrator_train.py 等）解析头部后可用
+ *   numpy.fromfile 带 offset 直接按列读取，无需逐行解析。
+ */
+bool WriteFeatureMatrixBinary(const FeatureMatrix& matrix,
+                              const std::string& file_path,
+                              std::string* out_error);
+
+/// 读取二进制列式特征文件（校验 magic 与尺寸一致性）。
+bool LoadFeatureMatrixBinary(const std::string& file_path,
+                             FeatureMatrix* out_matrix,
+                             std::string* out_error);
+
+}  // namespace ai_trade::research
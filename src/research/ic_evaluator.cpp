@@ -151,20 +151,80 @@ std::vector<double> ComputeRollingSpearmanIC(
     return out;
   }
 
+  // 增量滑窗实现：窗口内"双向有限"的样本对在两份有序数组中各自维护，
+  // 每步滑动只做二分插入/删除；平均秩直接由 lower/upper_bound 位置读出
+  // （等值区间 [lb, ub) 的平均秩 = (lb + 1 + ub) / 2），无需逐窗口整排。
+  // 相比旧版逐位置调用 ComputeSpearmanIC（切片拷贝 + 两次全排序），
+  // 每步成本从 O(w log w) 排序降为 O(w) 次二分读秩且零分配。
+  // ComputeSpearmanIC 保留为正确性基准，单测对两者做交叉校验。
+  std::vector<double> sorted_f;
+  std::vector<double> sorted_r;
+  sorted_f.reserve(w);
+  sorted_r.reserve(w);
+  std::vector<double> rank_f;
+  std::vector<double> rank_r;
+  rank_f.reserve(w);
+  rank_r.reserve(w);
+
+  const auto pair_valid = [&](std::size_t i) {
+    return IsFinite(factor_values[i]) && IsFinite(future_returns[i]);
+  };
+  const auto sorted_insert = [](std::vector<double>* sorted, double value) {
+    sorted->insert(std::lower_bound(sorted->begin(), sorted->end(), value),
+                   value);
+  };
+  const auto sorted_erase = [](std::vector<double>* sorted, double value) {
+    sorted->erase(std::lower_bound(sorted->begin(), sorted->end(), value));
+  };
+  // 等值平均秩：排序数组中 [lb, ub) 为与 value 相等的区间（1-based 平均）。
+  const auto average_rank = [](const std::vector<double>& sorted,
+                               double value) {
+    const auto lower = std::lower_bound(sorted.begin(), sorted.end(), value);
+    const auto upper = std::upper_bound(lower, sorted.end(), value);
+    const double lb = static_cast<double>(lower - sorted.begin());
+    const double ub = static_cast<double>(upper - sorted.begin());
+    return 0.5 * (lb + 1.0 + ub);
+  };
+
+  // 初始窗口 [0, w)
+  for (std::size_t i = 0; i < w; ++i) {
+    if (!pair_valid(i)) {
+      continue;
+    }
+    sorted_insert(&sorted_f, factor_values[i]);
+    sorted_insert(&sorted_r, future_returns[i]);
+  }
+
   for (std::size_t end = w - 1; end < factor_values.size(); ++end) {
+    if (end > w - 1) {
+      const std::size_t leaving = end - w;
+      if (pair_valid(leaving)) {
+        sorted_erase(&sorted_f, factor_values[leaving]);
+        sorted_erase(&sorted_r, future_returns[leaving]);
+      }
+      if (pair_valid(end)) {
+        sorted_insert(&sorted_f, factor_values[end]);
+        sorted_insert(&sorted_r, future_returns[end]);
+      }
+    }
+    if (sorted_f.size() < 3) {
+      continue;
+    }
+
+    // 读出窗口内每个有效样本对的平均秩，再对秩做 Pearson（与基准一致）。
+    rank_f.clear();
+    rank_r.clear();
     const std::size_t begin = end + 1 - w;
-    std::vector<double> f_slice;
-    std::vector<double> r_slice;
-    f_slice.reserve(w);
-    r_slice.reserve(w);
     for (std::size_t i = begin; i <= end; ++i) {
-      f_slice.push_back(factor_values[i]);
-      r_slice.push_back(future_returns[i]);
-    }
-    const SpearmanIcResult ic = ComputeSpearmanIC(f_slice, r_slice);
-    if (ic.sample_count >= 3) {
-      out[end] = ic.ic;
+      if (!pair_valid(i)) {
+        continue;
+      }
+      rank_f.push_back(average_rank(sorted_f, factor_values[i]));
+      rank_r.push_back(average_rank(sorted_r, future_returns[i]));
     }
+    // 与基准语义一致：有效样本足够时必有输出，秩退化（全并列）记 0。
+    const double corr = PearsonCorrelation(rank_f, rank_r);
+    out[end] = IsFinite(corr) ? corr : 0.0;
   }
   return out;
 }
@@ -1,6 +1,7 @@
 #include "research/miner.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cmath>
 #include <cstdint>
@@ -10,13 +11,16 @@
 #include <iomanip>
 #include <limits>
 #include <random>
+#include <span>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "research/bar_store.h"
 #include "research/ic_evaluator.h"
 #include "research/time_series_operators.h"
 
@@ -146,7 +150,7 @@ std::vector<double> ElementWiseAbs(const std::vector<double>& values) {
   return out;
 }
 
-std::vector<double> BuildForwardReturns(const std::vector<double>& close) {
+std::vector<double> BuildForwardReturns(std::span<const double> close) {
   std::vector<double> out(close.size(), NaN());
   if (close.size() < 2) {
     return out;
@@ -157,6 +161,46 @@ std::vector<double> BuildForwardReturns(const std::vector<double>& close) {
   return out;
 }
 
+// 并行 for：原子游标做动态取任务（候选表达式的评估成本差异很大，
+// 静态分片会产生长尾），每个下标恰好执行一次、结果写入固定槽位，
+// 因此调度顺序不影响输出，可复现性与串行一致。
+void ParallelFor(std::size_t count,
+                 int worker_count,
+                 const std::function<void(std::size_t)>& fn) {
+  if (count == 0) {
+    return;
+  }
+  std::size_t workers = worker_count > 0
+                            ? static_cast<std::size_t>(worker_count)
+                            : static_cast<std::size_t>(
+                                  std::max(1U, std::thread::hardware_concurrency()));
+  workers = std::min(workers, count);
+  if (workers <= 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (std::size_t t = 0; t < workers; ++t) {
+    threads.emplace_back([&next, count, &fn]() {
+      while (true) {
+        const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) {
+          break;
+        }
+        fn(index);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
 std::uint64_t Fnv1a64(const std::string& text) {
   constexpr std::uint64_t kOffset = 1469598103934665603ULL;
   constexpr std::uint64_t kPrime = 1099511628211ULL;
@@ -261,12 +305,19 @@ bool AddCandidateDedup(const Candidate& candidate,
   return true;
 }
 
+// 跨代的公共子表达式结果缓存：交叉繁殖高度复用子树（同一组合在
+// 不同代反复出现），列向量按规范化表达式串缓存，命中即免去整列重算。
+// 生命周期限定在一次 Run 内，规模上界为 generations x population。
+using ExpressionColumnCache =
+    std::unordered_map<std::string, std::vector<double>>;
+
 std::vector<Candidate> BuildNextGeneration(
     const std::vector<Candidate>& all_candidates,
     const std::vector<CandidateEval>& evaluations,
     int elite_size,
     int population_size,
-    std::mt19937* rng) {
+    std::mt19937* rng,
+    ExpressionColumnCache* column_cache) {
   std::vector<Candidate> next;
   if (all_candidates.empty() || evaluations.empty() || rng == nullptr) {
     return next;
@@ -301,52 +352,77 @@ std::vector<Candidate> BuildNextGeneration(
     return next;
   }
 
+  // 繁殖某个子表达式前先查 visited（本代已有则连列计算都省掉），
+  // 再查跨代缓存；仅真正的新表达式才触发整列计算并回填缓存。
+  const auto breed_child =
+      [&](const std::string& expression,
+          double complexity,
+          const std::function<std::vector<double>()>& compute) {
+        if (visited.count(expression) > 0) {
+          return false;
+        }
+        Candidate child;
+        child.expression = expression;
+        child.complexity = complexity;
+        if (column_cache != nullptr) {
+          auto it = column_cache->find(expression);
+          if (it == column_cache->end()) {
+            it = column_cache->emplace(expression, compute()).first;
+          }
+          child.values = it->second;
+        } else {
+          child.values = compute();
+        }
+        return AddCandidateDedup(child, &visited, &next);
+      };
+
   std::uniform_int_distribution<int> pick_elite(
       0, static_cast<int>(elites.size() - 1));
   while (next.size() < safe_population) {
     const Candidate& a = *elites[static_cast<std::size_t>(pick_elite(*rng))];
     const Candidate& b = *elites[static_cast<std::size_t>(pick_elite(*rng))];
 
-    Candidate plus;
-    plus.expression = "(" + a.expression + ")+(" + b.expression + ")";
-    plus.values = ElementWiseBinary(a.values, b.values, [](double lhs, double rhs) {
-      if (!IsFinite(lhs) || !IsFinite(rhs)) {
-        return NaN();
-      }
-      return lhs + rhs;
-    });
-    plus.complexity = a.complexity + b.complexity + 1.0;
-    if (AddCandidateDedup(plus, &visited, &next) && next.size() >= safe_population) {
+    if (breed_child("(" + a.expression + ")+(" + b.expression + ")",
+                    a.complexity + b.complexity + 1.0,
+                    [&] {
+                      return ElementWiseBinary(
+                          a.values, b.values, [](double lhs, double rhs) {
+                            if (!IsFinite(lhs) || !IsFinite(rhs)) {
+                              return NaN();
+                            }
+                            return lhs + rhs;
+                          });
+                    }) &&
+        next.size() >= safe_population) {
       break;
     }
 
-    Candidate minus;
-    minus.expression = "(" + a.expression + ")-(" + b.expression + ")";
-    minus.values = ElementWiseBinary(a.values, b.values, [](double lhs, double rhs) {
-      if (!IsFinite(lhs) || !IsFinite(rhs)) {
-        return NaN();
-      }
-      return lhs - rhs;
-    });
-    minus.complexity = a.complexity + b.complexity + 1.0;
-    if (AddCandidateDedup(minus, &visited, &next) && next.size() >= safe_population) {
+    if (breed_child("(" + a.expression + ")-(" + b.expression + ")",
+                    a.complexity + b.complexity + 1.0,
+                    [&] {
+                      return ElementWiseBinary(
+                          a.values, b.values, [](double lhs, double rhs) {
+                            if (!IsFinite(lhs) || !IsFinite(rhs)) {
+                              return NaN();
+                            }
+                            return lhs - rhs;
+                          });
+                    }) &&
+        next.size() >= safe_population) {
       break;
     }
 
-    Candidate corr;
-    corr.expression =
-        "ts_corr((" + a.expression + "),(" + b.expression + "),10)";
-    corr.values = TsCorr(a.values, b.values, 10);
-    corr.complexity = a.complexity + b.complexity + 2.0;
-    if (AddCandidateDedup(corr, &visited, &next) && next.size() >= safe_population) {
+    if (breed_child("ts_corr((" + a.expression + "),(" + b.expression + "),10)",
+                    a.complexity + b.complexity + 2.0,
+                    [&] { return TsCorr(a.values, b.values, 10); }) &&
+        next.size() >= safe_population) {
       break;
     }
 
-    Candidate rank;
-    rank.expression = "ts_rank((" + a.expression + "),10)";
-    rank.values = TsRank(a.values, 10);
-    rank.complexity = a.complexity + 1.0;
-    if (AddCandidateDedup(rank, &visited, &next) && next.size() >= safe_population) {
+    if (breed_child("ts_rank((" + a.expression + "),10)",
+                    a.complexity + 1.0,
+                    [&] { return TsRank(a.values, 10); }) &&
+        next.size() >= safe_population) {
       break;
     }
   }
@@ -402,8 +478,8 @@ IcSummary BuildRandomBaselineAbsIcSummary(
     std::size_t begin,
     std::size_t end,
     int random_seed,
-    int trials) {
-  std::vector<double> abs_ics;
+    int trials,
+    int worker_count) {
   if (begin >= end || end > future_returns.size() || trials <= 0) {
     return {};
   }
@@ -412,24 +488,42 @@ IcSummary BuildRandomBaselineAbsIcSummary(
     return {};
   }
 
-  std::mt19937 rng(static_cast<std::mt19937::result_type>(random_seed));
-  std::normal_distribution<double> dist(0.0, 1.0);
-  abs_ics.reserve(static_cast<std::size_t>(trials));
-  for (int i = 0; i < trials; ++i) {
-    std::vector<double> random_factor(returns_slice.size(), NaN());
-    for (double& value : random_factor) {
-      value = dist(rng);
-    }
-    const SpearmanIcResult ic = ComputeSpearmanIC(random_factor, returns_slice);
-    if (ic.sample_count >= 3 && IsFinite(ic.ic)) {
-      abs_ics.push_back(std::fabs(ic.ic));
+  // 各 trial 完全独立，按 ParallelFor 并行展开。每个 trial 使用由
+  // random_seed 和 trial 序号派生的独立随机流（黄金比奇数乘子打散，
+  // 避免相邻种子产生相关序列），结果写入固定槽位后按序号聚合，
+  // 因此同 seed 的输出与线程数、调度顺序无关。
+  std::vector<double> trial_abs_ic(static_cast<std::size_t>(trials), NaN());
+  ParallelFor(
+      static_cast<std::size_t>(trials),
+      worker_count,
+      [&](std::size_t trial) {
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(random_seed) +
+                         0x9E3779B9U *
+                             (static_cast<std::mt19937::result_type>(trial) + 1U));
+        std::normal_distribution<double> dist(0.0, 1.0);
+        std::vector<double> random_factor(returns_slice.size(), NaN());
+        for (double& value : random_factor) {
+          value = dist(rng);
+        }
+        const SpearmanIcResult ic =
+            ComputeSpearmanIC(random_factor, returns_slice);
+        if (ic.sample_count >= 3 && IsFinite(ic.ic)) {
+          trial_abs_ic[trial] = std::fabs(ic.ic);
+        }
+      });
+
+  std::vector<double> abs_ics;
+  abs_ics.reserve(trial_abs_ic.size());
+  for (double value : trial_abs_ic) {
+    if (IsFinite(value)) {
+      abs_ics.push_back(value);
     }
   }
   return SummarizeIcSeries(abs_ics);
 }
 
-std::vector<Candidate> BuildCandidates(const std::vector<double>& close,
-                                       const std::vector<double>& volume) {
+std::vector<Candidate> BuildCandidates(std::span<const double> close,
+                                       std::span<const double> volume) {
   std::vector<Candidate> candidates;
 
   const std::vector<double> delay1 = TsDelay(close, 1);
@@ -549,12 +643,14 @@ std::vector<Candidate> BuildCandidates(const std::vector<double>& close,
   return candidates;
 }
 
-}  // namespace
-
-MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
-                       const MinerConfig& config) const {
+// 行式与列式入口共用的挖掘主流程：只依赖 close/volume 两条连续列，
+// 因此既可来自 AoS 拷贝，也可直接指向 mmap 的列式存储（零拷贝）。
+MinerReport RunOnColumns(std::span<const double> close,
+                         std::span<const double> volume,
+                         const MinerConfig& config) {
   MinerReport report;
-  if (bars.size() < 30) {
+  const std::size_t bar_count = close.size();
+  if (bar_count < 30 || volume.size() != bar_count) {
     return report;
   }
   report.random_seed = config.random_seed;
@@ -563,42 +659,40 @@ MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
   report.generations = std::max(1, config.generations);
   report.population_size = std::max(1, config.population_size);
 
-  std::vector<double> close;
-  std::vector<double> volume;
-  close.reserve(bars.size());
-  volume.reserve(bars.size());
-  for (const ResearchBar& bar : bars) {
-    close.push_back(bar.close);
-    volume.push_back(bar.volume);
-  }
   const std::vector<double> future_returns = BuildForwardReturns(close);
   std::vector<Candidate> population = BuildCandidates(close, volume);
 
   std::size_t split_index =
       static_cast<std::size_t>(config.train_split_ratio *
-                               static_cast<double>(bars.size()));
+                               static_cast<double>(bar_count));
   // 为 OOS 留出最小样本，避免 split 极端导致结果无意义。
-  split_index = std::clamp<std::size_t>(split_index, 10, bars.size() - 10);
+  split_index = std::clamp<std::size_t>(split_index, 10, bar_count - 10);
 
   std::unordered_map<std::string, CandidateEval> best_eval_by_expression;
   best_eval_by_expression.reserve(static_cast<std::size_t>(report.population_size) *
                                   static_cast<std::size_t>(report.generations));
 
   std::mt19937 rng(static_cast<std::mt19937::result_type>(config.random_seed));
+  // 跨代列缓存（见 ExpressionColumnCache 注释），Run 结束即释放。
+  ExpressionColumnCache column_cache;
+  column_cache.reserve(static_cast<std::size_t>(report.population_size) *
+                       static_cast<std::size_t>(report.generations));
   const int target_generations = std::max(1, config.generations);
   const int rolling_window = std::max(3, config.rolling_ic_window);
   for (int generation = 0;
        generation < target_generations && !population.empty();
        ++generation) {
-    std::vector<CandidateEval> evaluations;
-    evaluations.reserve(population.size());
-    for (const Candidate& candidate : population) {
-      evaluations.push_back(EvaluateCandidate(candidate,
-                                             future_returns,
-                                             split_index,
-                                             rolling_window,
-                                             config.complexity_penalty));
-    }
+    // 各候选的适应度互不依赖，按槽位并行评估（见 ParallelFor 注释）。
+    std::vector<CandidateEval> evaluations(population.size());
+    ParallelFor(population.size(),
+                config.eval_threads,
+                [&](std::size_t i) {
+                  evaluations[i] = EvaluateCandidate(population[i],
+                                                     future_returns,
+                                                     split_index,
+                                                     rolling_window,
+                                                     config.complexity_penalty);
+                });
     SortEvaluations(&evaluations);
     if (evaluations.empty()) {
       break;
@@ -628,7 +722,8 @@ MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
                                      evaluations,
                                      config.elite_size,
                                      config.population_size,
-                                     &rng);
+                                     &rng,
+                                     &column_cache);
   }
   report.generations = static_cast<int>(report.generation_summaries.size());
 
@@ -665,9 +760,10 @@ MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
   report.random_baseline_oos_abs_ic = BuildRandomBaselineAbsIcSummary(
       future_returns,
       split_index,
-      bars.size(),
+      bar_count,
       config.random_seed,
-      report.random_baseline_trials);
+      report.random_baseline_trials,
+      config.eval_threads);
   report.oos_random_baseline_threshold_p90 =
       report.random_baseline_oos_abs_ic.p90;
   if (!report.factors.empty()) {
@@ -677,7 +773,7 @@ MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
       report.top_factor_oos_abs_ic >= report.oos_random_baseline_threshold_p90;
 
   std::ostringstream id_seed;
-  id_seed << "seed=" << config.random_seed << "|bars=" << bars.size()
+  id_seed << "seed=" << config.random_seed << "|bars=" << bar_count
           << "|top=" << count;
   for (const RankedFactor& factor : report.factors) {
     id_seed << "|" << factor.expression << "|" << std::fixed
@@ -690,6 +786,26 @@ MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
   return report;
 }
 
+}  // namespace
+
+MinerReport Miner::Run(const std::vector<ResearchBar>& bars,
+                       const MinerConfig& config) const {
+  std::vector<double> close;
+  std::vector<double> volume;
+  close.reserve(bars.size());
+  volume.reserve(bars.size());
+  for (const ResearchBar& bar : bars) {
+    close.push_back(bar.close);
+    volume.push_back(bar.volume);
+  }
+  return RunOnColumns(close, volume, config);
+}
+
+MinerReport Miner::Run(const ColumnarBarStore& store,
+                       const MinerConfig& config) const {
+  return RunOnColumns(store.Closes(), store.Volumes(), config);
+}
+
 bool LoadResearchBarsFromCsv(const std::string& file_path,
                              std::vector<ResearchBar>* out_bars,
                              std::string* out_error) {
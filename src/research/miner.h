@@ -54,6 +54,10 @@ struct MinerConfig {
   int generations{4};
   int population_size{32};
   int elite_size{8};
+  // 种群评估并行线程数；<=0 表示取硬件并发数。
+  // 并行只覆盖互相独立的适应度计算，不改变任何随机数消费顺序，
+  // 同 random_seed 的报告输出与串行完全一致。
+  int eval_threads{0};
 };
 
 /// Miner 产物报告（用于后续 Integrator 对接）。
@@ -73,6 +77,8 @@ struct MinerReport {
   std::vector<MinerGenerationSummary> generation_summaries;
 };
 
+class ColumnarBarStore;
+
 /**
  * @brief 阶段 R1：离线因子挖掘器（MVP）
  *
@@ -85,6 +91,9 @@ class Miner {
  public:
   MinerReport Run(const std::vector<ResearchBar>& bars,
                   const MinerConfig& config) const;
+  /// 直接在内存映射的列式存储上运行（零解析零拷贝，结果与行式一致）。
+  MinerReport Run(const ColumnarBarStore& store,
+                  const MinerConfig& config) const;
 };
 
 /**
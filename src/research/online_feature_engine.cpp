@@ -1,18 +1,15 @@
 #include "research/online_feature_engine.h"
 
 #include <algorithm>
-#include <atomic>
 #include <cctype>
 #include <cmath>
-#include <iostream>
 #include <limits>
-#include <sstream>
-#include <stack>
 #include <stdexcept>
 #include <string_view>
 #include <unordered_map>
 
 #include "core/log.h"
+#include "core/snapshot_io.h"
 #include "research/time_series_operators.h"
 
 namespace ai_trade::research {
@@ -33,34 +30,21 @@ bool IsAlpha(char c) {
   return std::isalpha(static_cast<unsigned char>(c));
 }
 
-// 向量二元运算辅助
-std::vector<double> BinaryOp(const std::vector<double>& lhs,
-                             const std::vector<double>& rhs,
-                             char op) {
-  const size_t n = std::min(lhs.size(), rhs.size());
-  std::vector<double> res;
-  res.reserve(n);
-  for (size_t i = 0; i < n; ++i) {
-    double val = 0.0;
-    if (!IsFinite(lhs[i]) || !IsFinite(rhs[i])) {
-      val = std::numeric_limits<double>::quiet_NaN();
-    } else {
-      switch (op) {
-        case '+': val = lhs[i] + rhs[i]; break;
-        case '-': val = lhs[i] - rhs[i]; break;
-        case '*': val = lhs[i] * rhs[i]; break;
-        case '/': 
-          val = (std::abs(rhs[i]) > 1e-9) ? lhs[i] / rhs[i] : 0.0; 
-          break;
-        default: val = 0.0; break;
-      }
-    }
-    res.push_back(val);
-  }
-  return res;
+double NaN() {
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+// 变量名 → SoA 字段下标（open=0..volume=4），未知变量返回 -1。
+int FieldIndexOf(const std::string& name) {
+  if (name == "open") return 0;
+  if (name == "high") return 1;
+  if (name == "low") return 2;
+  if (name == "close") return 3;
+  if (name == "volume") return 4;
+  return -1;
 }
 
-// --- 表达式解析器 ---
+// --- 表达式词法单元 ---
 
 enum class TokenType {
   kNumber,
@@ -81,18 +65,58 @@ struct Token {
   double number_value{0.0};
 };
 
-class ExpressionParser {
+}  // namespace
+
+// --- 表达式编译器 ---
+//
+// 与旧的 ExpressionParser 采用相同的递归下降文法，但不直接求值，
+// 而是发射后序排列的节点程序（CompiledExpression）。每个节点对应一个
+// 窗口长度的结果槽，求值阶段按程序顺序原地写入，无字符串处理、
+// 无程序结构分配。
+class ExpressionCompiler {
  public:
-  ExpressionParser(const std::string& expression,
-                   const std::unordered_map<std::string, RollingBuffer>& series,
-                   size_t window_size)
+  using OpCode = CompiledExpression::OpCode;
+  using Node = CompiledExpression::Node;
+
+  // series 为空指针时按字段下标绑定变量（多 symbol 引擎），
+  // 否则按缓冲区指针绑定（单 symbol 引擎）。
+  ExpressionCompiler(const std::string& expression,
+                     const std::unordered_map<std::string, RollingBuffer>* series,
+                     size_t window_size)
       : expression_(expression), series_(series), window_size_(window_size) {
     Tokenize();
   }
 
-  std::vector<double> Parse() {
+  // 共享的程序执行器：kSeries 节点的窗口视图由调用方的回调提供，
+  // 其余节点语义与引擎无关。两个引擎共用，保证求值语义一致。
+  using SeriesViewFn =
+      std::function<std::span<const double>(const CompiledExpression::Node&)>;
+  static double Execute(const CompiledExpression& compiled,
+                        const SeriesViewFn& series_view);
+
+  CompiledExpression Compile() {
+    CompiledExpression compiled;
+    compiled.source_ = expression_;
+    if (expression_.empty()) {
+      return compiled;
+    }
     cursor_ = 0;
-    return ParseExpression();
+    program_ = &compiled.program_;
+    ParseExpression();
+    program_ = nullptr;
+
+    // 预分配并填充结果槽：常数/无效节点编译期写死，其余节点运行期覆盖。
+    compiled.slots_.resize(compiled.program_.size());
+    compiled.views_.resize(compiled.program_.size());
+    for (size_t i = 0; i < compiled.program_.size(); ++i) {
+      const Node& node = compiled.program_[i];
+      if (node.op == OpCode::kConst) {
+        compiled.slots_[i].assign(window_size_, node.constant);
+      } else {
+        compiled.slots_[i].assign(window_size_, NaN());
+      }
+    }
+    return compiled;
   }
 
  private:
@@ -103,7 +127,7 @@ class ExpressionParser {
         ++i;
         continue;
       }
-      
+
       char c = expression_[i];
       if (IsDigit(c) || c == '.') {
         size_t start = i;
@@ -154,7 +178,7 @@ class ExpressionParser {
           case '-': tokens_.push_back({TokenType::kMinus, "-", 0.0}); break;
           case '*': tokens_.push_back({TokenType::kMultiply, "*", 0.0}); break;
           case '/': tokens_.push_back({TokenType::kDivide, "/", 0.0}); break;
-          default: 
+          default:
             // 忽略未知字符
             break;
         }
@@ -183,39 +207,60 @@ class ExpressionParser {
     return false;
   }
 
+  int Emit(Node node) {
+    program_->push_back(node);
+    return static_cast<int>(program_->size()) - 1;
+  }
+
+  int EmitInvalid() {
+    Node node;
+    node.op = OpCode::kInvalid;
+    return Emit(node);
+  }
+
   // Grammar:
   // Expression -> Term { (+|-) Term }
   // Term -> Factor { (*|/) Factor }
   // Factor -> Number | Identifier | Identifier(Args) | (Expression) | -Factor
 
-  std::vector<double> ParseExpression() {
-    std::vector<double> lhs = ParseTerm();
+  int ParseExpression() {
+    int lhs = ParseTerm();
     while (Peek().type == TokenType::kPlus || Peek().type == TokenType::kMinus) {
       Token op = Consume();
-      std::vector<double> rhs = ParseTerm();
-      lhs = BinaryOp(lhs, rhs, op.text[0]);
+      int rhs = ParseTerm();
+      Node node;
+      node.op = (op.type == TokenType::kPlus) ? OpCode::kAdd : OpCode::kSub;
+      node.lhs = lhs;
+      node.rhs = rhs;
+      lhs = Emit(node);
     }
     return lhs;
   }
 
-  std::vector<double> ParseTerm() {
-    std::vector<double> lhs = ParseFactor();
+  int ParseTerm() {
+    int lhs = ParseFactor();
     while (Peek().type == TokenType::kMultiply || Peek().type == TokenType::kDivide) {
       Token op = Consume();
-      std::vector<double> rhs = ParseFactor();
-      lhs = BinaryOp(lhs, rhs, op.text[0]);
+      int rhs = ParseFactor();
+      Node node;
+      node.op = (op.type == TokenType::kMultiply) ? OpCode::kMul : OpCode::kDiv;
+      node.lhs = lhs;
+      node.rhs = rhs;
+      lhs = Emit(node);
     }
     return lhs;
   }
 
-  std::vector<double> ParseFactor() {
+  int ParseFactor() {
     Token t = Peek();
-    
+
     if (t.type == TokenType::kNumber) {
       Consume();
-      // 返回常数向量
-      return std::vector<double>(window_size_, t.number_value);
-    } 
+      Node node;
+      node.op = OpCode::kConst;
+      node.constant = t.number_value;
+      return Emit(node);
+    }
     else if (t.type == TokenType::kIdentifier) {
       Consume();
       if (Peek().type == TokenType::kLParen) {
@@ -223,32 +268,45 @@ class ExpressionParser {
         return ParseFunctionCall(t.text);
       } else {
         // Variable
-        return GetVariable(t.text);
+        const int field = FieldIndexOf(t.text);
+        if (field < 0) {
+          return EmitInvalid();
+        }
+        Node node;
+        node.op = OpCode::kSeries;
+        node.series_field = field;
+        if (series_ != nullptr) {
+          const auto it = series_->find(t.text);
+          if (it == series_->end()) {
+            return EmitInvalid();
+          }
+          node.series = &it->second;
+        }
+        return Emit(node);
       }
-    } 
+    }
     else if (t.type == TokenType::kLParen) {
       Consume();
-      std::vector<double> val = ParseExpression();
-      if (!Match(TokenType::kRParen)) {
-        // 简单的错误处理：返回空或 NaN 向量
-        // LogError("Expected ')'");
-      }
+      int val = ParseExpression();
+      Match(TokenType::kRParen);
       return val;
     }
     else if (t.type == TokenType::kMinus) {
       Consume();
-      std::vector<double> val = ParseFactor();
-      for (auto& v : val) v = -v;
-      return val;
+      int operand = ParseFactor();
+      Node node;
+      node.op = OpCode::kNeg;
+      node.lhs = operand;
+      return Emit(node);
     }
 
     // Error case
-    return std::vector<double>(window_size_, std::numeric_limits<double>::quiet_NaN());
+    return EmitInvalid();
   }
 
-  std::vector<double> ParseFunctionCall(const std::string& func_name) {
+  int ParseFunctionCall(const std::string& func_name) {
     Consume(); // '('
-    std::vector<std::vector<double>> args;
+    std::vector<int> args;
     if (Peek().type != TokenType::kRParen) {
       args.push_back(ParseExpression());
       while (Match(TokenType::kComma)) {
@@ -257,107 +315,153 @@ class ExpressionParser {
     }
     Match(TokenType::kRParen);
 
-    // Dispatch function
+    Node node;
     if (func_name == "ts_delay" && args.size() == 2) {
-      int delay = static_cast<int>(GetScalar(args[1]));
-      return TsDelay(args[0], delay);
+      node.op = OpCode::kTsDelay;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
     }
     if (func_name == "ts_delta" && args.size() == 2) {
-      int delay = static_cast<int>(GetScalar(args[1]));
-      return TsDelta(args[0], delay);
+      node.op = OpCode::kTsDelta;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
     }
     if (func_name == "ts_rank" && args.size() == 2) {
-      int window = static_cast<int>(GetScalar(args[1]));
-      return TsRank(args[0], window);
+      node.op = OpCode::kTsRank;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
     }
     if (func_name == "ts_corr" && args.size() == 3) {
-      int window = static_cast<int>(GetScalar(args[2]));
-      return TsCorr(args[0], args[1], window);
+      node.op = OpCode::kTsCorr;
+      node.lhs = args[0];
+      node.rhs = args[1];
+      node.param = args[2];
+      return Emit(node);
+    }
+    if (func_name == "ts_min" && args.size() == 2) {
+      node.op = OpCode::kTsMin;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
+    }
+    if (func_name == "ts_max" && args.size() == 2) {
+      node.op = OpCode::kTsMax;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
+    }
+    if (func_name == "ts_sum" && args.size() == 2) {
+      node.op = OpCode::kTsSum;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
+    }
+    if (func_name == "ts_std" && args.size() == 2) {
+      node.op = OpCode::kTsStd;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
+    }
+    if (func_name == "ts_zscore" && args.size() == 2) {
+      node.op = OpCode::kTsZscore;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
     }
     if (func_name == "rsi" && args.size() == 2) {
-      int period = static_cast<int>(GetScalar(args[1]));
-      return TsRsi(args[0], period);
+      node.op = OpCode::kRsi;
+      node.lhs = args[0];
+      node.param = args[1];
+      return Emit(node);
     }
     if (func_name == "ema" && args.size() == 2) {
-      int period = static_cast<int>(GetScalar(args[1]));
+      node.op = OpCode::kEma;
+      node.lhs = args[0];
+      node.param = args[1];
       // 精度警告：EMA 是递归算子，在滑动窗口上计算存在冷启动偏差。
       // 经验法则：窗口长度应至少为周期的 3 倍以保证误差 < 1% (对于 alpha=2/(N+1))。
-      if (period > 0 && window_size_ < static_cast<size_t>(period * 3)) {
-        static std::atomic<int> warn_throttle{0};
-        // 限频日志，避免刷屏
-        if (warn_throttle.fetch_add(1, std::memory_order_relaxed) % 100 == 0) {
-           LogInfo("WARN: EMA period " + std::to_string(period) + 
-                   " is too large for window " + std::to_string(window_size_) + 
-                   ". Precision loss expected (recommend window >= 3*period).");
+      // 周期为常数时在编译期检查一次即可，无需在求值热路径限频。
+      const Node& param_node = (*program_)[args[1]];
+      if (param_node.op == OpCode::kConst) {
+        const int period = static_cast<int>(param_node.constant);
+        if (period > 0 && window_size_ < static_cast<size_t>(period * 3)) {
+          LogInfo("WARN: EMA period " + std::to_string(period) +
+                  " is too large for window " + std::to_string(window_size_) +
+                  ". Precision loss expected (recommend window >= 3*period).");
         }
       }
-      return TsEma(args[0], period);
+      return Emit(node);
     }
     if (func_name == "abs" && args.size() == 1) {
-      std::vector<double> res = args[0];
-      for (auto& v : res) v = std::abs(v);
-      return res;
+      node.op = OpCode::kAbs;
+      node.lhs = args[0];
+      return Emit(node);
     }
 
     // Unknown function or wrong args
-    return std::vector<double>(window_size_, std::numeric_limits<double>::quiet_NaN());
-  }
-
-  std::vector<double> GetVariable(const std::string& name) {
-    auto it = series_.find(name);
-    if (it != series_.end()) {
-      // 获取最近 window_size_ 个数据
-      std::vector<double> data = it->second.GetLast(window_size_);
-      // 如果数据不足，前面补 NaN 以对齐长度，保证计算逻辑一致
-      if (data.size() < window_size_) {
-        std::vector<double> padded(window_size_ - data.size(), std::numeric_limits<double>::quiet_NaN());
-        padded.insert(padded.end(), data.begin(), data.end());
-        return padded;
-      }
-      return data;
-    }
-    return std::vector<double>(window_size_, std::numeric_limits<double>::quiet_NaN());
-  }
-
-  double GetScalar(const std::vector<double>& vec) {
-    if (vec.empty()) return 0.0;
-    // 通常常数向量所有值都一样，取最后一个即可
-    return vec.back();
+    return EmitInvalid();
   }
 
   std::string expression_;
-  const std::unordered_map<std::string, RollingBuffer>& series_;
+  const std::unordered_map<std::string, RollingBuffer>* series_;
   size_t window_size_;
   std::vector<Token> tokens_;
   size_t cursor_{0};
+  std::vector<Node>* program_{nullptr};
 };
 
-}  // namespace
-
 // --- RollingBuffer 实现 ---
 
-RollingBuffer::RollingBuffer(size_t capacity) : capacity_(capacity) {}
+RollingBuffer::RollingBuffer(size_t capacity)
+    : storage_(capacity * 2, 0.0), capacity_(capacity) {}
 
 void RollingBuffer::Add(double value) {
-  buffer_.push_back(value);
-  if (buffer_.size() > capacity_) {
-    buffer_.pop_front();
+  if (capacity_ == 0) {
+    return;
   }
+  // 镜像写入：同一样本写入相距 capacity 的两个位置，
+  // 保证任意最近窗口 [write_pos_+capacity-n, write_pos_+capacity) 连续。
+  storage_[write_pos_] = value;
+  storage_[write_pos_ + capacity_] = value;
+  write_pos_ = (write_pos_ + 1) % capacity_;
+  count_ = std::min(count_ + 1, capacity_);
 }
 
-std::vector<double> RollingBuffer::GetLast(size_t n) const {
-  if (buffer_.empty()) {
+void RollingBuffer::SaveState(SnapshotWriter* writer) const {
+  writer->Field(static_cast<std::uint64_t>(capacity_));
+  writer->Field(static_cast<std::uint64_t>(write_pos_));
+  writer->Field(static_cast<std::uint64_t>(count_));
+  writer->Field(storage_);
+}
+
+void RollingBuffer::LoadState(SnapshotReader* reader) {
+  std::uint64_t capacity = 0;
+  std::uint64_t write_pos = 0;
+  std::uint64_t count = 0;
+  reader->Field(capacity);
+  reader->Field(write_pos);
+  reader->Field(count);
+  reader->Field(storage_);
+  capacity_ = static_cast<size_t>(capacity);
+  write_pos_ = static_cast<size_t>(write_pos);
+  count_ = static_cast<size_t>(count);
+}
+
+std::span<const double> RollingBuffer::LastSpan(size_t n) const {
+  const size_t count = std::min(n, count_);
+  if (count == 0) {
     return {};
   }
-  size_t count = std::min(n, buffer_.size());
-  std::vector<double> result;
-  result.reserve(count);
-  
-  // 从后往前取 count 个，保持时间正序
-  auto it = buffer_.end();
-  std::advance(it, -static_cast<std::ptrdiff_t>(count));
-  result.insert(result.end(), it, buffer_.end());
-  return result;
+  return std::span<const double>(
+      storage_.data() + (write_pos_ + capacity_ - count), count);
+}
+
+std::vector<double> RollingBuffer::GetLast(size_t n) const {
+  const auto view = LastSpan(n);
+  return std::vector<double>(view.begin(), view.end());
 }
 
 // --- OnlineFeatureEngine 实现 ---
@@ -390,8 +494,157 @@ void OnlineFeatureEngine::OnMarket(const MarketEvent& event) {
   series_.at("volume").Add(volume);
 }
 
+CompiledExpression OnlineFeatureEngine::Compile(
+    const std::string& expression) const {
+  try {
+    ExpressionCompiler compiler(expression, &series_, window_size_);
+    return compiler.Compile();
+  } catch (const std::exception&) {
+    // 解析错误：返回无效程序，求值时统一产出 NaN。
+    return CompiledExpression{};
+  }
+}
+
 double OnlineFeatureEngine::Evaluate(const std::string& expression) const {
-  return EvaluateRecursive(expression);
+  // 一次性求值路径：仍然走编译器，保证与预编译路径语义一致。
+  // 热路径应调用 Compile 缓存编译结果。
+  return Evaluate(Compile(expression));
+}
+
+double ExpressionCompiler::Execute(const CompiledExpression& compiled,
+                                   const SeriesViewFn& series_view) {
+  if (!compiled.valid()) {
+    return NaN();
+  }
+  using OpCode = CompiledExpression::OpCode;
+  const auto& program = compiled.program_;
+  auto& slots = compiled.slots_;
+  auto& views = compiled.views_;
+
+  // 取标量参数：约定参数子表达式为常数向量，取末位即可（与旧解析器一致）。
+  const auto scalar_param = [&views](int slot_index) {
+    if (slot_index < 0 || views[slot_index].empty()) {
+      return 0;
+    }
+    return static_cast<int>(views[slot_index].back());
+  };
+
+  for (size_t i = 0; i < program.size(); ++i) {
+    const auto& node = program[i];
+    std::vector<double>& out = slots[i];
+    switch (node.op) {
+      case OpCode::kConst:
+      case OpCode::kInvalid:
+        // 结果槽编译期已填充
+        views[i] = out;
+        break;
+      case OpCode::kSeries:
+        // 由调用方引擎解析为连续窗口视图，零拷贝
+        views[i] = series_view(node);
+        break;
+      case OpCode::kAdd:
+      case OpCode::kSub:
+      case OpCode::kMul:
+      case OpCode::kDiv: {
+        const std::span<const double> lhs = views[node.lhs];
+        const std::span<const double> rhs = views[node.rhs];
+        const size_t n = std::min(lhs.size(), rhs.size());
+        out.resize(n);
+        for (size_t j = 0; j < n; ++j) {
+          if (!IsFinite(lhs[j]) || !IsFinite(rhs[j])) {
+            out[j] = NaN();
+            continue;
+          }
+          switch (node.op) {
+            case OpCode::kAdd: out[j] = lhs[j] + rhs[j]; break;
+            case OpCode::kSub: out[j] = lhs[j] - rhs[j]; break;
+            case OpCode::kMul: out[j] = lhs[j] * rhs[j]; break;
+            default:
+              out[j] = (std::abs(rhs[j]) > 1e-9) ? lhs[j] / rhs[j] : 0.0;
+              break;
+          }
+        }
+        views[i] = out;
+        break;
+      }
+      case OpCode::kNeg: {
+        const std::span<const double> in = views[node.lhs];
+        out.resize(in.size());
+        for (size_t j = 0; j < in.size(); ++j) {
+          out[j] = -in[j];
+        }
+        views[i] = out;
+        break;
+      }
+      case OpCode::kAbs: {
+        const std::span<const double> in = views[node.lhs];
+        out.resize(in.size());
+        for (size_t j = 0; j < in.size(); ++j) {
+          out[j] = std::abs(in[j]);
+        }
+        views[i] = out;
+        break;
+      }
+      case OpCode::kTsDelay:
+        TsDelayInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsDelta:
+        TsDeltaInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsRank:
+        TsRankInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsCorr:
+        TsCorrInto(views[node.lhs], views[node.rhs], scalar_param(node.param),
+                   &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsMin:
+        TsMinInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsMax:
+        TsMaxInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsSum:
+        TsSumInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsStd:
+        TsStdInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kTsZscore:
+        TsZscoreInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kRsi:
+        TsRsiInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+      case OpCode::kEma:
+        TsEmaInto(views[node.lhs], scalar_param(node.param), &out);
+        views[i] = out;
+        break;
+    }
+  }
+
+  const std::span<const double> result = views.back();
+  // 返回当前 tick 的值（向量的最后一个元素）
+  return result.empty() ? NaN() : result.back();
+}
+
+double OnlineFeatureEngine::Evaluate(const CompiledExpression& compiled) const {
+  return ExpressionCompiler::Execute(
+      compiled, [this](const CompiledExpression::Node& node) {
+        return node.series != nullptr
+                   ? node.series->LastSpan(window_size_)
+                   : std::span<const double>{};
+      });
 }
 
 std::vector<double> OnlineFeatureEngine::EvaluateBatch(
@@ -404,6 +657,23 @@ std::vector<double> OnlineFeatureEngine::EvaluateBatch(
   return results;
 }
 
+std::vector<double> OnlineFeatureEngine::EvaluateBatch(
+    const std::vector<CompiledExpression>& compiled) const {
+  std::vector<double> results;
+  EvaluateBatchInto(compiled, &results);
+  return results;
+}
+
+void OnlineFeatureEngine::EvaluateBatchInto(
+    const std::vector<CompiledExpression>& compiled,
+    std::vector<double>* out) const {
+  out->clear();
+  out->reserve(compiled.size());
+  for (const auto& expr : compiled) {
+    out->push_back(Evaluate(expr));
+  }
+}
+
 bool OnlineFeatureEngine::IsReady() const {
   if (series_.empty()) return false;
   // 放宽限制：只要有数据即可尝试计算。
@@ -419,22 +689,144 @@ size_t OnlineFeatureEngine::SampleCount() const {
   return it->second.size();
 }
 
-double OnlineFeatureEngine::EvaluateRecursive(const std::string& expr) const {
-  if (expr.empty()) return std::numeric_limits<double>::quiet_NaN();
-  
+void OnlineFeatureEngine::SaveState(SnapshotWriter* writer) const {
+  writer->Field(static_cast<std::uint64_t>(window_size_));
+  writer->Field(static_cast<std::uint64_t>(series_.size()));
+  for (const auto& [name, buffer] : series_) {
+    writer->Field(name);
+    buffer.SaveState(writer);
+  }
+}
+
+void OnlineFeatureEngine::LoadState(SnapshotReader* reader) {
+  std::uint64_t window_size = 0;
+  std::uint64_t count = 0;
+  reader->Field(window_size);
+  reader->Field(count);
+  window_size_ = static_cast<size_t>(window_size);
+  series_.clear();
+  for (std::uint64_t i = 0; reader->ok() && i < count; ++i) {
+    std::string name;
+    reader->Field(name);
+    RollingBuffer buffer(window_size_);
+    buffer.LoadState(reader);
+    series_.emplace(std::move(name), std::move(buffer));
+  }
+}
+
+// --- MultiSymbolFeatureEngine 实现 ---
+
+MultiSymbolFeatureEngine::MultiSymbolFeatureEngine(
+    const std::vector<std::string>& symbols, size_t window_size)
+    : window_size_(window_size), symbols_(symbols) {
+  symbol_index_.reserve(symbols_.size());
+  for (size_t i = 0; i < symbols_.size(); ++i) {
+    symbol_index_[symbols_[i]] = i;
+  }
+  // 每字段一整块：symbol 分段、每段 2x window 的镜像环。
+  for (auto& storage : field_storage_) {
+    storage.assign(symbols_.size() * window_size_ * 2, 0.0);
+  }
+  write_pos_.assign(symbols_.size(), 0);
+  count_.assign(symbols_.size(), 0);
+}
+
+void MultiSymbolFeatureEngine::OnMarket(const MarketEvent& event) {
+  if (window_size_ == 0) {
+    return;
+  }
+  const auto it = symbol_index_.find(event.symbol);
+  if (it == symbol_index_.end()) {
+    return;
+  }
+  const size_t sym = it->second;
+
+  // 价格/量的映射口径与单 symbol 引擎保持一致。
+  const double price =
+      (std::isfinite(event.price) && event.price > 0.0)
+          ? event.price
+          : ((std::isfinite(event.mark_price) && event.mark_price > 0.0)
+                 ? event.mark_price
+                 : std::numeric_limits<double>::quiet_NaN());
+  const double volume =
+      std::isfinite(event.volume) ? std::max(0.0, event.volume) : 0.0;
+  const double field_values[5] = {price, price, price, price, volume};
+
+  const size_t base = sym * window_size_ * 2;
+  const size_t pos = write_pos_[sym];
+  for (size_t field = 0; field < field_storage_.size(); ++field) {
+    std::vector<double>& storage = field_storage_[field];
+    storage[base + pos] = field_values[field];
+    storage[base + pos + window_size_] = field_values[field];
+  }
+  write_pos_[sym] = (pos + 1) % window_size_;
+  count_[sym] = std::min(count_[sym] + 1, window_size_);
+}
+
+CompiledExpression MultiSymbolFeatureEngine::Compile(
+    const std::string& expression) const {
   try {
-    ExpressionParser parser(expr, series_, window_size_);
-    std::vector<double> result_vec = parser.Parse();
-    
-    if (result_vec.empty()) return std::numeric_limits<double>::quiet_NaN();
-    
-    // 返回当前 tick 的值（向量的最后一个元素）
-    return result_vec.back();
-  } catch (const std::exception& e) {
-    // 解析错误或计算错误，返回 0.0 并记录日志（实际生产中应限频日志）
-    // LogError("Feature eval failed: " + std::string(e.what()));
-    return std::numeric_limits<double>::quiet_NaN();
+    // 不传序列表：变量按字段下标绑定，同一产物可横扫所有 symbol。
+    ExpressionCompiler compiler(expression, nullptr, window_size_);
+    return compiler.Compile();
+  } catch (const std::exception&) {
+    return CompiledExpression{};
+  }
+}
+
+std::span<const double> MultiSymbolFeatureEngine::FieldSpan(
+    int field, size_t symbol_index, size_t n) const {
+  if (field < 0 || static_cast<size_t>(field) >= field_storage_.size()) {
+    return {};
+  }
+  const size_t count = std::min(n, count_[symbol_index]);
+  if (count == 0) {
+    return {};
+  }
+  const std::vector<double>& storage = field_storage_[static_cast<size_t>(field)];
+  const size_t base = symbol_index * window_size_ * 2;
+  return std::span<const double>(
+      storage.data() + base + (write_pos_[symbol_index] + window_size_ - count),
+      count);
+}
+
+void MultiSymbolFeatureEngine::EvaluateAll(const CompiledExpression& compiled,
+                                           std::vector<double>* out) const {
+  if (out == nullptr) {
+    return;
+  }
+  out->assign(symbols_.size(), NaN());
+  if (!compiled.valid()) {
+    return;
+  }
+  // 顺序横扫：symbol 间复用同一份结果槽，同字段数据在内存中相邻。
+  for (size_t sym = 0; sym < symbols_.size(); ++sym) {
+    (*out)[sym] = ExpressionCompiler::Execute(
+        compiled, [this, sym](const CompiledExpression::Node& node) {
+          return FieldSpan(node.series_field, sym, window_size_);
+        });
+  }
+}
+
+double MultiSymbolFeatureEngine::Evaluate(const CompiledExpression& compiled,
+                                          const std::string& symbol) const {
+  const auto it = symbol_index_.find(symbol);
+  if (it == symbol_index_.end() || !compiled.valid()) {
+    return NaN();
+  }
+  const size_t sym = it->second;
+  return ExpressionCompiler::Execute(
+      compiled, [this, sym](const CompiledExpression::Node& node) {
+        return FieldSpan(node.series_field, sym, window_size_);
+      });
+}
+
+size_t MultiSymbolFeatureEngine::SampleCount(const std::string& symbol) const {
+  const auto it = symbol_index_.find(symbol);
+  if (it == symbol_index_.end()) {
+    return 0;
   }
+  return count_[it->second];
 }
 
 }  // namespace ai_trade::research
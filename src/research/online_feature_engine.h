@@ -1,6 +1,7 @@
 #pragma once
 
-#include <deque>
+#include <array>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,23 +11,111 @@
 
 #include "core/types.h"
 
+namespace ai_trade {
+class SnapshotWriter;
+class SnapshotReader;
+}  // namespace ai_trade
+
 namespace ai_trade::research {
 
-// 简单的环形缓冲区，用于存储 OHLCV 历史数据
+// 固定容量的连续环形缓冲区，用于存储 OHLCV 历史数据。
+// 采用 2x 容量的镜像写入：每个样本同时写入两个间隔 capacity 的位置，
+// 保证任意"最近 N 个"窗口在内存中始终连续，可直接以 span 视图
+// 零拷贝地交给 ts_rank/ts_corr 等算子读取。
 class RollingBuffer {
  public:
   explicit RollingBuffer(size_t capacity);
   void Add(double value);
-  // 获取最近 N 个数据（按时间正序，最新的在最后）
-  // 如果数据不足 N 个，返回空 vector 或填充 NaN（视策略而定）
+  // 获取最近 N 个数据的拷贝（按时间正序，最新的在最后）。
+  // 兼容旧调用方；热路径请使用 LastSpan 避免拷贝。
   std::vector<double> GetLast(size_t n) const;
-  size_t size() const { return buffer_.size(); }
-  double back() const { return buffer_.empty() ? 0.0 : buffer_.back(); }
-  bool empty() const { return buffer_.empty(); }
+  // 最近 min(n, size) 个数据的零拷贝连续视图（按时间正序）。
+  // 视图在下一次 Add 之前有效。
+  std::span<const double> LastSpan(size_t n) const;
+  // 顺序访问第 index 个样本（0 为最旧，调用方保证越界检查）
+  double At(size_t index) const {
+    return storage_[write_pos_ + capacity_ - count_ + index];
+  }
+  size_t size() const { return count_; }
+  size_t capacity() const { return capacity_; }
+  double back() const {
+    return count_ == 0 ? 0.0 : storage_[write_pos_ + capacity_ - 1];
+  }
+  bool empty() const { return count_ == 0; }
+
+  /// 把环形缓冲完整状态（含镜像存储）写入二进制快照。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复；容量以快照内容为准。
+  void LoadState(SnapshotReader* reader);
 
  private:
-  std::deque<double> buffer_;
+  std::vector<double> storage_;  // 2x capacity，镜像写入
   size_t capacity_;
+  size_t write_pos_{0};  // 下一个写入槽位 [0, capacity)
+  size_t count_{0};
+};
+
+class ExpressionCompiler;  // 定义于 .cpp，仅内部使用
+
+// 预编译的因子表达式：字符串解析只在编译时发生一次，之后每个 tick
+// 对滚动窗口零字符串处理、零程序结构分配地求值（节点结果槽复用）。
+// 注意：编译产物持有创建它的引擎内部序列缓冲区的指针，
+// 生命周期不得超过对应的 OnlineFeatureEngine。
+class CompiledExpression {
+ public:
+  CompiledExpression() = default;
+
+  // 编译是否产出了可执行程序（空表达式返回 false）
+  bool valid() const { return !program_.empty(); }
+  const std::string& source() const { return source_; }
+
+ private:
+  friend class OnlineFeatureEngine;
+  friend class MultiSymbolFeatureEngine;
+  friend class ExpressionCompiler;
+
+  enum class OpCode {
+    kConst,      // 常数向量（编译期填充）
+    kSeries,     // 变量窗口视图（open/high/low/close/volume）
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kNeg,
+    kAbs,
+    kTsDelay,
+    kTsDelta,
+    kTsRank,
+    kTsCorr,
+    kTsMin,
+    kTsMax,
+    kTsSum,
+    kTsStd,
+    kTsZscore,
+    kRsi,
+    kEma,
+    kInvalid,    // 未知函数/语法错误（编译期填充 NaN）
+  };
+
+  struct Node {
+    OpCode op{OpCode::kInvalid};
+    int lhs{-1};    // 左操作数所在的结果槽下标
+    int rhs{-1};    // 右操作数所在的结果槽下标
+    int param{-1};  // 标量参数（delay/window/period）所在的结果槽下标
+    double constant{0.0};                  // kConst 专用
+    const RollingBuffer* series{nullptr};  // kSeries 专用（单 symbol 引擎绑定）
+    // kSeries 专用：字段下标（open=0..volume=4）。多 symbol 引擎按
+    // 字段而非缓冲区指针绑定，同一份编译产物可横扫全 universe。
+    int series_field{-1};
+  };
+
+  std::string source_;
+  std::vector<Node> program_;  // 后序排列，最后一个节点为根
+  // 每个节点一个窗口长度的结果槽；求值时原地复用，避免每 tick 分配。
+  mutable std::vector<std::vector<double>> slots_;
+  // 每个节点的操作数视图：kSeries 节点直接指向环形缓冲区的连续窗口
+  // （零拷贝），其余节点指向自己的结果槽。每次求值刷新。
+  mutable std::vector<std::span<const double>> views_;
 };
 
 // 在线特征计算引擎
@@ -39,14 +128,31 @@ class OnlineFeatureEngine {
   void OnMarket(const MarketEvent& event);
 
   // 计算单个表达式的值
-  // 支持算子：ts_delay, ts_delta, ts_rank, ts_corr, +, -, *, /
+  // 支持算子：ts_delay, ts_delta, ts_rank, ts_corr, ts_min, ts_max,
+  //           ts_sum, ts_std, ts_zscore, rsi, ema, abs, +, -, *, /
   // 变量名：open, high, low, close, volume
   // 返回：计算结果，如果数据不足或计算错误返回 NaN
   double Evaluate(const std::string& expression) const;
 
+  // 将表达式编译为可复用的求值程序。热路径应在初始化阶段编译一次，
+  // 之后每个 tick 走 Evaluate(const CompiledExpression&)。
+  CompiledExpression Compile(const std::string& expression) const;
+
+  // 对预编译表达式求值：无字符串解析，结果槽复用，无每 tick 分配。
+  double Evaluate(const CompiledExpression& compiled) const;
+
   // 批量计算特征向量（用于模型推理）
   std::vector<double> EvaluateBatch(const std::vector<std::string>& expressions) const;
 
+  // 预编译版本的批量求值（Integrator 热路径）
+  std::vector<double> EvaluateBatch(
+      const std::vector<CompiledExpression>& compiled) const;
+
+  // EvaluateBatch 的 Into 变体：结果写入调用方缓冲（只 clear/reserve，
+  // 复用已有容量）。按决策反复调用时可避免每次重新分配结果向量。
+  void EvaluateBatchInto(const std::vector<CompiledExpression>& compiled,
+                         std::vector<double>* out) const;
+
   // 检查缓冲区是否已满足最小计算长度
   bool IsReady() const;
 
@@ -54,13 +160,58 @@ class OnlineFeatureEngine {
   // 避免 ts_rank/ts_corr 等 miner 表达式在窗口未满时产生 NaN 并被归零。
   size_t SampleCount() const;
 
+  /// 把 OHLCV 全部滚动窗口写入二进制快照（重启免预热）。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复滚动窗口；缓冲损坏时由调用方检查 reader->ok()。
+  void LoadState(SnapshotReader* reader);
+
  private:
   size_t window_size_;
   std::unordered_map<std::string, RollingBuffer> series_;
-  
-  // 简单的递归下降解析器或栈式求值器辅助函数
-  // 实际实现中可能需要一个轻量级的 ExpressionParser 类
-  double EvaluateRecursive(const std::string& expr) const;
+};
+
+// 多 symbol 在线特征引擎（结构体数组布局）
+// 每个字段（open/high/low/close/volume）是一整块连续内存，按 symbol
+// 分段，每段是与 RollingBuffer 相同的 2x 镜像环。相比每个 symbol 一个
+// OnlineFeatureEngine 实例（每实例 5 次独立堆分配），全 universe 的
+// 同字段数据彼此相邻，EvaluateAll 的横扫按内存顺序推进、缓存友好，
+// 且编译产物跨 symbol 共享（结果槽复用，横扫期间零分配）。
+class MultiSymbolFeatureEngine {
+ public:
+  MultiSymbolFeatureEngine(const std::vector<std::string>& symbols,
+                           size_t window_size);
+
+  // 按 event.symbol 路由写入；未注册的 symbol 直接忽略。
+  void OnMarket(const MarketEvent& event);
+
+  // 编译产物按字段下标绑定（不持缓冲区指针），仅可在本引擎上求值，
+  // 生命周期不得超过引擎本身。
+  CompiledExpression Compile(const std::string& expression) const;
+
+  // 对全 universe 一次横扫求值：out 与 symbols() 同序同长，
+  // 数据不足或表达式无效时对应位置为 NaN。
+  void EvaluateAll(const CompiledExpression& compiled,
+                   std::vector<double>* out) const;
+
+  // 单 symbol 求值（未注册的 symbol 返回 NaN）。
+  double Evaluate(const CompiledExpression& compiled,
+                  const std::string& symbol) const;
+
+  const std::vector<std::string>& symbols() const { return symbols_; }
+  // 指定 symbol 已累计的样本数（未注册返回 0）。
+  size_t SampleCount(const std::string& symbol) const;
+
+ private:
+  std::span<const double> FieldSpan(int field, size_t symbol_index,
+                                    size_t n) const;
+
+  size_t window_size_;
+  std::vector<std::string> symbols_;
+  std::unordered_map<std::string, size_t> symbol_index_;
+  // 字段优先、symbol 分段的 SoA 存储：每段 2x window 的镜像环。
+  std::array<std::vector<double>, 5> field_storage_;
+  std::vector<size_t> write_pos_;  // 每 symbol 的下一个写入槽位
+  std::vector<size_t> count_;      // 每 symbol 已累计样本数
 };
 
 }  // namespace ai_trade::research
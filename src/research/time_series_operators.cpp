@@ -2,8 +2,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
-#include <numeric>
 
 namespace ai_trade::research {
 
@@ -13,36 +13,9 @@ double NaN() {
   return std::numeric_limits<double>::quiet_NaN();
 }
 
-std::vector<double> MakeNaNVector(std::size_t size) {
-  return std::vector<double>(size, NaN());
-}
-
-double PearsonCorrelation(const std::vector<double>& lhs,
-                          const std::vector<double>& rhs) {
-  const std::size_t n = lhs.size();
-  if (n < 2 || n != rhs.size()) {
-    return NaN();
-  }
-
-  const double lhs_sum = std::accumulate(lhs.begin(), lhs.end(), 0.0);
-  const double rhs_sum = std::accumulate(rhs.begin(), rhs.end(), 0.0);
-  const double lhs_mean = lhs_sum / static_cast<double>(n);
-  const double rhs_mean = rhs_sum / static_cast<double>(n);
-
-  double cov = 0.0;
-  double lhs_var = 0.0;
-  double rhs_var = 0.0;
-  for (std::size_t i = 0; i < n; ++i) {
-    const double lhs_centered = lhs[i] - lhs_mean;
-    const double rhs_centered = rhs[i] - rhs_mean;
-    cov += lhs_centered * rhs_centered;
-    lhs_var += lhs_centered * lhs_centered;
-    rhs_var += rhs_centered * rhs_centered;
-  }
-  if (lhs_var <= 0.0 || rhs_var <= 0.0) {
-    return NaN();
-  }
-  return cov / std::sqrt(lhs_var * rhs_var);
+// 将输出向量重置为 n 个 NaN（只 resize，不释放已有容量）。
+void ResetToNaN(std::vector<double>* out, std::size_t n) {
+  out->assign(n, NaN());
 }
 
 }  // namespace
@@ -51,21 +24,34 @@ bool IsFinite(double value) {
   return std::isfinite(value) != 0;
 }
 
-std::vector<double> TsDelay(const std::vector<double>& series, int delay) {
-  std::vector<double> out = MakeNaNVector(series.size());
+std::vector<double> TsDelay(std::span<const double> series, int delay) {
+  std::vector<double> out;
+  TsDelayInto(series, delay, &out);
+  return out;
+}
+
+void TsDelayInto(std::span<const double> series, int delay,
+                 std::vector<double>* out) {
+  ResetToNaN(out, series.size());
   if (delay <= 0) {
-    return out;
+    return;
   }
   for (std::size_t i = static_cast<std::size_t>(delay); i < series.size(); ++i) {
-    out[i] = series[i - static_cast<std::size_t>(delay)];
+    (*out)[i] = series[i - static_cast<std::size_t>(delay)];
   }
+}
+
+std::vector<double> TsDelta(std::span<const double> series, int delay) {
+  std::vector<double> out;
+  TsDeltaInto(series, delay, &out);
   return out;
 }
 
-std::vector<double> TsDelta(const std::vector<double>& series, int delay) {
-  std::vector<double> out = MakeNaNVector(series.size());
+void TsDeltaInto(std::span<const double> series, int delay,
+                 std::vector<double>* out) {
+  ResetToNaN(out, series.size());
   if (delay <= 0) {
-    return out;
+    return;
   }
   const std::size_t d = static_cast<std::size_t>(delay);
   for (std::size_t i = d; i < series.size(); ++i) {
@@ -74,101 +60,446 @@ std::vector<double> TsDelta(const std::vector<double>& series, int delay) {
     if (!IsFinite(current) || !IsFinite(history)) {
       continue;
     }
-    out[i] = current - history;
+    (*out)[i] = current - history;
   }
+}
+
+std::vector<double> TsRank(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsRankInto(series, window, &out);
   return out;
 }
 
-std::vector<double> TsRank(const std::vector<double>& series, int window) {
-  std::vector<double> out = MakeNaNVector(series.size());
+void TsRankInto(std::span<const double> series, int window,
+                std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
   if (window <= 0) {
-    return out;
+    return;
   }
   const std::size_t w = static_cast<std::size_t>(window);
   if (w > series.size()) {
-    return out;
+    return;
   }
 
-  for (std::size_t end = w - 1; end < series.size(); ++end) {
-    const std::size_t begin = end + 1 - w;
-    const double current = series[end];
-    if (!IsFinite(current)) {
+  // 增量滑窗：维护窗口内有限值的有序数组作为顺序统计结构。
+  // 每次滑动二分插入/删除（memmove 连续内存，编译器可向量化），
+  // less/equal 直接由 lower/upper_bound 得出，替代原先每个窗口
+  // O(w) 的重新计数，全序列从 O(n·w) 降为 O(n·log w) 比较。
+  std::vector<double> window_sorted;
+  window_sorted.reserve(w);
+  std::size_t invalid_count = 0;
+
+  // 初始窗口 [0, w)
+  for (std::size_t i = 0; i < w; ++i) {
+    const double value = series[i];
+    if (!IsFinite(value)) {
+      ++invalid_count;
       continue;
     }
+    window_sorted.insert(
+        std::lower_bound(window_sorted.begin(), window_sorted.end(), value),
+        value);
+  }
 
-    int less = 0;
-    int equal = 0;
-    bool valid_window = true;
-    for (std::size_t i = begin; i <= end; ++i) {
-      const double value = series[i];
-      if (!IsFinite(value)) {
-        valid_window = false;
-        break;
+  for (std::size_t end = w - 1; end < series.size(); ++end) {
+    if (end > w - 1) {
+      // 滑动：移除离开窗口的样本，加入新样本
+      const double leaving = series[end - w];
+      if (!IsFinite(leaving)) {
+        --invalid_count;
+      } else {
+        window_sorted.erase(std::lower_bound(window_sorted.begin(),
+                                             window_sorted.end(), leaving));
       }
-      if (value < current) {
-        ++less;
-      } else if (value == current) {
-        ++equal;
+      const double entering = series[end];
+      if (!IsFinite(entering)) {
+        ++invalid_count;
+      } else {
+        window_sorted.insert(std::lower_bound(window_sorted.begin(),
+                                              window_sorted.end(), entering),
+                             entering);
       }
     }
-    if (!valid_window || equal <= 0) {
+
+    const double current = series[end];
+    if (!IsFinite(current) || invalid_count > 0) {
+      continue;
+    }
+    const auto lower =
+        std::lower_bound(window_sorted.begin(), window_sorted.end(), current);
+    const auto upper =
+        std::upper_bound(lower, window_sorted.end(), current);
+    const auto less = static_cast<double>(lower - window_sorted.begin());
+    const auto equal = static_cast<double>(upper - lower);
+    if (equal <= 0.0) {
       continue;
     }
     // 使用 tie-aware 分位排名，保证重复值可稳定比较。
-    const double rank = (static_cast<double>(less) +
-                         0.5 * static_cast<double>(equal)) /
-                        static_cast<double>(w);
-    out[end] = rank;
+    out[end] = (less + 0.5 * equal) / static_cast<double>(w);
   }
-  return out;
 }
 
-std::vector<double> TsCorr(const std::vector<double>& lhs,
-                           const std::vector<double>& rhs,
+std::vector<double> TsCorr(std::span<const double> lhs,
+                           std::span<const double> rhs,
                            int window) {
-  std::vector<double> out = MakeNaNVector(lhs.size());
+  std::vector<double> out;
+  TsCorrInto(lhs, rhs, window, &out);
+  return out;
+}
+
+void TsCorrInto(std::span<const double> lhs,
+                std::span<const double> rhs,
+                int window,
+                std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, lhs.size());
+  std::vector<double>& out = *out_vec;
   if (window <= 1 || lhs.size() != rhs.size()) {
-    return out;
+    return;
   }
   const std::size_t w = static_cast<std::size_t>(window);
   if (w > lhs.size()) {
-    return out;
+    return;
   }
 
-  std::vector<double> lhs_window;
-  std::vector<double> rhs_window;
-  lhs_window.reserve(w);
-  rhs_window.reserve(w);
+  // 增量滑窗：跨窗口携带和/平方和/交叉积，每次滑动 O(1) 更新，
+  // 替代原先每个窗口 O(w) 的均值/方差重算。浮点累积误差通过
+  // kRefreshInterval 次滑动后整窗重算进行约束（重算是连续内存的
+  // 顺序归约循环，编译器可自动向量化）。
+  constexpr std::size_t kRefreshInterval = 1024;
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+  double sum_xx = 0.0;
+  double sum_yy = 0.0;
+  double sum_xy = 0.0;
+  std::size_t invalid_count = 0;
+  std::size_t slides_since_refresh = 0;
+
+  const auto refresh_window = [&](std::size_t begin) {
+    sum_x = sum_y = sum_xx = sum_yy = sum_xy = 0.0;
+    invalid_count = 0;
+    for (std::size_t i = begin; i < begin + w; ++i) {
+      const double x = lhs[i];
+      const double y = rhs[i];
+      if (!IsFinite(x) || !IsFinite(y)) {
+        ++invalid_count;
+        continue;
+      }
+      sum_x += x;
+      sum_y += y;
+      sum_xx += x * x;
+      sum_yy += y * y;
+      sum_xy += x * y;
+    }
+    slides_since_refresh = 0;
+  };
 
+  refresh_window(0);
   for (std::size_t end = w - 1; end < lhs.size(); ++end) {
-    const std::size_t begin = end + 1 - w;
-    lhs_window.clear();
-    rhs_window.clear();
-    bool valid_window = true;
-    for (std::size_t i = begin; i <= end; ++i) {
-      if (!IsFinite(lhs[i]) || !IsFinite(rhs[i])) {
-        valid_window = false;
-        break;
+    if (end > w - 1) {
+      const std::size_t leaving = end - w;
+      const double lx = lhs[leaving];
+      const double ly = rhs[leaving];
+      if (!IsFinite(lx) || !IsFinite(ly)) {
+        --invalid_count;
+      } else {
+        sum_x -= lx;
+        sum_y -= ly;
+        sum_xx -= lx * lx;
+        sum_yy -= ly * ly;
+        sum_xy -= lx * ly;
+      }
+      const double ex = lhs[end];
+      const double ey = rhs[end];
+      if (!IsFinite(ex) || !IsFinite(ey)) {
+        ++invalid_count;
+      } else {
+        sum_x += ex;
+        sum_y += ey;
+        sum_xx += ex * ex;
+        sum_yy += ey * ey;
+        sum_xy += ex * ey;
+      }
+      if (++slides_since_refresh >= kRefreshInterval) {
+        refresh_window(end + 1 - w);
       }
-      lhs_window.push_back(lhs[i]);
-      rhs_window.push_back(rhs[i]);
     }
-    if (!valid_window) {
+    if (invalid_count > 0) {
+      continue;
+    }
+    const double n = static_cast<double>(w);
+    const double cov = sum_xy - sum_x * sum_y / n;
+    const double var_x = sum_xx - sum_x * sum_x / n;
+    const double var_y = sum_yy - sum_y * sum_y / n;
+    // 方差阈值按平方和的相对精度取：低于该值的"方差"只是减法的
+    // 浮点残渣，视为退化窗口（与两遍中心化算法的 var<=0 语义一致）。
+    const double eps_x = 1e-12 * sum_xx;
+    const double eps_y = 1e-12 * sum_yy;
+    if (var_x <= std::max(0.0, eps_x) || var_y <= std::max(0.0, eps_y)) {
       continue;
     }
-    out[end] = PearsonCorrelation(lhs_window, rhs_window);
+    out[end] = cov / std::sqrt(var_x * var_y);
+  }
+}
+
+namespace {
+
+// ts_min/ts_max 公共实现：单调队列（下标存于 vector，head 游标代替
+// pop_front），每个下标至多入队/出队一次，摊还 O(1)/样本。
+// take_min 为 true 时维护递增队列，否则维护递减队列。
+void SlidingExtremeInto(std::span<const double> series, int window,
+                        bool take_min, std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
+  if (window <= 0) {
+    return;
+  }
+  const std::size_t w = static_cast<std::size_t>(window);
+  if (w > series.size()) {
+    return;
+  }
+
+  std::vector<std::size_t> deque;
+  deque.reserve(series.size());
+  std::size_t head = 0;
+  std::size_t invalid_count = 0;
+
+  for (std::size_t i = 0; i < series.size(); ++i) {
+    if (i >= w && !IsFinite(series[i - w])) {
+      --invalid_count;
+    }
+    while (head < deque.size() && deque[head] + w <= i) {
+      ++head;
+    }
+    const double value = series[i];
+    if (!IsFinite(value)) {
+      ++invalid_count;
+    } else {
+      while (deque.size() > head &&
+             (take_min ? series[deque.back()] >= value
+                       : series[deque.back()] <= value)) {
+        deque.pop_back();
+      }
+      deque.push_back(i);
+    }
+    if (i + 1 >= w && invalid_count == 0 && head < deque.size()) {
+      out[i] = series[deque[head]];
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<double> TsMin(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsMinInto(series, window, &out);
+  return out;
+}
+
+void TsMinInto(std::span<const double> series, int window,
+               std::vector<double>* out) {
+  SlidingExtremeInto(series, window, /*take_min=*/true, out);
+}
+
+std::vector<double> TsMax(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsMaxInto(series, window, &out);
+  return out;
+}
+
+void TsMaxInto(std::span<const double> series, int window,
+               std::vector<double>* out) {
+  SlidingExtremeInto(series, window, /*take_min=*/false, out);
+}
+
+std::vector<double> TsSum(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsSumInto(series, window, &out);
+  return out;
+}
+
+void TsSumInto(std::span<const double> series, int window,
+               std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
+  if (window <= 0) {
+    return;
+  }
+  const std::size_t w = static_cast<std::size_t>(window);
+  if (w > series.size()) {
+    return;
+  }
+
+  // 增量滑窗携带运行和，浮点残差约束方式与 TsCorrInto 一致：
+  // 每 kRefreshInterval 次滑动后整窗重算。
+  constexpr std::size_t kRefreshInterval = 1024;
+  double sum = 0.0;
+  std::size_t invalid_count = 0;
+  std::size_t slides_since_refresh = 0;
+
+  const auto refresh_window = [&](std::size_t begin) {
+    sum = 0.0;
+    invalid_count = 0;
+    for (std::size_t i = begin; i < begin + w; ++i) {
+      const double value = series[i];
+      if (!IsFinite(value)) {
+        ++invalid_count;
+        continue;
+      }
+      sum += value;
+    }
+    slides_since_refresh = 0;
+  };
+
+  refresh_window(0);
+  for (std::size_t end = w - 1; end < series.size(); ++end) {
+    if (end > w - 1) {
+      const double leaving = series[end - w];
+      if (!IsFinite(leaving)) {
+        --invalid_count;
+      } else {
+        sum -= leaving;
+      }
+      const double entering = series[end];
+      if (!IsFinite(entering)) {
+        ++invalid_count;
+      } else {
+        sum += entering;
+      }
+      if (++slides_since_refresh >= kRefreshInterval) {
+        refresh_window(end + 1 - w);
+      }
+    }
+    if (invalid_count == 0) {
+      out[end] = sum;
+    }
+  }
+}
+
+namespace {
+
+// ts_std/ts_zscore 公共实现：携带和/平方和做 O(1) 滑动（滑窗场景需要
+// O(1) 删除旧样本，经典 Welford 不支持，故与 TsCorrInto 同构），
+// 方差残差用相对阈值判退化。compute 回调负责由矩量产出输出值。
+void SlidingMomentsInto(
+    std::span<const double> series, int window, std::vector<double>* out_vec,
+    const std::function<double(double current, double sum, double sum_sq,
+                               double n)>& compute) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
+  if (window <= 1) {
+    return;
+  }
+  const std::size_t w = static_cast<std::size_t>(window);
+  if (w > series.size()) {
+    return;
+  }
+
+  constexpr std::size_t kRefreshInterval = 1024;
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  std::size_t invalid_count = 0;
+  std::size_t slides_since_refresh = 0;
+
+  const auto refresh_window = [&](std::size_t begin) {
+    sum = sum_sq = 0.0;
+    invalid_count = 0;
+    for (std::size_t i = begin; i < begin + w; ++i) {
+      const double value = series[i];
+      if (!IsFinite(value)) {
+        ++invalid_count;
+        continue;
+      }
+      sum += value;
+      sum_sq += value * value;
+    }
+    slides_since_refresh = 0;
+  };
+
+  refresh_window(0);
+  for (std::size_t end = w - 1; end < series.size(); ++end) {
+    if (end > w - 1) {
+      const double leaving = series[end - w];
+      if (!IsFinite(leaving)) {
+        --invalid_count;
+      } else {
+        sum -= leaving;
+        sum_sq -= leaving * leaving;
+      }
+      const double entering = series[end];
+      if (!IsFinite(entering)) {
+        ++invalid_count;
+      } else {
+        sum += entering;
+        sum_sq += entering * entering;
+      }
+      if (++slides_since_refresh >= kRefreshInterval) {
+        refresh_window(end + 1 - w);
+      }
+    }
+    if (invalid_count == 0) {
+      out[end] = compute(series[end], sum, sum_sq, static_cast<double>(w));
+    }
   }
+}
+
+}  // namespace
+
+std::vector<double> TsStd(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsStdInto(series, window, &out);
+  return out;
+}
+
+void TsStdInto(std::span<const double> series, int window,
+               std::vector<double>* out) {
+  SlidingMomentsInto(series, window, out,
+                     [](double, double sum, double sum_sq, double n) {
+                       // 负方差只可能是减法的浮点残渣，钳为 0。
+                       const double var =
+                           std::max(0.0, (sum_sq - sum * sum / n) / n);
+                       return std::sqrt(var);
+                     });
+}
+
+std::vector<double> TsZscore(std::span<const double> series, int window) {
+  std::vector<double> out;
+  TsZscoreInto(series, window, &out);
   return out;
 }
 
-std::vector<double> TsRsi(const std::vector<double>& series, int period) {
-  std::vector<double> out = MakeNaNVector(series.size());
+void TsZscoreInto(std::span<const double> series, int window,
+                  std::vector<double>* out) {
+  SlidingMomentsInto(
+      series, window, out,
+      [](double current, double sum, double sum_sq, double n) {
+        // 与 TsCorrInto 相同的相对阈值：低于平方和相对精度的方差
+        // 视为退化窗口，Z 分数无意义，输出 NaN。
+        const double var_times_n = sum_sq - sum * sum / n;
+        if (var_times_n <= std::max(0.0, 1e-12 * sum_sq)) {
+          return NaN();
+        }
+        const double mean = sum / n;
+        return (current - mean) / std::sqrt(var_times_n / n);
+      });
+}
+
+std::vector<double> TsRsi(std::span<const double> series, int period) {
+  std::vector<double> out;
+  TsRsiInto(series, period, &out);
+  return out;
+}
+
+void TsRsiInto(std::span<const double> series, int period,
+               std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
   if (period <= 1) {
-    return out;
+    return;
   }
   const std::size_t p = static_cast<std::size_t>(period);
   if (series.size() <= p) {
-    return out;
+    return;
   }
 
   std::vector<double> gains(series.size(), 0.0);
@@ -215,13 +546,20 @@ std::vector<double> TsRsi(const std::vector<double>& series, int period) {
       out[i] = 100.0 - (100.0 / (1.0 + rs));
     }
   }
+}
+
+std::vector<double> TsEma(std::span<const double> series, int period) {
+  std::vector<double> out;
+  TsEmaInto(series, period, &out);
   return out;
 }
 
-std::vector<double> TsEma(const std::vector<double>& series, int period) {
-  std::vector<double> out = MakeNaNVector(series.size());
+void TsEmaInto(std::span<const double> series, int period,
+               std::vector<double>* out_vec) {
+  ResetToNaN(out_vec, series.size());
+  std::vector<double>& out = *out_vec;
   if (period <= 0) {
-    return out;
+    return;
   }
   const double alpha = 2.0 / (static_cast<double>(period) + 1.0);
   double running = NaN();
@@ -238,7 +576,6 @@ std::vector<double> TsEma(const std::vector<double>& series, int period) {
     }
     out[i] = running;
   }
-  return out;
 }
 
 }  // namespace ai_trade::research
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <vector>
 
 namespace ai_trade::research {
@@ -12,7 +13,7 @@ namespace ai_trade::research {
  * 2. 前 d 个位置因缺少历史样本返回 NaN；
  * 3. d<=0 视为无效参数，返回全 NaN。
  */
-std::vector<double> TsDelay(const std::vector<double>& series, int delay);
+std::vector<double> TsDelay(std::span<const double> series, int delay);
 
 /**
  * @brief 时序差分算子：输出 x[t]-x[t-d]
@@ -22,30 +23,65 @@ std::vector<double> TsDelay(const std::vector<double>& series, int delay);
  * 2. 任一输入无效（NaN/Inf）时输出 NaN；
  * 3. d<=0 视为无效参数，返回全 NaN。
  */
-std::vector<double> TsDelta(const std::vector<double>& series, int delay);
+std::vector<double> TsDelta(std::span<const double> series, int delay);
 
 /**
  * @brief 滚动排名算子：输出 x[t] 在窗口 [t-d+1, t] 内的分位排名
  *
  * 返回区间：[0, 1]。窗口不足或窗口内存在无效值时输出 NaN。
  */
-std::vector<double> TsRank(const std::vector<double>& series, int window);
+std::vector<double> TsRank(std::span<const double> series, int window);
 
 /**
  * @brief 滚动相关系数算子：输出 corr(x, y) over [t-d+1, t]
  *
  * 返回区间：[-1, 1]。窗口不足、窗口含无效值或方差为 0 时输出 NaN。
  */
-std::vector<double> TsCorr(const std::vector<double>& lhs,
-                           const std::vector<double>& rhs,
+std::vector<double> TsCorr(std::span<const double> lhs,
+                           std::span<const double> rhs,
                            int window);
 
+/**
+ * @brief 滚动最小值算子：输出 min(x) over [t-d+1, t]
+ *
+ * 单调队列实现，摊还 O(1)/样本。窗口不足或窗口含无效值时输出 NaN。
+ */
+std::vector<double> TsMin(std::span<const double> series, int window);
+
+/**
+ * @brief 滚动最大值算子：输出 max(x) over [t-d+1, t]
+ *
+ * 单调队列实现，摊还 O(1)/样本。窗口不足或窗口含无效值时输出 NaN。
+ */
+std::vector<double> TsMax(std::span<const double> series, int window);
+
+/**
+ * @brief 滚动求和算子：输出 sum(x) over [t-d+1, t]
+ *
+ * 增量滑窗 O(1)/样本。窗口不足或窗口含无效值时输出 NaN。
+ */
+std::vector<double> TsSum(std::span<const double> series, int window);
+
+/**
+ * @brief 滚动标准差算子：输出 std(x) over [t-d+1, t]（总体口径，除以 w）
+ *
+ * 增量滑窗 O(1)/样本。窗口不足（w<=1）或窗口含无效值时输出 NaN。
+ */
+std::vector<double> TsStd(std::span<const double> series, int window);
+
+/**
+ * @brief 滚动 Z 分数算子：输出 (x[t]-mean)/std over [t-d+1, t]
+ *
+ * 增量滑窗 O(1)/样本。窗口不足、窗口含无效值或方差退化时输出 NaN。
+ */
+std::vector<double> TsZscore(std::span<const double> series, int window);
+
 /**
  * @brief 相对强弱指数 (RSI)：基于窗口内的简单移动平均 (SMA) 计算
  *
  * 逻辑与 tools/integrator_train.py 中的 rsi 函数一致。
  */
-std::vector<double> TsRsi(const std::vector<double>& series, int period);
+std::vector<double> TsRsi(std::span<const double> series, int period);
 
 /**
  * @brief 指数移动平均 (EMA)
@@ -53,9 +89,37 @@ std::vector<double> TsRsi(const std::vector<double>& series, int period);
  * 逻辑与 tools/integrator_train.py 中的 ema 函数一致。
  * 注意：由于是在滑动窗口上计算，每次窗口移动都会重新初始化 EMA，因此窗口长度建议至少为 period 的 3-5 倍以保证收敛精度。
  */
-std::vector<double> TsEma(const std::vector<double>& series, int period);
+std::vector<double> TsEma(std::span<const double> series, int period);
 
 /// 标准有限数值判断：用于过滤 NaN/Inf。
 bool IsFinite(double value);
 
+// 以下 *Into 变体与对应的值返回版本语义完全一致，但结果写入调用方提供的
+// out 向量（只做 resize，复用已有容量）。在线求值路径按 tick 反复调用时
+// 可避免每次重新分配结果向量。
+void TsDelayInto(std::span<const double> series, int delay,
+                 std::vector<double>* out);
+void TsDeltaInto(std::span<const double> series, int delay,
+                 std::vector<double>* out);
+void TsRankInto(std::span<const double> series, int window,
+                std::vector<double>* out);
+void TsCorrInto(std::span<const double> lhs,
+                std::span<const double> rhs,
+                int window,
+                std::vector<double>* out);
+void TsMinInto(std::span<const double> series, int window,
+               std::vector<double>* out);
+void TsMaxInto(std::span<const double> series, int window,
+               std::vector<double>* out);
+void TsSumInto(std::span<const double> series, int window,
+               std::vector<double>* out);
+void TsStdInto(std::span<const double> series, int window,
+               std::vector<double>* out);
+void TsZscoreInto(std::span<const double> series, int window,
+                  std::vector<double>* out);
+void TsRsiInto(std::span<const double> series, int period,
+               std::vector<double>* out);
+void TsEmaInto(std::span<const double> series, int period,
+               std::vector<double>* out);
+
 }  // namespace ai_trade::research
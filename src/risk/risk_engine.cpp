@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "core/snapshot_io.h"
+
 namespace ai_trade {
 
 /**
@@ -63,33 +65,63 @@ RiskAdjustedPosition RiskEngine::Apply(const TargetPosition& target,
                                        bool trade_ok,
                                        double drawdown_pct,
                                        double liq_distance_pct) {
+  AccountRiskSnapshot account;
+  account.drawdown_pct = drawdown_pct;
+  account.liquidation_distance_pct = liq_distance_pct;
+  BeginRound(trade_ok, account);
+
   RiskAdjustedPosition out;
   out.symbol = target.symbol;
-  mode_ = ResolveMode(trade_ok, drawdown_pct, liq_distance_pct);
   out.risk_mode = mode_;
-  out.reduce_only = (mode_ == RiskMode::kReduceOnly ||
-                     mode_ == RiskMode::kCooldown ||
-                     mode_ == RiskMode::kFuse);
-
-  // 基础限额：先做净名义敞口绝对值裁剪（单 symbol 维度）。
-  const double capped = std::clamp(target.target_notional_usd,
-                                   -max_abs_notional_usd_,
-                                   max_abs_notional_usd_);
+  out.reduce_only = round_reduce_only_;
+  out.adjusted_notional_usd =
+      round_scale_ * std::clamp(target.target_notional_usd,
+                                -max_abs_notional_usd_,
+                                max_abs_notional_usd_);
+  return out;
+}
 
-  // 熔断/冷却：目标仓位强制归零，仅允许收敛风险。
+RiskMode RiskEngine::BeginRound(bool trade_ok,
+                                const AccountRiskSnapshot& account) {
+  mode_ = ResolveMode(trade_ok, account.drawdown_pct,
+                      account.liquidation_distance_pct);
+  round_reduce_only_ = (mode_ == RiskMode::kReduceOnly ||
+                        mode_ == RiskMode::kCooldown ||
+                        mode_ == RiskMode::kFuse);
+  // 熔断/冷却：目标仓位强制归零；降级：打 5 折降杠杆；其余全额。
   if (mode_ == RiskMode::kFuse || mode_ == RiskMode::kCooldown) {
-    out.adjusted_notional_usd = 0.0;
-    return out;
+    round_scale_ = 0.0;
+  } else if (mode_ == RiskMode::kDegraded) {
+    round_scale_ = 0.5;
+  } else {
+    round_scale_ = 1.0;
   }
-  
-  // 降级：允许交易但降杠杆，目标仓位打 5 折。
-  if (mode_ == RiskMode::kDegraded) {
-    out.adjusted_notional_usd = 0.5 * capped;
-    return out;
+  return mode_;
+}
+
+void RiskEngine::ApplyBatch(std::span<const TargetPosition> targets,
+                            std::span<RiskAdjustedPosition> out) const {
+  const std::size_t count = std::min(targets.size(), out.size());
+  for (std::size_t i = 0; i < count; ++i) {
+    // 基础限额裁剪 + 轮级缩放因子，无逐元素模式分支。
+    out[i].symbol = targets[i].symbol;
+    out[i].risk_mode = mode_;
+    out[i].reduce_only = round_reduce_only_;
+    out[i].adjusted_notional_usd =
+        round_scale_ * std::clamp(targets[i].target_notional_usd,
+                                  -max_abs_notional_usd_,
+                                  max_abs_notional_usd_);
   }
+}
 
-  out.adjusted_notional_usd = capped;
-  return out;
+void RiskEngine::SaveState(SnapshotWriter* writer) const {
+  writer->Field(mode_);
+  writer->Field(forced_reduce_only_);
+}
+
+void RiskEngine::LoadState(SnapshotReader* reader) {
+  reader->Field(mode_);
+  reader->Field(forced_reduce_only_);
 }
 
 }  // namespace ai_trade
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <span>
+
 #include "core/types.h"
 
 namespace ai_trade {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /**
  * @brief 风控引擎 (Risk Engine)
  *
@@ -36,9 +41,33 @@ class RiskEngine {
                              double drawdown_pct,
                              double liq_distance_pct = 1.0);
 
+  /**
+   * @brief 决策轮开始：从账户聚合快照解析一次风险模式
+   *
+   * 账户级量（回撤、强平距离）整轮共享，状态机转移与 reduce-only /
+   * 仓位缩放因子在此定死，随后 `ApplyBatch` 的逐 symbol 修正不再
+   * 含任何模式分支。
+   */
+  RiskMode BeginRound(bool trade_ok, const AccountRiskSnapshot& account);
+
+  /**
+   * @brief 对整批目标仓位做一次连续内存修正（须先调用 BeginRound）
+   *
+   * 循环体只有敞口裁剪与缩放乘法，模式判定已在轮前完成；
+   * 输出按 `targets` 下标一一对应写入，超出 `out` 容量的目标被忽略。
+   */
+  void ApplyBatch(std::span<const TargetPosition> targets,
+                  std::span<RiskAdjustedPosition> out) const;
+
   void SetForcedReduceOnly(bool enabled) { forced_reduce_only_ = enabled; }
   RiskMode mode() const { return mode_; }
 
+  /// 把状态机运行态（模式滞回 + 强制减仓开关）写入二进制快照；
+  /// 阈值与敞口上限来自配置，不入快照。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复状态机运行态。
+  void LoadState(SnapshotReader* reader);
+
  private:
   RiskMode ResolveMode(bool trade_ok, double drawdown_pct, double liq_distance_pct);
 
@@ -46,6 +75,8 @@ class RiskEngine {
   RiskThresholds thresholds_{};  ///< 回撤与强平距离阈值集合。
   RiskMode mode_{RiskMode::kNormal};  ///< 当前风险状态机模式。
   bool forced_reduce_only_{false};  ///< 外部硬开关：强制只减仓（reduce-only）。
+  double round_scale_{1.0};  ///< 本轮仓位缩放因子（Normal=1.0 / Degraded=0.5 / 熔断冷却=0.0）。
+  bool round_reduce_only_{false};  ///< 本轮 reduce-only 判定（随 BeginRound 缓存）。
 };
 
 }  // namespace ai_trade
@@ -0,0 +1,282 @@
+#include "storage/decision_journal.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#include "core/line_writer.h"
+
+namespace ai_trade {
+
+namespace {
+
+constexpr std::int64_t kDefaultRotateBytes = 64LL * 1024 * 1024;
+
+/// 文件头：magic + version，各 4 字节。
+struct JournalFileHeader {
+  std::uint32_t magic{kDecisionJournalMagic};
+  std::uint32_t version{kDecisionJournalVersion};
+};
+
+std::int64_t CurrentEpochMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+int ClampDirection(int direction) {
+  if (direction > 0) return 1;
+  if (direction < 0) return -1;
+  return 0;
+}
+
+const char* RiskModeName(std::uint8_t mode) {
+  switch (static_cast<RiskMode>(mode)) {
+    case RiskMode::kNormal: return "NORMAL";
+    case RiskMode::kDegraded: return "DEGRADED";
+    case RiskMode::kCooldown: return "COOLDOWN";
+    case RiskMode::kFuse: return "FUSE";
+    case RiskMode::kReduceOnly: return "REDUCE_ONLY";
+  }
+  return "UNKNOWN";
+}
+
+const char* OrderPurposeName(std::uint8_t purpose) {
+  switch (static_cast<OrderPurpose>(purpose)) {
+    case OrderPurpose::kEntry: return "ENTRY";
+    case OrderPurpose::kTp: return "TP";
+    case OrderPurpose::kSl: return "SL";
+    case OrderPurpose::kReduce: return "REDUCE";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace
+
+DecisionJournal::DecisionJournal(std::string dir, std::int64_t rotate_bytes)
+    : dir_(std::move(dir)),
+      rotate_bytes_(rotate_bytes > 0 ? rotate_bytes : kDefaultRotateBytes) {}
+
+DecisionJournal::~DecisionJournal() { Close(); }
+
+bool DecisionJournal::Initialize(std::string* out_error) {
+  if (dir_.empty()) {
+    if (out_error != nullptr) {
+      *out_error = "决策日志目录为空";
+    }
+    return false;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    if (out_error != nullptr) {
+      *out_error = "无法创建决策日志目录: " + dir_ + " (" + ec.message() + ")";
+    }
+    return false;
+  }
+  return OpenNewFile(out_error);
+}
+
+bool DecisionJournal::OpenNewFile(std::string* out_error) {
+  Close();
+  // 文件名带进程内序号：同一毫秒内多次滚动也不会互相覆盖。
+  current_file_ = dir_ + "/decisions-" + std::to_string(CurrentEpochMs()) +
+                  "-" + std::to_string(file_seq_++) + ".dj";
+  file_ = std::fopen(current_file_.c_str(), "wb");
+  if (file_ == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开决策日志文件: " + current_file_;
+    }
+    return false;
+  }
+  JournalFileHeader header;
+  if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+    if (out_error != nullptr) {
+      *out_error = "决策日志文件头写入失败: " + current_file_;
+    }
+    Close();
+    return false;
+  }
+  current_bytes_ = static_cast<std::int64_t>(sizeof(header));
+  return true;
+}
+
+void DecisionJournal::FillRecord(const MarketEvent& event,
+                                 const MarketDecision& decision,
+                                 DecisionJournalRecord* out_record) {
+  DecisionJournalRecord& record = *out_record;
+  record = DecisionJournalRecord{};
+  record.ts_ms = event.ts_ms;
+  std::strncpy(record.symbol, event.symbol.c_str(), sizeof(record.symbol) - 1);
+  record.price = event.price;
+  record.regime = static_cast<std::uint8_t>(decision.regime.regime);
+  record.bucket = static_cast<std::uint8_t>(decision.regime.bucket);
+  record.warmup = decision.regime.warmup ? 1 : 0;
+  record.risk_mode = static_cast<std::uint8_t>(decision.risk_adjusted.risk_mode);
+  record.reduce_only = decision.risk_adjusted.reduce_only ? 1 : 0;
+  record.base_direction =
+      static_cast<std::int8_t>(ClampDirection(decision.base_signal.direction));
+  record.final_direction =
+      static_cast<std::int8_t>(ClampDirection(decision.signal.direction));
+  record.has_intent = decision.intent.has_value() ? 1 : 0;
+  record.instant_return = decision.regime.instant_return;
+  record.trend_strength = decision.regime.trend_strength;
+  record.volatility_level = decision.regime.volatility_level;
+  record.base_confidence = decision.base_signal.confidence;
+  record.base_notional_usd = decision.base_signal.suggested_notional_usd;
+  record.trend_notional_usd = decision.base_signal.trend_notional_usd;
+  record.defensive_notional_usd = decision.base_signal.defensive_notional_usd;
+  record.final_notional_usd = decision.signal.suggested_notional_usd;
+  record.adjusted_notional_usd = decision.risk_adjusted.adjusted_notional_usd;
+  record.reason_mask = decision.signal.reason_mask;
+  if (decision.intent.has_value()) {
+    record.intent_direction =
+        static_cast<std::int8_t>(ClampDirection(decision.intent->direction));
+    record.intent_purpose = static_cast<std::uint8_t>(decision.intent->purpose);
+    record.intent_reduce_only = decision.intent->reduce_only ? 1 : 0;
+    record.intent_qty = decision.intent->qty;
+    record.intent_price = decision.intent->price;
+  }
+}
+
+bool DecisionJournal::Append(const MarketEvent& event,
+                             const MarketDecision& decision,
+                             std::string* out_error) {
+  if (file_ == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "决策日志未初始化";
+    }
+    return false;
+  }
+  if (current_bytes_ + static_cast<std::int64_t>(sizeof(DecisionJournalRecord)) >
+      rotate_bytes_) {
+    if (!OpenNewFile(out_error)) {
+      return false;
+    }
+  }
+  DecisionJournalRecord record;
+  FillRecord(event, decision, &record);
+  if (std::fwrite(&record, sizeof(record), 1, file_) != 1) {
+    if (out_error != nullptr) {
+      *out_error = "决策日志记录写入失败: " + current_file_;
+    }
+    return false;
+  }
+  current_bytes_ += static_cast<std::int64_t>(sizeof(record));
+  ++appended_records_;
+  return true;
+}
+
+bool DecisionJournal::Flush(std::string* out_error) {
+  if (file_ == nullptr) {
+    return true;
+  }
+  if (std::fflush(file_) != 0) {
+    if (out_error != nullptr) {
+      *out_error = "决策日志刷盘失败: " + current_file_;
+    }
+    return false;
+  }
+  return true;
+}
+
+void DecisionJournal::Close() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  current_bytes_ = 0;
+}
+
+bool DecisionJournal::ReadFile(const std::string& file_path,
+                               std::vector<DecisionJournalRecord>* out_records,
+                               std::string* out_error) {
+  std::FILE* file = std::fopen(file_path.c_str(), "rb");
+  if (file == nullptr) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开决策日志文件: " + file_path;
+    }
+    return false;
+  }
+  JournalFileHeader header{0, 0};
+  if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != kDecisionJournalMagic) {
+    std::fclose(file);
+    if (out_error != nullptr) {
+      *out_error = "决策日志文件头非法: " + file_path;
+    }
+    return false;
+  }
+  if (header.version != kDecisionJournalVersion) {
+    std::fclose(file);
+    if (out_error != nullptr) {
+      *out_error = "决策日志版本不兼容: " + file_path +
+                   " (version=" + std::to_string(header.version) + ")";
+    }
+    return false;
+  }
+  DecisionJournalRecord record;
+  // 尾部不足整条的残留（进程中断）按截断丢弃，不视为错误。
+  while (std::fread(&record, sizeof(record), 1, file) == 1) {
+    out_records->push_back(record);
+  }
+  std::fclose(file);
+  return true;
+}
+
+std::string DecisionJournal::ToJsonLine(const DecisionJournalRecord& record) {
+  LineWriter writer(512);
+  writer.Append("{\"ts_ms\":").AppendInt(record.ts_ms);
+  std::size_t symbol_len = 0;
+  while (symbol_len < sizeof(record.symbol) &&
+         record.symbol[symbol_len] != '\0') {
+    ++symbol_len;
+  }
+  writer.Append(",\"symbol\":\"");
+  writer.AppendJsonEscaped(std::string_view(record.symbol, symbol_len));
+  writer.Append("\",\"price\":").AppendDouble(record.price);
+  writer.Append(",\"regime\":\"")
+      .Append(ToString(static_cast<Regime>(record.regime)))
+      .Append("\",\"bucket\":\"")
+      .Append(ToString(static_cast<RegimeBucket>(record.bucket)))
+      .Append("\",\"warmup\":")
+      .AppendBool(record.warmup != 0);
+  writer.Append(",\"instant_return\":").AppendDouble(record.instant_return);
+  writer.Append(",\"trend_strength\":").AppendDouble(record.trend_strength);
+  writer.Append(",\"volatility_level\":").AppendDouble(record.volatility_level);
+  writer.Append(",\"base_direction\":")
+      .AppendInt(record.base_direction);
+  writer.Append(",\"base_confidence\":").AppendDouble(record.base_confidence);
+  writer.Append(",\"base_notional_usd\":").AppendDouble(record.base_notional_usd);
+  writer.Append(",\"trend_notional_usd\":")
+      .AppendDouble(record.trend_notional_usd);
+  writer.Append(",\"defensive_notional_usd\":")
+      .AppendDouble(record.defensive_notional_usd);
+  writer.Append(",\"final_direction\":").AppendInt(record.final_direction);
+  writer.Append(",\"final_notional_usd\":")
+      .AppendDouble(record.final_notional_usd);
+  writer.Append(",\"risk_mode\":\"")
+      .Append(RiskModeName(record.risk_mode))
+      .Append("\",\"reduce_only\":")
+      .AppendBool(record.reduce_only != 0);
+  writer.Append(",\"adjusted_notional_usd\":")
+      .AppendDouble(record.adjusted_notional_usd);
+  writer.Append(",\"reason_mask\":").AppendInt(
+      static_cast<std::int64_t>(record.reason_mask));
+  writer.Append(",\"has_intent\":").AppendBool(record.has_intent != 0);
+  if (record.has_intent != 0) {
+    writer.Append(",\"intent\":{\"direction\":")
+        .AppendInt(record.intent_direction);
+    writer.Append(",\"purpose\":\"")
+        .Append(OrderPurposeName(record.intent_purpose))
+        .Append("\",\"reduce_only\":")
+        .AppendBool(record.intent_reduce_only != 0);
+    writer.Append(",\"qty\":").AppendDouble(record.intent_qty);
+    writer.Append(",\"price\":").AppendDouble(record.intent_price);
+    writer.Append('}');
+  }
+  writer.Append('}');
+  return writer.TakeString();
+}
+
+}  // namespace ai_trade
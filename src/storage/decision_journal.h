@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "core/types.h"
+#include "system/trade_system.h"
+
+namespace ai_trade {
+
+/// 决策日志单条二进制记录（定长、packed、小端主机序）。
+/// 布局即磁盘格式：任何字段增删都必须提升 `kDecisionJournalVersion`。
+#pragma pack(push, 1)
+struct DecisionJournalRecord {
+  std::int64_t ts_ms{0};          ///< 行情事件时间戳。
+  char symbol[16]{};              ///< symbol（NUL 填充，超长截断）。
+  double price{0.0};              ///< 事件成交价。
+  std::uint8_t regime{0};         ///< Regime（enum 底层值）。
+  std::uint8_t bucket{0};         ///< RegimeBucket。
+  std::uint8_t warmup{0};         ///< Regime 是否仍处 warmup。
+  std::uint8_t risk_mode{0};      ///< 风控状态机模式。
+  std::uint8_t reduce_only{0};    ///< 风控 reduce-only 判定。
+  std::int8_t base_direction{0};  ///< 基础信号方向 (-1/0/1)。
+  std::int8_t final_direction{0}; ///< Integrator 后最终信号方向。
+  std::uint8_t has_intent{0};     ///< 是否生成订单意图。
+  double instant_return{0.0};     ///< Regime 即时收益率。
+  double trend_strength{0.0};     ///< Regime 趋势强度。
+  double volatility_level{0.0};   ///< Regime 波动水平。
+  double base_confidence{0.0};    ///< 基础信号置信度。
+  double base_notional_usd{0.0};  ///< 基础信号建议名义值。
+  double trend_notional_usd{0.0};       ///< 趋势分支名义值。
+  double defensive_notional_usd{0.0};   ///< 防御分支名义值。
+  double final_notional_usd{0.0};       ///< 最终信号建议名义值。
+  double adjusted_notional_usd{0.0};    ///< 风控修正后目标名义值。
+  std::uint64_t reason_mask{0};   ///< 信号 reason code 位掩码。
+  std::int8_t intent_direction{0};      ///< 意图方向（无意图为 0）。
+  std::uint8_t intent_purpose{0};       ///< 意图用途（OrderPurpose）。
+  std::uint8_t intent_reduce_only{0};   ///< 意图是否 reduce-only。
+  std::uint8_t reserved[5]{};     ///< 对齐保留位（写 0）。
+  double intent_qty{0.0};         ///< 意图数量。
+  double intent_price{0.0};       ///< 意图限价。
+};
+#pragma pack(pop)
+
+inline constexpr std::uint32_t kDecisionJournalMagic = 0x4A445441;  // "ATDJ"
+inline constexpr std::uint32_t kDecisionJournalVersion = 1;
+
+/**
+ * @brief 二进制追加式决策日志（按大小滚动）
+ *
+ * 文本决策日志逐条走 string 拼接 + 行解析，热路径写入与离线回读都偏慢。
+ * 本组件把每个决策编码为定长 `DecisionJournalRecord`，单次缓冲写追加到
+ * `<dir>/decisions-<epoch_ms>.dj`；当前文件超过滚动阈值后切换新文件。
+ * 写入走 stdio 缓冲，崩溃最多丢尾部一个缓冲区（决策日志为审计口径，
+ * 不承担 WAL 的恢复职责）。离线解码由 `trade_journal_dump` 完成。
+ */
+class DecisionJournal {
+ public:
+  /// @param dir 日志目录；@param rotate_bytes 单文件滚动阈值（<=0 用默认 64 MiB）。
+  DecisionJournal(std::string dir, std::int64_t rotate_bytes);
+  ~DecisionJournal();
+
+  DecisionJournal(const DecisionJournal&) = delete;
+  DecisionJournal& operator=(const DecisionJournal&) = delete;
+
+  /// 确保目录存在并打开首个日志文件。
+  bool Initialize(std::string* out_error);
+
+  /// 追加一条决策记录（单次缓冲写；超过阈值先滚动再写）。
+  bool Append(const MarketEvent& event, const MarketDecision& decision,
+              std::string* out_error);
+
+  /// 把 stdio 缓冲刷到内核（周期性调用，不在每条记录后调用）。
+  bool Flush(std::string* out_error);
+
+  /// 关闭当前文件（析构亦会调用）。
+  void Close();
+
+  const std::string& current_file() const { return current_file_; }
+  std::uint64_t appended_records() const { return appended_records_; }
+
+  /// 由决策上下文填充定长记录（编码与解码共用的唯一布局入口）。
+  static void FillRecord(const MarketEvent& event,
+                         const MarketDecision& decision,
+                         DecisionJournalRecord* out_record);
+
+  /// 离线解码：校验文件头后读出全部记录；损坏的尾部记录被丢弃。
+  static bool ReadFile(const std::string& file_path,
+                       std::vector<DecisionJournalRecord>* out_records,
+                       std::string* out_error);
+
+  /// 把单条记录编码为一行 JSON（下游工具按 JSONL 消费）。
+  static std::string ToJsonLine(const DecisionJournalRecord& record);
+
+ private:
+  bool OpenNewFile(std::string* out_error);
+
+  std::string dir_;             ///< 日志目录。
+  std::int64_t rotate_bytes_;   ///< 单文件滚动阈值（字节）。
+  std::string current_file_;    ///< 当前日志文件路径。
+  std::FILE* file_{nullptr};    ///< stdio 句柄（缓冲写）。
+  std::int64_t current_bytes_{0};       ///< 当前文件已写字节数。
+  std::uint64_t appended_records_{0};   ///< 进程内累计追加记录数。
+  std::uint64_t file_seq_{0};           ///< 进程内文件序号（防同毫秒滚动重名）。
+};
+
+}  // namespace ai_trade
@@ -0,0 +1,135 @@
+#include "storage/state_snapshot.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include "core/config_cache.h"
+#include "core/snapshot_io.h"
+#include "system/trade_system.h"
+
+namespace ai_trade {
+
+namespace {
+
+// 快照文件头：magic + 格式版本 + 载荷哈希。版本在任一引擎的
+// SaveState/LoadState 字段清单变更时递增；哈希（FNV-1a，与配置缓存
+// 同款）保证损坏快照在触碰内存状态前被整体拒绝。
+constexpr std::uint32_t kStateSnapshotMagic = 0x53535441;  // "ATSS"
+constexpr std::uint32_t kStateSnapshotVersion = 1;
+
+struct StateSnapshotHeader {
+  std::uint32_t magic{0};
+  std::uint32_t version{0};
+  std::uint64_t payload_hash{0};
+};
+
+}  // namespace
+
+bool SaveStateSnapshot(const std::string& file_path,
+                       const TradeSystem& system,
+                       const std::unordered_set<std::string>& applied_fill_ids,
+                       std::string* out_error) {
+  SnapshotWriter writer;
+  writer.Field(applied_fill_ids);
+  system.SerializeState(&writer);
+
+  StateSnapshotHeader header;
+  header.magic = kStateSnapshotMagic;
+  header.version = kStateSnapshotVersion;
+  header.payload_hash = HashConfigSource(writer.buffer());
+
+  // 临时文件 + rename 原子替换：任意时刻目标路径要么是完整旧快照、
+  // 要么是完整新快照。
+  const std::string tmp_path = file_path + ".tmp";
+  {
+    std::ofstream output(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+      if (out_error != nullptr) {
+        *out_error = "无法创建快照临时文件: " + tmp_path;
+      }
+      return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(writer.buffer().data(),
+                 static_cast<std::streamsize>(writer.buffer().size()));
+    if (!output.good()) {
+      if (out_error != nullptr) {
+        *out_error = "快照临时文件写入失败: " + tmp_path;
+      }
+      return false;
+    }
+  }
+
+  std::error_code rename_error;
+  std::filesystem::rename(tmp_path, file_path, rename_error);
+  if (rename_error) {
+    if (out_error != nullptr) {
+      *out_error = "快照原子替换失败: " + rename_error.message();
+    }
+    return false;
+  }
+  return true;
+}
+
+bool LoadStateSnapshot(const std::string& file_path,
+                       TradeSystem* system,
+                       std::unordered_set<std::string>* out_applied_fill_ids,
+                       std::string* out_error) {
+  std::ifstream input(file_path, std::ios::binary);
+  if (!input.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "快照文件不存在: " + file_path;
+    }
+    return false;
+  }
+  const std::string contents((std::istreambuf_iterator<char>(input)),
+                             std::istreambuf_iterator<char>());
+  if (contents.size() < sizeof(StateSnapshotHeader)) {
+    if (out_error != nullptr) {
+      *out_error = "快照文件过短";
+    }
+    return false;
+  }
+  StateSnapshotHeader header;
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kStateSnapshotMagic) {
+    if (out_error != nullptr) {
+      *out_error = "快照 magic 不符";
+    }
+    return false;
+  }
+  if (header.version != kStateSnapshotVersion) {
+    if (out_error != nullptr) {
+      *out_error = "快照格式版本不符: " + std::to_string(header.version);
+    }
+    return false;
+  }
+  const std::string_view payload =
+      std::string_view(contents).substr(sizeof(StateSnapshotHeader));
+  if (header.payload_hash != HashConfigSource(payload)) {
+    if (out_error != nullptr) {
+      *out_error = "快照载荷哈希不符（文件损坏）";
+    }
+    return false;
+  }
+
+  SnapshotReader reader(payload);
+  std::unordered_set<std::string> applied_fill_ids;
+  reader.Field(applied_fill_ids);
+  if (!system->RestoreState(&reader) || !reader.fully_consumed()) {
+    if (out_error != nullptr) {
+      *out_error = "快照载荷解析失败";
+    }
+    return false;
+  }
+  if (out_applied_fill_ids != nullptr) {
+    *out_applied_fill_ids = std::move(applied_fill_ids);
+  }
+  return true;
+}
+
+}  // namespace ai_trade
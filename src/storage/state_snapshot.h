@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+namespace ai_trade {
+
+class TradeSystem;
+
+/**
+ * @brief TradeSystem 状态快照落盘/恢复
+ *
+ * 语义：
+ * 1. 快照包含 TradeSystem 完整运行态 + 已计入快照的 WAL 成交 id 集合，
+ *    重启时只需回放快照之后的 WAL 尾部即可恢复到交易就绪；
+ * 2. 写入走临时文件 + rename 原子替换，崩溃不会留下半截快照；
+ * 3. 头部带格式版本与载荷哈希，损坏/过期快照在触碰内存状态前被拒绝。
+ */
+
+/// 把系统运行态与已应用成交 id 写为二进制快照（原子替换目标文件）。
+bool SaveStateSnapshot(const std::string& file_path,
+                       const TradeSystem& system,
+                       const std::unordered_set<std::string>& applied_fill_ids,
+                       std::string* out_error);
+
+/// 从快照恢复系统运行态；`out_applied_fill_ids` 用于 WAL 尾部去重。
+/// 文件缺失/版本不符/哈希不符时返回 false 且不修改系统状态。
+bool LoadStateSnapshot(const std::string& file_path,
+                       TradeSystem* system,
+                       std::unordered_set<std::string>* out_applied_fill_ids,
+                       std::string* out_error);
+
+}  // namespace ai_trade
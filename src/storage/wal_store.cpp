@@ -1,57 +1,181 @@
 #include "storage/wal_store.h"
 
-#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ai_trade {
 
 namespace {
 
-std::string SerializeIntent(const OrderIntent& order) {
-  // 文本 WAL 格式：字段顺序固定，便于版本兼容与人工排障。
-  std::ostringstream oss;
-  oss << "INTENT"
-      << '\t'
-      << order.client_order_id
-      << '\t'
-      << order.symbol
-      << '\t'
-      << static_cast<int>(order.purpose)
-      << '\t'
-      << static_cast<int>(order.liquidity_preference)
-      << '\t'
-      << (order.reduce_only ? 1 : 0)
-      << '\t'
-      << order.direction
-      << '\t'
-      << order.qty
-      << '\t'
-      << order.price;
-  return oss.str();
-}
-
-std::string SerializeFillV2(const FillEvent& fill) {
-  // V2 显式存储 fill_id，解决旧格式无法稳定去重的问题。
-  std::ostringstream oss;
-  oss << "FILL2"
-      << '\t'
-      << fill.fill_id
-      << '\t'
-      << fill.client_order_id
-      << '\t'
-      << fill.symbol
-      << '\t'
-      << fill.direction
-      << '\t'
-      << fill.qty
-      << '\t'
-      << fill.price
-      << '\t'
-      << fill.fee;
-  return oss.str();
+// 二进制记录帧：哨兵字节 0x01 不可能出现在历史文本行行首，恢复路径
+// 据此区分两种格式。数值按宿主字节序原样存取（本机生成本机消费，
+// 与 config_cache 同一取舍）。
+constexpr unsigned char kRecordSentinel = 0x01;
+constexpr unsigned char kRecordTypeIntent = 1;
+constexpr unsigned char kRecordTypeFill = 2;
+// 快照压实产物：意图折叠后只剩 client_order_id（恢复只用 id 去重）。
+constexpr unsigned char kRecordTypeIntentId = 3;
+constexpr std::size_t kRecordHeaderSize = 16;
+
+// 组提交阈值：缓冲达到字节数或距上次落盘超过时间窗即触发 write+sync；
+// 有耐久性等待方时立即触发。
+constexpr std::size_t kFlushBytesThreshold = 64 * 1024;
+constexpr int kFlushIntervalMs = 5;
+
+std::uint64_t Fnv1a64(const char* data, std::size_t size) {
+  constexpr std::uint64_t kOffset = 1469598103934665603ULL;
+  constexpr std::uint64_t kPrime = 1099511628211ULL;
+  std::uint64_t hash = kOffset;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= kPrime;
+  }
+  return hash;
+}
+
+template <typename T>
+void AppendPod(std::string* out, T value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendLpString(std::string* out, const std::string& text) {
+  AppendPod(out, static_cast<std::uint32_t>(text.size()));
+  out->append(text);
+}
+
+template <typename T>
+bool ReadPod(std::string_view data, std::size_t* cursor, T* out_value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  if (*cursor + sizeof(T) > data.size()) {
+    return false;
+  }
+  std::memcpy(out_value, data.data() + *cursor, sizeof(T));
+  *cursor += sizeof(T);
+  return true;
+}
+
+// 就地切片读取：string_view 指向映射区，只有落入输出结构时才拷贝。
+bool ReadLpString(std::string_view data,
+                  std::size_t* cursor,
+                  std::string* out_text) {
+  std::uint32_t size = 0;
+  if (!ReadPod(data, cursor, &size) || *cursor + size > data.size()) {
+    return false;
+  }
+  out_text->assign(data.data() + *cursor, size);
+  *cursor += size;
+  return true;
+}
+
+std::string SerializeRecord(unsigned char type, const std::string& payload) {
+  std::string record;
+  record.reserve(kRecordHeaderSize + payload.size());
+  record.push_back(static_cast<char>(kRecordSentinel));
+  record.push_back(static_cast<char>(type));
+  AppendPod(&record, static_cast<std::uint16_t>(0));
+  AppendPod(&record, static_cast<std::uint32_t>(payload.size()));
+  AppendPod(&record, Fnv1a64(payload.data(), payload.size()));
+  record.append(payload);
+  return record;
+}
+
+std::string SerializeIntentRecord(const OrderIntent& order) {
+  std::string payload;
+  payload.reserve(64);
+  AppendLpString(&payload, order.client_order_id);
+  AppendLpString(&payload, order.symbol);
+  AppendPod(&payload, static_cast<std::int32_t>(order.purpose));
+  AppendPod(&payload, static_cast<std::int32_t>(order.liquidity_preference));
+  AppendPod(&payload, static_cast<std::uint8_t>(order.reduce_only ? 1 : 0));
+  AppendPod(&payload, static_cast<std::int32_t>(order.direction));
+  AppendPod(&payload, static_cast<double>(order.qty));
+  AppendPod(&payload, static_cast<double>(order.price));
+  return SerializeRecord(kRecordTypeIntent, payload);
+}
+
+std::string SerializeIntentIdRecord(const std::string& client_order_id) {
+  std::string payload;
+  payload.reserve(client_order_id.size() + 4);
+  AppendLpString(&payload, client_order_id);
+  return SerializeRecord(kRecordTypeIntentId, payload);
+}
+
+std::string SerializeFillRecord(const FillEvent& fill) {
+  std::string payload;
+  payload.reserve(80);
+  AppendLpString(&payload, fill.fill_id);
+  AppendLpString(&payload, fill.client_order_id);
+  AppendLpString(&payload, fill.symbol);
+  AppendPod(&payload, static_cast<std::int32_t>(fill.direction));
+  AppendPod(&payload, static_cast<double>(fill.qty));
+  AppendPod(&payload, static_cast<double>(fill.price));
+  AppendPod(&payload, static_cast<double>(fill.fee));
+  return SerializeRecord(kRecordTypeFill, payload);
+}
+
+bool ParseIntentPayload(std::string_view payload, OrderIntent* out_intent) {
+  std::size_t cursor = 0;
+  std::int32_t purpose = 0;
+  std::int32_t liquidity_preference = 0;
+  std::uint8_t reduce_only = 0;
+  std::int32_t direction = 0;
+  if (!ReadLpString(payload, &cursor, &out_intent->client_order_id) ||
+      !ReadLpString(payload, &cursor, &out_intent->symbol) ||
+      !ReadPod(payload, &cursor, &purpose) ||
+      !ReadPod(payload, &cursor, &liquidity_preference) ||
+      !ReadPod(payload, &cursor, &reduce_only) ||
+      !ReadPod(payload, &cursor, &direction) ||
+      !ReadPod(payload, &cursor, &out_intent->qty) ||
+      !ReadPod(payload, &cursor, &out_intent->price) ||
+      cursor != payload.size()) {
+    return false;
+  }
+  if (liquidity_preference < static_cast<int>(LiquidityPreference::kAuto) ||
+      liquidity_preference > static_cast<int>(LiquidityPreference::kTaker)) {
+    return false;
+  }
+  out_intent->purpose = static_cast<OrderPurpose>(purpose);
+  out_intent->liquidity_preference =
+      static_cast<LiquidityPreference>(liquidity_preference);
+  out_intent->reduce_only = reduce_only != 0;
+  out_intent->direction = direction;
+  return true;
+}
+
+// 直接解析进调用方槽位（配合 emplace_back 免去中间拷贝）。
+bool ParseFillPayload(std::string_view payload, FillEvent* out_fill) {
+  std::size_t cursor = 0;
+  std::int32_t direction = 0;
+  if (!ReadLpString(payload, &cursor, &out_fill->fill_id) ||
+      !ReadLpString(payload, &cursor, &out_fill->client_order_id) ||
+      !ReadLpString(payload, &cursor, &out_fill->symbol) ||
+      !ReadPod(payload, &cursor, &direction) ||
+      !ReadPod(payload, &cursor, &out_fill->qty) ||
+      !ReadPod(payload, &cursor, &out_fill->price) ||
+      !ReadPod(payload, &cursor, &out_fill->fee) || cursor != payload.size()) {
+    return false;
+  }
+  out_fill->direction = direction;
+  return true;
 }
 
 std::vector<std::string> SplitTab(const std::string& line) {
@@ -188,9 +312,48 @@ bool ParseLegacyFillV1(const std::vector<std::string>& fields,
   return true;
 }
 
+std::string SegmentName(const std::string& base, std::uint64_t seq) {
+  char suffix[24];
+  std::snprintf(suffix, sizeof(suffix), ".seg-%06llu",
+                static_cast<unsigned long long>(seq));
+  return base + suffix;
+}
+
+/// 扫描既有段（含归档）得到下一个段序号，保证重启后段名单调递增。
+std::uint64_t ScanNextSegmentSeq(const std::string& base) {
+  const std::filesystem::path path(base);
+  const std::string prefix = path.filename().string() + ".seg-";
+  std::uint64_t next_seq = 1;
+  std::error_code ec;
+  const auto parent = path.parent_path().empty()
+                          ? std::filesystem::path(".")
+                          : path.parent_path();
+  for (const auto& entry :
+       std::filesystem::directory_iterator(parent, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind(prefix, 0) != 0) {
+      continue;
+    }
+    const std::uint64_t seq =
+        std::strtoull(name.c_str() + prefix.size(), nullptr, 10);
+    if (seq >= next_seq) {
+      next_seq = seq + 1;
+    }
+  }
+  return next_seq;
+}
+
 }  // namespace
 
-bool WalStore::Initialize(std::string* out_error) const {
+WalStore::~WalStore() {
+  StopFlusher();
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool WalStore::Initialize(std::string* out_error) {
   const std::filesystem::path path(file_path_);
   const auto parent = path.parent_path();
   std::error_code ec;
@@ -204,49 +367,312 @@ bool WalStore::Initialize(std::string* out_error) const {
     }
   }
 
-  std::ofstream out(file_path_, std::ios::app);
-  if (!out.is_open()) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return EnsureOpenLocked(out_error);
+}
+
+bool WalStore::EnsureOpenLocked(std::string* out_error) {
+  if (fd_ >= 0) {
+    return true;
+  }
+  fd_ = ::open(file_path_.c_str(), O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
     if (out_error != nullptr) {
       *out_error = "创建/打开 WAL 文件失败: " + file_path_;
     }
     return false;
   }
+  std::error_code ec;
+  const auto existing_size = std::filesystem::file_size(file_path_, ec);
+  active_size_ = ec ? 0 : static_cast<std::int64_t>(existing_size);
+  next_segment_seq_ = ScanNextSegmentSeq(file_path_);
+  if (!flusher_thread_.joinable()) {
+    stop_ = false;
+    flusher_thread_ = std::thread([this] { RunFlusher(); });
+  }
   return true;
 }
 
-bool WalStore::AppendLine(const std::string& line, std::string* out_error) const {
-  std::ofstream out(file_path_, std::ios::app);
-  if (!out.is_open()) {
+bool WalStore::AppendIntent(const OrderIntent& intent, std::string* out_error) {
+  // 入场意图创建新敞口，提交路径必须拿到耐久性确认；其余意图
+  // （保护/减仓等恢复时仅用于去重）与成交一样自由攒批。
+  const bool await_durable = intent.purpose == OrderPurpose::kEntry;
+  return EnqueueRecord(SerializeIntentRecord(intent), await_durable, out_error);
+}
+
+bool WalStore::AppendFill(const FillEvent& fill, std::string* out_error) {
+  return EnqueueRecord(SerializeFillRecord(fill), /*await_durable=*/false,
+                       out_error);
+}
+
+bool WalStore::EnqueueRecord(std::string record,
+                             bool await_durable,
+                             std::string* out_error) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!EnsureOpenLocked(out_error)) {
+    return false;
+  }
+  if (!flush_error_.empty()) {
     if (out_error != nullptr) {
-      *out_error = "WAL 打开失败: " + file_path_;
+      *out_error = flush_error_;
     }
     return false;
   }
 
-  out << line << '\n';
-  out.flush();
-  if (!out.good()) {
+  buffer_.append(record);
+  const std::uint64_t my_seq = ++appended_seq_;
+  if (await_durable) {
+    sync_requested_ = true;
+    flush_cv_.notify_one();
+    return AwaitDurableLocked(&lock, my_seq, out_error);
+  }
+  if (buffer_.size() >= kFlushBytesThreshold) {
+    flush_cv_.notify_one();
+  }
+  return true;
+}
+
+bool WalStore::Flush(std::string* out_error) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!flush_error_.empty()) {
     if (out_error != nullptr) {
-      *out_error = "WAL 写入失败";
+      *out_error = flush_error_;
+    }
+    return false;
+  }
+  if (durable_seq_ >= appended_seq_) {
+    return true;
+  }
+  sync_requested_ = true;
+  flush_cv_.notify_one();
+  return AwaitDurableLocked(&lock, appended_seq_, out_error);
+}
+
+bool WalStore::AwaitDurableLocked(std::unique_lock<std::mutex>* lock,
+                                  std::uint64_t target,
+                                  std::string* out_error) {
+  durable_cv_.wait(*lock, [this, target] {
+    return durable_seq_ >= target || !flush_error_.empty() || stop_;
+  });
+  if (durable_seq_ >= target) {
+    return true;
+  }
+  if (out_error != nullptr) {
+    *out_error = flush_error_.empty() ? "WAL 刷盘线程已停止" : flush_error_;
+  }
+  return false;
+}
+
+void WalStore::RunFlusher() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    flush_cv_.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs),
+                       [this] {
+                         return stop_ || sync_requested_ ||
+                                buffer_.size() >= kFlushBytesThreshold;
+                       });
+    if (buffer_.empty()) {
+      if (stop_) {
+        return;
+      }
+      sync_requested_ = false;
+      continue;
     }
+
+    // 整段换出缓冲后解锁写盘：追加侧只付 append + notify 的成本。
+    std::string batch;
+    batch.swap(buffer_);
+    const std::uint64_t batch_seq = appended_seq_;
+    sync_requested_ = false;
+    lock.unlock();
+
+    bool ok = true;
+    std::size_t written = 0;
+    while (written < batch.size()) {
+      const ssize_t n =
+          ::write(fd_, batch.data() + written, batch.size() - written);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ok = false;
+        break;
+      }
+      written += static_cast<std::size_t>(n);
+    }
+    if (ok && ::fdatasync(fd_) != 0) {
+      ok = false;
+    }
+
+    lock.lock();
+    if (ok) {
+      durable_seq_ = batch_seq;
+      active_size_ += static_cast<std::int64_t>(batch.size());
+      // 耐久性已确认后再封存：段内容完整且无需再 sync。
+      if (segment_max_bytes_ > 0 && active_size_ >= segment_max_bytes_) {
+        if (!RotateActiveLocked() && flush_error_.empty()) {
+          flush_error_ = "WAL 段封存失败: " + file_path_;
+        }
+      }
+    } else if (flush_error_.empty()) {
+      flush_error_ = "WAL 写入失败: " + file_path_;
+    }
+    durable_cv_.notify_all();
+    if (stop_ && buffer_.empty()) {
+      return;
+    }
+  }
+}
+
+bool WalStore::RotateActiveLocked() {
+  ::close(fd_);
+  fd_ = -1;
+  std::error_code ec;
+  std::filesystem::rename(file_path_, SegmentName(file_path_,
+                                                  next_segment_seq_), ec);
+  if (ec) {
+    return false;
+  }
+  ++next_segment_seq_;
+  fd_ = ::open(file_path_.c_str(), O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
     return false;
   }
+  active_size_ = 0;
   return true;
 }
 
-bool WalStore::AppendIntent(const OrderIntent& intent,
-                            std::string* out_error) const {
-  return AppendLine(SerializeIntent(intent), out_error);
+std::string WalStore::SnapshotPath() const { return file_path_ + ".snapshot"; }
+
+std::vector<std::string> WalStore::ListLiveSegments() const {
+  const std::filesystem::path path(file_path_);
+  const std::string prefix = path.filename().string() + ".seg-";
+  std::vector<std::string> segments;
+  std::error_code ec;
+  const auto parent = path.parent_path().empty()
+                          ? std::filesystem::path(".")
+                          : path.parent_path();
+  for (const auto& entry :
+       std::filesystem::directory_iterator(parent, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind(prefix, 0) != 0) {
+      continue;
+    }
+    const bool archived =
+        name.size() >= 9 &&
+        name.compare(name.size() - 9, 9, ".archived") == 0;
+    if (archived) {
+      continue;
+    }
+    segments.push_back(entry.path().string());
+  }
+  // 段号零填充，字典序即时间序。
+  std::sort(segments.begin(), segments.end());
+  return segments;
 }
 
-bool WalStore::AppendFill(const FillEvent& fill, std::string* out_error) const {
-  return AppendLine(SerializeFillV2(fill), out_error);
+bool WalStore::Compact(std::string* out_error) {
+  const std::vector<std::string> segments = ListLiveSegments();
+  if (segments.empty()) {
+    return true;  // 无待压实段：零成本空操作。
+  }
+
+  // 旧快照 + 已封存段折叠为去重后的全集；活动文件不参与，避免与
+  // 刷盘线程互扰。
+  std::unordered_set<std::string> intent_ids;
+  std::unordered_set<std::string> fill_ids;
+  std::vector<FillEvent> fills;
+  if (!ParseWalFile(SnapshotPath(), &intent_ids, &fill_ids, &fills,
+                    out_error)) {
+    return false;
+  }
+  for (const std::string& segment : segments) {
+    if (!ParseWalFile(segment, &intent_ids, &fill_ids, &fills, out_error)) {
+      return false;
+    }
+  }
+
+  // 先写临时文件并 fsync，再原子改名覆盖，崩溃任一时刻旧快照仍完整。
+  const std::string tmp_path = SnapshotPath() + ".tmp";
+  std::string contents;
+  for (const std::string& intent_id : intent_ids) {
+    contents.append(SerializeIntentIdRecord(intent_id));
+  }
+  for (const FillEvent& fill : fills) {
+    contents.append(SerializeFillRecord(fill));
+  }
+  const int snapshot_fd = ::open(
+      tmp_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0644);
+  if (snapshot_fd < 0) {
+    if (out_error != nullptr) {
+      *out_error = "创建 WAL 快照临时文件失败: " + tmp_path;
+    }
+    return false;
+  }
+  std::size_t written = 0;
+  bool ok = true;
+  while (written < contents.size()) {
+    const ssize_t n = ::write(snapshot_fd, contents.data() + written,
+                              contents.size() - written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ok = false;
+      break;
+    }
+    written += static_cast<std::size_t>(n);
+  }
+  if (ok && ::fdatasync(snapshot_fd) != 0) {
+    ok = false;
+  }
+  ::close(snapshot_fd);
+  if (!ok) {
+    if (out_error != nullptr) {
+      *out_error = "写入 WAL 快照失败: " + tmp_path;
+    }
+    return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, SnapshotPath(), ec);
+  if (ec) {
+    if (out_error != nullptr) {
+      *out_error = "WAL 快照改名失败: " + ec.message();
+    }
+    return false;
+  }
+
+  // 已折叠进快照的段归档；归档失败不回滚（快照已含其内容，重复
+  // 记录由去重兜底），只上报错误。
+  for (const std::string& segment : segments) {
+    std::filesystem::rename(segment, segment + ".archived", ec);
+    if (ec) {
+      if (out_error != nullptr) {
+        *out_error = "WAL 段归档失败: " + ec.message();
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void WalStore::StopFlusher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  flush_cv_.notify_all();
+  if (flusher_thread_.joinable()) {
+    flusher_thread_.join();
+  }
 }
 
 bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
                          std::unordered_set<std::string>* out_fill_ids,
                          std::vector<FillEvent>* out_fills,
-                         std::string* out_error) const {
+                         std::string* out_error) {
   if (out_intent_ids == nullptr || out_fill_ids == nullptr ||
       out_fills == nullptr) {
     if (out_error != nullptr) {
@@ -255,20 +681,171 @@ bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
     return false;
   }
 
+  // 先栅栏自身缓冲，保证读到本实例已追加的全部记录。
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (appended_seq_ > durable_seq_ && flush_error_.empty()) {
+      sync_requested_ = true;
+      flush_cv_.notify_one();
+      std::string flush_err;
+      if (!AwaitDurableLocked(&lock, appended_seq_, &flush_err)) {
+        if (out_error != nullptr) {
+          *out_error = flush_err;
+        }
+        return false;
+      }
+    }
+  }
+
   out_intent_ids->clear();
   out_fill_ids->clear();
   out_fills->clear();
 
-  std::ifstream in(file_path_);
-  if (!in.is_open()) {
+  // 恢复顺序：快照（压实后的去重全集）→ 存活段（按段号）→ 活动文件。
+  if (!ParseWalFile(SnapshotPath(), out_intent_ids, out_fill_ids, out_fills,
+                    out_error)) {
+    return false;
+  }
+  for (const std::string& segment : ListLiveSegments()) {
+    if (!ParseWalFile(segment, out_intent_ids, out_fill_ids, out_fills,
+                      out_error)) {
+      return false;
+    }
+  }
+  return ParseWalFile(file_path_, out_intent_ids, out_fill_ids, out_fills,
+                      out_error);
+}
+
+bool WalStore::ParseWalFile(const std::string& path,
+                            std::unordered_set<std::string>* out_intent_ids,
+                            std::unordered_set<std::string>* out_fill_ids,
+                            std::vector<FillEvent>* out_fills,
+                            std::string* out_error) const {
+  // mmap 只读映射后就地扫描：记录字段经 string_view 切片直达输出
+  // 结构，恢复路径不再做整文件读入或逐记录中间拷贝。
+  const int read_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (read_fd < 0) {
     // 文件不存在或无法打开视为“无历史”，由 Initialize 负责创建。
     return true;
   }
+  struct stat st{};
+  if (::fstat(read_fd, &st) != 0 || st.st_size <= 0) {
+    ::close(read_fd);
+    return true;
+  }
+  void* mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                        PROT_READ, MAP_PRIVATE, read_fd, 0);
+  ::close(read_fd);
+  if (mapped == MAP_FAILED) {
+    if (out_error != nullptr) {
+      *out_error = "WAL mmap 失败: " + path;
+    }
+    return false;
+  }
+  const std::string_view contents(static_cast<const char*>(mapped),
+                                  static_cast<std::size_t>(st.st_size));
+  // 无记录数头（文件混有历史文本行），按典型记录长度估算并预留
+  // 哈希桶，避免恢复期间反复 rehash。
+  constexpr std::size_t kApproxRecordBytes = 64;
+  const std::size_t estimated_records =
+      contents.size() / kApproxRecordBytes + 1;
+  out_intent_ids->reserve(out_intent_ids->size() + estimated_records);
+  out_fill_ids->reserve(out_fill_ids->size() + estimated_records);
+  out_fills->reserve(out_fills->size() + estimated_records);
+  const auto finish = [mapped, &st](bool result) {
+    ::munmap(mapped, static_cast<std::size_t>(st.st_size));
+    return result;
+  };
+
+  std::size_t pos = 0;
+  int record_no = 0;
+  while (pos < contents.size()) {
+    ++record_no;
+
+    if (static_cast<unsigned char>(contents[pos]) == kRecordSentinel) {
+      // 二进制记录：头部或载荷被截断（崩溃遗留的尾部残缺）按日志
+      // 截断语义忽略；完整但校验失败的记录视为损坏并报错。
+      if (pos + kRecordHeaderSize > contents.size()) {
+        break;
+      }
+      const unsigned char type =
+          static_cast<unsigned char>(contents[pos + 1]);
+      std::uint32_t payload_size = 0;
+      std::uint64_t checksum = 0;
+      std::memcpy(&payload_size, contents.data() + pos + 4,
+                  sizeof(payload_size));
+      std::memcpy(&checksum, contents.data() + pos + 8, sizeof(checksum));
+      if (pos + kRecordHeaderSize + payload_size > contents.size()) {
+        break;
+      }
+      // 载荷只取映射区上的视图，校验与解析全程零拷贝。
+      const std::string_view payload =
+          contents.substr(pos + kRecordHeaderSize, payload_size);
+      pos += kRecordHeaderSize + payload_size;
+      if (Fnv1a64(payload.data(), payload.size()) != checksum) {
+        if (out_error != nullptr) {
+          *out_error =
+              "WAL 记录校验失败（record=" + std::to_string(record_no) + ")";
+        }
+        return finish(false);
+      }
 
-  std::string line;
-  int line_no = 0;
-  while (std::getline(in, line)) {
-    ++line_no;
+      if (type == kRecordTypeIntent) {
+        OrderIntent intent;
+        if (!ParseIntentPayload(payload, &intent)) {
+          if (out_error != nullptr) {
+            *out_error = "WAL INTENT 记录解析失败（record=" +
+                         std::to_string(record_no) + ")";
+          }
+          return finish(false);
+        }
+        out_intent_ids->insert(std::move(intent.client_order_id));
+        continue;
+      }
+      if (type == kRecordTypeFill) {
+        // 先 emplace 再就地解析，失败或重复（按 fill_id 去重，避免重复
+        // 回放导致仓位漂移）时回退，免去中间 FillEvent 拷贝。
+        FillEvent& fill = out_fills->emplace_back();
+        if (!ParseFillPayload(payload, &fill)) {
+          if (out_error != nullptr) {
+            *out_error = "WAL FILL 记录解析失败（record=" +
+                         std::to_string(record_no) + ")";
+          }
+          return finish(false);
+        }
+        if (!out_fill_ids->insert(fill.fill_id).second) {
+          out_fills->pop_back();
+        }
+        continue;
+      }
+      if (type == kRecordTypeIntentId) {
+        std::string intent_id;
+        std::size_t cursor = 0;
+        if (!ReadLpString(payload, &cursor, &intent_id) ||
+            cursor != payload.size()) {
+          if (out_error != nullptr) {
+            *out_error = "WAL INTENT_ID 记录解析失败（record=" +
+                         std::to_string(record_no) + ")";
+          }
+          return finish(false);
+        }
+        out_intent_ids->insert(std::move(intent_id));
+        continue;
+      }
+      if (out_error != nullptr) {
+        *out_error =
+            "未知 WAL 记录类型（record=" + std::to_string(record_no) + ")";
+      }
+      return finish(false);
+    }
+
+    // 历史文本行：沿用旧格式解析，保证既有 WAL 可直接恢复。
+    const std::size_t line_end = contents.find('\n', pos);
+    const std::string line(
+        contents.substr(pos, line_end == std::string_view::npos
+                                 ? std::string_view::npos
+                                 : line_end - pos));
+    pos = line_end == std::string_view::npos ? contents.size() : line_end + 1;
     if (line.empty()) {
       continue;
     }
@@ -284,10 +861,10 @@ bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
       std::string parse_error;
       if (!ParseIntent(fields, &intent, &parse_error)) {
         if (out_error != nullptr) {
-          *out_error = "WAL 行解析失败（line=" + std::to_string(line_no) +
+          *out_error = "WAL 行解析失败（line=" + std::to_string(record_no) +
                        "）: " + parse_error;
         }
-        return false;
+        return finish(false);
       }
       out_intent_ids->insert(intent.client_order_id);
       continue;
@@ -297,12 +874,11 @@ bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
       std::string parse_error;
       if (!ParseFillV2(fields, &fill, &parse_error)) {
         if (out_error != nullptr) {
-          *out_error = "WAL 行解析失败（line=" + std::to_string(line_no) +
+          *out_error = "WAL 行解析失败（line=" + std::to_string(record_no) +
                        "）: " + parse_error;
         }
-        return false;
+        return finish(false);
       }
-      // 以 fill_id 去重，避免重复回放导致仓位漂移。
       const bool inserted = out_fill_ids->insert(fill.fill_id).second;
       if (inserted) {
         out_fills->push_back(fill);
@@ -314,10 +890,10 @@ bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
       std::string parse_error;
       if (!ParseLegacyFillV1(fields, &fill, &parse_error)) {
         if (out_error != nullptr) {
-          *out_error = "WAL 行解析失败（line=" + std::to_string(line_no) +
+          *out_error = "WAL 行解析失败（line=" + std::to_string(record_no) +
                        "）: " + parse_error;
         }
-        return false;
+        return finish(false);
       }
       const bool inserted = out_fill_ids->insert(fill.fill_id).second;
       if (inserted) {
@@ -327,12 +903,12 @@ bool WalStore::LoadState(std::unordered_set<std::string>* out_intent_ids,
     }
 
     if (out_error != nullptr) {
-      *out_error = "未知 WAL 事件类型（line=" + std::to_string(line_no) + ")";
+      *out_error = "未知 WAL 事件类型（line=" + std::to_string(record_no) + ")";
     }
-    return false;
+    return finish(false);
   }
 
-  return true;
+  return finish(true);
 }
 
 }  // namespace ai_trade
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -15,29 +19,103 @@ namespace ai_trade {
  * 1. 先写意图/成交再推进内存状态；
  * 2. 支持进程重启恢复；
  * 3. 支持成交去重（依赖 fill_id）。
+ *
+ * 写入路径为二进制定长头记录（长度前缀 + FNV-1a 校验和）配合组提交：
+ * 追加只是把序列化好的记录放进内存缓冲，专职刷盘线程按小的时间/字节
+ * 阈值批量 write + fdatasync。入场意图（kEntry）在返回前等待自身记录
+ * 落盘（组提交摊薄同步成本），成交与其余意图自由攒批。恢复路径同时
+ * 识别历史文本行与二进制记录；崩溃留下的尾部残缺记录按日志截断语义
+ * 忽略。
+ *
+ * 分段与压实：活动文件写满 segment_max_bytes 后由刷盘线程封存为
+ * `<path>.seg-NNNNNN` 并另起新活动文件；`Compact()` 把已封存段与旧
+ * 快照折叠进 `<path>.snapshot`（意图只留 id、成交按 fill_id 去重），
+ * 消化掉的段追加 `.archived` 后缀归档。恢复只读快照 + 存活段 + 活动
+ * 文件，启动成本随“去重后的状态量”而非追加历史长度增长。
  */
 class WalStore {
  public:
-  explicit WalStore(std::string file_path) : file_path_(std::move(file_path)) {}
+  /// 默认活动段封存阈值（字节）。
+  static constexpr std::int64_t kDefaultSegmentMaxBytes = 4 * 1024 * 1024;
+
+  explicit WalStore(std::string file_path,
+                    std::int64_t segment_max_bytes = kDefaultSegmentMaxBytes)
+      : file_path_(std::move(file_path)),
+        segment_max_bytes_(segment_max_bytes) {}
+  ~WalStore();
+
+  WalStore(const WalStore&) = delete;
+  WalStore& operator=(const WalStore&) = delete;
 
-  /// 初始化 WAL：确保父目录存在并创建文件（若不存在）。
-  bool Initialize(std::string* out_error) const;
+  /// 初始化 WAL：确保父目录存在、打开文件并启动刷盘线程。
+  bool Initialize(std::string* out_error);
 
-  /// 追加一条订单意图记录。
-  bool AppendIntent(const OrderIntent& intent, std::string* out_error) const;
-  /// 追加一条成交记录。
-  bool AppendFill(const FillEvent& fill, std::string* out_error) const;
+  /// 追加一条订单意图记录；kEntry 意图在返回前等待落盘。
+  bool AppendIntent(const OrderIntent& intent, std::string* out_error);
+  /// 追加一条成交记录（只入缓冲，由刷盘线程攒批落盘）。
+  bool AppendFill(const FillEvent& fill, std::string* out_error);
 
-  /// 加载 WAL 中的意图与成交，用于重启恢复。
+  /// 显式耐久性栅栏：等待当前全部缓冲记录落盘。
+  bool Flush(std::string* out_error);
+
+  /**
+   * @brief 压实已封存段为快照记录
+   *
+   * 把 `<path>.snapshot`（若有）与全部未归档段折叠为新快照：意图只保留
+   * client_order_id，成交按 fill_id 去重；成功后消化掉的段重命名归档。
+   * 无待压实段时为零成本空操作。
+   */
+  bool Compact(std::string* out_error);
+
+  /// 加载快照 + 存活段 + 活动文件，用于重启恢复（先栅栏自身缓冲）。
   bool LoadState(std::unordered_set<std::string>* out_intent_ids,
                  std::unordered_set<std::string>* out_fill_ids,
                  std::vector<FillEvent>* out_fills,
-                 std::string* out_error) const;
+                 std::string* out_error);
 
  private:
-  /// 追加单行文本到 WAL 文件（append + flush）。
-  bool AppendLine(const std::string& line, std::string* out_error) const;
-  std::string file_path_;  ///< WAL 文件路径。
+  /// 懒打开文件描述符并启动刷盘线程（加锁调用方负责互斥）。
+  bool EnsureOpenLocked(std::string* out_error);
+  /// 记录入缓冲；await_durable 时阻塞等待其序号落盘。
+  bool EnqueueRecord(std::string record,
+                     bool await_durable,
+                     std::string* out_error);
+  /// 等待 durable_seq_ 追上 target（调用方持锁）。
+  bool AwaitDurableLocked(std::unique_lock<std::mutex>* lock,
+                          std::uint64_t target,
+                          std::string* out_error);
+  /// 刷盘线程主体：cv 唤醒或超时后整段 write + fdatasync。
+  void RunFlusher();
+  /// 停止刷盘线程并排空缓冲（幂等）。
+  void StopFlusher();
+  /// 活动文件写满阈值后封存为段并另起新文件（刷盘线程持锁调用）。
+  bool RotateActiveLocked();
+  /// 快照文件路径（`<path>.snapshot`）。
+  std::string SnapshotPath() const;
+  /// 列出未归档的已封存段（按段号升序）。
+  std::vector<std::string> ListLiveSegments() const;
+  /// 解析单个 WAL 文件（快照/段/活动文件共用）；文件缺失视为空。
+  bool ParseWalFile(const std::string& path,
+                    std::unordered_set<std::string>* out_intent_ids,
+                    std::unordered_set<std::string>* out_fill_ids,
+                    std::vector<FillEvent>* out_fills,
+                    std::string* out_error) const;
+
+  std::string file_path_;  ///< 活动 WAL 文件路径（段/快照名由此派生）。
+  std::int64_t segment_max_bytes_{kDefaultSegmentMaxBytes};  ///< 封存阈值。
+  std::int64_t active_size_{0};  ///< 活动文件当前字节数。
+  std::uint64_t next_segment_seq_{1};  ///< 下一个封存段序号。
+  int fd_{-1};  ///< O_APPEND 文件描述符（刷盘线程独占写）。
+  std::thread flusher_thread_;  ///< 专职刷盘线程。
+  mutable std::mutex mutex_;  ///< 保护缓冲/序号/错误状态。
+  std::condition_variable flush_cv_;  ///< 追加侧唤醒刷盘线程。
+  std::condition_variable durable_cv_;  ///< 刷盘线程通知耐久性等待方。
+  std::string buffer_;  ///< 待落盘的已序列化记录字节。
+  std::uint64_t appended_seq_{0};  ///< 已入缓冲的记录序号。
+  std::uint64_t durable_seq_{0};  ///< 已 fdatasync 的记录序号。
+  bool sync_requested_{false};  ///< 有等待耐久性的追加方（立即刷）。
+  bool stop_{false};  ///< 刷盘线程停止标志。
+  std::string flush_error_;  ///< 刷盘失败原因（粘滞，后续追加报错）。
 };
 
 }  // namespace ai_trade
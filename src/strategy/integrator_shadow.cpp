@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <initializer_list>
@@ -30,6 +31,14 @@ typedef void (*Proc_ModelCalcerDelete)(ModelCalcerHandle handle);
 typedef bool (*Proc_ModelCalcerLoadSingleModelFromFile)(ModelCalcerHandle handle, const char* filename);
 typedef bool (*Proc_LoadFullModelFromFile)(ModelCalcerHandle handle, const char* filename);
 typedef bool (*Proc_ModelCalcerCalc)(ModelCalcerHandle handle, const float* features, size_t featuresSize, double* result, size_t resultSize);
+// 多行批量入口：一次调用对 doc_count 行特征做预测，树遍历的模型
+// 级开销按批摊销，逐行调用的每行固定成本只付一次。
+typedef bool (*Proc_CalcModelPredictionFlat)(ModelCalcerHandle handle,
+                                             size_t doc_count,
+                                             const float** features,
+                                             size_t features_size,
+                                             double* result,
+                                             size_t result_size);
 typedef bool (*Proc_CalcModelPredictionSingle)(ModelCalcerHandle handle,
                                                 const float* features,
                                                 size_t features_size,
@@ -45,6 +54,7 @@ struct CatBoostDynamicApi {
   Proc_ModelCalcerDelete remove{nullptr};
   Proc_ModelCalcerLoadSingleModelFromFile load_single{nullptr};
   Proc_LoadFullModelFromFile load_full{nullptr};
+  Proc_CalcModelPredictionFlat calc_flat{nullptr};
   Proc_ModelCalcerCalc calc{nullptr};
   Proc_CalcModelPredictionSingle calc_single{nullptr};
   Proc_ModelCalcerGetErrorString error_with_handle{nullptr};
@@ -106,9 +116,13 @@ bool ResolveCatBoostApi(void* handle, CatBoostDynamicApi* out_api, std::string*
     api.load_full = ResolveFirstSymbol<Proc_LoadFullModelFromFile>(
         handle, {"LoadFullModelFromFile"}, &api.load_symbol_name);
   }
+  // 优先解析批量入口；单行入口保留为兼容回退。
+  api.calc_flat = ResolveFirstSymbol<Proc_CalcModelPredictionFlat>(
+      handle, {"CalcModelPredictionFlat"}, &api.calc_symbol_name);
   api.calc = ResolveFirstSymbol<Proc_ModelCalcerCalc>(
-      handle, {"ModelCalcerCalc"}, &api.calc_symbol_name);
-  if (api.calc == nullptr) {
+      handle, {"ModelCalcerCalc"},
+      api.calc_flat == nullptr ? &api.calc_symbol_name : nullptr);
+  if (api.calc_flat == nullptr && api.calc == nullptr) {
     api.calc_single = ResolveFirstSymbol<Proc_CalcModelPredictionSingle>(
         handle, {"CalcModelPredictionSingle"}, &api.calc_symbol_name);
   }
@@ -129,8 +143,10 @@ bool ResolveCatBoostApi(void* handle, CatBoostDynamicApi* out_api, std::string*
   if (api.load_single == nullptr && api.load_full == nullptr) {
     missing.push_back("ModelCalcerLoadSingleModelFromFile/LoadFullModelFromFile");
   }
-  if (api.calc == nullptr && api.calc_single == nullptr) {
-    missing.push_back("ModelCalcerCalc/CalcModelPredictionSingle");
+  if (api.calc_flat == nullptr && api.calc == nullptr &&
+      api.calc_single == nullptr) {
+    missing.push_back(
+        "CalcModelPredictionFlat/ModelCalcerCalc/CalcModelPredictionSingle");
   }
   if (api.error_with_handle == nullptr && api.error_global == nullptr) {
     missing.push_back("ModelCalcerGetErrorString/GetErrorString");
@@ -181,6 +197,11 @@ bool CatBoostCalcPrediction(ModelCalcerHandle handle,
                             std::size_t features_size,
                             double* result,
                             std::size_t result_size) {
+  if (g_catboost_api.calc_flat != nullptr) {
+    const float* rows[1] = {features};
+    return g_catboost_api.calc_flat(handle, 1, rows, features_size, result,
+                                    result_size);
+  }
   if (g_catboost_api.calc != nullptr) {
     return g_catboost_api.calc(handle, features, features_size, result, result_size);
   }
@@ -190,6 +211,29 @@ bool CatBoostCalcPrediction(ModelCalcerHandle handle,
   }
   return false;
 }
+
+// 批量预测：rows 指向 doc_count 个行首（同一块连续矩阵的行指针）。
+// 批量符号可用时整批一次调用；否则逐行回退，任一行失败整体失败。
+bool CatBoostCalcPredictionBatch(ModelCalcerHandle handle,
+                                 std::size_t doc_count,
+                                 const float** rows,
+                                 std::size_t features_size,
+                                 double* results) {
+  if (doc_count == 0) {
+    return true;
+  }
+  if (g_catboost_api.calc_flat != nullptr) {
+    return g_catboost_api.calc_flat(handle, doc_count, rows, features_size,
+                                    results, doc_count);
+  }
+  for (std::size_t row = 0; row < doc_count; ++row) {
+    if (!CatBoostCalcPrediction(handle, rows[row], features_size,
+                                &results[row], 1)) {
+      return false;
+    }
+  }
+  return true;
+}
 #endif
 
 namespace ai_trade {
@@ -359,6 +403,7 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
   model_version_ = "n/a";
   feature_names_.clear();
   feature_expressions_.clear();
+  compiled_features_.clear();
   feature_clipping_enabled_ = false;
   feature_clip_lower_.clear();
   feature_clip_upper_.clear();
@@ -367,6 +412,7 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
   feature_norm_scale_.clear();
   feature_norm_max_abs_.clear();
   model_runtime_ready_ = false;
+  native_model_ = ObliviousTreeModel{};
 
   if (!config_.enabled) {
     initialized_ = true;
@@ -565,6 +611,31 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
     return fail("integrator 报告治理门槛未通过: " + JoinReasons(quality_failures));
   }
 
+  // 原生对称树模型：配置后优先加载，打分无需 CatBoost 运行库；
+  // .cbm 同时可用时仍会加载 CatBoost 做一次同分校验（见下）。
+  const bool use_native_model = !config_.native_model_path.empty();
+  if (use_native_model) {
+    std::string native_error;
+    if (!native_model_.Load(config_.native_model_path, &native_error)) {
+      if (require_model_file) {
+        return fail("integrator 原生模型加载失败: " + native_error);
+      }
+      LogInfo("INTEGRATOR_DEGRADED: 原生模型不可用，shadow 推理将降级关闭: " +
+              native_error);
+    } else if (!feature_names_.empty() &&
+               native_model_.feature_count() != feature_names_.size()) {
+      return fail("integrator 原生模型特征数与报告不一致: model=" +
+                  std::to_string(native_model_.feature_count()) +
+                  ", report=" + std::to_string(feature_names_.size()));
+    } else {
+      model_runtime_ready_ = true;
+      LogInfo("INTEGRATOR_NATIVE_MODEL_READY: path=" +
+              config_.native_model_path +
+              ", trees=" + std::to_string(native_model_.tree_count()) +
+              ", features=" + std::to_string(native_model_.feature_count()));
+    }
+  }
+
   const bool has_model_path = !config_.model_path.empty();
   bool model_file_ok = false;
   std::string model_file_error;
@@ -574,11 +645,14 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
     model_file_error = "model_path 为空";
   }
   if (!model_file_ok) {
-    if (require_model_file) {
-      return fail("integrator 模型文件校验失败: " + model_file_error);
+    // 原生模型已就绪时 .cbm 缺失不是降级：它只用于可选的同分校验。
+    if (!native_model_.loaded()) {
+      if (require_model_file) {
+        return fail("integrator 模型文件校验失败: " + model_file_error);
+      }
+      LogInfo("INTEGRATOR_DEGRADED: 模型文件不可用，shadow 推理将降级关闭: " +
+              model_file_error);
     }
-    LogInfo("INTEGRATOR_DEGRADED: 模型文件不可用，shadow 推理将降级关闭: " +
-            model_file_error);
   } else {
 #ifdef AI_TRADE_ENABLE_CATBOOST
     // 1. 延迟加载库
@@ -589,10 +663,12 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
              g_catboost_lib_handle = dlopen("/usr/local/lib/libcatboostmodel.so", RTLD_LAZY | RTLD_GLOBAL);
         }
         if (!g_catboost_lib_handle) {
-            if (require_model_file) {
+            if (require_model_file && !native_model_.loaded()) {
               return fail("无法加载 libcatboostmodel.so: " + std::string(dlerror()));
             }
-            LogInfo("INTEGRATOR_DEGRADED: 无法加载 libcatboostmodel.so，shadow 推理将降级关闭");
+            if (!native_model_.loaded()) {
+              LogInfo("INTEGRATOR_DEGRADED: 无法加载 libcatboostmodel.so，shadow 推理将降级关闭");
+            }
         } else {
           g_catboost_lib_loaded = true;
         }
@@ -640,12 +716,51 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
         LogInfo("CatBoost 模型加载成功: " + config_.model_path);
       }
     }
+
+    // 双运行时同分校验：原生 blob 与 .cbm 对确定性探针行打分必须
+    // 一致，否则判定转换产物损坏。校验通过后释放 CatBoost 句柄，
+    // 运行期只保留原生评估器。
+    if (native_model_.loaded() && model_handle_ != nullptr) {
+      constexpr int kProbeRows = 16;
+      std::vector<float> probe(native_model_.feature_count(), 0.0F);
+      std::uint64_t lcg_state = 0x9E3779B97F4A7C15ULL;
+      for (int row = 0; row < kProbeRows; ++row) {
+        for (float& value : probe) {
+          lcg_state = lcg_state * 6364136223846793005ULL + 1442695040888963407ULL;
+          // 映射到 [-2, 2)：覆盖归一化后特征的常见取值范围。
+          value = static_cast<float>(
+                      static_cast<double>(lcg_state >> 11) /
+                      static_cast<double>(1ULL << 53)) *
+                      4.0F -
+                  2.0F;
+        }
+        double catboost_score = 0.0;
+        if (!CatBoostCalcPrediction(
+                static_cast<ModelCalcerHandle>(model_handle_), probe.data(),
+                probe.size(), &catboost_score, 1)) {
+          return fail("原生模型同分校验失败：CatBoost 探针推理出错");
+        }
+        const double native_score = native_model_.Predict(probe);
+        if (std::fabs(native_score - catboost_score) > 1e-6) {
+          return fail("原生模型与 CatBoost 评分不一致: row=" +
+                      std::to_string(row) +
+                      ", native=" + std::to_string(native_score) +
+                      ", catboost=" + std::to_string(catboost_score));
+        }
+      }
+      LogInfo("INTEGRATOR_NATIVE_MODEL_VALIDATED: probes=" +
+              std::to_string(kProbeRows));
+      g_catboost_api.remove(static_cast<ModelCalcerHandle>(model_handle_));
+      model_handle_ = nullptr;
+    }
 #else
-    if (require_model_file) {
-      return fail(
-          "当前构建未启用 AI_TRADE_ENABLE_CATBOOST，无法加载模型进入接管模式");
+    if (!native_model_.loaded()) {
+      if (require_model_file) {
+        return fail(
+            "当前构建未启用 AI_TRADE_ENABLE_CATBOOST，无法加载模型进入接管模式");
+      }
+      LogInfo("INTEGRATOR_DEGRADED: 未启用 AI_TRADE_ENABLE_CATBOOST，shadow 推理将降级关闭");
     }
-    LogInfo("INTEGRATOR_DEGRADED: 未启用 AI_TRADE_ENABLE_CATBOOST，shadow 推理将降级关闭");
 #endif
   }
 
@@ -787,6 +902,15 @@ bool IntegratorShadow::Initialize(bool strict_takeover, std::string* out_error)
     return fail(oss.str());
   }
 
+  // 5. 预编译表达式：解析只发生一次，Infer 每 tick 直接对滚动窗口求值
+  compiled_features_.reserve(feature_expressions_.size());
+  for (const auto& expression : feature_expressions_) {
+    compiled_features_.push_back(feature_engine_.Compile(expression));
+    if (!compiled_features_.back().valid()) {
+      return fail("integrator 特征表达式编译失败: " + expression);
+    }
+  }
+
   initialized_ = true;
   return true;
 }
@@ -814,13 +938,15 @@ ShadowInference IntegratorShadow::Infer(const Signal& signal,
   }
 
   out.model_version = model_version_;
-  if (!model_runtime_ready_ || model_handle_ == nullptr) {
+  if (!model_runtime_ready_ ||
+      (!native_model_.loaded() && model_handle_ == nullptr)) {
     out.enabled = false;
     return out;
   }
 
-  // 1. 计算特征向量
-  std::vector<double> features;
+  // 1. 计算特征向量（写入复用的行缓冲，稳态零分配）
+  feature_row_.clear();
+  std::vector<double>& features = feature_row_;
   const std::size_t warmup_ticks =
       static_cast<std::size_t>(std::max(1, config_.feature_window_ticks));
   if (feature_engine_.SampleCount() < warmup_ticks) {
@@ -837,7 +963,7 @@ ShadowInference IntegratorShadow::Infer(const Signal& signal,
     return out;
   }
   if (feature_engine_.IsReady()) {
-    features = feature_engine_.EvaluateBatch(feature_expressions_);
+    feature_engine_.EvaluateBatchInto(compiled_features_, &features);
   }
   if (features.empty()) {
     out.enabled = false;
@@ -937,32 +1063,33 @@ ShadowInference IntegratorShadow::Infer(const Signal& signal,
     }
   }
 
-  // 2. 模型推理
+  // 2. 模型推理：原生对称树优先，CatBoost 运行库仅作回退。
   double raw = 0.0;
-
+  float_row_.assign(features.begin(), features.end());
+  if (native_model_.loaded()) {
+    raw = native_model_.Predict(float_row_);
+  } else {
 #ifdef AI_TRADE_ENABLE_CATBOOST
-  if (!g_catboost_lib_handle || !g_catboost_api.resolved || !model_handle_) {
-    out.enabled = false;
-    return out;
-  }
-  std::vector<float> float_features(features.begin(), features.end());
-  const float* row_ptr = float_features.data();
-  double result = 0.0;
-
-  if (!CatBoostCalcPrediction(static_cast<ModelCalcerHandle>(model_handle_),
-                              row_ptr,
-                              features.size(),
-                              &result,
-                              1)) {
-    LogInfo("INTEGRATOR_ERROR: CatBoost inference failed");
+    if (!g_catboost_lib_handle || !g_catboost_api.resolved || !model_handle_) {
+      out.enabled = false;
+      return out;
+    }
+    double result = 0.0;
+    if (!CatBoostCalcPrediction(static_cast<ModelCalcerHandle>(model_handle_),
+                                float_row_.data(),
+                                features.size(),
+                                &result,
+                                1)) {
+      LogInfo("INTEGRATOR_ERROR: CatBoost inference failed");
+      out.enabled = false;
+      return out;
+    }
+    raw = result;
+#else
     out.enabled = false;
     return out;
-  }
-  raw = result;
-#else
-  out.enabled = false;
-  return out;
 #endif
+  }
 
   if (config_.log_model_score) {
     std::ostringstream oss;
@@ -6,6 +6,7 @@
 #include "core/config.h"
 #include "core/types.h"
 #include "research/online_feature_engine.h"
+#include "strategy/oblivious_tree_model.h"
 
 namespace ai_trade {
 
@@ -35,6 +36,8 @@ class IntegratorShadow {
   research::OnlineFeatureEngine feature_engine_;
   std::vector<std::string> feature_names_;
   std::vector<std::string> feature_expressions_;
+  // Initialize 阶段预编译的表达式程序：Infer 热路径零解析求值
+  std::vector<research::CompiledExpression> compiled_features_;
   bool feature_clipping_enabled_{false};
   std::vector<double> feature_clip_lower_;
   std::vector<double> feature_clip_upper_;
@@ -44,6 +47,14 @@ class IntegratorShadow {
   std::vector<double> feature_norm_max_abs_;
   void* model_handle_{nullptr}; // CatBoost ModelCalcerHandle (void* to avoid header dependency)
   bool model_runtime_ready_{false};
+  // 原生对称树评估器：native_model_path 配置后替代 CatBoost 运行库，
+  // 双运行时同时可用时 Initialize 做同分校验后释放 CatBoost 句柄。
+  ObliviousTreeModel native_model_;
+
+  // Infer 热路径的行缓冲：特征求值结果与 float 转换行跨决策复用容量，
+  // 稳态零堆分配（mutable 与 CompiledExpression 的结果槽同一口径）。
+  mutable std::vector<double> feature_row_;
+  mutable std::vector<float> float_row_;
 };
 
 }  // namespace ai_trade
@@ -0,0 +1,175 @@
+#include "strategy/oblivious_tree_model.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace ai_trade {
+
+namespace {
+
+constexpr char kModelMagic[8] = {'A', 'T', 'C', 'O', 'B', 'L', 'T', '1'};
+// 深度上限：叶表为 2^depth，限制住可防御损坏文件触发超大分配。
+constexpr std::uint32_t kMaxTreeDepth = 16;
+
+}  // namespace
+
+bool ObliviousTreeModel::Load(const std::string& file_path,
+                              std::string* out_error) {
+  *this = ObliviousTreeModel{};
+
+  std::ifstream in(file_path, std::ios::binary);
+  if (!in.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法打开原生模型文件: " + file_path;
+    }
+    return false;
+  }
+
+  char magic[sizeof(kModelMagic)] = {};
+  std::uint32_t feature_count = 0;
+  std::uint32_t tree_count = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(&feature_count), sizeof(feature_count));
+  in.read(reinterpret_cast<char*>(&tree_count), sizeof(tree_count));
+  if (!in.good() ||
+      std::memcmp(magic, kModelMagic, sizeof(kModelMagic)) != 0 ||
+      feature_count == 0 || tree_count == 0) {
+    if (out_error != nullptr) {
+      *out_error = "原生模型文件头部非法: " + file_path;
+    }
+    return false;
+  }
+
+  feature_count_ = feature_count;
+  tree_depths_.reserve(tree_count);
+  tree_split_offsets_.reserve(tree_count);
+  tree_leaf_offsets_.reserve(tree_count);
+  for (std::uint32_t t = 0; t < tree_count; ++t) {
+    std::uint32_t depth = 0;
+    in.read(reinterpret_cast<char*>(&depth), sizeof(depth));
+    if (!in.good() || depth == 0 || depth > kMaxTreeDepth) {
+      if (out_error != nullptr) {
+        *out_error = "原生模型树深非法: " + file_path +
+                     ", tree=" + std::to_string(t);
+      }
+      *this = ObliviousTreeModel{};
+      return false;
+    }
+    tree_depths_.push_back(depth);
+    tree_split_offsets_.push_back(
+        static_cast<std::uint32_t>(split_features_.size()));
+    tree_leaf_offsets_.push_back(
+        static_cast<std::uint32_t>(leaf_values_.size()));
+    for (std::uint32_t level = 0; level < depth; ++level) {
+      std::uint32_t feature_index = 0;
+      float border = 0.0F;
+      in.read(reinterpret_cast<char*>(&feature_index), sizeof(feature_index));
+      in.read(reinterpret_cast<char*>(&border), sizeof(border));
+      if (!in.good() || feature_index >= feature_count_) {
+        if (out_error != nullptr) {
+          *out_error = "原生模型分裂特征下标越界: " + file_path +
+                       ", tree=" + std::to_string(t);
+        }
+        *this = ObliviousTreeModel{};
+        return false;
+      }
+      split_features_.push_back(feature_index);
+      split_borders_.push_back(border);
+    }
+    const std::size_t leaf_count = static_cast<std::size_t>(1) << depth;
+    const std::size_t leaf_begin = leaf_values_.size();
+    leaf_values_.resize(leaf_begin + leaf_count);
+    in.read(reinterpret_cast<char*>(leaf_values_.data() + leaf_begin),
+            static_cast<std::streamsize>(leaf_count * sizeof(double)));
+    if (!in.good()) {
+      if (out_error != nullptr) {
+        *out_error = "原生模型叶值数据不完整: " + file_path;
+      }
+      *this = ObliviousTreeModel{};
+      return false;
+    }
+  }
+  return true;
+}
+
+double ObliviousTreeModel::Predict(std::span<const float> features) const {
+  if (features.size() < feature_count_) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (std::size_t t = 0; t < tree_depths_.size(); ++t) {
+    const std::uint32_t depth = tree_depths_[t];
+    const std::uint32_t split_offset = tree_split_offsets_[t];
+    std::size_t leaf_index = 0;
+    // 对称树：每层同一条件作用于整层，叶下标即 depth 个比较位拼接。
+    for (std::uint32_t level = 0; level < depth; ++level) {
+      const std::uint32_t feature = split_features_[split_offset + level];
+      const float border = split_borders_[split_offset + level];
+      leaf_index |= static_cast<std::size_t>(features[feature] > border)
+                    << level;
+    }
+    sum += leaf_values_[tree_leaf_offsets_[t] + leaf_index];
+  }
+  return sum;
+}
+
+bool ObliviousTreeModel::Save(std::uint32_t feature_count,
+                              const std::vector<Tree>& trees,
+                              const std::string& file_path,
+                              std::string* out_error) {
+  if (feature_count == 0 || trees.empty()) {
+    if (out_error != nullptr) {
+      *out_error = "原生模型写出参数非法：特征数与树数必须为正";
+    }
+    return false;
+  }
+  for (std::size_t t = 0; t < trees.size(); ++t) {
+    const Tree& tree = trees[t];
+    const std::size_t depth = tree.feature_indices.size();
+    if (depth == 0 || depth > kMaxTreeDepth ||
+        tree.borders.size() != depth ||
+        tree.leaf_values.size() != (static_cast<std::size_t>(1) << depth)) {
+      if (out_error != nullptr) {
+        *out_error = "原生模型树结构非法: tree=" + std::to_string(t);
+      }
+      return false;
+    }
+  }
+
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    if (out_error != nullptr) {
+      *out_error = "无法写入原生模型文件: " + file_path;
+    }
+    return false;
+  }
+  const std::uint32_t tree_count = static_cast<std::uint32_t>(trees.size());
+  out.write(kModelMagic, sizeof(kModelMagic));
+  out.write(reinterpret_cast<const char*>(&feature_count),
+            sizeof(feature_count));
+  out.write(reinterpret_cast<const char*>(&tree_count), sizeof(tree_count));
+  for (const Tree& tree : trees) {
+    const std::uint32_t depth =
+        static_cast<std::uint32_t>(tree.feature_indices.size());
+    out.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+    for (std::uint32_t level = 0; level < depth; ++level) {
+      out.write(reinterpret_cast<const char*>(&tree.feature_indices[level]),
+                sizeof(std::uint32_t));
+      out.write(reinterpret_cast<const char*>(&tree.borders[level]),
+                sizeof(float));
+    }
+    out.write(reinterpret_cast<const char*>(tree.leaf_values.data()),
+              static_cast<std::streamsize>(tree.leaf_values.size() *
+                                           sizeof(double)));
+  }
+  out.flush();
+  if (!out.good()) {
+    if (out_error != nullptr) {
+      *out_error = "写入原生模型文件失败: " + file_path;
+    }
+    return false;
+  }
+  return true;
+}
+
+}  // namespace ai_trade
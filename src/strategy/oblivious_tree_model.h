@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ai_trade {
+
+/**
+ * @brief 原生对称树（oblivious tree）模型评估器
+ *
+ * 设计动机：CatBoost 运行库通过 dlopen 加载，镜像要带一份共享库，
+ * kActive 接管模式被这份重依赖卡住；而生产模型都是浅层对称树，
+ * 评估只需逐树做 depth 次"特征 > 阈值"比较拼出叶下标再查表。
+ * 部署时用 tools/convert_catboost_model.py 把训练产物转成紧凑二进制
+ * blob，进程内以扁平数组装载：所有树的分裂条件连续存放，打分是
+ * 一次顺序扫描，无指针追逐、无分支树结构，单行亚微秒级。
+ *
+ * 文件格式 v1（小端）：
+ *   [0,8)  magic "ATCOBLT1"
+ *   [8,12) 特征数 feature_count（uint32）
+ *   [12,16) 树数 tree_count（uint32）
+ *   每棵树：uint32 depth，depth 组 (uint32 feature_index, float border)，
+ *   然后 2^depth 个 double 叶值。
+ *
+ * 分裂语义与 CatBoost 一致：feature > border 取高位分支。
+ */
+class ObliviousTreeModel {
+ public:
+  /// 转换器/测试用的单棵树写端表示。
+  struct Tree {
+    std::vector<std::uint32_t> feature_indices;  ///< 每层的特征下标。
+    std::vector<float> borders;                  ///< 每层的分裂阈值。
+    std::vector<double> leaf_values;             ///< 2^depth 个叶值。
+  };
+
+  /// 加载二进制 blob；失败时返回 false 并写出中文错误信息。
+  bool Load(const std::string& file_path, std::string* out_error);
+
+  bool loaded() const { return !tree_depths_.empty(); }
+  std::size_t feature_count() const { return feature_count_; }
+  std::size_t tree_count() const { return tree_depths_.size(); }
+
+  /// 单行打分：features 长度不足 feature_count 时返回 0（调用方保证
+  /// 长度，防御性下界只为避免越界）。
+  double Predict(std::span<const float> features) const;
+
+  /// 将树集合落盘为二进制 blob（转换器写端，覆盖已有文件）。
+  static bool Save(std::uint32_t feature_count,
+                   const std::vector<Tree>& trees,
+                   const std::string& file_path,
+                   std::string* out_error);
+
+ private:
+  std::uint32_t feature_count_{0};
+  // 扁平布局：全部树的分裂条件/叶值各自连续，按树偏移索引。
+  std::vector<std::uint32_t> split_features_;
+  std::vector<float> split_borders_;
+  std::vector<double> leaf_values_;
+  std::vector<std::uint32_t> tree_depths_;
+  std::vector<std::uint32_t> tree_split_offsets_;
+  std::vector<std::uint32_t> tree_leaf_offsets_;
+};
+
+}  // namespace ai_trade
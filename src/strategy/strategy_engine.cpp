@@ -5,6 +5,10 @@
 #include <string>
 #include <vector>
 
+#include "core/reason_codes.h"
+#include "core/snapshot_io.h"
+#include "core/symbol_table.h"
+
 namespace ai_trade {
 
 namespace {
@@ -53,45 +57,82 @@ double TrendBucketScale(const StrategyConfig& config, RegimeBucket bucket) {
   return config.trend_range_scale;
 }
 
-void PushReason(std::vector<std::string>* reasons, const std::string& code) {
-  if (reasons == nullptr || code.empty()) {
-    return;
-  }
-  if (std::find(reasons->begin(), reasons->end(), code) == reasons->end()) {
-    reasons->push_back(code);
-  }
-}
-
-void AppendRegimeReason(const RegimeState& regime,
-                        std::vector<std::string>* reasons) {
-  if (reasons == nullptr) {
+void AppendRegimeReason(const RegimeState& regime, ReasonMask* mask) {
+  if (mask == nullptr) {
     return;
   }
   switch (regime.regime) {
     case Regime::kUptrend:
-      PushReason(reasons, "REG_UPTREND");
+      SetReason(mask, ReasonCode::kRegUptrend);
       break;
     case Regime::kDowntrend:
-      PushReason(reasons, "REG_DOWNTREND");
+      SetReason(mask, ReasonCode::kRegDowntrend);
       break;
     case Regime::kRange:
-      PushReason(reasons, "REG_RANGE");
+      SetReason(mask, ReasonCode::kRegRange);
       break;
     case Regime::kExtreme:
-      PushReason(reasons, "REG_EXTREME");
+      SetReason(mask, ReasonCode::kRegExtreme);
       break;
   }
   if (regime.warmup) {
-    PushReason(reasons, "REG_WARMUP");
+    SetReason(mask, ReasonCode::kRegWarmup);
   }
 }
 
 }  // namespace
 
+StrategyEngine::SymbolState& StrategyEngine::StateFor(const MarketEvent& event) {
+  // 入口已 intern 的事件直接用 id；直接构造的事件（测试/回放）回退一次。
+  const SymbolId symbol_id = event.symbol_id != kInvalidSymbolId
+                                 ? event.symbol_id
+                                 : InternSymbol(event.symbol);
+  if (symbol_states_.size() <= symbol_id) {
+    symbol_states_.resize(symbol_id + 1);
+  }
+  if (!symbol_states_[symbol_id]) {
+    symbol_states_[symbol_id] = std::make_unique<SymbolState>();
+  }
+  return *symbol_states_[symbol_id];
+}
+
+void StrategyEngine::RefreshCompiledFactors(SymbolState* state) const {
+  // 编译一次、逐 tick 复用：OnMarket 不再每 tick 拼接表达式字符串并
+  // 重走解析器，稳态求值只剩结果槽复用，决策路径不触碰堆分配。
+  const auto& engine = state->feature_engine;
+  state->ema_fast_expr = engine.Compile(
+      "ema(close," + std::to_string(config_.trend_ema_fast) + ")");
+  state->ema_slow_expr = engine.Compile(
+      "ema(close," + std::to_string(config_.trend_ema_slow) + ")");
+  state->breakout_rank_expr =
+      config_.trend_breakout_lookback_ticks > 1
+          ? engine.Compile(
+                "ts_rank(close," +
+                std::to_string(config_.trend_breakout_lookback_ticks) + ")")
+          : research::CompiledExpression{};
+  state->defensive_rank_expr =
+      config_.defensive_rank_lookback_ticks > 1
+          ? engine.Compile(
+                "ts_rank(close," +
+                std::to_string(config_.defensive_rank_lookback_ticks) + ")")
+          : research::CompiledExpression{};
+  // 斜率回看窗口容量不足时重建环形缓冲（丢弃历史，重新暖机）；
+  // 容量足够则原样保留，缩小回看不清数据。
+  const std::size_t history_capacity = static_cast<std::size_t>(
+      std::max(4, config_.trend_slope_lookback_ticks + 4));
+  if (state->ema_slow_history.capacity() < history_capacity) {
+    state->ema_slow_history = research::RollingBuffer(history_capacity);
+  }
+  state->compiled_config_epoch = config_epoch_;
+}
+
 Signal StrategyEngine::OnMarket(const MarketEvent& event,
                                 const AccountState& account,
                                 const RegimeState& regime) {
-  SymbolState& state = symbol_states_[event.symbol];
+  SymbolState& state = StateFor(event);
+  if (state.compiled_config_epoch != config_epoch_) {
+    RefreshCompiledFactors(&state);
+  }
   const int signal_valid_ms = std::max(1000, config_.signal_valid_for_ms);
   std::int64_t event_interval_ms = event.interval_ms;
   // 仅在 ts 符合“真实 epoch 毫秒”口径时才用 ts 差值推导间隔；
@@ -132,8 +173,8 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     state.has_last = true;
     state.last_price = event.price;
     Signal warmup_signal = make_base_signal();
-    PushReason(&warmup_signal.reason_codes, "STR_WARMUP");
-    AppendRegimeReason(regime, &warmup_signal.reason_codes);
+    SetReason(&warmup_signal.reason_mask, ReasonCode::kStrWarmup);
+    AppendRegimeReason(regime, &warmup_signal.reason_mask);
     return warmup_signal;
   }
   const double safe_price = std::max(std::fabs(event.price), kEpsilon);
@@ -145,46 +186,41 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
   // 确保窗口足够长以计算慢速 EMA
   if (!state.feature_engine.IsReady()) {
     Signal not_ready_signal = make_base_signal();
-    PushReason(&not_ready_signal.reason_codes, "STR_FEATURE_NOT_READY");
-    AppendRegimeReason(regime, &not_ready_signal.reason_codes);
+    SetReason(&not_ready_signal.reason_mask, ReasonCode::kStrFeatureNotReady);
+    AppendRegimeReason(regime, &not_ready_signal.reason_mask);
     return not_ready_signal;
   }
 
-  const double ema_fast = state.feature_engine.Evaluate("ema(close," + std::to_string(config_.trend_ema_fast) + ")");
-  const double ema_slow = state.feature_engine.Evaluate("ema(close," + std::to_string(config_.trend_ema_slow) + ")");
+  const double ema_fast = state.feature_engine.Evaluate(state.ema_fast_expr);
+  const double ema_slow = state.feature_engine.Evaluate(state.ema_slow_expr);
   if (std::isfinite(ema_slow)) {
-    state.ema_slow_history.push_back(ema_slow);
-    const std::size_t max_history =
-        static_cast<std::size_t>(std::max(4, config_.trend_slope_lookback_ticks + 4));
-    while (state.ema_slow_history.size() > max_history) {
-      state.ema_slow_history.pop_front();
-    }
+    // 环形缓冲自动淘汰最旧样本，容量由 RefreshCompiledFactors 保证。
+    state.ema_slow_history.Add(ema_slow);
   }
 
   int raw_direction = 0;
   Signal signal = make_base_signal();
-  PushReason(&signal.reason_codes, "STR_TREND_EVAL");
+  SetReason(&signal.reason_mask, ReasonCode::kStrTrendEval);
   if (std::isfinite(ema_fast) && std::isfinite(ema_slow)) {
     if (ema_fast > ema_slow) {
       raw_direction = 1;
-      PushReason(&signal.reason_codes, "STR_TREND_EMA_UP");
+      SetReason(&signal.reason_mask, ReasonCode::kStrTrendEmaUp);
     } else if (ema_fast < ema_slow) {
       raw_direction = -1;
-      PushReason(&signal.reason_codes, "STR_TREND_EMA_DOWN");
+      SetReason(&signal.reason_mask, ReasonCode::kStrTrendEmaDown);
     } else {
-      PushReason(&signal.reason_codes, "STR_TREND_EMA_FLAT");
+      SetReason(&signal.reason_mask, ReasonCode::kStrTrendEmaFlat);
     }
   } else {
-    PushReason(&signal.reason_codes, "STR_TREND_EMA_INVALID");
+    SetReason(&signal.reason_mask, ReasonCode::kStrTrendEmaInvalid);
   }
 
   if (raw_direction != 0 && config_.trend_breakout_lookback_ticks > 1) {
-    const int breakout_window = config_.trend_breakout_lookback_ticks;
-    const double rank = state.feature_engine.Evaluate(
-        "ts_rank(close," + std::to_string(breakout_window) + ")");
+    const double rank =
+        state.feature_engine.Evaluate(state.breakout_rank_expr);
     if (!std::isfinite(rank)) {
       raw_direction = 0;
-      PushReason(&signal.reason_codes, "STR_BREAKOUT_NOT_READY");
+      SetReason(&signal.reason_mask, ReasonCode::kStrBreakoutNotReady);
     } else {
       const double threshold =
           std::clamp(config_.trend_breakout_rank_threshold, 0.5, 1.0);
@@ -194,9 +230,9 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
           raw_direction > 0 ? breakout_up : breakout_down;
       if (!breakout_pass) {
         raw_direction = 0;
-        PushReason(&signal.reason_codes, "STR_BREAKOUT_BLOCK");
+        SetReason(&signal.reason_mask, ReasonCode::kStrBreakoutBlock);
       } else {
-        PushReason(&signal.reason_codes, "STR_BREAKOUT_PASS");
+        SetReason(&signal.reason_mask, ReasonCode::kStrBreakoutPass);
       }
     }
   }
@@ -206,20 +242,20 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     const int lookback = config_.trend_slope_lookback_ticks;
     if (state.ema_slow_history.size() <= static_cast<std::size_t>(lookback)) {
       raw_direction = 0;
-      PushReason(&signal.reason_codes, "STR_SLOPE_NOT_READY");
+      SetReason(&signal.reason_mask, ReasonCode::kStrSlopeNotReady);
     } else {
       const std::size_t idx =
           state.ema_slow_history.size() - 1 - static_cast<std::size_t>(lookback);
-      const double ema_ref = state.ema_slow_history[idx];
+      const double ema_ref = state.ema_slow_history.At(idx);
       const double slope = (ema_slow - ema_ref) / safe_price;
       const double min_abs = std::max(0.0, config_.trend_slope_min_abs);
       const bool slope_pass =
           raw_direction > 0 ? (slope >= min_abs) : (slope <= -min_abs);
       if (!slope_pass) {
         raw_direction = 0;
-        PushReason(&signal.reason_codes, "STR_SLOPE_BLOCK");
+        SetReason(&signal.reason_mask, ReasonCode::kStrSlopeBlock);
       } else {
-        PushReason(&signal.reason_codes, "STR_SLOPE_PASS");
+        SetReason(&signal.reason_mask, ReasonCode::kStrSlopePass);
       }
     }
   }
@@ -232,14 +268,14 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
       std::isfinite(current_vol_annual) &&
       current_vol_annual > config_.trend_vol_cap_annual) {
     raw_direction = 0;
-    PushReason(&signal.reason_codes, "STR_VOL_CAP_BLOCK");
+    SetReason(&signal.reason_mask, ReasonCode::kStrVolCapBlock);
   }
 
   // 价格变化不足 deadband 时沿用当前方向，避免在微小波动中频繁反手。
   if (effective_deadband_abs > 0.0 &&
       price_delta_abs < effective_deadband_abs) {
     raw_direction = state.effective_direction;
-    PushReason(&signal.reason_codes, "STR_DEADBAND_HOLD");
+    SetReason(&signal.reason_mask, ReasonCode::kStrDeadbandHold);
   }
 
   // 3. 信号防抖 (Signal Debounce)
@@ -249,7 +285,7 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
       (raw_direction == 0 || raw_direction != state.effective_direction) &&
       state.ticks_since_direction_change < config_.min_hold_ticks) {
     final_direction = state.effective_direction;
-    PushReason(&signal.reason_codes, "STR_MIN_HOLD_HOLD");
+    SetReason(&signal.reason_mask, ReasonCode::kStrMinHoldHold);
   }
 
   // 更新状态计数器
@@ -269,9 +305,8 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
   double defensive_score_abs = 0.0;
   bool defensive_signal_ready = false;
   if (config_.defensive_rank_lookback_ticks > 1) {
-    const int rank_window = config_.defensive_rank_lookback_ticks;
-    const double rank = state.feature_engine.Evaluate(
-        "ts_rank(close," + std::to_string(rank_window) + ")");
+    const double rank =
+        state.feature_engine.Evaluate(state.defensive_rank_expr);
     if (std::isfinite(rank)) {
       // rank∈[0,1] -> centered∈[-0.5,0.5]；放大到[-2,2]，便于复用 entry_score 阈值。
       const double centered = std::clamp(0.5 - rank, -0.5, 0.5);
@@ -279,13 +314,13 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
       defensive_score_abs = std::fabs(defensive_score);
       if (defensive_score_abs >= std::max(config_.defensive_entry_score, kEpsilon)) {
         raw_defensive_direction = SignOf(defensive_score);
-        PushReason(&signal.reason_codes, "STR_DEFENSIVE_RANK_TRIGGER");
+        SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveRankTrigger);
       } else {
-        PushReason(&signal.reason_codes, "STR_DEFENSIVE_RANK_WEAK");
+        SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveRankWeak);
       }
       defensive_signal_ready = true;
     } else {
-      PushReason(&signal.reason_codes, "STR_DEFENSIVE_RANK_NOT_READY");
+      SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveRankNotReady);
     }
   }
   if (!defensive_signal_ready && std::isfinite(ema_slow)) {
@@ -298,15 +333,15 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     defensive_score_abs = std::fabs(defensive_score);
     if (defensive_score_abs >= std::max(config_.defensive_entry_score, kEpsilon)) {
       raw_defensive_direction = -SignOf(defensive_score);
-      PushReason(&signal.reason_codes, "STR_DEFENSIVE_LEGACY_TRIGGER");
+      SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveLegacyTrigger);
     } else {
-      PushReason(&signal.reason_codes, "STR_DEFENSIVE_LEGACY_WEAK");
+      SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveLegacyWeak);
     }
   }
   if (effective_deadband_abs > 0.0 &&
       price_delta_abs < effective_deadband_abs) {
     raw_defensive_direction = state.defensive_effective_direction;
-    PushReason(&signal.reason_codes, "STR_DEFENSIVE_DEADBAND_HOLD");
+    SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveDeadbandHold);
   }
 
   int final_defensive_direction = raw_defensive_direction;
@@ -316,7 +351,7 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
        raw_defensive_direction != state.defensive_effective_direction) &&
       state.defensive_ticks_since_direction_change < config_.min_hold_ticks) {
     final_defensive_direction = state.defensive_effective_direction;
-    PushReason(&signal.reason_codes, "STR_DEFENSIVE_MIN_HOLD_HOLD");
+    SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveMinHoldHold);
   }
   if (final_defensive_direction == state.defensive_effective_direction) {
     if (state.defensive_effective_direction != 0) {
@@ -391,7 +426,7 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     const double bucket_scale =
         std::max(0.0, TrendBucketScale(config_, regime.bucket));
     if (bucket_scale < 1.0) {
-      PushReason(&signal.reason_codes, "STR_TREND_BUCKET_SCALED");
+      SetReason(&signal.reason_mask, ReasonCode::kStrTrendBucketScaled);
     }
     trend_notional = static_cast<double>(final_direction) * target_notional *
                      std::clamp(trend_strength, 0.0, 1.0) * bucket_scale;
@@ -408,7 +443,7 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
         config_.eth_range_defensive_scale_multiplier < 1.0) {
       bucket_scale *=
           std::clamp(config_.eth_range_defensive_scale_multiplier, 0.0, 1.0);
-      PushReason(&signal.reason_codes, "STR_DEFENSIVE_ETH_RANGE_SCALED");
+      SetReason(&signal.reason_mask, ReasonCode::kStrDefensiveEthRangeScaled);
     }
     if (regime.warmup) {
       bucket_scale *= 0.5;
@@ -434,7 +469,7 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     signal.suggested_notional_usd = 0.0;
     signal.direction = 0;
     signal.confidence = 0.0;
-    PushReason(&signal.reason_codes, "STR_EXTREME_BLOCK");
+    SetReason(&signal.reason_mask, ReasonCode::kStrExtremeBlock);
   }
   if (regime.bucket == RegimeBucket::kRange &&
       signal.direction != 0 &&
@@ -445,18 +480,81 @@ Signal StrategyEngine::OnMarket(const MarketEvent& event,
     signal.suggested_notional_usd = 0.0;
     signal.direction = 0;
     signal.confidence = 0.0;
-    PushReason(&signal.reason_codes, "STR_RANGE_CONFIDENCE_BLOCK");
+    SetReason(&signal.reason_mask, ReasonCode::kStrRangeConfidenceBlock);
   }
   if (signal.direction == 0) {
-    PushReason(&signal.reason_codes, "STR_FLAT_SIGNAL");
+    SetReason(&signal.reason_mask, ReasonCode::kStrFlatSignal);
   } else {
-    PushReason(&signal.reason_codes, "STR_ACTIVE_SIGNAL");
+    SetReason(&signal.reason_mask, ReasonCode::kStrActiveSignal);
   }
-  AppendRegimeReason(regime, &signal.reason_codes);
-  if (signal.reason_codes.empty()) {
-    PushReason(&signal.reason_codes, "STR_NO_REASON");
+  AppendRegimeReason(regime, &signal.reason_mask);
+  if (signal.reason_mask == 0ULL) {
+    SetReason(&signal.reason_mask, ReasonCode::kStrNoReason);
   }
   return signal;
 }
 
+void StrategyEngine::SaveState(SnapshotWriter* writer) const {
+  std::uint64_t active = 0;
+  for (const auto& state : symbol_states_) {
+    if (state) {
+      ++active;
+    }
+  }
+  writer->Field(active);
+  for (SymbolId id = 0; id < symbol_states_.size(); ++id) {
+    const auto& state = symbol_states_[id];
+    if (!state) {
+      continue;
+    }
+    writer->Field(SymbolNameOf(id));
+    writer->Field(state->last_price);
+    writer->Field(state->has_last);
+    writer->Field(state->last_event_ts_ms);
+    writer->Field(state->effective_direction);
+    writer->Field(state->ticks_since_direction_change);
+    // 按时间正序落盘，线格式与旧版 deque 序列化一致（u32 数量 + 样本）。
+    writer->Field(state->ema_slow_history.GetLast(state->ema_slow_history.size()));
+    writer->Field(state->defensive_effective_direction);
+    writer->Field(state->defensive_ticks_since_direction_change);
+    writer->Field(state->has_last_target_notional);
+    writer->Field(state->last_target_notional);
+    state->feature_engine.SaveState(writer);
+  }
+}
+
+void StrategyEngine::LoadState(SnapshotReader* reader) {
+  symbol_states_.clear();
+  std::uint64_t count = 0;
+  reader->Field(count);
+  for (std::uint64_t i = 0; reader->ok() && i < count; ++i) {
+    std::string symbol;
+    reader->Field(symbol);
+    const SymbolId symbol_id = InternSymbol(symbol);
+    if (symbol_states_.size() <= symbol_id) {
+      symbol_states_.resize(symbol_id + 1);
+    }
+    auto state = std::make_unique<SymbolState>();
+    reader->Field(state->last_price);
+    reader->Field(state->has_last);
+    reader->Field(state->last_event_ts_ms);
+    reader->Field(state->effective_direction);
+    reader->Field(state->ticks_since_direction_change);
+    std::vector<double> ema_slow_history;
+    reader->Field(ema_slow_history);
+    // 按当前配置容量重建环形缓冲；快照样本超额时最旧的自然淘汰。
+    state->ema_slow_history = research::RollingBuffer(static_cast<std::size_t>(
+        std::max(4, config_.trend_slope_lookback_ticks + 4)));
+    for (const double value : ema_slow_history) {
+      state->ema_slow_history.Add(value);
+    }
+    reader->Field(state->defensive_effective_direction);
+    reader->Field(state->defensive_ticks_since_direction_change);
+    reader->Field(state->has_last_target_notional);
+    reader->Field(state->last_target_notional);
+    state->feature_engine.LoadState(reader);
+    symbol_states_[symbol_id] = std::move(state);
+  }
+}
+
 }  // namespace ai_trade
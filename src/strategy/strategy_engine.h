@@ -1,9 +1,8 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <memory>
-#include <deque>
 
 #include "core/config.h"
 #include "core/types.h"
@@ -12,6 +11,9 @@
 
 namespace ai_trade {
 
+class SnapshotWriter;
+class SnapshotReader;
+
 /**
  * @brief Strategy Engine
  *
@@ -26,6 +28,13 @@ class StrategyEngine {
  public:
   explicit StrategyEngine(StrategyConfig config = {}) : config_(config) {}
 
+  /// 热更新策略参数（各 symbol 指标与持仓运行态保持不变）。
+  /// 代数递增使各 symbol 的预编译表达式在下一个 tick 懒重编译。
+  void SetConfig(const StrategyConfig& config) {
+    config_ = config;
+    ++config_epoch_;
+  }
+
   /**
    * @brief Main entry point for signal generation.
    * 
@@ -38,6 +47,12 @@ class StrategyEngine {
                   const AccountState& account,
                   const RegimeState& regime);
 
+  /// 把各 symbol 指标运行态（含特征引擎窗口）写入二进制快照。
+  /// 状态按 symbol 名落盘，跨进程重启不依赖 SymbolId 分配顺序。
+  void SaveState(SnapshotWriter* writer) const;
+  /// 从快照恢复各 symbol 运行态；缓冲损坏时由调用方检查 reader->ok()。
+  void LoadState(SnapshotReader* reader);
+
  private:
   // Internal state for a single symbol
   struct SymbolState {
@@ -48,7 +63,10 @@ class StrategyEngine {
     // Trend Logic State
     int effective_direction{0};
     int ticks_since_direction_change{0};
-    std::deque<double> ema_slow_history{};
+    // 慢线 EMA 滚动窗口：固定容量环形缓冲，稳态写入不触碰堆
+    // （deque 每 64 个样本就要换一块 chunk）。容量不足时由
+    // RefreshCompiledFactors 按配置重建。
+    research::RollingBuffer ema_slow_history{64};
     
     // Defensive Logic State
     int defensive_effective_direction{0};
@@ -60,10 +78,27 @@ class StrategyEngine {
     
     // Feature Engine
     research::OnlineFeatureEngine feature_engine{100};
+
+    // 预编译因子表达式：字符串拼接与解析只在配置代数变化时发生一次，
+    // 此后每 tick 走 Evaluate(CompiledExpression) 的零分配求值路径。
+    // 编译产物绑定本 state 的 feature_engine，生命周期同生共死。
+    std::int64_t compiled_config_epoch{-1};
+    research::CompiledExpression ema_fast_expr;
+    research::CompiledExpression ema_slow_expr;
+    research::CompiledExpression breakout_rank_expr;
+    research::CompiledExpression defensive_rank_expr;
   };
 
+  /// 取 event 对应 symbol 的状态槽（按稠密 SymbolId 索引，按需创建）。
+  SymbolState& StateFor(const MarketEvent& event);
+  /// 按当前配置重编译 state 的固定因子表达式（配置代数变化时调用）。
+  void RefreshCompiledFactors(SymbolState* state) const;
+
   StrategyConfig config_;
-  std::unordered_map<std::string, SymbolState> symbol_states_;
+  std::int64_t config_epoch_{0};  ///< SetConfig 递增；见 compiled_config_epoch。
+  // 按 SymbolId 稠密索引的运行态：查找是数组下标而非字符串哈希。
+  // unique_ptr 保证 universe 扩容时已有状态地址稳定。
+  std::vector<std::unique_ptr<SymbolState>> symbol_states_;
 };
 
 }  // namespace ai_trade
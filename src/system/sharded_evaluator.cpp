@@ -0,0 +1,92 @@
+#include "system/sharded_evaluator.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "core/symbol_table.h"
+
+namespace ai_trade {
+
+ShardedEvaluator::ShardedEvaluator(const AppConfig& config,
+                                   std::size_t shard_count) {
+  shard_count = std::max<std::size_t>(shard_count, 1);
+  shards_.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>(config));
+  }
+}
+
+std::size_t ShardedEvaluator::ShardIndexFor(const MarketEvent& event) const {
+  const SymbolId symbol_id = event.symbol_id != kInvalidSymbolId
+                                 ? event.symbol_id
+                                 : InternSymbol(event.symbol);
+  return static_cast<std::size_t>(symbol_id) % shards_.size();
+}
+
+void ShardedEvaluator::Dispatch(const MarketEvent& event) {
+  Shard& shard = *shards_[ShardIndexFor(event)];
+  shard.queue.push_back(event);
+  if (shard.queue.back().symbol_id == kInvalidSymbolId) {
+    shard.queue.back().symbol_id = InternSymbol(event.symbol);
+  }
+}
+
+void ShardedEvaluator::OnFill(const FillEvent& fill) {
+  const SymbolId symbol_id = InternSymbol(fill.symbol);
+  shards_[static_cast<std::size_t>(symbol_id) % shards_.size()]
+      ->system.OnFill(fill);
+}
+
+BatchEvaluateSummary ShardedEvaluator::Drain(
+    std::vector<MarketDecision>* out_intent_decisions) {
+  // 每分片一个线程：分片状态线程亲和，评估期间零跨线程共享。
+  std::vector<std::thread> workers;
+  workers.reserve(shards_.size());
+  for (auto& shard_ptr : shards_) {
+    Shard* shard = shard_ptr.get();
+    shard->summary = BatchEvaluateSummary{};
+    shard->intent_decisions.clear();
+    if (shard->queue.empty()) {
+      continue;
+    }
+    workers.emplace_back([shard]() {
+      shard->system.EvaluateBatch(shard->queue,
+                                  true,
+                                  &shard->intent_decisions,
+                                  &shard->summary);
+      shard->queue.clear();
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  BatchEvaluateSummary merged;
+  for (const auto& shard : shards_) {
+    merged.event_count += shard->summary.event_count;
+    merged.intent_count += shard->summary.intent_count;
+    merged.active_signal_count += shard->summary.active_signal_count;
+    merged.warmup_count += shard->summary.warmup_count;
+    if (out_intent_decisions != nullptr) {
+      out_intent_decisions->insert(out_intent_decisions->end(),
+                                   shard->intent_decisions.begin(),
+                                   shard->intent_decisions.end());
+    }
+  }
+  PublishCrossShardRiskSnapshot();
+  return merged;
+}
+
+void ShardedEvaluator::PublishCrossShardRiskSnapshot() {
+  double total_gross = 0.0;
+  for (const auto& shard : shards_) {
+    total_gross += shard->system.GetAccount().gross_notional_usd();
+  }
+  for (auto& shard : shards_) {
+    const double own_gross = shard->system.GetAccount().gross_notional_usd();
+    shard->system.SetExternalGrossNotionalUsd(
+        std::max(0.0, total_gross - own_gross));
+  }
+}
+
+}  // namespace ai_trade
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "core/config.h"
+#include "system/trade_system.h"
+
+namespace ai_trade {
+
+/**
+ * @brief 多 symbol 决策流水线分片器
+ *
+ * 每个分片独占一个 `TradeSystem` 实例与一段不相交的 symbol 子集
+ * （按稠密 SymbolId 取模路由），分片内部状态线程亲和、互不共享；
+ * `Drain()` 以每分片一个线程并行评估已分派事件后合并结果。
+ *
+ * 账户级风险通过快照共享：每轮 Drain 结束后把其余分片的总敞口
+ * 以 `TradeSystem::SetExternalGrossNotionalUsd` 下发，使各分片的
+ * 账户总名义预算检查覆盖全局敞口而非仅本分片。
+ *
+ * 适用批量吞吐场景（回放校验、断线重连追赶）；实盘主循环的
+ * OMS/WAL/对账链路仍为单线程，不经由本组件。
+ */
+class ShardedEvaluator {
+ public:
+  /**
+   * @param config      应用配置（每个分片各构造一套流水线）
+   * @param shard_count 分片数，通常取物理核数；至少为 1
+   */
+  ShardedEvaluator(const AppConfig& config, std::size_t shard_count);
+
+  /// 事件所属分片下标（同一 symbol 恒定路由到同一分片）。
+  std::size_t ShardIndexFor(const MarketEvent& event) const;
+
+  /// 把事件排入所属分片的待评估队列（不触发评估）。
+  void Dispatch(const MarketEvent& event);
+
+  /// 把成交回报路由到持有该 symbol 的分片账户。
+  void OnFill(const FillEvent& fill);
+
+  /**
+   * @brief 并行排空全部分片队列
+   *
+   * 每分片一个线程执行 `EvaluateBatch`，完成后合并紧凑汇总、收集
+   * 意图决策（按分片序拼接），并刷新跨分片风险快照。
+   */
+  BatchEvaluateSummary Drain(
+      std::vector<MarketDecision>* out_intent_decisions);
+
+  std::size_t shard_count() const { return shards_.size(); }
+
+  /// 直接访问分片流水线（测试与状态巡检用）。
+  TradeSystem& shard(std::size_t index) { return shards_[index]->system; }
+
+ private:
+  struct Shard {
+    explicit Shard(const AppConfig& config) : system(config) {}
+
+    TradeSystem system;
+    std::vector<MarketEvent> queue;
+    // Drain 线程的评估输出（线程私有，join 后合并）。
+    std::vector<MarketDecision> intent_decisions;
+    BatchEvaluateSummary summary;
+  };
+
+  /// 把其余分片的账户总敞口快照下发给每个分片。
+  void PublishCrossShardRiskSnapshot();
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace ai_trade
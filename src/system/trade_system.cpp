@@ -1,15 +1,27 @@
 #include "system/trade_system.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 
+#include "core/line_writer.h"
 #include "core/log.h"
+#include "core/reason_codes.h"
+#include "core/snapshot_io.h"
+#include "core/symbol_table.h"
 
 namespace ai_trade {
 
 namespace {
 
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+// 阶段计时打点：画像关闭时宏展开为空，Evaluate 不含任何时钟调用。
+#define AI_TRADE_EVAL_STAGE_MARK(stage) record_stage(stage)
+#else
+#define AI_TRADE_EVAL_STAGE_MARK(stage)
+#endif
+
 constexpr double kWeightEpsilon = 1e-9;
 constexpr double kNotionalEpsilon = 1e-6;
 
@@ -17,12 +29,41 @@ bool HasExposure(double notional_usd) {
   return std::fabs(notional_usd) > kNotionalEpsilon;
 }
 
-void PushReason(std::vector<std::string>* reasons, const std::string& code) {
+// 动态 reason 回收池上限：每 tick 最多一条 MODEL_<policy>，16 绰绰有余。
+constexpr std::size_t kReasonPoolCap = 16;
+
+// 把 vector<string> 的元素 buffer 移进回收池后清空。Signal 整体拷贝会把
+// 既有元素析构掉，不回收则 MODEL_<policy> 字符串每 tick 重新分配。
+void RecycleReasonBuffers(std::vector<std::string>* reasons,
+                          std::vector<std::string>* pool) {
+  for (std::string& code : *reasons) {
+    if (pool->size() < kReasonPoolCap) {
+      pool->push_back(std::move(code));
+    }
+  }
+  reasons->clear();
+}
+
+// 动态 reason（MODEL_<policy>）无法进固定枚举，保留去重的字符串追加。
+// prefix+code 原位拼进回收池取出的 buffer，稳态下整条路径零堆分配。
+void PushExtraReason(std::vector<std::string>* reasons,
+                     std::string_view prefix,
+                     const std::string& code,
+                     std::vector<std::string>* pool) {
   if (reasons == nullptr || code.empty()) {
     return;
   }
-  if (std::find(reasons->begin(), reasons->end(), code) == reasons->end()) {
-    reasons->push_back(code);
+  std::string entry;
+  if (pool != nullptr && !pool->empty()) {
+    entry = std::move(pool->back());
+    pool->pop_back();
+  }
+  entry.assign(prefix);
+  entry.append(code);
+  if (std::find(reasons->begin(), reasons->end(), entry) == reasons->end()) {
+    reasons->push_back(std::move(entry));
+  } else if (pool != nullptr && pool->size() < kReasonPoolCap) {
+    pool->push_back(std::move(entry));
   }
 }
 
@@ -84,6 +125,100 @@ TradeSystem::TradeSystem(double risk_cap_usd, double max_order_notional_usd,
   evolution_weights_by_bucket_.fill({1.0, 0.0});
 }
 
+void TradeSystem::ApplyHotConfig(const AppConfig& config) {
+  strategy_.SetConfig(config.GetStrategyConfig());
+  regime_.SetConfig(config.regime);
+  execution_.SetConfig(config.GetExecutionEngineConfig());
+}
+
+void TradeSystem::SerializeState(SnapshotWriter* writer) const {
+  account_.SaveState(writer);
+  strategy_.SaveState(writer);
+  regime_.SaveState(writer);
+  risk_.SaveState(writer);
+  writer->Field(evolution_enabled_);
+  for (const auto& weights : evolution_weights_by_bucket_) {
+    writer->Field(weights.trend_weight);
+    writer->Field(weights.defensive_weight);
+  }
+}
+
+bool TradeSystem::RestoreState(SnapshotReader* reader) {
+  account_.LoadState(reader);
+  strategy_.LoadState(reader);
+  regime_.LoadState(reader);
+  risk_.LoadState(reader);
+  reader->Field(evolution_enabled_);
+  for (auto& weights : evolution_weights_by_bucket_) {
+    reader->Field(weights.trend_weight);
+    reader->Field(weights.defensive_weight);
+  }
+  return reader->ok();
+}
+
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+void TradeSystem::RecordEvaluateLatency(
+    const MarketEvent& event,
+    const std::array<std::int64_t, kEvaluateStageCount>& stage_nanos) {
+  // 适配器入口已 intern；OnPrice/单测路径兜底补一次。
+  const SymbolId symbol_id = event.symbol_id != kInvalidSymbolId
+                                 ? event.symbol_id
+                                 : InternSymbol(event.symbol);
+  if (evaluate_latency_.size() <= symbol_id) {
+    evaluate_latency_.resize(symbol_id + 1);
+  }
+  auto& stages = evaluate_latency_[symbol_id];
+  for (std::size_t i = 0; i < kEvaluateStageCount; ++i) {
+    stages[i].Record(stage_nanos[i]);
+  }
+}
+#endif
+
+const LatencyHistogram* TradeSystem::EvaluateLatencyFor(
+    SymbolId symbol_id, EvaluateStage stage) const {
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+  if (symbol_id >= evaluate_latency_.size()) {
+    return nullptr;
+  }
+  const LatencyHistogram& histogram =
+      evaluate_latency_[symbol_id][static_cast<std::size_t>(stage)];
+  return histogram.count() > 0 ? &histogram : nullptr;
+#else
+  (void)symbol_id;
+  (void)stage;
+  return nullptr;
+#endif
+}
+
+std::string TradeSystem::EvaluateLatencySummary() const {
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+  static constexpr const char* kStageNames[kEvaluateStageCount] = {
+      "regime", "strategy", "integrator", "risk", "intent", "total"};
+  std::array<LatencyHistogram, kEvaluateStageCount> merged;
+  for (const auto& stages : evaluate_latency_) {
+    for (std::size_t i = 0; i < kEvaluateStageCount; ++i) {
+      merged[i].Merge(stages[i]);
+    }
+  }
+  if (merged[static_cast<std::size_t>(EvaluateStage::kTotal)].count() == 0) {
+    return std::string();
+  }
+  LineWriter line(512);
+  line.Append("EVAL_LATENCY: ");
+  for (std::size_t i = 0; i < kEvaluateStageCount; ++i) {
+    if (i > 0) {
+      line.Append(", ");
+    }
+    line.Append(kStageNames[i]).Append("={");
+    merged[i].AppendSummary(&line);
+    line.Append('}');
+  }
+  return line.TakeString();
+#else
+  return std::string();
+#endif
+}
+
 bool TradeSystem::OnPrice(double price, bool trade_ok) {
   const MarketEvent event = market_generator_.Next(price);
   const auto decision = Evaluate(event, trade_ok, 0.0);
@@ -117,12 +252,36 @@ MarketDecision TradeSystem::Evaluate(const MarketEvent& event,
                                      bool trade_ok,
                                      double symbol_inflight_notional_usd) {
   MarketDecision decision;
+  Evaluate(event, trade_ok, symbol_inflight_notional_usd, &decision);
+  return decision;
+}
+
+void TradeSystem::Evaluate(const MarketEvent& event,
+                           bool trade_ok,
+                           double symbol_inflight_notional_usd,
+                           MarketDecision* out_decision) {
+  MarketDecision& decision = *out_decision;
+
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+  using ProfileClock = std::chrono::steady_clock;
+  const auto profile_start = ProfileClock::now();
+  auto stage_start = profile_start;
+  std::array<std::int64_t, kEvaluateStageCount> stage_nanos{};
+  const auto record_stage = [&](EvaluateStage stage) {
+    const auto now = ProfileClock::now();
+    stage_nanos[static_cast<std::size_t>(stage)] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - stage_start)
+            .count();
+    stage_start = now;
+  };
+#endif
 
   // 1. Update Account Valuation
   account_.OnMarket(event);
 
   // 2. Regime Analysis
   decision.regime = regime_.OnMarket(event);
+  AI_TRADE_EVAL_STAGE_MARK(EvaluateStage::kRegime);
 
   // 3. Strategy Signal Generation
   decision.base_signal = strategy_.OnMarket(event, account_, decision.regime);
@@ -136,7 +295,7 @@ MarketDecision TradeSystem::Evaluate(const MarketEvent& event,
     decision.base_signal.defensive_notional_usd = 0.0;
     decision.base_signal.direction = 0;
     decision.base_signal.confidence = 0.0;
-    PushReason(&decision.base_signal.reason_codes, "STR_SIGNAL_EXPIRED");
+    SetReason(&decision.base_signal.reason_mask, ReasonCode::kStrSignalExpired);
   }
 
   // 3.1. Evolution Weighting (Optional)
@@ -145,10 +304,15 @@ MarketDecision TradeSystem::Evaluate(const MarketEvent& event,
     decision.base_signal.suggested_notional_usd =
         BlendSignalNotional(decision.base_signal, weights);
     decision.base_signal.direction = SignOf(decision.base_signal.suggested_notional_usd);
-    PushReason(&decision.base_signal.reason_codes, "PORT_EVOLUTION_BLEND");
+    SetReason(&decision.base_signal.reason_mask,
+              ReasonCode::kPortEvolutionBlend);
   }
+  AI_TRADE_EVAL_STAGE_MARK(EvaluateStage::kStrategy);
 
   // 4. Integrator / ML Overlay
+  // 先把上个 tick 的动态 reason 字符串回收进池再整体拷贝：
+  // vector 赋值会析构多余元素，buffer 不回收就得每 tick 重新分配。
+  RecycleReasonBuffers(&decision.signal.extra_reason_codes, &reason_pool_);
   decision.signal = decision.base_signal;
   integrator_shadow_.OnMarket(event);
   decision.shadow = integrator_shadow_.Infer(decision.base_signal, decision.regime);
@@ -159,25 +323,32 @@ MarketDecision TradeSystem::Evaluate(const MarketEvent& event,
       &decision.integrator_confidence,
       &decision.integrator_policy_reason);
   if (!decision.integrator_policy_reason.empty()) {
-    PushReason(&decision.signal.reason_codes,
-               "MODEL_" + decision.integrator_policy_reason);
+    PushExtraReason(&decision.signal.extra_reason_codes, "MODEL_",
+                    decision.integrator_policy_reason, &reason_pool_);
   }
-  if (decision.signal.reason_codes.empty()) {
-    PushReason(&decision.signal.reason_codes, "STR_NO_REASON");
+  if (decision.signal.reason_mask == 0ULL &&
+      decision.signal.extra_reason_codes.empty()) {
+    SetReason(&decision.signal.reason_mask, ReasonCode::kStrNoReason);
   }
+  AI_TRADE_EVAL_STAGE_MARK(EvaluateStage::kIntegrator);
 
   // 5. Risk Management
   decision.target = TargetPosition{decision.signal.symbol, decision.signal.suggested_notional_usd};
-  
-  const double liq_dist = account_.liquidation_distance_p95();
-  decision.risk_adjusted = risk_.Apply(decision.target, trade_ok, account_.drawdown_pct(), liq_dist);
+
+  // 账户级聚合（回撤/强平距离/总敞口）单次遍历持仓表得出，
+  // 供风控判定与 5.1 的总名义预算检查共用。
+  const AccountRiskSnapshot account_risk = account_.BuildRiskSnapshot();
+  decision.risk_adjusted =
+      risk_.Apply(decision.target, trade_ok, account_risk.drawdown_pct,
+                  account_risk.liquidation_distance_pct);
 
   // 5.1. Global Account Gross Notional Check
   const double settled_symbol_notional =
       account_.current_notional_usd(decision.risk_adjusted.symbol);
   const double symbol_current_notional =
       settled_symbol_notional + symbol_inflight_notional_usd;
-  const double settled_gross_notional = account_.gross_notional_usd();
+  const double settled_gross_notional =
+      account_risk.gross_notional_usd + external_gross_notional_usd_;
   const double gross_notional =
       std::max(0.0, settled_gross_notional +
                         std::fabs(symbol_current_notional) -
@@ -190,12 +361,60 @@ MarketDecision TradeSystem::Evaluate(const MarketEvent& event,
     decision.risk_adjusted.adjusted_notional_usd = std::clamp(
         decision.risk_adjusted.adjusted_notional_usd, -symbol_budget, symbol_budget);
   }
+  AI_TRADE_EVAL_STAGE_MARK(EvaluateStage::kRisk);
 
   // 6. Execution
-  decision.intent = execution_.BuildIntent(decision.risk_adjusted,
-                                           symbol_current_notional,
-                                           event.price);
-  return decision;
+  // 原位构造：optional 持续有值时 client_order_id 等字符串容量跨 tick 保留；
+  // 无单 tick 先把 id buffer 挪进 scratch 再 reset，下次发单时归还。
+  if (!decision.intent.has_value()) {
+    decision.intent.emplace();
+    decision.intent->client_order_id = std::move(order_id_scratch_);
+  }
+  if (!execution_.BuildIntentInto(decision.risk_adjusted,
+                                  symbol_current_notional, event.price,
+                                  &*decision.intent)) {
+    order_id_scratch_ = std::move(decision.intent->client_order_id);
+    decision.intent.reset();
+  }
+  AI_TRADE_EVAL_STAGE_MARK(EvaluateStage::kIntent);
+
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+  stage_nanos[static_cast<std::size_t>(EvaluateStage::kTotal)] =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          ProfileClock::now() - profile_start)
+          .count();
+  RecordEvaluateLatency(event, stage_nanos);
+#endif
+}
+
+std::size_t TradeSystem::EvaluateBatch(
+    std::span<const MarketEvent> events,
+    bool trade_ok,
+    std::vector<MarketDecision>* out_intent_decisions,
+    BatchEvaluateSummary* out_summary) {
+  BatchEvaluateSummary summary;
+  // 单个决策对象跨事件复用，字符串/向量容量保留，稳态零堆分配。
+  MarketDecision scratch;
+  for (const MarketEvent& event : events) {
+    Evaluate(event, trade_ok, 0.0, &scratch);
+    ++summary.event_count;
+    if (scratch.signal.direction != 0) {
+      ++summary.active_signal_count;
+    }
+    if (scratch.regime.warmup) {
+      ++summary.warmup_count;
+    }
+    if (scratch.intent.has_value()) {
+      ++summary.intent_count;
+      if (out_intent_decisions != nullptr) {
+        out_intent_decisions->push_back(scratch);
+      }
+    }
+  }
+  if (out_summary != nullptr) {
+    *out_summary = summary;
+  }
+  return summary.intent_count;
 }
 
 void TradeSystem::OnFill(const FillEvent& fill) {
@@ -212,9 +431,9 @@ void TradeSystem::SyncAccountFromRemotePositions(
   account_.SyncFromRemotePositions(positions, baseline_cash_usd);
 }
 
-void TradeSystem::RefreshAccountRiskFromRemotePositions(
+bool TradeSystem::RefreshAccountRiskFromRemotePositions(
     const std::vector<RemotePositionSnapshot>& positions) {
-  account_.RefreshRiskFromRemotePositions(positions);
+  return account_.RefreshRiskFromRemotePositions(positions);
 }
 
 void TradeSystem::ForceSyncAccountPositionsFromRemote(
@@ -278,9 +497,10 @@ bool TradeSystem::ApplyIntegratorPolicy(const ShadowInference& shadow,
                                         std::string* out_reason) const {
   if (!inout_signal) return false;
 
-  auto set_out = [&](double conf, const std::string& reason) {
+  // string_view + assign：reason 都是字面量，避免每 tick 构造临时 string。
+  auto set_out = [&](double conf, std::string_view reason) {
     if (out_confidence) *out_confidence = conf;
-    if (out_reason) *out_reason = reason;
+    if (out_reason) out_reason->assign(reason);
   };
 
   set_out(0.0, "");
@@ -2,10 +2,12 @@
 
 #include <array>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "core/config.h"
+#include "core/latency_histogram.h"
 #include "core/types.h"
 #include "execution/execution_engine.h"
 #include "market/market_data.h"
@@ -17,6 +19,29 @@
 
 namespace ai_trade {
 
+class SnapshotWriter;
+class SnapshotReader;
+
+/// 批量评估的紧凑汇总：为未产生意图的事件保留的全部观测口径。
+struct BatchEvaluateSummary {
+  std::size_t event_count{0};    ///< 已处理事件数。
+  std::size_t intent_count{0};   ///< 产生订单意图的事件数。
+  std::size_t active_signal_count{0};  ///< 最终信号方向非零的事件数。
+  std::size_t warmup_count{0};   ///< Regime 仍处 warmup 的事件数。
+};
+
+/// Evaluate 流水线阶段（延迟画像维度）。
+enum class EvaluateStage : std::uint8_t {
+  kRegime = 0,
+  kStrategy,
+  kIntegrator,
+  kRisk,
+  kIntent,
+  kTotal,
+};
+
+inline constexpr std::size_t kEvaluateStageCount = 6;
+
 // Snapshot of the decision pipeline for auditing/logging
 struct MarketDecision {
   RegimeState regime;
@@ -54,6 +79,28 @@ class TradeSystem {
                           bool trade_ok = true,
                           double symbol_inflight_notional_usd = 0.0);
 
+  /// 零分配变体：填充调用方复用的决策对象，保留其字符串/向量容量。
+  /// 每个字段都会被无条件覆盖，跨 tick 复用同一对象是安全的。
+  void Evaluate(const MarketEvent& event,
+                bool trade_ok,
+                double symbol_inflight_notional_usd,
+                MarketDecision* out_decision);
+
+  /**
+   * @brief 批量评估（回放校验 / 断线重连后的事件追赶）
+   *
+   * 单个决策对象跨事件复用，仅对产生订单意图的事件把完整
+   * `MarketDecision` 追加到 `out_intent_decisions` 作审计记录，其余
+   * 事件只累计 `out_summary` 紧凑汇总。批量路径不含在途名义修正
+   * （逐事件口径与 `Evaluate(event, trade_ok)` 一致）。
+   *
+   * @return 产生订单意图的事件数
+   */
+  std::size_t EvaluateBatch(std::span<const MarketEvent> events,
+                            bool trade_ok,
+                            std::vector<MarketDecision>* out_intent_decisions,
+                            BatchEvaluateSummary* out_summary = nullptr);
+
   /// Simplified entry point returning just the order intent (if any).
   std::optional<OrderIntent> OnMarket(const MarketEvent& event,
                                       bool trade_ok = true,
@@ -73,7 +120,8 @@ class TradeSystem {
       const std::vector<RemotePositionSnapshot>& positions,
       double baseline_cash_usd = 10000.0);
       
-  void RefreshAccountRiskFromRemotePositions(
+  /// @return true 表示远端快照相对上轮纪元有变化并已应用（见 AccountState）。
+  bool RefreshAccountRiskFromRemotePositions(
       const std::vector<RemotePositionSnapshot>& positions);
       
   void ForceSyncAccountPositionsFromRemote(
@@ -82,8 +130,26 @@ class TradeSystem {
   void SyncAccountFromRemoteBalance(const RemoteAccountBalanceSnapshot& balance,
                                     bool reset_peak_to_equity);
 
+  // --- State Snapshot ---
+
+  /// 把全部引擎运行态写入快照字段流：账户、策略/Regime 各 symbol
+  /// 状态（含特征引擎窗口）、风控状态机与进化权重。
+  void SerializeState(SnapshotWriter* writer) const;
+  /// 按相同字段顺序恢复运行态；返回 false 表示快照流损坏（此时状态
+  /// 可能已被部分覆盖，仅应在启动、尚未开始交易前调用）。
+  bool RestoreState(SnapshotReader* reader);
+
   // --- Configuration & Control ---
 
+  /// 热更新可在线调整的子配置（策略/Regime/执行与保护），不重置运行态。
+  void ApplyHotConfig(const AppConfig& config);
+
+  /// 启动期用历史 K 线事件预热 Regime 状态机（按 symbol 并行），
+  /// 让 warmup 在首个实时 tick 之前清除；返回已出 warmup 的 symbol 数。
+  std::size_t WarmStartRegime(std::span<const MarketEvent> events) {
+    return regime_.PreloadHistory(events);
+  }
+
   void EnableEvolution(bool enabled) { evolution_enabled_ = enabled; }
   
   bool SetEvolutionWeights(double trend_weight, double defensive_weight,
@@ -101,11 +167,26 @@ class TradeSystem {
   
   // Risk Control
   void ForceReduceOnly(bool enabled) { risk_.SetForcedReduceOnly(enabled); }
+
+  /// 分片模式下由调度器下发的“其余分片账户总敞口”快照（USD）。
+  /// 计入账户总名义预算检查，使分片的风险口径覆盖全局敞口。
+  void SetExternalGrossNotionalUsd(double gross_notional_usd) {
+    external_gross_notional_usd_ =
+        gross_notional_usd > 0.0 ? gross_notional_usd : 0.0;
+  }
   RiskMode GetRiskMode() const { return risk_.mode(); }
 
   // Accessors
   const AccountState& GetAccount() const { return account_; }
 
+  // --- Latency Profiling（编译期开关 AI_TRADE_EVAL_LATENCY_PROFILING）---
+
+  /// 某 symbol 某阶段的延迟直方图；无样本或画像关闭时返回 nullptr。
+  const LatencyHistogram* EvaluateLatencyFor(SymbolId symbol_id,
+                                             EvaluateStage stage) const;
+  /// 聚合全部 symbol 的各阶段延迟摘要行；无样本或画像关闭时返回空串。
+  std::string EvaluateLatencySummary() const;
+
   // Compatibility shims for legacy call sites.
   const AccountState& account() const { return GetAccount(); }
   IntegratorMode integrator_mode() const { return GetIntegratorMode(); }
@@ -133,12 +214,31 @@ class TradeSystem {
   // Configuration
   IntegratorConfig integrator_config_;
   double max_account_gross_notional_usd_;
+  /// 跨分片共享的外部敞口快照（非分片模式恒为 0）。
+  double external_gross_notional_usd_{0.0};
   bool evolution_enabled_{false};
   std::array<EvolutionWeights, 3> evolution_weights_by_bucket_;
 
+  /// 动态 reason（MODEL_<policy>）字符串 buffer 回收池：Evaluate 每 tick
+  /// 复用，避免 extra_reason_codes 被 Signal 拷贝析构后重新分配。
+  std::vector<std::string> reason_pool_;
+  /// client_order_id 的 buffer 暂存：无单 tick reset intent 前挪出来，
+  /// 避免发单/不发单交替时反复分配。
+  std::string order_id_scratch_;
+
   // Helpers
   bool ApplyIntegratorPolicy(const ShadowInference& shadow, Signal* inout_signal,
                              double* out_confidence, std::string* out_reason) const;
+
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
+  void RecordEvaluateLatency(
+      const MarketEvent& event,
+      const std::array<std::int64_t, kEvaluateStageCount>& stage_nanos);
+
+  // 延迟画像：外层按 SymbolId 稠密索引，内层按阶段。
+  std::vector<std::array<LatencyHistogram, kEvaluateStageCount>>
+      evaluate_latency_;
+#endif
 };
 
 }  // namespace ai_trade
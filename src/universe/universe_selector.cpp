@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 #include <unordered_set>
 #include <utility>
 
@@ -11,6 +13,14 @@ namespace {
 
 constexpr double kEpsilon = 1e-9;
 
+/// 24h 成交额 EWMA 平滑系数：首个观测直接作为初值，之后指数平滑，
+/// 单笔 ticker 的成交额抖动不会直接触发过滤门槛翻转。
+constexpr double kTurnoverEwmaAlpha = 0.2;
+
+/// 主评分榜需要保持有序的前缀长度下限：UNIVERSE_UPDATE 日志展示
+/// top_scores 前 5 名，部分排序的前缀至少覆盖到这里。
+constexpr int kScoreLogTopN = 5;
+
 struct CandidateScore {
   std::string symbol;
   double score{0.0};
@@ -61,7 +71,13 @@ std::optional<UniverseUpdate> UniverseSelector::OnMarket(const MarketEvent& even
     stats.has_last_price = true;
   }
   ++stats.tick_count;
-  stats.last_turnover = event.volume * price; // 估算 24h 成交额 (volume 为 24h 基础币种量)
+  const double turnover = event.volume * price; // 估算 24h 成交额 (volume 为 24h 基础币种量)
+  if (stats.has_turnover) {
+    stats.turnover_ewma += kTurnoverEwmaAlpha * (turnover - stats.turnover_ewma);
+  } else {
+    stats.turnover_ewma = turnover;
+    stats.has_turnover = true;
+  }
 
   // 按 tick 间隔触发刷新，避免每个行情都重排 Universe。
   ++ticks_since_update_;
@@ -108,7 +124,9 @@ bool UniverseSelector::IsActive(const std::string& symbol) const {
   if (!config_.enabled) {
     return true;
   }
-  return active_symbol_set_.count(symbol) != 0U;
+  const std::shared_ptr<const SymbolSet> snapshot =
+      active_snapshot_.load(std::memory_order_acquire);
+  return snapshot->count(symbol) != 0U;
 }
 
 std::optional<UniverseUpdate> UniverseSelector::Refresh() {
@@ -134,7 +152,7 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
     }
     const MarketStats& stats = it->second;
     // 过滤：成交额不足
-    if (stats.last_turnover < config_.min_turnover_usd) {
+    if (stats.turnover_ewma < config_.min_turnover_usd) {
       continue;
     }
     // 主评分偏向稳健成交与波动；趋势评分用于保留探索槽，避免 live 长期锁死在
@@ -156,14 +174,26 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
     candidate_scores.push_back(CandidateScore{symbol, score, trend_score});
   }
 
-  // 按分数降序排列
-  std::sort(candidate_scores.begin(), candidate_scores.end(),
-            [](const CandidateScore& lhs, const CandidateScore& rhs) {
-              if (std::fabs(lhs.score - rhs.score) > 1e-12) {
-                return lhs.score > rhs.score;
-              }
-              return lhs.symbol < rhs.symbol;
-            });
+  const int reserve_slots =
+      (config_.trend_reserve_enabled ? config_.trend_reserve_slots : 0);
+  const int core_slots = std::max(0, config_.max_active_symbols - reserve_slots);
+
+  // 选型与日志只依赖榜单前缀：核心槽数与 top_scores 展示条数取较大者，
+  // 用 O(n log k) 堆式部分排序替代全量排序，候选池扩大时刷新成本
+  // 只随 k 增长。前缀之外的候选保持任意顺序。
+  const std::size_t ranked_prefix =
+      std::min(candidate_scores.size(),
+               static_cast<std::size_t>(std::max(core_slots, kScoreLogTopN)));
+  std::partial_sort(candidate_scores.begin(),
+                    candidate_scores.begin() +
+                        static_cast<std::ptrdiff_t>(ranked_prefix),
+                    candidate_scores.end(),
+                    [](const CandidateScore& lhs, const CandidateScore& rhs) {
+                      if (std::fabs(lhs.score - rhs.score) > 1e-12) {
+                        return lhs.score > rhs.score;
+                      }
+                      return lhs.symbol < rhs.symbol;
+                    });
 
   std::vector<std::string> selected;
   selected.reserve(static_cast<std::size_t>(config_.max_active_symbols));
@@ -174,9 +204,6 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
   for (const auto& candidate : candidate_scores) {
     candidate_score_symbols.insert(candidate.symbol);
   }
-  const int reserve_slots =
-      (config_.trend_reserve_enabled ? config_.trend_reserve_slots : 0);
-  const int core_slots = std::max(0, config_.max_active_symbols - reserve_slots);
 
   for (const auto& candidate : candidate_scores) {
     if (static_cast<int>(selected.size()) >= core_slots) {
@@ -222,17 +249,27 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
     }
 
     std::vector<CandidateScore> trend_candidates = candidate_scores;
-    std::sort(trend_candidates.begin(), trend_candidates.end(),
-              [](const CandidateScore& lhs, const CandidateScore& rhs) {
-                if (std::fabs(lhs.trend_score - rhs.trend_score) > 1e-12) {
-                  return lhs.trend_score > rhs.trend_score;
-                }
-                if (std::fabs(lhs.score - rhs.score) > 1e-12) {
-                  return lhs.score > rhs.score;
-                }
-                return lhs.symbol < rhs.symbol;
-              });
-    for (const auto& candidate : trend_candidates) {
+    // 趋势榜同样只需前缀有序：前 (已选数 + 预留槽数) 名中已选的至多
+    // 占 已选数 个，剩余必然足够填满预留槽，无需全排序。
+    const std::size_t trend_ranked_prefix =
+        std::min(trend_candidates.size(),
+                 selected.size() + static_cast<std::size_t>(reserve_slots));
+    std::partial_sort(trend_candidates.begin(),
+                      trend_candidates.begin() +
+                          static_cast<std::ptrdiff_t>(trend_ranked_prefix),
+                      trend_candidates.end(),
+                      [](const CandidateScore& lhs, const CandidateScore& rhs) {
+                        if (std::fabs(lhs.trend_score - rhs.trend_score) >
+                            1e-12) {
+                          return lhs.trend_score > rhs.trend_score;
+                        }
+                        if (std::fabs(lhs.score - rhs.score) > 1e-12) {
+                          return lhs.score > rhs.score;
+                        }
+                        return lhs.symbol < rhs.symbol;
+                      });
+    for (std::size_t i = 0; i < trend_ranked_prefix; ++i) {
+      const CandidateScore& candidate = trend_candidates[i];
       if (static_cast<int>(selected.size()) >= config_.max_active_symbols) {
         break;
       }
@@ -292,12 +329,14 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
 
   active_symbols_ = std::move(selected);
   RebuildActiveSet();
+  const std::shared_ptr<const SymbolSet> active_snapshot =
+      active_snapshot_.load(std::memory_order_acquire);
 
   std::unordered_map<std::string, int> next_residency;
   if (reserve_slots > 0 &&
       config_.trend_reserve_min_residency_refreshes > 0 && !degraded) {
     for (const auto& [symbol, remaining] : trend_reserve_residency_remaining_) {
-      if (remaining <= 0 || active_symbol_set_.count(symbol) == 0U ||
+      if (remaining <= 0 || active_snapshot->count(symbol) == 0U ||
           !IsAllowed(symbol) || candidate_score_symbols.count(symbol) == 0U) {
         continue;
       }
@@ -322,7 +361,7 @@ std::optional<UniverseUpdate> UniverseSelector::Refresh() {
                     symbol) != sticky_trend_reserve_symbols.end()) {
         continue;
       }
-      if (active_symbol_set_.count(symbol) == 0U) {
+      if (active_snapshot->count(symbol) == 0U) {
         continue;
       }
       next_residency[symbol] =
@@ -378,10 +417,14 @@ std::vector<std::string> UniverseSelector::UniqueSymbols(
 }
 
 void UniverseSelector::RebuildActiveSet() {
-  active_symbol_set_.clear();
+  auto next = std::make_shared<SymbolSet>();
+  next->reserve(active_symbols_.size());
   for (const auto& symbol : active_symbols_) {
-    active_symbol_set_.insert(symbol);
+    next->insert(symbol);
   }
+  // 整体换代：旧快照由仍持有引用的读者自然回收，读侧永不阻塞。
+  active_snapshot_.store(std::shared_ptr<const SymbolSet>(std::move(next)),
+                         std::memory_order_release);
 }
 
 bool UniverseSelector::IsAllowed(const std::string& symbol) const {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -33,6 +35,10 @@ struct UniverseUpdate {
  * 2. 打分：基于波动率 (Volatility) 和流动性 (Liquidity/Activity) 评分。
  * 3. 截断：保留 Top N 个标的作为 Active Universe。
  * 4. 降级：若筛选结果为空，回退到默认标的 (Fallback)。
+ *
+ * 选型按 O(n log k) 堆式部分排序截取 Top-k（候选池扩到全量永续
+ * 宇宙时刷新成本不随池子全排序增长）；生效集合以不可变快照挂在
+ * 原子指针后发布，决策路径读成员关系无锁且不受刷新换代影响。
  */
 class UniverseSelector {
  public:
@@ -53,8 +59,12 @@ class UniverseSelector {
     double signed_return_sum{0.0};  ///< 有方向收益率累积和（趋势性近似）。
     int return_count{0};  ///< 有效收益率样本数。
     int tick_count{0};  ///< 观测到的行情 tick 数（活跃度近似）。
-    double last_turnover{0.0}; ///< 最近一次观测到的 24h 成交额 (USD)。
+    /// 24h 成交额 EWMA (USD)：首个观测即为初值，之后指数平滑，
+    /// 抑制单笔 ticker 抖动对成交额门槛过滤的影响。
+    double turnover_ewma{0.0};
+    bool has_turnover{false};  ///< turnover_ewma 是否已有观测。
   };
+  using SymbolSet = std::unordered_set<std::string>;
 
   std::optional<UniverseUpdate> Refresh();
   void ResetWindowStats();
@@ -71,7 +81,10 @@ class UniverseSelector {
   std::unordered_map<std::string, MarketStats> stats_by_symbol_;  ///< symbol 统计状态。
   std::unordered_set<std::string> seen_symbols_;  ///< 已观测到的 symbol 集合。
   std::vector<std::string> active_symbols_;  ///< 当前活跃币对列表（有序）。
-  std::unordered_set<std::string> active_symbol_set_;  ///< 当前活跃币对集合（快速查找）。
+  /// 当前活跃币对集合：不可变快照 + 原子指针换代，读侧（决策路径的
+  /// IsActive）无锁取快照查询，写侧整体替换，读写互不阻塞。
+  std::atomic<std::shared_ptr<const SymbolSet>> active_snapshot_{
+      std::make_shared<const SymbolSet>()};
   std::unordered_map<std::string, int>
       trend_reserve_residency_remaining_;  ///< trend reserve 最小驻留剩余刷新次数。
   bool allowed_symbol_filter_enabled_{false};  ///< 是否启用交易规则白名单过滤。
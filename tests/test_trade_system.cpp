@@ -1,3 +1,13 @@
+#include <arpa/inet.h>
+#include <sched.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cctype>
 #include <cstdint>
@@ -6,7 +16,11 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -22,25 +36,56 @@
 #pragma clang diagnostic pop
 #endif
 #include "app/intent_policy.h"
+#include "core/arena.h"
+#include "core/clock.h"
 #include "core/config.h"
+#include "core/config_watcher.h"
+#include "core/json_utils.h"
+#include "core/latency_histogram.h"
+#include "core/line_writer.h"
+#include "core/log.h"
+#include "core/reason_codes.h"
+#include "core/spsc_ring.h"
+#include "core/symbol_table.h"
+#include "core/thread_topology.h"
+#include "core/timer_wheel.h"
 #include "exchange/bybit_exchange_adapter.h"
+#include "exchange/bybit_kline_backfill.h"
+#include "system/sharded_evaluator.h"
 #include "exchange/bybit_private_stream.h"
 #include "exchange/bybit_public_stream.h"
 #include "exchange/bybit_rest_client.h"
 #include "exchange/mock_exchange_adapter.h"
+#include "exchange/mux_exchange_adapter.h"
 #include "exchange/websocket_client.h"
+#include "evolution/evolution_pipeline.h"
 #include "evolution/self_evolution_controller.h"
+#include "execution/async_executor.h"
 #include "execution/execution_engine.h"
 #include "execution/order_throttle.h"
+#include "execution/quantization.h"
+#include "market/order_book.h"
 #include "monitor/gate_monitor.h"
+#include "monitor/metrics_http_server.h"
+#include "monitor/metrics_registry.h"
+#include "monitor/sharded_symbol_stats.h"
+#include "monitor/shm_event_bus.h"
+#include "monitor/state_delta_stream.h"
 #include "oms/order_manager.h"
 #include "oms/reconciler.h"
 #include "regime/regime_engine.h"
+#include "replay/replay_engine.h"
+#include "replay/walk_forward.h"
+#include "research/bar_store.h"
+#include "research/feature_store_builder.h"
 #include "research/ic_evaluator.h"
 #include "research/miner.h"
 #include "research/online_feature_engine.h"
 #include "research/time_series_operators.h"
 #include "risk/risk_engine.h"
+#include "storage/decision_journal.h"
+#include "strategy/oblivious_tree_model.h"
+#include "storage/state_snapshot.h"
 #include "storage/wal_store.h"
 #include "system/trade_system.h"
 #include "universe/universe_selector.h"
@@ -93,6 +138,132 @@ class CoarseStepMockAdapter final : public ai_trade::MockExchangeAdapter {
   std::string symbol_;
 };
 
+/// 线程安全记录适配器：多通道执行器测试用，按 symbol 记录提交顺序。
+class LaneRecordingAdapter final : public ai_trade::MockExchangeAdapter {
+ public:
+  LaneRecordingAdapter()
+      : MockExchangeAdapter(std::vector<double>{100.0},
+                            std::vector<std::string>{"BTCUSDT", "ETHUSDT"}) {}
+
+  bool SubmitOrder(const ai_trade::OrderIntent& intent) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitted_by_symbol_[intent.symbol].push_back(intent.client_order_id);
+    return true;
+  }
+
+  bool SubmitOrders(std::span<const ai_trade::OrderIntent> intents,
+                    std::vector<bool>* out_ok) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batch_sizes_.push_back(intents.size());
+    }
+    return ExchangeAdapter::SubmitOrders(intents, out_ok);
+  }
+
+  bool CancelOrder(const std::string& client_order_id) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_.push_back(client_order_id);
+    return true;
+  }
+
+  std::vector<std::string> SubmittedFor(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = submitted_by_symbol_.find(symbol);
+    return it != submitted_by_symbol_.end() ? it->second
+                                            : std::vector<std::string>{};
+  }
+
+  std::vector<std::string> Cancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+  }
+
+  std::vector<std::size_t> BatchSizes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_sizes_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<std::string>>
+      submitted_by_symbol_;
+  std::vector<std::string> cancelled_;
+  std::vector<std::size_t> batch_sizes_;
+};
+
+/// 多所 mux 测试桩：脚本化行情队列 + 记录执行调用（行情被 venue 线程消费）。
+class MuxVenueStubAdapter final : public ai_trade::MockExchangeAdapter {
+ public:
+  explicit MuxVenueStubAdapter(std::vector<ai_trade::MarketEvent> events,
+                               bool connect_ok = true)
+      : MockExchangeAdapter(std::vector<double>{100.0},
+                            std::vector<std::string>{"BTCUSDT", "ETHUSDT"}),
+        events_(std::move(events)),
+        connect_ok_(connect_ok) {}
+
+  bool Connect() override { return connect_ok_; }
+  bool TradeOk() const override { return connect_ok_; }
+
+  bool PollMarket(ai_trade::MarketEvent* out_event) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (next_ >= events_.size()) {
+      return false;
+    }
+    *out_event = events_[next_++];
+    return true;
+  }
+
+  bool SubmitOrder(const ai_trade::OrderIntent& intent) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitted_.push_back(intent.client_order_id);
+    return true;
+  }
+
+  bool SubmitOrders(std::span<const ai_trade::OrderIntent> intents,
+                    std::vector<bool>* out_ok) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batch_sizes_.push_back(intents.size());
+    }
+    return ExchangeAdapter::SubmitOrders(intents, out_ok);
+  }
+
+  bool CancelOrder(const std::string& client_order_id) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_.push_back(client_order_id);
+    return true;
+  }
+
+  bool Drained() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_ >= events_.size();
+  }
+
+  std::vector<std::string> Submitted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return submitted_;
+  }
+
+  std::vector<std::string> Cancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+  }
+
+  std::vector<std::size_t> BatchSizes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_sizes_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<ai_trade::MarketEvent> events_;
+  std::size_t next_{0};
+  bool connect_ok_{true};
+  std::vector<std::string> submitted_;
+  std::vector<std::string> cancelled_;
+  std::vector<std::size_t> batch_sizes_;
+};
+
 bool WriteIntegratorReportFile(const std::filesystem::path& path,
                                double auc_mean,
                                double delta_auc,
@@ -393,6 +564,13 @@ class MockBybitHttpTransport final : public ai_trade::BybitHttpTransport {
     ai_trade::BybitHttpResponse response;
   };
 
+  MockBybitHttpTransport() = default;
+  // transport 工厂按值克隆路由表；互斥量不可复制，新实例各自持有。
+  MockBybitHttpTransport(const MockBybitHttpTransport& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    routes_ = other.routes_;
+  }
+
   void AddRoute(const std::string& method,
                 const std::string& url_contains,
                 ai_trade::BybitHttpResponse response) {
@@ -405,6 +583,8 @@ class MockBybitHttpTransport final : public ai_trade::BybitHttpTransport {
       const std::vector<std::pair<std::string, std::string>>& headers,
       const std::string& body) const override {
     (void)headers;
+    // 回补引擎并发调用同一 transport：加锁保护 last_* 与路由查找。
+    std::lock_guard<std::mutex> lock(mutex_);
     last_method_ = method;
     last_url_ = url;
     last_body_ = body;
@@ -426,6 +606,7 @@ class MockBybitHttpTransport final : public ai_trade::BybitHttpTransport {
 
  private:
   std::vector<Route> routes_;
+  mutable std::mutex mutex_;
   mutable std::string last_method_;
   mutable std::string last_url_;
   mutable std::string last_body_;
@@ -1105,10 +1286,8 @@ int main() {
     }
     const auto signal = strategy.OnMarket(ai_trade::MarketEvent{
         900, "BTCUSDT", 121.0, 121.0}, dummy_account, regime);
-    const bool has_rank_reason = std::find(signal.reason_codes.begin(),
-                                           signal.reason_codes.end(),
-                                           "STR_DEFENSIVE_RANK_TRIGGER") !=
-                                 signal.reason_codes.end();
+    const bool has_rank_reason = ai_trade::HasReason(
+        signal.reason_mask, ai_trade::ReasonCode::kStrDefensiveRankTrigger);
     if (signal.defensive_notional_usd >= 0.0 || !has_rank_reason) {
       std::cerr << "defensive_rank 信号应触发反向防御分量并输出 rank reason\n";
       return 1;
@@ -1211,10 +1390,8 @@ int main() {
     }
     const auto signal = strategy.OnMarket(ai_trade::MarketEvent{
         900, "BTCUSDT", 101.0, 101.0}, dummy_account, regime);
-    const bool blocked = std::find(signal.reason_codes.begin(),
-                                   signal.reason_codes.end(),
-                                   "STR_RANGE_CONFIDENCE_BLOCK") !=
-                         signal.reason_codes.end();
+    const bool blocked = ai_trade::HasReason(
+        signal.reason_mask, ai_trade::ReasonCode::kStrRangeConfidenceBlock);
     if (signal.direction != 0 ||
         !NearlyEqual(signal.suggested_notional_usd, 0.0, 1e-9) ||
         signal.confidence != 0.0 || !blocked) {
@@ -1252,10 +1429,8 @@ int main() {
         1250, "BTCUSDT", 101.0, 101.0}, dummy_account, trend_regime);
     const auto range_signal = strategy.OnMarket(ai_trade::MarketEvent{
         1251, "BTCUSDT", 101.2, 101.2}, dummy_account, range_regime);
-    const bool scaled = std::find(range_signal.reason_codes.begin(),
-                                  range_signal.reason_codes.end(),
-                                  "STR_TREND_BUCKET_SCALED") !=
-                        range_signal.reason_codes.end();
+    const bool scaled = ai_trade::HasReason(
+        range_signal.reason_mask, ai_trade::ReasonCode::kStrTrendBucketScaled);
     if (!(std::fabs(range_signal.trend_notional_usd) <
           std::fabs(trend_signal.trend_notional_usd)) ||
         !NearlyEqual(std::fabs(range_signal.trend_notional_usd),
@@ -1298,10 +1473,9 @@ int main() {
         1300, "BTCUSDT", 101.0, 101.0}, dummy_account, regime);
     const auto eth_signal = strategy.OnMarket(ai_trade::MarketEvent{
         2300, "ETHUSDT", 101.0, 101.0}, dummy_account, regime);
-    const bool eth_scaled = std::find(eth_signal.reason_codes.begin(),
-                                      eth_signal.reason_codes.end(),
-                                      "STR_DEFENSIVE_ETH_RANGE_SCALED") !=
-                            eth_signal.reason_codes.end();
+    const bool eth_scaled =
+        ai_trade::HasReason(eth_signal.reason_mask,
+                            ai_trade::ReasonCode::kStrDefensiveEthRangeScaled);
     if (!(std::fabs(eth_signal.defensive_notional_usd) <
           std::fabs(btc_signal.defensive_notional_usd)) ||
         !NearlyEqual(std::fabs(eth_signal.defensive_notional_usd),
@@ -1341,10 +1515,8 @@ int main() {
     }
     const auto signal = strategy.OnMarket(ai_trade::MarketEvent{
         3300, "BTCUSDT", 101.0, 101.0}, dummy_account, regime);
-    const bool blocked = std::find(signal.reason_codes.begin(),
-                                   signal.reason_codes.end(),
-                                   "STR_EXTREME_BLOCK") !=
-                         signal.reason_codes.end();
+    const bool blocked = ai_trade::HasReason(
+        signal.reason_mask, ai_trade::ReasonCode::kStrExtremeBlock);
     if (signal.direction != 0 ||
         !NearlyEqual(signal.suggested_notional_usd, 0.0, 1e-9) ||
         signal.confidence != 0.0 || !blocked) {
@@ -1354,7 +1526,7 @@ int main() {
   }
 
   {
-    // Signal 必须携带有效期与 reason_codes，满足审计约束。
+    // Signal 必须携带有效期与非空 reason 掩码，满足审计约束。
     ai_trade::StrategyEngine strategy(ai_trade::StrategyConfig{
         .signal_notional_usd = 1000.0,
         .signal_deadband_abs = 0.0,
@@ -1379,8 +1551,12 @@ int main() {
                                           dummy_account,
                                           regime);
     if (signal.valid_until_ms <= (1000 + 20 * 5000) ||
-        signal.reason_codes.empty()) {
-      std::cerr << "Signal 应包含有效期与非空 reason_codes\n";
+        signal.reason_mask == 0ULL) {
+      std::cerr << "Signal 应包含有效期与非空 reason 掩码\n";
+      return 1;
+    }
+    if (ai_trade::ExpandReasonMask(signal.reason_mask).empty()) {
+      std::cerr << "ExpandReasonMask 应为非空掩码产出审计字符串\n";
       return 1;
     }
   }
@@ -1543,6 +1719,56 @@ int main() {
     }
   }
 
+  {
+    // 远端风险刷新的增量纪元：快照不变走快路径，变化时只应用变更条目。
+    ai_trade::AccountState account;
+    const std::vector<ai_trade::RemotePositionSnapshot> snapshot = {
+        ai_trade::RemotePositionSnapshot{
+            .symbol = "BTCUSDT",
+            .qty = 1.0,
+            .avg_entry_price = 100.0,
+            .mark_price = 100.0,
+            .liquidation_price = 90.0,
+        },
+        ai_trade::RemotePositionSnapshot{
+            .symbol = "ETHUSDT",
+            .qty = 2.0,
+            .avg_entry_price = 2000.0,
+            .mark_price = 2000.0,
+            .liquidation_price = 1800.0,
+        },
+    };
+    if (!account.RefreshRiskFromRemotePositions(snapshot)) {
+      std::cerr << "首轮远端风险刷新应报告快照变化\n";
+      return 1;
+    }
+
+    // 本地行情推进 BTC mark；相同快照重放应走快路径，不回写陈旧 mark。
+    account.OnMarket(ai_trade::MarketEvent{1, "BTCUSDT", 105.0, 105.0});
+    if (account.RefreshRiskFromRemotePositions(snapshot)) {
+      std::cerr << "相同快照重放应走无变化快路径\n";
+      return 1;
+    }
+    if (!NearlyEqual(account.mark_price("BTCUSDT"), 105.0, 1e-9)) {
+      std::cerr << "快路径不应覆盖本地更新的 mark 价格\n";
+      return 1;
+    }
+
+    // 只有 ETH 条目变化：BTC 条目未变不应被重放，ETH 风险字段应更新。
+    auto moved = snapshot;
+    moved[1].mark_price = 2100.0;
+    moved[1].liquidation_price = 1850.0;
+    if (!account.RefreshRiskFromRemotePositions(moved)) {
+      std::cerr << "快照变化后应报告并应用增量\n";
+      return 1;
+    }
+    if (!NearlyEqual(account.mark_price("BTCUSDT"), 105.0, 1e-9) ||
+        !NearlyEqual(account.mark_price("ETHUSDT"), 2100.0, 1e-9)) {
+      std::cerr << "增量应用后 mark 价格不符合预期\n";
+      return 1;
+    }
+  }
+
   {
     ai_trade::AccountState account;
     ai_trade::FillEvent local_fill;
@@ -2479,7 +2705,6 @@ int main() {
     app.RefreshReduceOnlyMode();
     ai_trade::BotApplication::PendingRequiredSlAttach pending_sl;
     pending_sl.parent_order_id = "pending-parent";
-    pending_sl.deadline_ms = 1;
     app.pending_required_sl_attach_["pending-sl"] = pending_sl;
     app.RefreshProtectionReduceOnlyRelease("unit_test_pending_sl");
     if (!app.IsForceReduceOnlyActive()) {
@@ -2623,6 +2848,103 @@ int main() {
     }
   }
 
+  {
+    // 行情环溢出合并语义：价格/时间取最新，增量 volume/interval/funding 累加。
+    ai_trade::MarketEvent merged;
+    const ai_trade::MarketEvent first{1000, "SOLUSDT", 10.0, 10.1, 2.0, 500, 0.001};
+    const ai_trade::MarketEvent second{1500, "SOLUSDT", 10.5, 10.6, 3.0, 500, 0.002};
+    ai_trade::BotApplication::ConflateMarketEvent(&merged, first);
+    ai_trade::BotApplication::ConflateMarketEvent(&merged, second);
+    if (merged.ts_ms != 1500 || !NearlyEqual(merged.price, 10.5) ||
+        !NearlyEqual(merged.mark_price, 10.6) ||
+        !NearlyEqual(merged.volume, 5.0) || merged.interval_ms != 1000 ||
+        !NearlyEqual(merged.funding_rate_per_interval, 0.003, 1e-12)) {
+      std::cerr << "行情环溢出合并语义不符合预期\n";
+      return 1;
+    }
+    // funding 缺失（NaN）不应污染已累计值。
+    ai_trade::MarketEvent no_funding{2000, "SOLUSDT", 10.7, 10.8, 1.0, 500};
+    ai_trade::BotApplication::ConflateMarketEvent(&merged, no_funding);
+    if (!NearlyEqual(merged.funding_rate_per_interval, 0.003, 1e-12) ||
+        !NearlyEqual(merged.volume, 6.0)) {
+      std::cerr << "缺失 funding 的合并不应污染累计值\n";
+      return 1;
+    }
+  }
+
+  {
+    // 专职行情读取线程：事件经 SPSC 环送入决策循环，max_ticks 正常退出。
+    ai_trade::AppConfig config;
+    const auto temp_dir = std::filesystem::temp_directory_path() /
+                          "ai_trade_test_feed_reader";
+    std::filesystem::create_directories(temp_dir);
+    config.data_path = temp_dir.string();
+    config.exchange = "mock";
+    config.mode = "paper";
+    config.feed_reader_enabled = true;
+    config.feed_ring_capacity = 8;
+    config.system_max_ticks = 4;
+
+    ai_trade::BotApplication app(config);
+    if (!app.Initialize()) {
+      std::cerr << "feed reader 测试初始化失败\n";
+      return 1;
+    }
+    app.RunLoop();
+    if (app.feed_ring_ == nullptr || app.market_tick_count_ < 4) {
+      std::cerr << "feed reader 环路未按预期驱动决策循环\n";
+      return 1;
+    }
+    if (app.feed_reader_thread_.joinable()) {
+      std::cerr << "RunLoop 退出后读取线程应已回收\n";
+      return 1;
+    }
+    if (app.main_wake_fd_ != -1) {
+      std::cerr << "读取线程停止后主循环唤醒 fd 应已关闭\n";
+      return 1;
+    }
+    app.Shutdown();
+    std::filesystem::remove_all(temp_dir);
+  }
+
+  {
+    // 决策侧最新值折叠：同 symbol 积压 tick 折叠为一条，跨 symbol 按首现顺序。
+    ai_trade::AppConfig config;
+    config.exchange = "mock";
+    config.mode = "paper";
+    config.tick_conflation_enabled = true;
+    ai_trade::BotApplication app(config);
+    app.feed_ring_ =
+        std::make_unique<ai_trade::SpscRing<ai_trade::MarketEvent>>(8);
+    (void)app.feed_ring_->TryPush(
+        ai_trade::MarketEvent{1000, "SOLUSDT", 10.0, 10.1, 2.0, 500, 0.001});
+    (void)app.feed_ring_->TryPush(
+        ai_trade::MarketEvent{1500, "SOLUSDT", 10.5, 10.6, 3.0, 500, 0.002});
+    (void)app.feed_ring_->TryPush(
+        ai_trade::MarketEvent{1600, "ETHUSDT", 20.0, 20.1, 1.0, 600});
+    (void)app.feed_ring_->TryPush(
+        ai_trade::MarketEvent{2000, "SOLUSDT", 11.0, 11.1, 1.0, 500, 0.001});
+
+    ai_trade::MarketEvent event;
+    if (!app.FetchConflatedMarket(&event, /*from_ring=*/true) ||
+        event.symbol != "SOLUSDT" || event.ts_ms != 2000 ||
+        !NearlyEqual(event.price, 11.0) || !NearlyEqual(event.volume, 6.0) ||
+        event.interval_ms != 1500 ||
+        !NearlyEqual(event.funding_rate_per_interval, 0.004, 1e-12)) {
+      std::cerr << "同 symbol 积压 tick 应折叠为最新值（增量字段累加）\n";
+      return 1;
+    }
+    if (!app.FetchConflatedMarket(&event, /*from_ring=*/true) ||
+        event.symbol != "ETHUSDT" || event.ts_ms != 1600) {
+      std::cerr << "跨 symbol 折叠应按首现顺序逐轮吐出\n";
+      return 1;
+    }
+    if (app.FetchConflatedMarket(&event, /*from_ring=*/true)) {
+      std::cerr << "暂存表排空后不应再产出行情\n";
+      return 1;
+    }
+  }
+
   {
     ai_trade::AppConfig config;
     config.exchange = "mock";
@@ -2746,6 +3068,69 @@ int main() {
     }
   }
 
+  {
+    // 自进化异步流水线：观测入环由后台线程评估，动作经 PollAction 取回，
+    // 语义应与同步 OnTick 一致。
+    ai_trade::SelfEvolutionConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 2;
+    config.min_update_interval_ticks = 0;
+    config.max_single_strategy_weight = 0.60;
+    config.max_weight_step = 0.05;
+    config.min_abs_window_pnl_usd = 1.0;
+    config.rollback_degrade_windows = 2;
+    config.rollback_degrade_threshold_score = 0.0;
+    config.rollback_cooldown_ticks = 5;
+
+    ai_trade::EvolutionPipeline pipeline(config);
+    std::string error;
+    if (!pipeline.Initialize(/*current_tick=*/0,
+                             /*initial_equity_usd=*/10000.0,
+                             {0.50, 0.50},
+                             &error,
+                             /*initial_realized_net_pnl_usd=*/10000.0)) {
+      std::cerr << "自进化流水线初始化失败: " << error << "\n";
+      return 1;
+    }
+    ai_trade::EvolutionObservation first;
+    first.tick = 1;
+    first.realized_net_pnl_usd = 10010.0;
+    ai_trade::EvolutionObservation second;
+    second.tick = 2;
+    second.realized_net_pnl_usd = 10020.0;
+    if (!pipeline.SubmitObservation(std::move(first)) ||
+        !pipeline.SubmitObservation(std::move(second))) {
+      std::cerr << "自进化流水线观测入环失败\n";
+      return 1;
+    }
+
+    std::optional<ai_trade::SelfEvolutionAction> action;
+    for (int attempt = 0; attempt < 200 && !action.has_value(); ++attempt) {
+      action = pipeline.PollAction();
+      if (!action.has_value()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    if (!action.has_value() ||
+        action->type != ai_trade::SelfEvolutionActionType::kUpdated ||
+        action->reason_code != "EVOLUTION_WEIGHT_INCREASE_TREND" ||
+        !NearlyEqual(action->trend_weight_after, 0.55, 1e-9) ||
+        !NearlyEqual(action->defensive_weight_after, 0.45, 1e-9)) {
+      std::cerr << "自进化流水线异步更新行为不符合预期\n";
+      return 1;
+    }
+    if (pipeline.next_eval_tick() <= 2 ||
+        pipeline.dropped_observations() != 0) {
+      std::cerr << "自进化流水线节奏镜像不符合预期\n";
+      return 1;
+    }
+    pipeline.Stop();
+    if (pipeline.PollAction().has_value()) {
+      std::cerr << "自进化流水线停止后不应残留动作\n";
+      return 1;
+    }
+  }
+
   {
     // 自进化控制器：窗口盈亏绝对值不足时应显式跳过更新。
     ai_trade::SelfEvolutionConfig config;
@@ -4031,6 +4416,143 @@ int main() {
     }
   }
 
+  {
+    // API 预算令牌桶：窗口内限量、reduce-only 透支、窗口边界补满
+    ai_trade::OrderThrottle throttle(ai_trade::OrderThrottleConfig{
+        .min_order_interval_ms = 0,
+        .reverse_signal_cooldown_ticks = 0,
+        .api_budget_per_window = 2,
+        .api_budget_window_ms = 1000,
+        .api_order_budget_per_window = 2,
+    });
+    ai_trade::OrderIntent intent;
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 0.01;
+    intent.price = 100.0;
+
+    std::string reason;
+    for (int i = 0; i < 2; ++i) {
+      intent.client_order_id = "budget-" + std::to_string(i);
+      if (!throttle.Allow(intent, 1000, 30 + i, &reason)) {
+        std::cerr << "预算未耗尽时不应拦截: " << reason << "\n";
+        return 1;
+      }
+      throttle.OnAccepted(intent, 1000, 30 + i);
+    }
+    if (throttle.total_stats().account_budget_tokens != 0) {
+      std::cerr << "账户桶剩余令牌应为 0\n";
+      return 1;
+    }
+
+    intent.client_order_id = "budget-exhausted";
+    if (throttle.Allow(intent, 1500, 32, &reason)) {
+      std::cerr << "预算耗尽后应拦截开仓订单\n";
+      return 1;
+    }
+    if (reason.find("api_budget_exhausted_ms_remaining=") ==
+        std::string::npos) {
+      std::cerr << "预算拦截原因不符合预期: " << reason << "\n";
+      return 1;
+    }
+    if (throttle.total_stats().budget_rejects != 1) {
+      std::cerr << "budget_rejects 统计不符合预期\n";
+      return 1;
+    }
+
+    // reduce-only 保护单不受预算拒绝，透支后桶为负
+    ai_trade::OrderIntent reduce_only = intent;
+    reduce_only.client_order_id = "budget-reduce-only";
+    reduce_only.reduce_only = true;
+    if (!throttle.Allow(reduce_only, 1500, 32, &reason)) {
+      std::cerr << "reduce_only 订单不应被预算拦截\n";
+      return 1;
+    }
+    throttle.OnAccepted(reduce_only, 1500, 32);
+    if (throttle.total_stats().account_budget_tokens != -1) {
+      std::cerr << "reduce_only 透支后账户桶应为 -1\n";
+      return 1;
+    }
+
+    // 跨过窗口边界后整窗补满，恢复放行
+    intent.client_order_id = "budget-refilled";
+    if (!throttle.Allow(intent, 2100, 40, &reason)) {
+      std::cerr << "窗口补满后应恢复下单: " << reason << "\n";
+      return 1;
+    }
+    if (throttle.total_stats().account_budget_tokens != 2) {
+      std::cerr << "窗口补满后令牌数不符合预期: "
+                << throttle.total_stats().account_budget_tokens << "\n";
+      return 1;
+    }
+  }
+
+  {
+    // 预计算量化表：倒数乘子对齐与原始除法口径一致、精度模板生效
+    ai_trade::SymbolInfo info;
+    info.symbol = "BTCUSDT";
+    info.tradable = true;
+    info.qty_step = 0.001;
+    info.min_order_qty = 0.002;
+    info.min_notional_usd = 5.0;
+    info.price_tick = 0.1;
+    info.qty_precision = 3;
+    info.price_precision = 1;
+
+    ai_trade::QuantizationTable table;
+    table.Load(info);
+    const ai_trade::SymbolQuantization* quant = table.Find("BTCUSDT");
+    if (quant == nullptr || !quant->tradable) {
+      std::cerr << "量化表加载失败\n";
+      return 1;
+    }
+    if (table.Find("UNKNOWNUSDT") != nullptr) {
+      std::cerr << "未加载 symbol 不应命中量化表\n";
+      return 1;
+    }
+
+    // 与逐单除法实现的口径对齐（含临界值）
+    const double qty_samples[] = {0.0004, 0.001, 0.0015, 0.1234567,
+                                  1.0,    2.0005, 1234.5678901};
+    for (const double qty : qty_samples) {
+      const double steps = std::floor((qty + 1e-12) / info.qty_step);
+      const double expected = steps > 0.0 ? steps * info.qty_step : 0.0;
+      if (!NearlyEqual(quant->QuantizeQtyFloor(qty), expected, 1e-12)) {
+        std::cerr << "量化表步长对齐与除法口径不一致: qty=" << qty << "\n";
+        return 1;
+      }
+    }
+
+    // 步长感知最小名义金额地板：5 USD / 100 => 0.05，已对齐步长
+    if (!NearlyEqual(quant->StepNotionalFloor(100.0, 5.0), 5.0, 1e-9)) {
+      std::cerr << "最小名义金额地板不符合预期\n";
+      return 1;
+    }
+    // 地板需上调到步长整数倍：0.7 USD / 300 => 0.00234 → 0.003 步
+    const double raised = quant->StepNotionalFloor(300.0, 0.7);
+    if (!NearlyEqual(raised, 0.003 * 300.0, 1e-9)) {
+      std::cerr << "步长上调地板不符合预期: " << raised << "\n";
+      return 1;
+    }
+
+    std::string formatted;
+    quant->AppendFormattedQty(0.1234567, &formatted);
+    if (formatted != "0.123") {
+      std::cerr << "数量精度模板格式化不符合预期: " << formatted << "\n";
+      return 1;
+    }
+
+    // FindOrLoad：适配器按需补载
+    ai_trade::MockExchangeAdapter adapter({100.0});
+    adapter.Connect();
+    const ai_trade::SymbolQuantization* loaded =
+        table.FindOrLoad("BTCUSDT", &adapter);
+    if (loaded != quant) {
+      std::cerr << "已缓存 symbol 不应重新补载\n";
+      return 1;
+    }
+  }
+
   {
     const std::filesystem::path temp_path =
         std::filesystem::temp_directory_path() / "ai_trade_test_config.yaml";
@@ -4085,6 +4607,8 @@ int main() {
         << "    expected_position_mode: \"HEDGE\"\n"
         << "    public_ws_enabled: false\n"
         << "    public_ws_rest_fallback: true\n"
+        << "    orderbook_enabled: true\n"
+        << "    orderbook_depth: 1\n"
         << "    private_ws_enabled: true\n"
         << "    private_ws_rest_fallback: false\n"
         << "    ws_reconnect_interval_ms: 17000\n"
@@ -4097,6 +4621,12 @@ int main() {
         << "    replay_interval_column: \"interval_ms\"\n"
         << "    replay_funding_rate_column: \"funding_rate_per_interval\"\n"
         << "    replay_default_interval_ms: 300000\n"
+        << "  mux:\n"
+        << "    market_venues: [\"bybit\", \"binance\"]\n"
+        << "    execution_venue: \"bybit\"\n"
+        << "    symbol_routes: [\"BTCUSDT=binance\"]\n"
+        << "    ring_capacity: 2048\n"
+        << "    poll_idle_sleep_us: 150\n"
         << "risk:\n"
         << "  max_abs_notional_usd: 4321\n"
         << "  max_drawdown:\n"
@@ -4215,6 +4745,7 @@ int main() {
         << "    log_model_score: false\n"
         << "    model_report_path: \"./data/research/integrator_report.json\"\n"
         << "    model_path: \"./data/models/integrator_latest.cbm\"\n"
+        << "    native_model_path: \"./data/models/integrator_native.bin\"\n"
         << "    active_meta_path: \"./data/models/integrator_active.json\"\n"
         << "    require_model_file: true\n"
         << "    require_active_meta: true\n"
@@ -4224,6 +4755,15 @@ int main() {
         << "    min_split_trained_count: 3\n"
         << "    min_split_trained_ratio: 0.70\n"
         << "    score_gain: 1.2\n"
+        << "threads:\n"
+        << "  enabled: true\n"
+        << "  feed_cpus: \"1\"\n"
+        << "  decision_cpus: \"2\"\n"
+        << "  executor_cpus: \"3,4\"\n"
+        << "  logger_cpus: \"5\"\n"
+        << "  background_cpus: \"0\"\n"
+        << "  decision_sched_fifo: true\n"
+        << "  decision_fifo_priority: 12\n"
         << "self_evolution:\n"
         << "  enabled: true\n"
         << "  update_interval_ticks: 88\n"
@@ -4365,6 +4905,13 @@ int main() {
         config.bybit.replay_interval_column != "interval_ms" ||
         config.bybit.replay_funding_rate_column != "funding_rate_per_interval" ||
         config.bybit.replay_default_interval_ms != 300000 ||
+        config.mux.market_venues !=
+            (std::vector<std::string>{"bybit", "binance"}) ||
+        config.mux.execution_venue != "bybit" ||
+        config.mux.symbol_routes !=
+            (std::vector<std::string>{"BTCUSDT=binance"}) ||
+        config.mux.ring_capacity != 2048 ||
+        config.mux.poll_idle_sleep_us != 150 ||
         !NearlyEqual(config.strategy_signal_notional_usd, 1500.0) ||
         !NearlyEqual(config.strategy_signal_deadband_abs, 0.3) ||
         !NearlyEqual(config.strategy_signal_deadband_bps, 2.5) ||
@@ -4443,6 +4990,8 @@ int main() {
         config.bybit.expected_position_mode != ai_trade::PositionMode::kHedge ||
         config.bybit.public_ws_enabled != false ||
         config.bybit.public_ws_rest_fallback != true ||
+        config.bybit.orderbook_enabled != true ||
+        config.bybit.orderbook_depth != 1 ||
         config.bybit.private_ws_enabled != true ||
         config.bybit.private_ws_rest_fallback != false ||
         config.bybit.ws_reconnect_interval_ms != 17000 ||
@@ -4465,6 +5014,16 @@ int main() {
             "./data/research/integrator_report.json" ||
         config.integrator.shadow.model_path !=
             "./data/models/integrator_latest.cbm" ||
+        config.integrator.shadow.native_model_path !=
+            "./data/models/integrator_native.bin" ||
+        config.threads.enabled != true ||
+        config.threads.feed_cpus != "1" ||
+        config.threads.decision_cpus != "2" ||
+        config.threads.executor_cpus != "3,4" ||
+        config.threads.logger_cpus != "5" ||
+        config.threads.background_cpus != "0" ||
+        config.threads.decision_sched_fifo != true ||
+        config.threads.decision_fifo_priority != 12 ||
         config.integrator.shadow.active_meta_path !=
             "./data/models/integrator_active.json" ||
         config.integrator.shadow.require_model_file != true ||
@@ -6039,3347 +6598,7177 @@ int main() {
   }
 
   {
-    const std::filesystem::path wal_path =
-        std::filesystem::temp_directory_path() / "ai_trade_test_trade.wal";
+    // 配置二进制快照：首次加载生成 .cache，二次加载命中且字段一致，
+    // 源文件修改后回退到完整解析并拿到新值
+    const std::filesystem::path temp_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_cfg_cache.yaml";
+    const std::filesystem::path cache_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_cfg_cache.yaml.cache";
     std::error_code ec;
-    std::filesystem::remove(wal_path, ec);
+    std::filesystem::remove(cache_path, ec);
+    {
+      std::ofstream out(temp_path);
+      out << "system:\n"
+          << "  mode: \"replay\"\n"
+          << "  primary_symbol: \"ETHUSDT\"\n"
+          << "risk:\n"
+          << "  max_abs_notional_usd: 2468\n"
+          << "universe:\n"
+          << "  candidate_symbols: [\"BTCUSDT\", \"ETHUSDT\"]\n";
+    }
 
-    ai_trade::WalStore wal(wal_path.string());
+    ai_trade::AppConfig parsed;
     std::string error;
-    if (!wal.Initialize(&error)) {
-      std::cerr << "WAL 初始化失败: " << error << "\n";
+    if (!ai_trade::LoadAppConfigFromYaml(temp_path.string(), &parsed, &error)) {
+      std::cerr << "配置快照首次加载失败: " << error << "\n";
       return 1;
     }
-
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "cid-1";
-    intent.symbol = "BTCUSDT";
-    intent.purpose = ai_trade::OrderPurpose::kEntry;
-    intent.reduce_only = false;
-    intent.direction = 1;
-    intent.qty = 2.0;
-    intent.price = 100.0;
-
-    if (!wal.AppendIntent(intent, &error)) {
-      std::cerr << "WAL 追加 intent 失败: " << error << "\n";
+    if (!std::filesystem::exists(cache_path)) {
+      std::cerr << "首次加载后应生成配置快照文件\n";
       return 1;
     }
-    ai_trade::FillEvent fill_1 = ToFill(intent, "fill-1");
-    fill_1.qty = 0.8;
-    ai_trade::FillEvent fill_2 = ToFill(intent, "fill-2");
-    fill_2.qty = 1.2;
 
-    if (!wal.AppendFill(fill_1, &error)) {
-      std::cerr << "WAL 追加 fill_1 失败: " << error << "\n";
+    ai_trade::AppConfig cached;
+    if (!ai_trade::LoadAppConfigFromYaml(temp_path.string(), &cached, &error)) {
+      std::cerr << "配置快照命中加载失败: " << error << "\n";
       return 1;
     }
-    if (!wal.AppendFill(fill_2, &error)) {
-      std::cerr << "WAL 追加 fill_2 失败: " << error << "\n";
+    if (cached.primary_symbol != parsed.primary_symbol ||
+        !NearlyEqual(cached.risk_max_abs_notional_usd,
+                     parsed.risk_max_abs_notional_usd) ||
+        cached.universe.candidate_symbols != parsed.universe.candidate_symbols) {
+      std::cerr << "配置快照命中结果与完整解析不一致\n";
       return 1;
     }
-    if (!wal.AppendFill(fill_1, &error)) {
-      std::cerr << "WAL 追加重复 fill_1 失败: " << error << "\n";
+
+    {
+      std::ofstream out(temp_path);
+      out << "system:\n"
+          << "  mode: \"replay\"\n"
+          << "  primary_symbol: \"SOLUSDT\"\n"
+          << "risk:\n"
+          << "  max_abs_notional_usd: 1357\n";
+    }
+    ai_trade::AppConfig reparsed;
+    if (!ai_trade::LoadAppConfigFromYaml(temp_path.string(), &reparsed,
+                                         &error)) {
+      std::cerr << "配置源文件修改后重新解析失败: " << error << "\n";
       return 1;
     }
-
-    std::unordered_set<std::string> intent_ids;
-    std::unordered_set<std::string> fill_ids;
-    std::vector<ai_trade::FillEvent> fills;
-    if (!wal.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
-      std::cerr << "WAL 加载失败: " << error << "\n";
+    if (reparsed.primary_symbol != "SOLUSDT" ||
+        !NearlyEqual(reparsed.risk_max_abs_notional_usd, 1357.0)) {
+      std::cerr << "配置源文件修改后应回退完整解析并拿到新值\n";
       return 1;
     }
+    std::filesystem::remove(temp_path);
+    std::filesystem::remove(cache_path, ec);
+  }
 
-    if (intent_ids.size() != 1 || fill_ids.size() != 2 || fills.size() != 2) {
-      std::cerr << "WAL 去重或加载计数不符合预期\n";
-      return 1;
+  {
+    // 配置热加载：基线无快照，源文件修改后监视线程发布新快照
+    const std::filesystem::path temp_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_cfg_watch.yaml";
+    std::error_code ec;
+    std::filesystem::remove(
+        std::filesystem::path(temp_path.string() + ".cache"), ec);
+    {
+      std::ofstream out(temp_path);
+      out << "risk:\n"
+          << "  max_abs_notional_usd: 1000\n";
     }
 
-    ai_trade::TradeSystem recovered_system(/*risk_cap_usd=*/500.0,
-                                           /*max_order_notional_usd=*/200.0);
-    for (const auto& fill : fills) {
-      recovered_system.OnFill(fill);
+    ai_trade::ConfigWatcher watcher;
+    std::string error;
+    if (!watcher.Start(temp_path.string(), &error)) {
+      std::cerr << "ConfigWatcher 启动失败: " << error << "\n";
+      return 1;
     }
-    if (!NearlyEqual(recovered_system.account().current_notional_usd(), 200.0)) {
-      std::cerr << "WAL 回放后仓位恢复不符合预期\n";
+    if (watcher.PollUpdated() != nullptr) {
+      std::cerr << "基线内容不应触发热加载快照\n";
       return 1;
     }
 
-    std::filesystem::remove(wal_path);
+    {
+      std::ofstream out(temp_path);
+      out << "risk:\n"
+          << "  max_abs_notional_usd: 2000\n";
+    }
+    std::unique_ptr<const ai_trade::AppConfig> updated;
+    for (int i = 0; i < 100 && updated == nullptr; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      updated = watcher.PollUpdated();
+    }
+    if (updated == nullptr ||
+        !NearlyEqual(updated->risk_max_abs_notional_usd, 2000.0)) {
+      std::cerr << "源文件修改后应发布携带新值的配置快照\n";
+      return 1;
+    }
+    watcher.Stop();
+    std::filesystem::remove(temp_path);
+    std::filesystem::remove(
+        std::filesystem::path(temp_path.string() + ".cache"), ec);
   }
 
   {
-    ai_trade::RiskEngine risk(/*max_abs_notional_usd=*/500.0);
-    const ai_trade::TargetPosition target{"BTCUSDT", 500.0};
+    // Arena：容器分配/字符串分配正确，Reset 后容量保留且稳态不再增长
+    ai_trade::Arena arena(1024);
+    {
+      ai_trade::ArenaVector<int> values{ai_trade::ArenaAllocator<int>(&arena)};
+      for (int i = 0; i < 500; ++i) {
+        values.push_back(i * 3);
+      }
+      if (values[499] != 1497 || values[0] != 0) {
+        std::cerr << "ArenaVector 内容不符合预期\n";
+        return 1;
+      }
+      ai_trade::ArenaString text{ai_trade::ArenaAllocator<char>(&arena)};
+      text.assign("arena-");
+      text += "scratch-string-long-enough-to-escape-sso";
+      if (text.find("scratch") == std::string::npos) {
+        std::cerr << "ArenaString 内容不符合预期\n";
+        return 1;
+      }
+    }
+    if (arena.allocated_bytes() == 0) {
+      std::cerr << "Arena 分配统计不应为 0\n";
+      return 1;
+    }
+    arena.Reset();
+    if (arena.allocated_bytes() != 0) {
+      std::cerr << "Reset 后分配统计应归零\n";
+      return 1;
+    }
+    const std::size_t reserved_after_first_pass = arena.reserved_bytes();
+    for (int pass = 0; pass < 3; ++pass) {
+      ai_trade::ArenaVector<int> values{ai_trade::ArenaAllocator<int>(&arena)};
+      for (int i = 0; i < 500; ++i) {
+        values.push_back(i);
+      }
+      arena.Reset();
+    }
+    if (arena.reserved_bytes() != reserved_after_first_pass) {
+      std::cerr << "稳态复用阶段 Arena 不应再向系统申请内存\n";
+      return 1;
+    }
+    // 超大请求独占一块，不影响常规块复用。
+    void* big = arena.Allocate(16 * 1024);
+    if (big == nullptr) {
+      std::cerr << "超大请求分配失败\n";
+      return 1;
+    }
+  }
 
-    const auto normal = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.01);
-    if (normal.risk_mode != ai_trade::RiskMode::kNormal ||
-        normal.reduce_only ||
-        !NearlyEqual(normal.adjusted_notional_usd, 500.0)) {
-      std::cerr << "风控 NORMAL 模式结果不符合预期\n";
+  {
+    // 延迟直方图：对数定桶、近似分位与合并语义
+    ai_trade::LatencyHistogram histogram;
+    if (histogram.ApproxPercentileNanos(0.99) != 0) {
+      std::cerr << "空直方图分位数应为 0\n";
+      return 1;
+    }
+    for (int i = 0; i < 99; ++i) {
+      histogram.Record(1000);  // 桶 [512ns, 1024ns)
+    }
+    histogram.Record(100000);  // 100us 离群样本
+    if (histogram.count() != 100 || histogram.max_nanos() != 100000) {
+      std::cerr << "直方图计数/最大值不符合预期\n";
       return 1;
     }
+    if (histogram.ApproxPercentileNanos(0.50) > 1024) {
+      std::cerr << "p50 应落在 1us 桶内\n";
+      return 1;
+    }
+    if (histogram.ApproxPercentileNanos(1.0) < 100000) {
+      std::cerr << "p100 不应低于最大样本\n";
+      return 1;
+    }
+    ai_trade::LatencyHistogram other;
+    other.Record(2000000);  // 2ms
+    histogram.Merge(other);
+    if (histogram.count() != 101 || histogram.max_nanos() != 2000000) {
+      std::cerr << "直方图合并结果不符合预期\n";
+      return 1;
+    }
+  }
 
-    const auto degraded = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.09);
-    if (degraded.risk_mode != ai_trade::RiskMode::kDegraded ||
-        degraded.reduce_only ||
-        !NearlyEqual(degraded.adjusted_notional_usd, 250.0)) {
-      std::cerr << "风控 DEGRADED 模式结果不符合预期\n";
+  {
+    // 批量评估：与逐事件 Evaluate 口径一致，仅意图事件保留完整决策
+    std::vector<ai_trade::MarketEvent> events;
+    for (int i = 0; i < 60; ++i) {
+      ai_trade::MarketEvent event;
+      event.ts_ms = 1700000000000 + i * 5000;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + i * 0.8;
+      event.volume = 10.0;
+      event.interval_ms = 5000;
+      events.push_back(event);
+    }
+
+    ai_trade::TradeSystem batch_system(10000.0, 1000.0);
+    std::vector<ai_trade::MarketDecision> intent_decisions;
+    ai_trade::BatchEvaluateSummary summary;
+    const std::size_t intent_count = batch_system.EvaluateBatch(
+        events, true, &intent_decisions, &summary);
+
+    ai_trade::TradeSystem serial_system(10000.0, 1000.0);
+    std::size_t serial_intents = 0;
+    for (const auto& event : events) {
+      const auto decision = serial_system.Evaluate(event, true);
+      if (decision.intent.has_value()) {
+        ++serial_intents;
+      }
+    }
+
+    if (summary.event_count != events.size() ||
+        intent_count != serial_intents ||
+        intent_decisions.size() != intent_count) {
+      std::cerr << "批量评估与逐事件评估口径不一致: batch=" << intent_count
+                << ", serial=" << serial_intents << "\n";
       return 1;
     }
+    for (const auto& decision : intent_decisions) {
+      if (!decision.intent.has_value() ||
+          decision.intent->symbol != "BTCUSDT") {
+        std::cerr << "批量评估审计记录应只包含产生意图的事件\n";
+        return 1;
+      }
+    }
+  }
 
-    const auto cooldown = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.13);
-    if (cooldown.risk_mode != ai_trade::RiskMode::kCooldown ||
-        !cooldown.reduce_only ||
-        !NearlyEqual(cooldown.adjusted_notional_usd, 0.0)) {
-      std::cerr << "风控 COOLDOWN 模式结果不符合预期\n";
+  {
+    // 分片评估：路由稳定、汇总口径与按分片串行评估一致
+    ai_trade::AppConfig config;
+    ai_trade::ShardedEvaluator sharded(config, 2);
+
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+    std::vector<ai_trade::MarketEvent> events;
+    for (int i = 0; i < 90; ++i) {
+      ai_trade::MarketEvent event;
+      event.ts_ms = 1700000000000 + i * 5000;
+      event.symbol = symbols[i % symbols.size()];
+      event.price = 100.0 + i * 0.6;
+      event.volume = 5.0;
+      event.interval_ms = 5000;
+      events.push_back(event);
+    }
+
+    std::vector<std::vector<ai_trade::MarketEvent>> per_shard(
+        sharded.shard_count());
+    for (const auto& event : events) {
+      const std::size_t index = sharded.ShardIndexFor(event);
+      if (index != sharded.ShardIndexFor(event)) {
+        std::cerr << "同一事件的分片路由应稳定\n";
+        return 1;
+      }
+      per_shard[index].push_back(event);
+      sharded.Dispatch(event);
+    }
+
+    std::vector<ai_trade::MarketDecision> intent_decisions;
+    const auto summary = sharded.Drain(&intent_decisions);
+    if (summary.event_count != events.size()) {
+      std::cerr << "分片评估处理事件数不符合预期\n";
       return 1;
     }
 
-    const auto fuse = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.21);
-    if (fuse.risk_mode != ai_trade::RiskMode::kFuse ||
-        !fuse.reduce_only ||
-        !NearlyEqual(fuse.adjusted_notional_usd, 0.0)) {
-      std::cerr << "风控 FUSE 模式结果不符合预期\n";
+    std::size_t serial_intents = 0;
+    for (const auto& shard_events : per_shard) {
+      ai_trade::TradeSystem serial_system(config);
+      std::vector<ai_trade::MarketDecision> shard_decisions;
+      serial_intents +=
+          serial_system.EvaluateBatch(shard_events, true, &shard_decisions);
+    }
+    if (summary.intent_count != serial_intents ||
+        intent_decisions.size() != summary.intent_count) {
+      std::cerr << "分片评估意图数与按分片串行评估不一致: sharded="
+                << summary.intent_count << ", serial=" << serial_intents
+                << "\n";
       return 1;
     }
 
-    risk.SetForcedReduceOnly(true);
-    const auto forced = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.0);
-    if (forced.risk_mode != ai_trade::RiskMode::kReduceOnly ||
-        !forced.reduce_only) {
-      std::cerr << "风控强制 reduce-only 模式不符合预期\n";
+    // 跨分片风险快照：外部敞口占满预算后不应再产生开仓意图。
+    ai_trade::TradeSystem budget_system(config);
+    budget_system.SetExternalGrossNotionalUsd(1e9);
+    std::vector<ai_trade::MarketDecision> budget_decisions;
+    const std::size_t budget_intents =
+        budget_system.EvaluateBatch(events, true, &budget_decisions);
+    if (budget_intents != 0) {
+      std::cerr << "外部敞口占满全局预算时不应产生开仓意图\n";
       return 1;
     }
   }
 
   {
-    ai_trade::RiskThresholds thresholds;
-    thresholds.degraded_drawdown = 0.08;
-    thresholds.degraded_recover_drawdown = 0.06;
-    thresholds.cooldown_drawdown = 0.12;
-    thresholds.cooldown_recover_drawdown = 0.10;
-    thresholds.fuse_drawdown = 0.20;
-    thresholds.fuse_recover_drawdown = 0.16;
-    ai_trade::RiskEngine risk(/*max_abs_notional_usd=*/500.0, thresholds);
-    const ai_trade::TargetPosition target{"BTCUSDT", 500.0};
+    // 原生回放引擎：列式 K 线驱动 Evaluate，与逐事件 + 即时成交口径一致
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT"};
+    std::vector<std::string> bar_paths;
+    std::vector<std::vector<ai_trade::research::ResearchBar>> per_symbol_bars;
+    for (std::size_t s = 0; s < symbols.size(); ++s) {
+      std::vector<ai_trade::research::ResearchBar> bars;
+      for (int i = 0; i < 80; ++i) {
+        ai_trade::research::ResearchBar bar;
+        bar.ts_ms = 1700000000000 + i * 5000 + static_cast<int>(s) * 1000;
+        bar.close = 100.0 + i * (s == 0 ? 0.8 : 0.5);
+        bar.open = bar.close - 0.2;
+        bar.high = bar.close + 0.3;
+        bar.low = bar.open - 0.3;
+        bar.volume = 10.0 + static_cast<double>(s);
+        bars.push_back(bar);
+      }
+      const std::string path =
+          (std::filesystem::temp_directory_path() /
+           ("ai_trade_test_replay_" + symbols[s] + ".bin"))
+              .string();
+      std::string save_error;
+      if (!ai_trade::research::SaveResearchBarsColumnar(bars, path,
+                                                        &save_error)) {
+        std::cerr << "回放测试 K 线落盘失败: " << save_error << "\n";
+        return 1;
+      }
+      bar_paths.push_back(path);
+      per_symbol_bars.push_back(std::move(bars));
+    }
 
-    const auto degraded_enter = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.081);
-    if (degraded_enter.risk_mode != ai_trade::RiskMode::kDegraded) {
-      std::cerr << "风控滞回：degraded 进入失败\n";
+    ai_trade::AppConfig config;
+    ai_trade::ReplayEngine engine(config);
+    std::string replay_error;
+    for (std::size_t s = 0; s < symbols.size(); ++s) {
+      if (!engine.AddSymbolBars(symbols[s], bar_paths[s], 5000,
+                                &replay_error)) {
+        std::cerr << "回放引擎挂载 K 线失败: " << replay_error << "\n";
+        return 1;
+      }
+    }
+    if (engine.AddSymbolBars("BTCUSDT", bar_paths[0], 5000, &replay_error)) {
+      std::cerr << "重复挂载同一 symbol 应失败\n";
       return 1;
     }
-    const auto degraded_hold = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.079);
-    if (degraded_hold.risk_mode != ai_trade::RiskMode::kDegraded) {
-      std::cerr << "风控滞回：degraded 保持失败\n";
+    ai_trade::ReplayStats stats;
+    if (!engine.Run(&stats, &replay_error)) {
+      std::cerr << "回放执行失败: " << replay_error << "\n";
       return 1;
     }
-    const auto degraded_exit = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.059);
-    if (degraded_exit.risk_mode != ai_trade::RiskMode::kNormal) {
-      std::cerr << "风控滞回：degraded 恢复失败\n";
+    if (stats.events != symbols.size() * 80) {
+      std::cerr << "回放事件数不符合预期: " << stats.events << "\n";
       return 1;
     }
 
-    const auto fuse_enter = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.21);
-    if (fuse_enter.risk_mode != ai_trade::RiskMode::kFuse) {
-      std::cerr << "风控滞回：fuse 进入失败\n";
-      return 1;
+    // 串行参照：同一事件流逐条 Evaluate + 同款即时成交
+    std::vector<ai_trade::MarketEvent> merged;
+    for (std::size_t s = 0; s < symbols.size(); ++s) {
+      const auto& bars = per_symbol_bars[s];
+      for (std::size_t i = 0; i < bars.size(); ++i) {
+        ai_trade::MarketEvent event;
+        event.ts_ms = bars[i].ts_ms;
+        event.symbol = symbols[s];
+        event.price = bars[i].close;
+        event.mark_price = bars[i].close;
+        event.volume = bars[i].volume;
+        event.interval_ms =
+            i > 0 ? bars[i].ts_ms - bars[i - 1].ts_ms : 5000;
+        merged.push_back(event);
+      }
     }
-    const auto fuse_hold = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.17);
-    if (fuse_hold.risk_mode != ai_trade::RiskMode::kFuse) {
-      std::cerr << "风控滞回：fuse 保持失败\n";
+    std::sort(merged.begin(), merged.end(),
+              [](const ai_trade::MarketEvent& a,
+                 const ai_trade::MarketEvent& b) { return a.ts_ms < b.ts_ms; });
+
+    ai_trade::TradeSystem reference(config);
+    std::size_t reference_intents = 0;
+    for (const auto& event : merged) {
+      const auto decision = reference.Evaluate(event, true);
+      if (!decision.intent.has_value()) {
+        continue;
+      }
+      ++reference_intents;
+      ai_trade::FillEvent fill;
+      fill.fill_id = decision.intent->client_order_id + "-sim-fill";
+      fill.client_order_id = decision.intent->client_order_id;
+      fill.symbol = decision.intent->symbol;
+      fill.direction = decision.intent->direction;
+      fill.qty = decision.intent->qty;
+      fill.price = decision.intent->price;
+      reference.OnFill(fill);
+    }
+    if (stats.intents != reference_intents || stats.fills != stats.intents) {
+      std::cerr << "回放引擎与串行参照意图数不一致: replay=" << stats.intents
+                << ", serial=" << reference_intents << "\n";
+      return 1;
+    }
+    if (!NearlyEqual(stats.final_equity_usd, reference.account().equity_usd(),
+                     1e-6)) {
+      std::cerr << "回放引擎与串行参照账户权益不一致\n";
       return 1;
     }
-    const auto fuse_release = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.15);
-    if (fuse_release.risk_mode != ai_trade::RiskMode::kCooldown) {
-      std::cerr << "风控滞回：fuse 释放到 cooldown 失败\n";
+    if (engine.SummaryLine().find("REPLAY_SUMMARY: events=") ==
+        std::string::npos) {
+      std::cerr << "回放汇总行格式不符合预期: " << engine.SummaryLine()
+                << "\n";
       return 1;
     }
+    for (const auto& path : bar_paths) {
+      std::filesystem::remove(path);
+    }
   }
 
   {
-    ai_trade::OrderManager oms;
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "oms-order-1";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 10.0;
-    intent.price = 100.0;
-    intent.purpose = ai_trade::OrderPurpose::kEntry;
-    if (!oms.RegisterIntent(intent)) {
-      std::cerr << "OMS 注册订单失败\n";
+    // walk-forward 折级并行：窗口完整划分时间轴，并行与串行结果一致
+    std::vector<ai_trade::research::ResearchBar> bars;
+    for (int i = 0; i < 160; ++i) {
+      ai_trade::research::ResearchBar bar;
+      bar.ts_ms = 1700000000000 + i * 5000;
+      bar.close = 100.0 + 5.0 * std::sin(i * 0.15) + i * 0.2;
+      bar.open = bar.close - 0.2;
+      bar.high = bar.close + 0.3;
+      bar.low = bar.open - 0.3;
+      bar.volume = 10.0;
+      bars.push_back(bar);
+    }
+    const std::string bar_path =
+        (std::filesystem::temp_directory_path() / "ai_trade_test_wf.bin")
+            .string();
+    std::string wf_error;
+    if (!ai_trade::research::SaveResearchBarsColumnar(bars, bar_path,
+                                                      &wf_error)) {
+      std::cerr << "walk-forward 测试 K 线落盘失败: " << wf_error << "\n";
       return 1;
     }
-    if (!oms.HasPendingNetPositionOrders() ||
-        oms.PendingNetPositionOrderCount() != 1) {
-      std::cerr << "OMS 在途净仓位订单计数不符合预期\n";
+
+    ai_trade::AppConfig config;
+    const auto run_folds = [&](std::size_t max_parallel,
+                               ai_trade::WalkForwardReport* out_report) {
+      ai_trade::WalkForwardRunner runner(config);
+      if (!runner.AddSymbolBars("BTCUSDT", bar_path, 5000, &wf_error)) {
+        return false;
+      }
+      return runner.Run(4, max_parallel, out_report, &wf_error);
+    };
+
+    ai_trade::WalkForwardReport parallel_report;
+    ai_trade::WalkForwardReport serial_report;
+    if (!run_folds(4, &parallel_report) || !run_folds(1, &serial_report)) {
+      std::cerr << "walk-forward 执行失败: " << wf_error << "\n";
       return 1;
     }
-    if (!oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", 1) ||
-        oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", -1) ||
-        oms.HasPendingNetPositionOrderForSymbolDirection("ETHUSDT", 1)) {
-      std::cerr << "OMS 同向在途净仓位判定不符合预期\n";
+    if (parallel_report.folds.size() != 4 ||
+        parallel_report.total.events != bars.size()) {
+      std::cerr << "walk-forward 测试窗口未完整覆盖样本: events="
+                << parallel_report.total.events << "\n";
       return 1;
     }
-    if (!oms.HasPendingNetPositionOrderForSymbol("BTCUSDT") ||
-        oms.HasPendingNetPositionOrderForSymbol("ETHUSDT")) {
-      std::cerr << "OMS 按 symbol 在途净仓位判定不符合预期\n";
+    for (std::size_t k = 0; k < parallel_report.folds.size(); ++k) {
+      const auto& parallel_fold = parallel_report.folds[k];
+      const auto& serial_fold = serial_report.folds[k];
+      if (k > 0 && parallel_fold.test_begin_ts !=
+                       parallel_report.folds[k - 1].test_end_ts) {
+        std::cerr << "walk-forward 测试窗口应首尾相接\n";
+        return 1;
+      }
+      if (parallel_fold.stats.events != serial_fold.stats.events ||
+          parallel_fold.stats.intents != serial_fold.stats.intents ||
+          parallel_fold.stats.fills != serial_fold.stats.fills ||
+          !NearlyEqual(parallel_fold.stats.realized_pnl_usd,
+                       serial_fold.stats.realized_pnl_usd, 1e-6)) {
+        std::cerr << "walk-forward 并行与串行折结果不一致: fold=" << k << "\n";
+        return 1;
+      }
+    }
+    if (ai_trade::WalkForwardSummaryLine(parallel_report)
+            .find("WALK_FORWARD_SUMMARY: folds=4") == std::string::npos) {
+      std::cerr << "walk-forward 汇总行格式不符合预期\n";
       return 1;
     }
-    oms.MarkSent(intent.client_order_id);
+    std::filesystem::remove(bar_path);
+  }
 
-    ai_trade::FillEvent partial;
-    partial.fill_id = "fill-a";
-    partial.client_order_id = intent.client_order_id;
-    partial.symbol = intent.symbol;
-    partial.direction = 1;
-    partial.qty = 4.0;
-    partial.price = 100.0;
-    oms.OnFill(partial);
-    const auto* r1 = oms.Find(intent.client_order_id);
-    if (r1 == nullptr || r1->state != ai_trade::OrderState::kPartial) {
-      std::cerr << "OMS partial 状态不符合预期\n";
+  {
+    // 状态快照：恢复后与原系统逐事件行为一致，损坏快照被整体拒绝
+    const auto make_event = [](int i) {
+      ai_trade::MarketEvent event;
+      event.ts_ms = 1700000000000 + i * 5000;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + i * 0.8;
+      event.volume = 10.0;
+      event.interval_ms = 5000;
+      return event;
+    };
+    const auto drive = [](ai_trade::TradeSystem& system,
+                          const ai_trade::MarketEvent& event) {
+      const auto decision = system.Evaluate(event, true);
+      if (!decision.intent.has_value()) {
+        return false;
+      }
+      ai_trade::FillEvent fill;
+      fill.fill_id = decision.intent->client_order_id + "-sim-fill";
+      fill.client_order_id = decision.intent->client_order_id;
+      fill.symbol = decision.intent->symbol;
+      fill.direction = decision.intent->direction;
+      fill.qty = decision.intent->qty;
+      fill.price = decision.intent->price;
+      system.OnFill(fill);
+      return true;
+    };
+
+    ai_trade::TradeSystem original(10000.0, 1000.0);
+    for (int i = 0; i < 60; ++i) {
+      drive(original, make_event(i));
+    }
+    std::string snapshot_error;
+    if (!original.SetEvolutionWeights(0.7, 0.3, &snapshot_error)) {
+      std::cerr << "进化权重设置失败: " << snapshot_error << "\n";
       return 1;
     }
 
-    ai_trade::FillEvent rest = partial;
-    rest.fill_id = "fill-b";
-    rest.qty = 6.0;
-    oms.OnFill(rest);
-    const auto* r2 = oms.Find(intent.client_order_id);
-    if (r2 == nullptr || r2->state != ai_trade::OrderState::kFilled) {
-      std::cerr << "OMS filled 状态不符合预期\n";
+    const std::string snapshot_path =
+        (std::filesystem::temp_directory_path() / "ai_trade_test_state.snapshot")
+            .string();
+    const std::unordered_set<std::string> applied_fills = {"fill-a", "fill-b"};
+    if (!ai_trade::SaveStateSnapshot(snapshot_path, original, applied_fills,
+                                     &snapshot_error)) {
+      std::cerr << "状态快照写出失败: " << snapshot_error << "\n";
       return 1;
     }
-    if (oms.HasPendingNetPositionOrders() ||
-        oms.PendingNetPositionOrderCount() != 0) {
-      std::cerr << "OMS 终态后在途净仓位订单应为 0\n";
+
+    ai_trade::TradeSystem restored(10000.0, 1000.0);
+    std::unordered_set<std::string> restored_fills;
+    if (!ai_trade::LoadStateSnapshot(snapshot_path, &restored, &restored_fills,
+                                     &snapshot_error)) {
+      std::cerr << "状态快照恢复失败: " << snapshot_error << "\n";
       return 1;
     }
-    if (oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", 1)) {
-      std::cerr << "OMS 终态后不应存在同向在途净仓位订单\n";
+    if (restored_fills != applied_fills) {
+      std::cerr << "快照内成交 id 集合恢复不一致\n";
       return 1;
     }
-    if (oms.HasPendingNetPositionOrderForSymbol("BTCUSDT")) {
-      std::cerr << "OMS 终态后不应存在同 symbol 在途净仓位订单\n";
+    if (!NearlyEqual(restored.account().equity_usd(),
+                     original.account().equity_usd()) ||
+        !NearlyEqual(restored.account().cumulative_realized_pnl_usd(),
+                     original.account().cumulative_realized_pnl_usd()) ||
+        !NearlyEqual(restored.account().position_qty("BTCUSDT"),
+                     original.account().position_qty("BTCUSDT"))) {
+      std::cerr << "快照恢复后账户状态与原系统不一致\n";
+      return 1;
+    }
+    const auto original_weights =
+        original.GetEvolutionWeights(ai_trade::RegimeBucket::kTrend);
+    const auto restored_weights =
+        restored.GetEvolutionWeights(ai_trade::RegimeBucket::kTrend);
+    if (!NearlyEqual(original_weights.trend_weight,
+                     restored_weights.trend_weight) ||
+        !NearlyEqual(original_weights.defensive_weight,
+                     restored_weights.defensive_weight)) {
+      std::cerr << "快照恢复后进化权重不一致\n";
       return 1;
     }
-  }
 
-  {
-    ai_trade::OrderManager oms;
-    ai_trade::OrderIntent sl_intent;
-    sl_intent.client_order_id = "oms-sl-1";
-    sl_intent.symbol = "BTCUSDT";
-    sl_intent.direction = -1;
-    sl_intent.qty = 1.0;
-    sl_intent.price = 90.0;
-    sl_intent.reduce_only = true;
-    sl_intent.purpose = ai_trade::OrderPurpose::kSl;
-    if (!oms.RegisterIntent(sl_intent)) {
-      std::cerr << "OMS 注册保护单失败\n";
+    // 恢复后的系统应与原系统对后续事件产生完全一致的决策轨迹。
+    for (int i = 60; i < 90; ++i) {
+      const auto event = make_event(i);
+      const bool original_filled = drive(original, event);
+      const bool restored_filled = drive(restored, event);
+      if (original_filled != restored_filled) {
+        std::cerr << "快照恢复后决策轨迹分叉: tick=" << i << "\n";
+        return 1;
+      }
+    }
+    if (!NearlyEqual(restored.account().equity_usd(),
+                     original.account().equity_usd())) {
+      std::cerr << "快照恢复后权益轨迹与原系统不一致\n";
       return 1;
     }
-    oms.MarkSent(sl_intent.client_order_id);
-    if (oms.HasPendingNetPositionOrders() ||
-        oms.PendingNetPositionOrderCount() != 0) {
-      std::cerr << "保护单不应计入净仓位在途订单\n";
+
+    // 损坏快照：载荷哈希不符，应在触碰系统状态前被拒绝。
+    {
+      std::ofstream corrupt(snapshot_path,
+                            std::ios::binary | std::ios::in | std::ios::out);
+      corrupt.seekp(64);
+      corrupt.write("XX", 2);
+    }
+    ai_trade::TradeSystem untouched(10000.0, 1000.0);
+    if (ai_trade::LoadStateSnapshot(snapshot_path, &untouched, nullptr,
+                                    &snapshot_error)) {
+      std::cerr << "损坏快照不应恢复成功\n";
+      return 1;
+    }
+    std::filesystem::remove(snapshot_path);
+  }
+
+  {
+    // Regime 预热：并行回放历史 K 线后 warmup 清除，结果与串行一致
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT",
+                                              "SOLUSDT"};
+    std::vector<ai_trade::MarketEvent> history;
+    for (std::size_t s = 0; s < symbols.size(); ++s) {
+      for (int i = 0; i < 80; ++i) {
+        ai_trade::MarketEvent event;
+        event.ts_ms = 1700000000000 + i * 5000;
+        event.symbol = symbols[s];
+        event.price = 100.0 + i * 0.5 + static_cast<double>(s);
+        event.volume = 10.0;
+        event.interval_ms = 5000;
+        history.push_back(event);
+      }
+    }
+
+    ai_trade::RegimeEngine parallel_engine;
+    const std::size_t warm_cleared = parallel_engine.PreloadHistory(history);
+    if (warm_cleared != symbols.size()) {
+      std::cerr << "Regime 预热后 warmup 未全部清除: " << warm_cleared
+                << "\n";
       return 1;
     }
-  }
 
-  {
-    ai_trade::OrderManager oms;
-    oms.SeedNetPositionBaseline({
-        ai_trade::RemotePositionSnapshot{
-            .symbol = "BTCUSDT",
-            .qty = -0.02,
-            .avg_entry_price = 70000.0,
-            .mark_price = 70000.0,
-        },
-        ai_trade::RemotePositionSnapshot{
-            .symbol = "ETHUSDT",
-            .qty = 0.30,
-            .avg_entry_price = 2000.0,
-            .mark_price = 2000.0,
-        },
-    });
-    if (!NearlyEqual(oms.net_filled_qty("BTCUSDT"), -0.02, 1e-9) ||
-        !NearlyEqual(oms.net_filled_qty("ETHUSDT"), 0.30, 1e-9) ||
-        !NearlyEqual(oms.net_filled_qty(), 0.28, 1e-9)) {
-      std::cerr << "OMS 远端基线注入后净仓位不符合预期\n";
+    ai_trade::RegimeEngine serial_engine;
+    for (const auto& event : history) {
+      serial_engine.OnMarket(event);
+    }
+    for (const auto& symbol : symbols) {
+      ai_trade::MarketEvent live;
+      live.ts_ms = 1700000000000 + 80 * 5000;
+      live.symbol = symbol;
+      live.price = 150.0;
+      live.volume = 10.0;
+      live.interval_ms = 5000;
+      const auto parallel_state = parallel_engine.OnMarket(live);
+      const auto serial_state = serial_engine.OnMarket(live);
+      if (parallel_state.warmup || serial_state.warmup ||
+          parallel_state.regime != serial_state.regime ||
+          parallel_state.bucket != serial_state.bucket) {
+        std::cerr << "Regime 并行预热与串行回放结果不一致: " << symbol
+                  << "\n";
+        return 1;
+      }
+    }
+
+    // TradeSystem 包装：预热后首个实时 tick 不再处于 warmup。
+    ai_trade::TradeSystem warm_system(10000.0, 1000.0);
+    if (warm_system.WarmStartRegime(history) != symbols.size()) {
+      std::cerr << "TradeSystem Regime 预热计数不符合预期\n";
+      return 1;
+    }
+    ai_trade::MarketEvent first_live;
+    first_live.ts_ms = 1700000000000 + 80 * 5000;
+    first_live.symbol = "BTCUSDT";
+    first_live.price = 150.0;
+    first_live.volume = 10.0;
+    first_live.interval_ms = 5000;
+    const auto first_decision = warm_system.Evaluate(first_live, true);
+    if (first_decision.regime.warmup) {
+      std::cerr << "预热后的首个实时 tick 不应处于 warmup\n";
       return 1;
     }
   }
 
   {
-    ai_trade::OrderManager oms;
-    ai_trade::AccountState account;
-    ai_trade::Reconciler reconciler(/*tolerance_notional_usd=*/1.0);
+    // 账户风险聚合快照：单次遍历结果与各独立聚合口径一致
+    ai_trade::TradeSystem system(10000.0, 2000.0);
+    std::vector<ai_trade::RemotePositionSnapshot> remote;
+    {
+      ai_trade::RemotePositionSnapshot p;
+      p.symbol = "BTCUSDT";
+      p.qty = 0.02;
+      p.avg_entry_price = 50000.0;
+      p.mark_price = 48000.0;
+      p.liquidation_price = 30000.0;
+      remote.push_back(p);
+    }
+    {
+      ai_trade::RemotePositionSnapshot p;
+      p.symbol = "ETHUSDT";
+      p.qty = -0.5;
+      p.avg_entry_price = 3000.0;
+      p.mark_price = 3100.0;
+      p.liquidation_price = 4200.0;
+      remote.push_back(p);
+    }
+    system.SyncAccountFromRemotePositions(remote, 10000.0);
 
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "rec-order";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 1.0;
-    intent.price = 100.0;
-    intent.purpose = ai_trade::OrderPurpose::kEntry;
-    oms.RegisterIntent(intent);
-    oms.MarkSent(intent.client_order_id);
+    const auto& account = system.GetAccount();
+    const auto snapshot = account.BuildRiskSnapshot();
+    if (!NearlyEqual(snapshot.equity_usd, account.equity_usd()) ||
+        !NearlyEqual(snapshot.drawdown_pct, account.drawdown_pct()) ||
+        !NearlyEqual(snapshot.liquidation_distance_pct,
+                     account.liquidation_distance_p95()) ||
+        !NearlyEqual(snapshot.gross_notional_usd,
+                     account.gross_notional_usd())) {
+      std::cerr << "账户风险快照与独立聚合口径不一致\n";
+      return 1;
+    }
+  }
 
-    account.OnMarket(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0});
-    ai_trade::FillEvent fill = ToFill(intent, "rec-fill-1");
-    oms.OnFill(fill);
-    account.ApplyFill(fill);
-    account.OnMarket(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0});
+  {
+    // 风控批量修正：BeginRound + ApplyBatch 与逐 symbol Apply 等价
+    ai_trade::RiskEngine batch_engine(1500.0);
+    ai_trade::RiskEngine scalar_engine(1500.0);
 
-    const auto ok = reconciler.Check(account, oms);
-    if (!ok.ok) {
-      std::cerr << "预期对账成功但失败\n";
+    std::vector<ai_trade::TargetPosition> targets;
+    targets.push_back({"BTCUSDT", 2500.0});
+    targets.push_back({"ETHUSDT", -900.0});
+    targets.push_back({"SOLUSDT", -4000.0});
+    targets.push_back({"XRPUSDT", 120.0});
+
+    struct Round {
+      bool trade_ok;
+      double drawdown_pct;
+      double liq_distance_pct;
+    };
+    // 覆盖各模式及滞回恢复路径：正常 -> 降级 -> 冷却 -> 熔断 ->
+    // 熔断滞回 -> reduce-only（通道/强平距离）-> 恢复正常。
+    const std::vector<Round> rounds = {
+        {true, 0.0, 1.0},  {true, 0.09, 1.0}, {true, 0.13, 1.0},
+        {true, 0.25, 1.0}, {true, 0.17, 1.0}, {false, 0.0, 1.0},
+        {true, 0.0, 0.05}, {true, 0.02, 1.0},
+    };
+
+    std::vector<ai_trade::RiskAdjustedPosition> batch_out(targets.size());
+    for (const auto& round : rounds) {
+      ai_trade::AccountRiskSnapshot account_risk;
+      account_risk.drawdown_pct = round.drawdown_pct;
+      account_risk.liquidation_distance_pct = round.liq_distance_pct;
+      batch_engine.BeginRound(round.trade_ok, account_risk);
+      batch_engine.ApplyBatch(targets, batch_out);
+
+      for (std::size_t i = 0; i < targets.size(); ++i) {
+        const auto scalar_out =
+            scalar_engine.Apply(targets[i], round.trade_ok,
+                                round.drawdown_pct, round.liq_distance_pct);
+        if (batch_out[i].symbol != scalar_out.symbol ||
+            batch_out[i].risk_mode != scalar_out.risk_mode ||
+            batch_out[i].reduce_only != scalar_out.reduce_only ||
+            !NearlyEqual(batch_out[i].adjusted_notional_usd,
+                         scalar_out.adjusted_notional_usd)) {
+          std::cerr << "批量风控修正与逐 symbol Apply 不一致: "
+                    << targets[i].symbol << "\n";
+          return 1;
+        }
+      }
+    }
+    if (batch_engine.mode() != scalar_engine.mode() ||
+        batch_engine.mode() != ai_trade::RiskMode::kNormal) {
+      std::cerr << "批量与逐个路径的风险状态机终态不一致\n";
       return 1;
     }
+  }
 
-    ai_trade::AccountState mismatch_account;
-    mismatch_account.OnMarket(ai_trade::MarketEvent{1, "BTCUSDT", 120.0, 120.0});
-    const auto mismatch = reconciler.Check(mismatch_account, oms);
-    if (mismatch.ok || mismatch.reason_code != "OMS_RECONCILE_MISMATCH") {
-      std::cerr << "预期对账异常未触发\n";
+  {
+    // 二进制决策日志：追加/滚动/解码往返一致，JSONL 输出格式正确
+    const auto journal_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_journal_test";
+    std::filesystem::remove_all(journal_dir);
+
+    // 滚动阈值压到 4 条记录强制触发切换。
+    const std::int64_t rotate_bytes =
+        8 + 4 * static_cast<std::int64_t>(sizeof(ai_trade::DecisionJournalRecord));
+    ai_trade::DecisionJournal journal(journal_dir.string(), rotate_bytes);
+    std::string journal_error;
+    if (!journal.Initialize(&journal_error)) {
+      std::cerr << "决策日志初始化失败: " << journal_error << "\n";
       return 1;
     }
+    const std::string first_file = journal.current_file();
 
-    const std::vector<ai_trade::RemotePositionSnapshot> remote_positions = {
-        ai_trade::RemotePositionSnapshot{
-            .symbol = "BTCUSDT",
-            .qty = 0.8,
-            .avg_entry_price = 100.0,
-            .mark_price = 101.0,
-        }};
-    const double remote_notional =
-        reconciler.ComputeRemoteNotionalUsd(remote_positions);
-    if (!NearlyEqual(remote_notional, 80.8)) {
-      std::cerr << "远端名义值计算不符合预期\n";
+    ai_trade::TradeSystem system(10000.0, 1000.0);
+    std::vector<ai_trade::MarketDecision> expected;
+    for (int i = 0; i < 10; ++i) {
+      ai_trade::MarketEvent event;
+      event.ts_ms = 1700000000000 + i * 1000;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + (i % 2 == 0 ? i * 2.0 : -i * 1.0);
+      event.volume = 5.0;
+      event.interval_ms = 1000;
+      const auto decision = system.Evaluate(event, true);
+      if (!journal.Append(event, decision, &journal_error)) {
+        std::cerr << "决策日志追加失败: " << journal_error << "\n";
+        return 1;
+      }
+      expected.push_back(decision);
+    }
+    if (journal.current_file() == first_file) {
+      std::cerr << "决策日志超过滚动阈值后未切换文件\n";
+      return 1;
+    }
+    if (journal.appended_records() != 10) {
+      std::cerr << "决策日志追加计数不符合预期\n";
       return 1;
     }
+    journal.Close();
 
-    const auto report = reconciler.BuildSymbolDeltaReport(
-        account, remote_positions, std::vector<std::string>{"BTCUSDT"}, 0.5);
-    if (report.find("BTCUSDT") == std::string::npos ||
-        report.find("delta_notional") == std::string::npos) {
-      std::cerr << "symbol级对账差异报告不符合预期: " << report << "\n";
+    std::vector<std::string> journal_files;
+    for (const auto& entry : std::filesystem::directory_iterator(journal_dir)) {
+      if (entry.path().extension() == ".dj") {
+        journal_files.push_back(entry.path().string());
+      }
+    }
+    std::sort(journal_files.begin(), journal_files.end());
+    std::vector<ai_trade::DecisionJournalRecord> records;
+    for (const auto& file : journal_files) {
+      if (!ai_trade::DecisionJournal::ReadFile(file, &records,
+                                               &journal_error)) {
+        std::cerr << "决策日志解码失败: " << journal_error << "\n";
+        return 1;
+      }
+    }
+    if (records.size() != expected.size()) {
+      std::cerr << "决策日志解码记录数不一致: " << records.size() << "\n";
+      return 1;
+    }
+    for (std::size_t i = 0; i < records.size(); ++i) {
+      const auto& record = records[i];
+      const auto& decision = expected[i];
+      if (record.ts_ms != 1700000000000 + static_cast<std::int64_t>(i) * 1000 ||
+          std::string(record.symbol) != "BTCUSDT" ||
+          record.regime != static_cast<std::uint8_t>(decision.regime.regime) ||
+          record.warmup != (decision.regime.warmup ? 1 : 0) ||
+          record.has_intent != (decision.intent.has_value() ? 1 : 0) ||
+          !NearlyEqual(record.base_notional_usd,
+                       decision.base_signal.suggested_notional_usd) ||
+          !NearlyEqual(record.adjusted_notional_usd,
+                       decision.risk_adjusted.adjusted_notional_usd)) {
+        std::cerr << "决策日志记录往返不一致: index=" << i << "\n";
+        return 1;
+      }
+      if (record.has_intent != 0 &&
+          !NearlyEqual(record.intent_qty, decision.intent->qty)) {
+        std::cerr << "决策日志意图数量往返不一致: index=" << i << "\n";
+        return 1;
+      }
+    }
+
+    const std::string json_line =
+        ai_trade::DecisionJournal::ToJsonLine(records.front());
+    if (json_line.find("\"symbol\":\"BTCUSDT\"") == std::string::npos ||
+        json_line.find("\"ts_ms\":1700000000000") == std::string::npos ||
+        json_line.find("\"risk_mode\":") == std::string::npos ||
+        json_line.front() != '{' || json_line.back() != '}') {
+      std::cerr << "决策日志 JSONL 输出格式不正确: " << json_line << "\n";
       return 1;
     }
+    std::filesystem::remove_all(journal_dir);
   }
 
   {
-    ai_trade::AppConfig config;
-    ai_trade::BotApplication app(config);
-    app.market_tick_count_ = 100;
-    app.tracked_symbols_ = {"BTCUSDT"};
-    app.system_.SyncAccountFromRemotePositions(
-        std::vector<ai_trade::RemotePositionSnapshot>{
-            ai_trade::RemotePositionSnapshot{
-                .symbol = "BTCUSDT",
-                .qty = -0.01,
-                .avg_entry_price = 75620.0,
-                .mark_price = 75620.0,
-            }},
-        /*baseline_cash_usd=*/10000.0);
-    app.recent_fill_observations_.push_back(
-        ai_trade::BotApplication::RecentFillObservation{
-            .symbol = "BTCUSDT",
-            .signed_qty = -0.005,
-            .abs_notional_usd = 378.1,
-            .tick = 99,
-        });
-    std::string explanation;
-    const bool explained = app.RecentFillsExplainReconcileMismatch(
-        std::vector<ai_trade::RemotePositionSnapshot>{
-            ai_trade::RemotePositionSnapshot{
-                .symbol = "BTCUSDT",
-                .qty = -0.005,
-                .avg_entry_price = 75620.0,
-                .mark_price = 75620.0,
-            }},
-        &explanation);
-    if (!explained || explanation.find("BTCUSDT") == std::string::npos) {
-      std::cerr << "recent fill 应解释 symbol 级对账差异\n";
+    // Gate 延迟分位门：p99 超预算触发独立失败原因
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 0;
+    gate_config.min_fills_per_window = 0;
+    gate_config.heartbeat_empty_signal_ticks = 0;
+    gate_config.window_ticks = 2;
+    gate_config.latency_p99_budget_us = 1000.0;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    // 窗口 1：延迟远低于预算，应通过。
+    for (int i = 0; i < 2; ++i) {
+      monitor.OnDecision(signal, adjusted, intent);
+      monitor.RecordDecisionLatency(10'000);  // 10us
+    }
+    monitor.OnTick();
+    const auto fast_window = monitor.OnTick();
+    if (!fast_window.has_value() || !fast_window->pass ||
+        fast_window->latency_samples != 2 ||
+        fast_window->latency_p99_us > gate_config.latency_p99_budget_us) {
+      std::cerr << "低延迟窗口不应触发延迟门失败\n";
       return 1;
     }
 
-    app.market_tick_count_ = 108;
-    app.PruneRecentFillObservations(app.market_tick_count_);
-    explanation.clear();
-    const bool stale_explained = app.RecentFillsExplainReconcileMismatch(
-        std::vector<ai_trade::RemotePositionSnapshot>{
-            ai_trade::RemotePositionSnapshot{
-                .symbol = "BTCUSDT",
-                .qty = -0.005,
-                .avg_entry_price = 75620.0,
-                .mark_price = 75620.0,
-            }},
-        &explanation);
-    if (stale_explained) {
-      std::cerr << "过期 recent fill 不应继续豁免对账差异\n";
+    // 窗口 2：p99 超出 1ms 预算，应失败且带独立原因码。
+    for (int i = 0; i < 2; ++i) {
+      monitor.OnDecision(signal, adjusted, intent);
+      monitor.RecordDecisionLatency(5'000'000);  // 5ms
+    }
+    monitor.OnTick();
+    const auto slow_window = monitor.OnTick();
+    if (!slow_window.has_value() || slow_window->pass) {
+      std::cerr << "高延迟窗口应触发 Gate 失败\n";
+      return 1;
+    }
+    bool has_latency_reason = false;
+    for (const auto& reason : slow_window->fail_reasons) {
+      if (reason == "FAIL_LATENCY_P99_BUDGET") {
+        has_latency_reason = true;
+      }
+    }
+    if (!has_latency_reason) {
+      std::cerr << "延迟超预算未输出 FAIL_LATENCY_P99_BUDGET\n";
       return 1;
     }
   }
 
   {
-    const std::filesystem::path data_dir =
-        std::filesystem::temp_directory_path() / "ai_trade_fill_guard_test";
-    std::error_code ec;
-    std::filesystem::remove_all(data_dir, ec);
+    // Gate 环形窗口历史：O(1) 推进下滚动计数只覆盖最近 N 个窗口
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 0;
+    gate_config.min_fills_per_window = 0;
+    gate_config.heartbeat_empty_signal_ticks = 0;
+    gate_config.window_ticks = 1;
+    gate_config.history_windows = 2;
+    ai_trade::GateMonitor monitor(gate_config);
 
-    ai_trade::AppConfig config;
-    config.data_path = data_dir.string();
-    ai_trade::BotApplication app(config);
-    std::string error;
-    if (!app.wal_.Initialize(&error)) {
-      std::cerr << "fill guard 测试 WAL 初始化失败: " << error << "\n";
+    ai_trade::Signal signal;
+    signal.suggested_notional_usd = 100.0;
+    signal.direction = 1;
+    ai_trade::RiskAdjustedPosition adjusted;
+    adjusted.adjusted_notional_usd = 100.0;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    // 三个窗口分别产生 2 / 1 / 4 个有效信号，深度 2 的环只保留后两个。
+    const int window_signals[] = {2, 1, 4};
+    for (const int count : window_signals) {
+      for (int i = 0; i < count; ++i) {
+        monitor.OnDecision(signal, adjusted, intent);
+      }
+      if (!monitor.OnTick().has_value()) {
+        std::cerr << "窗口结束应返回 Gate 结果\n";
+        return 1;
+      }
+    }
+    const auto& rolling = monitor.rolling();
+    if (rolling.windows != 2 || rolling.effective_signals != 5 ||
+        rolling.raw_signals != 5 || rolling.fills != 0) {
+      std::cerr << "Gate 环形滚动统计不符合预期: windows=" << rolling.windows
+                << ", effective=" << rolling.effective_signals << "\n";
       return 1;
     }
+  }
 
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "guard-order";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 1.0;
-    intent.price = 100.0;
-    intent.purpose = ai_trade::OrderPurpose::kEntry;
-    if (!app.oms_.RegisterIntent(intent)) {
-      std::cerr << "fill guard 测试 OMS 注册失败\n";
+  {
+    // 指标注册表：注册幂等、Prometheus 文本导出口径正确
+    auto& registry = ai_trade::MetricsRegistry::Instance();
+    ai_trade::MetricCounter* counter =
+        registry.RegisterCounter("test_events_total", "测试事件数");
+    ai_trade::MetricGauge* gauge =
+        registry.RegisterGauge("test_equity_usd", "测试权益");
+    ai_trade::MetricHistogram* histogram =
+        registry.RegisterHistogram("test_latency_seconds", "测试延迟");
+    if (counter == nullptr || gauge == nullptr || histogram == nullptr) {
+      std::cerr << "指标注册返回空指针\n";
+      return 1;
+    }
+    if (registry.RegisterCounter("test_events_total", "测试事件数") !=
+        counter) {
+      std::cerr << "同名计数器重复注册应返回同一槽位\n";
       return 1;
     }
-    app.oms_.MarkSent(intent.client_order_id);
 
-    ai_trade::FillEvent first_fill = ToFill(intent, "guard-fill-1");
-    app.ProcessFillEvent(first_fill);
-    if (!NearlyEqual(app.system_.account().position_qty("BTCUSDT"), 1.0) ||
-        !NearlyEqual(app.oms_.net_filled_qty("BTCUSDT"), 1.0) ||
-        app.fill_ids_.size() != 1U) {
-      std::cerr << "首笔 fill 应正常落地\n";
+    counter->Inc();
+    counter->Inc(2);
+    gauge->Set(12345.5);
+    histogram->Record(800);       // 桶 1：[512ns, 1024ns)
+    histogram->Record(3'000'000); // 3ms
+    if (counter->value() != 3 || histogram->count() != 2) {
+      std::cerr << "指标累加结果不符合预期\n";
       return 1;
     }
 
-    ai_trade::FillEvent duplicate_semantic_fill = ToFill(intent, "guard-fill-2");
-    app.ProcessFillEvent(duplicate_semantic_fill);
-    const auto* record = app.oms_.Find(intent.client_order_id);
-    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
-        !NearlyEqual(record->filled_qty, 1.0) ||
-        !NearlyEqual(app.system_.account().position_qty("BTCUSDT"), 1.0) ||
-        !NearlyEqual(app.oms_.net_filled_qty("BTCUSDT"), 1.0) ||
-        app.fill_ids_.size() != 1U) {
-      std::cerr << "超出订单数量的重复语义 fill 应被拦截\n";
+    const std::string text = registry.RenderPrometheus();
+    if (text.find("# TYPE test_events_total counter") == std::string::npos ||
+        text.find("test_events_total 3") == std::string::npos ||
+        text.find("test_equity_usd 12345.5") == std::string::npos ||
+        text.find("# TYPE test_latency_seconds histogram") ==
+            std::string::npos ||
+        text.find("test_latency_seconds_bucket{le=\"+Inf\"} 2") ==
+            std::string::npos ||
+        text.find("test_latency_seconds_count 2") == std::string::npos) {
+      std::cerr << "Prometheus 导出文本不符合预期:\n" << text << "\n";
       return 1;
     }
 
-    std::unordered_set<std::string> intent_ids;
-    std::unordered_set<std::string> fill_ids;
-    std::vector<ai_trade::FillEvent> fills;
-    if (!app.wal_.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
-      std::cerr << "fill guard 测试 WAL 回放失败: " << error << "\n";
+    // 内嵌 scrape 端点：port=0 由内核分配，GET 应返回指标文本
+    ai_trade::MetricsHttpServer server;
+    std::string error;
+    if (!server.Start(0, &error)) {
+      std::cerr << "metrics 端点启动失败: " << error << "\n";
       return 1;
     }
-    if (fill_ids.size() != 1U || fills.size() != 1U ||
-        fill_ids.count("guard-fill-2") != 0U) {
-      std::cerr << "被拦截的重复 fill 不应写入 WAL\n";
+    if (server.bound_port() <= 0) {
+      std::cerr << "metrics 端点未取得实际端口\n";
       return 1;
     }
 
-    std::filesystem::remove_all(data_dir, ec);
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      std::cerr << "测试 socket 创建失败\n";
+      return 1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(server.bound_port()));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      std::cerr << "metrics 端点连接失败\n";
+      return 1;
+    }
+    const std::string request = "GET /metrics HTTP/1.1\r\n\r\n";
+    (void)::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t n = 0;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+      response.append(buffer, static_cast<std::size_t>(n));
+    }
+    ::close(fd);
+    server.Stop();
+    if (response.find("200 OK") == std::string::npos ||
+        response.find("test_events_total 3") == std::string::npos) {
+      std::cerr << "metrics 端点响应不符合预期:\n" << response << "\n";
+      return 1;
+    }
   }
 
   {
-    const std::filesystem::path data_dir =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_unmapped_fill_guard_test";
-    std::error_code ec;
-    std::filesystem::remove_all(data_dir, ec);
+    // 分片品种统计：多线程并发累加应无丢失，Drain 聚合并清零窗口。
+    ai_trade::ShardedSymbolStats stats;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 1000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+      workers.emplace_back([&stats]() {
+        for (int i = 0; i < kPerThread; ++i) {
+          stats.Record("BTCUSDT", /*net_quality=*/i % 2 == 0, 0.5, 0.1, 10.0);
+          stats.Record("ETHUSDT", /*net_quality=*/false, -0.25, 0.05, 5.0);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
 
-    ai_trade::AppConfig config;
-    config.data_path = data_dir.string();
-    ai_trade::BotApplication app(config);
-    std::string error;
-    if (!app.wal_.Initialize(&error)) {
-      std::cerr << "unmapped fill guard 测试 WAL 初始化失败: " << error
+    std::vector<ai_trade::ShardedSymbolStats::SymbolTotals> totals;
+    stats.Drain(&totals);
+    if (totals.size() != 2) {
+      std::cerr << "分片统计 Drain 品种数不符合预期: " << totals.size()
                 << "\n";
       return 1;
     }
+    const auto find_symbol = [&totals](const std::string& symbol)
+        -> const ai_trade::ShardedSymbolStats::SymbolTotals* {
+      for (const auto& entry : totals) {
+        if (entry.symbol == symbol) {
+          return &entry;
+        }
+      }
+      return nullptr;
+    };
+    const auto* btc = find_symbol("BTCUSDT");
+    const auto* eth = find_symbol("ETHUSDT");
+    constexpr std::uint64_t kExpected = kThreads * kPerThread;
+    if (btc == nullptr || btc->fills != kExpected ||
+        btc->net_quality_fills != kExpected / 2 ||
+        !NearlyEqual(btc->realized_net_sum_usd, 0.5 * kExpected, 1e-6) ||
+        !NearlyEqual(btc->fee_usd_sum, 0.1 * kExpected, 1e-6) ||
+        !NearlyEqual(btc->notional_abs_usd_sum, 10.0 * kExpected, 1e-6)) {
+      std::cerr << "分片统计 BTCUSDT 聚合结果不符合预期\n";
+      return 1;
+    }
+    if (eth == nullptr || eth->fills != kExpected ||
+        eth->net_quality_fills != 0 ||
+        !NearlyEqual(eth->realized_net_sum_usd, -0.25 * kExpected, 1e-6)) {
+      std::cerr << "分片统计 ETHUSDT 聚合结果不符合预期\n";
+      return 1;
+    }
 
-    ai_trade::FillEvent fill;
-    fill.fill_id = "unmapped-empty-client-order";
-    fill.client_order_id = "";
-    fill.symbol = "BNBUSDT";
-    fill.direction = 1;
-    fill.qty = 0.59;
-    fill.price = 638.1;
-    fill.fee = 0.0375;
-    fill.liquidity = ai_trade::FillLiquidity::kTaker;
-    app.ProcessFillEvent(fill);
-    if (!NearlyEqual(app.system_.account().position_qty("BNBUSDT"), 0.0) ||
-        !NearlyEqual(app.oms_.net_filled_qty("BNBUSDT"), 0.0) ||
-        app.funnel_window_.fills_applied != 0 ||
-        app.pending_fills_for_evolution_ != 0 ||
-        app.fill_ids_.count(fill.fill_id) != 1U) {
-      std::cerr << "无法归因的空 client_order_id fill 不应污染本地账户/OMS/样本\n";
+    // Drain 应同时清零窗口；新样本在下个窗口重新可见。
+    stats.Drain(&totals);
+    if (!totals.empty()) {
+      std::cerr << "分片统计 Drain 未清零窗口\n";
       return 1;
     }
+    stats.Record("BTCUSDT", /*net_quality=*/true, 1.0, 0.2, 20.0);
+    stats.Drain(&totals);
+    if (totals.size() != 1 || totals[0].symbol != "BTCUSDT" ||
+        totals[0].fills != 1 || totals[0].net_quality_fills != 1) {
+      std::cerr << "分片统计清零后重新累加不符合预期\n";
+      return 1;
+    }
+  }
 
-    std::unordered_set<std::string> intent_ids;
-    std::unordered_set<std::string> fill_ids;
-    std::vector<ai_trade::FillEvent> fills;
-    if (!app.wal_.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
-      std::cerr << "unmapped fill guard 测试 WAL 回放失败: " << error << "\n";
+  {
+    // 共享内存事件总线：写读往返、记录类型区分与套圈丢弃语义。
+    const auto bus_path =
+        (std::filesystem::temp_directory_path() / "ai_trade_test_shm_bus.bin")
+            .string();
+    ai_trade::ShmEventBusWriter writer;
+    std::string bus_error;
+    if (!writer.Create(bus_path, /*capacity=*/8, &bus_error)) {
+      std::cerr << "shm 总线创建失败: " << bus_error << "\n";
       return 1;
     }
-    if (!fill_ids.empty() || !fills.empty()) {
-      std::cerr << "无法归因的 fill 不应写入 WAL 成为可回放策略成交\n";
+
+    ai_trade::MarketEvent market{1000, "BTCUSDT", 100.5, 100.6, 2000.0, 5000};
+    writer.Publish(market);
+    ai_trade::MarketDecision decision;
+    writer.Publish(market, decision);
+    ai_trade::FillEvent fill;
+    fill.fill_id = "shm-fill-1";
+    fill.client_order_id = "shm-order-1";
+    fill.symbol = "BTCUSDT";
+    fill.direction = -1;
+    fill.qty = 0.25;
+    fill.price = 101.0;
+    fill.fee = 0.05;
+    writer.Publish(fill);
+
+    ai_trade::ShmEventBusReader reader;
+    if (!reader.Open(bus_path, &bus_error)) {
+      std::cerr << "shm 总线读者打开失败: " << bus_error << "\n";
+      return 1;
+    }
+    ai_trade::ShmEventRecord record;
+    if (!reader.Next(&record) ||
+        record.type != static_cast<std::uint8_t>(
+                           ai_trade::ShmEventType::kMarket) ||
+        record.payload.market.ts_ms != 1000 ||
+        std::string(record.payload.market.symbol) != "BTCUSDT" ||
+        !NearlyEqual(record.payload.market.price, 100.5, 1e-12)) {
+      std::cerr << "shm 总线行情记录回读不符合预期\n";
+      return 1;
+    }
+    if (!reader.Next(&record) ||
+        record.type != static_cast<std::uint8_t>(
+                           ai_trade::ShmEventType::kDecision)) {
+      std::cerr << "shm 总线决策记录回读不符合预期\n";
+      return 1;
+    }
+    if (!reader.Next(&record) ||
+        record.type != static_cast<std::uint8_t>(
+                           ai_trade::ShmEventType::kFill) ||
+        std::string(record.payload.fill.client_order_id) != "shm-order-1" ||
+        record.payload.fill.direction != -1 ||
+        !NearlyEqual(record.payload.fill.qty, 0.25, 1e-12)) {
+      std::cerr << "shm 总线成交记录回读不符合预期\n";
+      return 1;
+    }
+    if (reader.Next(&record)) {
+      std::cerr << "shm 总线无新记录时 Next 应返回 false\n";
       return 1;
     }
 
-    std::filesystem::remove_all(data_dir, ec);
+    // 写者超出环容量套圈：慢读者跳到最旧可读记录并累计丢弃数。
+    for (int i = 0; i < 20; ++i) {
+      market.ts_ms = 2000 + i;
+      writer.Publish(market);
+    }
+    std::size_t read_back = 0;
+    std::int64_t first_ts = 0;
+    while (reader.Next(&record)) {
+      if (read_back == 0) {
+        first_ts = record.payload.market.ts_ms;
+      }
+      ++read_back;
+    }
+    if (read_back != 8 || first_ts != 2000 + 12 || reader.dropped() != 12) {
+      std::cerr << "shm 总线套圈语义不符合预期: read=" << read_back
+                << ", first_ts=" << first_ts
+                << ", dropped=" << reader.dropped() << "\n";
+      return 1;
+    }
+
+    reader.Close();
+    writer.Close();
+    std::filesystem::remove(bus_path);
   }
 
   {
-    const std::filesystem::path data_dir =
-        std::filesystem::temp_directory_path() / "ai_trade_cancelled_late_fill_test";
-    std::error_code ec;
-    std::filesystem::remove_all(data_dir, ec);
-
-    ai_trade::AppConfig config;
-    config.data_path = data_dir.string();
-    ai_trade::BotApplication app(config);
-    std::string error;
-    if (!app.wal_.Initialize(&error)) {
-      std::cerr << "cancelled late fill 测试 WAL 初始化失败: " << error << "\n";
+    // SPSC 环：容量取整、FIFO 顺序、队满/队空边界
+    ai_trade::SpscRing<int> ring(3);
+    if (ring.capacity() != 4) {
+      std::cerr << "SPSC 环容量未取整到 2 的幂\n";
       return 1;
     }
-
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "cancelled-late-fill";
-    intent.symbol = "SOLUSDT";
-    intent.direction = -1;
-    intent.qty = 4.4;
-    intent.price = 85.0;
-    intent.purpose = ai_trade::OrderPurpose::kEntry;
-    if (!app.oms_.RegisterIntent(intent)) {
-      std::cerr << "cancelled late fill 测试 OMS 注册失败\n";
+    for (int i = 0; i < 4; ++i) {
+      if (!ring.TryPush(static_cast<int&&>(i))) {
+        std::cerr << "SPSC 环未满时入队失败\n";
+        return 1;
+      }
+    }
+    int overflow = 99;
+    if (ring.TryPush(static_cast<int&&>(overflow))) {
+      std::cerr << "SPSC 环队满时应拒绝入队\n";
       return 1;
     }
-    app.oms_.MarkSent(intent.client_order_id);
-    app.oms_.MarkCancelled(intent.client_order_id);
-
-    ai_trade::FillEvent fill = ToFill(intent, "cancelled-late-fill-1");
-    app.ProcessFillEvent(fill);
-    const auto* record = app.oms_.Find(intent.client_order_id);
-    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
-        !NearlyEqual(record->filled_qty, 4.4) ||
-        !NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
-        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
-        app.fill_ids_.size() != 1U) {
-      std::cerr << "cancelled late fill 应合法落地一次并补齐 OMS 状态\n";
+    for (int i = 0; i < 4; ++i) {
+      int value = -1;
+      if (!ring.TryPop(&value) || value != i) {
+        std::cerr << "SPSC 环出队顺序错误: " << value << "\n";
+        return 1;
+      }
+    }
+    int empty_value = -1;
+    if (ring.TryPop(&empty_value) || !ring.Empty()) {
+      std::cerr << "SPSC 环队空时应拒绝出队\n";
       return 1;
     }
 
-    std::filesystem::remove_all(data_dir, ec);
+    // 异步执行器：无锁环 + eventfd 唤醒后提交/撤单结果应完整回流
+    ai_trade::MockExchangeAdapter adapter({100.0});
+    adapter.Connect();
+    ai_trade::AsyncExecutor executor(&adapter);
+    executor.Start();
+
+    constexpr int kIntents = 64;
+    for (int i = 0; i < kIntents; ++i) {
+      ai_trade::OrderIntent intent;
+      intent.client_order_id = "spsc-" + std::to_string(i);
+      intent.symbol = "BTCUSDT";
+      intent.purpose = ai_trade::OrderPurpose::kEntry;
+      intent.direction = 1;
+      intent.qty = 0.01;
+      intent.price = 100.0;
+      executor.Submit(intent);
+    }
+    executor.Cancel("spsc-0");
+
+    std::vector<ai_trade::AsyncResult> results;
+    std::vector<ai_trade::AsyncResult> batch;
+    for (int spin = 0;
+         spin < 10000 && results.size() < static_cast<size_t>(kIntents) + 1;
+         ++spin) {
+      executor.PollResults(&batch);
+      for (auto& result : batch) {
+        results.push_back(std::move(result));
+      }
+      std::this_thread::yield();
+    }
+    executor.Stop();
+    if (results.size() != static_cast<size_t>(kIntents) + 1) {
+      std::cerr << "异步执行结果数量不符合预期: " << results.size() << "\n";
+      return 1;
+    }
+    for (int i = 0; i < kIntents; ++i) {
+      if (results[i].client_order_id != "spsc-" + std::to_string(i) ||
+          !results[i].success || results[i].is_cancel) {
+        std::cerr << "异步提交结果乱序或失败: index=" << i << "\n";
+        return 1;
+      }
+    }
+    if (!results.back().is_cancel || results.back().client_order_id != "spsc-0") {
+      std::cerr << "撤单结果未按提交顺序回流\n";
+      return 1;
+    }
   }
 
   {
-    const std::filesystem::path data_dir =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_account_reflected_fill_test";
-    std::error_code ec;
-    std::filesystem::remove_all(data_dir, ec);
-
-    ai_trade::AppConfig config;
-    config.data_path = data_dir.string();
-    ai_trade::BotApplication app(config);
-    std::string error;
-    if (!app.wal_.Initialize(&error)) {
-      std::cerr << "account reflected fill 测试 WAL 初始化失败: " << error << "\n";
+    // 结果唤醒 fd：执行结果入环后应写 eventfd，等待方无需定长睡眠
+    ai_trade::MockExchangeAdapter adapter({100.0});
+    adapter.Connect();
+    ai_trade::AsyncExecutor executor(&adapter);
+    const int wake_fd = ::eventfd(0, EFD_NONBLOCK);
+    if (wake_fd < 0) {
+      std::cerr << "eventfd 创建失败\n";
       return 1;
     }
+    executor.SetResultWakeFd(wake_fd);
+    executor.Start();
 
     ai_trade::OrderIntent intent;
-    intent.client_order_id = "account-reflected-fill";
-    intent.symbol = "SOLUSDT";
-    intent.direction = -1;
-    intent.qty = 4.4;
-    intent.price = 85.0;
+    intent.client_order_id = "wake-0";
+    intent.symbol = "BTCUSDT";
     intent.purpose = ai_trade::OrderPurpose::kEntry;
-    if (!app.oms_.RegisterIntent(intent)) {
-      std::cerr << "account reflected fill 测试 OMS 注册失败\n";
-      return 1;
-    }
-    app.oms_.MarkSent(intent.client_order_id);
-    app.oms_.MarkCancelled(intent.client_order_id);
-    app.system_.SyncAccountFromRemotePositions(
-        {ai_trade::RemotePositionSnapshot{
-             .symbol = "SOLUSDT",
-             .qty = -4.4,
-             .avg_entry_price = 85.0,
-             .mark_price = 85.0,
-         }},
-        10000.0);
+    intent.direction = 1;
+    intent.qty = 0.01;
+    intent.price = 100.0;
+    executor.Submit(intent);
 
-    ai_trade::FillEvent fill = ToFill(intent, "account-reflected-fill-1");
-    app.ProcessFillEvent(fill);
-    const auto* record = app.oms_.Find(intent.client_order_id);
-    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
-        !NearlyEqual(record->filled_qty, 4.4) ||
-        !NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
-        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
-        app.fill_ids_.size() != 1U) {
-      std::cerr << "已由账户同步反映的 late fill 不应再次扩大本地仓位\n";
+    struct pollfd pfd{};
+    pfd.fd = wake_fd;
+    pfd.events = POLLIN;
+    const int ready = ::poll(&pfd, 1, 2000);
+    if (ready <= 0 || (pfd.revents & POLLIN) == 0) {
+      std::cerr << "结果就绪后未收到 eventfd 唤醒\n";
       return 1;
     }
+    std::uint64_t pending = 0;
+    (void)!::read(wake_fd, &pending, sizeof(pending));
 
-    ai_trade::FillEvent duplicate_fill = ToFill(intent, "account-reflected-fill-2");
-    app.ProcessFillEvent(duplicate_fill);
-    if (!NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
-        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
-        app.fill_ids_.size() != 1U) {
-      std::cerr << "已补齐订单数量后的 late fill 重复回报应被拦截\n";
+    std::vector<ai_trade::AsyncResult> results;
+    executor.PollResults(&results);
+    if (results.size() != 1 || results[0].client_order_id != "wake-0" ||
+        !results[0].success) {
+      std::cerr << "唤醒后结果未能立刻消费\n";
       return 1;
     }
-
-    std::filesystem::remove_all(data_dir, ec);
+    executor.SetResultWakeFd(-1);
+    executor.Stop();
+    ::close(wake_fd);
   }
 
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 2;
-    config.max_active_symbols = 2;
-    config.min_active_symbols = 1;
-    config.fallback_symbols = {"BTCUSDT"};
-    config.min_turnover_usd = 100000.0; // 设置成交额门槛
-    config.candidate_symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT"};
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    if (selector.active_symbols().empty()) {
-      std::cerr << "Universe 初始 active_symbols 不应为空\n";
+    // 多通道执行器：不同 symbol 并发、同 symbol 串行、撤单随原通道
+    LaneRecordingAdapter adapter;
+    adapter.Connect();
+    ai_trade::AsyncExecutor executor(&adapter, 4);
+    if (executor.lane_count() != 4) {
+      std::cerr << "执行器通道数不符合预期\n";
       return 1;
     }
+    executor.Start();
 
-    const auto first = selector.OnMarket(ai_trade::MarketEvent{
-        1, "BTCUSDT", 100.0, 100.0, 2000.0}); // Turnover = 200,000 > 100,000
-    if (first.has_value()) {
-      std::cerr << "Universe 未到更新间隔不应刷新\n";
-      return 1;
+    constexpr int kPerSymbol = 32;
+    const std::string symbols[] = {"BTCUSDT", "ETHUSDT"};
+    for (int i = 0; i < kPerSymbol; ++i) {
+      for (const auto& symbol : symbols) {
+        ai_trade::OrderIntent intent;
+        intent.client_order_id = symbol + "-" + std::to_string(i);
+        intent.symbol = symbol;
+        intent.purpose = ai_trade::OrderPurpose::kEntry;
+        intent.direction = 1;
+        intent.qty = 0.01;
+        intent.price = 100.0;
+        executor.Submit(intent);
+      }
     }
-    const auto second = selector.OnMarket(ai_trade::MarketEvent{
-        2, "ETHUSDT", 2000.0, 2000.0, 10.0}); // Turnover = 20,000 < 100,000
-    if (!second.has_value()) {
-      std::cerr << "Universe 到更新间隔应刷新\n";
-      return 1;
+    executor.Cancel("BTCUSDT-5");
+
+    std::vector<ai_trade::AsyncResult> results;
+    std::vector<ai_trade::AsyncResult> batch;
+    const std::size_t expected = 2 * kPerSymbol + 1;
+    for (int spin = 0; spin < 10000 && results.size() < expected; ++spin) {
+      executor.PollResults(&batch);
+      for (auto& result : batch) {
+        results.push_back(std::move(result));
+      }
+      std::this_thread::yield();
     }
-    if (second->active_symbols.empty() ||
-        static_cast<int>(second->active_symbols.size()) > config.max_active_symbols) {
-      std::cerr << "Universe 刷新后的 active_symbols 数量不符合预期\n";
+    executor.Stop();
+    if (results.size() != expected) {
+      std::cerr << "多通道执行结果数量不符合预期: " << results.size() << "\n";
       return 1;
     }
-    // ETHUSDT 成交额不足，应被过滤，仅剩 BTCUSDT (或 fallback)
-    if (selector.IsActive("ETHUSDT")) {
-      std::cerr << "Universe 应过滤低成交额币对\n";
-      return 1;
+    // 核心不变量：每个 symbol 内部到达交易所的顺序与提交顺序一致。
+    for (const auto& symbol : symbols) {
+      const auto submitted = adapter.SubmittedFor(symbol);
+      if (submitted.size() != kPerSymbol) {
+        std::cerr << symbol << " 提交数量不符合预期: " << submitted.size()
+                  << "\n";
+        return 1;
+      }
+      for (int i = 0; i < kPerSymbol; ++i) {
+        if (submitted[i] != symbol + "-" + std::to_string(i)) {
+          std::cerr << symbol << " 同 symbol 顺序被打乱: " << submitted[i]
+                    << "\n";
+          return 1;
+        }
+      }
     }
-    if (!selector.IsActive("BTCUSDT")) {
-      std::cerr << "Universe 应保留高成交额币对\n";
+    const auto cancelled = adapter.Cancelled();
+    if (cancelled.size() != 1 || cancelled[0] != "BTCUSDT-5") {
+      std::cerr << "撤单未到达交易所或目标错误\n";
       return 1;
     }
   }
 
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 1;
-    config.max_active_symbols = 3;
-    config.min_active_symbols = 1;
-    config.fallback_symbols = {"BTCUSDT", "ETHUSDT"};
-    config.candidate_symbols = {"BTCUSDT", "ETHUSDT"};
+    // 批量提交合并：Start 前排队的同通道提交应合并为一次批量调用
+    LaneRecordingAdapter adapter;
+    adapter.Connect();
+    ai_trade::AsyncExecutor executor(&adapter, 1);
 
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    selector.SetAllowedSymbols({"BTCUSDT"});
-    const auto update = selector.OnMarket(ai_trade::MarketEvent{
-        1, "ETHUSDT", 2000.0, 2000.0});
-    if (!update.has_value() || update->active_symbols.empty()) {
-      std::cerr << "Universe 允许集合过滤后应仍有活跃币对\n";
+    constexpr int kQueued = 3;  // entry + TP/SL 保护单族的典型批量
+    for (int i = 0; i < kQueued; ++i) {
+      ai_trade::OrderIntent intent;
+      intent.client_order_id = "batch-" + std::to_string(i);
+      intent.symbol = "BTCUSDT";
+      intent.purpose = ai_trade::OrderPurpose::kEntry;
+      intent.direction = 1;
+      intent.qty = 0.01;
+      intent.price = 100.0;
+      executor.Submit(intent);
+    }
+    executor.Start();
+
+    std::vector<ai_trade::AsyncResult> results;
+    std::vector<ai_trade::AsyncResult> batch;
+    for (int spin = 0;
+         spin < 10000 && results.size() < static_cast<size_t>(kQueued);
+         ++spin) {
+      executor.PollResults(&batch);
+      for (auto& result : batch) {
+        results.push_back(std::move(result));
+      }
+      std::this_thread::yield();
+    }
+    executor.Stop();
+    if (results.size() != static_cast<size_t>(kQueued)) {
+      std::cerr << "批量提交结果数量不符合预期: " << results.size() << "\n";
       return 1;
     }
-    for (const auto& symbol : update->active_symbols) {
-      if (symbol != "BTCUSDT") {
-        std::cerr << "Universe 允许集合过滤结果包含非允许symbol\n";
+    for (int i = 0; i < kQueued; ++i) {
+      if (!results[i].success ||
+          results[i].client_order_id != "batch-" + std::to_string(i)) {
+        std::cerr << "批量提交结果乱序或失败: index=" << i << "\n";
         return 1;
       }
     }
+    const auto batch_sizes = adapter.BatchSizes();
+    if (batch_sizes.size() != 1 || batch_sizes[0] != kQueued) {
+      std::cerr << "同批排队提交未合并为一次批量调用: calls="
+                << batch_sizes.size() << "\n";
+      return 1;
+    }
+    const auto submitted = adapter.SubmittedFor("BTCUSDT");
+    if (submitted.size() != kQueued || submitted[0] != "batch-0" ||
+        submitted[2] != "batch-2") {
+      std::cerr << "批量提交到达顺序不符合预期\n";
+      return 1;
+    }
   }
 
+#if defined(AI_TRADE_EVAL_LATENCY_PROFILING)
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 1;
-    config.max_active_symbols = 2;
-    config.min_active_symbols = 2;
-    config.fallback_symbols = {"BTCUSDT", "ETHUSDT"};
-    config.candidate_symbols = {"SOLUSDT"};
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    const auto update = selector.OnMarket(ai_trade::MarketEvent{
-        1, "SOLUSDT", 80.0, 80.0});
-    if (!update.has_value()) {
-      std::cerr << "Universe 预期应触发刷新\n";
-      return 1;
+    // Evaluate 延迟画像：跑若干 tick 后各阶段应有样本且摘要可读
+    ai_trade::TradeSystem system(10000.0, 1000.0);
+    for (int i = 0; i < 20; ++i) {
+      system.OnPrice(100.0 + i);
     }
-    if (!update->degraded_to_fallback || update->reason_code.empty()) {
-      std::cerr << "Universe 预期应触发 fallback 降级\n";
+    const std::string summary = system.EvaluateLatencySummary();
+    if (summary.find("EVAL_LATENCY: regime={") == std::string::npos ||
+        summary.find("total={") == std::string::npos) {
+      std::cerr << "Evaluate 延迟摘要格式不符合预期: " << summary << "\n";
       return 1;
     }
-    if (update->active_symbols.size() != 2U) {
-      std::cerr << "Universe fallback 后活跃币对应满足最小数量\n";
+    const ai_trade::SymbolId btc_id = ai_trade::InternSymbol("BTCUSDT");
+    const auto* total = system.EvaluateLatencyFor(
+        btc_id, ai_trade::EvaluateStage::kTotal);
+    if (total == nullptr || total->count() != 20) {
+      std::cerr << "per-symbol 延迟直方图样本数不符合预期\n";
       return 1;
     }
   }
+#endif
 
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 14;
-    config.max_active_symbols = 2;
-    config.min_active_symbols = 1;
-    config.min_turnover_usd = 1000.0;
-    config.trend_reserve_enabled = true;
-    config.trend_reserve_slots = 1;
-    config.fallback_symbols = {"BTCUSDT"};
-    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT", "QUIETUSDT"};
+    const std::filesystem::path wal_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_trade.wal";
+    std::error_code ec;
+    std::filesystem::remove(wal_path, ec);
 
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    std::optional<ai_trade::UniverseUpdate> update;
-    const auto push = [&selector, &update](std::int64_t ts,
-                                           const std::string& symbol,
-                                           double price) {
-      update = selector.OnMarket(
-          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
-    };
+    ai_trade::WalStore wal(wal_path.string());
+    std::string error;
+    if (!wal.Initialize(&error)) {
+      std::cerr << "WAL 初始化失败: " << error << "\n";
+      return 1;
+    }
 
-    push(1, "TRENDUSDT", 100.0);
-    push(2, "QUIETUSDT", 100.0);
-    push(3, "CHOPUSDT", 100.0);
-    push(4, "CHOPUSDT", 102.0);
-    push(5, "CHOPUSDT", 100.0);
-    push(6, "CHOPUSDT", 102.0);
-    push(7, "CHOPUSDT", 100.0);
-    push(8, "CHOPUSDT", 102.0);
-    push(9, "CHOPUSDT", 100.0);
-    push(10, "CHOPUSDT", 102.0);
-    push(11, "CHOPUSDT", 100.0);
-    push(12, "TRENDUSDT", 101.0);
-    push(13, "TRENDUSDT", 102.0);
-    push(14, "QUIETUSDT", 100.01);
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "cid-1";
+    intent.symbol = "BTCUSDT";
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    intent.reduce_only = false;
+    intent.direction = 1;
+    intent.qty = 2.0;
+    intent.price = 100.0;
 
-    if (!update.has_value()) {
-      std::cerr << "Universe 趋势保留槽测试应触发刷新\n";
+    if (!wal.AppendIntent(intent, &error)) {
+      std::cerr << "WAL 追加 intent 失败: " << error << "\n";
       return 1;
     }
-    if (!selector.IsActive("CHOPUSDT")) {
-      std::cerr << "Universe 稳健槽应保留高活跃高波动币对\n";
+    ai_trade::FillEvent fill_1 = ToFill(intent, "fill-1");
+    fill_1.qty = 0.8;
+    ai_trade::FillEvent fill_2 = ToFill(intent, "fill-2");
+    fill_2.qty = 1.2;
+
+    if (!wal.AppendFill(fill_1, &error)) {
+      std::cerr << "WAL 追加 fill_1 失败: " << error << "\n";
       return 1;
     }
-    if (!selector.IsActive("TRENDUSDT")) {
-      std::cerr << "Universe 趋势保留槽应补充持续单边币对\n";
+    if (!wal.AppendFill(fill_2, &error)) {
+      std::cerr << "WAL 追加 fill_2 失败: " << error << "\n";
       return 1;
     }
-    if (selector.IsActive("QUIETUSDT")) {
-      std::cerr << "Universe 不应选入安静币对\n";
+    if (!wal.AppendFill(fill_1, &error)) {
+      std::cerr << "WAL 追加重复 fill_1 失败: " << error << "\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 14;
-    config.max_active_symbols = 2;
-    config.min_active_symbols = 1;
-    config.min_turnover_usd = 1000.0;
-    config.trend_reserve_enabled = true;
-    config.trend_reserve_slots = 1;
-    config.trend_reserve_min_residency_refreshes = 2;
-    config.reset_stats_on_refresh = true;
-    config.fallback_symbols = {"BTCUSDT"};
-    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT", "QUIETUSDT", "NEWUSDT"};
-
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    std::optional<ai_trade::UniverseUpdate> update;
-    const auto push = [&selector, &update](std::int64_t ts,
-                                           const std::string& symbol,
-                                           double price) {
-      update = selector.OnMarket(
-          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
-    };
 
-    push(1, "TRENDUSDT", 100.0);
-    push(2, "QUIETUSDT", 100.0);
-    push(3, "CHOPUSDT", 100.0);
-    push(4, "CHOPUSDT", 102.0);
-    push(5, "CHOPUSDT", 100.0);
-    push(6, "CHOPUSDT", 102.0);
-    push(7, "CHOPUSDT", 100.0);
-    push(8, "CHOPUSDT", 102.0);
-    push(9, "CHOPUSDT", 100.0);
-    push(10, "CHOPUSDT", 102.0);
-    push(11, "CHOPUSDT", 100.0);
-    push(12, "TRENDUSDT", 101.0);
-    push(13, "TRENDUSDT", 102.0);
-    push(14, "QUIETUSDT", 100.01);
+    std::unordered_set<std::string> intent_ids;
+    std::unordered_set<std::string> fill_ids;
+    std::vector<ai_trade::FillEvent> fills;
+    if (!wal.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
+      std::cerr << "WAL 加载失败: " << error << "\n";
+      return 1;
+    }
 
-    if (!update.has_value() || !selector.IsActive("TRENDUSDT")) {
-      std::cerr << "Universe 趋势保留驻留首轮应选入趋势币对\n";
+    if (intent_ids.size() != 1 || fill_ids.size() != 2 || fills.size() != 2) {
+      std::cerr << "WAL 去重或加载计数不符合预期\n";
       return 1;
     }
 
-    for (int i = 0; i < 14; ++i) {
-      push(15 + i, "NEWUSDT", 100.0 + static_cast<double>(i) * 2.0);
+    ai_trade::TradeSystem recovered_system(/*risk_cap_usd=*/500.0,
+                                           /*max_order_notional_usd=*/200.0);
+    for (const auto& fill : fills) {
+      recovered_system.OnFill(fill);
     }
-    if (!update.has_value()) {
-      std::cerr << "Universe 趋势保留驻留第二轮应刷新\n";
+    if (!NearlyEqual(recovered_system.account().current_notional_usd(), 200.0)) {
+      std::cerr << "WAL 回放后仓位恢复不符合预期\n";
       return 1;
     }
-    if (!selector.IsActive("TRENDUSDT")) {
-      std::cerr << "Universe 趋势保留驻留应避免趋势币对被立即轮换\n";
-      return 1;
+
+    std::filesystem::remove(wal_path);
+  }
+
+  {
+    // 二进制 WAL：历史文本行混读、kEntry 返回即耐久、残缺尾部按截断忽略。
+    const std::filesystem::path wal_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_binary.wal";
+    std::error_code ec;
+    std::filesystem::remove(wal_path, ec);
+
+    {
+      // 预置旧文本格式记录，验证新恢复路径兼容既有 WAL 文件。
+      std::ofstream out(wal_path);
+      out << "INTENT\tlegacy-1\tBTCUSDT\t0\t0\t0\t1\t1\t100\n";
+      out << "FILL2\tlegacy-fill\tlegacy-1\tBTCUSDT\t1\t1\t100\t0.01\n";
     }
-    if (std::find(update->sticky_trend_reserve_symbols.begin(),
-                  update->sticky_trend_reserve_symbols.end(),
-                  "TRENDUSDT") ==
-        update->sticky_trend_reserve_symbols.end()) {
-      std::cerr << "Universe 应上报 sticky trend reserve 币对\n";
+
+    {
+      ai_trade::WalStore wal(wal_path.string());
+      std::string error;
+      if (!wal.Initialize(&error)) {
+        std::cerr << "二进制 WAL 初始化失败: " << error << "\n";
+        return 1;
+      }
+
+      ai_trade::OrderIntent intent;
+      intent.client_order_id = "bin-1";
+      intent.symbol = "ETHUSDT";
+      intent.purpose = ai_trade::OrderPurpose::kEntry;
+      intent.liquidity_preference = ai_trade::LiquidityPreference::kMaker;
+      intent.reduce_only = false;
+      intent.direction = -1;
+      intent.qty = 1.5;
+      intent.price = 2500.0;
+      if (!wal.AppendIntent(intent, &error)) {
+        std::cerr << "二进制 WAL 追加 kEntry intent 失败: " << error << "\n";
+        return 1;
+      }
+
+      // kEntry 组提交语义：AppendIntent 返回后另一实例应立即可见。
+      ai_trade::WalStore reader(wal_path.string());
+      std::unordered_set<std::string> intent_ids;
+      std::unordered_set<std::string> fill_ids;
+      std::vector<ai_trade::FillEvent> fills;
+      if (!reader.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
+        std::cerr << "二进制 WAL 混读失败: " << error << "\n";
+        return 1;
+      }
+      if (intent_ids.count("legacy-1") != 1U || intent_ids.count("bin-1") != 1U ||
+          fill_ids.count("legacy-fill") != 1U || fills.size() != 1U) {
+        std::cerr << "文本/二进制混合 WAL 恢复结果不符合预期\n";
+        return 1;
+      }
+
+      ai_trade::FillEvent fill;
+      fill.fill_id = "bin-fill-1";
+      fill.client_order_id = "bin-1";
+      fill.symbol = "ETHUSDT";
+      fill.direction = -1;
+      fill.qty = 1.5;
+      fill.price = 2500.0;
+      fill.fee = 0.75;
+      if (!wal.AppendFill(fill, &error) || !wal.Flush(&error)) {
+        std::cerr << "二进制 WAL 成交攒批/栅栏失败: " << error << "\n";
+        return 1;
+      }
+      if (!reader.LoadState(&intent_ids, &fill_ids, &fills, &error) ||
+          fill_ids.count("bin-fill-1") != 1U || fills.size() != 2U ||
+          !NearlyEqual(fills[1].qty, 1.5) ||
+          !NearlyEqual(fills[1].fee, 0.75)) {
+        std::cerr << "Flush 后成交记录应可恢复且字段往返无损\n";
+        return 1;
+      }
+    }
+
+    {
+      // 崩溃遗留的残缺尾部记录（只有哨兵 + 半个头部）应被忽略。
+      std::ofstream out(wal_path, std::ios::app | std::ios::binary);
+      out.put('\x01');
+      out.put('\x02');
+    }
+    ai_trade::WalStore tail_reader(wal_path.string());
+    std::unordered_set<std::string> intent_ids;
+    std::unordered_set<std::string> fill_ids;
+    std::vector<ai_trade::FillEvent> fills;
+    std::string error;
+    if (!tail_reader.LoadState(&intent_ids, &fill_ids, &fills, &error) ||
+        intent_ids.size() != 2U || fill_ids.size() != 2U) {
+      std::cerr << "残缺尾部记录应按日志截断语义忽略: " << error << "\n";
       return 1;
     }
+
+    std::filesystem::remove(wal_path, ec);
   }
 
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 3;
-    config.max_active_symbols = 2;
-    config.min_active_symbols = 1;
-    config.min_turnover_usd = 1000.0;
-    config.trend_reserve_enabled = true;
-    config.trend_reserve_slots = 1;
-    config.trend_reserve_min_residency_refreshes = 2;
-    config.warmup_trend_reserve_min_ratio = 0.6;
-    config.reset_stats_on_refresh = true;
-    config.fallback_symbols = {"BTCUSDT"};
-    config.candidate_symbols = {"COREUSDT", "WARMUSDT", "NEWUSDT"};
-
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    std::optional<ai_trade::UniverseUpdate> update;
-    const auto push = [&selector, &update](std::int64_t ts,
-                                           const std::string& symbol,
-                                           double price) {
-      update = selector.OnMarket(
-          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
+    // WAL 分段 + 快照压实：段封存、压实归档、恢复只读快照 + 存活段。
+    const std::filesystem::path wal_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_test_wal_segments";
+    std::error_code ec;
+    std::filesystem::remove_all(wal_dir, ec);
+    std::filesystem::create_directories(wal_dir);
+    const std::string wal_path = (wal_dir / "trade.wal").string();
+
+    const auto count_files = [&wal_dir](const char* needle,
+                                        const char* exclude) {
+      int count = 0;
+      for (const auto& entry : std::filesystem::directory_iterator(wal_dir)) {
+        const std::string name = entry.path().filename().string();
+        if (name.find(needle) == std::string::npos) {
+          continue;
+        }
+        if (exclude != nullptr && name.find(exclude) != std::string::npos) {
+          continue;
+        }
+        ++count;
+      }
+      return count;
     };
 
-    push(1, "COREUSDT", 100.0);
-    push(2, "WARMUSDT", 100.0);
-    if (!selector.RecordWarmupTrendCandidate("WARMUSDT", 0.8)) {
-      std::cerr << "Universe warmup 趋势候选应进入趋势保留驻留队列\n";
+    {
+      // 刻意用极小的段阈值触发活动文件封存。
+      ai_trade::WalStore wal(wal_path, /*segment_max_bytes=*/64);
+      std::string error;
+      if (!wal.Initialize(&error)) {
+        std::cerr << "分段 WAL 初始化失败: " << error << "\n";
+        return 1;
+      }
+      for (int i = 0; i < 4; ++i) {
+        ai_trade::OrderIntent intent;
+        intent.client_order_id = "seg-cid-" + std::to_string(i);
+        intent.symbol = "BTCUSDT";
+        intent.purpose = ai_trade::OrderPurpose::kEntry;
+        intent.direction = 1;
+        intent.qty = 1.0;
+        intent.price = 100.0;
+        if (!wal.AppendIntent(intent, &error)) {
+          std::cerr << "分段 WAL 追加 intent 失败: " << error << "\n";
+          return 1;
+        }
+      }
+      ai_trade::FillEvent fill;
+      fill.fill_id = "seg-fill-1";
+      fill.client_order_id = "seg-cid-0";
+      fill.symbol = "BTCUSDT";
+      fill.direction = 1;
+      fill.qty = 1.0;
+      fill.price = 100.0;
+      fill.fee = 0.05;
+      if (!wal.AppendFill(fill, &error) || !wal.Flush(&error)) {
+        std::cerr << "分段 WAL 追加 fill 失败: " << error << "\n";
+        return 1;
+      }
+    }
+    if (count_files(".seg-", ".archived") < 1) {
+      std::cerr << "超过段阈值后应产生已封存段文件\n";
       return 1;
     }
-    push(3, "NEWUSDT", 100.0);
-    if (!update.has_value() || !selector.IsActive("WARMUSDT")) {
-      std::cerr << "Universe warmup 趋势候选应在下一轮刷新中保留\n";
+
+    ai_trade::WalStore wal(wal_path, /*segment_max_bytes=*/64);
+    std::string error;
+    if (!wal.Compact(&error)) {
+      std::cerr << "WAL 压实失败: " << error << "\n";
       return 1;
     }
-    if (std::find(update->sticky_trend_reserve_symbols.begin(),
-                  update->sticky_trend_reserve_symbols.end(),
-                  "WARMUSDT") ==
-        update->sticky_trend_reserve_symbols.end()) {
-      std::cerr << "Universe warmup 趋势候选应上报 sticky reserve\n";
+    if (!std::filesystem::exists(wal_path + ".snapshot") ||
+        count_files(".seg-", ".archived") != 0 ||
+        count_files(".archived", nullptr) < 1) {
+      std::cerr << "压实后应生成快照并归档全部已封存段\n";
       return 1;
     }
 
-    for (int i = 0; i < 3; ++i) {
-      push(4 + i, "NEWUSDT", 102.0 + static_cast<double>(i) * 3.0);
-    }
-    if (!update.has_value() || !selector.IsActive("WARMUSDT")) {
-      std::cerr << "Universe warmup 趋势候选驻留应跨刷新周期生效\n";
+    std::unordered_set<std::string> intent_ids;
+    std::unordered_set<std::string> fill_ids;
+    std::vector<ai_trade::FillEvent> fills;
+    if (!wal.LoadState(&intent_ids, &fill_ids, &fills, &error) ||
+        intent_ids.size() != 4U || fill_ids.count("seg-fill-1") != 1U ||
+        fills.size() != 1U || !NearlyEqual(fills[0].fee, 0.05)) {
+      std::cerr << "压实后恢复结果应与压实前一致: " << error << "\n";
       return 1;
     }
-    if (selector.RecordWarmupTrendCandidate("NEWUSDT", 0.5)) {
-      std::cerr << "低于 warmup 趋势保留门槛时不应 pin Universe\n";
+    // 无待压实段时为空操作，且可重复调用。
+    if (!wal.Compact(&error)) {
+      std::cerr << "空压实应为无操作且成功: " << error << "\n";
       return 1;
     }
+
+    std::filesystem::remove_all(wal_dir, ec);
   }
 
   {
-    ai_trade::UniverseConfig config;
-    config.enabled = true;
-    config.update_interval_ticks = 2;
-    config.max_active_symbols = 1;
-    config.min_active_symbols = 1;
-    config.min_turnover_usd = 1000.0;
-    config.reset_stats_on_refresh = true;
-    config.fallback_symbols = {"BTCUSDT"};
-    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT"};
+    ai_trade::RiskEngine risk(/*max_abs_notional_usd=*/500.0);
+    const ai_trade::TargetPosition target{"BTCUSDT", 500.0};
 
-    ai_trade::UniverseSelector selector(config, "BTCUSDT");
-    auto update = selector.OnMarket(
-        ai_trade::MarketEvent{1, "CHOPUSDT", 100.0, 100.0, 20.0});
-    if (update.has_value()) {
-      std::cerr << "Universe reset_stats_on_refresh 测试首个 tick 不应刷新\n";
+    const auto normal = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.01);
+    if (normal.risk_mode != ai_trade::RiskMode::kNormal ||
+        normal.reduce_only ||
+        !NearlyEqual(normal.adjusted_notional_usd, 500.0)) {
+      std::cerr << "风控 NORMAL 模式结果不符合预期\n";
       return 1;
     }
-    update = selector.OnMarket(
-        ai_trade::MarketEvent{2, "CHOPUSDT", 102.0, 102.0, 20.0});
-    if (!update.has_value() || !selector.IsActive("CHOPUSDT")) {
-      std::cerr << "Universe 第一窗口应选出 CHOPUSDT\n";
+
+    const auto degraded = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.09);
+    if (degraded.risk_mode != ai_trade::RiskMode::kDegraded ||
+        degraded.reduce_only ||
+        !NearlyEqual(degraded.adjusted_notional_usd, 250.0)) {
+      std::cerr << "风控 DEGRADED 模式结果不符合预期\n";
       return 1;
     }
 
-    update = selector.OnMarket(
-        ai_trade::MarketEvent{3, "TRENDUSDT", 100.0, 100.0, 20.0});
-    if (update.has_value()) {
-      std::cerr << "Universe 第二窗口首个 tick 不应提前刷新\n";
+    const auto cooldown = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.13);
+    if (cooldown.risk_mode != ai_trade::RiskMode::kCooldown ||
+        !cooldown.reduce_only ||
+        !NearlyEqual(cooldown.adjusted_notional_usd, 0.0)) {
+      std::cerr << "风控 COOLDOWN 模式结果不符合预期\n";
       return 1;
     }
-    update = selector.OnMarket(
-        ai_trade::MarketEvent{4, "TRENDUSDT", 101.0, 101.0, 20.0});
-    if (!update.has_value() || !selector.IsActive("TRENDUSDT")) {
-      std::cerr << "Universe reset_stats_on_refresh 后应根据新窗口重选币对\n";
+
+    const auto fuse = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.21);
+    if (fuse.risk_mode != ai_trade::RiskMode::kFuse ||
+        !fuse.reduce_only ||
+        !NearlyEqual(fuse.adjusted_notional_usd, 0.0)) {
+      std::cerr << "风控 FUSE 模式结果不符合预期\n";
       return 1;
     }
-  }
 
-  {
-    ai_trade::MockExchangeAdapter adapter({100.0, 101.0});
-    if (!adapter.Connect()) {
-      std::cerr << "mock 连接失败\n";
+    risk.SetForcedReduceOnly(true);
+    const auto forced = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.0);
+    if (forced.risk_mode != ai_trade::RiskMode::kReduceOnly ||
+        !forced.reduce_only) {
+      std::cerr << "风控强制 reduce-only 模式不符合预期\n";
       return 1;
     }
-    ai_trade::MarketEvent event;
-    if (!adapter.PollMarket(&event)) {
-      std::cerr << "mock 行情拉取失败\n";
+  }
+
+  {
+    ai_trade::RiskThresholds thresholds;
+    thresholds.degraded_drawdown = 0.08;
+    thresholds.degraded_recover_drawdown = 0.06;
+    thresholds.cooldown_drawdown = 0.12;
+    thresholds.cooldown_recover_drawdown = 0.10;
+    thresholds.fuse_drawdown = 0.20;
+    thresholds.fuse_recover_drawdown = 0.16;
+    ai_trade::RiskEngine risk(/*max_abs_notional_usd=*/500.0, thresholds);
+    const ai_trade::TargetPosition target{"BTCUSDT", 500.0};
+
+    const auto degraded_enter = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.081);
+    if (degraded_enter.risk_mode != ai_trade::RiskMode::kDegraded) {
+      std::cerr << "风控滞回：degraded 进入失败\n";
       return 1;
     }
-
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "remote-notional-order";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 2.0;
-    intent.price = 100.0;
-    if (!adapter.SubmitOrder(intent)) {
-      std::cerr << "mock 下单失败\n";
+    const auto degraded_hold = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.079);
+    if (degraded_hold.risk_mode != ai_trade::RiskMode::kDegraded) {
+      std::cerr << "风控滞回：degraded 保持失败\n";
+      return 1;
+    }
+    const auto degraded_exit = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.059);
+    if (degraded_exit.risk_mode != ai_trade::RiskMode::kNormal) {
+      std::cerr << "风控滞回：degraded 恢复失败\n";
       return 1;
     }
 
-    ai_trade::FillEvent fill;
-    while (adapter.PollFill(&fill)) {
+    const auto fuse_enter = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.21);
+    if (fuse_enter.risk_mode != ai_trade::RiskMode::kFuse) {
+      std::cerr << "风控滞回：fuse 进入失败\n";
+      return 1;
     }
-    double remote_notional = 0.0;
-    if (!adapter.GetRemoteNotionalUsd(&remote_notional)) {
-      std::cerr << "mock 远端仓位读取失败\n";
+    const auto fuse_hold = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.17);
+    if (fuse_hold.risk_mode != ai_trade::RiskMode::kFuse) {
+      std::cerr << "风控滞回：fuse 保持失败\n";
       return 1;
     }
-    if (!NearlyEqual(remote_notional, 200.0)) {
-      std::cerr << "mock 远端名义仓位不符合预期，实际 "
-                << remote_notional << "\n";
+    const auto fuse_release = risk.Apply(target, /*trade_ok=*/true, /*dd=*/0.15);
+    if (fuse_release.risk_mode != ai_trade::RiskMode::kCooldown) {
+      std::cerr << "风控滞回：fuse 释放到 cooldown 失败\n";
       return 1;
     }
+  }
 
-    ai_trade::ExchangeAccountSnapshot snapshot;
-    if (!adapter.GetAccountSnapshot(&snapshot)) {
-      std::cerr << "mock 账户快照读取失败\n";
+  {
+    ai_trade::OrderManager oms;
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "oms-order-1";
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 10.0;
+    intent.price = 100.0;
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    if (!oms.RegisterIntent(intent)) {
+      std::cerr << "OMS 注册订单失败\n";
       return 1;
     }
-    if (snapshot.account_mode != ai_trade::AccountMode::kUnified ||
-        snapshot.margin_mode != ai_trade::MarginMode::kIsolated ||
-        snapshot.position_mode != ai_trade::PositionMode::kOneWay) {
-      std::cerr << "mock 账户快照模式不符合预期\n";
+    if (!oms.HasPendingNetPositionOrders() ||
+        oms.PendingNetPositionOrderCount() != 1) {
+      std::cerr << "OMS 在途净仓位订单计数不符合预期\n";
       return 1;
     }
-
-    ai_trade::SymbolInfo symbol_info;
-    if (!adapter.GetSymbolInfo("BTCUSDT", &symbol_info) ||
-        !symbol_info.tradable ||
-        symbol_info.qty_step <= 0.0 ||
-        symbol_info.price_tick <= 0.0) {
-      std::cerr << "mock SymbolInfo 读取不符合预期\n";
+    if (!oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", 1) ||
+        oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", -1) ||
+        oms.HasPendingNetPositionOrderForSymbolDirection("ETHUSDT", 1)) {
+      std::cerr << "OMS 同向在途净仓位判定不符合预期\n";
       return 1;
     }
-
-    std::vector<ai_trade::RemotePositionSnapshot> remote_positions;
-    if (!adapter.GetRemotePositions(&remote_positions) ||
-        remote_positions.size() != 1U ||
-        remote_positions.front().symbol != "BTCUSDT" ||
-        !NearlyEqual(remote_positions.front().qty, 2.0)) {
-      std::cerr << "mock 远端持仓快照读取不符合预期\n";
+    if (!oms.HasPendingNetPositionOrderForSymbol("BTCUSDT") ||
+        oms.HasPendingNetPositionOrderForSymbol("ETHUSDT")) {
+      std::cerr << "OMS 按 symbol 在途净仓位判定不符合预期\n";
       return 1;
     }
+    oms.MarkSent(intent.client_order_id);
 
-    ai_trade::RemoteAccountBalanceSnapshot balance;
-    if (!adapter.GetRemoteAccountBalance(&balance) ||
-        !balance.has_equity ||
-        !balance.has_wallet_balance ||
-        !NearlyEqual(balance.equity_usd, 10000.0)) {
-      std::cerr << "mock 远端资金快照读取不符合预期\n";
+    ai_trade::FillEvent partial;
+    partial.fill_id = "fill-a";
+    partial.client_order_id = intent.client_order_id;
+    partial.symbol = intent.symbol;
+    partial.direction = 1;
+    partial.qty = 4.0;
+    partial.price = 100.0;
+    oms.OnFill(partial);
+    const auto* r1 = oms.Find(intent.client_order_id);
+    if (r1 == nullptr || r1->state != ai_trade::OrderState::kPartial) {
+      std::cerr << "OMS partial 状态不符合预期\n";
       return 1;
     }
 
-    std::unordered_set<std::string> open_order_ids;
-    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids)) {
-      std::cerr << "mock 远端活动订单读取失败\n";
+    ai_trade::FillEvent rest = partial;
+    rest.fill_id = "fill-b";
+    rest.qty = 6.0;
+    oms.OnFill(rest);
+    const auto* r2 = oms.Find(intent.client_order_id);
+    if (r2 == nullptr || r2->state != ai_trade::OrderState::kFilled) {
+      std::cerr << "OMS filled 状态不符合预期\n";
       return 1;
     }
-    if (!open_order_ids.empty()) {
-      std::cerr << "mock 无挂单时活动订单集合应为空\n";
+    if (oms.HasPendingNetPositionOrders() ||
+        oms.PendingNetPositionOrderCount() != 0) {
+      std::cerr << "OMS 终态后在途净仓位订单应为 0\n";
+      return 1;
+    }
+    if (oms.HasPendingNetPositionOrderForSymbolDirection("BTCUSDT", 1)) {
+      std::cerr << "OMS 终态后不应存在同向在途净仓位订单\n";
+      return 1;
+    }
+    if (oms.HasPendingNetPositionOrderForSymbol("BTCUSDT")) {
+      std::cerr << "OMS 终态后不应存在同 symbol 在途净仓位订单\n";
       return 1;
     }
   }
 
   {
-    ai_trade::MockExchangeAdapter adapter({100.0});
-    if (!adapter.Connect()) {
-      std::cerr << "mock 连接失败\n";
+    ai_trade::OrderManager oms;
+    ai_trade::OrderIntent sl_intent;
+    sl_intent.client_order_id = "oms-sl-1";
+    sl_intent.symbol = "BTCUSDT";
+    sl_intent.direction = -1;
+    sl_intent.qty = 1.0;
+    sl_intent.price = 90.0;
+    sl_intent.reduce_only = true;
+    sl_intent.purpose = ai_trade::OrderPurpose::kSl;
+    if (!oms.RegisterIntent(sl_intent)) {
+      std::cerr << "OMS 注册保护单失败\n";
       return 1;
     }
-    ai_trade::MarketEvent event;
-    adapter.PollMarket(&event);
+    oms.MarkSent(sl_intent.client_order_id);
+    if (oms.HasPendingNetPositionOrders() ||
+        oms.PendingNetPositionOrderCount() != 0) {
+      std::cerr << "保护单不应计入净仓位在途订单\n";
+      return 1;
+    }
+  }
 
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "cancel-order";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 2.0;
-    intent.price = 100.0;
-    if (!adapter.SubmitOrder(intent)) {
-      std::cerr << "mock 下单失败\n";
+  {
+    // OMS 二级索引：parent_id 保护单索引、终态/复活迁移与超时截止堆。
+    ai_trade::OrderManager oms;
+    ai_trade::OrderIntent sl_intent;
+    sl_intent.client_order_id = "idx-sl-1";
+    sl_intent.symbol = "BTCUSDT";
+    sl_intent.direction = -1;
+    sl_intent.qty = 1.0;
+    sl_intent.price = 90.0;
+    sl_intent.reduce_only = true;
+    sl_intent.purpose = ai_trade::OrderPurpose::kSl;
+    sl_intent.parent_order_id = "idx-parent-1";
+    ai_trade::OrderIntent tp_intent = sl_intent;
+    tp_intent.client_order_id = "idx-tp-1";
+    tp_intent.price = 120.0;
+    tp_intent.purpose = ai_trade::OrderPurpose::kTp;
+    if (!oms.RegisterIntent(sl_intent) || !oms.RegisterIntent(tp_intent)) {
+      std::cerr << "OMS 保护单族注册失败\n";
       return 1;
     }
-    if (!adapter.CancelOrder(intent.client_order_id)) {
-      std::cerr << "mock 撤单失败\n";
+    if (!oms.HasOpenProtection("idx-parent-1") ||
+        oms.HasOpenProtection("idx-parent-other")) {
+      std::cerr << "OMS parent_id 保护单索引判定不符合预期\n";
       return 1;
     }
-    std::unordered_set<std::string> open_order_ids;
-    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids)) {
-      std::cerr << "mock 撤单后活动订单读取失败\n";
+    const auto sibling = oms.FindOpenProtectiveSibling(
+        "idx-parent-1", ai_trade::OrderPurpose::kSl);
+    if (!sibling.has_value() || *sibling != "idx-tp-1") {
+      std::cerr << "OMS 保护单兄弟查找不符合预期\n";
       return 1;
     }
-    if (!open_order_ids.empty()) {
-      std::cerr << "mock 撤单后活动订单集合应为空\n";
+    oms.MarkCancelled("idx-tp-1");
+    if (oms.FindOpenProtectiveSibling("idx-parent-1",
+                                      ai_trade::OrderPurpose::kSl)
+            .has_value()) {
+      std::cerr << "OMS 终态保护单不应再被索引命中\n";
       return 1;
     }
-    ai_trade::FillEvent fill;
-    if (adapter.PollFill(&fill)) {
-      std::cerr << "撤单后不应再有成交\n";
+    oms.MarkCancelled("idx-sl-1");
+    if (oms.HasOpenProtection("idx-parent-1")) {
+      std::cerr << "OMS 保护单全部终态后索引应为空\n";
       return 1;
     }
-  }
 
-  {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+    ai_trade::OrderIntent entry;
+    entry.client_order_id = "idx-entry-1";
+    entry.symbol = "ETHUSDT";
+    entry.direction = 1;
+    entry.qty = 2.0;
+    entry.price = 2000.0;
+    entry.purpose = ai_trade::OrderPurpose::kEntry;
+    oms.RegisterIntent(entry);
+    oms.MarkSent(entry.client_order_id);
+    oms.SchedulePendingDeadline(entry.client_order_id, /*deadline_ms=*/1000);
 
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "POST",
-        "/v5/order/cancel",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":110001,"retMsg":"order not exists or too late to cancel"})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/order/realtime",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","orderLinkId":"cid-open-1","orderStatus":"New","leavesQty":"1"},{"symbol":"BTCUSDT","orderLinkId":"cid-zero-leaves-1","orderStatus":"New","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"cid-filled-1","orderStatus":"Filled","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"cid-cancelled-1","orderStatus":"Cancelled","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"","orderStatus":"New","leavesQty":"1"}]}})",
-            .error = "",
-        });
+    // 撤单后索引移除；到期条目应被惰性丢弃而非返回。
+    oms.MarkCancelled(entry.client_order_id);
+    if (oms.HasPendingNetPositionOrderForSymbol("ETHUSDT") ||
+        !oms.TakeExpiredPendingNetPositionOrders(/*now_ms=*/2000).empty()) {
+      std::cerr << "OMS 撤单后索引/截止堆未按预期清理\n";
+      return 1;
+    }
 
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
+    // Cancelled 订单的 late partial fill 回到 Partial，需重新进入在途索引。
+    ai_trade::FillEvent late_fill;
+    late_fill.fill_id = "idx-late-fill";
+    late_fill.client_order_id = entry.client_order_id;
+    late_fill.symbol = entry.symbol;
+    late_fill.direction = 1;
+    late_fill.qty = 0.5;
+    late_fill.price = 2000.0;
+    oms.OnFill(late_fill);
+    if (!oms.HasPendingNetPositionOrderForSymbol("ETHUSDT") ||
+        oms.PendingNetPositionOrderCount() != 1 ||
+        !NearlyEqual(oms.PendingNetPositionRemainingQtyForSymbol("ETHUSDT"),
+                     1.5, 1e-9)) {
+      std::cerr << "OMS late fill 复活后索引不符合预期\n";
+      return 1;
+    }
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（撤单幂等测试）\n";
+    // 重新登记截止时间：未到期不弹出，到期后弹出且堆被清空。
+    oms.SchedulePendingDeadline(entry.client_order_id, /*deadline_ms=*/3000);
+    if (!oms.TakeExpiredPendingNetPositionOrders(/*now_ms=*/2500).empty()) {
+      std::cerr << "OMS 未到期订单不应被弹出\n";
       return 1;
     }
-    if (!adapter.CancelOrder("cid-stale-1")) {
-      std::cerr << "Bybit 110001 撤单应按幂等成功处理\n";
-      return 1;
-    }
-    std::unordered_set<std::string> open_order_ids;
-    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids) ||
-        open_order_ids.find("cid-open-1") == open_order_ids.end() ||
-        open_order_ids.find("cid-zero-leaves-1") != open_order_ids.end() ||
-        open_order_ids.find("cid-filled-1") != open_order_ids.end() ||
-        open_order_ids.find("cid-cancelled-1") != open_order_ids.end()) {
-      std::cerr << "Bybit 活动订单集合读取不符合预期\n";
+    const auto expired = oms.TakeExpiredPendingNetPositionOrders(3000);
+    if (expired.size() != 1 || expired.front() != entry.client_order_id ||
+        !oms.TakeExpiredPendingNetPositionOrders(4000).empty()) {
+      std::cerr << "OMS 到期订单弹出结果不符合预期\n";
       return 1;
     }
   }
 
   {
-    ai_trade::BybitPrivateStreamOptions ws_options;
-    ws_options.enabled = false;
-    ws_options.api_key = "k";
-    ws_options.api_secret = "s";
-    ai_trade::BybitPrivateStream stream(std::move(ws_options));
-    std::string error;
-    if (stream.Connect(&error)) {
-      std::cerr << "禁用 private ws 时不应连接成功\n";
-      return 1;
-    }
-    if (stream.Healthy()) {
-      std::cerr << "禁用 private ws 时健康状态应为 false\n";
-      return 1;
-    }
-    if (error.empty()) {
-      std::cerr << "禁用 private ws 时应返回错误原因\n";
+    ai_trade::OrderManager oms;
+    oms.SeedNetPositionBaseline({
+        ai_trade::RemotePositionSnapshot{
+            .symbol = "BTCUSDT",
+            .qty = -0.02,
+            .avg_entry_price = 70000.0,
+            .mark_price = 70000.0,
+        },
+        ai_trade::RemotePositionSnapshot{
+            .symbol = "ETHUSDT",
+            .qty = 0.30,
+            .avg_entry_price = 2000.0,
+            .mark_price = 2000.0,
+        },
+    });
+    if (!NearlyEqual(oms.net_filled_qty("BTCUSDT"), -0.02, 1e-9) ||
+        !NearlyEqual(oms.net_filled_qty("ETHUSDT"), 0.30, 1e-9) ||
+        !NearlyEqual(oms.net_filled_qty(), 0.28, 1e-9)) {
+      std::cerr << "OMS 远端基线注入后净仓位不符合预期\n";
       return 1;
     }
   }
 
   {
-    ai_trade::BybitPrivateStreamOptions ws_options;
-    ws_options.enabled = true;
-    ws_options.testnet = true;
-    ws_options.api_key = "k";
-    ws_options.api_secret = "s";
-    ws_options.ack_timeout_ms = 1000;
+    ai_trade::OrderManager oms;
+    ai_trade::AccountState account;
+    ai_trade::Reconciler reconciler(/*tolerance_notional_usd=*/1.0);
 
-    std::vector<ScriptedWsStep> script = {
-        {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
-        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-        {ScriptedWsAction::kText, "{", ""},
-        {ScriptedWsAction::kText,
-         R"({"topic":"execution","data":[{"execId":"exec-1","orderLinkId":"cid-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":true},{"execId":"exec-2","orderLinkId":"","orderId":"oid-2","symbol":"ETHUSDT","side":"Sell","execQty":"2","execPrice":"101","execFee":"0.02","isMaker":false},{"execId":"exec-1","orderLinkId":"cid-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":true}]})",
-         ""},
-        {ScriptedWsAction::kClosed, "", "peer closed"},
-    };
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "rec-order";
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 1.0;
+    intent.price = 100.0;
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    oms.RegisterIntent(intent);
+    oms.MarkSent(intent.client_order_id);
 
-    ai_trade::BybitPrivateStream stream(
-        ws_options,
-        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
-    std::string error;
-    if (!stream.Connect(&error)) {
-      std::cerr << "private ws 脚本连接失败: " << error << "\n";
+    account.OnMarket(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0});
+    ai_trade::FillEvent fill = ToFill(intent, "rec-fill-1");
+    oms.OnFill(fill);
+    account.ApplyFill(fill);
+    account.OnMarket(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0});
+
+    const auto ok = reconciler.Check(account, oms);
+    if (!ok.ok) {
+      std::cerr << "预期对账成功但失败\n";
       return 1;
     }
 
-    ai_trade::FillEvent fill;
-    if (stream.PollExecution(&fill)) {
-      std::cerr << "异常 JSON 包不应产生成交\n";
+    ai_trade::AccountState mismatch_account;
+    mismatch_account.OnMarket(ai_trade::MarketEvent{1, "BTCUSDT", 120.0, 120.0});
+    const auto mismatch = reconciler.Check(mismatch_account, oms);
+    if (mismatch.ok || mismatch.reason_code != "OMS_RECONCILE_MISMATCH") {
+      std::cerr << "预期对账异常未触发\n";
       return 1;
     }
-    if (!stream.PollExecution(&fill)) {
-      std::cerr << "有效 execution 消息应产生成交\n";
+
+    const std::vector<ai_trade::RemotePositionSnapshot> remote_positions = {
+        ai_trade::RemotePositionSnapshot{
+            .symbol = "BTCUSDT",
+            .qty = 0.8,
+            .avg_entry_price = 100.0,
+            .mark_price = 101.0,
+        }};
+    const double remote_notional =
+        reconciler.ComputeRemoteNotionalUsd(remote_positions);
+    if (!NearlyEqual(remote_notional, 80.8)) {
+      std::cerr << "远端名义值计算不符合预期\n";
       return 1;
     }
-    if (fill.fill_id != "exec-1" || fill.client_order_id != "cid-1" ||
-        fill.direction != 1 || !NearlyEqual(fill.qty, 1.0) ||
-        fill.liquidity != ai_trade::FillLiquidity::kMaker) {
-      std::cerr << "private ws execution 解析结果不符合预期\n";
+
+    const auto report = reconciler.BuildSymbolDeltaReport(
+        account, remote_positions, std::vector<std::string>{"BTCUSDT"}, 0.5);
+    if (report.find("BTCUSDT") == std::string::npos ||
+        report.find("delta_notional") == std::string::npos) {
+      std::cerr << "symbol级对账差异报告不符合预期: " << report << "\n";
       return 1;
     }
-    if (!stream.PollExecution(&fill)) {
-      std::cerr << "空 orderLinkId 但有 orderId 的 execution 应产生成交\n";
+  }
+
+  {
+    // 远端活动订单纪元：归并差分只报告真实出现/消失的 id。
+    ai_trade::Reconciler reconciler(/*tolerance_notional_usd=*/1.0);
+    const auto first = reconciler.UpdateRemoteOpenOrders(
+        {"open-order-a", "open-order-b"});
+    if (first.appeared != 2 || first.disappeared != 0) {
+      std::cerr << "首轮远端活动集合差分不符合预期\n";
       return 1;
     }
-    if (fill.fill_id != "exec-2" || fill.client_order_id != "oid-2" ||
-        fill.symbol != "ETHUSDT" || fill.direction != -1 ||
-        !NearlyEqual(fill.qty, 2.0) ||
-        fill.liquidity != ai_trade::FillLiquidity::kTaker) {
-      std::cerr << "private ws execution 应在 orderLinkId 为空时 fallback 到 orderId\n";
+    if (!reconciler.RemoteOpenOrderEpochContains("open-order-a") ||
+        !reconciler.RemoteOpenOrderEpochContains("open-order-b") ||
+        reconciler.RemoteOpenOrderEpochContains("open-order-c")) {
+      std::cerr << "远端活动纪元成员资格判定不符合预期\n";
       return 1;
     }
-    if (stream.PollExecution(&fill)) {
-      std::cerr << "重复 execId 不应再次产生成交\n";
+
+    const auto unchanged = reconciler.UpdateRemoteOpenOrders(
+        {"open-order-a", "open-order-b"});
+    if (unchanged.changed()) {
+      std::cerr << "集合未变化时差分应为空\n";
       return 1;
     }
-    if (stream.Healthy()) {
-      std::cerr << "连接关闭后 private ws 应标记为不健康\n";
+
+    const auto moved = reconciler.UpdateRemoteOpenOrders(
+        {"open-order-b", "open-order-c"});
+    if (moved.appeared != 1 || moved.disappeared != 1) {
+      std::cerr << "集合变化差分计数不符合预期\n";
+      return 1;
+    }
+    if (reconciler.RemoteOpenOrderEpochContains("open-order-a") ||
+        !reconciler.RemoteOpenOrderEpochContains("open-order-c")) {
+      std::cerr << "纪元更新后成员资格不符合预期\n";
+      return 1;
+    }
+
+    const auto emptied = reconciler.UpdateRemoteOpenOrders({});
+    if (emptied.appeared != 0 || emptied.disappeared != 2 ||
+        reconciler.RemoteOpenOrderEpochContains("open-order-b")) {
+      std::cerr << "清空远端活动集合后纪元不符合预期\n";
       return 1;
     }
   }
 
   {
-    ai_trade::BybitPrivateStreamOptions ws_options;
-    ws_options.enabled = true;
-    ws_options.testnet = false;
-    ws_options.demo_trading = true;
-    ws_options.api_key = "k";
-    ws_options.api_secret = "s";
-    ws_options.ack_timeout_ms = 1000;
-
-    std::vector<ScriptedWsStep> script = {
-        {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
-        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-    };
+    ai_trade::AppConfig config;
+    ai_trade::BotApplication app(config);
+    app.market_tick_count_ = 100;
+    app.tracked_symbols_ = {"BTCUSDT"};
+    app.system_.SyncAccountFromRemotePositions(
+        std::vector<ai_trade::RemotePositionSnapshot>{
+            ai_trade::RemotePositionSnapshot{
+                .symbol = "BTCUSDT",
+                .qty = -0.01,
+                .avg_entry_price = 75620.0,
+                .mark_price = 75620.0,
+            }},
+        /*baseline_cash_usd=*/10000.0);
+    app.recent_fill_observations_.push_back(
+        ai_trade::BotApplication::RecentFillObservation{
+            .symbol = "BTCUSDT",
+            .signed_qty = -0.005,
+            .abs_notional_usd = 378.1,
+            .tick = 99,
+        });
+    std::string explanation;
+    const bool explained = app.RecentFillsExplainReconcileMismatch(
+        std::vector<ai_trade::RemotePositionSnapshot>{
+            ai_trade::RemotePositionSnapshot{
+                .symbol = "BTCUSDT",
+                .qty = -0.005,
+                .avg_entry_price = 75620.0,
+                .mark_price = 75620.0,
+            }},
+        &explanation);
+    if (!explained || explanation.find("BTCUSDT") == std::string::npos) {
+      std::cerr << "recent fill 应解释 symbol 级对账差异\n";
+      return 1;
+    }
 
-    ai_trade::BybitPrivateStream stream(
-        ws_options,
-        std::make_unique<ScriptedWebsocketClient>(
-            std::move(script),
-            true,
-            "",
-            "wss://stream-demo.bybit.com/v5/private"));
-    std::string error;
-    if (!stream.Connect(&error)) {
-      std::cerr << "demo private ws URL 连接失败: " << error << "\n";
+    app.market_tick_count_ = 108;
+    app.PruneRecentFillObservations(app.market_tick_count_);
+    explanation.clear();
+    const bool stale_explained = app.RecentFillsExplainReconcileMismatch(
+        std::vector<ai_trade::RemotePositionSnapshot>{
+            ai_trade::RemotePositionSnapshot{
+                .symbol = "BTCUSDT",
+                .qty = -0.005,
+                .avg_entry_price = 75620.0,
+                .mark_price = 75620.0,
+            }},
+        &explanation);
+    if (stale_explained) {
+      std::cerr << "过期 recent fill 不应继续豁免对账差异\n";
       return 1;
     }
   }
 
   {
-    ai_trade::BybitPublicStreamOptions ws_options;
-    ws_options.enabled = true;
-    ws_options.testnet = true;
-    ws_options.category = "linear";
-    ws_options.symbols = {"BTCUSDT"};
-    ws_options.ack_timeout_ms = 1000;
+    const std::filesystem::path data_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_fill_guard_test";
+    std::error_code ec;
+    std::filesystem::remove_all(data_dir, ec);
 
-    std::vector<ScriptedWsStep> script = {
-        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-        {ScriptedWsAction::kText, "{", ""},
-        {ScriptedWsAction::kText,
-         R"({"ts":1700000000100,"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"123.4","markPrice":"123.5","volume24h":"1000","fundingRate":"0.0004"}})",
-         ""},
-        {ScriptedWsAction::kText,
-         R"({"ts":1700000000300,"topic":"tickers.BTCUSDT","type":"delta","data":{"symbol":"BTCUSDT","lastPrice":"123.6","markPrice":"123.7","volume24h":"1002","fundingRate":"0.0004"}})",
-         ""},
-        {ScriptedWsAction::kText,
-         R"({"ts":1700000000500,"topic":"tickers.BTCUSDT","type":"delta","data":{"symbol":"BTCUSDT","lastPrice":"123.5","markPrice":"123.6","volume24h":"999","fundingRate":"0.0004"}})",
-         ""},
-    };
-    ai_trade::BybitPublicStream stream(
-        ws_options,
-        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    ai_trade::AppConfig config;
+    config.data_path = data_dir.string();
+    ai_trade::BotApplication app(config);
     std::string error;
-    if (!stream.Connect(&error)) {
-      std::cerr << "public ws 脚本连接失败: " << error << "\n";
+    if (!app.wal_.Initialize(&error)) {
+      std::cerr << "fill guard 测试 WAL 初始化失败: " << error << "\n";
       return 1;
     }
 
-    ai_trade::MarketEvent event;
-    if (stream.PollTicker(&event)) {
-      std::cerr << "异常 JSON 包不应产出行情\n";
-      return 1;
-    }
-    if (!stream.PollTicker(&event)) {
-      std::cerr << "有效 ticker 消息应产出行情\n";
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "guard-order";
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 1.0;
+    intent.price = 100.0;
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    if (!app.oms_.RegisterIntent(intent)) {
+      std::cerr << "fill guard 测试 OMS 注册失败\n";
       return 1;
     }
-    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 123.4) ||
-        !NearlyEqual(event.mark_price, 123.5) || event.ts_ms != 1700000000100LL ||
-        !NearlyEqual(event.volume, 0.0) || event.interval_ms != 0 ||
-        std::isfinite(event.funding_rate_per_interval)) {
-      std::cerr << "public ws ticker 解析结果不符合预期\n";
-      return 1;
-    }
-    if (!stream.PollTicker(&event)) {
-      std::cerr << "第二条 ticker 消息应产出行情\n";
-      return 1;
-    }
-    if (!NearlyEqual(event.price, 123.6) || !NearlyEqual(event.mark_price, 123.7) ||
-        event.interval_ms != 200 || !NearlyEqual(event.volume, 2.0)) {
-      std::cerr << "public ws ticker interval/volume 语义不符合预期\n";
+    app.oms_.MarkSent(intent.client_order_id);
+
+    ai_trade::FillEvent first_fill = ToFill(intent, "guard-fill-1");
+    app.ProcessFillEvent(first_fill);
+    if (!NearlyEqual(app.system_.account().position_qty("BTCUSDT"), 1.0) ||
+        !NearlyEqual(app.oms_.net_filled_qty("BTCUSDT"), 1.0) ||
+        app.fill_ids_.size() != 1U) {
+      std::cerr << "首笔 fill 应正常落地\n";
       return 1;
     }
-    constexpr double kExpectedFundingPerInterval =
-        0.0004 * (200.0 / (8.0 * 60.0 * 60.0 * 1000.0));
-    if (!NearlyEqual(event.funding_rate_per_interval, kExpectedFundingPerInterval,
-                     1e-12)) {
-      std::cerr << "public ws ticker funding_rate_per_interval 语义不符合预期\n";
+
+    ai_trade::FillEvent duplicate_semantic_fill = ToFill(intent, "guard-fill-2");
+    app.ProcessFillEvent(duplicate_semantic_fill);
+    const auto* record = app.oms_.Find(intent.client_order_id);
+    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
+        !NearlyEqual(record->filled_qty, 1.0) ||
+        !NearlyEqual(app.system_.account().position_qty("BTCUSDT"), 1.0) ||
+        !NearlyEqual(app.oms_.net_filled_qty("BTCUSDT"), 1.0) ||
+        app.fill_ids_.size() != 1U) {
+      std::cerr << "超出订单数量的重复语义 fill 应被拦截\n";
       return 1;
     }
-    if (!stream.PollTicker(&event)) {
-      std::cerr << "第三条 ticker 消息应产出行情\n";
+
+    std::unordered_set<std::string> intent_ids;
+    std::unordered_set<std::string> fill_ids;
+    std::vector<ai_trade::FillEvent> fills;
+    if (!app.wal_.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
+      std::cerr << "fill guard 测试 WAL 回放失败: " << error << "\n";
       return 1;
     }
-    constexpr double kExpectedRollingFallbackVolume =
-        999.0 * (200.0 / (24.0 * 60.0 * 60.0 * 1000.0));
-    if (!NearlyEqual(event.price, 123.5) || !NearlyEqual(event.mark_price, 123.6) ||
-        event.interval_ms != 200 ||
-        !NearlyEqual(event.volume, kExpectedRollingFallbackVolume, 1e-12)) {
-      std::cerr << "public ws ticker rolling volume 回退语义不符合预期\n";
+    if (fill_ids.size() != 1U || fills.size() != 1U ||
+        fill_ids.count("guard-fill-2") != 0U) {
+      std::cerr << "被拦截的重复 fill 不应写入 WAL\n";
       return 1;
     }
+
+    std::filesystem::remove_all(data_dir, ec);
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/execution/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"rest-exec-1","orderLinkId":"cid-rest-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","isMaker":"0"},{"execId":"rest-exec-1","orderLinkId":"cid-rest-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","isMaker":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/account/wallet-balance",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"accountType":"UNIFIED","totalEquity":"12345.6","totalWalletBalance":"12000.0","totalPerpUPL":"345.6"}]}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = true;
-    options.private_ws_rest_fallback = true;
-    options.execution_skip_history_on_start = false;
-    options.execution_poll_limit = 10;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
-    options.private_stream_factory =
-        [](ai_trade::BybitPrivateStreamOptions ws_options) {
-          std::vector<ScriptedWsStep> ws_script = {
-              {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
-              {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-              {ScriptedWsAction::kClosed, "", "ws down"},
-          };
-          return std::make_unique<ai_trade::BybitPrivateStream>(
-              std::move(ws_options),
-              std::make_unique<ScriptedWebsocketClient>(std::move(ws_script)));
-        };
+    const std::filesystem::path data_dir =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_unmapped_fill_guard_test";
+    std::error_code ec;
+    std::filesystem::remove_all(data_dir, ec);
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（private ws fallback 测试）\n";
+    ai_trade::AppConfig config;
+    config.data_path = data_dir.string();
+    ai_trade::BotApplication app(config);
+    std::string error;
+    if (!app.wal_.Initialize(&error)) {
+      std::cerr << "unmapped fill guard 测试 WAL 初始化失败: " << error
+                << "\n";
       return 1;
     }
 
     ai_trade::FillEvent fill;
-    if (!adapter.PollFill(&fill) && !adapter.PollFill(&fill)) {
-      std::cerr << "private ws 回退后应从 REST 获取成交\n";
+    fill.fill_id = "unmapped-empty-client-order";
+    fill.client_order_id = "";
+    fill.symbol = "BNBUSDT";
+    fill.direction = 1;
+    fill.qty = 0.59;
+    fill.price = 638.1;
+    fill.fee = 0.0375;
+    fill.liquidity = ai_trade::FillLiquidity::kTaker;
+    app.ProcessFillEvent(fill);
+    if (!NearlyEqual(app.system_.account().position_qty("BNBUSDT"), 0.0) ||
+        !NearlyEqual(app.oms_.net_filled_qty("BNBUSDT"), 0.0) ||
+        app.funnel_window_.fills_applied != 0 ||
+        app.pending_fills_for_evolution_ != 0 ||
+        app.fill_ids_.count(fill.fill_id) != 1U) {
+      std::cerr << "无法归因的空 client_order_id fill 不应污染本地账户/OMS/样本\n";
       return 1;
     }
-    if (fill.fill_id != "rest-exec-1" || fill.client_order_id != "cid-rest-1" ||
-        fill.direction != 1 || !NearlyEqual(fill.qty, 1.0) ||
-        fill.liquidity != ai_trade::FillLiquidity::kTaker) {
-      std::cerr << "private ws 回退 REST 成交解析不符合预期\n";
+
+    std::unordered_set<std::string> intent_ids;
+    std::unordered_set<std::string> fill_ids;
+    std::vector<ai_trade::FillEvent> fills;
+    if (!app.wal_.LoadState(&intent_ids, &fill_ids, &fills, &error)) {
+      std::cerr << "unmapped fill guard 测试 WAL 回放失败: " << error << "\n";
       return 1;
     }
-    if (adapter.PollFill(&fill)) {
-      std::cerr << "重复 REST execId 不应重复产生成交\n";
+    if (!fill_ids.empty() || !fills.empty()) {
+      std::cerr << "无法归因的 fill 不应写入 WAL 成为可回放策略成交\n";
       return 1;
     }
-    if (!adapter.TradeOk()) {
-      std::cerr << "private ws 回退后 trade_ok 预期应为 true\n";
+
+    std::filesystem::remove_all(data_dir, ec);
+  }
+
+  {
+    const std::filesystem::path data_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_cancelled_late_fill_test";
+    std::error_code ec;
+    std::filesystem::remove_all(data_dir, ec);
+
+    ai_trade::AppConfig config;
+    config.data_path = data_dir.string();
+    ai_trade::BotApplication app(config);
+    std::string error;
+    if (!app.wal_.Initialize(&error)) {
+      std::cerr << "cancelled late fill 测试 WAL 初始化失败: " << error << "\n";
       return 1;
     }
 
-    ai_trade::RemoteAccountBalanceSnapshot balance;
-    if (!adapter.GetRemoteAccountBalance(&balance) ||
-        !balance.has_equity ||
-        !balance.has_wallet_balance ||
-        !balance.has_unrealized_pnl ||
-        !NearlyEqual(balance.equity_usd, 12345.6, 1e-9) ||
-        !NearlyEqual(balance.wallet_balance_usd, 12000.0, 1e-9) ||
-        !NearlyEqual(balance.unrealized_pnl_usd, 345.6, 1e-9)) {
-      std::cerr << "bybit 远端资金快照解析不符合预期\n";
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "cancelled-late-fill";
+    intent.symbol = "SOLUSDT";
+    intent.direction = -1;
+    intent.qty = 4.4;
+    intent.price = 85.0;
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    if (!app.oms_.RegisterIntent(intent)) {
+      std::cerr << "cancelled late fill 测试 OMS 注册失败\n";
+      return 1;
+    }
+    app.oms_.MarkSent(intent.client_order_id);
+    app.oms_.MarkCancelled(intent.client_order_id);
+
+    ai_trade::FillEvent fill = ToFill(intent, "cancelled-late-fill-1");
+    app.ProcessFillEvent(fill);
+    const auto* record = app.oms_.Find(intent.client_order_id);
+    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
+        !NearlyEqual(record->filled_qty, 4.4) ||
+        !NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
+        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
+        app.fill_ids_.size() != 1U) {
+      std::cerr << "cancelled late fill 应合法落地一次并补齐 OMS 状态\n";
       return 1;
     }
+
+    std::filesystem::remove_all(data_dir, ec);
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+    const std::filesystem::path data_dir =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_account_reflected_fill_test";
+    std::error_code ec;
+    std::filesystem::remove_all(data_dir, ec);
 
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/execution/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[]}})",
-            .error = "",
-        });
+    ai_trade::AppConfig config;
+    config.data_path = data_dir.string();
+    ai_trade::BotApplication app(config);
+    std::string error;
+    if (!app.wal_.Initialize(&error)) {
+      std::cerr << "account reflected fill 测试 WAL 初始化失败: " << error << "\n";
+      return 1;
+    }
 
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = true;
-    options.private_ws_rest_fallback = true;
-    options.ws_reconnect_interval_ms = 0;
-    options.execution_skip_history_on_start = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
-    options.private_stream_factory =
-        [](ai_trade::BybitPrivateStreamOptions ws_options) {
-          std::vector<std::vector<ScriptedWsStep>> sessions = {
-              {
-                  {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
-                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-                  {ScriptedWsAction::kClosed, "", "ws down once"},
-              },
-              {
-                  {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
-                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-                  {ScriptedWsAction::kText,
-                   R"({"topic":"execution","data":[{"execId":"ws-recovered-exec-1","orderLinkId":"cid-ws-recovered-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01"}]})",
-                   ""},
-              },
-          };
-          return std::make_unique<ai_trade::BybitPrivateStream>(
-              std::move(ws_options),
-              std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
-        };
-
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（private ws 自动重连测试）\n";
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "account-reflected-fill";
+    intent.symbol = "SOLUSDT";
+    intent.direction = -1;
+    intent.qty = 4.4;
+    intent.price = 85.0;
+    intent.purpose = ai_trade::OrderPurpose::kEntry;
+    if (!app.oms_.RegisterIntent(intent)) {
+      std::cerr << "account reflected fill 测试 OMS 注册失败\n";
       return 1;
     }
+    app.oms_.MarkSent(intent.client_order_id);
+    app.oms_.MarkCancelled(intent.client_order_id);
+    app.system_.SyncAccountFromRemotePositions(
+        {ai_trade::RemotePositionSnapshot{
+             .symbol = "SOLUSDT",
+             .qty = -4.4,
+             .avg_entry_price = 85.0,
+             .mark_price = 85.0,
+         }},
+        10000.0);
 
-    ai_trade::FillEvent fill;
-    if (!adapter.PollFill(&fill)) {
-      std::cerr << "private ws 断线后应重连并恢复成交读取\n";
-      return 1;
-    }
-    if (fill.fill_id != "ws-recovered-exec-1" ||
-        fill.client_order_id != "cid-ws-recovered-1") {
-      std::cerr << "private ws 重连恢复后的成交解析不符合预期\n";
+    ai_trade::FillEvent fill = ToFill(intent, "account-reflected-fill-1");
+    app.ProcessFillEvent(fill);
+    const auto* record = app.oms_.Find(intent.client_order_id);
+    if (record == nullptr || record->state != ai_trade::OrderState::kFilled ||
+        !NearlyEqual(record->filled_qty, 4.4) ||
+        !NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
+        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
+        app.fill_ids_.size() != 1U) {
+      std::cerr << "已由账户同步反映的 late fill 不应再次扩大本地仓位\n";
       return 1;
     }
-    const std::string health = adapter.ChannelHealthSummary();
-    if (health.find("fill_channel=private_ws") == std::string::npos) {
-      std::cerr << "private ws 重连后通道状态应回到 private_ws，实际: "
-                << health << "\n";
+
+    ai_trade::FillEvent duplicate_fill = ToFill(intent, "account-reflected-fill-2");
+    app.ProcessFillEvent(duplicate_fill);
+    if (!NearlyEqual(app.system_.account().position_qty("SOLUSDT"), -4.4) ||
+        !NearlyEqual(app.oms_.net_filled_qty("SOLUSDT"), -4.4) ||
+        app.fill_ids_.size() != 1U) {
+      std::cerr << "已补齐订单数量后的 late fill 重复回报应被拦截\n";
       return 1;
     }
+
+    std::filesystem::remove_all(data_dir, ec);
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "POST",
-        "/v5/order/create",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"orderId":"oid-map-1","orderLinkId":"cid-map-1"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/execution/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"exec-map-1","orderId":"oid-map-1","orderLinkId":"","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":1}]}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.execution_skip_history_on_start = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
-
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（orderId 映射测试）\n";
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 2;
+    config.max_active_symbols = 2;
+    config.min_active_symbols = 1;
+    config.fallback_symbols = {"BTCUSDT"};
+    config.min_turnover_usd = 100000.0; // 设置成交额门槛
+    config.candidate_symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    if (selector.active_symbols().empty()) {
+      std::cerr << "Universe 初始 active_symbols 不应为空\n";
       return 1;
     }
 
-    ai_trade::OrderIntent intent;
-    intent.client_order_id = "cid-map-1";
-    intent.symbol = "BTCUSDT";
-    intent.direction = 1;
-    intent.qty = 1.0;
-    intent.price = 100.0;
-    if (!adapter.SubmitOrder(intent)) {
-      std::cerr << "orderId 映射测试下单失败\n";
+    const auto first = selector.OnMarket(ai_trade::MarketEvent{
+        1, "BTCUSDT", 100.0, 100.0, 2000.0}); // Turnover = 200,000 > 100,000
+    if (first.has_value()) {
+      std::cerr << "Universe 未到更新间隔不应刷新\n";
       return 1;
     }
-
-    ai_trade::FillEvent fill;
-    if (!adapter.PollFill(&fill)) {
-      std::cerr << "orderId 映射测试应获取到成交\n";
+    const auto second = selector.OnMarket(ai_trade::MarketEvent{
+        2, "ETHUSDT", 2000.0, 2000.0, 10.0}); // Turnover = 20,000 < 100,000
+    if (!second.has_value()) {
+      std::cerr << "Universe 到更新间隔应刷新\n";
       return 1;
     }
-    if (fill.client_order_id != intent.client_order_id ||
-        fill.fill_id != "exec-map-1" ||
-        fill.liquidity != ai_trade::FillLiquidity::kMaker) {
-      std::cerr << "orderId 映射为 client_order_id 失败\n";
+    if (second->active_symbols.empty() ||
+        static_cast<int>(second->active_symbols.size()) > config.max_active_symbols) {
+      std::cerr << "Universe 刷新后的 active_symbols 数量不符合预期\n";
+      return 1;
+    }
+    // ETHUSDT 成交额不足，应被过滤，仅剩 BTCUSDT (或 fallback)
+    if (selector.IsActive("ETHUSDT")) {
+      std::cerr << "Universe 应过滤低成交额币对\n";
+      return 1;
+    }
+    if (!selector.IsActive("BTCUSDT")) {
+      std::cerr << "Universe 应保留高成交额币对\n";
       return 1;
     }
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/execution/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"hist-exec-1","orderLinkId":"cid-hist-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","execTime":"1730000000000"}]}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.execution_skip_history_on_start = true;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 1;
+    config.max_active_symbols = 3;
+    config.min_active_symbols = 1;
+    config.fallback_symbols = {"BTCUSDT", "ETHUSDT"};
+    config.candidate_symbols = {"BTCUSDT", "ETHUSDT"};
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（execution 启动预热测试）\n";
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    selector.SetAllowedSymbols({"BTCUSDT"});
+    const auto update = selector.OnMarket(ai_trade::MarketEvent{
+        1, "ETHUSDT", 2000.0, 2000.0});
+    if (!update.has_value() || update->active_symbols.empty()) {
+      std::cerr << "Universe 允许集合过滤后应仍有活跃币对\n";
       return 1;
     }
-
-    ai_trade::FillEvent fill;
-    if (adapter.PollFill(&fill)) {
-      std::cerr << "启动预热后不应消费历史 execution 成交\n";
-      return 1;
+    for (const auto& symbol : update->active_symbols) {
+      if (symbol != "BTCUSDT") {
+        std::cerr << "Universe 允许集合过滤结果包含非允许symbol\n";
+        return 1;
+      }
     }
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/market/tickers",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lastPrice":"101.2","markPrice":"101.3","volume24h":"888","time":"1700000001000"}]}})",
-            .error = "",
-        });
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 1;
+    config.max_active_symbols = 2;
+    config.min_active_symbols = 2;
+    config.fallback_symbols = {"BTCUSDT", "ETHUSDT"};
+    config.candidate_symbols = {"SOLUSDT"};
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    const auto update = selector.OnMarket(ai_trade::MarketEvent{
+        1, "SOLUSDT", 80.0, 80.0});
+    if (!update.has_value()) {
+      std::cerr << "Universe 预期应触发刷新\n";
+      return 1;
+    }
+    if (!update->degraded_to_fallback || update->reason_code.empty()) {
+      std::cerr << "Universe 预期应触发 fallback 降级\n";
+      return 1;
+    }
+    if (update->active_symbols.size() != 2U) {
+      std::cerr << "Universe fallback 后活跃币对应满足最小数量\n";
+      return 1;
+    }
+  }
 
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = true;
-    options.public_ws_rest_fallback = true;
-    options.private_ws_enabled = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
-    options.public_stream_factory = [](ai_trade::BybitPublicStreamOptions ws_options) {
-      std::vector<ScriptedWsStep> ws_script = {
-          {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-          {ScriptedWsAction::kClosed, "", "ws down"},
-      };
-      return std::make_unique<ai_trade::BybitPublicStream>(
-          std::move(ws_options),
-          std::make_unique<ScriptedWebsocketClient>(std::move(ws_script)));
+  {
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 14;
+    config.max_active_symbols = 2;
+    config.min_active_symbols = 1;
+    config.min_turnover_usd = 1000.0;
+    config.trend_reserve_enabled = true;
+    config.trend_reserve_slots = 1;
+    config.fallback_symbols = {"BTCUSDT"};
+    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT", "QUIETUSDT"};
+
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    std::optional<ai_trade::UniverseUpdate> update;
+    const auto push = [&selector, &update](std::int64_t ts,
+                                           const std::string& symbol,
+                                           double price) {
+      update = selector.OnMarket(
+          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
     };
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（public ws fallback 测试）\n";
+    push(1, "TRENDUSDT", 100.0);
+    push(2, "QUIETUSDT", 100.0);
+    push(3, "CHOPUSDT", 100.0);
+    push(4, "CHOPUSDT", 102.0);
+    push(5, "CHOPUSDT", 100.0);
+    push(6, "CHOPUSDT", 102.0);
+    push(7, "CHOPUSDT", 100.0);
+    push(8, "CHOPUSDT", 102.0);
+    push(9, "CHOPUSDT", 100.0);
+    push(10, "CHOPUSDT", 102.0);
+    push(11, "CHOPUSDT", 100.0);
+    push(12, "TRENDUSDT", 101.0);
+    push(13, "TRENDUSDT", 102.0);
+    push(14, "QUIETUSDT", 100.01);
+
+    if (!update.has_value()) {
+      std::cerr << "Universe 趋势保留槽测试应触发刷新\n";
       return 1;
     }
-
-    ai_trade::MarketEvent event;
-    if (!adapter.PollMarket(&event) && !adapter.PollMarket(&event)) {
-      std::cerr << "public ws 回退后应从 REST 获取行情\n";
+    if (!selector.IsActive("CHOPUSDT")) {
+      std::cerr << "Universe 稳健槽应保留高活跃高波动币对\n";
       return 1;
     }
-    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 101.2) ||
-        !NearlyEqual(event.mark_price, 101.3) || event.ts_ms != 1700000001000LL ||
-        !NearlyEqual(event.volume, 0.0)) {
-      std::cerr << "public ws 回退 REST 行情解析不符合预期: symbol="
-                << event.symbol << ", price=" << event.price
-                << ", mark=" << event.mark_price << ", ts=" << event.ts_ms
-                << ", volume=" << event.volume << ", interval=" << event.interval_ms
-                << "\n";
+    if (!selector.IsActive("TRENDUSDT")) {
+      std::cerr << "Universe 趋势保留槽应补充持续单边币对\n";
       return 1;
     }
-    if (!adapter.TradeOk()) {
-      std::cerr << "public ws 回退后 trade_ok 预期应为 true\n";
+    if (selector.IsActive("QUIETUSDT")) {
+      std::cerr << "Universe 不应选入安静币对\n";
       return 1;
     }
   }
 
   {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/market/tickers",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lastPrice":"88.8","markPrice":"88.9"}]}})",
-            .error = "",
-        });
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 14;
+    config.max_active_symbols = 2;
+    config.min_active_symbols = 1;
+    config.min_turnover_usd = 1000.0;
+    config.trend_reserve_enabled = true;
+    config.trend_reserve_slots = 1;
+    config.trend_reserve_min_residency_refreshes = 2;
+    config.reset_stats_on_refresh = true;
+    config.fallback_symbols = {"BTCUSDT"};
+    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT", "QUIETUSDT", "NEWUSDT"};
 
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.primary_symbol = "BTCUSDT";
-    options.public_ws_enabled = true;
-    options.public_ws_rest_fallback = true;
-    options.private_ws_enabled = false;
-    options.ws_reconnect_interval_ms = 0;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    std::optional<ai_trade::UniverseUpdate> update;
+    const auto push = [&selector, &update](std::int64_t ts,
+                                           const std::string& symbol,
+                                           double price) {
+      update = selector.OnMarket(
+          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
     };
-    options.public_stream_factory =
-        [](ai_trade::BybitPublicStreamOptions ws_options) {
-          std::vector<std::vector<ScriptedWsStep>> sessions = {
-              {
-                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-                  {ScriptedWsAction::kClosed, "", "ws down once"},
-              },
-              {
-                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
-                  {ScriptedWsAction::kText,
-                   R"({"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"120.1","markPrice":"120.2"}})",
-                   ""},
-              },
-          };
-          return std::make_unique<ai_trade::BybitPublicStream>(
-              std::move(ws_options),
-              std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
-        };
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit adapter 连接失败（public ws 自动重连测试）\n";
+    push(1, "TRENDUSDT", 100.0);
+    push(2, "QUIETUSDT", 100.0);
+    push(3, "CHOPUSDT", 100.0);
+    push(4, "CHOPUSDT", 102.0);
+    push(5, "CHOPUSDT", 100.0);
+    push(6, "CHOPUSDT", 102.0);
+    push(7, "CHOPUSDT", 100.0);
+    push(8, "CHOPUSDT", 102.0);
+    push(9, "CHOPUSDT", 100.0);
+    push(10, "CHOPUSDT", 102.0);
+    push(11, "CHOPUSDT", 100.0);
+    push(12, "TRENDUSDT", 101.0);
+    push(13, "TRENDUSDT", 102.0);
+    push(14, "QUIETUSDT", 100.01);
+
+    if (!update.has_value() || !selector.IsActive("TRENDUSDT")) {
+      std::cerr << "Universe 趋势保留驻留首轮应选入趋势币对\n";
       return 1;
     }
 
-    ai_trade::MarketEvent event;
-    if (!adapter.PollMarket(&event)) {
-      std::cerr << "public ws 断线后应重连并恢复行情读取\n";
+    for (int i = 0; i < 14; ++i) {
+      push(15 + i, "NEWUSDT", 100.0 + static_cast<double>(i) * 2.0);
+    }
+    if (!update.has_value()) {
+      std::cerr << "Universe 趋势保留驻留第二轮应刷新\n";
       return 1;
     }
-    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 120.1) ||
-        !NearlyEqual(event.mark_price, 120.2)) {
-      std::cerr << "public ws 重连恢复后的行情解析不符合预期\n";
+    if (!selector.IsActive("TRENDUSDT")) {
+      std::cerr << "Universe 趋势保留驻留应避免趋势币对被立即轮换\n";
       return 1;
     }
-    const std::string health = adapter.ChannelHealthSummary();
-    if (health.find("market_channel=public_ws") == std::string::npos) {
-      std::cerr << "public ws 重连后通道状态应回到 public_ws，实际: "
-                << health << "\n";
+    if (std::find(update->sticky_trend_reserve_symbols.begin(),
+                  update->sticky_trend_reserve_symbols.end(),
+                  "TRENDUSDT") ==
+        update->sticky_trend_reserve_symbols.end()) {
+      std::cerr << "Universe 应上报 sticky trend reserve 币对\n";
       return 1;
     }
   }
 
   {
-    ScopedEnvVar testnet_key("AI_TRADE_BYBIT_TESTNET_API_KEY", "k-testnet");
-    ScopedEnvVar testnet_secret("AI_TRADE_BYBIT_TESTNET_API_SECRET", "s-testnet");
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "");
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 3;
+    config.max_active_symbols = 2;
+    config.min_active_symbols = 1;
+    config.min_turnover_usd = 1000.0;
+    config.trend_reserve_enabled = true;
+    config.trend_reserve_slots = 1;
+    config.trend_reserve_min_residency_refreshes = 2;
+    config.warmup_trend_reserve_min_ratio = 0.6;
+    config.reset_stats_on_refresh = true;
+    config.fallback_symbols = {"BTCUSDT"};
+    config.candidate_symbols = {"COREUSDT", "WARMUSDT", "NEWUSDT"};
 
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
-
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "Bybit testnet 专用环境变量连接失败\n";
-      return 1;
-    }
-  }
-
-  {
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
-
-    auto* transport = new MockBybitHttpTransport();
-    transport->AddRoute(
-        "GET",
-        "/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport->AddRoute(
-        "GET",
-        "/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-    transport->AddRoute(
-        "GET",
-        "/v5/market/instruments-info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lotSizeFilter":{"minOrderQty":"0.001","maxMktOrderQty":"100","qtyStep":"0.001","minNotionalValue":"5"},"priceFilter":{"tickSize":"0.1"}}]}})",
-            .error = "",
-        });
-    transport->AddRoute(
-        "POST",
-        "/v5/order/create",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"orderId":"oid-1"}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = true;
-    options.symbols = {"BTCUSDT"};
-    options.maker_entry_enabled = true;
-    options.maker_fallback_to_market = false;
-    options.maker_price_offset_bps = 1.0;
-    options.maker_post_only = true;
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.http_transport_factory = [transport]() {
-      return std::unique_ptr<ai_trade::BybitHttpTransport>(transport);
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    std::optional<ai_trade::UniverseUpdate> update;
+    const auto push = [&selector, &update](std::int64_t ts,
+                                           const std::string& symbol,
+                                           double price) {
+      update = selector.OnMarket(
+          ai_trade::MarketEvent{ts, symbol, price, price, 20.0});
     };
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "Bybit 交易规则量化测试连接失败\n";
+    push(1, "COREUSDT", 100.0);
+    push(2, "WARMUSDT", 100.0);
+    if (!selector.RecordWarmupTrendCandidate("WARMUSDT", 0.8)) {
+      std::cerr << "Universe warmup 趋势候选应进入趋势保留驻留队列\n";
       return 1;
     }
-
-    ai_trade::OrderIntent ok_intent;
-    ok_intent.client_order_id = "qty-ok-1";
-    ok_intent.symbol = "BTCUSDT";
-    ok_intent.direction = 1;
-    ok_intent.qty = 0.123456;
-    ok_intent.price = 100.0;
-    if (!adapter.SubmitOrder(ok_intent)) {
-      std::cerr << "Bybit 数量量化后订单应提交成功\n";
+    push(3, "NEWUSDT", 100.0);
+    if (!update.has_value() || !selector.IsActive("WARMUSDT")) {
+      std::cerr << "Universe warmup 趋势候选应在下一轮刷新中保留\n";
       return 1;
     }
-    if (transport->last_body().find("\"qty\":\"0.123\"") == std::string::npos) {
-      std::cerr << "Bybit 数量量化结果不符合预期，body=" << transport->last_body() << "\n";
+    if (std::find(update->sticky_trend_reserve_symbols.begin(),
+                  update->sticky_trend_reserve_symbols.end(),
+                  "WARMUSDT") ==
+        update->sticky_trend_reserve_symbols.end()) {
+      std::cerr << "Universe warmup 趋势候选应上报 sticky reserve\n";
       return 1;
     }
 
-    ai_trade::OrderIntent reduce_maker_intent;
-    reduce_maker_intent.client_order_id = "reduce-maker-1";
-    reduce_maker_intent.symbol = "BTCUSDT";
-    reduce_maker_intent.direction = -1;
-    reduce_maker_intent.qty = 0.1;
-    reduce_maker_intent.price = 100.0;
-    reduce_maker_intent.reduce_only = true;
-    reduce_maker_intent.purpose = ai_trade::OrderPurpose::kReduce;
-    reduce_maker_intent.liquidity_preference =
-        ai_trade::LiquidityPreference::kMaker;
-    if (!adapter.SubmitOrder(reduce_maker_intent)) {
-      std::cerr << "Bybit maker reduce-only 平仓单应提交成功\n";
-      return 1;
+    for (int i = 0; i < 3; ++i) {
+      push(4 + i, "NEWUSDT", 102.0 + static_cast<double>(i) * 3.0);
     }
-    const std::string& reduce_body = transport->last_body();
-    if (reduce_body.find("\"orderType\":\"Limit\"") == std::string::npos ||
-        reduce_body.find("\"timeInForce\":\"PostOnly\"") == std::string::npos ||
-        reduce_body.find("\"reduceOnly\":true") == std::string::npos) {
-      std::cerr << "Bybit maker reduce-only 应使用 PostOnly Limit，body="
-                << reduce_body << "\n";
+    if (!update.has_value() || !selector.IsActive("WARMUSDT")) {
+      std::cerr << "Universe warmup 趋势候选驻留应跨刷新周期生效\n";
       return 1;
     }
-
-    ai_trade::OrderIntent small_intent = ok_intent;
-    small_intent.client_order_id = "qty-small-1";
-    small_intent.qty = 0.0004;
-    if (adapter.SubmitOrder(small_intent)) {
-      std::cerr << "Bybit 小于最小下单数量的订单应被拒绝\n";
+    if (selector.RecordWarmupTrendCandidate("NEWUSDT", 0.5)) {
+      std::cerr << "低于 warmup 趋势保留门槛时不应 pin Universe\n";
       return 1;
     }
   }
 
   {
-    ScopedEnvVar demo_key("AI_TRADE_BYBIT_DEMO_API_KEY", "k-demo");
-    ScopedEnvVar demo_secret("AI_TRADE_BYBIT_DEMO_API_SECRET", "s-demo");
-    ScopedEnvVar api_key("AI_TRADE_API_KEY", "");
-    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "");
-
-    MockBybitHttpTransport transport;
-    transport.AddRoute(
-        "GET",
-        "https://api-demo.bybit.com/v5/account/info",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
-            .error = "",
-        });
-    transport.AddRoute(
-        "GET",
-        "https://api-demo.bybit.com/v5/position/list",
-        ai_trade::BybitHttpResponse{
-            .status_code = 200,
-            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
-            .error = "",
-        });
-
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "paper";
-    options.testnet = false;
-    options.demo_trading = true;
-    options.symbols = {"BTCUSDT"};
-    options.public_ws_enabled = false;
-    options.private_ws_enabled = false;
-    options.http_transport_factory = [transport]() {
-      return std::make_unique<MockBybitHttpTransport>(transport);
-    };
+    ai_trade::UniverseConfig config;
+    config.enabled = true;
+    config.update_interval_ticks = 2;
+    config.max_active_symbols = 1;
+    config.min_active_symbols = 1;
+    config.min_turnover_usd = 1000.0;
+    config.reset_stats_on_refresh = true;
+    config.fallback_symbols = {"BTCUSDT"};
+    config.candidate_symbols = {"CHOPUSDT", "TRENDUSDT"};
 
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "Bybit demo 专用环境变量连接失败\n";
+    ai_trade::UniverseSelector selector(config, "BTCUSDT");
+    auto update = selector.OnMarket(
+        ai_trade::MarketEvent{1, "CHOPUSDT", 100.0, 100.0, 20.0});
+    if (update.has_value()) {
+      std::cerr << "Universe reset_stats_on_refresh 测试首个 tick 不应刷新\n";
+      return 1;
+    }
+    update = selector.OnMarket(
+        ai_trade::MarketEvent{2, "CHOPUSDT", 102.0, 102.0, 20.0});
+    if (!update.has_value() || !selector.IsActive("CHOPUSDT")) {
+      std::cerr << "Universe 第一窗口应选出 CHOPUSDT\n";
       return 1;
     }
-  }
 
-  {
-    std::string signature;
-    std::string error;
-    const bool ok = ai_trade::BybitRestClient::BuildV5Signature(
-        "test-secret",
-        "1700000000000",
-        "test-key",
-        "5000",
-        "category=linear&symbol=BTCUSDT",
-        &signature,
-        &error);
-    if (!ok || signature.size() != 64) {
-      std::cerr << "Bybit V5 签名生成失败: " << error << "\n";
+    update = selector.OnMarket(
+        ai_trade::MarketEvent{3, "TRENDUSDT", 100.0, 100.0, 20.0});
+    if (update.has_value()) {
+      std::cerr << "Universe 第二窗口首个 tick 不应提前刷新\n";
       return 1;
     }
-    for (char ch : signature) {
-      if (std::isxdigit(static_cast<unsigned char>(ch)) == 0) {
-        std::cerr << "Bybit V5 签名格式不符合预期\n";
-        return 1;
-      }
+    update = selector.OnMarket(
+        ai_trade::MarketEvent{4, "TRENDUSDT", 101.0, 101.0, 20.0});
+    if (!update.has_value() || !selector.IsActive("TRENDUSDT")) {
+      std::cerr << "Universe reset_stats_on_refresh 后应根据新窗口重选币对\n";
+      return 1;
     }
   }
 
   {
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "replay";
-    options.allow_no_auth_in_replay = true;
-    options.symbols = {"BTCUSDT", "ETHUSDT"};
-    options.replay_prices = {100.0, 101.0, 102.0, 103.0};
-    options.replay_entry_fee_bps = 10.0;
-    options.replay_expected_slippage_bps = 5.0;
-    options.remote_account_mode = ai_trade::AccountMode::kUnified;
-    options.remote_margin_mode = ai_trade::MarginMode::kPortfolio;
-    options.remote_position_mode = ai_trade::PositionMode::kHedge;
-    ai_trade::BybitExchangeAdapter adapter(options);
+    ai_trade::MockExchangeAdapter adapter({100.0, 101.0});
     if (!adapter.Connect()) {
-      std::cerr << "bybit 回放占位连接失败\n";
+      std::cerr << "mock 连接失败\n";
       return 1;
     }
-
-    ai_trade::MarketEvent e1;
-    ai_trade::MarketEvent e2;
-    if (!adapter.PollMarket(&e1) || !adapter.PollMarket(&e2)) {
-      std::cerr << "bybit 回放行情拉取失败\n";
-      return 1;
-    }
-    if (e1.symbol == e2.symbol) {
-      std::cerr << "bybit 回放行情应支持多币种轮询\n";
+    ai_trade::MarketEvent event;
+    if (!adapter.PollMarket(&event)) {
+      std::cerr << "mock 行情拉取失败\n";
       return 1;
     }
 
     ai_trade::OrderIntent intent;
-    intent.client_order_id = "bybit-replay-order-1";
-    intent.symbol = e1.symbol;
+    intent.client_order_id = "remote-notional-order";
+    intent.symbol = "BTCUSDT";
     intent.direction = 1;
     intent.qty = 2.0;
-    intent.price = e1.price;
-    // maker_entry_enabled=false 时 live 会实际走 Market/Taker，replay 需同口径计费。
-    intent.liquidity_preference = ai_trade::LiquidityPreference::kMaker;
+    intent.price = 100.0;
     if (!adapter.SubmitOrder(intent)) {
-      std::cerr << "bybit 回放下单失败\n";
+      std::cerr << "mock 下单失败\n";
       return 1;
     }
+
     ai_trade::FillEvent fill;
-    int fill_count = 0;
-    double replay_fee = 0.0;
     while (adapter.PollFill(&fill)) {
-      ++fill_count;
-      replay_fee += fill.fee;
-      if (fill.liquidity != ai_trade::FillLiquidity::kTaker ||
-          !NearlyEqual(fill.price, 100.05, 1e-9)) {
-        std::cerr << "bybit 回放成交应带 taker 滑点和流动性标记\n";
-        return 1;
-      }
-    }
-    if (fill_count < 1) {
-      std::cerr << "bybit 回放预期至少一笔成交\n";
-      return 1;
-    }
-    if (!NearlyEqual(replay_fee, 0.2001, 1e-9)) {
-      std::cerr << "bybit 回放成交手续费不符合预期，实际 " << replay_fee
-                << "\n";
-      return 1;
     }
     double remote_notional = 0.0;
     if (!adapter.GetRemoteNotionalUsd(&remote_notional)) {
-      std::cerr << "bybit 回放远端仓位读取失败\n";
+      std::cerr << "mock 远端仓位读取失败\n";
       return 1;
     }
     if (!NearlyEqual(remote_notional, 200.0)) {
-      std::cerr << "bybit 回放远端名义仓位不符合预期，实际 "
+      std::cerr << "mock 远端名义仓位不符合预期，实际 "
                 << remote_notional << "\n";
       return 1;
     }
 
     ai_trade::ExchangeAccountSnapshot snapshot;
     if (!adapter.GetAccountSnapshot(&snapshot)) {
-      std::cerr << "bybit 账户快照读取失败\n";
+      std::cerr << "mock 账户快照读取失败\n";
       return 1;
     }
     if (snapshot.account_mode != ai_trade::AccountMode::kUnified ||
-        snapshot.margin_mode != ai_trade::MarginMode::kPortfolio ||
-        snapshot.position_mode != ai_trade::PositionMode::kHedge) {
-      std::cerr << "bybit 账户快照字段不符合预期\n";
+        snapshot.margin_mode != ai_trade::MarginMode::kIsolated ||
+        snapshot.position_mode != ai_trade::PositionMode::kOneWay) {
+      std::cerr << "mock 账户快照模式不符合预期\n";
+      return 1;
+    }
+
+    ai_trade::SymbolInfo symbol_info;
+    if (!adapter.GetSymbolInfo("BTCUSDT", &symbol_info) ||
+        !symbol_info.tradable ||
+        symbol_info.qty_step <= 0.0 ||
+        symbol_info.price_tick <= 0.0) {
+      std::cerr << "mock SymbolInfo 读取不符合预期\n";
+      return 1;
+    }
+
+    std::vector<ai_trade::RemotePositionSnapshot> remote_positions;
+    if (!adapter.GetRemotePositions(&remote_positions) ||
+        remote_positions.size() != 1U ||
+        remote_positions.front().symbol != "BTCUSDT" ||
+        !NearlyEqual(remote_positions.front().qty, 2.0)) {
+      std::cerr << "mock 远端持仓快照读取不符合预期\n";
+      return 1;
+    }
+
+    ai_trade::RemoteAccountBalanceSnapshot balance;
+    if (!adapter.GetRemoteAccountBalance(&balance) ||
+        !balance.has_equity ||
+        !balance.has_wallet_balance ||
+        !NearlyEqual(balance.equity_usd, 10000.0)) {
+      std::cerr << "mock 远端资金快照读取不符合预期\n";
+      return 1;
+    }
+
+    std::unordered_set<std::string> open_order_ids;
+    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids)) {
+      std::cerr << "mock 远端活动订单读取失败\n";
+      return 1;
+    }
+    if (!open_order_ids.empty()) {
+      std::cerr << "mock 无挂单时活动订单集合应为空\n";
       return 1;
     }
   }
 
   {
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "replay";
-    options.allow_no_auth_in_replay = true;
-    options.symbols = {"BTCUSDT"};
-    options.replay_prices = {100.0, 98.0};
-    options.replay_exit_fee_bps = 10.0;
-    ai_trade::BybitExchangeAdapter adapter(options);
+    ai_trade::MockExchangeAdapter adapter({100.0});
     if (!adapter.Connect()) {
-      std::cerr << "bybit 回放保护单连接失败\n";
+      std::cerr << "mock 连接失败\n";
       return 1;
     }
+    ai_trade::MarketEvent event;
+    adapter.PollMarket(&event);
 
-    ai_trade::MarketEvent first;
-    if (!adapter.PollMarket(&first)) {
-      std::cerr << "bybit 回放保护单首条行情失败\n";
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "cancel-order";
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 2.0;
+    intent.price = 100.0;
+    if (!adapter.SubmitOrder(intent)) {
+      std::cerr << "mock 下单失败\n";
       return 1;
     }
-
-    ai_trade::OrderIntent entry;
-    entry.client_order_id = "bybit-replay-protection-entry";
-    entry.symbol = "BTCUSDT";
-    entry.purpose = ai_trade::OrderPurpose::kEntry;
-    entry.direction = 1;
-    entry.qty = 1.0;
-    entry.price = first.price;
-    if (!adapter.SubmitOrder(entry)) {
-      std::cerr << "bybit 回放保护单入场失败\n";
+    if (!adapter.CancelOrder(intent.client_order_id)) {
+      std::cerr << "mock 撤单失败\n";
       return 1;
     }
-    ai_trade::FillEvent fill;
-    while (adapter.PollFill(&fill)) {
+    std::unordered_set<std::string> open_order_ids;
+    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids)) {
+      std::cerr << "mock 撤单后活动订单读取失败\n";
+      return 1;
     }
-
-    ai_trade::OrderIntent stop_loss;
-    stop_loss.client_order_id = "bybit-replay-protection-sl";
-    stop_loss.parent_order_id = entry.client_order_id;
-    stop_loss.symbol = "BTCUSDT";
-    stop_loss.purpose = ai_trade::OrderPurpose::kSl;
-    stop_loss.reduce_only = true;
-    stop_loss.direction = -1;
-    stop_loss.qty = 1.0;
-    stop_loss.price = 99.0;
-    if (!adapter.SubmitOrder(stop_loss)) {
-      std::cerr << "bybit 回放保护单提交失败\n";
+    if (!open_order_ids.empty()) {
+      std::cerr << "mock 撤单后活动订单集合应为空\n";
       return 1;
     }
+    ai_trade::FillEvent fill;
     if (adapter.PollFill(&fill)) {
-      std::cerr << "bybit 回放保护单不应提交即成交\n";
+      std::cerr << "撤单后不应再有成交\n";
       return 1;
     }
+  }
 
-    ai_trade::MarketEvent second;
-    if (!adapter.PollMarket(&second)) {
-      std::cerr << "bybit 回放保护单触发行情失败\n";
+  {
+    // mock 压测模式：预生成事件流确定性、突发/空洞节奏与成交注入。
+    ai_trade::MockStressScenario scenario;
+    scenario.seed = 7;
+    scenario.total_events = 1000;
+    scenario.burst_size = 10;
+    scenario.gap_ms = 500;
+    scenario.base_price = 100.0;
+    scenario.price_jitter_pct = 0.002;
+    scenario.fill_every = 100;
+
+    ai_trade::MockExchangeAdapter adapter(
+        {}, std::vector<std::string>{"BTCUSDT", "ETHUSDT"});
+    adapter.PreloadStressScenario(scenario);
+    if (!adapter.Connect() || !adapter.stress_mode()) {
+      std::cerr << "mock 压测模式初始化失败\n";
       return 1;
     }
-    int protection_fills = 0;
-    double protection_fee = 0.0;
-    while (adapter.PollFill(&fill)) {
-      ++protection_fills;
-      protection_fee += fill.fee;
-      if (fill.client_order_id != stop_loss.client_order_id ||
-          fill.direction != -1 ||
-          !NearlyEqual(fill.price, 99.0, 1e-9)) {
-        std::cerr << "bybit 回放保护单触发成交字段不符合预期\n";
+
+    ai_trade::MockExchangeAdapter twin(
+        {}, std::vector<std::string>{"BTCUSDT", "ETHUSDT"});
+    twin.PreloadStressScenario(scenario);
+    twin.Connect();
+
+    ai_trade::MarketEvent event;
+    ai_trade::MarketEvent twin_event;
+    std::int64_t prev_ts_ms = 0;
+    std::size_t gap_count = 0;
+    std::size_t served = 0;
+    while (adapter.PollMarket(&event)) {
+      if (!twin.PollMarket(&twin_event) ||
+          twin_event.ts_ms != event.ts_ms ||
+          twin_event.symbol != event.symbol ||
+          !NearlyEqual(twin_event.price, event.price, 1e-12)) {
+        std::cerr << "同种子压测场景应产出完全一致的事件流\n";
+        return 1;
+      }
+      if (event.price <= 0.0 || event.ts_ms <= prev_ts_ms) {
+        std::cerr << "压测事件时间轴/价格不符合预期\n";
         return 1;
       }
+      if (served > 0 && event.ts_ms - prev_ts_ms >= scenario.gap_ms) {
+        ++gap_count;
+      }
+      prev_ts_ms = event.ts_ms;
+      ++served;
     }
-    if (protection_fills != 2 || !NearlyEqual(protection_fee, 0.099, 1e-9)) {
-      std::cerr << "bybit 回放保护单触发成交数量或手续费不符合预期\n";
+    if (served != scenario.total_events ||
+        adapter.stress_stats().market_events_served != scenario.total_events) {
+      std::cerr << "压测事件服务计数不符合预期\n";
       return 1;
     }
-    double remote_notional = 0.0;
-    if (!adapter.GetRemoteNotionalUsd(&remote_notional) ||
-        !NearlyEqual(remote_notional, 0.0, 1e-9)) {
-      std::cerr << "bybit 回放保护单触发后仓位应归零\n";
+    // 1000 个事件、突发 10 个一组 => 99 次突发间空洞。
+    if (gap_count != 99) {
+      std::cerr << "压测突发/空洞节奏不符合预期，空洞数 " << gap_count << "\n";
       return 1;
     }
-  }
 
-  {
-    const std::filesystem::path replay_path =
-        std::filesystem::temp_directory_path() / "ai_trade_replay_market.csv";
-    {
-      std::ofstream out(replay_path);
-      out << "timestamp,symbol,price,volume,interval_ms,funding_rate_per_interval\n"
-          << "1700000000000,BTCUSDT,50000,12.5,300000,\n"
-          << "1700000300000,BTCUSDT,50120,10.0,300000,0.00001\n";
+    ai_trade::FillEvent stress_fill;
+    std::size_t fills_drained = 0;
+    while (adapter.PollFill(&stress_fill)) {
+      ++fills_drained;
     }
-    ai_trade::BybitAdapterOptions options;
-    options.mode = "replay";
-    options.allow_no_auth_in_replay = true;
-    options.symbols = {"BTCUSDT"};
-    options.replay_market_data_path = replay_path.string();
-    options.replay_price_column = "price";
-    options.replay_volume_column = "volume";
-    options.replay_timestamp_column = "timestamp";
-    options.replay_symbol_column = "symbol";
-    options.replay_interval_column = "interval_ms";
-    options.replay_funding_rate_column = "funding_rate_per_interval";
-    options.replay_default_interval_ms = 300000;
-
-    ai_trade::BybitExchangeAdapter adapter(options);
-    if (!adapter.Connect()) {
-      std::cerr << "bybit CSV replay 连接失败\n";
+    if (fills_drained != 10 || adapter.stress_stats().fills_injected != 10 ||
+        adapter.stress_stats().max_pending_fill_depth == 0) {
+      std::cerr << "压测成交注入/队列深度统计不符合预期\n";
       return 1;
     }
+  }
 
-    ai_trade::MarketEvent first;
-    ai_trade::MarketEvent second;
-    if (!adapter.PollMarket(&first) || !adapter.PollMarket(&second)) {
-      std::cerr << "bybit CSV replay 行情拉取失败\n";
+  {
+    // curl 暖连接池：同一 transport 的连续请求应复用同一条 keep-alive 连接
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+      std::cerr << "连接池测试 socket 创建失败\n";
       return 1;
     }
-    if (!NearlyEqual(first.price, 50000.0) || !NearlyEqual(first.volume, 12.5) ||
-        first.interval_ms != 300000) {
-      std::cerr << "bybit CSV replay 第一条行情不符合预期\n";
+    sockaddr_in listen_addr{};
+    listen_addr.sin_family = AF_INET;
+    listen_addr.sin_port = 0;
+    ::inet_pton(AF_INET, "127.0.0.1", &listen_addr.sin_addr);
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&listen_addr),
+               sizeof(listen_addr)) != 0 ||
+        ::listen(listen_fd, 4) != 0) {
+      std::cerr << "连接池测试端口绑定失败\n";
       return 1;
     }
-    if (!NearlyEqual(second.price, 50120.0) || !NearlyEqual(second.volume, 10.0) ||
-        second.interval_ms != 300000 ||
-        !NearlyEqual(second.funding_rate_per_interval, 0.00001)) {
-      std::cerr << "bybit CSV replay 第二条行情不符合预期\n";
+    socklen_t addr_len = sizeof(listen_addr);
+    ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&listen_addr),
+                  &addr_len);
+    const int port = static_cast<int>(ntohs(listen_addr.sin_port));
+
+    std::atomic<int> accept_count{0};
+    std::thread server([listen_fd, &accept_count] {
+      const std::string body = R"({"retCode":0,"retMsg":"OK"})";
+      const std::string response =
+          "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+          "Content-Length: " + std::to_string(body.size()) +
+          "\r\nConnection: keep-alive\r\n\r\n" + body;
+      int served = 0;
+      while (served < 2) {
+        const int conn = ::accept(listen_fd, nullptr, nullptr);
+        if (conn < 0) {
+          break;
+        }
+        accept_count.fetch_add(1);
+        // 复用失败时 curl 会另开连接：限时等待避免测试悬挂。
+        timeval recv_timeout{.tv_sec = 2, .tv_usec = 0};
+        ::setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &recv_timeout,
+                     sizeof(recv_timeout));
+        char buffer[2048];
+        std::string request;
+        while (served < 2) {
+          const ssize_t n = ::recv(conn, buffer, sizeof(buffer), 0);
+          if (n <= 0) {
+            break;
+          }
+          request.append(buffer, static_cast<std::size_t>(n));
+          if (request.find("\r\n\r\n") != std::string::npos) {
+            (void)::send(conn, response.data(), response.size(), 0);
+            request.clear();
+            ++served;
+          }
+        }
+        ::close(conn);
+      }
+    });
+
+    ai_trade::CurlBybitHttpTransport transport;
+    const std::string url =
+        "http://127.0.0.1:" + std::to_string(port) + "/v5/market/time";
+    const auto first = transport.Send("GET", url, {}, "");
+    const auto second = transport.Send("GET", url, {}, "");
+    server.join();
+    ::close(listen_fd);
+    if (first.status_code != 200 || second.status_code != 200 ||
+        second.body.find("retCode") == std::string::npos) {
+      std::cerr << "暖连接池请求失败: " << first.error << " / "
+                << second.error << "\n";
+      return 1;
+    }
+    // accept 只发生一次 = 第二个请求走了回池句柄里的暖连接。
+    if (accept_count.load() != 1) {
+      std::cerr << "keep-alive 连接未被复用，accept 次数 "
+                << accept_count.load() << "\n";
       return 1;
     }
-    std::filesystem::remove(replay_path);
   }
 
   {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 2;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 3;
-    gate_config.window_ticks = 3;
-    ai_trade::GateMonitor monitor(gate_config);
+    // K 线并发回补：页对齐分块、升序去重合并、任一块失败整体失败
+    const auto make_page = [](std::int64_t first_ts, int bars,
+                              std::int64_t step_ms) {
+      // Bybit 返回按时间倒序的字符串数组行。
+      std::string list;
+      for (int i = bars - 1; i >= 0; --i) {
+        const std::int64_t ts = first_ts + i * step_ms;
+        if (!list.empty()) {
+          list += ",";
+        }
+        list += "[\"" + std::to_string(ts) + "\",\"100\",\"101\",\"99\",\"" +
+                std::to_string(100 + i) + "\",\"10\"]";
+      }
+      return std::string(R"({"retCode":0,"retMsg":"OK","result":{"list":[)") +
+             list + "]}}";
+    };
 
-    ai_trade::Signal signal;
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
+    auto transport = std::make_unique<MockBybitHttpTransport>();
+    // page_limit=4、interval=1m => 块跨度 240000ms；[0, 480000) 切两块。
+    transport->AddRoute("GET", "start=0&",
+                        ai_trade::BybitHttpResponse{
+                            .status_code = 200,
+                            .body = make_page(0, 4, 60'000),
+                            .error = "",
+                        });
+    transport->AddRoute("GET", "start=240000&",
+                        ai_trade::BybitHttpResponse{
+                            .status_code = 200,
+                            .body = make_page(240'000, 4, 60'000),
+                            .error = "",
+                        });
+    ai_trade::BybitRestClient rest("k", "s", /*testnet=*/true,
+                                   /*demo_trading=*/false,
+                                   std::move(transport));
+
+    ai_trade::BybitKlineBackfillOptions options;
+    options.page_limit = 4;
+    options.concurrency = 2;
+    options.max_requests_per_second = 100;
+    ai_trade::BybitKlineBackfill backfill(&rest, options);
 
-    if (monitor.OnDecision(signal, adjusted, intent).has_value()) {
-      std::cerr << "首个无信号tick不应触发心跳告警\n";
+    std::vector<ai_trade::research::ResearchBar> bars;
+    std::string backfill_error;
+    if (!backfill.BackfillRange("BTCUSDT", 1, 0, 480'000, &bars,
+                                &backfill_error)) {
+      std::cerr << "K 线回补失败: " << backfill_error << "\n";
       return 1;
     }
-    if (monitor.OnTick().has_value()) {
-      std::cerr << "窗口未结束不应返回 Gate 结果\n";
+    if (bars.size() != 8) {
+      std::cerr << "回补根数不符合预期: " << bars.size() << "\n";
       return 1;
     }
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+      if (bars[i].ts_ms != static_cast<std::int64_t>(i) * 60'000 ||
+          !NearlyEqual(bars[i].close, 100.0 + static_cast<double>(i % 4),
+                       1e-12)) {
+        std::cerr << "回补结果未按 ts 升序合并: index=" << i << "\n";
+        return 1;
+      }
+    }
 
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-
-    const auto heartbeat = monitor.OnDecision(signal, adjusted, intent);
-    if (!heartbeat.has_value() || *heartbeat != "WARN_SIGNAL_HEARTBEAT_GAP") {
-      std::cerr << "连续无有效信号未触发预期心跳告警\n";
+    // 多 symbol 落盘：结果应直接可被列式读取端打开。
+    const auto backfill_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_test_backfill";
+    std::filesystem::remove_all(backfill_dir);
+    if (!backfill.BackfillSymbolsToColumnar({"BTCUSDT"}, 1, 0, 480'000,
+                                            backfill_dir.string(),
+                                            &backfill_error)) {
+      std::cerr << "回补落盘失败: " << backfill_error << "\n";
       return 1;
     }
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || gate_result->pass) {
-      std::cerr << "预期 Gate 失败但未失败\n";
+    ai_trade::research::ColumnarBarStore store;
+    if (!store.Open((backfill_dir / "BTCUSDT_1m.bin").string(),
+                    &backfill_error) ||
+        store.Count() != 8 || store.Timestamps()[4] != 240'000) {
+      std::cerr << "回补列式文件读取不符合预期: " << backfill_error << "\n";
       return 1;
     }
-    if (gate_result->fail_reasons.size() != 2) {
-      std::cerr << "预期 Gate 失败原因包含信号与成交两个维度\n";
+    store.Close();
+    std::filesystem::remove_all(backfill_dir);
+
+    // 无路由的块返回 404：整体失败而非留下隐性断档。
+    if (backfill.BackfillRange("BTCUSDT", 1, 0, 720'000, &bars,
+                               &backfill_error) ||
+        backfill_error.empty()) {
+      std::cerr << "缺页回补应整体失败\n";
       return 1;
     }
   }
 
   {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 2;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    ai_trade::GateMonitor monitor(gate_config);
+    // 交易规则缓存：connect 全量分页加载，未配置的 symbol 也可查询
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
 
-    ai_trade::Signal signal;
-    signal.suggested_notional_usd = 100.0;
-    signal.direction = 1;
-    ai_trade::RiskAdjustedPosition adjusted;
-    adjusted.adjusted_notional_usd = 100.0;
-    std::optional<ai_trade::OrderIntent> intent;
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    // 带 cursor 的路由必须先注册：通用路由会同时命中两类 URL。
+    transport.AddRoute(
+        "GET",
+        "cursor=page2",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"ETHUSDT","lotSizeFilter":{"minOrderQty":"0.01","maxMktOrderQty":"500","qtyStep":"0.01","minNotionalValue":"5"},"priceFilter":{"tickSize":"0.01"}}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/market/instruments-info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"nextPageCursor":"page2","list":[{"symbol":"BTCUSDT","lotSizeFilter":{"minOrderQty":"0.001","maxMktOrderQty":"100","qtyStep":"0.001","minNotionalValue":"5"},"priceFilter":{"tickSize":"0.1"}}]}})",
+            .error = "",
+        });
 
-    monitor.OnDecision(signal, adjusted, intent);
-    ai_trade::FillEvent gate_fill;
-    gate_fill.fill_id = "gate-fill-1";
-    monitor.OnFill(gate_fill);
-    if (monitor.OnTick().has_value()) {
-      std::cerr << "窗口未结束不应返回 Gate 结果\n";
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.instrument_refresh_interval_s = 1;  // 同时覆盖刷新线程启停。
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "交易规则缓存测试连接失败\n";
       return 1;
     }
-
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-
-    monitor.OnDecision(signal, adjusted, intent);
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || !gate_result->pass) {
-      std::cerr << "预期 Gate 通过但失败\n";
+    ai_trade::SymbolInfo info;
+    if (!adapter.GetSymbolInfo("BTCUSDT", &info) ||
+        !NearlyEqual(info.qty_step, 0.001, 1e-12) ||
+        !NearlyEqual(info.price_tick, 0.1, 1e-12)) {
+      std::cerr << "首页交易规则未进入快照\n";
       return 1;
     }
-    if (gate_result->raw_signals != 3 ||
-        gate_result->order_intents != 0 ||
-        gate_result->effective_signals != 3 ||
-        gate_result->fills != 1) {
-      std::cerr << "Gate 统计结果不符合预期\n";
+    // ETHUSDT 不在配置列表里，只有全量分页加载才能命中。
+    if (!adapter.GetSymbolInfo("ETHUSDT", &info) ||
+        !NearlyEqual(info.qty_step, 0.01, 1e-12) ||
+        !NearlyEqual(info.min_notional_usd, 5.0, 1e-12)) {
+      std::cerr << "分页交易规则未进入快照\n";
       return 1;
     }
+    if (adapter.GetSymbolInfo("XRPUSDT", &info)) {
+      std::cerr << "未知 symbol 不应命中规则快照\n";
+      return 1;
+    }
+    // 析构应能干净回收后台刷新线程。
   }
 
   {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 2;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    gate_config.allow_policy_flat_windows = true;
-    ai_trade::GateMonitor monitor(gate_config);
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
 
-    ai_trade::Signal signal;
-    signal.reason_codes = {"STR_RANGE_CONFIDENCE_BLOCK", "STR_FLAT_SIGNAL", "REG_RANGE"};
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "POST",
+        "/v5/order/cancel",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":110001,"retMsg":"order not exists or too late to cancel"})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/order/realtime",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","orderLinkId":"cid-open-1","orderStatus":"New","leavesQty":"1"},{"symbol":"BTCUSDT","orderLinkId":"cid-zero-leaves-1","orderStatus":"New","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"cid-filled-1","orderStatus":"Filled","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"cid-cancelled-1","orderStatus":"Cancelled","leavesQty":"0"},{"symbol":"BTCUSDT","orderLinkId":"","orderStatus":"New","leavesQty":"1"}]}})",
+            .error = "",
+        });
 
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || !gate_result->pass ||
-        !gate_result->policy_flat_pass) {
-      std::cerr << "预期 Gate 以 policy-flat 方式通过但失败\n";
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（撤单幂等测试）\n";
       return 1;
     }
-    if (gate_result->policy_flat_signals != 3 ||
-        !gate_result->fail_reasons.empty()) {
-      std::cerr << "policy-flat Gate 统计结果不符合预期\n";
+    if (!adapter.CancelOrder("cid-stale-1")) {
+      std::cerr << "Bybit 110001 撤单应按幂等成功处理\n";
+      return 1;
+    }
+    std::unordered_set<std::string> open_order_ids;
+    if (!adapter.GetRemoteOpenOrderClientIds(&open_order_ids) ||
+        open_order_ids.find("cid-open-1") == open_order_ids.end() ||
+        open_order_ids.find("cid-zero-leaves-1") != open_order_ids.end() ||
+        open_order_ids.find("cid-filled-1") != open_order_ids.end() ||
+        open_order_ids.find("cid-cancelled-1") != open_order_ids.end()) {
+      std::cerr << "Bybit 活动订单集合读取不符合预期\n";
       return 1;
     }
   }
 
   {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 2;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    gate_config.allow_policy_flat_windows = true;
-    ai_trade::GateMonitor monitor(gate_config);
-
-    ai_trade::Signal signal;
-    signal.reason_codes = {"STR_FLAT_SIGNAL", "REG_RANGE"};
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
-
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || !gate_result->pass ||
-        !gate_result->policy_flat_pass) {
-      std::cerr << "预期 RANGE silent flat 也应作为 policy-flat 通过\n";
+    ai_trade::BybitPrivateStreamOptions ws_options;
+    ws_options.enabled = false;
+    ws_options.api_key = "k";
+    ws_options.api_secret = "s";
+    ai_trade::BybitPrivateStream stream(std::move(ws_options));
+    std::string error;
+    if (stream.Connect(&error)) {
+      std::cerr << "禁用 private ws 时不应连接成功\n";
       return 1;
     }
-    if (gate_result->policy_flat_signals != 3 ||
-        !gate_result->fail_reasons.empty()) {
-      std::cerr << "RANGE silent flat policy-flat 统计结果不符合预期\n";
+    if (stream.Healthy()) {
+      std::cerr << "禁用 private ws 时健康状态应为 false\n";
+      return 1;
+    }
+    if (error.empty()) {
+      std::cerr << "禁用 private ws 时应返回错误原因\n";
       return 1;
     }
   }
 
   {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 3;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    gate_config.allow_policy_flat_windows = true;
-    ai_trade::GateMonitor monitor(gate_config);
+    ai_trade::BybitPrivateStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.api_key = "k";
+    ws_options.api_secret = "s";
+    ws_options.ack_timeout_ms = 1000;
 
-    ai_trade::Signal signal;
-    signal.reason_codes = {"STR_RANGE_CONFIDENCE_BLOCK", "STR_FLAT_SIGNAL", "REG_RANGE"};
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        {ScriptedWsAction::kText, "{", ""},
+        {ScriptedWsAction::kText,
+         R"({"topic":"execution","data":[{"execId":"exec-1","orderLinkId":"cid-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":true},{"execId":"exec-2","orderLinkId":"","orderId":"oid-2","symbol":"ETHUSDT","side":"Sell","execQty":"2","execPrice":"101","execFee":"0.02","isMaker":false},{"execId":"exec-1","orderLinkId":"cid-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":true}]})",
+         ""},
+        {ScriptedWsAction::kClosed, "", "peer closed"},
+    };
 
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || gate_result->pass ||
-        gate_result->policy_flat_pass ||
-        !gate_result->policy_flat_runtime_exempt) {
-      std::cerr << "预期 Gate 为 policy-flat 部分窗口失败但应豁免 runtime 动作\n";
+    ai_trade::BybitPrivateStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "private ws 脚本连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::FillEvent fill;
+    if (stream.PollExecution(&fill)) {
+      std::cerr << "异常 JSON 包不应产生成交\n";
+      return 1;
+    }
+    if (!stream.PollExecution(&fill)) {
+      std::cerr << "有效 execution 消息应产生成交\n";
+      return 1;
+    }
+    if (fill.fill_id != "exec-1" || fill.client_order_id != "cid-1" ||
+        fill.direction != 1 || !NearlyEqual(fill.qty, 1.0) ||
+        fill.liquidity != ai_trade::FillLiquidity::kMaker) {
+      std::cerr << "private ws execution 解析结果不符合预期\n";
+      return 1;
+    }
+    if (!stream.PollExecution(&fill)) {
+      std::cerr << "空 orderLinkId 但有 orderId 的 execution 应产生成交\n";
+      return 1;
+    }
+    if (fill.fill_id != "exec-2" || fill.client_order_id != "oid-2" ||
+        fill.symbol != "ETHUSDT" || fill.direction != -1 ||
+        !NearlyEqual(fill.qty, 2.0) ||
+        fill.liquidity != ai_trade::FillLiquidity::kTaker) {
+      std::cerr << "private ws execution 应在 orderLinkId 为空时 fallback 到 orderId\n";
+      return 1;
+    }
+    if (stream.PollExecution(&fill)) {
+      std::cerr << "重复 execId 不应再次产生成交\n";
+      return 1;
+    }
+    if (stream.Healthy()) {
+      std::cerr << "连接关闭后 private ws 应标记为不健康\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::BybitPrivateStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = false;
+    ws_options.demo_trading = true;
+    ws_options.api_key = "k";
+    ws_options.api_secret = "s";
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+    };
+
+    ai_trade::BybitPrivateStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(
+            std::move(script),
+            true,
+            "",
+            "wss://stream-demo.bybit.com/v5/private"));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "demo private ws URL 连接失败: " << error << "\n";
+      return 1;
+    }
+  }
+
+  {
+    // order 主题按订单折叠：撤改单风暴下只吐出每个订单的最新状态
+    ai_trade::BybitPrivateStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.api_key = "k";
+    ws_options.api_secret = "s";
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        {ScriptedWsAction::kText,
+         R"({"topic":"order","data":[{"orderLinkId":"cid-A","symbol":"BTCUSDT","orderStatus":"New","cumExecQty":"0","leavesQty":"3","avgPrice":"0","updatedTime":"1700000000100"},{"orderLinkId":"cid-A","symbol":"BTCUSDT","orderStatus":"PartiallyFilled","cumExecQty":"1","leavesQty":"2","avgPrice":"100","updatedTime":"1700000000200"},{"orderLinkId":"cid-B","symbol":"ETHUSDT","orderStatus":"New","cumExecQty":"0","leavesQty":"5","avgPrice":"0","updatedTime":"1700000000250"},{"orderLinkId":"cid-A","symbol":"BTCUSDT","orderStatus":"Filled","cumExecQty":"3","leavesQty":"0","avgPrice":"101","updatedTime":"1700000000300"}]})",
+         ""},
+        {ScriptedWsAction::kText,
+         R"({"topic":"order","data":[{"orderLinkId":"cid-B","symbol":"ETHUSDT","orderStatus":"Cancelled","cumExecQty":"0","leavesQty":"0","avgPrice":"0","updatedTime":"1700000000400"}]})",
+         ""},
+    };
+
+    ai_trade::BybitPrivateStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "order 折叠用例连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::BybitOrderUpdate update;
+    if (!stream.PollOrderUpdate(&update) || update.client_order_id != "cid-A" ||
+        update.order_status != "Filled" || !NearlyEqual(update.cum_exec_qty, 3.0) ||
+        !NearlyEqual(update.leaves_qty, 0.0) ||
+        !NearlyEqual(update.avg_price, 101.0) ||
+        update.updated_ts_ms != 1700000000300 || update.conflated_count != 3) {
+      std::cerr << "cid-A 的三条中间态应折叠为最新一帧\n";
+      return 1;
+    }
+    if (!stream.PollOrderUpdate(&update) || update.client_order_id != "cid-B" ||
+        update.order_status != "New" || update.conflated_count != 1) {
+      std::cerr << "cid-B 首帧应原样吐出\n";
+      return 1;
+    }
+    // 消费后槽位重新置脏：后续帧应再次产出该订单。
+    if (!stream.PollOrderUpdate(&update) || update.client_order_id != "cid-B" ||
+        update.order_status != "Cancelled" || update.conflated_count != 1) {
+      std::cerr << "已消费订单收到新帧后应重新入队\n";
+      return 1;
+    }
+    if (stream.PollOrderUpdate(&update)) {
+      std::cerr << "脏单队列排空后不应再产出订单更新\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::BybitPublicStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.category = "linear";
+    ws_options.symbols = {"BTCUSDT"};
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        {ScriptedWsAction::kText, "{", ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000100,"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"123.4","markPrice":"123.5","volume24h":"1000","fundingRate":"0.0004"}})",
+         ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000300,"topic":"tickers.BTCUSDT","type":"delta","data":{"symbol":"BTCUSDT","lastPrice":"123.6","markPrice":"123.7","volume24h":"1002","fundingRate":"0.0004"}})",
+         ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000500,"topic":"tickers.BTCUSDT","type":"delta","data":{"symbol":"BTCUSDT","lastPrice":"123.5","markPrice":"123.6","volume24h":"999","fundingRate":"0.0004"}})",
+         ""},
+    };
+    ai_trade::BybitPublicStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "public ws 脚本连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent event;
+    // 批量排空：坏帧在同一次轮询内被跳过，首次 PollTicker 即产出有效行情。
+    if (!stream.PollTicker(&event)) {
+      std::cerr << "批量排空后首次轮询应跳过坏帧并产出行情\n";
+      return 1;
+    }
+    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 123.4) ||
+        !NearlyEqual(event.mark_price, 123.5) || event.ts_ms != 1700000000100LL ||
+        !NearlyEqual(event.volume, 0.0) || event.interval_ms != 0 ||
+        std::isfinite(event.funding_rate_per_interval)) {
+      std::cerr << "public ws ticker 解析结果不符合预期\n";
+      return 1;
+    }
+    if (!stream.PollTicker(&event)) {
+      std::cerr << "第二条 ticker 消息应产出行情\n";
+      return 1;
+    }
+    if (!NearlyEqual(event.price, 123.6) || !NearlyEqual(event.mark_price, 123.7) ||
+        event.interval_ms != 200 || !NearlyEqual(event.volume, 2.0)) {
+      std::cerr << "public ws ticker interval/volume 语义不符合预期\n";
+      return 1;
+    }
+    constexpr double kExpectedFundingPerInterval =
+        0.0004 * (200.0 / (8.0 * 60.0 * 60.0 * 1000.0));
+    if (!NearlyEqual(event.funding_rate_per_interval, kExpectedFundingPerInterval,
+                     1e-12)) {
+      std::cerr << "public ws ticker funding_rate_per_interval 语义不符合预期\n";
+      return 1;
+    }
+    if (!stream.PollTicker(&event)) {
+      std::cerr << "第三条 ticker 消息应产出行情\n";
+      return 1;
+    }
+    constexpr double kExpectedRollingFallbackVolume =
+        999.0 * (200.0 / (24.0 * 60.0 * 60.0 * 1000.0));
+    if (!NearlyEqual(event.price, 123.5) || !NearlyEqual(event.mark_price, 123.6) ||
+        event.interval_ms != 200 ||
+        !NearlyEqual(event.volume, kExpectedRollingFallbackVolume, 1e-12)) {
+      std::cerr << "public ws ticker rolling volume 回退语义不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    // 重连快路径：缓存订阅帧 + 异步 ACK，行情处理立即恢复
+    ai_trade::BybitPublicStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.category = "linear";
+    ws_options.symbols = {"BTCUSDT"};
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<std::vector<ScriptedWsStep>> sessions = {
+        {
+            {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+            {ScriptedWsAction::kClosed, "", "ws down once"},
+        },
+        {
+            // 重连会话：ticker 先于 ACK 到达，快路径应立即产出行情。
+            {ScriptedWsAction::kText,
+             R"({"ts":1700000001000,"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"130.5","markPrice":"130.6"}})",
+             ""},
+            {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        },
+    };
+    ai_trade::BybitPublicStream stream(
+        ws_options,
+        std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "重连快路径首连失败: " << error << "\n";
+      return 1;
+    }
+    ai_trade::MarketEvent event;
+    if (stream.PollTicker(&event) || stream.Healthy()) {
+      std::cerr << "首连断开后应标记为不健康\n";
+      return 1;
+    }
+    if (!stream.Connect(&error)) {
+      std::cerr << "重连快路径二次连接失败: " << error << "\n";
+      return 1;
+    }
+    // ACK 尚未到达也应先产出行情（ACK 在同一批次里被异步消化）。
+    if (!stream.PollTicker(&event) || event.symbol != "BTCUSDT" ||
+        !NearlyEqual(event.price, 130.5)) {
+      std::cerr << "重连快路径应立即恢复行情处理\n";
+      return 1;
+    }
+    if (!stream.Healthy()) {
+      std::cerr << "异步 ACK 成功后链路应保持健康\n";
+      return 1;
+    }
+  }
+
+  {
+    // 重连后订阅被拒：异步收集到 success:false 应按断链处理
+    ai_trade::BybitPublicStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.category = "linear";
+    ws_options.symbols = {"BTCUSDT"};
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<std::vector<ScriptedWsStep>> sessions = {
+        {
+            {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+            {ScriptedWsAction::kClosed, "", "ws down once"},
+        },
+        {
+            {ScriptedWsAction::kText,
+             R"({"op":"subscribe","success":false,"ret_msg":"bad args"})", ""},
+        },
+    };
+    ai_trade::BybitPublicStream stream(
+        ws_options,
+        std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "订阅拒绝用例首连失败: " << error << "\n";
+      return 1;
+    }
+    ai_trade::MarketEvent event;
+    (void)stream.PollTicker(&event);  // 消费断链。
+    if (!stream.Connect(&error)) {
+      std::cerr << "订阅拒绝用例二次连接失败: " << error << "\n";
+      return 1;
+    }
+    if (stream.PollTicker(&event) || stream.Healthy()) {
+      std::cerr << "异步 ACK 被拒后应标记断链\n";
+      return 1;
+    }
+  }
+
+  {
+    // WebsocketClient::PollBatch 默认实现：一次调用排空全部完整帧，
+    // 切片借用复用缓冲，缓冲跨调用保留容量。
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, "frame-a", ""},
+        {ScriptedWsAction::kText, "frame-bb", ""},
+        {ScriptedWsAction::kText, "frame-ccc", ""},
+        {ScriptedWsAction::kNoMessage, "", ""},
+        {ScriptedWsAction::kText, "frame-d", ""},
+    };
+    ScriptedWebsocketClient client(std::move(script));
+    std::string error;
+    if (!client.Connect("wss://unit.test/ws", {}, &error)) {
+      std::cerr << "PollBatch 脚本连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::WsFrameBatch batch;
+    if (client.PollBatch(&batch, &error) != ai_trade::WsPollStatus::kMessage ||
+        batch.frames.size() != 3 || batch.frames[0] != "frame-a" ||
+        batch.frames[1] != "frame-bb" || batch.frames[2] != "frame-ccc") {
+      std::cerr << "PollBatch 应一次排空全部完整帧\n";
+      return 1;
+    }
+    if (batch.data != "frame-aframe-bbframe-ccc" ||
+        batch.frames[1].data() != batch.data.data() + 7) {
+      std::cerr << "PollBatch 切片应直接借用持久缓冲\n";
+      return 1;
+    }
+
+    const std::size_t reserved = batch.data.capacity();
+    if (client.PollBatch(&batch, &error) != ai_trade::WsPollStatus::kMessage ||
+        batch.frames.size() != 1 || batch.frames[0] != "frame-d" ||
+        batch.data.capacity() < reserved) {
+      std::cerr << "PollBatch 复用缓冲应跨调用保留容量\n";
+      return 1;
+    }
+    if (client.PollBatch(&batch, &error) != ai_trade::WsPollStatus::kNoMessage ||
+        !batch.frames.empty()) {
+      std::cerr << "脚本耗尽后 PollBatch 应返回 kNoMessage\n";
+      return 1;
+    }
+  }
+
+  {
+    // 排空尾部遇到关闭：已收集帧照常返回，关闭状态在下一次调用复现。
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, "last-frame", ""},
+        {ScriptedWsAction::kClosed, "", "peer closed"},
+    };
+    ScriptedWebsocketClient client(std::move(script));
+    std::string error;
+    if (!client.Connect("wss://unit.test/ws", {}, &error)) {
+      std::cerr << "PollBatch 关闭脚本连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::WsFrameBatch batch;
+    if (client.PollBatch(&batch, &error) != ai_trade::WsPollStatus::kMessage ||
+        batch.frames.size() != 1 || batch.frames[0] != "last-frame") {
+      std::cerr << "关闭前已收集的帧应照常返回\n";
+      return 1;
+    }
+    if (client.PollBatch(&batch, &error) != ai_trade::WsPollStatus::kClosed) {
+      std::cerr << "关闭状态应在下一次 PollBatch 复现\n";
+      return 1;
+    }
+  }
+
+  {
+    // 非紧凑 JSON（键后带空格）不命中 ticker 专用读取器，
+    // 应回退通用解析并产出同语义行情。
+    ai_trade::BybitPublicStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.symbols = {"ETHUSDT"};
+    ws_options.ack_timeout_ms = 1000;
+
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        {ScriptedWsAction::kText,
+         R"({"topic": "tickers.ETHUSDT", "type": "snapshot", "ts": 1700000002000, "data": {"symbol": "ETHUSDT", "lastPrice": "200.5", "markPrice": "200.6"}})",
+         ""},
+    };
+    ai_trade::BybitPublicStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "非紧凑 JSON 回退测试连接失败: " << error << "\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent event;
+    if (!stream.PollTicker(&event)) {
+      std::cerr << "非紧凑 JSON 应经通用解析产出行情\n";
+      return 1;
+    }
+    if (event.symbol != "ETHUSDT" || !NearlyEqual(event.price, 200.5) ||
+        !NearlyEqual(event.mark_price, 200.6) ||
+        event.ts_ms != 1700000002000LL) {
+      std::cerr << "非紧凑 JSON 回退解析结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/execution/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"rest-exec-1","orderLinkId":"cid-rest-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","isMaker":"0"},{"execId":"rest-exec-1","orderLinkId":"cid-rest-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","isMaker":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/account/wallet-balance",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"accountType":"UNIFIED","totalEquity":"12345.6","totalWalletBalance":"12000.0","totalPerpUPL":"345.6"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = true;
+    options.private_ws_rest_fallback = true;
+    options.execution_skip_history_on_start = false;
+    options.execution_poll_limit = 10;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+    options.private_stream_factory =
+        [](ai_trade::BybitPrivateStreamOptions ws_options) {
+          std::vector<ScriptedWsStep> ws_script = {
+              {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+              {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+              {ScriptedWsAction::kClosed, "", "ws down"},
+          };
+          return std::make_unique<ai_trade::BybitPrivateStream>(
+              std::move(ws_options),
+              std::make_unique<ScriptedWebsocketClient>(std::move(ws_script)));
+        };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（private ws fallback 测试）\n";
+      return 1;
+    }
+
+    ai_trade::FillEvent fill;
+    if (!adapter.PollFill(&fill) && !adapter.PollFill(&fill)) {
+      std::cerr << "private ws 回退后应从 REST 获取成交\n";
+      return 1;
+    }
+    if (fill.fill_id != "rest-exec-1" || fill.client_order_id != "cid-rest-1" ||
+        fill.direction != 1 || !NearlyEqual(fill.qty, 1.0) ||
+        fill.liquidity != ai_trade::FillLiquidity::kTaker) {
+      std::cerr << "private ws 回退 REST 成交解析不符合预期\n";
+      return 1;
+    }
+    if (adapter.PollFill(&fill)) {
+      std::cerr << "重复 REST execId 不应重复产生成交\n";
+      return 1;
+    }
+    if (!adapter.TradeOk()) {
+      std::cerr << "private ws 回退后 trade_ok 预期应为 true\n";
+      return 1;
+    }
+
+    ai_trade::RemoteAccountBalanceSnapshot balance;
+    if (!adapter.GetRemoteAccountBalance(&balance) ||
+        !balance.has_equity ||
+        !balance.has_wallet_balance ||
+        !balance.has_unrealized_pnl ||
+        !NearlyEqual(balance.equity_usd, 12345.6, 1e-9) ||
+        !NearlyEqual(balance.wallet_balance_usd, 12000.0, 1e-9) ||
+        !NearlyEqual(balance.unrealized_pnl_usd, 345.6, 1e-9)) {
+      std::cerr << "bybit 远端资金快照解析不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/execution/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = true;
+    options.private_ws_rest_fallback = true;
+    options.ws_reconnect_interval_ms = 0;
+    options.execution_skip_history_on_start = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+    options.private_stream_factory =
+        [](ai_trade::BybitPrivateStreamOptions ws_options) {
+          std::vector<std::vector<ScriptedWsStep>> sessions = {
+              {
+                  {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+                  {ScriptedWsAction::kClosed, "", "ws down once"},
+              },
+              {
+                  {ScriptedWsAction::kText, R"({"op":"auth","success":true})", ""},
+                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+                  {ScriptedWsAction::kText,
+                   R"({"topic":"execution","data":[{"execId":"ws-recovered-exec-1","orderLinkId":"cid-ws-recovered-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01"}]})",
+                   ""},
+              },
+          };
+          return std::make_unique<ai_trade::BybitPrivateStream>(
+              std::move(ws_options),
+              std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
+        };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（private ws 自动重连测试）\n";
+      return 1;
+    }
+
+    ai_trade::FillEvent fill;
+    if (!adapter.PollFill(&fill)) {
+      std::cerr << "private ws 断线后应重连并恢复成交读取\n";
+      return 1;
+    }
+    if (fill.fill_id != "ws-recovered-exec-1" ||
+        fill.client_order_id != "cid-ws-recovered-1") {
+      std::cerr << "private ws 重连恢复后的成交解析不符合预期\n";
+      return 1;
+    }
+    const std::string health = adapter.ChannelHealthSummary();
+    if (health.find("fill_channel=private_ws") == std::string::npos) {
+      std::cerr << "private ws 重连后通道状态应回到 private_ws，实际: "
+                << health << "\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "POST",
+        "/v5/order/create",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"orderId":"oid-map-1","orderLinkId":"cid-map-1"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/execution/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"exec-map-1","orderId":"oid-map-1","orderLinkId":"","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.01","isMaker":1}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.execution_skip_history_on_start = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（orderId 映射测试）\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "cid-map-1";
+    intent.symbol = "BTCUSDT";
+    intent.direction = 1;
+    intent.qty = 1.0;
+    intent.price = 100.0;
+    if (!adapter.SubmitOrder(intent)) {
+      std::cerr << "orderId 映射测试下单失败\n";
+      return 1;
+    }
+
+    ai_trade::FillEvent fill;
+    if (!adapter.PollFill(&fill)) {
+      std::cerr << "orderId 映射测试应获取到成交\n";
+      return 1;
+    }
+    if (fill.client_order_id != intent.client_order_id ||
+        fill.fill_id != "exec-map-1" ||
+        fill.liquidity != ai_trade::FillLiquidity::kMaker) {
+      std::cerr << "orderId 映射为 client_order_id 失败\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/execution/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"execId":"hist-exec-1","orderLinkId":"cid-hist-1","symbol":"BTCUSDT","side":"Buy","execQty":"1","execPrice":"100","execFee":"0.02","execTime":"1730000000000"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.execution_skip_history_on_start = true;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（execution 启动预热测试）\n";
+      return 1;
+    }
+
+    ai_trade::FillEvent fill;
+    if (adapter.PollFill(&fill)) {
+      std::cerr << "启动预热后不应消费历史 execution 成交\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/market/tickers",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lastPrice":"101.2","markPrice":"101.3","volume24h":"888","time":"1700000001000"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = true;
+    options.public_ws_rest_fallback = true;
+    options.private_ws_enabled = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+    options.public_stream_factory = [](ai_trade::BybitPublicStreamOptions ws_options) {
+      std::vector<ScriptedWsStep> ws_script = {
+          {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+          {ScriptedWsAction::kClosed, "", "ws down"},
+      };
+      return std::make_unique<ai_trade::BybitPublicStream>(
+          std::move(ws_options),
+          std::make_unique<ScriptedWebsocketClient>(std::move(ws_script)));
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（public ws fallback 测试）\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent event;
+    if (!adapter.PollMarket(&event) && !adapter.PollMarket(&event)) {
+      std::cerr << "public ws 回退后应从 REST 获取行情\n";
+      return 1;
+    }
+    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 101.2) ||
+        !NearlyEqual(event.mark_price, 101.3) || event.ts_ms != 1700000001000LL ||
+        !NearlyEqual(event.volume, 0.0)) {
+      std::cerr << "public ws 回退 REST 行情解析不符合预期: symbol="
+                << event.symbol << ", price=" << event.price
+                << ", mark=" << event.mark_price << ", ts=" << event.ts_ms
+                << ", volume=" << event.volume << ", interval=" << event.interval_ms
+                << "\n";
+      return 1;
+    }
+    if (!adapter.TradeOk()) {
+      std::cerr << "public ws 回退后 trade_ok 预期应为 true\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/market/tickers",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lastPrice":"88.8","markPrice":"88.9"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.primary_symbol = "BTCUSDT";
+    options.public_ws_enabled = true;
+    options.public_ws_rest_fallback = true;
+    options.private_ws_enabled = false;
+    options.ws_reconnect_interval_ms = 0;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+    options.public_stream_factory =
+        [](ai_trade::BybitPublicStreamOptions ws_options) {
+          std::vector<std::vector<ScriptedWsStep>> sessions = {
+              {
+                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+                  {ScriptedWsAction::kClosed, "", "ws down once"},
+              },
+              {
+                  {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+                  {ScriptedWsAction::kText,
+                   R"({"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"120.1","markPrice":"120.2"}})",
+                   ""},
+              },
+          };
+          return std::make_unique<ai_trade::BybitPublicStream>(
+              std::move(ws_options),
+              std::make_unique<SessionScriptedWebsocketClient>(std::move(sessions)));
+        };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit adapter 连接失败（public ws 自动重连测试）\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent event;
+    if (!adapter.PollMarket(&event)) {
+      std::cerr << "public ws 断线后应重连并恢复行情读取\n";
+      return 1;
+    }
+    if (event.symbol != "BTCUSDT" || !NearlyEqual(event.price, 120.1) ||
+        !NearlyEqual(event.mark_price, 120.2)) {
+      std::cerr << "public ws 重连恢复后的行情解析不符合预期\n";
+      return 1;
+    }
+    const std::string health = adapter.ChannelHealthSummary();
+    if (health.find("market_channel=public_ws") == std::string::npos) {
+      std::cerr << "public ws 重连后通道状态应回到 public_ws，实际: "
+                << health << "\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar testnet_key("AI_TRADE_BYBIT_TESTNET_API_KEY", "k-testnet");
+    ScopedEnvVar testnet_secret("AI_TRADE_BYBIT_TESTNET_API_SECRET", "s-testnet");
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "Bybit testnet 专用环境变量连接失败\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "k");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "s");
+
+    auto* transport = new MockBybitHttpTransport();
+    transport->AddRoute(
+        "GET",
+        "/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport->AddRoute(
+        "GET",
+        "/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+    transport->AddRoute(
+        "GET",
+        "/v5/market/instruments-info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","lotSizeFilter":{"minOrderQty":"0.001","maxMktOrderQty":"100","qtyStep":"0.001","minNotionalValue":"5"},"priceFilter":{"tickSize":"0.1"}}]}})",
+            .error = "",
+        });
+    transport->AddRoute(
+        "POST",
+        "/v5/order/create",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"orderId":"oid-1"}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = true;
+    options.symbols = {"BTCUSDT"};
+    options.maker_entry_enabled = true;
+    options.maker_fallback_to_market = false;
+    options.maker_price_offset_bps = 1.0;
+    options.maker_post_only = true;
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.http_transport_factory = [transport]() {
+      return std::unique_ptr<ai_trade::BybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "Bybit 交易规则量化测试连接失败\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent ok_intent;
+    ok_intent.client_order_id = "qty-ok-1";
+    ok_intent.symbol = "BTCUSDT";
+    ok_intent.direction = 1;
+    ok_intent.qty = 0.123456;
+    ok_intent.price = 100.0;
+    if (!adapter.SubmitOrder(ok_intent)) {
+      std::cerr << "Bybit 数量量化后订单应提交成功\n";
+      return 1;
+    }
+    if (transport->last_body().find("\"qty\":\"0.123\"") == std::string::npos) {
+      std::cerr << "Bybit 数量量化结果不符合预期，body=" << transport->last_body() << "\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent reduce_maker_intent;
+    reduce_maker_intent.client_order_id = "reduce-maker-1";
+    reduce_maker_intent.symbol = "BTCUSDT";
+    reduce_maker_intent.direction = -1;
+    reduce_maker_intent.qty = 0.1;
+    reduce_maker_intent.price = 100.0;
+    reduce_maker_intent.reduce_only = true;
+    reduce_maker_intent.purpose = ai_trade::OrderPurpose::kReduce;
+    reduce_maker_intent.liquidity_preference =
+        ai_trade::LiquidityPreference::kMaker;
+    if (!adapter.SubmitOrder(reduce_maker_intent)) {
+      std::cerr << "Bybit maker reduce-only 平仓单应提交成功\n";
+      return 1;
+    }
+    const std::string& reduce_body = transport->last_body();
+    if (reduce_body.find("\"orderType\":\"Limit\"") == std::string::npos ||
+        reduce_body.find("\"timeInForce\":\"PostOnly\"") == std::string::npos ||
+        reduce_body.find("\"reduceOnly\":true") == std::string::npos) {
+      std::cerr << "Bybit maker reduce-only 应使用 PostOnly Limit，body="
+                << reduce_body << "\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent small_intent = ok_intent;
+    small_intent.client_order_id = "qty-small-1";
+    small_intent.qty = 0.0004;
+    if (adapter.SubmitOrder(small_intent)) {
+      std::cerr << "Bybit 小于最小下单数量的订单应被拒绝\n";
+      return 1;
+    }
+  }
+
+  {
+    ScopedEnvVar demo_key("AI_TRADE_BYBIT_DEMO_API_KEY", "k-demo");
+    ScopedEnvVar demo_secret("AI_TRADE_BYBIT_DEMO_API_SECRET", "s-demo");
+    ScopedEnvVar api_key("AI_TRADE_API_KEY", "");
+    ScopedEnvVar api_secret("AI_TRADE_API_SECRET", "");
+
+    MockBybitHttpTransport transport;
+    transport.AddRoute(
+        "GET",
+        "https://api-demo.bybit.com/v5/account/info",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"unifiedMarginStatus":3,"marginMode":"ISOLATED"}})",
+            .error = "",
+        });
+    transport.AddRoute(
+        "GET",
+        "https://api-demo.bybit.com/v5/position/list",
+        ai_trade::BybitHttpResponse{
+            .status_code = 200,
+            .body = R"({"retCode":0,"retMsg":"OK","result":{"list":[{"symbol":"BTCUSDT","tradeMode":1,"positionIdx":0,"side":"Buy","positionValue":"0"}]}})",
+            .error = "",
+        });
+
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "paper";
+    options.testnet = false;
+    options.demo_trading = true;
+    options.symbols = {"BTCUSDT"};
+    options.public_ws_enabled = false;
+    options.private_ws_enabled = false;
+    options.http_transport_factory = [transport]() {
+      return std::make_unique<MockBybitHttpTransport>(transport);
+    };
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "Bybit demo 专用环境变量连接失败\n";
+      return 1;
+    }
+  }
+
+  {
+    std::string signature;
+    std::string error;
+    const bool ok = ai_trade::BybitRestClient::BuildV5Signature(
+        "test-secret",
+        "1700000000000",
+        "test-key",
+        "5000",
+        "category=linear&symbol=BTCUSDT",
+        &signature,
+        &error);
+    if (!ok || signature.size() != 64) {
+      std::cerr << "Bybit V5 签名生成失败: " << error << "\n";
+      return 1;
+    }
+    for (char ch : signature) {
+      if (std::isxdigit(static_cast<unsigned char>(ch)) == 0) {
+        std::cerr << "Bybit V5 签名格式不符合预期\n";
+        return 1;
+      }
+    }
+  }
+
+  {
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "replay";
+    options.allow_no_auth_in_replay = true;
+    options.symbols = {"BTCUSDT", "ETHUSDT"};
+    options.replay_prices = {100.0, 101.0, 102.0, 103.0};
+    options.replay_entry_fee_bps = 10.0;
+    options.replay_expected_slippage_bps = 5.0;
+    options.remote_account_mode = ai_trade::AccountMode::kUnified;
+    options.remote_margin_mode = ai_trade::MarginMode::kPortfolio;
+    options.remote_position_mode = ai_trade::PositionMode::kHedge;
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit 回放占位连接失败\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent e1;
+    ai_trade::MarketEvent e2;
+    if (!adapter.PollMarket(&e1) || !adapter.PollMarket(&e2)) {
+      std::cerr << "bybit 回放行情拉取失败\n";
+      return 1;
+    }
+    if (e1.symbol == e2.symbol) {
+      std::cerr << "bybit 回放行情应支持多币种轮询\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent intent;
+    intent.client_order_id = "bybit-replay-order-1";
+    intent.symbol = e1.symbol;
+    intent.direction = 1;
+    intent.qty = 2.0;
+    intent.price = e1.price;
+    // maker_entry_enabled=false 时 live 会实际走 Market/Taker，replay 需同口径计费。
+    intent.liquidity_preference = ai_trade::LiquidityPreference::kMaker;
+    if (!adapter.SubmitOrder(intent)) {
+      std::cerr << "bybit 回放下单失败\n";
+      return 1;
+    }
+    ai_trade::FillEvent fill;
+    int fill_count = 0;
+    double replay_fee = 0.0;
+    while (adapter.PollFill(&fill)) {
+      ++fill_count;
+      replay_fee += fill.fee;
+      if (fill.liquidity != ai_trade::FillLiquidity::kTaker ||
+          !NearlyEqual(fill.price, 100.05, 1e-9)) {
+        std::cerr << "bybit 回放成交应带 taker 滑点和流动性标记\n";
+        return 1;
+      }
+    }
+    if (fill_count < 1) {
+      std::cerr << "bybit 回放预期至少一笔成交\n";
+      return 1;
+    }
+    if (!NearlyEqual(replay_fee, 0.2001, 1e-9)) {
+      std::cerr << "bybit 回放成交手续费不符合预期，实际 " << replay_fee
+                << "\n";
+      return 1;
+    }
+    double remote_notional = 0.0;
+    if (!adapter.GetRemoteNotionalUsd(&remote_notional)) {
+      std::cerr << "bybit 回放远端仓位读取失败\n";
+      return 1;
+    }
+    if (!NearlyEqual(remote_notional, 200.0)) {
+      std::cerr << "bybit 回放远端名义仓位不符合预期，实际 "
+                << remote_notional << "\n";
+      return 1;
+    }
+
+    ai_trade::ExchangeAccountSnapshot snapshot;
+    if (!adapter.GetAccountSnapshot(&snapshot)) {
+      std::cerr << "bybit 账户快照读取失败\n";
+      return 1;
+    }
+    if (snapshot.account_mode != ai_trade::AccountMode::kUnified ||
+        snapshot.margin_mode != ai_trade::MarginMode::kPortfolio ||
+        snapshot.position_mode != ai_trade::PositionMode::kHedge) {
+      std::cerr << "bybit 账户快照字段不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "replay";
+    options.allow_no_auth_in_replay = true;
+    options.symbols = {"BTCUSDT"};
+    options.replay_prices = {100.0, 98.0};
+    options.replay_exit_fee_bps = 10.0;
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit 回放保护单连接失败\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent first;
+    if (!adapter.PollMarket(&first)) {
+      std::cerr << "bybit 回放保护单首条行情失败\n";
+      return 1;
+    }
+
+    ai_trade::OrderIntent entry;
+    entry.client_order_id = "bybit-replay-protection-entry";
+    entry.symbol = "BTCUSDT";
+    entry.purpose = ai_trade::OrderPurpose::kEntry;
+    entry.direction = 1;
+    entry.qty = 1.0;
+    entry.price = first.price;
+    if (!adapter.SubmitOrder(entry)) {
+      std::cerr << "bybit 回放保护单入场失败\n";
+      return 1;
+    }
+    ai_trade::FillEvent fill;
+    while (adapter.PollFill(&fill)) {
+    }
+
+    ai_trade::OrderIntent stop_loss;
+    stop_loss.client_order_id = "bybit-replay-protection-sl";
+    stop_loss.parent_order_id = entry.client_order_id;
+    stop_loss.symbol = "BTCUSDT";
+    stop_loss.purpose = ai_trade::OrderPurpose::kSl;
+    stop_loss.reduce_only = true;
+    stop_loss.direction = -1;
+    stop_loss.qty = 1.0;
+    stop_loss.price = 99.0;
+    if (!adapter.SubmitOrder(stop_loss)) {
+      std::cerr << "bybit 回放保护单提交失败\n";
+      return 1;
+    }
+    if (adapter.PollFill(&fill)) {
+      std::cerr << "bybit 回放保护单不应提交即成交\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent second;
+    if (!adapter.PollMarket(&second)) {
+      std::cerr << "bybit 回放保护单触发行情失败\n";
+      return 1;
+    }
+    int protection_fills = 0;
+    double protection_fee = 0.0;
+    while (adapter.PollFill(&fill)) {
+      ++protection_fills;
+      protection_fee += fill.fee;
+      if (fill.client_order_id != stop_loss.client_order_id ||
+          fill.direction != -1 ||
+          !NearlyEqual(fill.price, 99.0, 1e-9)) {
+        std::cerr << "bybit 回放保护单触发成交字段不符合预期\n";
+        return 1;
+      }
+    }
+    if (protection_fills != 2 || !NearlyEqual(protection_fee, 0.099, 1e-9)) {
+      std::cerr << "bybit 回放保护单触发成交数量或手续费不符合预期\n";
+      return 1;
+    }
+    double remote_notional = 0.0;
+    if (!adapter.GetRemoteNotionalUsd(&remote_notional) ||
+        !NearlyEqual(remote_notional, 0.0, 1e-9)) {
+      std::cerr << "bybit 回放保护单触发后仓位应归零\n";
+      return 1;
+    }
+  }
+
+  {
+    const std::filesystem::path replay_path =
+        std::filesystem::temp_directory_path() / "ai_trade_replay_market.csv";
+    {
+      std::ofstream out(replay_path);
+      out << "timestamp,symbol,price,volume,interval_ms,funding_rate_per_interval\n"
+          << "1700000000000,BTCUSDT,50000,12.5,300000,\n"
+          << "1700000300000,BTCUSDT,50120,10.0,300000,0.00001\n";
+    }
+    ai_trade::BybitAdapterOptions options;
+    options.mode = "replay";
+    options.allow_no_auth_in_replay = true;
+    options.symbols = {"BTCUSDT"};
+    options.replay_market_data_path = replay_path.string();
+    options.replay_price_column = "price";
+    options.replay_volume_column = "volume";
+    options.replay_timestamp_column = "timestamp";
+    options.replay_symbol_column = "symbol";
+    options.replay_interval_column = "interval_ms";
+    options.replay_funding_rate_column = "funding_rate_per_interval";
+    options.replay_default_interval_ms = 300000;
+
+    ai_trade::BybitExchangeAdapter adapter(options);
+    if (!adapter.Connect()) {
+      std::cerr << "bybit CSV replay 连接失败\n";
+      return 1;
+    }
+
+    ai_trade::MarketEvent first;
+    ai_trade::MarketEvent second;
+    if (!adapter.PollMarket(&first) || !adapter.PollMarket(&second)) {
+      std::cerr << "bybit CSV replay 行情拉取失败\n";
+      return 1;
+    }
+    if (!NearlyEqual(first.price, 50000.0) || !NearlyEqual(first.volume, 12.5) ||
+        first.interval_ms != 300000) {
+      std::cerr << "bybit CSV replay 第一条行情不符合预期\n";
+      return 1;
+    }
+    if (!NearlyEqual(second.price, 50120.0) || !NearlyEqual(second.volume, 10.0) ||
+        second.interval_ms != 300000 ||
+        !NearlyEqual(second.funding_rate_per_interval, 0.00001)) {
+      std::cerr << "bybit CSV replay 第二条行情不符合预期\n";
+      return 1;
+    }
+    std::filesystem::remove(replay_path);
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 2;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 3;
+    gate_config.window_ticks = 3;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    if (monitor.OnDecision(signal, adjusted, intent).has_value()) {
+      std::cerr << "首个无信号tick不应触发心跳告警\n";
+      return 1;
+    }
+    if (monitor.OnTick().has_value()) {
+      std::cerr << "窗口未结束不应返回 Gate 结果\n";
+      return 1;
+    }
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+
+    const auto heartbeat = monitor.OnDecision(signal, adjusted, intent);
+    if (!heartbeat.has_value() || *heartbeat != "WARN_SIGNAL_HEARTBEAT_GAP") {
+      std::cerr << "连续无有效信号未触发预期心跳告警\n";
+      return 1;
+    }
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || gate_result->pass) {
+      std::cerr << "预期 Gate 失败但未失败\n";
+      return 1;
+    }
+    if (gate_result->fail_reasons.size() != 2) {
+      std::cerr << "预期 Gate 失败原因包含信号与成交两个维度\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 2;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.suggested_notional_usd = 100.0;
+    signal.direction = 1;
+    ai_trade::RiskAdjustedPosition adjusted;
+    adjusted.adjusted_notional_usd = 100.0;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    ai_trade::FillEvent gate_fill;
+    gate_fill.fill_id = "gate-fill-1";
+    monitor.OnFill(gate_fill);
+    if (monitor.OnTick().has_value()) {
+      std::cerr << "窗口未结束不应返回 Gate 结果\n";
+      return 1;
+    }
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+
+    monitor.OnDecision(signal, adjusted, intent);
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || !gate_result->pass) {
+      std::cerr << "预期 Gate 通过但失败\n";
+      return 1;
+    }
+    if (gate_result->raw_signals != 3 ||
+        gate_result->order_intents != 0 ||
+        gate_result->effective_signals != 3 ||
+        gate_result->fills != 1) {
+      std::cerr << "Gate 统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 2;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    gate_config.allow_policy_flat_windows = true;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.reason_mask =
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrRangeConfidenceBlock) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrFlatSignal) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kRegRange);
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || !gate_result->pass ||
+        !gate_result->policy_flat_pass) {
+      std::cerr << "预期 Gate 以 policy-flat 方式通过但失败\n";
+      return 1;
+    }
+    if (gate_result->policy_flat_signals != 3 ||
+        !gate_result->fail_reasons.empty()) {
+      std::cerr << "policy-flat Gate 统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 2;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    gate_config.allow_policy_flat_windows = true;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.reason_mask =
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrFlatSignal) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kRegRange);
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || !gate_result->pass ||
+        !gate_result->policy_flat_pass) {
+      std::cerr << "预期 RANGE silent flat 也应作为 policy-flat 通过\n";
+      return 1;
+    }
+    if (gate_result->policy_flat_signals != 3 ||
+        !gate_result->fail_reasons.empty()) {
+      std::cerr << "RANGE silent flat policy-flat 统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 3;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    gate_config.allow_policy_flat_windows = true;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.reason_mask =
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrRangeConfidenceBlock) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrFlatSignal) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kRegRange);
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || gate_result->pass ||
+        gate_result->policy_flat_pass ||
+        !gate_result->policy_flat_runtime_exempt) {
+      std::cerr << "预期 Gate 为 policy-flat 部分窗口失败但应豁免 runtime 动作\n";
+      return 1;
+    }
+    if (gate_result->policy_flat_signals != 2 ||
+        gate_result->fail_reasons.size() != 2) {
+      std::cerr << "policy-flat 部分窗口统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 3;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    gate_config.allow_policy_flat_windows = true;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.reason_mask =
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrFlatSignal) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kRegExtreme);
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || gate_result->pass ||
+        gate_result->policy_flat_pass ||
+        !gate_result->policy_flat_runtime_exempt) {
+      std::cerr << "预期 EXTREME silent flat 部分窗口失败但应豁免 runtime 动作\n";
+      return 1;
+    }
+    if (gate_result->policy_flat_signals != 2 ||
+        gate_result->fail_reasons.size() != 2) {
+      std::cerr << "EXTREME silent flat policy-flat 统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::GateConfig gate_config;
+    gate_config.min_effective_signals_per_window = 2;
+    gate_config.min_fills_per_window = 1;
+    gate_config.heartbeat_empty_signal_ticks = 10;
+    gate_config.window_ticks = 3;
+    gate_config.allow_policy_flat_windows = true;
+    ai_trade::GateMonitor monitor(gate_config);
+
+    ai_trade::Signal signal;
+    signal.trend_notional_usd = 120.0;
+    signal.defensive_notional_usd = -120.0;
+    signal.reason_mask =
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kStrFlatSignal) |
+        ai_trade::ReasonBit(ai_trade::ReasonCode::kRegRange);
+    ai_trade::RiskAdjustedPosition adjusted;
+    std::optional<ai_trade::OrderIntent> intent;
+
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    monitor.OnDecision(signal, adjusted, intent);
+    monitor.OnTick();
+    const auto gate_result = monitor.OnTick();
+    if (!gate_result.has_value() || gate_result->pass ||
+        gate_result->policy_flat_pass ||
+        gate_result->policy_flat_runtime_exempt) {
+      std::cerr << "预期分支互相抵消的净 flat 不应计作 policy-flat\n";
+      return 1;
+    }
+    if (gate_result->policy_flat_signals != 0 ||
+        gate_result->fail_reasons.size() != 2) {
+      std::cerr << "净额抵消场景的 Gate 统计结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 2;
+    config.ewma_alpha = 1.0;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.010;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.price = 100.0;
+
+    const auto s1 = engine.OnMarket(event);
+    if (!s1.warmup || s1.regime != ai_trade::Regime::kRange) {
+      std::cerr << "Regime warmup 判定不符合预期\n";
+      return 1;
+    }
+
+    event.price = 100.3;  // +0.3%
+    const auto s2 = engine.OnMarket(event);
+    if (s2.warmup || s2.regime != ai_trade::Regime::kUptrend ||
+        s2.bucket != ai_trade::RegimeBucket::kTrend) {
+      std::cerr << "Regime 趋势判定不符合预期\n";
+      return 1;
+    }
+
+    event.price = 98.9;  // -1.39%，触发 extreme
+    const auto s3 = engine.OnMarket(event);
+    if (s3.regime != ai_trade::Regime::kExtreme ||
+        s3.bucket != ai_trade::RegimeBucket::kExtreme) {
+      std::cerr << "Regime 极端判定不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 1;
+    config.ewma_alpha = 1.0;
+    config.switch_confirm_ticks = 3;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.050;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "ETHUSDT";
+    event.price = 100.0;
+    (void)engine.OnMarket(event);  // warmup
+
+    event.price = 100.3;  // uptrend
+    const auto up = engine.OnMarket(event);
+    if (up.regime != ai_trade::Regime::kUptrend) {
+      std::cerr << "Regime 初始确认态应进入上升趋势\n";
+      return 1;
+    }
+
+    event.price = 100.0;  // downtrend pending #1
+    const auto pending_1 = engine.OnMarket(event);
+    event.price = 99.7;   // downtrend pending #2
+    const auto pending_2 = engine.OnMarket(event);
+    if (pending_1.regime != ai_trade::Regime::kUptrend ||
+        pending_2.regime != ai_trade::Regime::kUptrend) {
+      std::cerr << "Regime 切换确认期内应保持已确认状态\n";
+      return 1;
+    }
+
+    event.price = 99.4;  // downtrend pending #3 -> switch
+    const auto switched = engine.OnMarket(event);
+    if (switched.regime != ai_trade::Regime::kDowntrend ||
+        switched.bucket != ai_trade::RegimeBucket::kTrend) {
+      std::cerr << "Regime 连续确认达到阈值后应完成切换\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 1;
+    config.ewma_alpha = 1.0;
+    config.bar_interval_ms = 5000;
+    config.switch_confirm_ticks = 5;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.050;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.interval_ms = 5000;
+    event.price = 100.0;
+    (void)engine.OnMarket(event);  // warmup
+
+    event.price = 100.01;
+    const auto baseline = engine.OnMarket(event);
+    if (baseline.warmup || baseline.regime != ai_trade::Regime::kRange) {
+      std::cerr << "Regime 时间确认测试的基准态应先维持 RANGE\n";
+      return 1;
+    }
+
+    event.price = 100.25;
+    event.interval_ms = 30000;
+    const auto switched = engine.OnMarket(event);
+    if (switched.regime != ai_trade::Regime::kUptrend ||
+        switched.bucket != ai_trade::RegimeBucket::kTrend) {
+      std::cerr << "Regime 应在长间隔样本下按真实时间完成确认切换\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 1;
+    config.ewma_alpha = 1.0;
+    config.switch_confirm_ticks = 1;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.010;
+    config.volatility_threshold = 0.020;
+    config.extreme_requires_both = true;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "SOLUSDT";
+    event.price = 100.0;
+    (void)engine.OnMarket(event);  // warmup
+
+    // jump 命中但 vol 未命中：在 requires_both=true 下不应进入 EXTREME。
+    event.price = 101.2;  // +1.2%
+    const auto jump_only = engine.OnMarket(event);
+    if (jump_only.regime == ai_trade::Regime::kExtreme) {
+      std::cerr << "extreme_requires_both=true 时 jump-only 不应触发 EXTREME\n";
+      return 1;
+    }
+
+    // jump 与 vol 同时命中：应进入 EXTREME。
+    event.price = 103.5;  // +2.27%
+    const auto both_hit = engine.OnMarket(event);
+    if (both_hit.regime != ai_trade::Regime::kExtreme) {
+      std::cerr << "extreme_requires_both=true 时双命中应触发 EXTREME\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 3;
+    config.ewma_alpha = 0.2;
+    config.switch_confirm_ticks = 1;
+    config.trend_threshold = 0.10;
+    config.extreme_threshold = 0.20;
+    config.volatility_threshold = 0.20;
+    config.extreme_requires_both = true;
+    config.volume_extreme_multiplier = 4.0;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.price = 100.0;
+    event.volume = 100.0;
+    (void)engine.OnMarket(event);  // warmup #1
+
+    event.price = 100.01;
+    event.volume = 100.0;
+    const auto warmup_2 = engine.OnMarket(event);  // warmup #2
+    if (!warmup_2.warmup) {
+      std::cerr << "volume extreme 测试中 warmup #2 应仍处于预热\n";
+      return 1;
+    }
+
+    event.price = 100.02;
+    event.volume = 100.0;
+    const auto baseline = engine.OnMarket(event);  // warmup 结束
+    if (baseline.regime == ai_trade::Regime::kExtreme) {
+      std::cerr << "volume extreme 基准样本不应触发 EXTREME\n";
+      return 1;
+    }
+
+    event.price = 100.03;
+    event.volume = 1000.0;
+    const auto volume_spike = engine.OnMarket(event);
+    if (volume_spike.regime != ai_trade::Regime::kExtreme ||
+        volume_spike.bucket != ai_trade::RegimeBucket::kExtreme) {
+      std::cerr << "volume_extreme_multiplier 命中时应触发 EXTREME\n";
+      return 1;
+    }
+  }
+
+  {
+    const std::filesystem::path cfg_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_regime_valid.yaml";
+    std::ofstream out(cfg_path);
+    out << "regime:\n"
+        << "  enabled: true\n"
+        << "  warmup_ticks: 12\n"
+        << "  ewma_alpha: 0.25\n"
+        << "  bar_interval_ms: 5000\n"
+        << "  switch_confirm_ticks: 4\n"
+        << "  extreme_requires_both: true\n"
+        << "  volume_extreme_multiplier: 5.0\n"
+        << "  trend_threshold: 0.0012\n"
+        << "  extreme_threshold: 0.006\n"
+        << "  volatility_threshold: 0.0025\n";
+    out.close();
+
+    ai_trade::AppConfig config;
+    std::string error;
+    if (!ai_trade::LoadAppConfigFromYaml(cfg_path.string(), &config, &error)) {
+      std::cerr << "Regime 配置解析失败: " << error << "\n";
+      return 1;
+    }
+    if (!config.regime.enabled || config.regime.warmup_ticks != 12 ||
+        !NearlyEqual(config.regime.ewma_alpha, 0.25) ||
+        config.regime.bar_interval_ms != 5000 ||
+        config.regime.switch_confirm_ticks != 4 ||
+        config.regime.extreme_requires_both != true ||
+        !NearlyEqual(config.regime.volume_extreme_multiplier, 5.0) ||
+        !NearlyEqual(config.regime.trend_threshold, 0.0012) ||
+        !NearlyEqual(config.regime.extreme_threshold, 0.006) ||
+        !NearlyEqual(config.regime.volatility_threshold, 0.0025)) {
+      std::cerr << "Regime 配置解析结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 1;
+    config.ewma_alpha = 1.0;
+    config.bar_interval_ms = 5000;
+    config.switch_confirm_ticks = 1;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.050;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.interval_ms = 1000;
+
+    event.price = 100.0;
+    for (int i = 0; i < 4; ++i) {
+      const auto pending = engine.OnMarket(event);
+      if (!pending.warmup || pending.decision_interval_ms != 0 ||
+          pending.aggregated_event_count != 0) {
+        std::cerr << "bar_interval_ms 聚合前不应提前输出决策样本\n";
+        return 1;
+      }
+      event.price += 0.1;
+    }
+
+    const auto seeded = engine.OnMarket(event);
+    if (!seeded.warmup || seeded.decision_interval_ms != 5000 ||
+        seeded.aggregated_event_count != 5) {
+      std::cerr << "bar_interval_ms 首个聚合样本应作为 warmup 基准输出\n";
+      return 1;
+    }
+
+    event.price += 0.1;
+    for (int i = 0; i < 4; ++i) {
+      const auto held = engine.OnMarket(event);
+      if (!held.warmup || held.decision_interval_ms != 5000 ||
+          held.aggregated_event_count != 5) {
+        std::cerr << "bar_interval_ms 未满窗口时应保持最近一次聚合状态\n";
+        return 1;
+      }
+      event.price += 0.1;
+    }
+
+    const auto trend = engine.OnMarket(event);
+    if (trend.warmup || trend.regime != ai_trade::Regime::kUptrend ||
+        trend.bucket != ai_trade::RegimeBucket::kTrend ||
+        trend.decision_interval_ms != 5000 ||
+        trend.aggregated_event_count != 5) {
+      std::cerr << "bar_interval_ms 聚合后应按 5s 样本触发趋势判定\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 2;
+    config.ewma_alpha = 1.0;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.010;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.price = 100.0;
+    (void)engine.OnMarket(event);
+
+    event.price = 100.06;  // +0.06%，达到趋势门槛 60%，但不进入 TREND。
+    const auto candidate = engine.OnMarket(event);
+    if (candidate.warmup || candidate.bucket != ai_trade::RegimeBucket::kRange ||
+        !candidate.trend_candidate ||
+        !NearlyEqual(candidate.trend_threshold_ratio, 0.6)) {
+      std::cerr << "Regime TREND_CANDIDATE 诊断不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    ai_trade::RegimeConfig config;
+    config.enabled = true;
+    config.warmup_ticks = 3;
+    config.ewma_alpha = 1.0;
+    config.trend_threshold = 0.001;
+    config.extreme_threshold = 0.010;
+    config.volatility_threshold = 0.050;
+
+    ai_trade::RegimeEngine engine(config);
+    ai_trade::MarketEvent event;
+    event.symbol = "BTCUSDT";
+    event.price = 100.0;
+    (void)engine.OnMarket(event);
+
+    event.price = 100.06;
+    const auto warmup_candidate = engine.OnMarket(event);
+    if (!warmup_candidate.warmup ||
+        warmup_candidate.bucket != ai_trade::RegimeBucket::kRange ||
+        warmup_candidate.trend_candidate ||
+        !warmup_candidate.warmup_trend_candidate ||
+        !NearlyEqual(warmup_candidate.trend_threshold_ratio, 0.6)) {
+      std::cerr << "Regime warmup TREND_CANDIDATE 诊断不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    const std::filesystem::path cfg_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_regime_invalid.yaml";
+    std::ofstream out(cfg_path);
+    out << "regime:\n"
+        << "  ewma_alpha: 0\n";
+    out.close();
+
+    ai_trade::AppConfig config;
+    std::string error;
+    if (ai_trade::LoadAppConfigFromYaml(cfg_path.string(), &config, &error)) {
+      std::cerr << "非法 regime.ewma_alpha 配置应加载失败\n";
+      return 1;
+    }
+    if (error.find("regime.ewma_alpha") == std::string::npos) {
+      std::cerr << "非法 regime.ewma_alpha 错误信息不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    const std::vector<double> series{1.0, 2.0, 3.0, 4.0, 5.0};
+    const std::vector<double> delayed = ai_trade::research::TsDelay(series, 2);
+    if (!std::isnan(delayed[0]) || !std::isnan(delayed[1]) ||
+        !NearlyEqual(delayed[2], 1.0) || !NearlyEqual(delayed[4], 3.0)) {
+      std::cerr << "TsDelay 结果不符合预期\n";
+      return 1;
+    }
+
+    const std::vector<double> delta = ai_trade::research::TsDelta(series, 2);
+    if (!std::isnan(delta[0]) || !std::isnan(delta[1]) ||
+        !NearlyEqual(delta[2], 2.0) || !NearlyEqual(delta[4], 2.0)) {
+      std::cerr << "TsDelta 结果不符合预期\n";
+      return 1;
+    }
+
+    const std::vector<double> rank = ai_trade::research::TsRank(series, 3);
+    if (!std::isnan(rank[0]) || !std::isnan(rank[1]) ||
+        !NearlyEqual(rank[2], (2.0 + 0.5) / 3.0) ||
+        !NearlyEqual(rank[4], (2.0 + 0.5) / 3.0)) {
+      std::cerr << "TsRank 结果不符合预期\n";
+      return 1;
+    }
+
+    const std::vector<double> y{2.0, 4.0, 6.0, 8.0, 10.0};
+    const std::vector<double> corr = ai_trade::research::TsCorr(series, y, 3);
+    if (!std::isnan(corr[0]) || !std::isnan(corr[1]) ||
+        !NearlyEqual(corr[2], 1.0) || !NearlyEqual(corr[4], 1.0)) {
+      std::cerr << "TsCorr 结果不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    // 增量滑窗 TsRank/TsCorr 与逐窗口暴力重算必须一致（含 NaN 窗口）
+    std::vector<double> xs;
+    std::vector<double> ys;
+    unsigned int lcg = 20240521U;
+    const auto next_value = [&lcg]() {
+      lcg = lcg * 1664525U + 1013904223U;
+      return static_cast<double>(lcg % 1000U) / 17.0 - 25.0;
+    };
+    for (int i = 0; i < 400; ++i) {
+      xs.push_back(next_value());
+      ys.push_back(0.3 * xs.back() + next_value());
+    }
+    // 注入少量 NaN 验证失效窗口的进入/离开路径
+    xs[57] = std::numeric_limits<double>::quiet_NaN();
+    ys[211] = std::numeric_limits<double>::quiet_NaN();
+    // 注入重复值验证 tie-aware 排名
+    xs[120] = xs[121] = xs[122];
+
+    const int window = 17;
+    const std::vector<double> rank = ai_trade::research::TsRank(xs, window);
+    const std::vector<double> corr = ai_trade::research::TsCorr(xs, ys, window);
+    for (size_t end = static_cast<size_t>(window) - 1; end < xs.size(); ++end) {
+      const size_t begin = end + 1 - static_cast<size_t>(window);
+      bool valid = true;
+      for (size_t i = begin; i <= end; ++i) {
+        if (!std::isfinite(xs[i]) || !std::isfinite(ys[i])) {
+          valid = false;
+          break;
+        }
+      }
+      if (!valid) {
+        if (std::isfinite(rank[end]) &&
+            std::isfinite(xs[end])) {  // rank 只看 xs
+          bool xs_valid = true;
+          for (size_t i = begin; i <= end; ++i) {
+            if (!std::isfinite(xs[i])) {
+              xs_valid = false;
+              break;
+            }
+          }
+          if (!xs_valid) {
+            std::cerr << "TsRank 失效窗口应返回 NaN, end=" << end << "\n";
+            return 1;
+          }
+        }
+        if (std::isfinite(corr[end])) {
+          std::cerr << "TsCorr 失效窗口应返回 NaN, end=" << end << "\n";
+          return 1;
+        }
+        continue;
+      }
+      // 暴力重算 rank
+      int less = 0;
+      int equal = 0;
+      for (size_t i = begin; i <= end; ++i) {
+        if (xs[i] < xs[end]) {
+          ++less;
+        } else if (xs[i] == xs[end]) {
+          ++equal;
+        }
+      }
+      const double expected_rank =
+          (static_cast<double>(less) + 0.5 * static_cast<double>(equal)) /
+          static_cast<double>(window);
+      if (!NearlyEqual(rank[end], expected_rank, 1e-9)) {
+        std::cerr << "TsRank 增量结果与暴力重算不一致, end=" << end << "\n";
+        return 1;
+      }
+      // 暴力重算 corr（两遍中心化）
+      double mean_x = 0.0;
+      double mean_y = 0.0;
+      for (size_t i = begin; i <= end; ++i) {
+        mean_x += xs[i];
+        mean_y += ys[i];
+      }
+      mean_x /= window;
+      mean_y /= window;
+      double cov = 0.0;
+      double var_x = 0.0;
+      double var_y = 0.0;
+      for (size_t i = begin; i <= end; ++i) {
+        cov += (xs[i] - mean_x) * (ys[i] - mean_y);
+        var_x += (xs[i] - mean_x) * (xs[i] - mean_x);
+        var_y += (ys[i] - mean_y) * (ys[i] - mean_y);
+      }
+      if (var_x <= 0.0 || var_y <= 0.0) {
+        continue;
+      }
+      const double expected_corr = cov / std::sqrt(var_x * var_y);
+      if (!NearlyEqual(corr[end], expected_corr, 1e-8)) {
+        std::cerr << "TsCorr 增量结果与暴力重算不一致, end=" << end << "\n";
+        return 1;
+      }
+    }
+  }
+
+  {
+    // 滚动 min/max/sum/std/zscore 与逐窗口暴力重算必须一致（含 NaN 窗口）
+    std::vector<double> xs;
+    unsigned int lcg = 20250611U;
+    const auto next_value = [&lcg]() {
+      lcg = lcg * 1664525U + 1013904223U;
+      return static_cast<double>(lcg % 1000U) / 13.0 - 38.0;
+    };
+    for (int i = 0; i < 300; ++i) {
+      xs.push_back(next_value());
+    }
+    xs[44] = std::numeric_limits<double>::quiet_NaN();
+    xs[180] = xs[181] = xs[182];  // 重复值覆盖单调队列的等值弹出
+
+    const int window = 11;
+    const std::vector<double> mins = ai_trade::research::TsMin(xs, window);
+    const std::vector<double> maxs = ai_trade::research::TsMax(xs, window);
+    const std::vector<double> sums = ai_trade::research::TsSum(xs, window);
+    const std::vector<double> stds = ai_trade::research::TsStd(xs, window);
+    const std::vector<double> zscores =
+        ai_trade::research::TsZscore(xs, window);
+    for (size_t i = 0; i + 1 < static_cast<size_t>(window); ++i) {
+      if (std::isfinite(mins[i]) || std::isfinite(maxs[i]) ||
+          std::isfinite(sums[i]) || std::isfinite(stds[i]) ||
+          std::isfinite(zscores[i])) {
+        std::cerr << "滚动统计算子窗口未满时应返回 NaN\n";
+        return 1;
+      }
+    }
+    for (size_t end = static_cast<size_t>(window) - 1; end < xs.size(); ++end) {
+      const size_t begin = end + 1 - static_cast<size_t>(window);
+      bool valid = true;
+      double sum = 0.0;
+      double min_value = xs[begin];
+      double max_value = xs[begin];
+      for (size_t i = begin; i <= end; ++i) {
+        if (!std::isfinite(xs[i])) {
+          valid = false;
+          break;
+        }
+        sum += xs[i];
+        min_value = std::min(min_value, xs[i]);
+        max_value = std::max(max_value, xs[i]);
+      }
+      if (!valid) {
+        if (std::isfinite(mins[end]) || std::isfinite(maxs[end]) ||
+            std::isfinite(sums[end]) || std::isfinite(stds[end]) ||
+            std::isfinite(zscores[end])) {
+          std::cerr << "滚动统计算子失效窗口应返回 NaN, end=" << end << "\n";
+          return 1;
+        }
+        continue;
+      }
+      const double mean = sum / window;
+      double var = 0.0;
+      for (size_t i = begin; i <= end; ++i) {
+        var += (xs[i] - mean) * (xs[i] - mean);
+      }
+      var /= window;
+      const double expected_std = std::sqrt(var);
+      const double expected_z =
+          var > 0.0 ? (xs[end] - mean) / expected_std
+                    : std::numeric_limits<double>::quiet_NaN();
+      if (!NearlyEqual(mins[end], min_value, 1e-9) ||
+          !NearlyEqual(maxs[end], max_value, 1e-9) ||
+          !NearlyEqual(sums[end], sum, 1e-8) ||
+          !NearlyEqual(stds[end], expected_std, 1e-8)) {
+        std::cerr << "滚动统计算子与暴力重算不一致, end=" << end << "\n";
+        return 1;
+      }
+      const bool z_both_nan =
+          !std::isfinite(zscores[end]) && !std::isfinite(expected_z);
+      if (!z_both_nan && !NearlyEqual(zscores[end], expected_z, 1e-8)) {
+        std::cerr << "TsZscore 与暴力重算不一致, end=" << end << "\n";
+        return 1;
+      }
+    }
+
+    // 新算子必须可通过表达式文法求值（与直接调用算子一致）
+    ai_trade::research::OnlineFeatureEngine engine(50);
+    for (int i = 0; i < 30; ++i) {
+      ai_trade::MarketEvent event;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + std::sin(static_cast<double>(i) * 0.4) * 6.0;
+      event.volume = 1000.0 + static_cast<double>(i % 7) * 31.0;
+      engine.OnMarket(event);
+    }
+    const double range = engine.Evaluate("ts_max(close,10)-ts_min(close,10)");
+    const double zscore = engine.Evaluate("ts_zscore(close,10)");
+    const double mean_from_sum = engine.Evaluate("ts_sum(close,10)/10");
+    const double std_value = engine.Evaluate("ts_std(close,10)");
+    if (!std::isfinite(range) || range <= 0.0 || !std::isfinite(zscore) ||
+        !std::isfinite(mean_from_sum) || !std::isfinite(std_value) ||
+        std_value < 0.0) {
+      std::cerr << "新滚动算子表达式求值失败\n";
+      return 1;
+    }
+  }
+
+  {
+    const std::vector<double> factor{1.0, 2.0, 3.0, 4.0, 5.0};
+    const std::vector<double> future{10.0, 20.0, 30.0, 40.0, 50.0};
+    const ai_trade::research::SpearmanIcResult ic =
+        ai_trade::research::ComputeSpearmanIC(factor, future);
+    if (ic.sample_count != 5 || !NearlyEqual(ic.ic, 1.0)) {
+      std::cerr << "Spearman IC 正相关计算不符合预期\n";
+      return 1;
+    }
+
+    const std::vector<double> reverse_future{50.0, 40.0, 30.0, 20.0, 10.0};
+    const ai_trade::research::SpearmanIcResult reverse_ic =
+        ai_trade::research::ComputeSpearmanIC(factor, reverse_future);
+    if (reverse_ic.sample_count != 5 || !NearlyEqual(reverse_ic.ic, -1.0)) {
+      std::cerr << "Spearman IC 负相关计算不符合预期\n";
+      return 1;
+    }
+  }
+
+  {
+    // 增量滚动 Spearman IC 必须与逐窗口基准 ComputeSpearmanIC 一致
+    std::vector<double> factor;
+    std::vector<double> future;
+    unsigned int lcg = 987654321U;
+    const auto next_value = [&lcg]() {
+      lcg = lcg * 1664525U + 1013904223U;
+      return static_cast<double>(lcg % 997U) / 31.0 - 16.0;
+    };
+    for (int i = 0; i < 300; ++i) {
+      factor.push_back(next_value());
+      future.push_back(0.4 * factor.back() + next_value());
+    }
+    factor[40] = std::numeric_limits<double>::quiet_NaN();
+    future[150] = std::numeric_limits<double>::quiet_NaN();
+    factor[200] = factor[201] = factor[202];  // 并列秩
+
+    const int window = 9;
+    const std::vector<double> rolling =
+        ai_trade::research::ComputeRollingSpearmanIC(factor, future, window);
+    if (rolling.size() != factor.size()) {
+      std::cerr << "滚动 Spearman IC 输出长度错误\n";
+      return 1;
+    }
+    for (size_t end = static_cast<size_t>(window) - 1; end < factor.size();
+         ++end) {
+      const size_t begin = end + 1 - static_cast<size_t>(window);
+      const std::vector<double> f_slice(factor.begin() + begin,
+                                        factor.begin() + end + 1);
+      const std::vector<double> r_slice(future.begin() + begin,
+                                        future.begin() + end + 1);
+      const ai_trade::research::SpearmanIcResult oracle =
+          ai_trade::research::ComputeSpearmanIC(f_slice, r_slice);
+      if (oracle.sample_count < 3) {
+        if (std::isfinite(rolling[end])) {
+          std::cerr << "滚动 Spearman IC 样本不足应为 NaN, end=" << end << "\n";
+          return 1;
+        }
+        continue;
+      }
+      if (!NearlyEqual(rolling[end], oracle.ic, 1e-9)) {
+        std::cerr << "滚动 Spearman IC 与基准不一致, end=" << end
+                  << " rolling=" << rolling[end] << " oracle=" << oracle.ic
+                  << "\n";
+        return 1;
+      }
+    }
+  }
+
+  {
+    // 模型运行时不可用时，canary 应显式降级为 shadow_unavailable，不得伪造打分。
+    const std::filesystem::path report_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_report_canary_applied.json";
+    std::string report_error;
+    if (!WriteIntegratorReportFile(report_path,
+                                   /*auc_mean=*/0.62,
+                                   /*delta_auc=*/0.03,
+                                   /*split_trained_count=*/5,
+                                   /*split_count=*/5,
+                                   &report_error)) {
+      std::cerr << report_error << "\n";
+      return 1;
+    }
+
+    ai_trade::IntegratorConfig integrator;
+    integrator.enabled = true;
+    integrator.mode = ai_trade::IntegratorMode::kShadow;
+    integrator.canary_notional_ratio = 0.35;
+    integrator.canary_confidence_threshold = 0.30;
+    integrator.canary_allow_countertrend = false;
+    integrator.shadow.enabled = true;
+    integrator.shadow.model_report_path = report_path.string();
+    integrator.shadow.model_path =
+        (std::filesystem::temp_directory_path() /
+         "ai_trade_test_integrator_model_missing_canary_1.cbm")
+            .string();
+    integrator.shadow.active_meta_path.clear();
+    integrator.shadow.score_gain = 1.0;
+
+    ai_trade::RegimeConfig regime_config;
+    regime_config.enabled = false;
+    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
+                                 /*max_order_notional_usd=*/1000.0,
+                                 ai_trade::RiskThresholds{},
+                                 ai_trade::StrategyConfig{},
+                                 /*min_rebalance_notional_usd=*/0.0,
+                                 regime_config,
+                                 integrator);
+    std::string init_error;
+    if (!system.InitializeIntegratorShadow(&init_error)) {
+      std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+      return 1;
+    }
+    system.SetIntegratorMode(ai_trade::IntegratorMode::kCanary);
+
+    (void)system.Evaluate(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
+    const auto decision =
+        system.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0}, true);
+    if (decision.integrator_policy_applied ||
+        decision.integrator_policy_reason != "shadow_unavailable") {
+      std::cerr << "canary 在模型不可用时应降级为 shadow_unavailable\n";
+      return 1;
+    }
+    if (!NearlyEqual(decision.base_signal.suggested_notional_usd,
+                     decision.signal.suggested_notional_usd,
+                     1e-9)) {
+      std::cerr << "canary 降级后不应修改原策略信号\n";
+      return 1;
+    }
+
+    std::filesystem::remove(report_path);
+  }
+
+  {
+    // 模型运行时不可用时，canary 不应触发 countertrend 逻辑，而应统一降级。
+    const std::filesystem::path report_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_report_canary_countertrend.json";
+    std::string report_error;
+    if (!WriteIntegratorReportFile(report_path,
+                                   /*auc_mean=*/0.62,
+                                   /*delta_auc=*/0.03,
+                                   /*split_trained_count=*/5,
+                                   /*split_count=*/5,
+                                   &report_error)) {
+      std::cerr << report_error << "\n";
+      return 1;
+    }
+
+    ai_trade::IntegratorConfig integrator;
+    integrator.enabled = true;
+    integrator.mode = ai_trade::IntegratorMode::kShadow;
+    integrator.canary_notional_ratio = 0.35;
+    integrator.canary_confidence_threshold = 0.30;
+    integrator.canary_allow_countertrend = false;
+    integrator.shadow.enabled = true;
+    integrator.shadow.model_report_path = report_path.string();
+    integrator.shadow.model_path =
+        (std::filesystem::temp_directory_path() /
+         "ai_trade_test_integrator_model_missing_canary_2.cbm")
+            .string();
+    integrator.shadow.active_meta_path.clear();
+    // 即使配置负增益，模型不可用时也不应执行伪造推理路径。
+    integrator.shadow.score_gain = -1.0;
+
+    ai_trade::RegimeConfig regime_config;
+    regime_config.enabled = false;
+    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
+                                 /*max_order_notional_usd=*/1000.0,
+                                 ai_trade::RiskThresholds{},
+                                 ai_trade::StrategyConfig{},
+                                 /*min_rebalance_notional_usd=*/0.0,
+                                 regime_config,
+                                 integrator);
+    std::string init_error;
+    if (!system.InitializeIntegratorShadow(&init_error)) {
+      std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+      return 1;
+    }
+    system.SetIntegratorMode(ai_trade::IntegratorMode::kCanary);
+
+    (void)system.Evaluate(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
+    const auto decision =
+        system.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0}, true);
+    if (decision.integrator_policy_applied ||
+        decision.integrator_policy_reason != "shadow_unavailable") {
+      std::cerr << "canary 模型不可用降级逻辑不符合预期\n";
+      return 1;
+    }
+    if (!NearlyEqual(decision.signal.suggested_notional_usd,
+                     decision.base_signal.suggested_notional_usd)) {
+      std::cerr << "canary 反向拦截后不应修改原策略信号\n";
+      return 1;
+    }
+
+    std::filesystem::remove(report_path);
+  }
+
+  {
+    // 原生对称树模型：Save/Load 往返 + 手算打分 + 损坏文件拒载。
+    const std::filesystem::path model_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_oblivious_tree_model.bin";
+
+    std::vector<ai_trade::ObliviousTreeModel::Tree> trees(2);
+    trees[0].feature_indices = {0, 2};
+    trees[0].borders = {0.5F, -1.0F};
+    trees[0].leaf_values = {1.0, 2.0, 4.0, 8.0};
+    trees[1].feature_indices = {1};
+    trees[1].borders = {10.0F};
+    trees[1].leaf_values = {-0.25, 0.75};
+
+    std::string model_error;
+    if (!ai_trade::ObliviousTreeModel::Save(/*feature_count=*/3, trees,
+                                            model_path.string(),
+                                            &model_error)) {
+      std::cerr << "原生模型写出失败: " << model_error << "\n";
+      return 1;
+    }
+
+    ai_trade::ObliviousTreeModel model;
+    if (!model.Load(model_path.string(), &model_error)) {
+      std::cerr << "原生模型加载失败: " << model_error << "\n";
+      return 1;
+    }
+    if (!model.loaded() || model.feature_count() != 3 ||
+        model.tree_count() != 2) {
+      std::cerr << "原生模型元数据不符合预期\n";
+      return 1;
+    }
+
+    // 树 0：f0>0.5 置位 bit0，f2>-1 置位 bit1；树 1：f1>10 置位 bit0。
+    const std::vector<float> row_a = {1.0F, 20.0F, 0.0F};  // 叶 3 + 叶 1
+    const std::vector<float> row_b = {0.0F, 5.0F, -2.0F};  // 叶 0 + 叶 0
+    const std::vector<float> row_c = {1.0F, 5.0F, -2.0F};  // 叶 1 + 叶 0
+    if (!NearlyEqual(model.Predict(row_a), 8.0 + 0.75) ||
+        !NearlyEqual(model.Predict(row_b), 1.0 + -0.25) ||
+        !NearlyEqual(model.Predict(row_c), 2.0 + -0.25)) {
+      std::cerr << "原生模型打分与手算结果不一致\n";
+      return 1;
+    }
+    // 行长度不足特征数时防御性返回 0，不得越界。
+    const std::vector<float> short_row = {1.0F};
+    if (!NearlyEqual(model.Predict(short_row), 0.0)) {
+      std::cerr << "原生模型对长度不足的行应返回 0\n";
+      return 1;
+    }
+
+    // 魔数损坏的文件必须拒载，且实例回到未加载状态。
+    {
+      std::fstream corrupt(model_path,
+                           std::ios::binary | std::ios::in | std::ios::out);
+      corrupt.seekp(0);
+      corrupt.write("BADMAGIC", 8);
+    }
+    std::string corrupt_error;
+    if (model.Load(model_path.string(), &corrupt_error) || model.loaded()) {
+      std::cerr << "损坏的原生模型文件不应加载成功\n";
+      return 1;
+    }
+    if (corrupt_error.empty()) {
+      std::cerr << "原生模型拒载时应产出错误信息\n";
+      return 1;
+    }
+
+    std::filesystem::remove(model_path);
+  }
+
+  {
+    // 线程拓扑：核号列表解析 + 实际绑核生效校验。
+    std::vector<int> cpus;
+    if (!ai_trade::ParseCpuList("0,2,4-6", &cpus) ||
+        cpus != std::vector<int>{0, 2, 4, 5, 6}) {
+      std::cerr << "核号列表解析结果不符合预期\n";
+      return 1;
+    }
+    if (ai_trade::ParseCpuList("abc", &cpus) ||
+        ai_trade::ParseCpuList("3-1", &cpus) ||
+        ai_trade::ParseCpuList("", &cpus)) {
+      std::cerr << "非法核号列表不应解析成功\n";
+      return 1;
+    }
+
+    // 未启用拓扑时 ApplyThreadRole 是空操作。
+    ai_trade::ConfigureThreadTopology(ai_trade::ThreadTopologyConfig{});
+    std::string realized;
+    if (!ai_trade::ApplyThreadRole(ai_trade::ThreadRole::kBackground,
+                                   &realized) ||
+        realized != "topology_disabled") {
+      std::cerr << "拓扑未启用时角色应用应为空操作\n";
+      return 1;
+    }
+
+    // 启用拓扑后在工作线程里领取绑核，并读回内核侧亲和性验证。
+    ai_trade::ThreadTopologyConfig topology;
+    topology.enabled = true;
+    topology.background_cpus = "0";
+    ai_trade::ConfigureThreadTopology(topology);
+    bool apply_ok = false;
+    bool affinity_ok = false;
+    std::string worker_realized;
+    std::thread worker([&] {
+      apply_ok = ai_trade::ApplyThreadRole(ai_trade::ThreadRole::kBackground,
+                                           &worker_realized);
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        affinity_ok = CPU_COUNT(&cpu_set) == 1 && CPU_ISSET(0, &cpu_set);
+      }
+    });
+    worker.join();
+    if (!apply_ok || !affinity_ok ||
+        worker_realized.find("cpus=0") == std::string::npos) {
+      std::cerr << "后台角色绑核未生效: realized=" << worker_realized << "\n";
+      return 1;
+    }
+
+    // 还原为未启用，避免影响后续测试派生的线程。
+    ai_trade::ConfigureThreadTopology(ai_trade::ThreadTopologyConfig{});
+  }
+
+  {
+    // 原生模型配置后，IntegratorShadow 无需 CatBoost 运行库即可打分。
+    const std::filesystem::path report_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_report_native_model.json";
+    {
+      // 带 feature_names 的报告：两个经典特征，与原生模型特征数对齐。
+      std::ofstream report(report_path);
+      report << "{\n"
+             << "  \"model_version\": \"integrator_native_v1_test\",\n"
+             << "  \"feature_names\": [\"ret_1\", \"ret_3\"],\n"
+             << "  \"metrics_oos\": {\n"
+             << "    \"auc_mean\": 0.62,\n"
+             << "    \"delta_auc_vs_baseline\": 0.03,\n"
+             << "    \"split_trained_count\": 5,\n"
+             << "    \"split_count\": 5\n"
+             << "  }\n"
+             << "}\n";
+      if (!report.good()) {
+        std::cerr << "无法写入原生模型测试报告\n";
+        return 1;
+      }
+    }
+
+    // 单棵树、阈值取极小：任意输入都落在同一叶，打分恒为 2.0。
+    const std::filesystem::path native_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_native_model.bin";
+    std::vector<ai_trade::ObliviousTreeModel::Tree> trees(1);
+    trees[0].feature_indices = {0};
+    trees[0].borders = {-1e9F};
+    trees[0].leaf_values = {2.0, 2.0};
+    std::string model_error;
+    if (!ai_trade::ObliviousTreeModel::Save(/*feature_count=*/2, trees,
+                                            native_path.string(),
+                                            &model_error)) {
+      std::cerr << "原生模型写出失败: " << model_error << "\n";
+      return 1;
+    }
+
+    ai_trade::IntegratorConfig integrator;
+    integrator.enabled = true;
+    integrator.mode = ai_trade::IntegratorMode::kShadow;
+    integrator.shadow.enabled = true;
+    integrator.shadow.model_report_path = report_path.string();
+    integrator.shadow.model_path.clear();
+    integrator.shadow.native_model_path = native_path.string();
+    integrator.shadow.active_meta_path.clear();
+    integrator.shadow.score_gain = 1.0;
+    integrator.shadow.feature_window_ticks = 8;
+
+    ai_trade::RegimeConfig regime_config;
+    regime_config.enabled = false;
+    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
+                                 /*max_order_notional_usd=*/1000.0,
+                                 ai_trade::RiskThresholds{},
+                                 ai_trade::StrategyConfig{},
+                                 /*min_rebalance_notional_usd=*/0.0,
+                                 regime_config,
+                                 integrator);
+    std::string init_error;
+    if (!system.InitializeIntegratorShadow(&init_error)) {
+      std::cerr << "原生模型路径下 Integrator 初始化应成功，错误: "
+                << init_error << "\n";
+      return 1;
+    }
+
+    bool saw_model_score = false;
+    for (int i = 0; i < 40; ++i) {
+      const double price = 100.0 + 0.1 * static_cast<double>(i);
+      const auto decision = system.Evaluate(
+          ai_trade::MarketEvent{static_cast<std::int64_t>(i + 1), "BTCUSDT",
+                                price, price},
+          true);
+      if (decision.shadow.enabled) {
+        if (!NearlyEqual(decision.shadow.model_score, 2.0, 1e-9) ||
+            !NearlyEqual(decision.shadow.p_up,
+                         1.0 / (1.0 + std::exp(-2.0)), 1e-9)) {
+          std::cerr << "原生模型打分不符合预期: "
+                    << decision.shadow.model_score << "\n";
+          return 1;
+        }
+        saw_model_score = true;
+      }
+    }
+    if (!saw_model_score) {
+      std::cerr << "原生模型路径下 shadow 推理应产出有效打分\n";
+      return 1;
+    }
+
+    std::filesystem::remove(report_path);
+    std::filesystem::remove(native_path);
+  }
+
+  {
+    // active：模型运行时不可用时应显式降级，不得执行线性缩放。
+    const std::filesystem::path report_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_report_active_policy.json";
+    std::string report_error;
+    if (!WriteIntegratorReportFile(report_path,
+                                   /*auc_mean=*/0.62,
+                                   /*delta_auc=*/0.03,
+                                   /*split_trained_count=*/5,
+                                   /*split_count=*/5,
+                                   &report_error)) {
+      std::cerr << report_error << "\n";
+      return 1;
+    }
+
+    ai_trade::RegimeConfig regime_config;
+    regime_config.enabled = false;
+
+    {
+      ai_trade::IntegratorConfig integrator_low;
+      integrator_low.enabled = true;
+      integrator_low.mode = ai_trade::IntegratorMode::kShadow;
+      integrator_low.active_confidence_threshold = 0.60;
+      integrator_low.shadow.enabled = true;
+      integrator_low.shadow.model_report_path = report_path.string();
+      integrator_low.shadow.model_path =
+          (std::filesystem::temp_directory_path() /
+           "ai_trade_test_integrator_model_missing_active_low.cbm")
+              .string();
+      integrator_low.shadow.active_meta_path.clear();
+      integrator_low.shadow.score_gain = 1.0;
+
+      ai_trade::TradeSystem system_low(/*risk_cap_usd=*/3000.0,
+                                       /*max_order_notional_usd=*/1000.0,
+                                       ai_trade::RiskThresholds{},
+                                       ai_trade::StrategyConfig{},
+                                       /*min_rebalance_notional_usd=*/0.0,
+                                       regime_config,
+                                       integrator_low);
+      std::string init_error;
+      if (!system_low.InitializeIntegratorShadow(&init_error)) {
+        std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+        return 1;
+      }
+      system_low.SetIntegratorMode(ai_trade::IntegratorMode::kActive);
+      (void)system_low.Evaluate(
+          ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
+      const auto decision_low =
+          system_low.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0},
+                              true);
+      if (decision_low.integrator_policy_applied ||
+          decision_low.integrator_policy_reason != "shadow_unavailable" ||
+          !NearlyEqual(decision_low.signal.suggested_notional_usd,
+                       decision_low.base_signal.suggested_notional_usd,
+                       1e-9)) {
+        std::cerr << "active 低置信在模型不可用时应降级\n";
+        return 1;
+      }
+    }
+
+    {
+      ai_trade::IntegratorConfig integrator_high;
+      integrator_high.enabled = true;
+      integrator_high.mode = ai_trade::IntegratorMode::kShadow;
+      integrator_high.active_confidence_threshold = 0.20;
+      integrator_high.shadow.enabled = true;
+      integrator_high.shadow.model_report_path = report_path.string();
+      integrator_high.shadow.model_path =
+          (std::filesystem::temp_directory_path() /
+           "ai_trade_test_integrator_model_missing_active_high.cbm")
+              .string();
+      integrator_high.shadow.active_meta_path.clear();
+      integrator_high.shadow.score_gain = 2.0;
+
+      ai_trade::TradeSystem system_high(/*risk_cap_usd=*/3000.0,
+                                        /*max_order_notional_usd=*/1000.0,
+                                        ai_trade::RiskThresholds{},
+                                        ai_trade::StrategyConfig{},
+                                        /*min_rebalance_notional_usd=*/0.0,
+                                        regime_config,
+                                        integrator_high);
+      std::string init_error;
+      if (!system_high.InitializeIntegratorShadow(&init_error)) {
+        std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+        return 1;
+      }
+      system_high.SetIntegratorMode(ai_trade::IntegratorMode::kActive);
+      (void)system_high.Evaluate(
+          ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
+      const auto decision_high =
+          system_high.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0},
+                               true);
+      if (decision_high.integrator_policy_applied ||
+          decision_high.integrator_policy_reason != "shadow_unavailable" ||
+          !NearlyEqual(decision_high.signal.suggested_notional_usd,
+                       decision_high.base_signal.suggested_notional_usd,
+                       1e-9)) {
+        std::cerr << "active 高置信在模型不可用时应降级\n";
+        return 1;
+      }
+    }
+
+    std::filesystem::remove(report_path);
+  }
+
+  {
+    // Integrator 报告声明未知经典特征时应初始化失败，避免静默退化为常数特征。
+    const std::filesystem::path report_path =
+        std::filesystem::temp_directory_path() /
+        "ai_trade_test_integrator_report_unknown_feature.json";
+    std::ofstream out(report_path);
+    if (!out.is_open()) {
+      std::cerr << "无法写入 integrator unknown feature 报告\n";
+      return 1;
+    }
+    out << "{\n"
+        << "  \"model_version\": \"integrator_cb_v1_test\",\n"
+        << "  \"feature_names\": [\"ret_1\", \"unknown_feature_x\"],\n"
+        << "  \"metrics_oos\": {\n"
+        << "    \"auc_mean\": 0.62,\n"
+        << "    \"delta_auc_vs_baseline\": 0.03,\n"
+        << "    \"split_trained_count\": 5,\n"
+        << "    \"split_count\": 5\n"
+        << "  }\n"
+        << "}\n";
+    out.close();
+
+    ai_trade::IntegratorConfig integrator;
+    integrator.enabled = true;
+    integrator.mode = ai_trade::IntegratorMode::kShadow;
+    integrator.shadow.enabled = true;
+    integrator.shadow.model_report_path = report_path.string();
+    integrator.shadow.model_path =
+        (std::filesystem::temp_directory_path() /
+         "ai_trade_test_integrator_model_missing_unknown_feature.cbm")
+            .string();
+    integrator.shadow.active_meta_path.clear();
+    integrator.shadow.require_model_file = false;
+    integrator.shadow.require_active_meta = false;
+    integrator.shadow.require_gate_pass = false;
+
+    ai_trade::RegimeConfig regime_config;
+    regime_config.enabled = false;
+    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
+                                 /*max_order_notional_usd=*/1000.0,
+                                 ai_trade::RiskThresholds{},
+                                 ai_trade::StrategyConfig{},
+                                 /*min_rebalance_notional_usd=*/0.0,
+                                 regime_config,
+                                 integrator);
+    std::string init_error;
+    if (system.InitializeIntegratorShadow(&init_error)) {
+      std::cerr << "包含未知特征名的 Integrator 报告应初始化失败\n";
+      return 1;
+    }
+    if (init_error.find("不受支持") == std::string::npos &&
+        init_error.find("缺失") == std::string::npos) {
+      std::cerr << "未知特征初始化失败错误信息不符合预期: " << init_error << "\n";
+      return 1;
+    }
+    std::filesystem::remove(report_path);
+  }
+
+  {
+    std::vector<ai_trade::research::ResearchBar> bars;
+    bars.reserve(220);
+    for (int i = 0; i < 220; ++i) {
+      ai_trade::research::ResearchBar bar;
+      bar.ts_ms = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 300'000LL;
+      bar.close = 100.0 + static_cast<double>(i) * 0.12 +
+                  std::sin(static_cast<double>(i) * 0.08) * 1.5;
+      bar.open = bar.close - 0.20;
+      bar.high = bar.close + 0.35;
+      bar.low = bar.close - 0.40;
+      bar.volume = 1200.0 + static_cast<double>(i % 11) * 23.0 +
+                   std::cos(static_cast<double>(i) * 0.05) * 40.0;
+      bars.push_back(bar);
+    }
+
+    ai_trade::research::MinerConfig config;
+    config.random_seed = 42;
+    config.top_k = 5;
+    config.train_split_ratio = 0.7;
+    config.complexity_penalty = 0.01;
+
+    ai_trade::research::Miner miner;
+    const ai_trade::research::MinerReport report_1 = miner.Run(bars, config);
+    const ai_trade::research::MinerReport report_2 = miner.Run(bars, config);
+
+    if (report_1.factors.size() != 5 || report_2.factors.size() != 5) {
+      std::cerr << "Miner TopK 结果数量不符合预期\n";
+      return 1;
+    }
+    if (report_1.random_seed != 42 ||
+        report_1.search_space_version.empty() ||
+        report_1.random_baseline_trials <= 0 ||
+        report_1.random_baseline_oos_abs_ic.sample_count <= 0) {
+      std::cerr << "Miner 报告元数据/随机基线统计不符合预期\n";
+      return 1;
+    }
+    if (!ai_trade::research::IsFinite(report_1.oos_random_baseline_threshold_p90) ||
+        report_1.oos_random_baseline_threshold_p90 < 0.0 ||
+        !ai_trade::research::IsFinite(report_1.top_factor_oos_abs_ic)) {
+      std::cerr << "Miner 随机基线阈值或 Top 因子 IC 非法\n";
+      return 1;
+    }
+    if (report_1.factor_set_version.empty() ||
+        report_1.factor_set_version != report_2.factor_set_version) {
+      std::cerr << "Miner 同种子复现性不符合预期\n";
+      return 1;
+    }
+    if (report_1.factors[0].expression != report_2.factors[0].expression) {
+      std::cerr << "Miner Top 因子复现性不符合预期\n";
+      return 1;
+    }
+    const auto has_delay =
+        std::any_of(report_1.candidate_expressions.begin(),
+                    report_1.candidate_expressions.end(),
+                    [](const std::string& expr) {
+                      return expr.find("ts_delay") != std::string::npos;
+                    });
+    const auto has_delta =
+        std::any_of(report_1.candidate_expressions.begin(),
+                    report_1.candidate_expressions.end(),
+                    [](const std::string& expr) {
+                      return expr.find("ts_delta") != std::string::npos;
+                    });
+    const auto has_rank =
+        std::any_of(report_1.candidate_expressions.begin(),
+                    report_1.candidate_expressions.end(),
+                    [](const std::string& expr) {
+                      return expr.find("ts_rank") != std::string::npos;
+                    });
+    const auto has_corr =
+        std::any_of(report_1.candidate_expressions.begin(),
+                    report_1.candidate_expressions.end(),
+                    [](const std::string& expr) {
+                      return expr.find("ts_corr") != std::string::npos;
+                    });
+    if (!has_delay || !has_delta || !has_rank || !has_corr) {
+      std::cerr << "Miner 候选因子未覆盖必需时序算子\n";
       return 1;
     }
-    if (gate_result->policy_flat_signals != 2 ||
-        gate_result->fail_reasons.size() != 2) {
-      std::cerr << "policy-flat 部分窗口统计结果不符合预期\n";
+    if (report_1.factors.front().search_space_version != "ts_ops_v1" ||
+        report_1.factors.front().valid_universe.empty() ||
+        report_1.factors.front().rolling_ic_oos.sample_count <= 0) {
+      std::cerr << "Miner 因子诊断字段不符合预期\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 3;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    gate_config.allow_policy_flat_windows = true;
-    ai_trade::GateMonitor monitor(gate_config);
-
-    ai_trade::Signal signal;
-    signal.reason_codes = {"STR_FLAT_SIGNAL", "REG_EXTREME"};
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
 
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || gate_result->pass ||
-        gate_result->policy_flat_pass ||
-        !gate_result->policy_flat_runtime_exempt) {
-      std::cerr << "预期 EXTREME silent flat 部分窗口失败但应豁免 runtime 动作\n";
+    // 列式存储往返 + Miner 列式入口与行式入口结果一致性
+    const std::filesystem::path columnar_path =
+        std::filesystem::temp_directory_path() / "ai_trade_test_bars.atcbar";
+    std::string store_error;
+    if (!ai_trade::research::SaveResearchBarsColumnar(
+            bars, columnar_path.string(), &store_error)) {
+      std::cerr << "列式存储写入失败: " << store_error << "\n";
       return 1;
     }
-    if (gate_result->policy_flat_signals != 2 ||
-        gate_result->fail_reasons.size() != 2) {
-      std::cerr << "EXTREME silent flat policy-flat 统计结果不符合预期\n";
+    ai_trade::research::ColumnarBarStore store;
+    if (!store.Open(columnar_path.string(), &store_error)) {
+      std::cerr << "列式存储打开失败: " << store_error << "\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::GateConfig gate_config;
-    gate_config.min_effective_signals_per_window = 2;
-    gate_config.min_fills_per_window = 1;
-    gate_config.heartbeat_empty_signal_ticks = 10;
-    gate_config.window_ticks = 3;
-    gate_config.allow_policy_flat_windows = true;
-    ai_trade::GateMonitor monitor(gate_config);
-
-    ai_trade::Signal signal;
-    signal.trend_notional_usd = 120.0;
-    signal.defensive_notional_usd = -120.0;
-    signal.reason_codes = {"STR_FLAT_SIGNAL", "REG_RANGE"};
-    ai_trade::RiskAdjustedPosition adjusted;
-    std::optional<ai_trade::OrderIntent> intent;
-
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    monitor.OnDecision(signal, adjusted, intent);
-    monitor.OnTick();
-    const auto gate_result = monitor.OnTick();
-    if (!gate_result.has_value() || gate_result->pass ||
-        gate_result->policy_flat_pass ||
-        gate_result->policy_flat_runtime_exempt) {
-      std::cerr << "预期分支互相抵消的净 flat 不应计作 policy-flat\n";
+    if (store.Count() != bars.size()) {
+      std::cerr << "列式存储样本数不符合预期\n";
       return 1;
     }
-    if (gate_result->policy_flat_signals != 0 ||
-        gate_result->fail_reasons.size() != 2) {
-      std::cerr << "净额抵消场景的 Gate 统计结果不符合预期\n";
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+      if (store.Timestamps()[i] != bars[i].ts_ms ||
+          !NearlyEqual(store.Opens()[i], bars[i].open) ||
+          !NearlyEqual(store.Highs()[i], bars[i].high) ||
+          !NearlyEqual(store.Lows()[i], bars[i].low) ||
+          !NearlyEqual(store.Closes()[i], bars[i].close) ||
+          !NearlyEqual(store.Volumes()[i], bars[i].volume)) {
+        std::cerr << "列式存储往返数据不一致，下标: " << i << "\n";
+        return 1;
+      }
+    }
+    const ai_trade::research::MinerReport report_columnar =
+        miner.Run(store, config);
+    if (report_columnar.factor_set_version != report_1.factor_set_version) {
+      std::cerr << "Miner 列式入口与行式入口结果不一致\n";
+      return 1;
+    }
+    store.Close();
+    std::filesystem::remove(columnar_path);
+
+    ai_trade::research::ColumnarBarStore bad_store;
+    if (bad_store.Open((columnar_path.string() + ".missing"), &store_error)) {
+      std::cerr << "不存在的列式文件应打开失败\n";
       return 1;
     }
   }
 
   {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 2;
-    config.ewma_alpha = 1.0;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.010;
-    config.volatility_threshold = 0.050;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.price = 100.0;
-
-    const auto s1 = engine.OnMarket(event);
-    if (!s1.warmup || s1.regime != ai_trade::Regime::kRange) {
-      std::cerr << "Regime warmup 判定不符合预期\n";
-      return 1;
+    // 原生特征构建器：列集合与 Python 版一致，行式/列式入口结果相同，
+    // 二进制落盘可无损读回。
+    std::vector<ai_trade::research::ResearchBar> bars;
+    bars.reserve(160);
+    for (int i = 0; i < 160; ++i) {
+      ai_trade::research::ResearchBar bar;
+      bar.ts_ms = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 300'000LL;
+      bar.close = 100.0 + static_cast<double>(i) * 0.10 +
+                  std::sin(static_cast<double>(i) * 0.30) * 0.8;
+      bar.open = bar.close - 0.10;
+      bar.high = bar.close + 0.30;
+      bar.low = bar.close - 0.30;
+      bar.volume = 1000.0 + static_cast<double>(i % 7) * 15.0;
+      bars.push_back(bar);
     }
 
-    event.price = 100.3;  // +0.3%
-    const auto s2 = engine.OnMarket(event);
-    if (s2.warmup || s2.regime != ai_trade::Regime::kUptrend ||
-        s2.bucket != ai_trade::RegimeBucket::kTrend) {
-      std::cerr << "Regime 趋势判定不符合预期\n";
+    ai_trade::research::FeatureBuildOptions options;
+    options.forward_bars = 12;
+    options.threads = 4;
+    ai_trade::research::FeatureMatrix matrix;
+    std::string feature_error;
+    if (!ai_trade::research::BuildFeatureMatrix(bars, options, &matrix,
+                                                &feature_error)) {
+      std::cerr << "特征矩阵构建失败: " << feature_error << "\n";
       return 1;
     }
-
-    event.price = 98.9;  // -1.39%，触发 extreme
-    const auto s3 = engine.OnMarket(event);
-    if (s3.regime != ai_trade::Regime::kExtreme ||
-        s3.bucket != ai_trade::RegimeBucket::kExtreme) {
-      std::cerr << "Regime 极端判定不符合预期\n";
+    if (matrix.column_names.size() != 36 || matrix.columns.size() != 35 ||
+        matrix.RowCount() != bars.size() ||
+        matrix.column_names.front() != "timestamp" ||
+        matrix.column_names.back() != "forward_return") {
+      std::cerr << "特征矩阵列集合不符合预期\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 1;
-    config.ewma_alpha = 1.0;
-    config.switch_confirm_ticks = 3;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.050;
-    config.volatility_threshold = 0.050;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "ETHUSDT";
-    event.price = 100.0;
-    (void)engine.OnMarket(event);  // warmup
-
-    event.price = 100.3;  // uptrend
-    const auto up = engine.OnMarket(event);
-    if (up.regime != ai_trade::Regime::kUptrend) {
-      std::cerr << "Regime 初始确认态应进入上升趋势\n";
+    const auto column_of =
+        [&matrix](const std::string& name) -> const std::vector<double>& {
+      for (std::size_t i = 1; i < matrix.column_names.size(); ++i) {
+        if (matrix.column_names[i] == name) {
+          return matrix.columns[i - 1];
+        }
+      }
+      std::cerr << "特征矩阵缺少列: " << name << "\n";
+      std::exit(1);
+    };
+    const std::vector<double>& ret_1 = column_of("ret_1");
+    if (!std::isnan(ret_1[0]) ||
+        !NearlyEqual(ret_1[5], bars[5].close / bars[4].close - 1.0, 1e-12)) {
+      std::cerr << "特征矩阵 ret_1 数值不符合预期\n";
       return 1;
     }
-
-    event.price = 100.0;  // downtrend pending #1
-    const auto pending_1 = engine.OnMarket(event);
-    event.price = 99.7;   // downtrend pending #2
-    const auto pending_2 = engine.OnMarket(event);
-    if (pending_1.regime != ai_trade::Regime::kUptrend ||
-        pending_2.regime != ai_trade::Regime::kUptrend) {
-      std::cerr << "Regime 切换确认期内应保持已确认状态\n";
+    if (!NearlyEqual(column_of("ema_fast")[0], bars[0].close, 1e-12)) {
+      std::cerr << "特征矩阵 EMA 初值不符合预期\n";
       return 1;
     }
-
-    event.price = 99.4;  // downtrend pending #3 -> switch
-    const auto switched = engine.OnMarket(event);
-    if (switched.regime != ai_trade::Regime::kDowntrend ||
-        switched.bucket != ai_trade::RegimeBucket::kTrend) {
-      std::cerr << "Regime 连续确认达到阈值后应完成切换\n";
+    const std::vector<double>& forward_ret = column_of("forward_return");
+    if (!NearlyEqual(forward_ret[10], bars[22].close / bars[10].close - 1.0,
+                     1e-12) ||
+        !std::isnan(forward_ret[bars.size() - 1])) {
+      std::cerr << "特征矩阵 forward_return 不符合预期\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 1;
-    config.ewma_alpha = 1.0;
-    config.bar_interval_ms = 5000;
-    config.switch_confirm_ticks = 5;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.050;
-    config.volatility_threshold = 0.050;
+    const std::vector<double>& mom_12 = column_of("mom_12");
+    const std::vector<double>& ret_12 = column_of("ret_12");
+    for (std::size_t i = 0; i < mom_12.size(); ++i) {
+      const bool both_nan = std::isnan(mom_12[i]) && std::isnan(ret_12[i]);
+      if (!both_nan && !NearlyEqual(mom_12[i], ret_12[i], 1e-12)) {
+        std::cerr << "特征矩阵 mom_12 应与 ret_12 一致\n";
+        return 1;
+      }
+    }
 
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.interval_ms = 5000;
-    event.price = 100.0;
-    (void)engine.OnMarket(event);  // warmup
+    // 列式入口：同一份样本经 mmap 列扫描应产出完全相同的矩阵。
+    const auto feature_dir =
+        std::filesystem::temp_directory_path() / "ai_trade_test_features";
+    std::filesystem::remove_all(feature_dir);
+    std::filesystem::create_directories(feature_dir);
+    const auto bar_path = feature_dir / "bars.atcbar";
+    if (!ai_trade::research::SaveResearchBarsColumnar(bars, bar_path.string(),
+                                                      &feature_error)) {
+      std::cerr << "特征测试列式样本写入失败: " << feature_error << "\n";
+      return 1;
+    }
+    ai_trade::research::ColumnarBarStore feature_store;
+    ai_trade::research::FeatureMatrix columnar_matrix;
+    if (!feature_store.Open(bar_path.string(), &feature_error) ||
+        !ai_trade::research::BuildFeatureMatrix(feature_store, options,
+                                                &columnar_matrix,
+                                                &feature_error)) {
+      std::cerr << "列式入口特征构建失败: " << feature_error << "\n";
+      return 1;
+    }
+    feature_store.Close();
+    if (columnar_matrix.column_names != matrix.column_names ||
+        columnar_matrix.timestamps != matrix.timestamps) {
+      std::cerr << "列式入口特征矩阵结构不一致\n";
+      return 1;
+    }
+    for (std::size_t c = 0; c < matrix.columns.size(); ++c) {
+      for (std::size_t i = 0; i < matrix.RowCount(); ++i) {
+        const double lhs = matrix.columns[c][i];
+        const double rhs = columnar_matrix.columns[c][i];
+        if ((std::isnan(lhs) != std::isnan(rhs)) ||
+            (!std::isnan(lhs) && !NearlyEqual(lhs, rhs, 1e-12))) {
+          std::cerr << "列式入口特征数值不一致: 列="
+                    << matrix.column_names[c + 1] << ", 行=" << i << "\n";
+          return 1;
+        }
+      }
+    }
 
-    event.price = 100.01;
-    const auto baseline = engine.OnMarket(event);
-    if (baseline.warmup || baseline.regime != ai_trade::Regime::kRange) {
-      std::cerr << "Regime 时间确认测试的基准态应先维持 RANGE\n";
+    // 二进制往返 + CSV drop-na 行数。
+    const auto bin_path = feature_dir / "features.bin";
+    const auto csv_path = feature_dir / "features.csv";
+    ai_trade::research::FeatureMatrix loaded;
+    if (!ai_trade::research::WriteFeatureMatrixBinary(matrix, bin_path.string(),
+                                                      &feature_error) ||
+        !ai_trade::research::LoadFeatureMatrixBinary(bin_path.string(), &loaded,
+                                                     &feature_error)) {
+      std::cerr << "特征二进制往返失败: " << feature_error << "\n";
       return 1;
     }
-
-    event.price = 100.25;
-    event.interval_ms = 30000;
-    const auto switched = engine.OnMarket(event);
-    if (switched.regime != ai_trade::Regime::kUptrend ||
-        switched.bucket != ai_trade::RegimeBucket::kTrend) {
-      std::cerr << "Regime 应在长间隔样本下按真实时间完成确认切换\n";
+    if (loaded.column_names != matrix.column_names ||
+        loaded.timestamps != matrix.timestamps ||
+        loaded.columns.size() != matrix.columns.size()) {
+      std::cerr << "特征二进制读回结构不一致\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 1;
-    config.ewma_alpha = 1.0;
-    config.switch_confirm_ticks = 1;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.010;
-    config.volatility_threshold = 0.020;
-    config.extreme_requires_both = true;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "SOLUSDT";
-    event.price = 100.0;
-    (void)engine.OnMarket(event);  // warmup
-
-    // jump 命中但 vol 未命中：在 requires_both=true 下不应进入 EXTREME。
-    event.price = 101.2;  // +1.2%
-    const auto jump_only = engine.OnMarket(event);
-    if (jump_only.regime == ai_trade::Regime::kExtreme) {
-      std::cerr << "extreme_requires_both=true 时 jump-only 不应触发 EXTREME\n";
+    for (std::size_t c = 0; c < matrix.columns.size(); ++c) {
+      for (std::size_t i = 0; i < matrix.RowCount(); ++i) {
+        const double lhs = matrix.columns[c][i];
+        const double rhs = loaded.columns[c][i];
+        if ((std::isnan(lhs) != std::isnan(rhs)) ||
+            (!std::isnan(lhs) && lhs != rhs)) {
+          std::cerr << "特征二进制读回数值不一致\n";
+          return 1;
+        }
+      }
+    }
+    std::size_t rows_kept = 0;
+    if (!ai_trade::research::WriteFeatureMatrixCsv(matrix, csv_path.string(),
+                                                   /*drop_na=*/true, &rows_kept,
+                                                   &feature_error)) {
+      std::cerr << "特征 CSV 写出失败: " << feature_error << "\n";
       return 1;
     }
-
-    // jump 与 vol 同时命中：应进入 EXTREME。
-    event.price = 103.5;  // +2.27%
-    const auto both_hit = engine.OnMarket(event);
-    if (both_hit.regime != ai_trade::Regime::kExtreme) {
-      std::cerr << "extreme_requires_both=true 时双命中应触发 EXTREME\n";
+    // 前 96 根（最长回看窗口，vol_96 依赖 ret_1 再延一根）与尾部
+    // 12 根（前向标签）应被 drop-na 剔除。
+    if (rows_kept != bars.size() - 96 - 12) {
+      std::cerr << "特征 CSV drop-na 行数不符合预期: " << rows_kept << "\n";
       return 1;
     }
+    std::filesystem::remove_all(feature_dir);
   }
 
   {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 3;
-    config.ewma_alpha = 0.2;
-    config.switch_confirm_ticks = 1;
-    config.trend_threshold = 0.10;
-    config.extreme_threshold = 0.20;
-    config.volatility_threshold = 0.20;
-    config.extreme_requires_both = true;
-    config.volume_extreme_multiplier = 4.0;
+    // OnlineFeatureEngine 单元测试
+    ai_trade::research::OnlineFeatureEngine engine(50);
+    
+    // 1. 预热数据
+    for (int i = 0; i < 20; ++i) {
+      ai_trade::MarketEvent event;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + i; // 100, 101, ... 119
+      event.volume = 1000.0 + i * 100; // 1000, 1100, ...
+      engine.OnMarket(event);
+    }
 
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.price = 100.0;
-    event.volume = 100.0;
-    (void)engine.OnMarket(event);  // warmup #1
+    if (!engine.IsReady()) {
+      std::cerr << "OnlineFeatureEngine 预热后应就绪\n";
+      return 1;
+    }
+    if (engine.SampleCount() != 20U) {
+      std::cerr << "OnlineFeatureEngine SampleCount 不符合预期\n";
+      return 1;
+    }
 
-    event.price = 100.01;
-    event.volume = 100.0;
-    const auto warmup_2 = engine.OnMarket(event);  // warmup #2
-    if (!warmup_2.warmup) {
-      std::cerr << "volume extreme 测试中 warmup #2 应仍处于预热\n";
+    // 2. 验证算子计算
+    // ts_delay(close, 1) -> 118.0 (current is 119.0)
+    double delay = engine.Evaluate("ts_delay(close, 1)");
+    if (!NearlyEqual(delay, 118.0)) {
+      std::cerr << "OnlineFeatureEngine ts_delay 计算错误: " << delay << "\n";
       return 1;
     }
 
-    event.price = 100.02;
-    event.volume = 100.0;
-    const auto baseline = engine.OnMarket(event);  // warmup 结束
-    if (baseline.regime == ai_trade::Regime::kExtreme) {
-      std::cerr << "volume extreme 基准样本不应触发 EXTREME\n";
+    // ts_delta(close, 1) -> 1.0
+    double delta = engine.Evaluate("ts_delta(close, 1)");
+    if (!NearlyEqual(delta, 1.0)) {
+      std::cerr << "OnlineFeatureEngine ts_delta 计算错误: " << delta << "\n";
       return 1;
     }
 
-    event.price = 100.03;
-    event.volume = 1000.0;
-    const auto volume_spike = engine.OnMarket(event);
-    if (volume_spike.regime != ai_trade::Regime::kExtreme ||
-        volume_spike.bucket != ai_trade::RegimeBucket::kExtreme) {
-      std::cerr << "volume_extreme_multiplier 命中时应触发 EXTREME\n";
+    // ts_rank(close, 5) -> 0.9 (strictly increasing: (4 + 0.5)/5)
+    double rank = engine.Evaluate("ts_rank(close, 5)");
+    if (!NearlyEqual(rank, 0.9)) {
+      std::cerr << "OnlineFeatureEngine ts_rank 计算错误: " << rank << "\n";
       return 1;
     }
-  }
-
-  {
-    const std::filesystem::path cfg_path =
-        std::filesystem::temp_directory_path() / "ai_trade_test_regime_valid.yaml";
-    std::ofstream out(cfg_path);
-    out << "regime:\n"
-        << "  enabled: true\n"
-        << "  warmup_ticks: 12\n"
-        << "  ewma_alpha: 0.25\n"
-        << "  bar_interval_ms: 5000\n"
-        << "  switch_confirm_ticks: 4\n"
-        << "  extreme_requires_both: true\n"
-        << "  volume_extreme_multiplier: 5.0\n"
-        << "  trend_threshold: 0.0012\n"
-        << "  extreme_threshold: 0.006\n"
-        << "  volatility_threshold: 0.0025\n";
-    out.close();
 
-    ai_trade::AppConfig config;
-    std::string error;
-    if (!ai_trade::LoadAppConfigFromYaml(cfg_path.string(), &config, &error)) {
-      std::cerr << "Regime 配置解析失败: " << error << "\n";
+    // ts_corr(close, volume, 10) -> 1.0 (perfectly correlated)
+    double corr = engine.Evaluate("ts_corr(close, volume, 10)");
+    if (!NearlyEqual(corr, 1.0)) {
+      std::cerr << "OnlineFeatureEngine ts_corr 计算错误: " << corr << "\n";
       return 1;
     }
-    if (!config.regime.enabled || config.regime.warmup_ticks != 12 ||
-        !NearlyEqual(config.regime.ewma_alpha, 0.25) ||
-        config.regime.bar_interval_ms != 5000 ||
-        config.regime.switch_confirm_ticks != 4 ||
-        config.regime.extreme_requires_both != true ||
-        !NearlyEqual(config.regime.volume_extreme_multiplier, 5.0) ||
-        !NearlyEqual(config.regime.trend_threshold, 0.0012) ||
-        !NearlyEqual(config.regime.extreme_threshold, 0.006) ||
-        !NearlyEqual(config.regime.volatility_threshold, 0.0025)) {
-      std::cerr << "Regime 配置解析结果不符合预期\n";
+
+    // rsi(close, 14) -> 100.0 (严格递增序列，无下跌，RSI=100)
+    double rsi = engine.Evaluate("rsi(close, 14)");
+    if (!NearlyEqual(rsi, 100.0)) {
+      std::cerr << "OnlineFeatureEngine rsi 计算错误: 预期 100.0, 实际 " << rsi << "\n";
       return 1;
     }
-  }
-
-  {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 1;
-    config.ewma_alpha = 1.0;
-    config.bar_interval_ms = 5000;
-    config.switch_confirm_ticks = 1;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.050;
-    config.volatility_threshold = 0.050;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.interval_ms = 1000;
 
-    event.price = 100.0;
-    for (int i = 0; i < 4; ++i) {
-      const auto pending = engine.OnMarket(event);
-      if (!pending.warmup || pending.decision_interval_ms != 0 ||
-          pending.aggregated_event_count != 0) {
-        std::cerr << "bar_interval_ms 聚合前不应提前输出决策样本\n";
-        return 1;
-      }
-      event.price += 0.1;
+    // ema(close, 5)
+    // 简单验证：EMA 应接近最新价格
+    double ema = engine.Evaluate("ema(close, 5)");
+    if (!std::isfinite(ema) || std::abs(ema - 119.0) > 5.0) {
+      std::cerr << "OnlineFeatureEngine ema 计算异常: " << ema << "\n";
+      return 1;
     }
 
-    const auto seeded = engine.OnMarket(event);
-    if (!seeded.warmup || seeded.decision_interval_ms != 5000 ||
-        seeded.aggregated_event_count != 5) {
-      std::cerr << "bar_interval_ms 首个聚合样本应作为 warmup 基准输出\n";
+    // macd 组合表达式验证
+    double macd = engine.Evaluate("ema(close,12)-ema(close,26)");
+    if (!std::isfinite(macd)) {
+      std::cerr << "OnlineFeatureEngine macd 组合计算异常\n";
       return 1;
     }
 
-    event.price += 0.1;
-    for (int i = 0; i < 4; ++i) {
-      const auto held = engine.OnMarket(event);
-      if (!held.warmup || held.decision_interval_ms != 5000 ||
-          held.aggregated_event_count != 5) {
-        std::cerr << "bar_interval_ms 未满窗口时应保持最近一次聚合状态\n";
-        return 1;
-      }
-      event.price += 0.1;
+    // Integrator/Miner 表达式会使用 1e-9 这类科学计数法常量；
+    // 线上解析器必须与 Python 训练语义一致，不能把 `1e-9` 误拆成变量 e。
+    double normalized_delta =
+        engine.Evaluate("ts_delta(close,1)/(abs(ts_delay(close,1))+1e-9)");
+    if (!std::isfinite(normalized_delta) ||
+        !NearlyEqual(normalized_delta, 1.0 / 118.0, 1e-8)) {
+      std::cerr << "OnlineFeatureEngine 科学计数法表达式计算错误: "
+                << normalized_delta << "\n";
+      return 1;
     }
 
-    const auto trend = engine.OnMarket(event);
-    if (trend.warmup || trend.regime != ai_trade::Regime::kUptrend ||
-        trend.bucket != ai_trade::RegimeBucket::kTrend ||
-        trend.decision_interval_ms != 5000 ||
-        trend.aggregated_event_count != 5) {
-      std::cerr << "bar_interval_ms 聚合后应按 5s 样本触发趋势判定\n";
+    // 验证：窗口不足时应返回 NaN 而非 0.0
+    // ts_delay(close, 60) 需要 60+1 个数据，当前仅 20 个有效数据，padding 后窗口 50。
+    double invalid_delay = engine.Evaluate("ts_delay(close, 60)");
+    if (std::isfinite(invalid_delay)) {
+      std::cerr << "OnlineFeatureEngine 数据不足时应返回 NaN，实际返回: " << invalid_delay << "\n";
       return 1;
     }
+    
+    // 3. 验证批量计算
+    std::vector<std::string> exprs = {"close", "volume"};
+    std::vector<double> results = engine.EvaluateBatch(exprs);
+    if (results.size() != 2 || !NearlyEqual(results[0], 119.0) || !NearlyEqual(results[1], 2900.0)) {
+       std::cerr << "OnlineFeatureEngine EvaluateBatch 计算错误\n";
+       return 1;
+    }
   }
 
   {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 2;
-    config.ewma_alpha = 1.0;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.010;
-    config.volatility_threshold = 0.050;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.price = 100.0;
-    (void)engine.OnMarket(event);
-
-    event.price = 100.06;  // +0.06%，达到趋势门槛 60%，但不进入 TREND。
-    const auto candidate = engine.OnMarket(event);
-    if (candidate.warmup || candidate.bucket != ai_trade::RegimeBucket::kRange ||
-        !candidate.trend_candidate ||
-        !NearlyEqual(candidate.trend_threshold_ratio, 0.6)) {
-      std::cerr << "Regime TREND_CANDIDATE 诊断不符合预期\n";
+    // Symbol intern 表：同名稳定返回同一 id，id 稠密且可反查
+    const ai_trade::SymbolId btc = ai_trade::InternSymbol("BTCUSDT");
+    const ai_trade::SymbolId eth = ai_trade::InternSymbol("ETHUSDT");
+    if (btc == eth || ai_trade::InternSymbol("BTCUSDT") != btc ||
+        ai_trade::InternSymbol("ETHUSDT") != eth) {
+      std::cerr << "Symbol intern id 不稳定\n";
+      return 1;
+    }
+    if (ai_trade::SymbolNameOf(btc) != "BTCUSDT" ||
+        ai_trade::SymbolNameOf(eth) != "ETHUSDT" ||
+        !ai_trade::SymbolNameOf(ai_trade::kInvalidSymbolId).empty()) {
+      std::cerr << "Symbol intern 反查不符合预期\n";
+      return 1;
+    }
+    if (ai_trade::InternedSymbolCount() < 2U ||
+        btc >= ai_trade::InternedSymbolCount() ||
+        eth >= ai_trade::InternedSymbolCount()) {
+      std::cerr << "Symbol intern id 应为稠密下标\n";
       return 1;
     }
   }
 
   {
-    ai_trade::RegimeConfig config;
-    config.enabled = true;
-    config.warmup_ticks = 3;
-    config.ewma_alpha = 1.0;
-    config.trend_threshold = 0.001;
-    config.extreme_threshold = 0.010;
-    config.volatility_threshold = 0.050;
-
-    ai_trade::RegimeEngine engine(config);
-    ai_trade::MarketEvent event;
-    event.symbol = "BTCUSDT";
-    event.price = 100.0;
-    (void)engine.OnMarket(event);
-
-    event.price = 100.06;
-    const auto warmup_candidate = engine.OnMarket(event);
-    if (!warmup_candidate.warmup ||
-        warmup_candidate.bucket != ai_trade::RegimeBucket::kRange ||
-        warmup_candidate.trend_candidate ||
-        !warmup_candidate.warmup_trend_candidate ||
-        !NearlyEqual(warmup_candidate.trend_threshold_ratio, 0.6)) {
-      std::cerr << "Regime warmup TREND_CANDIDATE 诊断不符合预期\n";
+    // JSON 零拷贝视图：字段查找/数组游标/类型转换应与 DOM 路径口径一致
+    const std::string message =
+        "{\"topic\":\"tickers.BTCUSDT\",\"ts\":1717000000123,"
+        "\"data\":[{\"symbol\":\"BTCUSDT\",\"lastPrice\":\"50123.5\","
+        "\"isMaker\":true,\"note\":\"a\\\"b\"},"
+        "{\"symbol\":\"ETHUSDT\",\"lastPrice\":2500}]}";
+    ai_trade::JsonView root;
+    std::string view_error;
+    if (!ai_trade::ParseJsonView(message, &root, &view_error) ||
+        root.type != ai_trade::JsonType::kObject) {
+      std::cerr << "ParseJsonView 解析合法消息失败: " << view_error << "\n";
+      return 1;
+    }
+    ai_trade::JsonView topic;
+    if (!ai_trade::JsonViewObjectField(root, "topic", &topic) ||
+        !ai_trade::JsonViewStringEquals(topic, "tickers.BTCUSDT")) {
+      std::cerr << "JsonViewObjectField 顶层字段查找失败\n";
+      return 1;
+    }
+    ai_trade::JsonView ts;
+    if (!ai_trade::JsonViewObjectField(root, "ts", &ts) ||
+        ai_trade::JsonViewAsInt64(ts).value_or(0) != 1717000000123LL) {
+      std::cerr << "JsonViewAsInt64 解析失败\n";
+      return 1;
+    }
+    ai_trade::JsonView data;
+    if (!ai_trade::JsonViewObjectField(root, "data", &data) ||
+        data.type != ai_trade::JsonType::kArray) {
+      std::cerr << "JsonView data 数组字段查找失败\n";
+      return 1;
+    }
+    std::size_t cursor = 0;
+    ai_trade::JsonView item;
+    int item_count = 0;
+    while (ai_trade::JsonViewArrayNext(data, &cursor, &item)) {
+      ++item_count;
+      if (item_count == 1) {
+        ai_trade::JsonView price;
+        ai_trade::JsonView maker;
+        ai_trade::JsonView note;
+        if (!ai_trade::JsonViewObjectField(item, "lastPrice", &price) ||
+            !NearlyEqual(ai_trade::JsonViewAsNumber(price).value_or(0.0),
+                         50123.5) ||
+            !ai_trade::JsonViewObjectField(item, "isMaker", &maker) ||
+            !ai_trade::JsonViewAsBool(maker).value_or(false) ||
+            !ai_trade::JsonViewObjectField(item, "note", &note) ||
+            ai_trade::JsonViewAsString(note).value_or("") != "a\"b") {
+          std::cerr << "JsonView 首元素字段解析失败\n";
+          return 1;
+        }
+      }
+    }
+    if (item_count != 2) {
+      std::cerr << "JsonViewArrayNext 应遍历出 2 个元素\n";
+      return 1;
+    }
+    ai_trade::JsonView missing;
+    if (ai_trade::JsonViewObjectField(root, "absent", &missing)) {
+      std::cerr << "JsonView 不存在的字段不应命中\n";
+      return 1;
+    }
+    ai_trade::JsonView bad_view;
+    if (ai_trade::ParseJsonView("{\"a\":1} trailing", &bad_view, &view_error)) {
+      std::cerr << "ParseJsonView 应拒绝尾部多余字符\n";
       return 1;
     }
   }
 
   {
-    const std::filesystem::path cfg_path =
-        std::filesystem::temp_directory_path() / "ai_trade_test_regime_invalid.yaml";
-    std::ofstream out(cfg_path);
-    out << "regime:\n"
-        << "  ewma_alpha: 0\n";
-    out.close();
-
-    ai_trade::AppConfig config;
-    std::string error;
-    if (ai_trade::LoadAppConfigFromYaml(cfg_path.string(), &config, &error)) {
-      std::cerr << "非法 regime.ewma_alpha 配置应加载失败\n";
+    // LineWriter：to_chars 数值输出应可往返，定点/转义行为符合约定
+    ai_trade::LineWriter writer(64);
+    writer.Append("qty=")
+        .AppendDouble(0.1)
+        .Append(", count=")
+        .AppendInt(-42)
+        .Append(", flag=")
+        .AppendBool(true);
+    if (writer.str() != "qty=0.1, count=-42, flag=true") {
+      std::cerr << "LineWriter 基础拼接结果不符合预期: " << writer.str() << "\n";
       return 1;
     }
-    if (error.find("regime.ewma_alpha") == std::string::npos) {
-      std::cerr << "非法 regime.ewma_alpha 错误信息不符合预期\n";
+    const double tricky = 1234.56789012345;
+    ai_trade::LineWriter round_trip_writer;
+    round_trip_writer.AppendDouble(tricky);
+    if (std::stod(round_trip_writer.str()) != tricky) {
+      std::cerr << "LineWriter AppendDouble 应输出可往返表示\n";
+      return 1;
+    }
+    ai_trade::LineWriter fixed_writer;
+    fixed_writer.AppendDoubleFixed(3.14159, 4);
+    if (fixed_writer.str() != "3.1416") {
+      std::cerr << "LineWriter 定点输出不符合预期: " << fixed_writer.str()
+                << "\n";
+      return 1;
+    }
+    ai_trade::LineWriter escape_writer;
+    escape_writer.AppendJsonEscaped("a\"b\\c\nd");
+    if (escape_writer.str() != "a\\\"b\\\\c\\nd") {
+      std::cerr << "LineWriter JSON 转义不符合预期: " << escape_writer.str()
+                << "\n";
       return 1;
     }
   }
 
   {
-    const std::vector<double> series{1.0, 2.0, 3.0, 4.0, 5.0};
-    const std::vector<double> delayed = ai_trade::research::TsDelay(series, 2);
-    if (!std::isnan(delayed[0]) || !std::isnan(delayed[1]) ||
-        !NearlyEqual(delayed[2], 1.0) || !NearlyEqual(delayed[4], 3.0)) {
-      std::cerr << "TsDelay 结果不符合预期\n";
+    // 异步日志：批量入队 + Flush 后应全部落盘，丢行计数单调
+    const std::uint64_t dropped_before = ai_trade::LogDroppedLines();
+    for (int i = 0; i < 200; ++i) {
+      ai_trade::LogInfo("ASYNC_LOG_SMOKE: i=" + std::to_string(i));
+    }
+    ai_trade::LogFlush();
+    if (ai_trade::LogDroppedLines() < dropped_before) {
+      std::cerr << "LogDroppedLines 不应回退\n";
       return 1;
     }
+  }
 
-    const std::vector<double> delta = ai_trade::research::TsDelta(series, 2);
-    if (!std::isnan(delta[0]) || !std::isnan(delta[1]) ||
-        !NearlyEqual(delta[2], 2.0) || !NearlyEqual(delta[4], 2.0)) {
-      std::cerr << "TsDelta 结果不符合预期\n";
+  {
+    // 缓存时钟：刷新后读取命中缓存值，且随真实时间单调不减
+    const std::int64_t refreshed = ai_trade::RefreshCachedClock();
+    if (refreshed <= 0) {
+      std::cerr << "RefreshCachedClock 应返回正的毫秒时间戳\n";
       return 1;
     }
-
-    const std::vector<double> rank = ai_trade::research::TsRank(series, 3);
-    if (!std::isnan(rank[0]) || !std::isnan(rank[1]) ||
-        !NearlyEqual(rank[2], (2.0 + 0.5) / 3.0) ||
-        !NearlyEqual(rank[4], (2.0 + 0.5) / 3.0)) {
-      std::cerr << "TsRank 结果不符合预期\n";
+    if (ai_trade::NowMsCached() != refreshed) {
+      std::cerr << "NowMsCached 应返回最近一次刷新的缓存值\n";
       return 1;
     }
-
-    const std::vector<double> y{2.0, 4.0, 6.0, 8.0, 10.0};
-    const std::vector<double> corr = ai_trade::research::TsCorr(series, y, 3);
-    if (!std::isnan(corr[0]) || !std::isnan(corr[1]) ||
-        !NearlyEqual(corr[2], 1.0) || !NearlyEqual(corr[4], 1.0)) {
-      std::cerr << "TsCorr 结果不符合预期\n";
+    const std::int64_t refreshed_again = ai_trade::RefreshCachedClock();
+    if (refreshed_again < refreshed) {
+      std::cerr << "缓存时钟不应回退\n";
       return 1;
     }
   }
 
   {
-    const std::vector<double> factor{1.0, 2.0, 3.0, 4.0, 5.0};
-    const std::vector<double> future{10.0, 20.0, 30.0, 40.0, 50.0};
-    const ai_trade::research::SpearmanIcResult ic =
-        ai_trade::research::ComputeSpearmanIC(factor, future);
-    if (ic.sample_count != 5 || !NearlyEqual(ic.ic, 1.0)) {
-      std::cerr << "Spearman IC 正相关计算不符合预期\n";
+    // Reason 掩码：置位/查询往返一致，懒展开产出旧 JSON 字段的原字符串
+    ai_trade::ReasonMask mask = 0;
+    ai_trade::SetReason(&mask, ai_trade::ReasonCode::kStrExtremeBlock);
+    ai_trade::SetReason(&mask, ai_trade::ReasonCode::kRegExtreme);
+    ai_trade::SetReason(&mask, ai_trade::ReasonCode::kStrExtremeBlock);
+    if (!ai_trade::HasReason(mask, ai_trade::ReasonCode::kStrExtremeBlock) ||
+        !ai_trade::HasReason(mask, ai_trade::ReasonCode::kRegExtreme) ||
+        ai_trade::HasReason(mask, ai_trade::ReasonCode::kStrWarmup)) {
+      std::cerr << "ReasonMask 置位/查询不一致\n";
       return 1;
-    }
-
-    const std::vector<double> reverse_future{50.0, 40.0, 30.0, 20.0, 10.0};
-    const ai_trade::research::SpearmanIcResult reverse_ic =
-        ai_trade::research::ComputeSpearmanIC(factor, reverse_future);
-    if (reverse_ic.sample_count != 5 || !NearlyEqual(reverse_ic.ic, -1.0)) {
-      std::cerr << "Spearman IC 负相关计算不符合预期\n";
+    }
+    const auto expanded = ai_trade::ExpandReasonMask(mask);
+    if (expanded.size() != 2U || expanded[0] != "STR_EXTREME_BLOCK" ||
+        expanded[1] != "REG_EXTREME") {
+      std::cerr << "ExpandReasonMask 展开结果与旧 reason 字符串不一致\n";
+      return 1;
+    }
+    if (std::string(ai_trade::ReasonCodeName(
+            ai_trade::ReasonCode::kStrWarmup)) != "STR_WARMUP") {
+      std::cerr << "ReasonCodeName 映射不符合预期\n";
       return 1;
     }
   }
 
   {
-    // 模型运行时不可用时，canary 应显式降级为 shadow_unavailable，不得伪造打分。
-    const std::filesystem::path report_path =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_test_integrator_report_canary_applied.json";
-    std::string report_error;
-    if (!WriteIntegratorReportFile(report_path,
-                                   /*auc_mean=*/0.62,
-                                   /*delta_auc=*/0.03,
-                                   /*split_trained_count=*/5,
-                                   /*split_count=*/5,
-                                   &report_error)) {
-      std::cerr << report_error << "\n";
+    // RollingBuffer：环形回绕后窗口视图必须连续且按时间正序
+    ai_trade::research::RollingBuffer buffer(4);
+    if (!buffer.empty() || !buffer.LastSpan(4).empty()) {
+      std::cerr << "RollingBuffer 初始状态错误\n";
       return 1;
     }
-
-    ai_trade::IntegratorConfig integrator;
-    integrator.enabled = true;
-    integrator.mode = ai_trade::IntegratorMode::kShadow;
-    integrator.canary_notional_ratio = 0.35;
-    integrator.canary_confidence_threshold = 0.30;
-    integrator.canary_allow_countertrend = false;
-    integrator.shadow.enabled = true;
-    integrator.shadow.model_report_path = report_path.string();
-    integrator.shadow.model_path =
-        (std::filesystem::temp_directory_path() /
-         "ai_trade_test_integrator_model_missing_canary_1.cbm")
-            .string();
-    integrator.shadow.active_meta_path.clear();
-    integrator.shadow.score_gain = 1.0;
-
-    ai_trade::RegimeConfig regime_config;
-    regime_config.enabled = false;
-    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
-                                 /*max_order_notional_usd=*/1000.0,
-                                 ai_trade::RiskThresholds{},
-                                 ai_trade::StrategyConfig{},
-                                 /*min_rebalance_notional_usd=*/0.0,
-                                 regime_config,
-                                 integrator);
-    std::string init_error;
-    if (!system.InitializeIntegratorShadow(&init_error)) {
-      std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+    for (int i = 1; i <= 6; ++i) {
+      buffer.Add(static_cast<double>(i));  // 容量 4，最终保留 3,4,5,6
+    }
+    if (buffer.size() != 4U || !NearlyEqual(buffer.back(), 6.0) ||
+        !NearlyEqual(buffer.At(0), 3.0)) {
+      std::cerr << "RollingBuffer 回绕后状态错误\n";
       return 1;
     }
-    system.SetIntegratorMode(ai_trade::IntegratorMode::kCanary);
-
-    (void)system.Evaluate(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
-    const auto decision =
-        system.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0}, true);
-    if (decision.integrator_policy_applied ||
-        decision.integrator_policy_reason != "shadow_unavailable") {
-      std::cerr << "canary 在模型不可用时应降级为 shadow_unavailable\n";
+    const auto window = buffer.LastSpan(4);
+    const std::vector<double> expected = {3.0, 4.0, 5.0, 6.0};
+    if (window.size() != 4U) {
+      std::cerr << "RollingBuffer LastSpan 长度错误\n";
       return 1;
     }
-    if (!NearlyEqual(decision.base_signal.suggested_notional_usd,
-                     decision.signal.suggested_notional_usd,
-                     1e-9)) {
-      std::cerr << "canary 降级后不应修改原策略信号\n";
+    for (size_t i = 0; i < expected.size(); ++i) {
+      if (!NearlyEqual(window[i], expected[i])) {
+        std::cerr << "RollingBuffer LastSpan 内容错误\n";
+        return 1;
+      }
+    }
+    // 视图必须是连续内存（span 本身保证），GetLast 应与视图一致
+    const auto copied = buffer.GetLast(2);
+    if (copied.size() != 2U || !NearlyEqual(copied[0], 5.0) ||
+        !NearlyEqual(copied[1], 6.0)) {
+      std::cerr << "RollingBuffer GetLast 内容错误\n";
       return 1;
     }
-
-    std::filesystem::remove(report_path);
   }
 
   {
-    // 模型运行时不可用时，canary 不应触发 countertrend 逻辑，而应统一降级。
-    const std::filesystem::path report_path =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_test_integrator_report_canary_countertrend.json";
-    std::string report_error;
-    if (!WriteIntegratorReportFile(report_path,
-                                   /*auc_mean=*/0.62,
-                                   /*delta_auc=*/0.03,
-                                   /*split_trained_count=*/5,
-                                   /*split_count=*/5,
-                                   &report_error)) {
-      std::cerr << report_error << "\n";
-      return 1;
+    // CompiledExpression：预编译求值路径必须与字符串求值路径语义一致
+    ai_trade::research::OnlineFeatureEngine engine(50);
+    const std::vector<std::string> expressions = {
+        "ts_delay(close, 1)",
+        "ts_rank(close, 5)",
+        "ts_corr(close, volume, 10)",
+        "ts_delta(close,1)/(abs(ts_delay(close,1))+1e-9)",
+        "ema(close,12)-ema(close,26)",
+    };
+    std::vector<ai_trade::research::CompiledExpression> compiled;
+    for (const auto& expr : expressions) {
+      compiled.push_back(engine.Compile(expr));
+      if (!compiled.back().valid() || compiled.back().source() != expr) {
+        std::cerr << "CompiledExpression 编译失败: " << expr << "\n";
+        return 1;
+      }
     }
 
-    ai_trade::IntegratorConfig integrator;
-    integrator.enabled = true;
-    integrator.mode = ai_trade::IntegratorMode::kShadow;
-    integrator.canary_notional_ratio = 0.35;
-    integrator.canary_confidence_threshold = 0.30;
-    integrator.canary_allow_countertrend = false;
-    integrator.shadow.enabled = true;
-    integrator.shadow.model_report_path = report_path.string();
-    integrator.shadow.model_path =
-        (std::filesystem::temp_directory_path() /
-         "ai_trade_test_integrator_model_missing_canary_2.cbm")
-            .string();
-    integrator.shadow.active_meta_path.clear();
-    // 即使配置负增益，模型不可用时也不应执行伪造推理路径。
-    integrator.shadow.score_gain = -1.0;
-
-    ai_trade::RegimeConfig regime_config;
-    regime_config.enabled = false;
-    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
-                                 /*max_order_notional_usd=*/1000.0,
-                                 ai_trade::RiskThresholds{},
-                                 ai_trade::StrategyConfig{},
-                                 /*min_rebalance_notional_usd=*/0.0,
-                                 regime_config,
-                                 integrator);
-    std::string init_error;
-    if (!system.InitializeIntegratorShadow(&init_error)) {
-      std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+    // 空表达式应编译为无效程序并求值为 NaN
+    const auto empty_compiled = engine.Compile("");
+    if (empty_compiled.valid() || std::isfinite(engine.Evaluate(empty_compiled))) {
+      std::cerr << "CompiledExpression 空表达式处理错误\n";
       return 1;
     }
-    system.SetIntegratorMode(ai_trade::IntegratorMode::kCanary);
 
-    (void)system.Evaluate(ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
-    const auto decision =
-        system.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0}, true);
-    if (decision.integrator_policy_applied ||
-        decision.integrator_policy_reason != "shadow_unavailable") {
-      std::cerr << "canary 模型不可用降级逻辑不符合预期\n";
+    // 预热不足时编译结果应输出 NaN，随数据推进逐 tick 复用求值
+    if (std::isfinite(engine.Evaluate(compiled[1]))) {
+      std::cerr << "CompiledExpression 预热前应返回 NaN\n";
       return 1;
     }
-    if (!NearlyEqual(decision.signal.suggested_notional_usd,
-                     decision.base_signal.suggested_notional_usd)) {
-      std::cerr << "canary 反向拦截后不应修改原策略信号\n";
-      return 1;
+    for (int i = 0; i < 20; ++i) {
+      ai_trade::MarketEvent event;
+      event.symbol = "BTCUSDT";
+      event.price = 100.0 + i;
+      event.volume = 1000.0 + i * 100;
+      engine.OnMarket(event);
+
+      // 同一份编译产物跨 tick 复用，结果必须与即时解析路径一致
+      for (size_t k = 0; k < expressions.size(); ++k) {
+        const double compiled_value = engine.Evaluate(compiled[k]);
+        const double parsed_value = engine.Evaluate(expressions[k]);
+        const bool both_nan =
+            !std::isfinite(compiled_value) && !std::isfinite(parsed_value);
+        if (!both_nan && !NearlyEqual(compiled_value, parsed_value, 1e-12)) {
+          std::cerr << "CompiledExpression 求值与解析路径不一致: "
+                    << expressions[k] << " compiled=" << compiled_value
+                    << " parsed=" << parsed_value << "\n";
+          return 1;
+        }
+      }
     }
 
-    std::filesystem::remove(report_path);
+    // 批量接口
+    const std::vector<double> batch = engine.EvaluateBatch(compiled);
+    if (batch.size() != expressions.size() || !NearlyEqual(batch[0], 118.0) ||
+        !NearlyEqual(batch[1], 0.9)) {
+      std::cerr << "CompiledExpression 批量求值错误\n";
+      return 1;
+    }
   }
 
   {
-    // active：模型运行时不可用时应显式降级，不得执行线性缩放。
-    const std::filesystem::path report_path =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_test_integrator_report_active_policy.json";
-    std::string report_error;
-    if (!WriteIntegratorReportFile(report_path,
-                                   /*auc_mean=*/0.62,
-                                   /*delta_auc=*/0.03,
-                                   /*split_trained_count=*/5,
-                                   /*split_count=*/5,
-                                   &report_error)) {
-      std::cerr << report_error << "\n";
-      return 1;
+    // MultiSymbolFeatureEngine：SoA 横扫结果必须与每 symbol 独立引擎一致
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+    ai_trade::research::MultiSymbolFeatureEngine multi(symbols, 50);
+    std::vector<ai_trade::research::OnlineFeatureEngine> singles;
+    for (size_t s = 0; s < symbols.size(); ++s) {
+      singles.emplace_back(50);
     }
 
-    ai_trade::RegimeConfig regime_config;
-    regime_config.enabled = false;
-
-    {
-      ai_trade::IntegratorConfig integrator_low;
-      integrator_low.enabled = true;
-      integrator_low.mode = ai_trade::IntegratorMode::kShadow;
-      integrator_low.active_confidence_threshold = 0.60;
-      integrator_low.shadow.enabled = true;
-      integrator_low.shadow.model_report_path = report_path.string();
-      integrator_low.shadow.model_path =
-          (std::filesystem::temp_directory_path() /
-           "ai_trade_test_integrator_model_missing_active_low.cbm")
-              .string();
-      integrator_low.shadow.active_meta_path.clear();
-      integrator_low.shadow.score_gain = 1.0;
-
-      ai_trade::TradeSystem system_low(/*risk_cap_usd=*/3000.0,
-                                       /*max_order_notional_usd=*/1000.0,
-                                       ai_trade::RiskThresholds{},
-                                       ai_trade::StrategyConfig{},
-                                       /*min_rebalance_notional_usd=*/0.0,
-                                       regime_config,
-                                       integrator_low);
-      std::string init_error;
-      if (!system_low.InitializeIntegratorShadow(&init_error)) {
-        std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
-        return 1;
-      }
-      system_low.SetIntegratorMode(ai_trade::IntegratorMode::kActive);
-      (void)system_low.Evaluate(
-          ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
-      const auto decision_low =
-          system_low.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0},
-                              true);
-      if (decision_low.integrator_policy_applied ||
-          decision_low.integrator_policy_reason != "shadow_unavailable" ||
-          !NearlyEqual(decision_low.signal.suggested_notional_usd,
-                       decision_low.base_signal.suggested_notional_usd,
-                       1e-9)) {
-        std::cerr << "active 低置信在模型不可用时应降级\n";
+    const std::vector<std::string> expressions = {
+        "ts_rank(close, 5)",
+        "ts_corr(close, volume, 10)",
+        "ts_delta(close,1)/(abs(ts_delay(close,1))+1e-9)",
+    };
+    std::vector<ai_trade::research::CompiledExpression> multi_compiled;
+    for (const auto& expr : expressions) {
+      multi_compiled.push_back(multi.Compile(expr));
+      if (!multi_compiled.back().valid()) {
+        std::cerr << "MultiSymbol 表达式编译失败: " << expr << "\n";
         return 1;
       }
     }
+    // 未知变量与单 symbol 引擎语义一致：程序求值恒为 NaN
+    const auto unknown_compiled = multi.Compile("unknown_var+1");
+    if (std::isfinite(multi.Evaluate(unknown_compiled, symbols[0]))) {
+      std::cerr << "MultiSymbol 未知变量求值应返回 NaN\n";
+      return 1;
+    }
 
-    {
-      ai_trade::IntegratorConfig integrator_high;
-      integrator_high.enabled = true;
-      integrator_high.mode = ai_trade::IntegratorMode::kShadow;
-      integrator_high.active_confidence_threshold = 0.20;
-      integrator_high.shadow.enabled = true;
-      integrator_high.shadow.model_report_path = report_path.string();
-      integrator_high.shadow.model_path =
-          (std::filesystem::temp_directory_path() /
-           "ai_trade_test_integrator_model_missing_active_high.cbm")
-              .string();
-      integrator_high.shadow.active_meta_path.clear();
-      integrator_high.shadow.score_gain = 2.0;
+    // 各 symbol 的价格路径/推进节奏刻意不同（SOLUSDT 隔 tick 推进）
+    for (int i = 0; i < 70; ++i) {
+      for (size_t s = 0; s < symbols.size(); ++s) {
+        if (s == 2 && i % 2 == 1) {
+          continue;
+        }
+        ai_trade::MarketEvent event;
+        event.symbol = symbols[s];
+        event.price = 100.0 * static_cast<double>(s + 1) +
+                      std::sin(static_cast<double>(i) * 0.2 +
+                               static_cast<double>(s)) *
+                          5.0 +
+                      static_cast<double>(i) * 0.1;
+        event.volume = 1000.0 + static_cast<double>((i * 7 + s * 13) % 50);
+        multi.OnMarket(event);
+        singles[s].OnMarket(event);
+      }
+    }
+    if (multi.SampleCount("BTCUSDT") != 50U ||
+        multi.SampleCount("SOLUSDT") != 35U ||
+        multi.SampleCount("XRPUSDT") != 0U) {
+      std::cerr << "MultiSymbol 样本计数不符合预期\n";
+      return 1;
+    }
 
-      ai_trade::TradeSystem system_high(/*risk_cap_usd=*/3000.0,
-                                        /*max_order_notional_usd=*/1000.0,
-                                        ai_trade::RiskThresholds{},
-                                        ai_trade::StrategyConfig{},
-                                        /*min_rebalance_notional_usd=*/0.0,
-                                        regime_config,
-                                        integrator_high);
-      std::string init_error;
-      if (!system_high.InitializeIntegratorShadow(&init_error)) {
-        std::cerr << "Integrator 初始化预期成功，错误: " << init_error << "\n";
+    std::vector<double> swept;
+    for (size_t k = 0; k < expressions.size(); ++k) {
+      multi.EvaluateAll(multi_compiled[k], &swept);
+      if (swept.size() != symbols.size()) {
+        std::cerr << "MultiSymbol 横扫输出长度错误\n";
         return 1;
       }
-      system_high.SetIntegratorMode(ai_trade::IntegratorMode::kActive);
-      (void)system_high.Evaluate(
-          ai_trade::MarketEvent{1, "BTCUSDT", 100.0, 100.0}, true);
-      const auto decision_high =
-          system_high.Evaluate(ai_trade::MarketEvent{2, "BTCUSDT", 101.0, 101.0},
-                               true);
-      if (decision_high.integrator_policy_applied ||
-          decision_high.integrator_policy_reason != "shadow_unavailable" ||
-          !NearlyEqual(decision_high.signal.suggested_notional_usd,
-                       decision_high.base_signal.suggested_notional_usd,
-                       1e-9)) {
-        std::cerr << "active 高置信在模型不可用时应降级\n";
-        return 1;
+      for (size_t s = 0; s < symbols.size(); ++s) {
+        const double expected = singles[s].Evaluate(expressions[k]);
+        const bool both_nan =
+            !std::isfinite(swept[s]) && !std::isfinite(expected);
+        if (!both_nan && !NearlyEqual(swept[s], expected, 1e-12)) {
+          std::cerr << "MultiSymbol 横扫与独立引擎不一致: " << expressions[k]
+                    << " symbol=" << symbols[s] << " swept=" << swept[s]
+                    << " expected=" << expected << "\n";
+          return 1;
+        }
+        if (!NearlyEqual(multi.Evaluate(multi_compiled[k], symbols[s]),
+                         swept[s], 1e-12) &&
+            std::isfinite(swept[s])) {
+          std::cerr << "MultiSymbol 单 symbol 求值与横扫不一致\n";
+          return 1;
+        }
       }
     }
-
-    std::filesystem::remove(report_path);
+    if (std::isfinite(multi.Evaluate(multi_compiled[0], "XRPUSDT"))) {
+      std::cerr << "MultiSymbol 未注册 symbol 应返回 NaN\n";
+      return 1;
+    }
+  }
+
+  {
+    // TimerWheel：到期序触发、跨层级联、取消与回调内再注册
+    ai_trade::TimerWheel wheel(1000);
+    std::vector<int> fired;
+    std::vector<std::int64_t> fire_times;
+    auto record = [&fired, &fire_times](int tag) {
+      return [&fired, &fire_times, tag](std::int64_t now_ms) {
+        fired.push_back(tag);
+        fire_times.push_back(now_ms);
+      };
+    };
+
+    // 覆盖各层：同槽近期、跨 64ms 窗口、跨 4096ms 窗口、远期溢出链
+    wheel.ScheduleAfter(5, record(1));
+    wheel.ScheduleAfter(200, record(2));
+    wheel.ScheduleAfter(5000, record(3));
+    const auto far_id =
+        wheel.ScheduleAt(1000 + (1LL << 24) + 100, record(4));
+    const auto cancelled_id = wheel.ScheduleAfter(50, record(99));
+    if (wheel.pending() != 5U || wheel.NextDeadlineHintMs() != 1005) {
+      std::cerr << "TimerWheel 注册后状态错误\n";
+      return 1;
+    }
+    if (!wheel.Cancel(cancelled_id) || wheel.Cancel(cancelled_id)) {
+      std::cerr << "TimerWheel 取消语义错误\n";
+      return 1;
+    }
+
+    if (wheel.Advance(1004) != 0 || wheel.Advance(1005) != 1 ||
+        fired != std::vector<int>{1} || fire_times.back() != 1005) {
+      std::cerr << "TimerWheel 近期定时器触发时刻错误\n";
+      return 1;
+    }
+    // 大步推进一次吸收剩余两层，触发序必须按到期时间
+    if (wheel.Advance(7000) != 2 || fired != (std::vector<int>{1, 2, 3}) ||
+        fire_times[1] != 1200 || fire_times[2] != 6000) {
+      std::cerr << "TimerWheel 跨层级联触发错误\n";
+      return 1;
+    }
+    if (wheel.pending() != 1U) {
+      std::cerr << "TimerWheel 在途计数错误\n";
+      return 1;
+    }
+    // 溢出链条目在顶层换轮后回填并按时触发
+    if (wheel.Advance(1000 + (1LL << 24) + 100) != 1 ||
+        fired.back() != 4 || fire_times.back() != 1000 + (1LL << 24) + 100) {
+      std::cerr << "TimerWheel 溢出链定时器触发错误\n";
+      return 1;
+    }
+    (void)far_id;
+    if (wheel.pending() != 0U || wheel.NextDeadlineHintMs() != -1) {
+      std::cerr << "TimerWheel 清空后状态错误\n";
+      return 1;
+    }
+
+    // 回调内再注册（含注册到过去时刻）：下一次 Advance 触发，不丢失
+    const std::int64_t base = wheel.now_ms();
+    wheel.ScheduleAfter(10, [&wheel, &fired](std::int64_t) {
+      fired.push_back(5);
+      wheel.ScheduleAfter(-100, [&fired](std::int64_t) {
+        fired.push_back(6);
+      });
+    });
+    wheel.Advance(base + 10);
+    if (fired.back() != 5) {
+      std::cerr << "TimerWheel 回调内注册失败\n";
+      return 1;
+    }
+    wheel.Advance(base + 11);
+    if (fired.back() != 6 || wheel.pending() != 0U) {
+      std::cerr << "TimerWheel 过去时刻定时器应在下一轮触发\n";
+      return 1;
+    }
   }
 
   {
-    // Integrator 报告声明未知经典特征时应初始化失败，避免静默退化为常数特征。
-    const std::filesystem::path report_path =
-        std::filesystem::temp_directory_path() /
-        "ai_trade_test_integrator_report_unknown_feature.json";
-    std::ofstream out(report_path);
-    if (!out.is_open()) {
-      std::cerr << "无法写入 integrator unknown feature 报告\n";
+    // MuxExchangeAdapter：多路行情时间序归并 + 按 symbol 执行路由
+    auto make_event = [](std::int64_t ts, const std::string& symbol,
+                         double price) {
+      ai_trade::MarketEvent event;
+      event.ts_ms = ts;
+      event.symbol = symbol;
+      event.price = price;
+      return event;
+    };
+    auto* fast = new MuxVenueStubAdapter(
+        {make_event(100, "BTCUSDT", 100.0), make_event(300, "BTCUSDT", 101.0)});
+    auto* slow = new MuxVenueStubAdapter(
+        {make_event(200, "BTCUSDT", 100.1), make_event(400, "BTCUSDT", 100.9)});
+
+    ai_trade::ExchangeMuxConfig mux_config;
+    mux_config.execution_venue = "main";
+    mux_config.symbol_routes = {"ETHUSDT=alt"};
+    mux_config.poll_idle_sleep_us = 100;
+    std::vector<ai_trade::MuxExchangeAdapter::Venue> venues;
+    venues.push_back({"main", std::unique_ptr<ai_trade::ExchangeAdapter>(slow)});
+    venues.push_back({"alt", std::unique_ptr<ai_trade::ExchangeAdapter>(fast)});
+    ai_trade::MuxExchangeAdapter mux(std::move(venues), mux_config);
+    if (mux.Name() != "mux(main+alt)") {
+      std::cerr << "mux 适配器名称错误: " << mux.Name() << "\n";
+      return 1;
+    }
+    if (!mux.Connect() || !mux.TradeOk()) {
+      std::cerr << "mux 适配器连接失败\n";
       return 1;
     }
-    out << "{\n"
-        << "  \"model_version\": \"integrator_cb_v1_test\",\n"
-        << "  \"feature_names\": [\"ret_1\", \"unknown_feature_x\"],\n"
-        << "  \"metrics_oos\": {\n"
-        << "    \"auc_mean\": 0.62,\n"
-        << "    \"delta_auc_vs_baseline\": 0.03,\n"
-        << "    \"split_trained_count\": 5,\n"
-        << "    \"split_count\": 5\n"
-        << "  }\n"
-        << "}\n";
-    out.close();
 
-    ai_trade::IntegratorConfig integrator;
-    integrator.enabled = true;
-    integrator.mode = ai_trade::IntegratorMode::kShadow;
-    integrator.shadow.enabled = true;
-    integrator.shadow.model_report_path = report_path.string();
-    integrator.shadow.model_path =
-        (std::filesystem::temp_directory_path() /
-         "ai_trade_test_integrator_model_missing_unknown_feature.cbm")
-            .string();
-    integrator.shadow.active_meta_path.clear();
-    integrator.shadow.require_model_file = false;
-    integrator.shadow.require_active_meta = false;
-    integrator.shadow.require_gate_pass = false;
+    // 等两路脚本行情都被拉取线程吸收后再归并消费，保证顺序确定
+    const auto wait_deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((!fast->Drained() || !slow->Drained()) &&
+           std::chrono::steady_clock::now() < wait_deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
-    ai_trade::RegimeConfig regime_config;
-    regime_config.enabled = false;
-    ai_trade::TradeSystem system(/*risk_cap_usd=*/3000.0,
-                                 /*max_order_notional_usd=*/1000.0,
-                                 ai_trade::RiskThresholds{},
-                                 ai_trade::StrategyConfig{},
-                                 /*min_rebalance_notional_usd=*/0.0,
-                                 regime_config,
-                                 integrator);
-    std::string init_error;
-    if (system.InitializeIntegratorShadow(&init_error)) {
-      std::cerr << "包含未知特征名的 Integrator 报告应初始化失败\n";
+    std::vector<std::int64_t> merged_ts;
+    ai_trade::MarketEvent merged;
+    while (mux.PollMarket(&merged)) {
+      merged_ts.push_back(merged.ts_ms);
+    }
+    if (merged_ts != (std::vector<std::int64_t>{100, 200, 300, 400})) {
+      std::cerr << "mux 行情归并顺序错误\n";
       return 1;
     }
-    if (init_error.find("不受支持") == std::string::npos &&
-        init_error.find("缺失") == std::string::npos) {
-      std::cerr << "未知特征初始化失败错误信息不符合预期: " << init_error << "\n";
+
+    // 执行路由：默认走 execution_venue，覆盖项按 symbol 指路
+    ai_trade::OrderIntent btc_intent;
+    btc_intent.client_order_id = "mux-btc-order";
+    btc_intent.symbol = "BTCUSDT";
+    ai_trade::OrderIntent eth_intent;
+    eth_intent.client_order_id = "mux-eth-order";
+    eth_intent.symbol = "ETHUSDT";
+    if (!mux.SubmitOrder(btc_intent) || !mux.SubmitOrder(eth_intent) ||
+        slow->Submitted() != std::vector<std::string>{"mux-btc-order"} ||
+        fast->Submitted() != std::vector<std::string>{"mux-eth-order"}) {
+      std::cerr << "mux 按 symbol 执行路由错误\n";
+      return 1;
+    }
+    // 撤单回下单时记录的归属 venue
+    if (!mux.CancelOrder("mux-eth-order") ||
+        fast->Cancelled() != std::vector<std::string>{"mux-eth-order"} ||
+        !slow->Cancelled().empty()) {
+      std::cerr << "mux 撤单归属路由错误\n";
+      return 1;
+    }
+    // 批量提交按 venue 分组，各自一次批量调用
+    const std::vector<ai_trade::OrderIntent> batch = {btc_intent, eth_intent};
+    std::vector<bool> batch_ok;
+    if (!mux.SubmitOrders(batch, &batch_ok) || batch_ok.size() != 2U ||
+        !batch_ok[0] || !batch_ok[1] ||
+        slow->BatchSizes() != std::vector<std::size_t>{1} ||
+        fast->BatchSizes() != std::vector<std::size_t>{1}) {
+      std::cerr << "mux 批量提交分组错误\n";
+      return 1;
+    }
+
+    // 行情专用 venue 连接失败只降级：交易链路照常可用
+    auto* healthy = new MuxVenueStubAdapter({make_event(1, "BTCUSDT", 1.0)});
+    auto* broken = new MuxVenueStubAdapter({}, /*connect_ok=*/false);
+    ai_trade::ExchangeMuxConfig degraded_config;
+    degraded_config.execution_venue = "main";
+    std::vector<ai_trade::MuxExchangeAdapter::Venue> degraded_venues;
+    degraded_venues.push_back(
+        {"main", std::unique_ptr<ai_trade::ExchangeAdapter>(healthy)});
+    degraded_venues.push_back(
+        {"dead", std::unique_ptr<ai_trade::ExchangeAdapter>(broken)});
+    ai_trade::MuxExchangeAdapter degraded(std::move(degraded_venues),
+                                          degraded_config);
+    if (!degraded.Connect() || !degraded.TradeOk()) {
+      std::cerr << "mux 行情 venue 失败不应影响交易可用性\n";
       return 1;
     }
-    std::filesystem::remove(report_path);
   }
 
   {
-    std::vector<ai_trade::research::ResearchBar> bars;
-    bars.reserve(220);
-    for (int i = 0; i < 220; ++i) {
-      ai_trade::research::ResearchBar bar;
-      bar.ts_ms = 1'700'000'000'000LL + static_cast<std::int64_t>(i) * 300'000LL;
-      bar.close = 100.0 + static_cast<double>(i) * 0.12 +
-                  std::sin(static_cast<double>(i) * 0.08) * 1.5;
-      bar.open = bar.close - 0.20;
-      bar.high = bar.close + 0.35;
-      bar.low = bar.close - 0.40;
-      bar.volume = 1200.0 + static_cast<double>(i % 11) * 23.0 +
-                   std::cos(static_cast<double>(i) * 0.05) * 40.0;
-      bars.push_back(bar);
+    // StateDeltaStreamWriter：快照锚定 + 仅变化字段入流 + 轮转语义
+    const std::string stream_path =
+        (std::filesystem::temp_directory_path() / "ai_trade_state_stream_test.jsonl")
+            .string();
+    auto read_lines = [&stream_path]() {
+      std::vector<std::string> lines;
+      std::ifstream in(stream_path);
+      std::string line;
+      while (std::getline(in, line)) {
+        lines.push_back(line);
+      }
+      return lines;
+    };
+
+    ai_trade::StateDeltaStreamWriter writer;
+    std::string error;
+    if (!writer.Open(stream_path, 3, 0, &error)) {
+      std::cerr << "状态增量流打开失败: " << error << "\n";
+      return 1;
     }
 
-    ai_trade::research::MinerConfig config;
-    config.random_seed = 42;
-    config.top_k = 5;
-    config.train_split_ratio = 0.7;
-    config.complexity_penalty = 0.01;
+    ai_trade::RuntimeStateSample sample;
+    sample.ts_ms = 1000;
+    sample.risk_mode = "NORMAL";
+    sample.trading_halted = false;
+    sample.equity_usd = 10000.0;
+    sample.drawdown_pct = 0.0;
+    sample.positions.push_back({"BTCUSDT", 0.01, 64000.0});
+    sample.funnel.emplace_back("raw_signals", 10ULL);
 
-    ai_trade::research::Miner miner;
-    const ai_trade::research::MinerReport report_1 = miner.Run(bars, config);
-    const ai_trade::research::MinerReport report_2 = miner.Run(bars, config);
+    if (!writer.Publish(sample) || writer.version() != 1U) {
+      std::cerr << "状态增量流首条应写出快照\n";
+      return 1;
+    }
+    auto lines = read_lines();
+    if (lines.size() != 1U ||
+        lines[0].find("\"type\":\"snapshot\"") == std::string::npos ||
+        lines[0].find("\"v\":1") == std::string::npos) {
+      std::cerr << "状态增量流快照行格式错误\n";
+      return 1;
+    }
 
-    if (report_1.factors.size() != 5 || report_2.factors.size() != 5) {
-      std::cerr << "Miner TopK 结果数量不符合预期\n";
+    // 无变化的采样不落盘、不升版本
+    if (writer.Publish(sample) || writer.version() != 1U ||
+        read_lines().size() != 1U) {
+      std::cerr << "状态增量流无变化采样不应写记录\n";
       return 1;
     }
-    if (report_1.random_seed != 42 ||
-        report_1.search_space_version.empty() ||
-        report_1.random_baseline_trials <= 0 ||
-        report_1.random_baseline_oos_abs_ic.sample_count <= 0) {
-      std::cerr << "Miner 报告元数据/随机基线统计不符合预期\n";
+
+    // 变化采样只写变化字段：权益 + 新开仓 + 漏斗计数
+    sample.ts_ms = 2000;
+    sample.equity_usd = 10100.0;
+    sample.positions.push_back({"ETHUSDT", 1.5, 3200.0});
+    sample.funnel[0].second = 12ULL;
+    if (!writer.Publish(sample) || writer.version() != 2U) {
+      std::cerr << "状态增量流变化采样应写 delta\n";
       return 1;
     }
-    if (!ai_trade::research::IsFinite(report_1.oos_random_baseline_threshold_p90) ||
-        report_1.oos_random_baseline_threshold_p90 < 0.0 ||
-        !ai_trade::research::IsFinite(report_1.top_factor_oos_abs_ic)) {
-      std::cerr << "Miner 随机基线阈值或 Top 因子 IC 非法\n";
+    lines = read_lines();
+    if (lines.size() != 2U ||
+        lines[1].find("\"type\":\"delta\"") == std::string::npos ||
+        lines[1].find("\"equity_usd\":10100") == std::string::npos ||
+        lines[1].find("ETHUSDT") == std::string::npos ||
+        lines[1].find("\"raw_signals\":12") == std::string::npos) {
+      std::cerr << "状态增量流 delta 行内容错误\n";
       return 1;
     }
-    if (report_1.factor_set_version.empty() ||
-        report_1.factor_set_version != report_2.factor_set_version) {
-      std::cerr << "Miner 同种子复现性不符合预期\n";
+    // 未变化的字段不应出现在 delta 里
+    if (lines[1].find("risk_mode") != std::string::npos ||
+        lines[1].find("BTCUSDT") != std::string::npos) {
+      std::cerr << "状态增量流 delta 不应携带未变化字段\n";
       return 1;
     }
-    if (report_1.factors[0].expression != report_2.factors[0].expression) {
-      std::cerr << "Miner Top 因子复现性不符合预期\n";
+
+    // 平仓以 qty=0 下发
+    sample.ts_ms = 3000;
+    sample.positions.erase(sample.positions.begin());
+    if (!writer.Publish(sample)) {
+      std::cerr << "状态增量流平仓采样应写 delta\n";
       return 1;
     }
-    const auto has_delay =
-        std::any_of(report_1.candidate_expressions.begin(),
-                    report_1.candidate_expressions.end(),
-                    [](const std::string& expr) {
-                      return expr.find("ts_delay") != std::string::npos;
-                    });
-    const auto has_delta =
-        std::any_of(report_1.candidate_expressions.begin(),
-                    report_1.candidate_expressions.end(),
-                    [](const std::string& expr) {
-                      return expr.find("ts_delta") != std::string::npos;
-                    });
-    const auto has_rank =
-        std::any_of(report_1.candidate_expressions.begin(),
-                    report_1.candidate_expressions.end(),
-                    [](const std::string& expr) {
-                      return expr.find("ts_rank") != std::string::npos;
-                    });
-    const auto has_corr =
-        std::any_of(report_1.candidate_expressions.begin(),
-                    report_1.candidate_expressions.end(),
-                    [](const std::string& expr) {
-                      return expr.find("ts_corr") != std::string::npos;
-                    });
-    if (!has_delay || !has_delta || !has_rank || !has_corr) {
-      std::cerr << "Miner 候选因子未覆盖必需时序算子\n";
+    lines = read_lines();
+    if (lines[2].find("\"symbol\":\"BTCUSDT\",\"qty\":0") ==
+        std::string::npos) {
+      std::cerr << "状态增量流平仓应下发 qty=0 条目\n";
       return 1;
     }
-    if (report_1.factors.front().search_space_version != "ts_ops_v1" ||
-        report_1.factors.front().valid_universe.empty() ||
-        report_1.factors.front().rolling_ic_oos.sample_count <= 0) {
-      std::cerr << "Miner 因子诊断字段不符合预期\n";
+
+    // 每 snapshot_interval 条记录后重发快照
+    sample.ts_ms = 4000;
+    sample.equity_usd = 10200.0;
+    writer.Publish(sample);
+    sample.ts_ms = 5000;
+    sample.equity_usd = 10300.0;
+    writer.Publish(sample);
+    lines = read_lines();
+    if (lines.size() != 5U ||
+        lines[4].find("\"type\":\"snapshot\"") == std::string::npos ||
+        lines[4].find("\"v\":5") == std::string::npos) {
+      std::cerr << "状态增量流应按间隔重发快照\n";
+      return 1;
+    }
+    writer.Close();
+
+    // 轮转：超出字节上限后截断重写，首条回到快照且版本继续递增
+    ai_trade::StateDeltaStreamWriter rotating;
+    if (!rotating.Open(stream_path, 100, 64, &error)) {
+      std::cerr << "状态增量流轮转用例打开失败: " << error << "\n";
       return 1;
     }
+    ai_trade::RuntimeStateSample small_sample;
+    small_sample.ts_ms = 1;
+    small_sample.risk_mode = "NORMAL";
+    small_sample.equity_usd = 1.0;
+    rotating.Publish(small_sample);
+    small_sample.ts_ms = 2;
+    small_sample.equity_usd = 2.0;
+    rotating.Publish(small_sample);  // 触发截断并强制快照
+    lines = read_lines();
+    if (lines.size() != 1U ||
+        lines[0].find("\"type\":\"snapshot\"") == std::string::npos ||
+        lines[0].find("\"v\":2") == std::string::npos) {
+      std::cerr << "状态增量流轮转后应以新快照开头\n";
+      return 1;
+    }
+    rotating.Close();
+    std::filesystem::remove(stream_path);
   }
 
   {
-    // OnlineFeatureEngine 单元测试
-    ai_trade::research::OnlineFeatureEngine engine(50);
-    
-    // 1. 预热数据
-    for (int i = 0; i < 20; ++i) {
-      ai_trade::MarketEvent event;
-      event.symbol = "BTCUSDT";
-      event.price = 100.0 + i; // 100, 101, ... 119
-      event.volume = 1000.0 + i * 100; // 1000, 1100, ...
-      engine.OnMarket(event);
+    // 定长订单簿：snapshot 锚定 / delta 增删改 / 序号去重 / seqlock 快照
+    ai_trade::FixedDepthOrderBook book;
+    if (book.Begin(1, 5, /*is_snapshot=*/false)) {
+      std::cerr << "未锚定的订单簿不应接受 delta\n";
+      return 1;
+    }
+    ai_trade::OrderBookSnapshot snapshot;
+    if (book.ReadSnapshot(&snapshot)) {
+      std::cerr << "未锚定的订单簿不应产出快照\n";
+      return 1;
     }
 
-    if (!engine.IsReady()) {
-      std::cerr << "OnlineFeatureEngine 预热后应就绪\n";
+    if (!book.Begin(1, 10, /*is_snapshot=*/true)) {
+      std::cerr << "snapshot 应总是被接受\n";
       return 1;
     }
-    if (engine.SampleCount() != 20U) {
-      std::cerr << "OnlineFeatureEngine SampleCount 不符合预期\n";
+    // 乱序插入应按价格有序落位：bids 降序、asks 升序。
+    book.SetBid(100.0, 1.0);
+    book.SetBid(99.0, 2.0);
+    book.SetBid(101.0, 3.0);
+    book.SetAsk(103.0, 2.0);
+    book.SetAsk(102.0, 1.0);
+    book.Commit();
+    if (!book.ReadSnapshot(&snapshot) || snapshot.bid_count != 3 ||
+        snapshot.ask_count != 2 || !NearlyEqual(snapshot.best_bid(), 101.0) ||
+        !NearlyEqual(snapshot.best_ask(), 102.0) ||
+        !NearlyEqual(snapshot.bids[2].price, 99.0) ||
+        !NearlyEqual(snapshot.spread(), 1.0) ||
+        !NearlyEqual(snapshot.mid(), 101.5)) {
+      std::cerr << "订单簿 snapshot 档位排序不符合预期\n";
       return 1;
     }
 
-    // 2. 验证算子计算
-    // ts_delay(close, 1) -> 118.0 (current is 119.0)
-    double delay = engine.Evaluate("ts_delay(close, 1)");
-    if (!NearlyEqual(delay, 118.0)) {
-      std::cerr << "OnlineFeatureEngine ts_delay 计算错误: " << delay << "\n";
+    // delta：改量 / 删档 / 插入新档 / 删除不存在的价位应为 no-op。
+    if (!book.Begin(2, 11, /*is_snapshot=*/false)) {
+      std::cerr << "序号前进的 delta 应被接受\n";
       return 1;
     }
-
-    // ts_delta(close, 1) -> 1.0
-    double delta = engine.Evaluate("ts_delta(close, 1)");
-    if (!NearlyEqual(delta, 1.0)) {
-      std::cerr << "OnlineFeatureEngine ts_delta 计算错误: " << delta << "\n";
+    book.SetBid(100.0, 5.0);
+    book.SetBid(101.0, 0.0);
+    book.SetBid(98.0, 0.0);
+    book.SetAsk(101.5, 0.5);
+    book.Commit();
+    if (!book.ReadSnapshot(&snapshot) || snapshot.bid_count != 2 ||
+        snapshot.ask_count != 3 || !NearlyEqual(snapshot.best_bid(), 100.0) ||
+        !NearlyEqual(snapshot.bids[0].qty, 5.0) ||
+        !NearlyEqual(snapshot.best_ask(), 101.5)) {
+      std::cerr << "订单簿 delta 应用结果不符合预期\n";
       return 1;
     }
-
-    // ts_rank(close, 5) -> 0.9 (strictly increasing: (4 + 0.5)/5)
-    double rank = engine.Evaluate("ts_rank(close, 5)");
-    if (!NearlyEqual(rank, 0.9)) {
-      std::cerr << "OnlineFeatureEngine ts_rank 计算错误: " << rank << "\n";
+    // 前 5 档不平衡：bids 5+2=7，asks 0.5+1+2=3.5。
+    if (!NearlyEqual(snapshot.ImbalanceTop(5), (7.0 - 3.5) / 10.5, 1e-12)) {
+      std::cerr << "订单簿不平衡口径不符合预期\n";
       return 1;
     }
 
-    // ts_corr(close, volume, 10) -> 1.0 (perfectly correlated)
-    double corr = engine.Evaluate("ts_corr(close, volume, 10)");
-    if (!NearlyEqual(corr, 1.0)) {
-      std::cerr << "OnlineFeatureEngine ts_corr 计算错误: " << corr << "\n";
+    // 重复/乱序序号直接拒绝，不进入写临界区。
+    if (book.Begin(3, 11, /*is_snapshot=*/false)) {
+      std::cerr << "序号不前进的 delta 应被丢弃\n";
       return 1;
     }
-
-    // rsi(close, 14) -> 100.0 (严格递增序列，无下跌，RSI=100)
-    double rsi = engine.Evaluate("rsi(close, 14)");
-    if (!NearlyEqual(rsi, 100.0)) {
-      std::cerr << "OnlineFeatureEngine rsi 计算错误: 预期 100.0, 实际 " << rsi << "\n";
+    if (!book.ReadSnapshot(&snapshot) || snapshot.update_id != 11) {
+      std::cerr << "被丢弃的 delta 不应污染簿状态\n";
       return 1;
     }
 
-    // ema(close, 5)
-    // 简单验证：EMA 应接近最新价格
-    double ema = engine.Evaluate("ema(close, 5)");
-    if (!std::isfinite(ema) || std::abs(ema - 119.0) > 5.0) {
-      std::cerr << "OnlineFeatureEngine ema 计算异常: " << ema << "\n";
+    // 新 snapshot 整簿替换；Reset 解除锚定。
+    if (!book.Begin(4, 20, /*is_snapshot=*/true)) {
+      std::cerr << "重建 snapshot 应被接受\n";
+      return 1;
+    }
+    book.SetBid(50.0, 1.0);
+    book.SetAsk(51.0, 1.0);
+    book.Commit();
+    if (!book.ReadSnapshot(&snapshot) || snapshot.bid_count != 1 ||
+        snapshot.ask_count != 1 || !NearlyEqual(snapshot.best_bid(), 50.0)) {
+      std::cerr << "snapshot 重建应清空旧档位\n";
+      return 1;
+    }
+    book.Reset();
+    if (book.ReadSnapshot(&snapshot)) {
+      std::cerr << "Reset 后订单簿应回到未锚定状态\n";
       return 1;
     }
+  }
 
-    // macd 组合表达式验证
-    double macd = engine.Evaluate("ema(close,12)-ema(close,26)");
-    if (!std::isfinite(macd)) {
-      std::cerr << "OnlineFeatureEngine macd 组合计算异常\n";
+  {
+    // 公共流 orderbook 通道：增量维护定长簿，ticker 事件带出顶档与不平衡
+    ai_trade::BybitPublicStreamOptions ws_options;
+    ws_options.enabled = true;
+    ws_options.testnet = true;
+    ws_options.category = "linear";
+    ws_options.symbols = {"BTCUSDT"};
+    ws_options.ack_timeout_ms = 1000;
+    ws_options.orderbook_enabled = true;
+    ws_options.orderbook_depth = 50;
+
+    std::vector<ScriptedWsStep> script = {
+        {ScriptedWsAction::kText, R"({"op":"subscribe","success":true})", ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000050,"topic":"orderbook.50.BTCUSDT","type":"snapshot","data":{"s":"BTCUSDT","b":[["123.0","2"],["122.5","1"]],"a":[["123.5","1"],["124.0","3"]],"u":7,"seq":100}})",
+         ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000080,"topic":"orderbook.50.BTCUSDT","type":"delta","data":{"s":"BTCUSDT","b":[["123.2","1.5"],["122.5","0"]],"a":[["123.5","0.4"]],"u":8,"seq":101}})",
+         ""},
+        // 重复序号的 delta 应被整条丢弃，不污染簿。
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000090,"topic":"orderbook.50.BTCUSDT","type":"delta","data":{"s":"BTCUSDT","b":[["999.0","9"]],"a":[],"u":8,"seq":102}})",
+         ""},
+        {ScriptedWsAction::kText,
+         R"({"ts":1700000000100,"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","lastPrice":"123.4","markPrice":"123.5","volume24h":"1000","fundingRate":"0.0004"}})",
+         ""},
+    };
+    ai_trade::BybitPublicStream stream(
+        ws_options,
+        std::make_unique<ScriptedWebsocketClient>(std::move(script)));
+    std::string error;
+    if (!stream.Connect(&error)) {
+      std::cerr << "orderbook 公共流脚本连接失败: " << error << "\n";
       return 1;
     }
 
-    // Integrator/Miner 表达式会使用 1e-9 这类科学计数法常量；
-    // 线上解析器必须与 Python 训练语义一致，不能把 `1e-9` 误拆成变量 e。
-    double normalized_delta =
-        engine.Evaluate("ts_delta(close,1)/(abs(ts_delay(close,1))+1e-9)");
-    if (!std::isfinite(normalized_delta) ||
-        !NearlyEqual(normalized_delta, 1.0 / 118.0, 1e-8)) {
-      std::cerr << "OnlineFeatureEngine 科学计数法表达式计算错误: "
-                << normalized_delta << "\n";
+    ai_trade::MarketEvent event;
+    if (!stream.PollTicker(&event) || event.symbol != "BTCUSDT" ||
+        !NearlyEqual(event.price, 123.4)) {
+      std::cerr << "orderbook 通道下 ticker 应照常产出行情\n";
+      return 1;
+    }
+    // delta 应用后顶档：bid 123.2(1.5)/123.0(2)，ask 123.5(0.4)/124.0(3)。
+    if (!NearlyEqual(event.best_bid, 123.2) ||
+        !NearlyEqual(event.best_ask, 123.5)) {
+      std::cerr << "ticker 事件应带出订单簿顶档\n";
+      return 1;
+    }
+    constexpr double kExpectedImbalance = (3.5 - 3.4) / 6.9;
+    if (!NearlyEqual(event.book_imbalance, kExpectedImbalance, 1e-12)) {
+      std::cerr << "ticker 事件的簿不平衡口径不符合预期\n";
       return 1;
     }
 
-    // 验证：窗口不足时应返回 NaN 而非 0.0
-    // ts_delay(close, 60) 需要 60+1 个数据，当前仅 20 个有效数据，padding 后窗口 50。
-    double invalid_delay = engine.Evaluate("ts_delay(close, 60)");
-    if (std::isfinite(invalid_delay)) {
-      std::cerr << "OnlineFeatureEngine 数据不足时应返回 NaN，实际返回: " << invalid_delay << "\n";
+    // 执行侧定价入口：跨线程 seqlock 读同样看到 delta 后的顶档。
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    if (!stream.ReadTopOfBook("BTCUSDT", &best_bid, &best_ask) ||
+        !NearlyEqual(best_bid, 123.2) || !NearlyEqual(best_ask, 123.5)) {
+      std::cerr << "ReadTopOfBook 结果不符合预期\n";
       return 1;
     }
-    
-    // 3. 验证批量计算
-    std::vector<std::string> exprs = {"close", "volume"};
-    std::vector<double> results = engine.EvaluateBatch(exprs);
-    if (results.size() != 2 || !NearlyEqual(results[0], 119.0) || !NearlyEqual(results[1], 2900.0)) {
-       std::cerr << "OnlineFeatureEngine EvaluateBatch 计算错误\n";
-       return 1;
+    if (stream.ReadTopOfBook("ETHUSDT", &best_bid, &best_ask)) {
+      std::cerr << "未订阅 symbol 不应有订单簿\n";
+      return 1;
     }
   }
 
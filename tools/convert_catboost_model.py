@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+把 CatBoost 模型转换为进程内原生对称树 blob（ATCOBLT1）。
+
+目的：
+1. 让 IntegratorShadow 通过 `integrator.shadow.native_model_path` 直接
+   装载扁平表表示打分，镜像无需携带 libcatboostmodel.so；
+2. 转换发生在部署时，线上启动阶段会对双运行时做同分校验
+   （见 src/strategy/integrator_shadow.cpp）。
+
+输入为 CatBoost 的 JSON 导出（`model.save_model(path, format="json")`，
+或 `catboost model-metadata` 工具导出）；只支持纯数值特征的对称树模型。
+
+blob 格式 v1（小端，与 src/strategy/oblivious_tree_model.h 对齐）：
+  magic "ATCOBLT1"，uint32 特征数，uint32 树数；每棵树 uint32 depth、
+  depth 组 (uint32 feature_index, float border)、2^depth 个 double 叶值。
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import pathlib
+import struct
+import sys
+from typing import Any, Dict, List
+
+MAGIC = b"ATCOBLT1"
+MAX_TREE_DEPTH = 16
+
+
+def load_model_json(path: pathlib.Path) -> Dict[str, Any]:
+    return json.loads(path.read_text(encoding="utf-8"))
+
+
+def extract_feature_count(model: Dict[str, Any]) -> int:
+    features_info = model.get("features_info", {})
+    float_features = features_info.get("float_features", [])
+    if not float_features:
+        raise ValueError("模型 JSON 缺少 features_info.float_features")
+    if features_info.get("categorical_features"):
+        raise ValueError("原生评估器不支持类别特征，请改用纯数值特征训练")
+    # flat_feature_index 不一定连续出现在导出里，用最大下标 +1 兜底。
+    max_index = max(
+        int(f.get("flat_feature_index", f.get("feature_index", i)))
+        for i, f in enumerate(float_features)
+    )
+    return max(len(float_features), max_index + 1)
+
+
+def extract_trees(model: Dict[str, Any]) -> List[Dict[str, Any]]:
+    trees = model.get("oblivious_trees")
+    if not trees:
+        raise ValueError("模型 JSON 缺少 oblivious_trees（非对称树模型？）")
+    return trees
+
+
+def convert_tree(tree: Dict[str, Any], feature_count: int,
+                 tree_index: int) -> Dict[str, Any]:
+    splits = tree.get("splits", [])
+    leaf_values = tree.get("leaf_values", [])
+    depth = len(splits)
+    if depth == 0 or depth > MAX_TREE_DEPTH:
+        raise ValueError(f"tree={tree_index}: 树深非法 depth={depth}")
+    if len(leaf_values) != (1 << depth):
+        raise ValueError(
+            f"tree={tree_index}: 叶值数 {len(leaf_values)} != 2^{depth}")
+    feature_indices: List[int] = []
+    borders: List[float] = []
+    for level, split in enumerate(splits):
+        if "float_feature_index" not in split and "border" not in split:
+            raise ValueError(
+                f"tree={tree_index} level={level}: 仅支持 float 分裂条件")
+        feature_index = int(split["float_feature_index"])
+        if feature_index < 0 or feature_index >= feature_count:
+            raise ValueError(
+                f"tree={tree_index} level={level}: 特征下标越界 "
+                f"{feature_index}")
+        feature_indices.append(feature_index)
+        borders.append(float(split["border"]))
+    return {
+        "feature_indices": feature_indices,
+        "borders": borders,
+        "leaf_values": [float(v) for v in leaf_values],
+    }
+
+
+def write_blob(path: pathlib.Path, feature_count: int,
+               trees: List[Dict[str, Any]]) -> None:
+    with path.open("wb") as fp:
+        fp.write(MAGIC)
+        fp.write(struct.pack("<II", feature_count, len(trees)))
+        for tree in trees:
+            depth = len(tree["feature_indices"])
+            fp.write(struct.pack("<I", depth))
+            for feature_index, border in zip(tree["feature_indices"],
+                                             tree["borders"]):
+                fp.write(struct.pack("<If", feature_index, border))
+            fp.write(struct.pack(f"<{len(tree['leaf_values'])}d",
+                                 *tree["leaf_values"]))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="CatBoost JSON 导出 -> 原生对称树 blob（ATCOBLT1）")
+    parser.add_argument("--input", required=True,
+                        help="CatBoost JSON 模型导出路径")
+    parser.add_argument("--output", required=True,
+                        help="原生 blob 输出路径（integrator.shadow.native_model_path）")
+    args = parser.parse_args()
+
+    input_path = pathlib.Path(args.input)
+    output_path = pathlib.Path(args.output)
+    try:
+        model = load_model_json(input_path)
+        feature_count = extract_feature_count(model)
+        trees = [
+            convert_tree(tree, feature_count, i)
+            for i, tree in enumerate(extract_trees(model))
+        ]
+    except (ValueError, KeyError, json.JSONDecodeError) as exc:
+        print(f"转换失败: {exc}", file=sys.stderr)
+        return 1
+
+    output_path.parent.mkdir(parents=True, exist_ok=True)
+    write_blob(output_path, feature_count, trees)
+    print(json.dumps({
+        "input": str(input_path),
+        "output": str(output_path),
+        "feature_count": feature_count,
+        "tree_count": len(trees),
+    }, ensure_ascii=False))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -306,9 +306,14 @@ def main() -> int:
     steps.append(StepResult(name="gap_fill", enabled=gap_fill_enabled, command=gap_cmd))
 
     feature_enabled = as_bool(deep_get(config, ["feature_store", "enabled"], True), True)
-    feature_cmd = [
-        py,
-        "tools/build_feature_store.py",
+    # feature_store.native_builder 指向 trade_feature_store 可执行文件时，
+    # 用原生构建器替换 Python 版（命令行参数兼容，产出格式一致）。
+    native_builder = str(deep_get(config, ["feature_store", "native_builder"], "") or "")
+    feature_cmd = (
+        [native_builder]
+        if native_builder
+        else [py, "tools/build_feature_store.py"]
+    ) + [
         "--input",
         str(ohlcv_path),
         "--output",